@@ -82,6 +82,7 @@
 -(void) reset;
 -(void) hard_reset;
 -(void) nmi;
+-(void) fastForwardToggle;
 -(int) checkMediaChanged;
 
 -(void) diskInsertNew:(int)which;
@@ -93,6 +94,8 @@
 -(void) diskWriteProtect:(int)which protect:(int)write;
 
 -(void) snapshotWrite:(const char *)filename;
+-(int) quickSave:(int)slot;
+-(int) quickLoad:(int)slot;
 
 -(void) screenshotScrRead:(const char *)filename;
 -(void) screenshotScrWrite:(const char *)filename;
@@ -115,6 +118,9 @@
 -(void) rzxStop;
 -(int) rzxContinueRecording:(const char *)filename;
 -(int) rzxFinaliseRecording:(const char *)filename;
+-(int) rzxSeek:(size_t)frame;
+-(size_t) rzxPlaybackPosition;
+-(size_t) rzxPlaybackLength;
 
 -(void) if1MdrNew:(int)drive;
 -(void) if1MdrInsert:(const char *)filename inDrive:(int)drive;
@@ -40,7 +40,9 @@
 #include "didaktik.h"
 #include "profile.h"
 #include "psg.h"
+#include "quicksave.h"
 #include "rzx.h"
+#include "rzx_index.h"
 #include "settings.h"
 #include "simpleide.h"
 #include "screenshot.h"
@@ -163,15 +165,18 @@ static Emulator *instance = nil;
           (0.8 * sound_framesiz / (float)settings_current.sound_freq ) ) 
         too_long = 1;
     }
-  /* If we're fastloading, keep running frames until we have used up 95% of
-     the timer interval */
-  } else if( settings_current.fastload && tape_is_playing() ) {
+  /* If we're fastloading or fast-forwarding, keep running frames until we
+     have used up 95% of the timer interval or reached the target speed */
+  } else if( spectrum_fast_forward_active() ) {
     int done = 0;
+    int fps = spectrum_fast_forward_fps();
+    int frames = fps ? deltaTime * fps + 0.5 : 0;
     CFTimeInterval startTime = CFAbsoluteTimeGetCurrent();
     while( !done ) {
       spectrum_do_frame();
       CFTimeInterval endTime = CFAbsoluteTimeGetCurrent();
-      if( (endTime - startTime) > (0.95 * timerInterval) ) 
+      if( (endTime - startTime) > (0.95 * timerInterval) ||
+          ( fps && --frames <= 0 ) )
         done = 1;
     }
   } else {
@@ -290,6 +295,11 @@ static Emulator *instance = nil;
   event_add( 0, z80_nmi_event );
 }
 
+-(void) fastForwardToggle
+{
+  spectrum_set_fast_forward( !settings_current.fast_forward );
+}
+
 -(int) checkMediaChanged
 {
 //  return menu_check_media_changed();
@@ -341,6 +351,16 @@ static Emulator *instance = nil;
   snapshot_write( filename );
 }
 
+-(int) quickSave:(int)slot
+{
+  return quicksave_save( slot );
+}
+
+-(int) quickLoad:(int)slot
+{
+  return quicksave_load( slot );
+}
+
 -(void) screenshotScrRead:(const char *)filename
 {
   screenshot_scr_read( filename );
@@ -452,6 +472,21 @@ static Emulator *instance = nil;
   return rzx_finalise_recording(filename);
 }
 
+-(int) rzxSeek:(size_t)frame
+{
+  return rzx_index_seek( frame );
+}
+
+-(size_t) rzxPlaybackPosition
+{
+  return rzx_playback ? rzx_index_position() : 0;
+}
+
+-(size_t) rzxPlaybackLength
+{
+  return rzx_playback ? rzx_index_length() : 0;
+}
+
 -(void) if1MdrNew:(int)drive
 {
   if1_mdr_insert( drive, NULL );
@@ -196,6 +196,9 @@ void compat_socket_networking_end( void );
 int compat_socket_close( compat_socket_t fd );
 int compat_socket_get_error( void );
 const char *compat_socket_get_strerror( void );
+int compat_socket_set_nonblocking( compat_socket_t fd );
+/* True if the last socket call failed only because it would have blocked */
+int compat_socket_would_block( void );
 
 typedef struct compat_socket_selfpipe_t compat_socket_selfpipe_t;
 
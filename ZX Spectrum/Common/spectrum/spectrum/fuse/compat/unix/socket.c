@@ -26,6 +26,7 @@
 #include "config.h"
 
 #include <errno.h>
+#include <fcntl.h>
 #include <string.h>
 #include <unistd.h>
 
@@ -70,6 +71,20 @@ compat_socket_get_strerror( void )
   return strerror( errno );
 }
 
+int
+compat_socket_set_nonblocking( compat_socket_t fd )
+{
+  int flags = fcntl( fd, F_GETFL );
+  if( flags == -1 ) return -1;
+  return fcntl( fd, F_SETFL, flags | O_NONBLOCK ) == -1 ? -1 : 0;
+}
+
+int
+compat_socket_would_block( void )
+{
+  return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINPROGRESS;
+}
+
 compat_socket_selfpipe_t* compat_socket_selfpipe_alloc( void )
 {
   int error;
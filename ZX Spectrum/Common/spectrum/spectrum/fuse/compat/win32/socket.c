@@ -78,6 +78,20 @@ compat_socket_get_strerror( void )
   return (const char *)buffer;
 }
 
+int
+compat_socket_set_nonblocking( compat_socket_t fd )
+{
+  u_long one = 1;
+  return ioctlsocket( fd, FIONBIO, &one ) == SOCKET_ERROR ? -1 : 0;
+}
+
+int
+compat_socket_would_block( void )
+{
+  int error = WSAGetLastError();
+  return error == WSAEWOULDBLOCK || error == WSAEINPROGRESS;
+}
+
 static int
 selfpipe_test( compat_socket_selfpipe_t *self )
 {
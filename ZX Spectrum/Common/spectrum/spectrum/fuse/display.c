@@ -44,9 +44,29 @@
 #include "ui.h"
 #include "uidisplay.h"
 
+/* Vector instructions the scanline log can build its lines with; both are
+   always there on the CPUs which have them at all, so unlike the scalers
+   there's nothing to choose at runtime */
+#ifndef WORDS_BIGENDIAN
+
+#if defined( __SSE2__ ) || defined( _M_X64 )
+#define DISPLAY_LOG_SSE2
+#include <emmintrin.h>
+#endif				/* #if defined( __SSE2__ ) || ... */
+
+#if defined( __ARM_NEON ) || defined( __ARM_NEON__ )
+#define DISPLAY_LOG_NEON
+#include <arm_neon.h>
+#endif				/* #if defined( __ARM_NEON ) || ... */
+
+#endif				/* #ifndef WORDS_BIGENDIAN */
+
 /* Set once we have initialised the UI */
 int display_ui_initialised = 0;
 
+/* Set while emulating frames which will never be shown */
+int display_hidden = 0;
+
 /* The current border colour */
 libspectrum_byte display_lores_border;
 libspectrum_byte display_hires_border;
@@ -124,6 +144,8 @@ static void display_dirty64( libspectrum_word address );
 static void display_get_attr( int x, int y,
 			      libspectrum_byte *ink, libspectrum_byte *paper);
 
+static void display_log_select( void );
+
 static int border_changes_last = 0;
 static struct border_change_t *border_changes = NULL;
 
@@ -140,6 +162,60 @@ alloc_change(void)
   return border_changes + border_changes_last++; 
 }
 
+/* With the scanline log active, writes to the screen and changes of border
+   colour are only logged during the frame and the whole frame is drawn from
+   the log once it has finished, replaying the writes in beam order */
+int display_log_active = 0;
+
+typedef enum display_log_type {
+  DISPLAY_LOG_WRITE,		/* A write to screen memory */
+  DISPLAY_LOG_SCREEN,		/* The displayed screen may have changed */
+  DISPLAY_LOG_BORDER,		/* The border colour changed */
+} display_log_type;
+
+typedef struct display_log_entry {
+  libspectrum_dword tstates;
+  libspectrum_word offset;	/* Offset of a write into its RAM page */
+  libspectrum_byte type;
+  libspectrum_byte page;	/* RAM page written to */
+  libspectrum_byte old;		/* Byte overwritten, or screen in use before
+				   a screen change */
+  libspectrum_byte value;	/* Byte written, border colour, or screen in
+				   use after a screen change */
+} display_log_entry;
+
+static display_log_entry *display_log = NULL;
+static size_t display_log_count = 0, display_log_size = 0;
+
+/* The two screen pages as the beam sees them while replaying the log */
+static libspectrum_byte display_log_screen[ 2 ][ 0x1b00 ];
+
+/* Set when everything has to be checked at the end of the next frame
+   rather than just the lines written to */
+static int display_log_redraw = 1;
+
+/* Lines written to after the beam had passed them, which will need to be
+   drawn again at the end of the next frame */
+static libspectrum_byte display_log_missed[ DISPLAY_HEIGHT ];
+
+static display_log_entry *
+display_log_add( display_log_type type )
+{
+  display_log_entry *entry;
+
+  if( display_log_count == display_log_size ) {
+    display_log_size = display_log_size ? display_log_size * 2 : 1024;
+    display_log = libspectrum_renew( display_log_entry, display_log,
+                                     display_log_size );
+  }
+
+  entry = &display_log[ display_log_count++ ];
+  entry->tstates = tstates;
+  entry->type = type;
+
+  return entry;
+}
+
 static int
 add_border_sentinel( void )
 {
@@ -190,6 +266,9 @@ display_init( int *argc, char ***argv )
 
   display_frame_count=0; display_flash_reversed=0;
 
+  display_log_count = 0;
+  display_log_select();
+
   display_refresh_all();
 
   border_changes_last = 0;
@@ -595,6 +674,13 @@ copy_critical_region_line( int y, int x, int end )
 static void
 copy_critical_region( int beam_x, int beam_y )
 {
+  /* Leave the chunks marked as maybe dirty so the next visible frame will
+     draw them */
+  if( display_hidden ) {
+    critical_region_x = beam_x; critical_region_y = beam_y;
+    return;
+  }
+
   if( critical_region_y == beam_y ) {
 
     copy_critical_region_line( critical_region_y, critical_region_x, beam_x );
@@ -615,43 +701,51 @@ copy_critical_region( int beam_x, int beam_y )
 }
 
 static inline void
-get_beam_position( int *x, int *y )
+get_beam_position( libspectrum_dword time, int *x, int *y )
 {
-  if( tstates < machine_current->line_times[ 0 ] ) {
+  if( time < machine_current->line_times[ 0 ] ) {
     *x = *y = -1;
     return;
   }
 
-  *y = ( tstates - machine_current->line_times[ 0 ] ) /
+  *y = ( time - machine_current->line_times[ 0 ] ) /
     machine_current->timings.tstates_per_line;
 
   if( *y >= 0 && *y <= DISPLAY_SCREEN_HEIGHT )
-    *x = ( tstates - machine_current->line_times[ *y ] ) / 4;
+    *x = ( time - machine_current->line_times[ *y ] ) / 4;
   else *x = 0;
 }
 
-inline static void
-update_critical_internal( int x, int y )
+/* Get the beam position at <time> relative to the main screen, clamped to
+   it; everything before this point has already been drawn */
+static inline void
+get_main_screen_beam( libspectrum_dword time, int *x, int *y )
 {
-  int beam_x, beam_y;
+  get_beam_position( time, x, y );
 
-  get_beam_position( &beam_x, &beam_y );
+  *x -= DISPLAY_BORDER_WIDTH_COLS;
+  *y -= DISPLAY_BORDER_HEIGHT;
 
-  beam_x -= DISPLAY_BORDER_WIDTH_COLS;
-  beam_y -= DISPLAY_BORDER_HEIGHT;
-
-  if( beam_y < 0 ) {
-    beam_x = beam_y = 0;
-  } else if( beam_y >= DISPLAY_HEIGHT ) {
-    beam_x = DISPLAY_WIDTH_COLS;
-    beam_y = DISPLAY_HEIGHT - 1;
+  if( *y < 0 ) {
+    *x = *y = 0;
+  } else if( *y >= DISPLAY_HEIGHT ) {
+    *x = DISPLAY_WIDTH_COLS;
+    *y = DISPLAY_HEIGHT - 1;
   }
 
-  if( beam_x < 0 ) {
-    beam_x = 0;
-  } else if( beam_x > DISPLAY_WIDTH_COLS ) {
-    beam_x = DISPLAY_WIDTH_COLS;
+  if( *x < 0 ) {
+    *x = 0;
+  } else if( *x > DISPLAY_WIDTH_COLS ) {
+    *x = DISPLAY_WIDTH_COLS;
   }
+}
+
+inline static void
+update_critical_internal( int x, int y )
+{
+  int beam_x, beam_y;
+
+  get_main_screen_beam( tstates, &beam_x, &beam_y );
 
   if(   y <  beam_y                 ||
       ( y == beam_y && x < beam_x )    )
@@ -661,6 +755,13 @@ update_critical_internal( int x, int y )
 void
 display_update_critical( int x, int y )
 {
+  if( display_log_active ) {
+    /* The screen in use from here on is only known once the frame has
+       finished */
+    display_log_add( DISPLAY_LOG_SCREEN )->old = memory_current_screen;
+    return;
+  }
+
   update_critical_internal( x, y );
 }
 
@@ -670,9 +771,11 @@ static inline void
 display_dirty_chunk( int x, int y )
 {
   /* If the write is between the start of the critical region and the
-     current beam position, then we must copy the critical region now */
-  if(   y >  critical_region_y                             ||
-      ( y == critical_region_y && x >= critical_region_x )    ) {
+     current beam position, then we must copy the critical region now. No
+     need when the frame won't be drawn */
+  if( !display_hidden &&
+      (   y >  critical_region_y                             ||
+        ( y == critical_region_y && x >= critical_region_x )    ) ) {
 
     update_critical_internal( x, y );
   }
@@ -725,12 +828,12 @@ display_get_attr( int x, int y,
 }
 
 static void
-push_border_change( int colour )
+add_border_change( libspectrum_dword time, int colour )
 {
   int beam_x, beam_y;
   struct border_change_t *change;
 
-  get_beam_position( &beam_x, &beam_y );
+  get_beam_position( time, &beam_x, &beam_y );
 
   if( beam_y >= DISPLAY_SCREEN_HEIGHT ) return;
 
@@ -745,6 +848,20 @@ push_border_change( int colour )
   change->colour = colour;
 }
 
+static void
+push_border_change( int colour )
+{
+  /* Hidden frames drop their border changes anyway */
+  if( display_hidden ) return;
+
+  if( display_log_active ) {
+    display_log_add( DISPLAY_LOG_BORDER )->value = colour;
+    return;
+  }
+
+  add_border_change( tstates, colour );
+}
+
 /* Change border colour if the colour in use changes */
 static void
 check_border_change( void )
@@ -769,6 +886,20 @@ display_set_lores_border( int colour )
   check_border_change();
 }
 
+/* Take up a colour restored from saved state as the border for the whole
+   of the frame in progress. Pushing it as a change at the restored time
+   could put it before changes already made this frame */
+void
+display_restore_lores_border( int colour )
+{
+  display_lores_border = colour;
+  display_last_border = scld_last_dec.name.hires ?
+                            display_hires_border : display_lores_border;
+
+  border_changes_last = 0;
+  add_border_sentinel();
+}
+
 void
 display_set_hires_border( int colour )
 {
@@ -891,6 +1022,266 @@ update_border( void )
   error = add_border_sentinel(); if( error ) return;
 }
 
+void
+display_log_write( int page, libspectrum_word offset, libspectrum_byte old,
+                   libspectrum_byte value )
+{
+  display_log_entry *entry = display_log_add( DISPLAY_LOG_WRITE );
+
+  entry->page = page;
+  entry->offset = offset;
+  entry->old = old;
+  entry->value = value;
+}
+
+/* The index of the first 8x1 chunk of the main screen, counting in the
+   order the beam draws them, which an event at <time> is seen in */
+static int
+display_log_chunk( libspectrum_dword time )
+{
+  int beam_x, beam_y;
+
+  get_main_screen_beam( time, &beam_x, &beam_y );
+
+  return beam_y * DISPLAY_WIDTH_COLS + beam_x;
+}
+
+/* Mark the lines a write to <offset> changes */
+static void
+display_log_mark( libspectrum_byte *lines, libspectrum_word offset )
+{
+  if( offset < 0x1800 ) {
+    lines[ display_dirty_ytable[ offset ] ] = 1;
+  } else {
+    memset( &lines[ display_dirty_ytable2[ offset - 0x1800 ] ], 1, 8 );
+  }
+}
+
+/* Mark the lines with chunks which a write to <offset> seen from <chunk>
+   onwards came too late for */
+static void
+display_log_mark_missed( libspectrum_word offset, int chunk )
+{
+  int x, y, i;
+
+  if( offset < 0x1800 ) {
+    x = display_dirty_xtable[ offset ];
+    y = display_dirty_ytable[ offset ];
+    if( y * DISPLAY_WIDTH_COLS + x < chunk ) display_log_missed[ y ] = 1;
+  } else {
+    x = display_dirty_xtable2[ offset - 0x1800 ];
+    y = display_dirty_ytable2[ offset - 0x1800 ];
+    for( i = 0; i < 8; i++ )
+      if( ( y + i ) * DISPLAY_WIDTH_COLS + x < chunk )
+        display_log_missed[ y + i ] = 1;
+  }
+}
+
+/* Make the change recorded in <entry>, which the beam sees from <chunk>
+   onwards */
+static void
+display_log_apply( const display_log_entry *entry, int chunk, int *screen )
+{
+  switch( entry->type ) {
+
+  case DISPLAY_LOG_WRITE:
+    display_log_screen[ entry->page == 7 ][ entry->offset ] = entry->value;
+    if( entry->page == 5 || entry->page == 7 )
+      display_log_mark_missed( entry->offset, chunk );
+    break;
+
+  case DISPLAY_LOG_SCREEN:
+    /* What was drawn before the change will need drawing again */
+    *screen = entry->value;
+    if( chunk && entry->value != entry->old ) display_log_redraw = 1;
+    break;
+
+  case DISPLAY_LOG_BORDER:
+    break;
+
+  }
+}
+
+/* line[x] = flash | attr[x] << 8 | data[x] for x from <x> up to <end>.
+   Eight chunks at a time: interleaving the data and attribute bytes gives
+   the low halves of the entries, and the flash bit their high halves */
+static void
+display_log_span( libspectrum_dword *line, const libspectrum_byte *data,
+                  const libspectrum_byte *attr, int x, int end )
+{
+  libspectrum_dword flash = display_flash_reversed << 24;
+
+#ifdef DISPLAY_LOG_SSE2
+  __m128i high = _mm_set1_epi16( flash >> 16 );
+
+  for( ; x + 8 <= end; x += 8 ) {
+    __m128i low = _mm_unpacklo_epi8(
+      _mm_loadl_epi64( (const __m128i*)( data + x ) ),
+      _mm_loadl_epi64( (const __m128i*)( attr + x ) )
+    );
+    _mm_storeu_si128( (__m128i*)( line + x ),
+                      _mm_unpacklo_epi16( low, high ) );
+    _mm_storeu_si128( (__m128i*)( line + x + 4 ),
+                      _mm_unpackhi_epi16( low, high ) );
+  }
+#endif				/* #ifdef DISPLAY_LOG_SSE2 */
+
+#ifdef DISPLAY_LOG_NEON
+  uint16x8_t high = vdupq_n_u16( flash >> 16 );
+
+  for( ; x + 8 <= end; x += 8 ) {
+    uint8x8x2_t bytes = vzip_u8( vld1_u8( data + x ), vld1_u8( attr + x ) );
+    uint16x8_t low = vreinterpretq_u16_u8( vcombine_u8( bytes.val[0],
+                                                        bytes.val[1] ) );
+    uint16x8x2_t words = vzipq_u16( low, high );
+    vst1q_u32( line + x, vreinterpretq_u32_u16( words.val[0] ) );
+    vst1q_u32( line + x + 4, vreinterpretq_u32_u16( words.val[1] ) );
+  }
+#endif				/* #ifdef DISPLAY_LOG_NEON */
+
+  for( ; x < end; x++ )
+    line[x] = flash | ( attr[x] << 8 ) | data[x];
+}
+
+/* Draw one line of the main screen. The line is built up a span at a time,
+   each span running up to the next logged event, and only compared against
+   what was drawn last time once it's complete */
+static void
+display_log_line( int y, size_t *next, int *next_chunk, int *screen )
+{
+  libspectrum_dword line[ DISPLAY_WIDTH_COLS ], *last;
+  int beam_x, beam_y, x, end;
+
+  beam_y = y + DISPLAY_BORDER_HEIGHT;
+  last = &display_last_screen[ DISPLAY_BORDER_WIDTH_COLS +
+                               beam_y * DISPLAY_SCREEN_WIDTH_COLS ];
+
+  for( x = 0; x < DISPLAY_WIDTH_COLS; x = end ) {
+    int chunk = y * DISPLAY_WIDTH_COLS + x;
+    const libspectrum_byte *data, *attr;
+
+    while( *next_chunk <= chunk ) {
+      display_log_apply( &display_log[ *next ], *next_chunk, screen );
+      *next_chunk = ++*next < display_log_count ?
+                    display_log_chunk( display_log[ *next ].tstates ) :
+                    DISPLAY_WIDTH_COLS * DISPLAY_HEIGHT;
+    }
+
+    end = *next_chunk - y * DISPLAY_WIDTH_COLS;
+    if( end > DISPLAY_WIDTH_COLS ) end = DISPLAY_WIDTH_COLS;
+
+    data = &display_log_screen[ *screen == 7 ][ display_line_start[y] ];
+    attr = &display_log_screen[ *screen == 7 ][ display_attr_start[y] ];
+
+    display_log_span( line, data, attr, x, end );
+  }
+
+  /* Only 128 bytes; the C library's memcmp() already picks vector code at
+     run time, and scaler_simd.c only has the scalers' pixel kernels */
+  if( !memcmp( line, last, sizeof( line ) ) ) return;
+
+  for( x = 0; x < DISPLAY_WIDTH_COLS; x++ ) {
+    libspectrum_byte ink, paper;
+
+    if( last[x] == line[x] ) continue;
+
+    beam_x = x + DISPLAY_BORDER_WIDTH_COLS;
+
+    display_parse_attr( ( line[x] >> 8 ) & 0xff, &ink, &paper );
+    uidisplay_plot8( beam_x, beam_y, line[x] & 0xff, ink, paper );
+
+    last[x] = line[x];
+    display_is_dirty[ beam_y ] |= ( (libspectrum_qword)1 << beam_x );
+  }
+}
+
+/* Draw the frame from the log. This stays on the emulation thread: it
+   only plots palette indices, and the frame end reads display_last_screen
+   and display_is_dirty straight afterwards. On the front ends drawing
+   through uiframe, the scaling and blitting of what it plots already
+   happen on the render thread */
+static void
+display_log_replay( void )
+{
+  libspectrum_byte lines[ DISPLAY_HEIGHT ];
+  size_t i, next;
+  int next_chunk, screen, y;
+
+  /* Start from the lines which were written to too late last time */
+  memcpy( lines, display_log_missed, sizeof( lines ) );
+  memset( display_log_missed, 0, sizeof( display_log_missed ) );
+
+  for( i = 0; i < display_log_count; i++ )
+    if( display_log[i].type == DISPLAY_LOG_BORDER )
+      add_border_change( display_log[i].tstates, display_log[i].value );
+
+  /* Take the screens as they are now and undo this frame's writes to get
+     them as they were at the start of the frame */
+  memcpy( display_log_screen[0], RAM[5], sizeof( display_log_screen[0] ) );
+  memcpy( display_log_screen[1], RAM[7], sizeof( display_log_screen[1] ) );
+  screen = memory_current_screen;
+
+  for( i = display_log_count; i--; ) {
+    display_log_entry *entry = &display_log[i];
+
+    switch( entry->type ) {
+
+    case DISPLAY_LOG_WRITE:
+      display_log_screen[ entry->page == 7 ][ entry->offset ] = entry->old;
+      if( entry->page == 5 || entry->page == 7 )
+        display_log_mark( lines, entry->offset );
+      break;
+
+    case DISPLAY_LOG_SCREEN:
+      entry->value = screen;
+      screen = entry->old;
+      if( entry->value != entry->old ) display_log_redraw = 1;
+      break;
+
+    case DISPLAY_LOG_BORDER:
+      break;
+
+    }
+  }
+
+  if( display_log_redraw ) {
+    memset( lines, 1, sizeof( lines ) );
+    display_log_redraw = 0;
+  }
+
+  /* And replay them, drawing each line as the beam would have seen it */
+  next = 0;
+  next_chunk = display_log_count ? display_log_chunk( display_log[0].tstates )
+                                 : DISPLAY_WIDTH_COLS * DISPLAY_HEIGHT;
+
+  for( y = 0; y < DISPLAY_HEIGHT; y++ )
+    if( lines[y] ) display_log_line( y, &next, &next_chunk, &screen );
+
+  /* Anything left came after the beam had finished with the main screen */
+  for( ; next < display_log_count; next++ )
+    display_log_apply( &display_log[ next ], DISPLAY_WIDTH_COLS * DISPLAY_HEIGHT,
+                       &screen );
+
+  display_log_count = 0;
+}
+
+/* Turn the scanline log on or off to match the settings and the screen
+   mode in use */
+static void
+display_log_select( void )
+{
+  int active = settings_current.scanline_log &&
+               display_write_if_dirty == display_write_if_dirty_sinclair;
+
+  if( active == display_log_active ) return;
+
+  display_log_active = active;
+  display_log_count = 0;
+
+  /* Neither way of drawing knows what the other one has done */
+  display_refresh_main_screen();
+}
+
 /* Send the updated screen to the UI-specific code */
 static void
 update_ui_screen( void )
@@ -900,6 +1291,14 @@ update_ui_screen( void )
   size_t i;
   struct rectangle *ptr;
 
+  /* The screen is still tracked in display_last_screen, but the UI never
+     hears about it */
+  if( ui_headless ) {
+    rectangle_inactive_count = 0;
+    display_redraw_all = 0;
+    return;
+  }
+
   if( settings_current.frame_rate <= ++frame_count ) {
     frame_count = 0;
     if( movie_recording ) {
@@ -936,23 +1335,52 @@ update_ui_screen( void )
 int
 display_frame( void )
 {
-  /* Copy all the critical region to the display */
-  copy_critical_region( DISPLAY_WIDTH_COLS, DISPLAY_HEIGHT - 1 );
+  /* The log can't draw anything other than the standard screen, so if that's
+     stopped being used part way through the frame, just start again */
+  if( display_log_active &&
+      display_write_if_dirty != display_write_if_dirty_sinclair ) {
+    display_log_active = 0;
+    display_log_count = 0;
+    display_refresh_main_screen();
+  }
+
+  if( display_log_active ) {
+    if( display_hidden ) {
+      display_log_count = 0;
+      display_log_redraw = 1;
+    } else {
+      display_log_replay();
+    }
+  } else {
+    /* Copy all the critical region to the display */
+    copy_critical_region( DISPLAY_WIDTH_COLS, DISPLAY_HEIGHT - 1 );
+  }
   critical_region_x = critical_region_y = 0;
 
-  update_border();
-  update_dirty_rects();
-  update_ui_screen();
+  if( display_hidden ) {
+    /* Drop this frame's border changes, starting the next frame from the
+       current colour */
+    border_changes_last = 0;
+    add_border_sentinel();
+  } else {
+    update_border();
+    update_dirty_rects();
+    update_ui_screen();
+  }
 
   display_frame_count++;
   if(display_frame_count==16) {
     display_flash_reversed=1;
-    display_dirty_flashing();
+    if( display_log_active ) display_log_redraw = 1;
+    else display_dirty_flashing();
   } else if(display_frame_count==32) {
     display_flash_reversed=0;
-    display_dirty_flashing();
+    if( display_log_active ) display_log_redraw = 1;
+    else display_dirty_flashing();
     display_frame_count=0;
   }
+
+  display_log_select();
   
   return 0;
 }
@@ -1011,12 +1439,36 @@ display_dirty_flashing_sinclair(void)
   }
 }
 
+void
+display_state_to( module_state *state )
+{
+  module_state_write( state, &display_frame_count,
+                      sizeof( display_frame_count ) );
+  module_state_write( state, &display_flash_reversed,
+                      sizeof( display_flash_reversed ) );
+  module_state_write( state, &display_last_border,
+                      sizeof( display_last_border ) );
+}
+
+void
+display_state_from( module_state *state )
+{
+  module_state_read( state, &display_frame_count,
+                     sizeof( display_frame_count ) );
+  module_state_read( state, &display_flash_reversed,
+                     sizeof( display_flash_reversed ) );
+  module_state_read( state, &display_last_border,
+                     sizeof( display_last_border ) );
+}
+
 void display_refresh_main_screen(void)
 {
   size_t i;
 
   for( i = 0; i < DISPLAY_HEIGHT; i++ )
     display_maybe_dirty[i] = display_all_dirty;
+
+  display_log_redraw = 1;
 }
 
 void display_refresh_all(void)
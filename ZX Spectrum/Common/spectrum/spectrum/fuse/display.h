@@ -30,6 +30,8 @@
 
 #include "libspectrum.h"
 
+#include "module.h"
+
 /* The width and height of the Speccy's screen */
 #define DISPLAY_WIDTH_COLS  32
 #define DISPLAY_HEIGHT_ROWS 24
@@ -64,6 +66,11 @@
 
 extern int display_ui_initialised;
 
+/* Set while emulating frames which will never be shown, such as those run
+   ahead of the displayed frame. Nothing is drawn, but what changed is
+   remembered so the next visible frame is complete */
+extern int display_hidden;
+
 extern libspectrum_byte display_lores_border;
 extern libspectrum_byte display_hires_border;
 
@@ -110,10 +117,16 @@ void display_dirty_flashing_sinclair(void);
 void display_parse_attr( libspectrum_byte attr, libspectrum_byte *ink, libspectrum_byte *paper );
 
 void display_set_lores_border(int colour);
+void display_restore_lores_border( int colour );
 void display_set_hires_border(int colour);
 int display_dirty_border(void);
 
 int display_frame(void);
+
+/* Save and restore the display state which depends on emulated time: the
+   flash phase and the last border colour */
+void display_state_to( module_state *state );
+void display_state_from( module_state *state );
 void display_refresh_main_screen(void);
 void display_refresh_all(void);
 
@@ -124,4 +137,12 @@ int display_getpixel( int x, int y );
 
 void display_update_critical( int x, int y );
 
+/* Set when screen writes are being logged and the screen drawn from the log
+   at the end of each frame */
+extern int display_log_active;
+
+/* Log a write to the first 0x1b00 bytes of RAM page 5 or 7 */
+void display_log_write( int page, libspectrum_word offset,
+                        libspectrum_byte old, libspectrum_byte value );
+
 #endif			/* #ifndef FUSE_DISPLAY_H */
@@ -258,6 +258,41 @@ event_foreach( GFunc function, gpointer user_data )
   g_slist_foreach( event_list, function, user_data );
 }
 
+void
+event_state_to( module_state *state )
+{
+  GSList *ptr;
+  size_t count = g_slist_length( event_list );
+
+  module_state_write( state, &count, sizeof( count ) );
+
+  for( ptr = event_list; ptr; ptr = ptr->next )
+    module_state_write( state, ptr->data, sizeof( event_t ) );
+}
+
+void
+event_state_from( module_state *state )
+{
+  GSList *list = NULL;
+  event_t *ptr;
+  size_t i, count;
+
+  event_reset();
+
+  module_state_read( state, &count, sizeof( count ) );
+
+  for( i = 0; i < count; i++ ) {
+    ptr = libspectrum_new( event_t, 1 );
+    module_state_read( state, ptr, sizeof( event_t ) );
+    list = g_slist_prepend( list, ptr );
+  }
+
+  event_list = g_slist_reverse( list );
+
+  event_next_event = event_list ?
+    ((event_t*)(event_list->data))->tstates : event_no_events;
+}
+
 /* A textual representation of each event type */
 const char*
 event_name( int type )
@@ -32,6 +32,8 @@
 
 #include "libspectrum.h"
 
+#include "module.h"
+
 /* Information about an event */
 typedef struct event_t {
   libspectrum_dword tstates;
@@ -88,6 +90,10 @@ void event_reset( void );
 /* Call a user-supplied function for every event in the current list */
 void event_foreach( GFunc function, gpointer user_data );
 
+/* Save and restore the whole event list */
+void event_state_to( module_state *state );
+void event_state_from( module_state *state );
+
 /* A textual representation of each event type */
 const char *event_name( int type );
 
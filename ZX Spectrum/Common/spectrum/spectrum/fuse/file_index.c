@@ -0,0 +1,599 @@
+/* file_index.c: Index of the type, machine and title of files
+   Copyright (c) 2026 The Fuse authors
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+   Author contact information:
+
+   E-mail: philip-fuse@shadowmagic.org.uk
+
+*/
+
+#include "config.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif				/* #ifdef HAVE_PTHREAD */
+
+#include "libspectrum.h"
+
+#include "compat.h"
+#include "file_index.h"
+#include "fuse.h"
+#include "settings.h"
+#include "startup_manager.h"
+#include "ui.h"
+#include "utils.h"
+
+/* The most threads we'll use to read files; beyond this the disk is
+   usually the limit */
+#define FILE_INDEX_MAX_THREADS 8
+
+static const char file_index_signature[] = "FUSEIDX";
+static const libspectrum_byte file_index_version = 1;
+
+/* Entries keyed by path */
+static GHashTable *entries = NULL;
+
+typedef struct scan_job {
+
+  const char *path;
+  file_index_entry *entry;	/* The new entry, or NULL if there isn't one */
+
+} scan_job;
+
+typedef struct scan_state {
+
+  scan_job *jobs;
+  size_t count;
+  size_t next;
+
+#ifdef HAVE_PTHREAD
+  pthread_mutex_t lock;
+#endif				/* #ifdef HAVE_PTHREAD */
+
+} scan_state;
+
+static void
+entry_free( gpointer data )
+{
+  file_index_entry *entry = data;
+  size_t i;
+
+  for( i = 0; i < entry->archive_info_count; i++ )
+    libspectrum_free( entry->archive_info_strings[i] );
+  libspectrum_free( entry->archive_info_strings );
+  libspectrum_free( entry->archive_info_ids );
+  libspectrum_free( entry->path );
+  libspectrum_free( entry );
+}
+
+static void
+entry_insert( file_index_entry *entry )
+{
+  g_hash_table_insert( entries, utils_safe_strdup( entry->path ), entry );
+}
+
+/* Reduce the screen to one colour per 4x4 block of pixels: the ink if at
+   least half of them are set, otherwise the paper */
+static void
+make_thumbnail( libspectrum_byte *thumbnail, const libspectrum_byte *screen )
+{
+  size_t x, y, i, j, set;
+  libspectrum_byte attr, pixels;
+
+  for( y = 0; y < FILE_INDEX_THUMBNAIL_HEIGHT; y++ ) {
+    for( x = 0; x < FILE_INDEX_THUMBNAIL_WIDTH; x++ ) {
+
+      attr = screen[ 0x1800 + ( y / 2 ) * 32 + x / 2 ];
+
+      for( i = 0, set = 0; i < 4; i++ ) {
+        size_t line = y * 4 + i;
+        pixels = screen[ ( ( line & 0xc0 ) << 5 ) | ( ( line & 0x07 ) << 8 ) |
+                         ( ( line & 0x38 ) << 2 ) | ( x / 2 ) ];
+        if( !( x & 1 ) ) pixels >>= 4;
+        for( j = 0; j < 4; j++ ) set += ( pixels >> j ) & 1;
+      }
+
+      thumbnail[ y * FILE_INDEX_THUMBNAIL_WIDTH + x ] =
+        ( set >= 8 ? attr & 0x07 : ( attr >> 3 ) & 0x07 ) |
+        ( attr & 0x40 ? 0x08 : 0x00 );
+    }
+  }
+}
+
+/* Read as much of a file as is needed to identify it. Returns NULL if it
+   can't be read */
+static libspectrum_byte*
+read_probe( const char *path, libspectrum_qword size, size_t *length )
+{
+  libspectrum_byte *buffer;
+  libspectrum_id_t type;
+  libspectrum_class_t class;
+  size_t wanted;
+  FILE *f;
+
+  f = fopen( path, "rb" );
+  if( !f ) return NULL;
+
+  wanted = size < LIBSPECTRUM_METADATA_PROBE_LENGTH ?
+           size : LIBSPECTRUM_METADATA_PROBE_LENGTH;
+  buffer = libspectrum_new( libspectrum_byte, wanted ? wanted : 1 );
+  *length = fread( buffer, 1, wanted, f );
+
+  /* Tapes can be identified from their start, but snapshots and compressed
+     files have to be read in full */
+  if( *length < size &&
+      !libspectrum_identify_file_raw( &type, path, buffer, *length ) &&
+      !libspectrum_identify_class( &class, type ) &&
+      ( class == LIBSPECTRUM_CLASS_SNAPSHOT ||
+        class == LIBSPECTRUM_CLASS_COMPRESSED ) ) {
+    buffer = libspectrum_renew( libspectrum_byte, buffer, size );
+    *length += fread( buffer + *length, 1, size - *length, f );
+  }
+
+  fclose( f );
+
+  return buffer;
+}
+
+/* Build a new entry for a file; runs on the worker threads, so mustn't
+   touch anything but the job */
+static void
+scan_file( scan_job *job )
+{
+  libspectrum_metadata *metadata;
+  file_index_entry *entry, *existing;
+  const libspectrum_byte *screen;
+  libspectrum_byte *buffer;
+  struct stat file_info;
+  size_t length, i;
+
+  job->entry = NULL;
+
+  if( stat( job->path, &file_info ) || !S_ISREG( file_info.st_mode ) ) return;
+
+  /* Nothing else modifies the table while a scan is running */
+  existing = g_hash_table_lookup( entries, job->path );
+  if( existing && existing->mtime == file_info.st_mtime &&
+      existing->size == file_info.st_size ) return;
+
+  buffer = read_probe( job->path, file_info.st_size, &length );
+  if( !buffer ) return;
+
+  metadata = libspectrum_metadata_alloc();
+
+  if( libspectrum_metadata_read( metadata, buffer, length, job->path ) ) {
+    libspectrum_metadata_free( metadata );
+    libspectrum_free( buffer );
+    return;
+  }
+
+  entry = libspectrum_new0( file_index_entry, 1 );
+  entry->path = utils_safe_strdup( job->path );
+  entry->mtime = file_info.st_mtime;
+  entry->size = file_info.st_size;
+  entry->type = libspectrum_metadata_type( metadata );
+  entry->class = libspectrum_metadata_class( metadata );
+  entry->machine = libspectrum_metadata_machine( metadata );
+
+  entry->archive_info_count =
+    libspectrum_metadata_archive_info_count( metadata );
+  entry->archive_info_ids =
+    libspectrum_new( int, entry->archive_info_count );
+  entry->archive_info_strings =
+    libspectrum_new( char*, entry->archive_info_count );
+  for( i = 0; i < entry->archive_info_count; i++ ) {
+    entry->archive_info_ids[i] =
+      libspectrum_metadata_archive_info_id( metadata, i );
+    entry->archive_info_strings[i] = utils_safe_strdup(
+      libspectrum_metadata_archive_info_string( metadata, i )
+    );
+  }
+
+  screen = libspectrum_metadata_screen( metadata );
+  if( screen ) {
+    make_thumbnail( entry->thumbnail, screen );
+    entry->have_thumbnail = 1;
+  }
+
+  libspectrum_metadata_free( metadata );
+  libspectrum_free( buffer );
+
+  job->entry = entry;
+}
+
+static void*
+scan_worker( void *arg )
+{
+  scan_state *state = arg;
+  size_t n;
+
+  while( 1 ) {
+
+#ifdef HAVE_PTHREAD
+    pthread_mutex_lock( &state->lock );
+#endif				/* #ifdef HAVE_PTHREAD */
+    n = state->next++;
+#ifdef HAVE_PTHREAD
+    pthread_mutex_unlock( &state->lock );
+#endif				/* #ifdef HAVE_PTHREAD */
+
+    if( n >= state->count ) break;
+
+    scan_file( &state->jobs[n] );
+  }
+
+  return NULL;
+}
+
+static libspectrum_error
+quiet_error( libspectrum_error error GCC_UNUSED,
+             const char *format GCC_UNUSED, va_list ap GCC_UNUSED )
+{
+  return LIBSPECTRUM_ERROR_NONE;
+}
+
+void
+file_index_scan( const char * const *paths, size_t count )
+{
+  libspectrum_error_function_t error_function;
+  scan_state state;
+  size_t i;
+
+#ifdef HAVE_PTHREAD
+  pthread_t workers[ FILE_INDEX_MAX_THREADS - 1 ];
+  long cpus = 1;
+  size_t threads;
+#endif				/* #ifdef HAVE_PTHREAD */
+
+  if( !entries || !count ) return;
+
+  state.jobs = libspectrum_new( scan_job, count );
+  state.count = count;
+  state.next = 0;
+  for( i = 0; i < count; i++ ) state.jobs[i].path = paths[i];
+
+  /* A file which can't be identified just isn't indexed; that isn't worth
+     an error for every such file in a directory */
+  error_function = libspectrum_error_function;
+  libspectrum_error_function = quiet_error;
+
+#ifdef HAVE_PTHREAD
+  pthread_mutex_init( &state.lock, NULL );
+
+#ifdef _SC_NPROCESSORS_ONLN
+  cpus = sysconf( _SC_NPROCESSORS_ONLN );
+#endif				/* #ifdef _SC_NPROCESSORS_ONLN */
+  if( cpus < 1 ) cpus = 1;
+  if( cpus > FILE_INDEX_MAX_THREADS ) cpus = FILE_INDEX_MAX_THREADS;
+  if( (size_t)cpus > count ) cpus = count;
+
+  /* This thread works through the files as well */
+  for( threads = 0; threads < (size_t)cpus - 1; threads++ )
+    if( pthread_create( &workers[ threads ], NULL, scan_worker, &state ) )
+      break;
+
+  scan_worker( &state );
+
+  for( i = 0; i < threads; i++ ) pthread_join( workers[i], NULL );
+
+  pthread_mutex_destroy( &state.lock );
+#else				/* #ifdef HAVE_PTHREAD */
+  scan_worker( &state );
+#endif				/* #ifdef HAVE_PTHREAD */
+
+  libspectrum_error_function = error_function;
+
+  for( i = 0; i < count; i++ )
+    if( state.jobs[i].entry ) entry_insert( state.jobs[i].entry );
+
+  libspectrum_free( state.jobs );
+}
+
+const file_index_entry*
+file_index_lookup( const char *path )
+{
+  file_index_entry *entry;
+  struct stat file_info;
+
+  if( !entries ) return NULL;
+
+  entry = g_hash_table_lookup( entries, path );
+  if( !entry ) return NULL;
+
+  if( stat( path, &file_info ) || entry->mtime != file_info.st_mtime ||
+      entry->size != (libspectrum_qword)file_info.st_size )
+    return NULL;
+
+  return entry;
+}
+
+const char*
+file_index_archive_info( const file_index_entry *entry, int id )
+{
+  size_t i;
+
+  for( i = 0; i < entry->archive_info_count; i++ )
+    if( entry->archive_info_ids[i] == id )
+      return entry->archive_info_strings[i];
+
+  return NULL;
+}
+
+/* The on-disk index is the signature and version, followed by each entry
+   in turn, all little-endian:
+
+   word path length, path,
+   qword mtime, qword size,
+   byte type, byte class, byte machine,
+   byte archive info count, then for each: byte id, word length, string,
+   byte thumbnail present, then if it is the 64x48 thumbnail */
+
+typedef struct index_buffer {
+
+  libspectrum_byte *data;
+  size_t length;
+  size_t allocated;
+
+} index_buffer;
+
+static void
+put_bytes( index_buffer *buffer, const void *data, size_t length )
+{
+  if( buffer->length + length > buffer->allocated ) {
+    while( buffer->length + length > buffer->allocated )
+      buffer->allocated = buffer->allocated ? buffer->allocated * 2 : 0x10000;
+    buffer->data =
+      libspectrum_renew( libspectrum_byte, buffer->data, buffer->allocated );
+  }
+
+  memcpy( buffer->data + buffer->length, data, length );
+  buffer->length += length;
+}
+
+static void
+put_value( index_buffer *buffer, libspectrum_qword value, size_t length )
+{
+  libspectrum_byte bytes[8];
+  size_t i;
+
+  for( i = 0; i < length; i++ ) { bytes[i] = value & 0xff; value >>= 8; }
+
+  put_bytes( buffer, bytes, length );
+}
+
+static void
+put_string( index_buffer *buffer, const char *string )
+{
+  size_t length = strlen( string );
+
+  if( length > 0xffff ) length = 0xffff;
+
+  put_value( buffer, length, 2 );
+  put_bytes( buffer, string, length );
+}
+
+static void
+put_entry( gpointer key GCC_UNUSED, gpointer value, gpointer user_data )
+{
+  file_index_entry *entry = value;
+  index_buffer *buffer = user_data;
+  size_t i, count;
+
+  count = entry->archive_info_count;
+  if( count > 0xff ) count = 0xff;
+
+  put_string( buffer, entry->path );
+  put_value( buffer, entry->mtime, 8 );
+  put_value( buffer, entry->size, 8 );
+  put_value( buffer, entry->type, 1 );
+  put_value( buffer, entry->class, 1 );
+  put_value( buffer, entry->machine, 1 );
+
+  put_value( buffer, count, 1 );
+  for( i = 0; i < count; i++ ) {
+    put_value( buffer, entry->archive_info_ids[i], 1 );
+    put_string( buffer, entry->archive_info_strings[i] );
+  }
+
+  put_value( buffer, entry->have_thumbnail, 1 );
+  if( entry->have_thumbnail )
+    put_bytes( buffer, entry->thumbnail, sizeof( entry->thumbnail ) );
+}
+
+int
+file_index_save( const char *filename )
+{
+  index_buffer buffer = { NULL, 0, 0 };
+  int error;
+
+  if( !entries ) return 0;
+
+  put_bytes( &buffer, file_index_signature, strlen( file_index_signature ) );
+  put_value( &buffer, file_index_version, 1 );
+
+  g_hash_table_foreach( entries, put_entry, &buffer );
+
+  error = utils_write_file( filename, buffer.data, buffer.length );
+
+  libspectrum_free( buffer.data );
+
+  return error;
+}
+
+static int
+get_value( const libspectrum_byte **ptr, const libspectrum_byte *end,
+           size_t length, libspectrum_qword *value )
+{
+  size_t i;
+
+  if( (size_t)( end - *ptr ) < length ) return 1;
+
+  for( *value = 0, i = 0; i < length; i++ )
+    *value |= (libspectrum_qword)(*ptr)[i] << ( 8 * i );
+  *ptr += length;
+
+  return 0;
+}
+
+static int
+get_string( const libspectrum_byte **ptr, const libspectrum_byte *end,
+            char **string )
+{
+  libspectrum_qword length;
+
+  if( get_value( ptr, end, 2, &length ) ) return 1;
+  if( (size_t)( end - *ptr ) < length ) return 1;
+
+  *string = libspectrum_new( char, length + 1 );
+  memcpy( *string, *ptr, length );
+  (*string)[ length ] = '\0';
+  *ptr += length;
+
+  return 0;
+}
+
+static int
+get_entry( const libspectrum_byte **ptr, const libspectrum_byte *end,
+           file_index_entry **entry_out )
+{
+  file_index_entry *entry;
+  libspectrum_qword value;
+  size_t i;
+
+  entry = libspectrum_new0( file_index_entry, 1 );
+
+  if( get_string( ptr, end, &entry->path ) ) goto error;
+
+  if( get_value( ptr, end, 8, &value ) ) goto error;
+  entry->mtime = value;
+  if( get_value( ptr, end, 8, &value ) ) goto error;
+  entry->size = value;
+  if( get_value( ptr, end, 1, &value ) ) goto error;
+  entry->type = value;
+  if( get_value( ptr, end, 1, &value ) ) goto error;
+  entry->class = value;
+  if( get_value( ptr, end, 1, &value ) ) goto error;
+  entry->machine = value;
+
+  if( get_value( ptr, end, 1, &value ) ) goto error;
+  entry->archive_info_ids = libspectrum_new( int, value );
+  entry->archive_info_strings = libspectrum_new( char*, value );
+  for( i = 0; i < value; i++ ) {
+    libspectrum_qword id;
+    if( get_value( ptr, end, 1, &id ) ) goto error;
+    entry->archive_info_ids[i] = id;
+    if( get_string( ptr, end, &entry->archive_info_strings[i] ) ) goto error;
+    entry->archive_info_count++;
+  }
+
+  if( get_value( ptr, end, 1, &value ) ) goto error;
+  entry->have_thumbnail = value;
+  if( entry->have_thumbnail ) {
+    if( (size_t)( end - *ptr ) < sizeof( entry->thumbnail ) ) goto error;
+    memcpy( entry->thumbnail, *ptr, sizeof( entry->thumbnail ) );
+    *ptr += sizeof( entry->thumbnail );
+  }
+
+  *entry_out = entry;
+  return 0;
+
+ error:
+  entry_free( entry );
+  return 1;
+}
+
+int
+file_index_load( const char *filename )
+{
+  size_t signature_length = strlen( file_index_signature );
+  const libspectrum_byte *ptr, *end;
+  file_index_entry *entry;
+  utils_file file;
+
+  if( !entries ) return 1;
+
+  /* There won't be an index the first time we run */
+  if( !compat_file_exists( filename ) ) return 0;
+
+  if( utils_read_file( filename, &file ) ) return 1;
+
+  ptr = file.buffer; end = file.buffer + file.length;
+
+  /* An index written by a different version is just ignored; it'll be
+     rebuilt as files are seen again */
+  if( file.length < signature_length + 1 ||
+      memcmp( ptr, file_index_signature, signature_length ) ||
+      ptr[ signature_length ] != file_index_version ) {
+    utils_close_file( &file );
+    return 0;
+  }
+
+  ptr += signature_length + 1;
+
+  while( ptr < end ) {
+    if( get_entry( &ptr, end, &entry ) ) {
+      ui_error( UI_ERROR_WARNING, "file index '%s' is corrupt", filename );
+      break;
+    }
+    entry_insert( entry );
+  }
+
+  utils_close_file( &file );
+
+  return 0;
+}
+
+static int
+file_index_init( void *context GCC_UNUSED )
+{
+  entries = g_hash_table_new_full( g_str_hash, g_str_equal, libspectrum_free,
+                                   entry_free );
+
+  if( settings_current.file_index )
+    file_index_load( settings_current.file_index );
+
+  return 0;
+}
+
+static void
+file_index_end( void )
+{
+  if( settings_current.file_index )
+    file_index_save( settings_current.file_index );
+
+  g_hash_table_destroy( entries );
+  entries = NULL;
+}
+
+void
+file_index_register_startup( void )
+{
+  startup_manager_module dependencies[] = {
+    STARTUP_MANAGER_MODULE_LIBSPECTRUM,
+    STARTUP_MANAGER_MODULE_SETUID,
+  };
+  startup_manager_register( STARTUP_MANAGER_MODULE_FILE_INDEX, dependencies,
+                            ARRAY_SIZE( dependencies ), file_index_init, NULL,
+                            file_index_end );
+}
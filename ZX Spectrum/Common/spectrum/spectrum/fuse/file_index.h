@@ -0,0 +1,74 @@
+/* file_index.h: Index of the type, machine and title of files
+   Copyright (c) 2026 The Fuse authors
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+   Author contact information:
+
+   E-mail: philip-fuse@shadowmagic.org.uk
+
+*/
+
+#ifndef FUSE_FILE_INDEX_H
+#define FUSE_FILE_INDEX_H
+
+#include "libspectrum.h"
+
+/* The loading screen is kept at a quarter of the Spectrum's resolution */
+#define FILE_INDEX_THUMBNAIL_WIDTH 64
+#define FILE_INDEX_THUMBNAIL_HEIGHT 48
+
+typedef struct file_index_entry {
+
+  char *path;
+
+  /* Used to tell if the file has changed since it was indexed */
+  libspectrum_signed_qword mtime;
+  libspectrum_qword size;
+
+  libspectrum_id_t type;
+  libspectrum_class_t class;
+  libspectrum_machine machine;
+
+  size_t archive_info_count;
+  int *archive_info_ids;
+  char **archive_info_strings;
+
+  /* One Spectrum colour (0-15, with bright in bit 3) per pixel */
+  int have_thumbnail;
+  libspectrum_byte thumbnail[ FILE_INDEX_THUMBNAIL_WIDTH *
+                              FILE_INDEX_THUMBNAIL_HEIGHT ];
+
+} file_index_entry;
+
+void file_index_register_startup( void );
+
+/* Index any of the files which aren't already indexed or have changed
+   since they were. Files are read in parallel where threads are available;
+   this returns once they've all been done */
+void file_index_scan( const char * const *paths, size_t count );
+
+/* Get the entry for a file, or NULL if it isn't indexed or has changed */
+const file_index_entry* file_index_lookup( const char *path );
+
+/* Get an archive info string (0x00 for the title, 0x01 for the publisher,
+   etc) from an entry, or NULL if it isn't there */
+const char* file_index_archive_info( const file_index_entry *entry, int id );
+
+/* Load and save the index. Loading merges with what's already indexed */
+int file_index_load( const char *filename );
+int file_index_save( const char *filename );
+
+#endif				/* #ifndef FUSE_FILE_INDEX_H */
@@ -72,7 +72,9 @@
 #include "beta.h"
 #include "didaktik.h"
 #include "fdd.h"
+#include "file_index.h"
 #include "fuller.h"
+#include "heatmap.h"
 #include "divide.h"
 #include "simpleide.h"
 #include "zxatasp.h"
@@ -91,6 +93,8 @@
 #include "pokemem.h"
 #include "profile.h"
 #include "psg.h"
+#include "quicksave.h"
+#include "regress.h"
 #include "rzx.h"
 #include "settings.h"
 #include "slt.h"
@@ -183,6 +187,13 @@ int old_main(int argc, char **argv)
   if( settings_current.show_help ||
       settings_current.show_version ) return 0;
 
+  if( settings_current.regress ) {
+    r = regress_run( settings_current.regress,
+                     settings_current.regress_update );
+    fuse_end();
+    return r;
+  }
+
   while( !fuse_exiting ) {
     spectrum_do_frame();
   }
@@ -288,7 +299,9 @@ run_startup_manager( int *argc, char ***argv )
   divide_register_startup();
   event_register_startup();
   fdd_register_startup();
+  file_index_register_startup();
   fuller_register_startup();
+  heatmap_register_startup();
   if1_register_startup();
   if2_register_startup();
   kempmouse_register_startup();
@@ -304,7 +317,9 @@ run_startup_manager( int *argc, char ***argv )
   printer_register_startup();
   profile_register_startup();
   psg_register_startup();
+  quicksave_register_startup();
   rzx_register_startup();
+  scaler_register_startup();
   scld_register_startup();
   settings_register_startup();
   setuid_register_startup();
@@ -331,6 +346,7 @@ int fuse_init(int argc, char **argv)
   int error, first_arg;
   char *start_scaler;
   start_files_t start_files;
+  double start, phase_start;
 
   /* Seed the bad but widely-available random number
      generator with the current time */
@@ -344,6 +360,8 @@ int fuse_init(int argc, char **argv)
   
   libspectrum_error_function = ui_libspectrum_error;
 
+  start = compat_timer_get_time();
+
 #ifdef GEKKO
   /* On the Wii, init the display first so we have a way of outputting
      messages */
@@ -352,6 +370,8 @@ int fuse_init(int argc, char **argv)
 
   if( settings_init( &first_arg, argc, argv ) ) return 1;
 
+  startup_manager_trace( "settings", start );
+
   if( settings_current.show_version ) {
     fuse_show_version();
     return 0;
@@ -373,15 +393,19 @@ int fuse_init(int argc, char **argv)
 
   if( run_startup_manager( &argc, &argv ) ) return 1;
 
+  phase_start = compat_timer_get_time();
   error = machine_select_id( settings_current.start_machine );
   if( error ) return error;
+  startup_manager_trace( "machine select", phase_start );
 
   error = scaler_select_id( start_scaler ); libspectrum_free( start_scaler );
   if( error ) return error;
 
+  phase_start = compat_timer_get_time();
   if( setup_start_files( &start_files ) ) return 1;
   if( parse_nonoption_args( argc, argv, first_arg, &start_files ) ) return 1;
   if( do_start_files( &start_files ) ) return 1;
+  startup_manager_trace( "start files", phase_start );
 
   /* Must do this after all subsytems are initialised */
   debugger_command_evaluate( settings_current.debugger_command );
@@ -391,6 +415,8 @@ int fuse_init(int argc, char **argv)
   fuse_emulation_paused = 0;
   movie_init();
 
+  startup_manager_trace( "total", start );
+
   return 0;
 }
 
@@ -404,8 +430,6 @@ creator_init( void *context )
   
   libspectrum_error error; int sys_error;
 
-  const char *gcrypt_version;
-
   sscanf( VERSION, "%u.%u.%u.%u",
 	  &version[0], &version[1], &version[2], &version[3] );
 
@@ -429,11 +453,9 @@ creator_init( void *context )
 
   custom = libspectrum_new( char, CUSTOM_SIZE );
 
-  gcrypt_version = libspectrum_gcrypt_version();
-  if( !gcrypt_version ) gcrypt_version = "not available";
-
-  snprintf( custom, CUSTOM_SIZE,
-	    "gcrypt: %s\nlibspectrum: %s\nuname: %s", gcrypt_version,
+  /* Not the libgcrypt version: asking for that would initialise it, which
+     is otherwise put off until an RZX file is signed or verified */
+  snprintf( custom, CUSTOM_SIZE, "libspectrum: %s\nuname: %s",
 	    libspectrum_version(), osname );
 
   error = libspectrum_creator_set_custom(
@@ -493,23 +515,34 @@ static void fuse_show_help( void )
    "Boolean options (use `--no-<option>' to turn off):\n\n"
    "--auto-load            Automatically load tape files when opened.\n"
    "--compress-rzx         Write RZX files out compressed.\n"
+   "--compress-snapshot    Write snapshot files out compressed.\n"
+   "--fast-forward         Run as fast as possible without sound.\n"
    "--issue2               Emulate an Issue 2 Spectrum.\n"
    "--kempston             Emulate the Kempston joystick on QAOP<space>.\n"
    "--loading-sound        Emulate the sound of tapes loading.\n"
+   "--rzx-index            Keep a seek index alongside played RZX files.\n"
+   "--scanline-log         Draw each frame from a log of screen writes.\n"
    "--sound                Produce sound.\n"
    "--sound-force-8bit     Generate 8-bit sound even if 16-bit is available.\n"
    "--slt                  Turn SLT traps on.\n"
+   "--startup-trace        Report how long each part of start-up takes.\n"
    "--traps                Turn tape traps on.\n\n"
    "Other options:\n\n"
+   "--file-index <file>    Keep the file selector's index in <file>.\n"
    "--help                 This information.\n"
    "--machine <type>       Which machine should be emulated?\n"
    "--playback <filename>  Play back RZX file <filename>.\n"
+   "--quicksave-file <prefix> Also write quick-saves to <prefix>-<n>.szx.\n"
    "--record <filename>    Record to RZX file <filename>.\n"
+   "--regress <manifest>   Play the files in <manifest> against their golden\n"
+   "                       results; --regress-update writes them instead.\n"
+   "--run-ahead <frames>   Show the frame this many frames ahead.\n"
    "--separation <type>    Use ACB/ABC stereo for the AY-3-8912 sound chip.\n"
    "--snapshot <filename>  Load snapshot <filename>.\n"
    "--speed <percentage>   How fast should emulation run?\n"
    "--fb-mode <mode>       Which mode should be used for FB?\n"
    "--tape <filename>      Open tape file <filename>.\n"
+   "--tape-record-file <filename> Also write recorded tape to <filename>.\n"
    "--version              Print version number and exit.\n"
    "\n"
    "For help, please mail <fuse-emulator-devel@lists.sf.net> or use\n"
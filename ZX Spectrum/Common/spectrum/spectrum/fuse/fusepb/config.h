@@ -16,6 +16,9 @@
 /* Defined if we've got enough memory to compile z80_ops.c */
 #define HAVE_ENOUGH_MEMORY 1
 
+/* Define to 1 if you have the `fork' function. */
+/* #undef HAVE_FORK */
+
 /* Define to 1 if you have the `fsync' function. */
 #define HAVE_FSYNC 1
 
@@ -62,7 +65,7 @@
 #define HAVE_MKSTEMP 1
 
 /* Define if you have POSIX threads libraries and header files. */
-/* #undef HAVE_PTHREAD */
+#define HAVE_PTHREAD 1
 
 /* Have PTHREAD_PRIO_INHERIT. */
 #define HAVE_PTHREAD_PRIO_INHERIT 1
@@ -97,6 +100,9 @@
 /* Define to 1 if you have the <sys/types.h> header file. */
 #define HAVE_SYS_TYPES_H 1
 
+/* Define to 1 if you have the <sys/wait.h> header file. */
+#define HAVE_SYS_WAIT_H 1
+
 /* Define to 1 if you have the <unistd.h> header file. */
 #define HAVE_UNISTD_H 1
 
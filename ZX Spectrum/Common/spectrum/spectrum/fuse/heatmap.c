@@ -0,0 +1,461 @@
+/* heatmap.c: Memory access heatmap and coverage map
+   Copyright (c) 2026 The Fuse authors
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+   Author contact information:
+
+   E-mail: philip-fuse@shadowmagic.org.uk
+
+*/
+
+#include "config.h"
+
+#include <errno.h>
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "libspectrum.h"
+
+#include "event.h"
+#include "fuse.h"
+#include "heatmap.h"
+#include "memory.h"
+#include "startup_manager.h"
+#include "ui.h"
+#include "z80.h"
+
+#ifdef USE_LIBPNG
+#include <png.h>
+#endif				/* #ifdef USE_LIBPNG */
+
+/* How much "heat" one access adds to a byte; the heat saturates at 0xff */
+#define HEATMAP_STEP 0x10
+
+/* Coverage is shown at this level in exported images once the heat has
+   decayed away */
+#define HEATMAP_COVERED_LEVEL 0x40
+
+/* The image exported for each bank is this many pixels wide */
+#define HEATMAP_IMAGE_WIDTH 128
+
+typedef struct heatmap_bank {
+
+  /* Decaying per-byte heat for the display; NULL until the bank is
+     touched */
+  libspectrum_byte *counters[ HEATMAP_ACCESS_COUNT ];
+
+  /* How many accesses there have really been to each byte, for exporting */
+  libspectrum_dword *totals[ HEATMAP_ACCESS_COUNT ];
+
+  /* HEATMAP_FLAG_* for every access seen this session */
+  libspectrum_byte *coverage;
+
+  /* Set if any counter in this bank may be non-zero */
+  int warm;
+
+} heatmap_bank;
+
+int heatmap_active = 0;
+
+static heatmap_bank ram_banks[ SPECTRUM_RAM_PAGES ];
+static heatmap_bank rom_banks[ SPECTRUM_ROM_PAGES ];
+
+static void
+bank_allocate( heatmap_bank *bank )
+{
+  size_t i;
+
+  for( i = 0; i < HEATMAP_ACCESS_COUNT; i++ ) {
+    bank->counters[i] = libspectrum_new0( libspectrum_byte,
+                                          HEATMAP_BANK_SIZE );
+    bank->totals[i] = libspectrum_new0( libspectrum_dword,
+                                        HEATMAP_BANK_SIZE );
+  }
+  bank->coverage = libspectrum_new0( libspectrum_byte, HEATMAP_BANK_SIZE );
+  bank->warm = 0;
+}
+
+static void
+bank_free( heatmap_bank *bank )
+{
+  size_t i;
+
+  for( i = 0; i < HEATMAP_ACCESS_COUNT; i++ ) {
+    libspectrum_free( bank->counters[i] );
+    bank->counters[i] = NULL;
+    libspectrum_free( bank->totals[i] );
+    bank->totals[i] = NULL;
+  }
+  libspectrum_free( bank->coverage );
+  bank->coverage = NULL;
+  bank->warm = 0;
+}
+
+static void
+heatmap_free( void )
+{
+  size_t i;
+
+  for( i = 0; i < SPECTRUM_RAM_PAGES; i++ ) bank_free( &ram_banks[i] );
+  for( i = 0; i < SPECTRUM_ROM_PAGES; i++ ) bank_free( &rom_banks[i] );
+}
+
+static int
+heatmap_init( void *context )
+{
+  heatmap_active = 0;
+
+  return 0;
+}
+
+static void
+heatmap_end( void )
+{
+  heatmap_active = 0;
+  heatmap_free();
+}
+
+void
+heatmap_register_startup( void )
+{
+  startup_manager_module dependencies[] = {
+    STARTUP_MANAGER_MODULE_MEMORY,
+    STARTUP_MANAGER_MODULE_SETUID,
+  };
+  startup_manager_register( STARTUP_MANAGER_MODULE_HEATMAP, dependencies,
+                            ARRAY_SIZE( dependencies ), heatmap_init, NULL,
+                            heatmap_end );
+}
+
+void
+heatmap_start( void )
+{
+  heatmap_free();
+
+  heatmap_active = 1;
+
+  /* Schedule an event to ensure that the main z80 emulation loop recognises
+     the heatmap is turned on */
+  event_add( tstates, event_type_null );
+}
+
+void
+heatmap_stop( void )
+{
+  /* The data is kept so it can still be viewed and exported */
+  heatmap_active = 0;
+
+  event_add( tstates, event_type_null );
+}
+
+static void
+heatmap_touch( const memory_page *mapping, libspectrum_word address,
+               heatmap_access access )
+{
+  heatmap_bank *bank;
+  libspectrum_byte *counter;
+  libspectrum_dword *total;
+  size_t offset;
+
+  if( mapping->source == memory_source_ram ) {
+    if( mapping->page_num < 0 || mapping->page_num >= SPECTRUM_RAM_PAGES )
+      return;
+    bank = &ram_banks[ mapping->page_num ];
+  } else if( mapping->source == memory_source_rom ) {
+    if( mapping->page_num < 0 || mapping->page_num >= SPECTRUM_ROM_PAGES )
+      return;
+    bank = &rom_banks[ mapping->page_num ];
+  } else {
+    return;
+  }
+
+  if( !bank->coverage ) bank_allocate( bank );
+
+  offset = ( mapping->offset + ( address & MEMORY_PAGE_SIZE_MASK ) ) &
+           ( HEATMAP_BANK_SIZE - 1 );
+
+  counter = &bank->counters[ access ][ offset ];
+  *counter = *counter > 0xff - HEATMAP_STEP ? 0xff : *counter + HEATMAP_STEP;
+
+  /* Only stops counting after about an hour of nothing but accesses to this
+     byte at 3.5MHz */
+  total = &bank->totals[ access ][ offset ];
+  if( *total != 0xffffffff ) (*total)++;
+
+  bank->coverage[ offset ] |= 1 << access;
+  bank->warm = 1;
+}
+
+void
+heatmap_read( libspectrum_word address )
+{
+  heatmap_touch( &memory_map_read[ address >> MEMORY_PAGE_SIZE_LOGARITHM ],
+                 address, HEATMAP_READ );
+}
+
+void
+heatmap_write( libspectrum_word address )
+{
+  heatmap_touch( &memory_map_write[ address >> MEMORY_PAGE_SIZE_LOGARITHM ],
+                 address, HEATMAP_WRITE );
+}
+
+void
+heatmap_execute( libspectrum_word address )
+{
+  heatmap_touch( &memory_map_read[ address >> MEMORY_PAGE_SIZE_LOGARITHM ],
+                 address, HEATMAP_EXECUTE );
+}
+
+static void
+bank_decay( heatmap_bank *bank )
+{
+  size_t i, j;
+  int warm = 0;
+
+  if( !bank->warm ) return;
+
+  for( i = 0; i < HEATMAP_ACCESS_COUNT; i++ ) {
+    libspectrum_byte *counters = bank->counters[i];
+
+    /* Lose 1/8 of the heat each frame, rounding up so everything eventually
+       reaches zero */
+    for( j = 0; j < HEATMAP_BANK_SIZE; j++ ) {
+      if( counters[j] ) {
+        counters[j] -= ( counters[j] + 7 ) >> 3;
+        warm |= counters[j];
+      }
+    }
+  }
+
+  bank->warm = warm;
+}
+
+void
+heatmap_frame( void )
+{
+  size_t i;
+
+  for( i = 0; i < SPECTRUM_RAM_PAGES; i++ ) bank_decay( &ram_banks[i] );
+  for( i = 0; i < SPECTRUM_ROM_PAGES; i++ ) bank_decay( &rom_banks[i] );
+}
+
+static const heatmap_bank*
+get_bank( int rom, int bank )
+{
+  if( rom ) {
+    if( bank < 0 || bank >= SPECTRUM_ROM_PAGES ) return NULL;
+    return &rom_banks[ bank ];
+  }
+
+  if( bank < 0 || bank >= SPECTRUM_RAM_PAGES ) return NULL;
+  return &ram_banks[ bank ];
+}
+
+const libspectrum_byte*
+heatmap_counters( int rom, int bank, heatmap_access access )
+{
+  const heatmap_bank *b = get_bank( rom, bank );
+
+  return b ? b->counters[ access ] : NULL;
+}
+
+const libspectrum_byte*
+heatmap_coverage( int rom, int bank )
+{
+  const heatmap_bank *b = get_bank( rom, bank );
+
+  return b ? b->coverage : NULL;
+}
+
+static int
+export_csv( const char *filename, const heatmap_bank *bank )
+{
+  FILE *f;
+  size_t i;
+
+  f = fopen( filename, "w" );
+  if( !f ) {
+    ui_error( UI_ERROR_ERROR, "unable to open heatmap '%s' for writing: %s",
+              filename, strerror( errno ) );
+    return 1;
+  }
+
+  fprintf( f, "offset,flags,read,write,execute\n" );
+
+  for( i = 0; i < HEATMAP_BANK_SIZE; i++ ) {
+
+    if( !bank->coverage[i] ) continue;
+
+    fprintf( f, "0x%04lx,%c%c%c,%lu,%lu,%lu\n", (unsigned long)i,
+             bank->coverage[i] & HEATMAP_FLAG_READ    ? 'r' : '-',
+             bank->coverage[i] & HEATMAP_FLAG_WRITE   ? 'w' : '-',
+             bank->coverage[i] & HEATMAP_FLAG_EXECUTE ? 'x' : '-',
+             (unsigned long)bank->totals[ HEATMAP_READ ][i],
+             (unsigned long)bank->totals[ HEATMAP_WRITE ][i],
+             (unsigned long)bank->totals[ HEATMAP_EXECUTE ][i] );
+  }
+
+  if( fclose( f ) ) {
+    ui_error( UI_ERROR_ERROR, "couldn't close '%s': %s", filename,
+              strerror( errno ) );
+    return 1;
+  }
+
+  return 0;
+}
+
+#ifdef USE_LIBPNG
+
+static libspectrum_byte
+pixel_level( const heatmap_bank *bank, size_t offset, heatmap_access access )
+{
+  libspectrum_byte level = bank->counters[ access ][ offset ];
+
+  if( level < HEATMAP_COVERED_LEVEL && bank->coverage[ offset ] & 1 << access )
+    level = HEATMAP_COVERED_LEVEL;
+
+  return level;
+}
+
+/* One pixel per byte: red for writes, green for execution and blue for
+   reads */
+static int
+export_png( const char *filename, const heatmap_bank *bank )
+{
+  static libspectrum_byte
+    png_data[ HEATMAP_BANK_SIZE * 3 ];
+  libspectrum_byte *row_pointers[ HEATMAP_BANK_SIZE / HEATMAP_IMAGE_WIDTH ];
+  size_t height = HEATMAP_BANK_SIZE / HEATMAP_IMAGE_WIDTH;
+  png_structp png_ptr;
+  png_infop info_ptr;
+  FILE *f;
+  size_t i;
+
+  for( i = 0; i < HEATMAP_BANK_SIZE; i++ ) {
+    png_data[ i * 3     ] = pixel_level( bank, i, HEATMAP_WRITE );
+    png_data[ i * 3 + 1 ] = pixel_level( bank, i, HEATMAP_EXECUTE );
+    png_data[ i * 3 + 2 ] = pixel_level( bank, i, HEATMAP_READ );
+  }
+
+  for( i = 0; i < height; i++ )
+    row_pointers[i] = &png_data[ i * HEATMAP_IMAGE_WIDTH * 3 ];
+
+  f = fopen( filename, "wb" );
+  if( !f ) {
+    ui_error( UI_ERROR_ERROR, "Couldn't open `%s': %s", filename,
+	      strerror( errno ) );
+    return 1;
+  }
+
+  png_ptr = png_create_write_struct( PNG_LIBPNG_VER_STRING,
+				     NULL, NULL, NULL );
+  if( !png_ptr ) {
+    ui_error( UI_ERROR_ERROR, "Couldn't allocate png_ptr" );
+    fclose( f );
+    return 1;
+  }
+
+  info_ptr = png_create_info_struct( png_ptr );
+  if( !info_ptr ) {
+    ui_error( UI_ERROR_ERROR, "Couldn't allocate info_ptr" );
+    png_destroy_write_struct( &png_ptr, NULL );
+    fclose( f );
+    return 1;
+  }
+
+  if( setjmp( png_jmpbuf( png_ptr ) ) ) {
+    ui_error( UI_ERROR_ERROR, "Error from libpng" );
+    png_destroy_write_struct( &png_ptr, &info_ptr );
+    fclose( f );
+    return 1;
+  }
+
+  png_init_io( png_ptr, f );
+
+  png_set_IHDR( png_ptr, info_ptr,
+		HEATMAP_IMAGE_WIDTH, height, 8,
+		PNG_COLOR_TYPE_RGB,
+		PNG_INTERLACE_NONE,
+		PNG_COMPRESSION_TYPE_DEFAULT,
+		PNG_FILTER_TYPE_DEFAULT );
+
+  png_set_rows( png_ptr, info_ptr, row_pointers );
+
+  png_write_png( png_ptr, info_ptr, PNG_TRANSFORM_IDENTITY, NULL );
+
+  png_destroy_write_struct( &png_ptr, &info_ptr );
+
+  if( fclose( f ) ) {
+    ui_error( UI_ERROR_ERROR, "Couldn't close `%s': %s", filename,
+	      strerror( errno ) );
+    return 1;
+  }
+
+  return 0;
+}
+
+#endif				/* #ifdef USE_LIBPNG */
+
+static int
+export_bank( const char *prefix, const char *type, int number,
+             const heatmap_bank *bank, heatmap_format format )
+{
+  char filename[ PATH_MAX ];
+
+  if( !bank->coverage ) return 0;
+
+  switch( format ) {
+
+  case HEATMAP_FORMAT_CSV:
+    snprintf( filename, PATH_MAX, "%s-%s%02d.csv", prefix, type, number );
+    return export_csv( filename, bank );
+
+  case HEATMAP_FORMAT_PNG:
+#ifdef USE_LIBPNG
+    snprintf( filename, PATH_MAX, "%s-%s%02d.png", prefix, type, number );
+    return export_png( filename, bank );
+#else				/* #ifdef USE_LIBPNG */
+    ui_error( UI_ERROR_ERROR,
+              "Fuse was compiled without libpng; can't write heatmap images" );
+    return 1;
+#endif				/* #ifdef USE_LIBPNG */
+
+  }
+
+  ui_error( UI_ERROR_ERROR, "unknown heatmap format %d", format );
+  return 1;
+}
+
+int
+heatmap_export( const char *prefix, heatmap_format format )
+{
+  size_t i;
+  int error;
+
+  for( i = 0; i < SPECTRUM_RAM_PAGES; i++ ) {
+    error = export_bank( prefix, "ram", i, &ram_banks[i], format );
+    if( error ) return error;
+  }
+
+  for( i = 0; i < SPECTRUM_ROM_PAGES; i++ ) {
+    error = export_bank( prefix, "rom", i, &rom_banks[i], format );
+    if( error ) return error;
+  }
+
+  return 0;
+}
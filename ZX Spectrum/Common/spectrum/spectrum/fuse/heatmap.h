@@ -0,0 +1,79 @@
+/* heatmap.h: Memory access heatmap and coverage map
+   Copyright (c) 2026 The Fuse authors
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+   Author contact information:
+
+   E-mail: philip-fuse@shadowmagic.org.uk
+
+*/
+
+#ifndef FUSE_HEATMAP_H
+#define FUSE_HEATMAP_H
+
+#include "libspectrum.h"
+
+/* The kinds of access we track */
+typedef enum heatmap_access {
+  HEATMAP_READ,
+  HEATMAP_WRITE,
+  HEATMAP_EXECUTE,
+
+  HEATMAP_ACCESS_COUNT
+} heatmap_access;
+
+/* Coverage flags, accumulated for the whole session and never decayed */
+#define HEATMAP_FLAG_READ    ( 1 << HEATMAP_READ )
+#define HEATMAP_FLAG_WRITE   ( 1 << HEATMAP_WRITE )
+#define HEATMAP_FLAG_EXECUTE ( 1 << HEATMAP_EXECUTE )
+
+/* The size of one bank in the heatmap */
+#define HEATMAP_BANK_SIZE 0x4000
+
+/* Export formats */
+typedef enum heatmap_format {
+  HEATMAP_FORMAT_CSV,
+  HEATMAP_FORMAT_PNG,
+} heatmap_format;
+
+extern int heatmap_active;
+
+void heatmap_register_startup( void );
+
+void heatmap_start( void );
+void heatmap_stop( void );
+
+/* Slow paths called from readbyte(), writebyte() and the opcode fetch when
+   heatmap_active is set */
+void heatmap_read( libspectrum_word address );
+void heatmap_write( libspectrum_word address );
+void heatmap_execute( libspectrum_word address );
+
+/* Decay the per-byte heat shown by the viewer; called once per frame. The
+   access counts in exported CSV files don't decay */
+void heatmap_frame( void );
+
+/* Access to the data for a 16K bank; 'rom' selects the ROM banks rather than
+   the RAM banks. Return NULL if nothing in the bank has been touched */
+const libspectrum_byte* heatmap_counters( int rom, int bank,
+                                          heatmap_access access );
+const libspectrum_byte* heatmap_coverage( int rom, int bank );
+
+/* Write one file per touched bank, named <prefix>-ram<n>.<ext> or
+   <prefix>-rom<n>.<ext> */
+int heatmap_export( const char *prefix, heatmap_format format );
+
+#endif			/* #ifndef FUSE_HEATMAP_H */
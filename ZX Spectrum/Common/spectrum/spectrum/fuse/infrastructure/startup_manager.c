@@ -29,8 +29,12 @@
 #include <glib.h>
 #endif				/* #ifdef HAVE_LIB_GLIB */
 
+#include <stdio.h>
+
 #include "libspectrum.h"
 
+#include "compat.h"
+#include "settings.h"
 #include "startup_manager.h"
 #include "ui.h"
 
@@ -46,6 +50,18 @@ static GArray *registered_modules;
 
 static GArray *end_functions;
 
+/* For --startup-trace; must be kept in the same order as
+   startup_manager_module */
+static const char * const module_names[] = {
+  "ay", "beta", "creator", "debugger", "didaktik", "disciple", "display",
+  "divide", "event", "fdd", "file_index", "fuller", "heatmap", "if1", "if2",
+  "kempmouse", "libspectrum", "libxml2", "machine", "machines_periph",
+  "melodik", "memory", "mempool", "opus", "plusd", "printer", "profile",
+  "psg", "quicksave", "rzx", "scaler", "scld", "settings_end", "setuid",
+  "simpleide", "slt", "sound", "speccyboot", "specdrum", "spectranet",
+  "spectrum", "tape", "timer", "ula", "usource", "z80", "zxatasp", "zxcf",
+};
+
 void
 startup_manager_init( void )
 {
@@ -106,12 +122,22 @@ remove_dependency( startup_manager_module module )
   }
 }
 
+void
+startup_manager_trace( const char *what, double start )
+{
+  if( !settings_current.startup_trace ) return;
+
+  fprintf( stderr, "startup: %-16s %8.2f ms\n", what,
+           ( compat_timer_get_time() - start ) * 1000 );
+}
+
 int
 startup_manager_run( void )
 {
   int progress_made;
   guint i;
   int error;
+  double start;
 
   /* Loop until we can't make any more progress; this will either be because
      we've called every function (good!) or because there's a logical error
@@ -127,10 +153,13 @@ startup_manager_run( void )
       if( registered_module->dependencies->len == 0 ) {
 
         if( registered_module->init_fn ) {
+          start = compat_timer_get_time();
           error = registered_module->init_fn(
             registered_module->init_context
           );
           if( error ) return error;
+          startup_manager_trace( module_names[ registered_module->module ],
+                                 start );
         }
 
         if( registered_module->end_fn )
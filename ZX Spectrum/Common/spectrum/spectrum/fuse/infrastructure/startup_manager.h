@@ -39,7 +39,9 @@ typedef enum startup_manager_module {
   STARTUP_MANAGER_MODULE_DIVIDE,
   STARTUP_MANAGER_MODULE_EVENT,
   STARTUP_MANAGER_MODULE_FDD,
+  STARTUP_MANAGER_MODULE_FILE_INDEX,
   STARTUP_MANAGER_MODULE_FULLER,
+  STARTUP_MANAGER_MODULE_HEATMAP,
   STARTUP_MANAGER_MODULE_IF1,
   STARTUP_MANAGER_MODULE_IF2,
   STARTUP_MANAGER_MODULE_KEMPMOUSE,
@@ -55,7 +57,9 @@ typedef enum startup_manager_module {
   STARTUP_MANAGER_MODULE_PRINTER,
   STARTUP_MANAGER_MODULE_PROFILE,
   STARTUP_MANAGER_MODULE_PSG,
+  STARTUP_MANAGER_MODULE_QUICKSAVE,
   STARTUP_MANAGER_MODULE_RZX,
+  STARTUP_MANAGER_MODULE_SCALER,
   STARTUP_MANAGER_MODULE_SCLD,
   STARTUP_MANAGER_MODULE_SETTINGS_END,
   STARTUP_MANAGER_MODULE_SETUID,
@@ -85,6 +89,10 @@ typedef void (*startup_manager_end_fn)( void );
 /* Initialise the startup manager itself */
 void startup_manager_init( void );
 
+/* With --startup-trace, report <what> as having taken the time since
+   <start>, as given by compat_timer_get_time() */
+void startup_manager_trace( const char *what, double start );
+
 /* Register an module with the startup manager */
 void startup_manager_register(
   startup_manager_module module, startup_manager_module *dependencies,
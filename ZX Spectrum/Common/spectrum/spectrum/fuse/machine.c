@@ -60,16 +60,37 @@ fuse_machine_info *machine_current = NULL; /* The currently selected machine */
 static int machine_location;	/* Where is the current machine in
 				   machine_types[...]? */
 
+/* Every reset maps the ROMs afresh, so keep each ROM file as first read
+   rather than searching for and reading it again every time */
+typedef struct rom_image {
+  libspectrum_byte *data;
+  size_t length;
+} rom_image;
+
+static GHashTable *rom_cache;
+
 static int machine_add_machine( int (*init_function)(fuse_machine_info *machine) );
 static int machine_select_machine( fuse_machine_info *machine );
 static void machine_set_const_timings( fuse_machine_info *machine );
 static void machine_set_variable_timings( fuse_machine_info *machine );
 
+static void
+rom_image_free( gpointer data )
+{
+  rom_image *image = data;
+
+  libspectrum_free( image->data );
+  libspectrum_free( image );
+}
+
 static int
 machine_init_machines( void *context )
 {
   int error;
 
+  rom_cache = g_hash_table_new_full( g_str_hash, g_str_equal,
+                                     libspectrum_free, rom_image_free );
+
   error = machine_add_machine( spec16_init    );
   if (error ) return error;
   error = machine_add_machine( spec48_init    );
@@ -311,29 +332,39 @@ machine_load_rom_bank_from_file( memory_page* bank_map, int page_num,
 {
   int error;
   utils_file rom;
+  rom_image *image;
 
-  error = utils_read_auxiliary_file( filename, &rom, UTILS_AUXILIARY_ROM );
-  if( error == -1 ) {
-    ui_error( UI_ERROR_ERROR, "couldn't find ROM '%s'", filename );
-    return 1;
+  image = g_hash_table_lookup( rom_cache, filename );
+
+  if( !image ) {
+
+    error = utils_read_auxiliary_file( filename, &rom, UTILS_AUXILIARY_ROM );
+    if( error == -1 ) {
+      ui_error( UI_ERROR_ERROR, "couldn't find ROM '%s'", filename );
+      return 1;
+    }
+    if( error ) return error;
+
+    image = libspectrum_new( rom_image, 1 );
+    image->length = rom.length;
+    image->data = libspectrum_new( libspectrum_byte, rom.length );
+    memcpy( image->data, rom.buffer, rom.length );
+
+    utils_close_file( &rom );
+
+    g_hash_table_insert( rom_cache, utils_safe_strdup( filename ), image );
   }
-  if( error ) return error;
   
-  if( rom.length != expected_length ) {
+  if( image->length != expected_length ) {
     ui_error( UI_ERROR_ERROR,
 	      "ROM '%s' is %ld bytes long; expected %ld bytes",
-	      filename, (unsigned long)rom.length,
+	      filename, (unsigned long)image->length,
 	      (unsigned long)expected_length );
-    utils_close_file( &rom );
     return 1;
   }
 
-  error = machine_load_rom_bank_from_buffer( bank_map, page_num, rom.buffer,
-    rom.length, custom );
-
-  utils_close_file( &rom );
-
-  return error;
+  return machine_load_rom_bank_from_buffer( bank_map, page_num, image->data,
+    image->length, custom );
 }
 
 int
@@ -393,10 +424,16 @@ machine_reset( int hard_reset )
   SetEmulationHz( (float)machine_current->timings.processor_speed /
                   machine_current->timings.tstates_per_frame );
 
-  /* Set up the contention array */
+  /* Set up the contention array, noting the window in which any contention
+     occurs so the Z80 core can skip the checks outside it */
+  ula_contention_start = ula_contention_end = 0;
   for( i = 0; i < machine_current->timings.tstates_per_frame; i++ ) {
     ula_contention[ i ] = machine_current->ram.contend_delay( i );
     ula_contention_no_mreq[ i ] = machine_current->ram.contend_delay_no_mreq( i );
+    if( ula_contention[ i ] || ula_contention_no_mreq[ i ] ) {
+      if( !ula_contention_end ) ula_contention_start = i;
+      ula_contention_end = i + 1;
+    }
   }
 
   /* Update the disk menu items */
@@ -472,6 +509,8 @@ machine_end( void )
   }
 
   libspectrum_free( machine_types );
+
+  g_hash_table_destroy( rom_cache );
 }
 
 void
@@ -34,12 +34,14 @@
 #include "debugger.h"
 #include "display.h"
 #include "fuse.h"
+#include "heatmap.h"
 #include "startup_manager.h"
 #include "pentagon.h"
 #include "spec128.h"
 #include "memory.h"
 #include "module.h"
 #include "opus.h"
+#include "periph.h"
 #include "spectranet.h"
 #include "ula.h"
 #include "settings.h"
@@ -85,6 +87,8 @@ libspectrum_word memory_screen_mask;
 
 static void memory_from_snapshot( libspectrum_snap *snap );
 static void memory_to_snapshot( libspectrum_snap *snap );
+static void memory_to_state( module_state *state );
+static void memory_from_state( module_state *state );
 
 static module_info_t memory_module_info = {
 
@@ -93,6 +97,8 @@ static module_info_t memory_module_info = {
   NULL,
   memory_from_snapshot,
   memory_to_snapshot,
+  memory_to_state,
+  memory_from_state,
 
 };
 
@@ -348,6 +354,24 @@ memory_map_romcs_2k( libspectrum_word address, memory_page source[] )
     memory_map_read[ start + i ] = memory_map_write[ start + i ] = source[ i ];
 }
 
+/* The part of a memory read common to readbyte() and readbyte_uncontended():
+   anything which needs to see the access, then the byte itself */
+static inline libspectrum_byte
+read_mapped( memory_page *mapping, libspectrum_word address )
+{
+  if( opus_active && address >= 0x2800 && address < 0x3800 )
+    return opus_read( address );
+
+  if( spectranet_paged ) {
+    if( spectranet_w5100_paged_a && address >= 0x1000 && address < 0x2000 )
+      return spectranet_w5100_read( mapping, address );
+    if( spectranet_w5100_paged_b && address >= 0x2000 && address < 0x3000 )
+      return spectranet_w5100_read( mapping, address );
+  }
+
+  return mapping->page[ address & MEMORY_PAGE_SIZE_MASK ];
+}
+
 libspectrum_byte
 readbyte( libspectrum_word address )
 {
@@ -360,20 +384,23 @@ readbyte( libspectrum_word address )
   if( debugger_mode != DEBUGGER_MODE_INACTIVE )
     debugger_check( DEBUGGER_BREAKPOINT_TYPE_READ, address );
 
+  if( heatmap_active ) heatmap_read( address );
+
   if( mapping->contended ) tstates += ula_contention[ tstates ];
   tstates += 3;
 
-  if( opus_active && address >= 0x2800 && address < 0x3800 )
-    return opus_read( address );
+  return read_mapped( mapping, address );
+}
 
-  if( spectranet_paged ) {
-    if( spectranet_w5100_paged_a && address >= 0x1000 && address < 0x2000 )
-      return spectranet_w5100_read( mapping, address );
-    if( spectranet_w5100_paged_b && address >= 0x2000 && address < 0x3000 )
-      return spectranet_w5100_read( mapping, address );
-  }
+/* As readbyte(), but for use by the Z80 core only when it knows the access
+   can't be contended and neither the debugger nor the heatmap is active */
+libspectrum_byte
+readbyte_uncontended( libspectrum_word address )
+{
+  tstates += 3;
 
-  return mapping->page[ address & MEMORY_PAGE_SIZE_MASK ];
+  return read_mapped( &memory_map_read[ address >> MEMORY_PAGE_SIZE_LOGARITHM ],
+                      address );
 }
 
 void
@@ -388,6 +415,8 @@ writebyte( libspectrum_word address, libspectrum_byte b )
   if( debugger_mode != DEBUGGER_MODE_INACTIVE )
     debugger_check( DEBUGGER_BREAKPOINT_TYPE_WRITE, address );
 
+  if( heatmap_active ) heatmap_write( address );
+
   if( mapping->contended ) tstates += ula_contention[ tstates ];
 
   tstates += 3;
@@ -395,6 +424,15 @@ writebyte( libspectrum_word address, libspectrum_byte b )
   writebyte_internal( address, b );
 }
 
+/* The write equivalent of readbyte_uncontended() */
+void
+writebyte_uncontended( libspectrum_word address, libspectrum_byte b )
+{
+  tstates += 3;
+
+  writebyte_internal( address, b );
+}
+
 void
 memory_display_dirty_pentagon_16_col( libspectrum_word address,
                                       libspectrum_byte b )
@@ -434,6 +472,17 @@ memory_display_dirty_sinclair( libspectrum_word address, libspectrum_byte b ) \
   /* The offset into the 16Kb RAM page (as opposed to the 2Kb chunk) */
   libspectrum_word offset2 = offset + mapping->offset;
 
+  /* With the scanline log, just note any change to either screen and leave
+     working out what it changed until the end of the frame */
+  if( display_log_active ) {
+    if( mapping->source == memory_source_ram &&
+        ( mapping->page_num == 5 || mapping->page_num == 7 ) &&
+        offset2 < 0x1b00 &&
+        memory[ offset ] != b )
+      display_log_write( mapping->page_num, offset2, memory[ offset ], b );
+    return;
+  }
+
   /* If this is a write to the current screen (and it actually changes
      the destination), redraw that bit */
   if( mapping->source == memory_source_ram && 
@@ -482,6 +531,11 @@ writebyte_internal( libspectrum_word address, libspectrum_byte b )
 void
 memory_romcs_map( void )
 {
+  /* Every machine's memory map comes through here, including when a
+     peripheral pages itself in or out from a port write, so this is where
+     the trap map finds out about paging between traps */
+  periph_update_traps();
+
   /* Nothing changes if /ROMCS is not set */
   if( !machine_current->ram.romcs ) return;
 
@@ -529,7 +583,8 @@ memory_from_snapshot( libspectrum_snap *snap )
   }
 
   for( i = 0; i < 64; i++ )
-    if( libspectrum_snap_pages( snap, i ) )
+    if( libspectrum_snap_pages( snap, i ) &&
+        libspectrum_snap_pages( snap, i ) != RAM[i] )
       memcpy( RAM[i], libspectrum_snap_pages( snap, i ), 0x4000 );
 
   if( libspectrum_snap_custom_rom( snap ) ) {
@@ -635,6 +690,12 @@ memory_to_snapshot( libspectrum_snap *snap )
   for( i = 0; i < 64; i++ ) {
     if( RAM[i] != NULL ) {
 
+      /* No need for a copy if the snap has been given our RAM to use */
+      if( libspectrum_snap_page_buffer_page( snap, i ) == RAM[i] ) {
+        libspectrum_snap_set_pages( snap, i, RAM[i] );
+        continue;
+      }
+
       buffer = libspectrum_new( libspectrum_byte, 0x4000 );
 
       memcpy( buffer, RAM[i], 0x4000 );
@@ -645,6 +706,34 @@ memory_to_snapshot( libspectrum_snap *snap )
   memory_rom_to_snapshot( snap );
 }
 
+/* The number of RAM pages held in a module state; the 48K machines use
+   pages 0, 2 and 5, so always include the first eight */
+static size_t
+state_pages( void )
+{
+  return machine_current->ram.valid_pages < 8 ?
+         8 : machine_current->ram.valid_pages;
+}
+
+static void
+memory_to_state( module_state *state )
+{
+  module_state_write( state, &machine_current->ram,
+                      sizeof( machine_current->ram ) );
+  module_state_write( state, RAM, state_pages() * 0x4000 );
+}
+
+/* Paging state is restored directly rather than via the port write
+   functions so the 128K paging lock doesn't get in the way; the caller
+   must call machine_current->memory_map() afterwards */
+static void
+memory_from_state( module_state *state )
+{
+  module_state_read( state, &machine_current->ram,
+                     sizeof( machine_current->ram ) );
+  module_state_read( state, RAM, state_pages() * 0x4000 );
+}
+
 /* Check whether we're actually in the right ROM when a tape or other traps
    hit */
 int
@@ -160,6 +160,7 @@ void memory_map_romcs_4k( libspectrum_word address, memory_page source[] );
 void memory_map_romcs_2k( libspectrum_word address, memory_page source[] );
 
 libspectrum_byte readbyte( libspectrum_word address );
+libspectrum_byte readbyte_uncontended( libspectrum_word address );
 
 /* Use a macro for performance in the main core, but a function for
    flexibility in the core tester */
@@ -177,6 +178,7 @@ libspectrum_byte readbyte_internal( libspectrum_word address );
 
 void writebyte( libspectrum_word address, libspectrum_byte b );
 void writebyte_internal( libspectrum_word address, libspectrum_byte b );
+void writebyte_uncontended( libspectrum_word address, libspectrum_byte b );
 
 typedef void (*memory_display_dirty_fn)( libspectrum_word address,
                                          libspectrum_byte b );
@@ -34,6 +34,7 @@
 
 #include "event.h"
 #include "fuse.h"
+#include "heatmap.h"
 #include "menu.h"
 #include "movie.h"
 #include "specplus3.h"
@@ -52,10 +53,12 @@
 #include "joystick.h"
 #include "profile.h"
 #include "psg.h"
+#include "quicksave.h"
 #include "rzx.h"
 #include "screenshot.h"
 #include "settings.h"
 #include "snapshot.h"
+#include "spectrum.h"
 #include "svg.h"
 #include "tape.h"
 #include "scaler.h"
@@ -88,6 +91,34 @@ MENU_CALLBACK( menu_file_open )
   fuse_emulation_unpause();
 }
 
+MENU_CALLBACK( menu_file_quicksave_save )
+{
+  ui_widget_finish();
+  quicksave_save( quicksave_current_slot );
+}
+
+MENU_CALLBACK( menu_file_quicksave_load )
+{
+  ui_widget_finish();
+  quicksave_load( quicksave_current_slot );
+}
+
+MENU_CALLBACK( menu_file_quicksave_nextslot )
+{
+  ui_widget_finish();
+  quicksave_select_slot( 1 );
+  ui_error( UI_ERROR_INFO, "Quick-save slot %d%s", quicksave_current_slot + 1,
+            quicksave_slot_used( quicksave_current_slot ) ? "" : " (empty)" );
+}
+
+MENU_CALLBACK( menu_file_quicksave_previousslot )
+{
+  ui_widget_finish();
+  quicksave_select_slot( -1 );
+  ui_error( UI_ERROR_INFO, "Quick-save slot %d%s", quicksave_current_slot + 1,
+            quicksave_slot_used( quicksave_current_slot ) ? "" : " (empty)" );
+}
+
 MENU_CALLBACK( menu_file_recording_insertsnapshot )
 {
   libspectrum_snap *snap;
@@ -334,12 +365,50 @@ MENU_CALLBACK( menu_machine_profiler_stop )
   fuse_emulation_unpause();
 }
 
+MENU_CALLBACK( menu_machine_memoryheatmap_start )
+{
+  ui_widget_finish();
+  heatmap_start();
+}
+
+MENU_CALLBACK( menu_machine_memoryheatmap_stop )
+{
+  ui_widget_finish();
+  heatmap_stop();
+}
+
+MENU_CALLBACK( menu_machine_memoryheatmap_export )
+{
+  char *filename;
+
+  fuse_emulation_pause();
+
+  filename = ui_get_save_filename( "Fuse - Export Memory Heatmap" );
+  if( !filename ) { fuse_emulation_unpause(); return; }
+
+  if( !heatmap_export( filename, HEATMAP_FORMAT_CSV ) ) {
+#ifdef USE_LIBPNG
+    heatmap_export( filename, HEATMAP_FORMAT_PNG );
+#endif
+  }
+
+  libspectrum_free( filename );
+
+  fuse_emulation_unpause();
+}
+
 MENU_CALLBACK( menu_machine_nmi )
 {
   ui_widget_finish();
   event_add( 0, z80_nmi_event );
 }
 
+MENU_CALLBACK( menu_machine_fastforward )
+{
+  ui_widget_finish();
+  spectrum_set_fast_forward( !settings_current.fast_forward );
+}
+
 MENU_CALLBACK( menu_media_tape_open )
 {
   char *filename;
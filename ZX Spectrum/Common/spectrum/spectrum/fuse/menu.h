@@ -56,6 +56,10 @@
  */
 
 MENU_CALLBACK( menu_file_open );
+MENU_CALLBACK( menu_file_quicksave_save );
+MENU_CALLBACK( menu_file_quicksave_load );
+MENU_CALLBACK( menu_file_quicksave_nextslot );
+MENU_CALLBACK( menu_file_quicksave_previousslot );
 MENU_CALLBACK( menu_file_recording_continuerecording );
 MENU_CALLBACK( menu_file_recording_insertsnapshot );
 MENU_CALLBACK( menu_file_recording_rollback );
@@ -82,7 +86,11 @@ MENU_CALLBACK( menu_options_save );
 
 MENU_CALLBACK( menu_machine_profiler_start );
 MENU_CALLBACK( menu_machine_profiler_stop );
+MENU_CALLBACK( menu_machine_memoryheatmap_start );
+MENU_CALLBACK( menu_machine_memoryheatmap_stop );
+MENU_CALLBACK( menu_machine_memoryheatmap_export );
 MENU_CALLBACK( menu_machine_nmi );
+MENU_CALLBACK( menu_machine_fastforward );
 MENU_CALLBACK( menu_machine_didaktiksnap );
 
 MENU_CALLBACK( menu_media_tape_browse );
@@ -174,6 +182,7 @@ MENU_CALLBACK( menu_machine_debugger );
 MENU_CALLBACK( menu_machine_pokefinder );
 MENU_CALLBACK( menu_machine_pokememory );
 MENU_CALLBACK( menu_machine_memorybrowser );
+MENU_CALLBACK( menu_machine_memoryheatmap_view );
 
 MENU_CALLBACK( menu_help_keyboard );
 MENU_CALLBACK( menu_help_about );
@@ -29,6 +29,8 @@
 #include <glib.h>
 #endif				/* #ifdef HAVE_LIB_GLIB */
 
+#include <string.h>
+
 #include "libspectrum.h"
 
 #include "compat.h"
@@ -36,6 +38,11 @@
 
 static GSList *registered_modules = NULL;
 
+typedef struct module_state_args {
+  module_state *state;
+  libspectrum_snap *snap;
+} module_state_args;
+
 int
 module_register( module_info_t *module )
 {
@@ -124,3 +131,105 @@ module_snapshot_to( libspectrum_snap *snap )
 {
   g_slist_foreach( registered_modules, snapshot_to, snap );
 }
+
+static void
+state_to( gpointer data, gpointer user_data )
+{
+  const module_info_t *module = data;
+  module_state_args *args = user_data;
+
+  if( module->state_to ) {
+    module->state_to( args->state );
+  } else if( module->snapshot_to && args->snap ) {
+    module->snapshot_to( args->snap );
+  }
+}
+
+void
+module_state_to( module_state *state, libspectrum_snap *snap )
+{
+  module_state_args args;
+
+  args.state = state;
+  args.snap = snap;
+
+  state->length = 0;
+  g_slist_foreach( registered_modules, state_to, &args );
+}
+
+static void
+state_enabled( gpointer data, gpointer user_data )
+{
+  const module_info_t *module = data;
+  module_state_args *args = user_data;
+
+  if( !module->state_from && module->snapshot_enabled && args->snap )
+    module->snapshot_enabled( args->snap );
+}
+
+static void
+state_from( gpointer data, gpointer user_data )
+{
+  const module_info_t *module = data;
+  module_state_args *args = user_data;
+
+  if( module->state_from ) {
+    module->state_from( args->state );
+  } else if( module->snapshot_from && args->snap ) {
+    module->snapshot_from( args->snap );
+  }
+}
+
+void
+module_state_from( module_state *state, libspectrum_snap *snap )
+{
+  module_state_args args;
+
+  args.state = state;
+  args.snap = snap;
+
+  /* As with snapshots, all peripherals must be enabled before any state
+     is restored */
+  g_slist_foreach( registered_modules, state_enabled, &args );
+
+  state->position = 0;
+  g_slist_foreach( registered_modules, state_from, &args );
+}
+
+void
+module_state_write( module_state *state, const void *data, size_t length )
+{
+  if( state->length + length > state->allocated ) {
+    size_t new_size = state->allocated ? 2 * state->allocated : 0x10000;
+    while( new_size < state->length + length ) new_size *= 2;
+    state->buffer = libspectrum_renew( libspectrum_byte, state->buffer,
+                                       new_size );
+    state->allocated = new_size;
+  }
+
+  memcpy( state->buffer + state->length, data, length );
+  state->length += length;
+}
+
+void
+module_state_read( module_state *state, void *data, size_t length )
+{
+  /* Can happen only if a module reads more than it wrote; leave the
+     rest of the data zeroed rather than running off the end */
+  if( state->position + length > state->length ) {
+    memset( data, 0, length );
+    state->position = state->length;
+    return;
+  }
+
+  memcpy( data, state->buffer + state->position, length );
+  state->position += length;
+}
+
+void
+module_state_free( module_state *state )
+{
+  libspectrum_free( state->buffer );
+  state->buffer = NULL;
+  state->length = state->allocated = state->position = 0;
+}
@@ -34,6 +34,21 @@ typedef void (*module_snapshot_enabled_fn)( libspectrum_snap *snap );
 typedef void (*module_snapshot_from_fn)( libspectrum_snap *snap );
 typedef void (*module_snapshot_to_fn)( libspectrum_snap *snap );
 
+/* A flat binary image of the modules' state, used for the in-memory
+   quick-save slots; the buffer is kept between saves so it is only
+   reallocated if the state grows */
+typedef struct module_state {
+
+  libspectrum_byte *buffer;
+  size_t length;		/* Bytes of state in the buffer */
+  size_t allocated;		/* Size of the buffer */
+  size_t position;		/* Where the next read comes from */
+
+} module_state;
+
+typedef void (*module_state_to_fn)( module_state *state );
+typedef void (*module_state_from_fn)( module_state *state );
+
 typedef struct module_info_t
 {
 
@@ -43,6 +58,10 @@ typedef struct module_info_t
   module_snapshot_from_fn snapshot_from;
   module_snapshot_to_fn snapshot_to;
 
+  /* Optional; modules without these go through the snapshot functions */
+  module_state_to_fn state_to;
+  module_state_from_fn state_from;
+
 } module_info_t;
 
 int module_register( module_info_t *module );
@@ -54,4 +73,17 @@ void module_snapshot_enabled( libspectrum_snap *snap );
 void module_snapshot_from( libspectrum_snap *snap );
 void module_snapshot_to( libspectrum_snap *snap );
 
+/* Save the state of every module: those with state functions into 'state',
+   the rest into 'snap'. If 'snap' is NULL, only the modules with state
+   functions are saved */
+void module_state_to( module_state *state, libspectrum_snap *snap );
+
+/* Restore what module_state_to() saved */
+void module_state_from( module_state *state, libspectrum_snap *snap );
+
+void module_state_write( module_state *state, const void *data,
+                         size_t length );
+void module_state_read( module_state *state, void *data, size_t length );
+void module_state_free( module_state *state );
+
 #endif			/* #ifndef FUSE_MODULE_H */
@@ -26,6 +26,8 @@
 
 #include "config.h"
 
+#include <string.h>
+
 #include "libspectrum.h"
 
 #include "debugger.h"
@@ -65,6 +67,21 @@ typedef struct periph_port_private_t {
 /* The list of currently active ports */
 static GSList *ports = NULL;
 
+/* The traps registered by one peripheral */
+typedef struct periph_trap_set_t {
+  const periph_trap_t *traps;
+  const int *available;
+  const int *paged;
+  /* The state of <*available> and <*paged> when the map was last built */
+  int built_available;
+  int built_paged;
+} periph_trap_set_t;
+
+/* All the registered traps */
+static GSList *trap_sets = NULL;
+
+static void free_trap_set( gpointer data, gpointer user_data );
+
 /* The strings used for debugger events */
 static const char * const page_event_string = "page",
   * const unpage_event_string = "unpage";
@@ -236,6 +253,10 @@ periph_end( void )
   g_slist_free( ports );
   ports = NULL;
 
+  g_slist_foreach( trap_sets, free_trap_set, NULL );
+  g_slist_free( trap_sets );
+  trap_sets = NULL;
+
   g_hash_table_destroy( peripherals );
   peripherals = NULL;
 }
@@ -484,3 +505,143 @@ periph_register_paging_events( const char *type_string, int *page_event,
   *page_event = debugger_event_register( type_string, page_event_string );
   *unpage_event = debugger_event_register( type_string, unpage_event_string );
 }
+
+/*
+ * Traps on the program counter
+ */
+
+libspectrum_byte periph_trap_map[ PERIPH_TRAP_STAGES ][ 0x10000 / 8 ];
+int periph_traps_armed = 0;
+
+/* Register the traps for a peripheral */
+void
+periph_register_traps( const periph_trap_t *traps, const int *available,
+                       const int *paged )
+{
+  periph_trap_set_t *set = libspectrum_new( periph_trap_set_t, 1 );
+
+  set->traps = traps;
+  set->available = available;
+  set->paged = paged;
+
+  trap_sets = g_slist_append( trap_sets, set );
+
+  periph_traps_changed();
+}
+
+static void
+free_trap_set( gpointer data, gpointer user_data GCC_UNUSED )
+{
+  libspectrum_free( data );
+}
+
+static int
+trap_set_paged( const periph_trap_set_t *set )
+{
+  return set->paged ? !!*set->paged : 0;
+}
+
+/* Is this trap armed given the state of its peripheral? */
+static int
+trap_armed( const periph_trap_t *trap, int paged )
+{
+  switch( trap->paging ) {
+  case PERIPH_TRAP_ALWAYS: return 1;
+  case PERIPH_TRAP_PAGED: return paged;
+  case PERIPH_TRAP_UNPAGED: return !paged;
+  }
+
+  return 0;
+}
+
+/* Set the bits from first to last inclusive in one stage's map */
+static void
+set_trap_bits( libspectrum_byte *map, libspectrum_dword first,
+               libspectrum_dword last )
+{
+  while( first <= last && ( first & 0x07 ) )
+    { map[ first >> 3 ] |= 1 << ( first & 0x07 ); first++; }
+
+  if( first + 7 <= last ) {
+    memset( &map[ first >> 3 ], 0xff, ( last + 1 - first ) >> 3 );
+    first += ( last + 1 - first ) & ~0x07;
+  }
+
+  while( first <= last )
+    { map[ first >> 3 ] |= 1 << ( first & 0x07 ); first++; }
+}
+
+/* Build the map for the current state of every peripheral. This only
+   happens when a peripheral is (un)paged or becomes (un)available, which
+   is much rarer than instructions which need checking */
+void
+periph_traps_changed( void )
+{
+  GSList *item;
+  const periph_trap_t *trap;
+
+  memset( periph_trap_map, 0, sizeof( periph_trap_map ) );
+  periph_traps_armed = 0;
+
+  for( item = trap_sets; item; item = item->next ) {
+    periph_trap_set_t *set = item->data;
+
+    set->built_available = !!*set->available;
+    set->built_paged = trap_set_paged( set );
+
+    if( !set->built_available ) continue;
+
+    for( trap = set->traps; trap->trap; trap++ ) {
+      if( !trap_armed( trap, set->built_paged ) ) continue;
+      set_trap_bits( periph_trap_map[ trap->stage ], trap->first, trap->last );
+      periph_traps_armed = 1;
+    }
+  }
+}
+
+void
+periph_update_traps( void )
+{
+  GSList *item;
+  int was_armed;
+
+  for( item = trap_sets; item; item = item->next ) {
+    periph_trap_set_t *set = item->data;
+    if( set->built_available != !!*set->available ||
+        set->built_paged != trap_set_paged( set ) ) {
+      was_armed = periph_traps_armed;
+      periph_traps_changed();
+
+      /* z80_do_opcodes() only sets up the trap checks when it starts, so if
+         a port write has just armed the first trap, get it to look again */
+      if( periph_traps_armed && !was_armed )
+        event_add( tstates, event_type_null );
+      return;
+    }
+  }
+}
+
+/* Run the armed traps for this address, in the order the peripherals were
+   registered */
+void
+periph_run_traps( periph_trap_stage stage, libspectrum_word pc )
+{
+  GSList *item;
+  const periph_trap_t *trap;
+
+  for( item = trap_sets; item; item = item->next ) {
+    periph_trap_set_t *set = item->data;
+
+    if( !*set->available ) continue;
+
+    for( trap = set->traps; trap->trap; trap++ ) {
+      /* Check the paging for each trap as an earlier one may have just
+         (un)paged the peripheral */
+      if( trap->stage == stage && pc >= trap->first && pc <= trap->last &&
+          trap_armed( trap, trap_set_paged( set ) ) )
+        trap->trap( pc );
+    }
+  }
+
+  periph_update_traps();
+}
@@ -164,6 +164,69 @@ int periph_postcheck( void );
 void periph_register_paging_events( const char *type_string, int *page_event,
 				    int *unpage_event );
 
+/*
+ * Traps on the program counter, used for automatic paging
+ */
+
+/* When in an instruction a trap is checked */
+typedef enum periph_trap_stage {
+  PERIPH_TRAP_BEFORE_FETCH,	/* Before the opcode is fetched */
+  PERIPH_TRAP_AFTER_FETCH,	/* After the opcode is fetched */
+
+  PERIPH_TRAP_STAGES
+} periph_trap_stage;
+
+/* Whether a trap depends on the peripheral's memory being paged in */
+typedef enum periph_trap_paging {
+  PERIPH_TRAP_ALWAYS,
+  PERIPH_TRAP_PAGED,		/* Only while paged in */
+  PERIPH_TRAP_UNPAGED,		/* Only while not paged in */
+} periph_trap_paging;
+
+typedef void (*periph_trap_function)( libspectrum_word pc );
+
+/* Information about a specific trap */
+typedef struct periph_trap_t {
+
+  periph_trap_stage stage;
+
+  /* This trap fires for all PC values from first to last inclusive */
+  libspectrum_word first;
+  libspectrum_word last;
+
+  periph_trap_paging paging;
+  periph_trap_function trap;
+
+} periph_trap_t;
+
+/* Register the traps for a peripheral; the list ends with an entry with no
+   trap function. The traps are armed while <*available> is non-zero;
+   <paged> says whether the peripheral's memory is paged in and may be NULL
+   if none of the traps depend on that. A trap function may be called for a
+   PC it then decides to ignore, but never for one outside its range */
+void periph_register_traps( const periph_trap_t *traps, const int *available,
+                            const int *paged );
+
+/* One bit per address for each stage, set where a trap is currently armed */
+extern libspectrum_byte periph_trap_map[ PERIPH_TRAP_STAGES ][ 0x10000 / 8 ];
+
+/* Is any trap armed at all? */
+extern int periph_traps_armed;
+
+#define periph_trap_hit( stage, pc ) \
+  ( periph_trap_map[ (stage) ][ (pc) >> 3 ] & ( 1 << ( (pc) & 0x07 ) ) )
+
+/* Rebuild the trap map if any peripheral has become (un)available or been
+   (un)paged since it was last built */
+void periph_update_traps( void );
+
+/* Rebuild the trap map now; for peripherals which have changed the
+   addresses in their trap list */
+void periph_traps_changed( void );
+
+/* Run the armed traps for this address */
+void periph_run_traps( periph_trap_stage stage, libspectrum_word pc );
+
 libspectrum_byte periph_merge_floating_bus( libspectrum_byte value,
                                             libspectrum_byte attached,
                                             libspectrum_byte floating_bus );
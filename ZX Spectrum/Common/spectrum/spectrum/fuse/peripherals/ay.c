@@ -36,6 +36,7 @@
 #include "periph.h"
 #include "printer.h"
 #include "psg.h"
+#include "settings.h"
 #include "sound.h"
 
 /* Unused bits in the AY registers are silently zeroed out; these masks
@@ -50,6 +51,8 @@ static const libspectrum_byte mask[ AY_REGISTERS ] = {
 static void ay_reset( int hard_reset );
 static void ay_from_snapshot( libspectrum_snap *snap );
 static void ay_to_snapshot( libspectrum_snap *snap );
+static void ay_to_state( module_state *state );
+static void ay_from_state( module_state *state );
 static libspectrum_dword get_current_register( void );
 static void set_current_register( libspectrum_dword value );
 
@@ -60,6 +63,8 @@ static module_info_t ay_module_info = {
   /* .snapshot_enabled = */ NULL,
   /* .snapshot_from = */ ay_from_snapshot,
   /* .snapshot_to = */ ay_to_snapshot,
+  /* .state_to = */ ay_to_state,
+  /* .state_from = */ ay_from_state,
 
 };
 
@@ -115,6 +120,11 @@ static periph_t ay_periph_timex = {
   /* .activate = */ NULL,
 };
 
+/* The second chip of a TurboSound interface, and which chip the ports
+   currently talk to */
+static ayinfo turbosound_ay;
+static int turbosound_selected = 0;
+
 /* Debugger system variables */
 static const char * const debugger_type_string = "ay";
 static const char * const current_register_detail_string = "current";
@@ -153,6 +163,26 @@ ay_reset( int hard_reset GCC_UNUSED )
 
   ay->current_register = 0;
   memset( ay->registers, 0, sizeof( ay->registers ) );
+
+  turbosound_ay.current_register = 0;
+  memset( turbosound_ay.registers, 0, sizeof( turbosound_ay.registers ) );
+  turbosound_selected = 0;
+}
+
+/* TurboSound puts a second AY behind the usual 128K ports */
+int
+ay_turbosound_active( void )
+{
+  return settings_current.turbosound &&
+         ( machine_current->capabilities & LIBSPECTRUM_MACHINE_CAPABILITY_AY );
+}
+
+/* The chip the AY ports are currently talking to */
+static ayinfo*
+ay_selected( void )
+{
+  return turbosound_selected && ay_turbosound_active() ?
+         &turbosound_ay : &machine_current->ay;
 }
 
 /* What happens when the AY register port (traditionally 0xfffd on the 128K
@@ -160,12 +190,13 @@ ay_reset( int hard_reset GCC_UNUSED )
 libspectrum_byte
 ay_registerport_read( libspectrum_word port GCC_UNUSED, libspectrum_byte *attached )
 {
+  ayinfo *ay = ay_selected();
   int current;
   const libspectrum_byte port_input = 0xbf; /* always allow serial output */
 
   *attached = 0xff;
 
-  current = machine_current->ay.current_register;
+  current = ay->current_register;
 
   /* The AY I/O ports return input directly from the port when in
      input mode; but in output mode, they return an AND between the
@@ -173,26 +204,32 @@ ay_registerport_read( libspectrum_word port GCC_UNUSED, libspectrum_byte *attach
      reading R14... */
 
   if( current == 14 ) {
-    if(machine_current->ay.registers[7] & 0x40)
-      return (port_input & machine_current->ay.registers[14]);
+    if(ay->registers[7] & 0x40)
+      return (port_input & ay->registers[14]);
     else
       return port_input;
   }
 
   /* R15 is simpler to do, as the 8912 lacks the second I/O port, and
      the input-mode input is always 0xff */
-  if( current == 15 && !( machine_current->ay.registers[7] & 0x80 ) )
+  if( current == 15 && !( ay->registers[7] & 0x80 ) )
     return 0xff;
 
   /* Otherwise return register value, appropriately masked */
-  return machine_current->ay.registers[ current ] & mask[ current ];
+  return ay->registers[ current ] & mask[ current ];
 }
 
 /* And when it's written to */
 void
 ay_registerport_write( libspectrum_word port GCC_UNUSED, libspectrum_byte b )
 {
-  set_current_register( b );
+  /* With TurboSound, 0xff selects the first chip and 0xfe the second */
+  if( ( b & 0xfe ) == 0xfe && ay_turbosound_active() ) {
+    turbosound_selected = !( b & 0x01 );
+    return;
+  }
+
+  ay_selected()->current_register = ( b & 0x0f );
 }
 
 /* What happens when the AY data port (traditionally 0xbffd on the 128K
@@ -201,12 +238,19 @@ ay_registerport_write( libspectrum_word port GCC_UNUSED, libspectrum_byte b )
 void
 ay_dataport_write( libspectrum_word port GCC_UNUSED, libspectrum_byte b )
 {
+  ayinfo *ay = ay_selected();
   int current;
 
-  current = machine_current->ay.current_register;
+  current = ay->current_register;
+
+  ay->registers[ current ] = b & mask[ current ];
+
+  if( ay == &turbosound_ay ) {
+    sound_ay_write( 1, current, b, tstates );
+    return;
+  }
 
-  machine_current->ay.registers[ current ] = b & mask[ current ];
-  sound_ay_write( current, b, tstates );
+  sound_ay_write( 0, current, b, tstates );
   if( psg_recording ) psg_write_register( current, b );
 
   if( current == 14 ) printer_serial_write( b );
@@ -223,7 +267,7 @@ ay_state_from_snapshot( libspectrum_snap *snap )
   for( i = 0; i < AY_REGISTERS; i++ ) {
     machine_current->ay.registers[i] =
       libspectrum_snap_ay_registers( snap, i );
-    sound_ay_write( i, machine_current->ay.registers[i], 0 );
+    sound_ay_write( 0, i, machine_current->ay.registers[i], 0 );
   }
 }
 
@@ -249,6 +293,35 @@ ay_to_snapshot( libspectrum_snap *snap )
 				       machine_current->ay.registers[i] );
 }
 
+static void
+ay_to_state( module_state *state )
+{
+  module_state_write( state, &machine_current->ay,
+                      sizeof( machine_current->ay ) );
+  module_state_write( state, &turbosound_ay, sizeof( turbosound_ay ) );
+  module_state_write( state, &turbosound_selected,
+                      sizeof( turbosound_selected ) );
+}
+
+static void
+ay_from_state( module_state *state )
+{
+  size_t i;
+
+  module_state_read( state, &machine_current->ay,
+                     sizeof( machine_current->ay ) );
+  module_state_read( state, &turbosound_ay, sizeof( turbosound_ay ) );
+  module_state_read( state, &turbosound_selected,
+                     sizeof( turbosound_selected ) );
+
+  if( machine_current->capabilities & LIBSPECTRUM_MACHINE_CAPABILITY_AY ) {
+    for( i = 0; i < AY_REGISTERS; i++ ) {
+      sound_ay_write( 0, i, machine_current->ay.registers[i], 0 );
+      sound_ay_write( 1, i, turbosound_ay.registers[i], 0 );
+    }
+  }
+}
+
 static libspectrum_dword
 get_current_register( void )
 {
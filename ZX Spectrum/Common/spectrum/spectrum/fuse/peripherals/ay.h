@@ -45,4 +45,7 @@ void ay_dataport_write( libspectrum_word port, libspectrum_byte b );
 
 void ay_state_from_snapshot( libspectrum_snap *snap );
 
+/* Is the second chip of a TurboSound interface present? */
+int ay_turbosound_active( void );
+
 #endif			/* #ifndef FUSE_AY_H */
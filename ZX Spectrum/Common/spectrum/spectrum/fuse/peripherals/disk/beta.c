@@ -48,6 +48,7 @@
 #include "startup_manager.h"
 #include "machine.h"
 #include "module.h"
+#include "periph.h"
 #include "settings.h"
 #include "ui.h"
 #include "uimedia.h"
@@ -90,6 +91,19 @@ static const periph_t beta_peripheral = {
   /* .activate = */ NULL,
 };
 
+static void beta_trap_page( libspectrum_word pc );
+static void beta_trap_unpage( libspectrum_word pc );
+
+/* The TR-DOS ROM is paged in from 0x3d00-0x3dff, or 0x3c00-0x3dff on 48K
+   machines, and out again on leaving the ROM area */
+static const periph_trap_t beta_traps[] = {
+  { PERIPH_TRAP_BEFORE_FETCH, 0x3c00, 0x3dff, PERIPH_TRAP_UNPAGED,
+    beta_trap_page },
+  { PERIPH_TRAP_BEFORE_FETCH, 0x4000, 0xffff, PERIPH_TRAP_PAGED,
+    beta_trap_unpage },
+  { 0, 0, 0, 0, NULL }
+};
+
 /* Debugger events */
 static const char * const event_type_string = "beta128";
 static int page_event, unpage_event;
@@ -131,6 +145,23 @@ beta_unpage( void )
   debugger_event( unpage_event );
 }
 
+#define NOT_128_TYPE_OR_IS_48_TYPE ( !( machine_current->capabilities & \
+            LIBSPECTRUM_MACHINE_CAPABILITY_128_MEMORY ) || \
+            machine_current->ram.current_rom )
+
+static void
+beta_trap_page( libspectrum_word pc )
+{
+  if( ( pc & beta_pc_mask ) == beta_pc_value && NOT_128_TYPE_OR_IS_48_TYPE )
+    beta_page();
+}
+
+static void
+beta_trap_unpage( libspectrum_word pc GCC_UNUSED )
+{
+  if( NOT_128_TYPE_OR_IS_48_TYPE ) beta_unpage();
+}
+
 static void
 beta_memory_map( void )
 {
@@ -179,6 +210,7 @@ beta_init( void *context )
     beta_memory_map_romcs[i].source = beta_memory_source;
 
   periph_register( PERIPH_TYPE_BETA128, &beta_peripheral );
+  periph_register_traps( beta_traps, &beta_available, &beta_active );
 
   for( i = 0; i < BETA_NUM_DRIVES; i++ ) {
     beta_ui_drives[ i ].fdd = &beta_drives[ i ];
@@ -38,6 +38,7 @@
 #include "startup_manager.h"
 #include "machine.h"
 #include "module.h"
+#include "periph.h"
 #include "printer.h"
 #include "settings.h"
 #include "ui.h"
@@ -126,6 +127,28 @@ static const periph_t didaktik_periph = {
   /* .activate = */ NULL,
 };
 
+static void
+didaktik_trap_page( libspectrum_word pc GCC_UNUSED )
+{
+  didaktik80_page();
+}
+
+static void
+didaktik_trap_unpage( libspectrum_word pc GCC_UNUSED )
+{
+  didaktik80_unpage();
+}
+
+static const periph_trap_t didaktik_traps[] = {
+  { PERIPH_TRAP_BEFORE_FETCH, 0x0000, 0x0000, PERIPH_TRAP_ALWAYS,
+    didaktik_trap_page },
+  { PERIPH_TRAP_BEFORE_FETCH, 0x0008, 0x0008, PERIPH_TRAP_ALWAYS,
+    didaktik_trap_page },
+  { PERIPH_TRAP_BEFORE_FETCH, 0x1700, 0x1700, PERIPH_TRAP_ALWAYS,
+    didaktik_trap_unpage },
+  { 0, 0, 0, 0, NULL }
+};
+
 /* Debugger events */
 static const char * const event_type_string = "didaktik80";
 static int page_event, unpage_event;
@@ -209,6 +232,7 @@ didaktik80_init( void *context )
     didaktik_memory_map_romcs_ram[i].source = didaktik_ram_memory_source;
 
   periph_register( PERIPH_TYPE_DIDAKTIK80, &didaktik_periph );
+  periph_register_traps( didaktik_traps, &didaktik80_available, NULL );
   for( i = 0; i < DIDAKTIK80_NUM_DRIVES; i++ ) {
     didaktik_ui_drives[ i ].fdd = &didaktik_drives[ i ];
     ui_media_drive_register( &didaktik_ui_drives[ i ] );
@@ -38,6 +38,7 @@
 #include "startup_manager.h"
 #include "machine.h"
 #include "module.h"
+#include "periph.h"
 #include "printer.h"
 #include "settings.h"
 #include "ui.h"
@@ -191,6 +192,24 @@ static const periph_t disciple_periph = {
   /* .activate = */ disciple_activate,
 };
 
+static void
+disciple_trap_page( libspectrum_word pc GCC_UNUSED )
+{
+  disciple_page();
+}
+
+static const periph_trap_t disciple_traps[] = {
+  { PERIPH_TRAP_BEFORE_FETCH, 0x0001, 0x0001, PERIPH_TRAP_ALWAYS,
+    disciple_trap_page },
+  { PERIPH_TRAP_BEFORE_FETCH, 0x0008, 0x0008, PERIPH_TRAP_ALWAYS,
+    disciple_trap_page },
+  { PERIPH_TRAP_BEFORE_FETCH, 0x0066, 0x0066, PERIPH_TRAP_ALWAYS,
+    disciple_trap_page },
+  { PERIPH_TRAP_BEFORE_FETCH, 0x028e, 0x028e, PERIPH_TRAP_ALWAYS,
+    disciple_trap_page },
+  { 0, 0, 0, 0, NULL }
+};
+
 static int
 disciple_init( void *context )
 {
@@ -231,6 +250,7 @@ disciple_init( void *context )
   }
 
   periph_register( PERIPH_TYPE_DISCIPLE, &disciple_periph );
+  periph_register_traps( disciple_traps, &disciple_available, NULL );
 
   for( i = 0; i < DISCIPLE_NUM_DRIVES; i++ ) {
     disciple_ui_drives[ i ].fdd = &disciple_drives[ i ];
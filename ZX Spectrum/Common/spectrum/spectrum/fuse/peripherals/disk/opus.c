@@ -37,6 +37,7 @@
 #include "startup_manager.h"
 #include "machine.h"
 #include "module.h"
+#include "periph.h"
 #include "opus.h"
 #include "printer.h"
 #include "settings.h"
@@ -94,6 +95,32 @@ static const periph_t opus_periph = {
   /* .activate = */ NULL,
 };
 
+static void
+opus_trap_page( libspectrum_word pc GCC_UNUSED )
+{
+  opus_page();
+}
+
+static void
+opus_trap_unpage( libspectrum_word pc GCC_UNUSED )
+{
+  opus_unpage();
+}
+
+/* The Opus is checked after the opcode fetch, so the instruction at the
+   trap address still comes from the Spectrum's ROM */
+static const periph_trap_t opus_traps[] = {
+  { PERIPH_TRAP_AFTER_FETCH, 0x0008, 0x0008, PERIPH_TRAP_UNPAGED,
+    opus_trap_page },
+  { PERIPH_TRAP_AFTER_FETCH, 0x0048, 0x0048, PERIPH_TRAP_UNPAGED,
+    opus_trap_page },
+  { PERIPH_TRAP_AFTER_FETCH, 0x1708, 0x1708, PERIPH_TRAP_UNPAGED,
+    opus_trap_page },
+  { PERIPH_TRAP_AFTER_FETCH, 0x1748, 0x1748, PERIPH_TRAP_PAGED,
+    opus_trap_unpage },
+  { 0, 0, 0, 0, NULL }
+};
+
 /* Debugger events */
 static const char * const event_type_string = "opus";
 static int page_event, unpage_event;
@@ -164,6 +191,7 @@ opus_init( void *context )
     opus_memory_map_romcs_ram[i].source = opus_ram_memory_source;
 
   periph_register( PERIPH_TYPE_OPUS, &opus_periph );
+  periph_register_traps( opus_traps, &opus_available, &opus_active );
   for( i = 0; i < OPUS_NUM_DRIVES; i++ ) {
     opus_ui_drives[ i ].fdd = &opus_drives[ i ];
     ui_media_drive_register( &opus_ui_drives[ i ] );
@@ -37,6 +37,7 @@
 #include "startup_manager.h"
 #include "machine.h"
 #include "module.h"
+#include "periph.h"
 #include "printer.h"
 #include "plusd.h"
 #include "settings.h"
@@ -160,6 +161,26 @@ static const periph_t plusd_periph = {
   /* .activate = */ plusd_activate,
 };
 
+static void
+plusd_trap_page( libspectrum_word pc GCC_UNUSED )
+{
+  plusd_page();
+}
+
+/* The +D pages itself in on RST 8, NMI and the ROM's SAVE and LOAD
+   routines */
+static const periph_trap_t plusd_traps[] = {
+  { PERIPH_TRAP_BEFORE_FETCH, 0x0008, 0x0008, PERIPH_TRAP_ALWAYS,
+    plusd_trap_page },
+  { PERIPH_TRAP_BEFORE_FETCH, 0x003a, 0x003a, PERIPH_TRAP_ALWAYS,
+    plusd_trap_page },
+  { PERIPH_TRAP_BEFORE_FETCH, 0x0066, 0x0066, PERIPH_TRAP_ALWAYS,
+    plusd_trap_page },
+  { PERIPH_TRAP_BEFORE_FETCH, 0x028e, 0x028e, PERIPH_TRAP_ALWAYS,
+    plusd_trap_page },
+  { 0, 0, 0, 0, NULL }
+};
+
 static int
 plusd_init( void *context )
 {
@@ -192,6 +213,7 @@ plusd_init( void *context )
     plusd_memory_map_romcs_ram[ i ].source = plusd_memory_source_ram;
 
   periph_register( PERIPH_TYPE_PLUSD, &plusd_periph );
+  periph_register_traps( plusd_traps, &plusd_available, NULL );
 
   for( i = 0; i < PLUSD_NUM_DRIVES; i++ ) {
     plusd_ui_drives[ i ].fdd = &plusd_drives[ i ];
@@ -66,6 +66,40 @@ static const periph_t divide_periph = {
   /* .activate = */ divide_activate,
 };
 
+static void
+divide_trap_automap_on( libspectrum_word pc GCC_UNUSED )
+{
+  divide_set_automap( 1 );
+}
+
+static void
+divide_trap_automap_off( libspectrum_word pc GCC_UNUSED )
+{
+  divide_set_automap( 0 );
+}
+
+/* Automapping happens straight away for the TR-DOS entry points, and only
+   after the opcode fetch otherwise */
+static const periph_trap_t divide_traps[] = {
+  { PERIPH_TRAP_BEFORE_FETCH, 0x3d00, 0x3dff, PERIPH_TRAP_ALWAYS,
+    divide_trap_automap_on },
+  { PERIPH_TRAP_AFTER_FETCH, 0x1ff8, 0x1fff, PERIPH_TRAP_ALWAYS,
+    divide_trap_automap_off },
+  { PERIPH_TRAP_AFTER_FETCH, 0x0000, 0x0000, PERIPH_TRAP_ALWAYS,
+    divide_trap_automap_on },
+  { PERIPH_TRAP_AFTER_FETCH, 0x0008, 0x0008, PERIPH_TRAP_ALWAYS,
+    divide_trap_automap_on },
+  { PERIPH_TRAP_AFTER_FETCH, 0x0038, 0x0038, PERIPH_TRAP_ALWAYS,
+    divide_trap_automap_on },
+  { PERIPH_TRAP_AFTER_FETCH, 0x0066, 0x0066, PERIPH_TRAP_ALWAYS,
+    divide_trap_automap_on },
+  { PERIPH_TRAP_AFTER_FETCH, 0x04c6, 0x04c6, PERIPH_TRAP_ALWAYS,
+    divide_trap_automap_on },
+  { PERIPH_TRAP_AFTER_FETCH, 0x0562, 0x0562, PERIPH_TRAP_ALWAYS,
+    divide_trap_automap_on },
+  { 0, 0, 0, 0, NULL }
+};
+
 static const libspectrum_byte DIVIDE_CONTROL_CONMEM = 0x80;
 static const libspectrum_byte DIVIDE_CONTROL_MAPRAM = 0x40;
 
@@ -158,6 +192,8 @@ divide_init( void *context )
   }
 
   periph_register( PERIPH_TYPE_DIVIDE, &divide_periph );
+  periph_register_traps( divide_traps, &settings_current.divide_enabled,
+                         NULL );
   periph_register_paging_events( event_type_string, &page_event,
                                  &unpage_event );
 
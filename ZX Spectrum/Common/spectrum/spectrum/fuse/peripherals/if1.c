@@ -37,6 +37,7 @@
 #include "compat.h"
 #include "debugger.h"
 #include "if1.h"
+#include "if1_io.h"
 #include "startup_manager.h"
 #include "machine.h"
 #include "memory.h"
@@ -83,9 +84,9 @@ typedef struct microdrive_t {
 } microdrive_t;
 
 typedef struct if1_ula_t {
-  int fd_r;	/* file descriptor for reading bytes or bits RS232 */
-  int fd_t;	/* file descriptor for writing bytes or bits RS232 */
-  int fd_net;	/* file descriptor for rw bytes or bits SinclairNET */
+  if1_io_channel *rs232_r;	/* for reading bytes or bits RS232 */
+  if1_io_channel *rs232_t;	/* for writing bytes or bits RS232 */
+  if1_io_channel *snet;	/* for rw bytes or bits SinclairNET */
   int rs232_buffer;	/* read buffer */
   int s_net_mode;
   int status;	/* if1_ula/SinclairNET */
@@ -232,6 +233,30 @@ static const periph_t if1_periph = {
   /* .activate = */ NULL,
 };
 
+static void
+if1_trap_page( libspectrum_word pc GCC_UNUSED )
+{
+  if1_page();
+}
+
+static void
+if1_trap_unpage( libspectrum_word pc GCC_UNUSED )
+{
+  if1_unpage();
+}
+
+/* The shadow ROM is paged in on RST 8 and the "Hook code" error handler
+   and out again when it returns through 0x0700 */
+static const periph_trap_t if1_traps[] = {
+  { PERIPH_TRAP_BEFORE_FETCH, 0x0008, 0x0008, PERIPH_TRAP_ALWAYS,
+    if1_trap_page },
+  { PERIPH_TRAP_BEFORE_FETCH, 0x1708, 0x1708, PERIPH_TRAP_ALWAYS,
+    if1_trap_page },
+  { PERIPH_TRAP_AFTER_FETCH, 0x0700, 0x0700, PERIPH_TRAP_ALWAYS,
+    if1_trap_unpage },
+  { 0, 0, 0, 0, NULL }
+};
+
 /* Memory source */
 static int if1_memory_source;
 
@@ -292,12 +317,12 @@ update_menu( enum if1_menu_item what )
   
   if( what == UMENU_ALL || what == UMENU_RS232 ) {
     ui_menu_activate( UI_MENU_ITEM_MEDIA_IF1_RS232_UNPLUG_R,
-                    ( if1_ula.fd_r > -1 ) ? 1 : 0 );
+                    if1_ula.rs232_r ? 1 : 0 );
     ui_menu_activate( UI_MENU_ITEM_MEDIA_IF1_RS232_UNPLUG_T,
-                    ( if1_ula.fd_t > -1 ) ? 1 : 0 );
+                    if1_ula.rs232_t ? 1 : 0 );
 #ifdef BUILD_WITH_SNET
     ui_menu_activate( UI_MENU_ITEM_MEDIA_IF1_SNET_UNPLUG,
-                    ( if1_ula.fd_net > -1 ) ? 1 : 0 );
+                    if1_ula.snet ? 1 : 0 );
 #endif
   }
 }
@@ -307,13 +332,13 @@ if1_init( void *context )
 {
   int m, i;
 
-  if1_ula.fd_r = -1;
-  if1_ula.fd_t = -1;
+  if1_ula.rs232_r = NULL;
+  if1_ula.rs232_t = NULL;
   if1_ula.dtr = 0;		/* No data terminal yet */
   if1_ula.cts = 2;		/* force to emit first cts status */
   if1_ula.comms_clk = 0;
   if1_ula.comms_data = 0; /* really? */
-  if1_ula.fd_net = -1;
+  if1_ula.snet = NULL;
   if1_ula.s_net_mode = 1;
   if1_ula.net = 0;
   if1_ula.esc_in = 0; /* empty */
@@ -349,6 +374,7 @@ if1_init( void *context )
     if1_memory_map_romcs[i].source = if1_memory_source;
 
   periph_register( PERIPH_TYPE_INTERFACE1, &if1_periph );
+  periph_register_traps( if1_traps, &if1_available, NULL );
   periph_register_paging_events( event_type_string, &page_event,
 				 &unpage_event );
 
@@ -360,6 +386,9 @@ if1_end( void )
 {
   int m;
 
+  if1_io_end();
+  if1_ula.rs232_r = if1_ula.rs232_t = if1_ula.snet = NULL;
+
   for( m = 0; m < 8; m++ ) {
     libspectrum_error error =
       libspectrum_microdrive_free( microdrive[m].cartridge );
@@ -614,10 +643,10 @@ port_ctr_in( void )
   }
   /* Here we have to poll, the if1_ula DTR 'line' */
   if( if1_ula.rs232_buffer > 0xff ) {	/* buffer empty */
-    unsigned char byte;
+    libspectrum_byte byte;
     int yes = 1;
 
-    while( yes && read( if1_ula.fd_r, &byte, 1 ) == 1 ) {
+    while( yes && if1_io_read( if1_ula.rs232_r, &byte ) ) {
       if( if1_ula.esc_in == 1 ) {
         if1_ula.esc_in = 0;
 	if( byte == '*' ) {
@@ -663,12 +692,15 @@ port_ctr_in( void )
 static int
 read_rs232( void )
 {
+  libspectrum_byte byte;
+
   if( if1_ula.rs232_buffer <= 0xff ) {	/* we read from the buffer */
     if1_ula.data_in = if1_ula.rs232_buffer;
     if1_ula.rs232_buffer = 0x0100;
     return 1;
   }
-  while( read( if1_ula.fd_r, &if1_ula.data_in, 1 ) == 1 ) {
+  while( if1_io_read( if1_ula.rs232_r, &byte ) ) {
+    if1_ula.data_in = byte;
     if( if1_ula.esc_in == 1 ) {
       if1_ula.esc_in = 0;
       if( if1_ula.data_in == '*' ) {
@@ -695,13 +727,13 @@ port_net_in( void )
 {
   libspectrum_byte ret = 0xff;
 
-  if( if1_ula.fd_r == -1 )
+  if( !if1_ula.rs232_r )
     goto no_rs232_in;
 
     /* Here is the RS232 input routine */
   if( if1_ula.cts ) {				  /* If CTS == 1 */
     if( if1_ula.count_in == 0 ) {
-      if( if1_ula.fd_r >= 0 && read_rs232() == 1 ) {
+      if( read_rs232() == 1 ) {
 	if1_ula.count_in++;	/* Ok, if read a byte, we begin */
       }
       if1_ula.tx = 0;				/* now send __ to if1
@@ -722,12 +754,14 @@ port_net_in( void )
   }
 
 no_rs232_in:
-  if( if1_ula.fd_net == -1 )
+  if( !if1_ula.snet )
     goto no_snet_in;
 
   if( if1_ula.s_net_mode == 0 ) {		/* if we do raw */
+    libspectrum_byte byte;
     /* Here is the input routine */
-    read( if1_ula.fd_net, &if1_ula.net, 1 );	/* Ok, if no byte, we send last*/
+    if( if1_io_read( if1_ula.snet, &byte ) )	/* Ok, if no byte, we send last*/
+      if1_ula.net = byte;
   } else {/* if( if1_ula.s_net_mode == 1 ) if we do interpreted */
 /* Here is the input routine. There are several stage in input
    and output. So first for output. if1 first do SEND-SC 
@@ -752,7 +786,9 @@ no_rs232_in:
       fprintf( stderr, "NET-STAT(%03d)? We send 0!\n", if1_ula.net_state );
 #endif
     } else if( if1_ula.net_state == 0x0100 ) { /* probably waiting for input */
-      if( read( if1_ula.fd_net, &if1_ula.net_data, 1 ) == 1 ) {
+      libspectrum_byte byte;
+      if( if1_io_read( if1_ula.snet, &byte ) ) {
+        if1_ula.net_data = byte;
         if1_ula.net_state++;
 	if1_ula.net = 1;	/* Start with __/~~ */
       } 	/* Ok, if have a byte, we send it! */
@@ -904,10 +940,8 @@ port_ctr_out( libspectrum_byte val )
   if1_ula.comms_clk = ( val & 0x02 ) ? 1 : 0;
   val = ( val & 0x10 ) ? 1 : 0;
   if( settings_current.rs232_handshake && 
-      if1_ula.fd_t != -1 && if1_ula.cts != val ) {
-    char data = val ? 0x03 : 0x02;
-    do {} while( write( if1_ula.fd_t, "", 1 ) != 1 );
-    do {} while( write( if1_ula.fd_t, &data, 1 ) != 1 );
+      if1_ula.rs232_t && if1_ula.cts != val ) {
+    if1_io_write_escape( if1_ula.rs232_t, val ? 0x03 : 0x02 );
   }
   if1_ula.cts = val;
     
@@ -922,7 +956,9 @@ port_ctr_out( libspectrum_byte val )
 static void
 port_net_out( libspectrum_byte val )
 {
-  if( if1_ula.fd_t == -1 )
+  int escape = 0;
+
+  if( !if1_ula.rs232_t )
     return;				/* nothing to write */
 
   if( if1_ula.comms_data == 1 ) {	/* OK, RS232 */
@@ -956,15 +992,18 @@ port_net_out( libspectrum_byte val )
     if( if1_ula.count_out == -1 ) {
       if1_ula.count_out = 13;
       if1_ula.data_out = '?';
-      do {} while( write( if1_ula.fd_t, "", 1 ) != 1 );
+      escape = 1;
     }
     if( if1_ula.count_out == 13 ) {
         /* Here is the output routine */
       if( if1_ula.data_out == 0x00 ) {
         if1_ula.data_out = '*';
-        do {} while( write( if1_ula.fd_t, "", 1 ) != 1 );
+        escape = 1;
       }
-      do {} while( write( if1_ula.fd_t, &if1_ula.data_out, 1 ) != 1 );
+      if( escape )
+        if1_io_write_escape( if1_ula.rs232_t, if1_ula.data_out );
+      else
+        if1_io_write( if1_ula.rs232_t, if1_ula.data_out );
       if1_ula.count_out = 0;
     }
     if1_ula.rx = val & 0x01;		/* set rx */
@@ -978,11 +1017,7 @@ port_net_out( libspectrum_byte val )
    The if1 software send complemented data and read straight data.
 */
       if1_ula.net = ( val & 0x01 ) ? 0 : 1;		/* set rx */
-      lseek( if1_ula.fd_net, 0, SEEK_SET );		/* we save only the state of the wire*/
-      do {} while( write( if1_ula.fd_net, &if1_ula.net, 1 ) == -1 );
-#ifdef HAVE_FSYNC
-      fsync( if1_ula.fd_net );
-#endif /* #ifdef HAVE_FSYNC */
+      if1_io_write( if1_ula.snet, if1_ula.net );	/* send the state of the wire */
 #ifdef IF1_DEBUG_NET
       fprintf( stderr, "Send SinclairNET: %d\n", if1_ula.net );
 #endif
@@ -995,12 +1030,8 @@ port_net_out( libspectrum_byte val )
 	if1_ula.net_data &= 0xff;
 	if1_ula.net_state++;		/* OK, now we get data bytes... */
         
-/*	lseek( if1_ula.fd_net, 0, SEEK_SET );  start a packet */
 		/* first we send the station number */
-        do {} while( write( if1_ula.fd_net, &if1_ula.net_data, 1 ) == -1 );
-#ifdef HAVE_FSYNC
-        fsync( if1_ula.fd_net );
-#endif /* #ifdef HAVE_FSYNC */
+        if1_io_write( if1_ula.snet, if1_ula.net_data );
 #ifdef IF1_DEBUG_NET
 	fprintf( stderr, "SC-OUT send network number: %d\n",
 	                                   if1_ula.net_data ^ 0xff );
@@ -1257,9 +1288,25 @@ if1_mdr_write( int which, const char *filename )
   return 0;
 }
 
-#ifndef O_NONBLOCK
-#define O_NONBLOCK FNDELAY
-#endif
+/* The network can be a file or FIFO, or a bus of Fuses joined through a
+   Unix-domain socket, given either with the "unix:" prefix or by choosing
+   the socket itself */
+static if1_io_channel*
+snet_open( const char *filename )
+{
+#ifndef WIN32
+  size_t prefix = strlen( IF1_IO_SOCKET_PREFIX );
+  struct stat info;
+
+  if( !strncmp( filename, IF1_IO_SOCKET_PREFIX, prefix ) )
+    return if1_io_open_bus( filename + prefix );
+
+  if( !stat( filename, &info ) && S_ISSOCK( info.st_mode ) )
+    return if1_io_open_bus( filename );
+#endif				/* #ifndef WIN32 */
+
+  return if1_io_open( filename, IF1_IO_READ | IF1_IO_WRITE );
+}
 
 void
 if1_plug( const char *filename, int what )
@@ -1268,43 +1315,31 @@ if1_plug( const char *filename, int what )
   ui_error( UI_ERROR_ERROR, "Not yet implemented on Win32" );
   return; 
 #else
-  int fd = -1;
+  if1_io_channel *channel = NULL;
 
   switch( what ) {
   case 1:
-    if( if1_ula.fd_r >= 0 )
-      close( if1_ula.fd_r );
-    fd = if1_ula.fd_r = open( filename, O_RDWR | O_NONBLOCK );
-    if( fcntl( fd, F_SETFL, O_RDONLY | O_NONBLOCK ) )
-      ui_error( UI_ERROR_ERROR, "Cannot set O_RDONLY on '%s': %s",
-		filename, strerror( errno ) );
+    if1_io_close( if1_ula.rs232_r );
+    channel = if1_ula.rs232_r = if1_io_open( filename, IF1_IO_READ );
     if1_ula.rs232_buffer = 0x100;		/* buffer is empty */
     break;
   case 2:
-    if( if1_ula.fd_t >= 0 )
-      close( if1_ula.fd_t );
-    fd = if1_ula.fd_t = open( filename, O_RDWR | O_NONBLOCK );
-    if( fcntl( fd, F_SETFL, O_WRONLY | O_NONBLOCK ) )
-      ui_error( UI_ERROR_ERROR, "Cannot set O_WRONLY on '%s': %s",
-		filename, strerror( errno ) );
+    if1_io_close( if1_ula.rs232_t );
+    channel = if1_ula.rs232_t = if1_io_open( filename, IF1_IO_WRITE );
     break;
   case 3:
-    if( if1_ula.fd_net >= 0 )
-      close( if1_ula.fd_net );
-    fd = if1_ula.fd_net = open( filename, O_RDWR | O_NONBLOCK );
+    if1_io_close( if1_ula.snet );
+    channel = if1_ula.snet = snet_open( filename );
     break;
   }
 
   /* rs232_handshake == 0 -> we assume DTR(DSR) always 1 if tx and rx plugged */
   if( !settings_current.rs232_handshake && 
-	if1_ula.fd_t != -1 && if1_ula.fd_r != -1 )
+	if1_ula.rs232_t && if1_ula.rs232_r )
     if1_ula.dtr = 1;
 
-  if( fd < 0 ) {
-    ui_error( UI_ERROR_ERROR, "Error opening '%s': %s",
-		filename, strerror( errno ) );
-    return;
-  }
+  /* if1_io_open() has already reported any error */
+  if( !channel ) return;
 
   if1_ula.s_net_mode = settings_current.raw_s_net ? 0 : 1;
   update_menu( UMENU_RS232 );
@@ -1316,25 +1351,22 @@ if1_unplug( int what )
 {
   switch( what ) {
   case 1:
-    if( if1_ula.fd_r >= 0 )
-      close( if1_ula.fd_r );
-    if1_ula.fd_r = -1;
+    if1_io_close( if1_ula.rs232_r );
+    if1_ula.rs232_r = NULL;
     break;
   case 2:
-    if( if1_ula.fd_t >= 0 )
-      close( if1_ula.fd_t );
-    if1_ula.fd_t = -1;
+    if1_io_close( if1_ula.rs232_t );
+    if1_ula.rs232_t = NULL;
     if1_ula.dtr = 0;
     break;
   case 3:
-    if( if1_ula.fd_net >= 0 )
-      close( if1_ula.fd_net );
-    if1_ula.fd_net = -1;
+    if1_io_close( if1_ula.snet );
+    if1_ula.snet = NULL;
     break;
   }
   /* rs232_handshake == 0 -> we assume DTR(DSR) always 1 if tx and rx plugged */
   if( !settings_current.rs232_handshake && 
-	( if1_ula.fd_t == -1 || if1_ula.fd_r == -1 ) )
+	( !if1_ula.rs232_t || !if1_ula.rs232_r ) )
     if1_ula.dtr = 0;
   update_menu( UMENU_RS232 );
 }
@@ -0,0 +1,864 @@
+/* if1_io.c: Buffered I/O for the Interface 1 RS-232 and network ports
+   Copyright (c) 2026 The Fuse authors
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+   Author contact information:
+
+   E-mail: philip-fuse@shadowmagic.org.uk
+
+*/
+
+#include "config.h"
+
+#include <errno.h>
+#include <string.h>
+
+#ifndef WIN32
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <sys/file.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif				/* #ifndef WIN32 */
+
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif				/* #ifdef HAVE_PTHREAD */
+
+#include "compat.h"
+#include "if1_io.h"
+#include "ui.h"
+#include "utils.h"
+
+#ifndef WIN32
+
+/* Must be a power of two */
+#define RING_SIZE 0x10000
+
+/* How often to look again at a file which has hit end of file or a bus
+   which has lost its hub */
+#define IDLE_TIMEOUT_MS 50
+
+#define BUS_PEERS_MAX 15
+
+/* RS-232 in and out, and the network */
+#define CHANNELS_MAX 3
+
+#ifndef O_NONBLOCK
+#define O_NONBLOCK FNDELAY
+#endif
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+/* `head' is where the next byte is written and `tail' where the next byte
+   is read; both only ever increase */
+typedef struct io_ring {
+  libspectrum_byte data[ RING_SIZE ];
+  size_t head, tail;
+} io_ring;
+
+typedef enum channel_type {
+  CHANNEL_FILE,
+  CHANNEL_BUS_CLIENT,		/* connected to the hub, or waiting to be */
+  CHANNEL_BUS_HUB,		/* `fd' is the listening socket */
+} channel_type;
+
+typedef struct bus_peer {
+  int fd;
+  io_ring *out;
+} bus_peer;
+
+struct if1_io_channel {
+
+  channel_type type;
+  if1_io_direction direction;
+  int fd;
+
+  io_ring in, out;
+
+  /* At end of file; not polled until the next idle timeout */
+  int idle;
+
+  /* The socket path and the other Fuses connected to the hub */
+  char *path;
+  bus_peer peers[ BUS_PEERS_MAX ];
+  size_t peer_count;
+
+  if1_io_channel *next;
+
+};
+
+static if1_io_channel *channels = NULL;
+
+#ifdef HAVE_PTHREAD
+
+/* Protects the rings of all channels; the channel list itself is only
+   changed while the I/O thread isn't running */
+static pthread_mutex_t io_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_t io_thread;
+static int io_thread_running = 0;
+static volatile int io_thread_quit;
+static int wake_pipe[2] = { -1, -1 };
+
+#define IO_LOCK() pthread_mutex_lock( &io_mutex )
+#define IO_UNLOCK() pthread_mutex_unlock( &io_mutex )
+
+#else				/* #ifdef HAVE_PTHREAD */
+
+#define IO_LOCK()
+#define IO_UNLOCK()
+
+#endif				/* #ifdef HAVE_PTHREAD */
+
+static size_t
+ring_used( const io_ring *ring )
+{
+  return ring->head - ring->tail;
+}
+
+static size_t
+ring_free( const io_ring *ring )
+{
+  return RING_SIZE - ring_used( ring );
+}
+
+/* Copy as much of `length' bytes as will fit; returns the number copied */
+static size_t
+ring_put( io_ring *ring, const libspectrum_byte *buffer, size_t length )
+{
+  size_t i, space = ring_free( ring );
+
+  if( length > space ) length = space;
+  for( i = 0; i < length; i++ )
+    ring->data[ ( ring->head + i ) & ( RING_SIZE - 1 ) ] = buffer[i];
+  ring->head += length;
+
+  return length;
+}
+
+/* Copy up to `length' bytes out without removing them */
+static size_t
+ring_peek( const io_ring *ring, libspectrum_byte *buffer, size_t length )
+{
+  size_t i, used = ring_used( ring );
+
+  if( length > used ) length = used;
+  for( i = 0; i < length; i++ )
+    buffer[i] = ring->data[ ( ring->tail + i ) & ( RING_SIZE - 1 ) ];
+
+  return length;
+}
+
+/* Data is copied out of or into the rings under the lock, but the system
+   calls are made without it so a slow device never holds up the port
+   handlers */
+
+static void
+fd_write_ring( int fd, io_ring *ring, int is_socket )
+{
+  libspectrum_byte buffer[ 4096 ];
+  size_t length;
+  ssize_t written;
+
+  IO_LOCK();
+  length = ring_peek( ring, buffer, sizeof( buffer ) );
+  IO_UNLOCK();
+  if( !length ) return;
+
+  written = is_socket ? send( fd, buffer, length, MSG_NOSIGNAL ) :
+                        write( fd, buffer, length );
+  if( written <= 0 ) return;
+
+  IO_LOCK();
+  ring->tail += written;
+  IO_UNLOCK();
+}
+
+/* Returns the number of bytes read, 0 at end of file or -1 on error */
+static ssize_t
+fd_read_ring( int fd, io_ring *ring )
+{
+  libspectrum_byte buffer[ 4096 ];
+  size_t space;
+  ssize_t length;
+
+  IO_LOCK();
+  space = ring_free( ring );
+  IO_UNLOCK();
+  if( space > sizeof( buffer ) ) space = sizeof( buffer );
+  if( !space ) {
+    errno = EAGAIN;
+    return -1;
+  }
+
+  length = read( fd, buffer, space );
+  if( length <= 0 ) return length;
+
+  IO_LOCK();
+  ring_put( ring, buffer, length );
+  IO_UNLOCK();
+
+  return length;
+}
+
+static int
+set_nonblocking( int fd )
+{
+  int flags = fcntl( fd, F_GETFL );
+  return flags == -1 || fcntl( fd, F_SETFL, flags | O_NONBLOCK ) == -1;
+}
+
+/* When the hub goes, every other station tries to take over at once.
+   Taking over is done holding a lock on a file alongside the socket, so
+   only one of them can find the hub missing, remove its socket and bind a
+   new one; the rest then find the new hub. Returns the locked descriptor,
+   or -1 with errno set */
+static int
+bus_lock( const char *path )
+{
+  size_t length = strlen( path ) + 6;
+  char *lock_path = libspectrum_new( char, length );
+  int fd, error;
+
+  snprintf( lock_path, length, "%s.lock", path );
+  fd = open( lock_path, O_RDWR | O_CREAT, 0600 );
+  libspectrum_free( lock_path );
+  if( fd == -1 ) return -1;
+
+  if( flock( fd, LOCK_EX ) ) {
+    error = errno;
+    close( fd );
+    errno = error;
+    return -1;
+  }
+
+  return fd;
+}
+
+static void
+bus_unlock( int fd )
+{
+  int error = errno;
+
+  flock( fd, LOCK_UN );
+  close( fd );
+
+  errno = error;
+}
+
+/* Connect a new socket to the hub at `address'. Returns the descriptor,
+   or -1 with errno set */
+static int
+bus_try_connect( const struct sockaddr_un *address )
+{
+  int fd, error;
+
+  fd = socket( AF_UNIX, SOCK_STREAM, 0 );
+  if( fd == -1 ) return -1;
+
+  if( connect( fd, (const struct sockaddr*)address, sizeof( *address ) ) ) {
+    error = errno;
+    close( fd );
+    errno = error;
+    return -1;
+  }
+
+  set_nonblocking( fd );
+
+  return fd;
+}
+
+/* Try to connect to the hub at channel->path, becoming the hub if there
+   isn't one. Returns 0 on success; errno is left set on failure */
+static int
+bus_connect( if1_io_channel *channel )
+{
+  struct sockaddr_un address;
+  int fd, lock, error;
+
+  if( strlen( channel->path ) >= sizeof( address.sun_path ) ) {
+    errno = ENAMETOOLONG;
+    return 1;
+  }
+
+  memset( &address, 0, sizeof( address ) );
+  address.sun_family = AF_UNIX;
+  strcpy( address.sun_path, channel->path );
+
+  fd = bus_try_connect( &address );
+  if( fd == -1 && errno != ENOENT && errno != ECONNREFUSED ) return 1;
+
+  if( fd == -1 ) {
+
+    lock = bus_lock( channel->path );
+    if( lock == -1 ) return 1;
+
+    /* Someone else may have taken over while we waited for the lock */
+    fd = bus_try_connect( &address );
+
+    if( fd == -1 ) {
+
+      if( errno != ENOENT && errno != ECONNREFUSED ) {
+        bus_unlock( lock );
+        return 1;
+      }
+
+      /* Nobody is listening, so remove any socket left behind by a hub
+         which went away and take over */
+      if( errno == ECONNREFUSED ) unlink( channel->path );
+
+      fd = socket( AF_UNIX, SOCK_STREAM, 0 );
+      if( fd == -1 ||
+          bind( fd, (struct sockaddr*)&address, sizeof( address ) ) ||
+          listen( fd, BUS_PEERS_MAX ) || set_nonblocking( fd ) ) {
+        error = errno;
+        if( fd != -1 ) close( fd );
+        bus_unlock( lock );
+        errno = error;
+        return 1;
+      }
+
+      bus_unlock( lock );
+
+      channel->type = CHANNEL_BUS_HUB;
+      channel->fd = fd;
+      channel->peer_count = 0;
+
+      return 0;
+    }
+
+    bus_unlock( lock );
+  }
+
+  channel->type = CHANNEL_BUS_CLIENT;
+  channel->fd = fd;
+
+  return 0;
+}
+
+static void
+bus_drop_peer( if1_io_channel *channel, size_t i )
+{
+  close( channel->peers[i].fd );
+  libspectrum_free( channel->peers[i].out );
+  channel->peers[i] = channel->peers[ --channel->peer_count ];
+}
+
+static void
+bus_disconnect( if1_io_channel *channel )
+{
+  if( channel->fd == -1 ) return;
+
+  /* Remove the socket before the peers hear we've gone, or one of them
+     could bind its own there first and have it removed */
+  if( channel->type == CHANNEL_BUS_HUB ) {
+    unlink( channel->path );
+    while( channel->peer_count ) bus_drop_peer( channel, 0 );
+  }
+
+  close( channel->fd );
+  channel->fd = -1;
+  channel->type = CHANNEL_BUS_CLIENT;
+}
+
+/* The hub passes everything it hears to every other station, including
+   itself, and everything it sends to all the other stations */
+static void
+bus_relay( if1_io_channel *channel, const libspectrum_byte *buffer,
+           size_t length, ssize_t from )
+{
+  size_t i;
+
+  IO_LOCK();
+  for( i = 0; i < channel->peer_count; i++ )
+    if( (ssize_t)i != from ) ring_put( channel->peers[i].out, buffer, length );
+  if( from != -1 ) ring_put( &channel->in, buffer, length );
+  IO_UNLOCK();
+}
+
+static void
+bus_hub_accept( if1_io_channel *channel )
+{
+  bus_peer *peer;
+  int fd = accept( channel->fd, NULL, NULL );
+
+  if( fd == -1 ) return;
+
+  if( channel->peer_count == BUS_PEERS_MAX || set_nonblocking( fd ) ) {
+    close( fd );
+    return;
+  }
+
+  peer = &channel->peers[ channel->peer_count ];
+  peer->fd = fd;
+  peer->out = libspectrum_new( io_ring, 1 );
+  peer->out->head = peer->out->tail = 0;
+  channel->peer_count++;
+}
+
+static void
+bus_hub_service( if1_io_channel *channel, const struct pollfd *fds )
+{
+  libspectrum_byte buffer[ 4096 ];
+  size_t i, length;
+  ssize_t got;
+
+  /* Our own station's output */
+  do {
+    IO_LOCK();
+    length = ring_peek( &channel->out, buffer, sizeof( buffer ) );
+    channel->out.tail += length;
+    IO_UNLOCK();
+    if( length ) bus_relay( channel, buffer, length, -1 );
+  } while( length );
+
+  /* Work downwards so a dropped peer is replaced by one already done */
+  for( i = channel->peer_count; i-- > 0; ) {
+    bus_peer *peer = &channel->peers[i];
+
+    if( !fds || fds[i].revents & ( POLLIN | POLLHUP | POLLERR ) ) {
+      got = read( peer->fd, buffer, sizeof( buffer ) );
+      if( got == 0 || ( got == -1 && errno != EAGAIN && errno != EINTR ) ) {
+        bus_drop_peer( channel, i );
+        continue;
+      }
+      if( got > 0 ) bus_relay( channel, buffer, got, i );
+    }
+
+    fd_write_ring( peer->fd, peer->out, 1 );
+  }
+}
+
+/* Move data for one channel. `fds' are the poll results for the
+   channel's own descriptor followed by those for any hub peers; NULL
+   when the caller didn't poll */
+static void
+channel_service( if1_io_channel *channel, const struct pollfd *fds )
+{
+  ssize_t got;
+
+  if( channel->fd == -1 ) return;
+
+  switch( channel->type ) {
+
+  case CHANNEL_FILE:
+    if( channel->direction & IF1_IO_READ && !channel->idle &&
+        ( !fds || fds[0].revents & ( POLLIN | POLLHUP | POLLERR ) ) ) {
+      got = fd_read_ring( channel->fd, &channel->in );
+      if( got == 0 || ( got == -1 && errno != EAGAIN && errno != EINTR ) )
+        channel->idle = 1;
+    }
+    if( channel->direction & IF1_IO_WRITE )
+      fd_write_ring( channel->fd, &channel->out, 0 );
+    break;
+
+  case CHANNEL_BUS_CLIENT:
+    if( !fds || fds[0].revents & ( POLLIN | POLLHUP | POLLERR ) ) {
+      got = fd_read_ring( channel->fd, &channel->in );
+      if( got == 0 || ( got == -1 && errno != EAGAIN && errno != EINTR ) ) {
+        /* The hub has gone; find or become a new one next time round */
+        bus_disconnect( channel );
+        return;
+      }
+    }
+    fd_write_ring( channel->fd, &channel->out, 1 );
+    break;
+
+  case CHANNEL_BUS_HUB:
+    /* Newcomers weren't polled, so must come after the existing peers */
+    if( !fds ) bus_hub_accept( channel );
+    bus_hub_service( channel, fds ? fds + 1 : NULL );
+    if( fds && fds[0].revents & POLLIN ) bus_hub_accept( channel );
+    break;
+
+  }
+}
+
+/* Things to do when nothing has happened for a while */
+static void
+channels_idle( void )
+{
+  if1_io_channel *channel;
+
+  for( channel = channels; channel; channel = channel->next ) {
+    channel->idle = 0;
+    if( channel->path && channel->fd == -1 ) bus_connect( channel );
+  }
+}
+
+#ifdef HAVE_PTHREAD
+
+static void
+wake_io_thread( void )
+{
+  libspectrum_byte byte = 0;
+
+  if( io_thread_running ) {
+    ssize_t written GCC_UNUSED = write( wake_pipe[1], &byte, 1 );
+  }
+}
+
+/* Wait until one of the channels can do something, and then do it */
+static void*
+io_thread_fn( void *arg GCC_UNUSED )
+{
+  struct pollfd fds[ 1 + CHANNELS_MAX * ( BUS_PEERS_MAX + 1 ) ];
+  size_t first[ CHANNELS_MAX ];
+  if1_io_channel *channel;
+  libspectrum_byte drain[ 64 ];
+  size_t n, i;
+  int timeout, ready;
+
+  while( !io_thread_quit ) {
+
+    fds[0].fd = wake_pipe[0]; fds[0].events = POLLIN;
+    n = 1; timeout = -1;
+
+    IO_LOCK();
+    for( channel = channels, i = 0; channel && i < CHANNELS_MAX;
+         channel = channel->next, i++ ) {
+      short events = 0;
+
+      first[i] = n;
+
+      if( channel->fd == -1 || channel->idle ) timeout = IDLE_TIMEOUT_MS;
+
+      if( channel->type == CHANNEL_BUS_HUB ) events = POLLIN;
+      else {
+        if( channel->direction & IF1_IO_READ && !channel->idle &&
+            ring_free( &channel->in ) )
+          events |= POLLIN;
+        if( channel->direction & IF1_IO_WRITE && ring_used( &channel->out ) )
+          events |= POLLOUT;
+      }
+      fds[n].fd = channel->fd; fds[n].events = events; n++;
+
+      if( channel->type == CHANNEL_BUS_HUB ) {
+        size_t p;
+        for( p = 0; p < channel->peer_count; p++ ) {
+          fds[n].fd = channel->peers[p].fd;
+          fds[n].events = POLLIN;
+          if( ring_used( channel->peers[p].out ) ) fds[n].events |= POLLOUT;
+          n++;
+        }
+      }
+    }
+    IO_UNLOCK();
+
+    ready = poll( fds, n, timeout );
+    if( ready == -1 ) {
+      if( errno == EINTR ) continue;
+      break;
+    }
+
+    if( ready == 0 ) {
+      channels_idle();
+      continue;
+    }
+
+    if( fds[0].revents & POLLIN ) {
+      ssize_t got GCC_UNUSED = read( wake_pipe[0], drain, sizeof( drain ) );
+    }
+
+    for( channel = channels, i = 0; channel && i < CHANNELS_MAX;
+         channel = channel->next, i++ )
+      channel_service( channel, &fds[ first[i] ] );
+  }
+
+  return NULL;
+}
+
+static void
+io_thread_stop( void )
+{
+  if( !io_thread_running ) return;
+
+  io_thread_quit = 1;
+  wake_io_thread();
+  pthread_join( io_thread, NULL );
+  io_thread_running = 0;
+
+  close( wake_pipe[0] ); close( wake_pipe[1] );
+  wake_pipe[0] = wake_pipe[1] = -1;
+}
+
+static void
+io_thread_start( void )
+{
+  if( io_thread_running || !channels ) return;
+
+  if( pipe( wake_pipe ) ) {
+    ui_error( UI_ERROR_ERROR, "couldn't create I/O wake-up pipe: %s",
+              strerror( errno ) );
+    return;
+  }
+  set_nonblocking( wake_pipe[0] ); set_nonblocking( wake_pipe[1] );
+
+  io_thread_quit = 0;
+  if( pthread_create( &io_thread, NULL, io_thread_fn, NULL ) ) {
+    ui_error( UI_ERROR_ERROR, "couldn't start Interface 1 I/O thread" );
+    close( wake_pipe[0] ); close( wake_pipe[1] );
+    wake_pipe[0] = wake_pipe[1] = -1;
+    return;
+  }
+
+  io_thread_running = 1;
+}
+
+#else				/* #ifdef HAVE_PTHREAD */
+
+/* Without a thread, the port handlers do the I/O themselves whenever
+   they run out of input or have something to send */
+static void
+wake_io_thread( void )
+{
+}
+
+static void
+channels_service( void )
+{
+  if1_io_channel *channel;
+
+  channels_idle();
+  for( channel = channels; channel; channel = channel->next )
+    channel_service( channel, NULL );
+}
+
+static void
+io_thread_stop( void )
+{
+}
+
+static void
+io_thread_start( void )
+{
+}
+
+#endif				/* #ifdef HAVE_PTHREAD */
+
+/* Allocate a channel and add it to the list; the caller has already
+   stopped the I/O thread */
+static if1_io_channel*
+channel_alloc( channel_type type, if1_io_direction direction, int fd )
+{
+  if1_io_channel *channel = libspectrum_new( if1_io_channel, 1 );
+
+  memset( channel, 0, sizeof( *channel ) );
+  channel->type = type;
+  channel->direction = direction;
+  channel->fd = fd;
+
+  channel->next = channels;
+  channels = channel;
+
+  return channel;
+}
+
+if1_io_channel*
+if1_io_open( const char *filename, if1_io_direction direction )
+{
+  if1_io_channel *channel;
+  int fd = open( filename, O_RDWR | O_NONBLOCK );
+
+  if( fd == -1 ) {
+    ui_error( UI_ERROR_ERROR, "Error opening '%s': %s", filename,
+              strerror( errno ) );
+    return NULL;
+  }
+
+  io_thread_stop();
+  channel = channel_alloc( CHANNEL_FILE, direction, fd );
+  io_thread_start();
+
+  return channel;
+}
+
+if1_io_channel*
+if1_io_open_bus( const char *path )
+{
+  if1_io_channel *channel;
+
+  io_thread_stop();
+
+  channel = channel_alloc( CHANNEL_BUS_CLIENT, IF1_IO_READ | IF1_IO_WRITE,
+                           -1 );
+  channel->path = utils_safe_strdup( path );
+
+  if( bus_connect( channel ) ) {
+    ui_error( UI_ERROR_ERROR, "Couldn't join network at '%s': %s", path,
+              strerror( errno ) );
+    channels = channel->next;
+    libspectrum_free( channel->path );
+    libspectrum_free( channel );
+    channel = NULL;
+  }
+
+  io_thread_start();
+
+  return channel;
+}
+
+void
+if1_io_close( if1_io_channel *channel )
+{
+  if1_io_channel **link;
+
+  if( !channel ) return;
+
+  io_thread_stop();
+
+  for( link = &channels; *link; link = &(*link)->next ) {
+    if( *link == channel ) {
+      *link = channel->next;
+      break;
+    }
+  }
+
+  /* Give anything still waiting to be written a last chance to go */
+  channel_service( channel, NULL );
+
+  if( channel->path ) {
+    bus_disconnect( channel );
+    libspectrum_free( channel->path );
+  } else if( channel->fd != -1 ) {
+    close( channel->fd );
+  }
+  libspectrum_free( channel );
+
+  io_thread_start();
+}
+
+int
+if1_io_read( if1_io_channel *channel, libspectrum_byte *byte )
+{
+  int got, was_full;
+
+  if( !channel ) return 0;
+
+#ifndef HAVE_PTHREAD
+  if( !ring_used( &channel->in ) ) channels_service();
+#endif				/* #ifndef HAVE_PTHREAD */
+
+  IO_LOCK();
+  got = ring_used( &channel->in ) != 0;
+  was_full = !ring_free( &channel->in );
+  if( got ) {
+    *byte = channel->in.data[ channel->in.tail & ( RING_SIZE - 1 ) ];
+    channel->in.tail++;
+  }
+  IO_UNLOCK();
+
+  /* The I/O thread stops reading when the buffer is full */
+  if( was_full ) wake_io_thread();
+
+  return got;
+}
+
+/* Queue all of `length' bytes, or none of them if they won't all fit */
+static void
+channel_write( if1_io_channel *channel, const libspectrum_byte *buffer,
+               size_t length )
+{
+  int was_empty;
+
+  if( !channel ) return;
+
+  IO_LOCK();
+  was_empty = !ring_used( &channel->out );
+  if( ring_free( &channel->out ) >= length )
+    ring_put( &channel->out, buffer, length );
+  IO_UNLOCK();
+
+  if( was_empty ) wake_io_thread();
+
+#ifndef HAVE_PTHREAD
+  channels_service();
+#endif				/* #ifndef HAVE_PTHREAD */
+}
+
+void
+if1_io_write( if1_io_channel *channel, libspectrum_byte byte )
+{
+  channel_write( channel, &byte, 1 );
+}
+
+void
+if1_io_write_escape( if1_io_channel *channel, libspectrum_byte code )
+{
+  libspectrum_byte buffer[2];
+
+  buffer[0] = 0x00; buffer[1] = code;
+  channel_write( channel, buffer, 2 );
+}
+
+void
+if1_io_end( void )
+{
+  while( channels ) if1_io_close( channels );
+}
+
+#else				/* #ifndef WIN32 */
+
+if1_io_channel*
+if1_io_open( const char *filename GCC_UNUSED,
+             if1_io_direction direction GCC_UNUSED )
+{
+  ui_error( UI_ERROR_ERROR, "Not yet implemented on Win32" );
+  return NULL;
+}
+
+if1_io_channel*
+if1_io_open_bus( const char *path GCC_UNUSED )
+{
+  ui_error( UI_ERROR_ERROR, "Not yet implemented on Win32" );
+  return NULL;
+}
+
+void
+if1_io_close( if1_io_channel *channel GCC_UNUSED )
+{
+}
+
+int
+if1_io_read( if1_io_channel *channel GCC_UNUSED,
+             libspectrum_byte *byte GCC_UNUSED )
+{
+  return 0;
+}
+
+void
+if1_io_write( if1_io_channel *channel GCC_UNUSED,
+              libspectrum_byte byte GCC_UNUSED )
+{
+}
+
+void
+if1_io_write_escape( if1_io_channel *channel GCC_UNUSED,
+                     libspectrum_byte code GCC_UNUSED )
+{
+}
+
+void
+if1_io_end( void )
+{
+}
+
+#endif				/* #ifndef WIN32 */
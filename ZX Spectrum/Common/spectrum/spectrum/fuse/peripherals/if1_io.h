@@ -0,0 +1,69 @@
+/* if1_io.h: Buffered I/O for the Interface 1 RS-232 and network ports
+   Copyright (c) 2026 The Fuse authors
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+   Author contact information:
+
+   E-mail: philip-fuse@shadowmagic.org.uk
+
+*/
+
+#ifndef FUSE_IF1_IO_H
+#define FUSE_IF1_IO_H
+
+#include "libspectrum.h"
+
+/* Names starting with this prefix connect the network to a local bus of
+   Fuse instances over a Unix-domain socket rather than opening a file */
+#define IF1_IO_SOCKET_PREFIX "unix:"
+
+typedef enum if1_io_direction {
+  IF1_IO_READ = 1 << 0,
+  IF1_IO_WRITE = 1 << 1,
+} if1_io_direction;
+
+/* A byte stream to or from a file, FIFO, terminal or socket. The port
+   handlers only ever touch the channel's buffers; the system calls are
+   made from a background thread where threads are available */
+typedef struct if1_io_channel if1_io_channel;
+
+/* Open a file, FIFO or terminal for reading, writing or both. Returns NULL
+   after reporting an error */
+if1_io_channel* if1_io_open( const char *filename,
+                             if1_io_direction direction );
+
+/* Join the network bus at `path' (a Unix-domain socket). The first Fuse to
+   join becomes the hub which relays every byte to all the others */
+if1_io_channel* if1_io_open_bus( const char *path );
+
+void if1_io_close( if1_io_channel *channel );
+
+/* Get the next received byte; returns 1 if there was one, 0 if not. A NULL
+   channel never has anything to read and discards everything written */
+int if1_io_read( if1_io_channel *channel, libspectrum_byte *byte );
+
+/* Queue a byte to be written. Bytes are dropped if the other end hasn't
+   taken the last 64K */
+void if1_io_write( if1_io_channel *channel, libspectrum_byte byte );
+
+/* Queue 0x00 followed by `code', as used for the RS-232 handshake lines
+   and escaped bytes. Either both bytes are written or neither is, as half
+   a pair would corrupt the stream */
+void if1_io_write_escape( if1_io_channel *channel, libspectrum_byte code );
+
+void if1_io_end( void );
+
+#endif				/* #ifndef FUSE_IF1_IO_H */
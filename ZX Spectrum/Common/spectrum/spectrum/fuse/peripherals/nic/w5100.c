@@ -28,12 +28,17 @@
 
 #include "config.h"
 
+#include <errno.h>
 #include <pthread.h>
 #include <string.h>
 #include <sys/types.h>
 #include <sys/time.h>
 #include <unistd.h>
 
+#ifdef HAVE_SYS_EPOLL_H
+#include <sys/epoll.h>
+#endif                          /* #ifdef HAVE_SYS_EPOLL_H */
+
 #include "fuse.h"
 #include "ui.h"
 #include "w5100.h"
@@ -83,59 +88,337 @@ nic_w5100_reset( nic_w5100_t *self )
   memset( self->sip, 0, sizeof( self->sip ) );
 
   for( i = 0; i < 4; i++ )
-    nic_w5100_socket_reset( &self->socket[i] );
+    nic_w5100_socket_reset( self, &self->socket[i] );
+}
+
+size_t
+nic_w5100_ring_used( nic_w5100_ring_t *ring )
+{
+  return W5100_LOAD_ACQUIRE( ring->head ) - W5100_LOAD_ACQUIRE( ring->tail );
+}
+
+size_t
+nic_w5100_ring_free( nic_w5100_ring_t *ring )
+{
+  return W5100_RING_SIZE - nic_w5100_ring_used( ring );
+}
+
+/* Producer only; the caller must have checked there is room */
+void
+nic_w5100_ring_write( nic_w5100_ring_t *ring, const void *data, size_t length )
+{
+  size_t head = ring->head;
+  size_t offset = head & ( W5100_RING_SIZE - 1 );
+  size_t first_chunk = W5100_RING_SIZE - offset;
+
+  if( first_chunk > length ) first_chunk = length;
+  memcpy( &ring->data[ offset ], data, first_chunk );
+  memcpy( ring->data, (const libspectrum_byte*)data + first_chunk,
+          length - first_chunk );
+
+  W5100_STORE_RELEASE( ring->head, head + length );
+}
+
+/* Consumer only */
+void
+nic_w5100_ring_peek( nic_w5100_ring_t *ring, size_t offset, void *data,
+                     size_t length )
+{
+  size_t start = ( ring->tail + offset ) & ( W5100_RING_SIZE - 1 );
+  size_t first_chunk = W5100_RING_SIZE - start;
+
+  if( first_chunk > length ) first_chunk = length;
+  memcpy( data, &ring->data[ start ], first_chunk );
+  memcpy( (libspectrum_byte*)data + first_chunk, ring->data,
+          length - first_chunk );
+}
+
+void
+nic_w5100_ring_skip( nic_w5100_ring_t *ring, size_t length )
+{
+  W5100_STORE_RELEASE( ring->tail, ring->tail + length );
+}
+
+void
+nic_w5100_send_command( nic_w5100_t *self, w5100_io_command *command )
+{
+  /* The I/O thread never blocks on anything but the poller, so this can't
+     wait for long */
+  while( nic_w5100_ring_free( &self->commands ) < sizeof( *command ) )
+    compat_socket_selfpipe_wake( self->selfpipe );
+
+  nic_w5100_ring_write( &self->commands, command, sizeof( *command ) );
+
+  /* Pairs with the fence in w5100_io_thread(): either it sees this command
+     before going into the poller, or we see that it's going there */
+  W5100_FENCE();
+  if( W5100_LOAD_ACQUIRE( self->io_sleeping ) )
+    compat_socket_selfpipe_wake( self->selfpipe );
+}
+
+void
+nic_w5100_process_events( nic_w5100_t *self )
+{
+  w5100_io_event event;
+  int i;
+
+  while( nic_w5100_ring_used( &self->events ) >= sizeof( event ) ) {
+    nic_w5100_ring_peek( &self->events, 0, &event, sizeof( event ) );
+    nic_w5100_ring_skip( &self->events, sizeof( event ) );
+    nic_w5100_socket_event( self, &self->socket[ event.socket ], &event );
+  }
+
+  for( i = 0; i < 4; i++ )
+    nic_w5100_socket_sync( self, &self->socket[i] );
+}
+
+void
+nic_w5100_post_event( nic_w5100_t *self, nic_w5100_socket_t *socket,
+                      w5100_io_event_type type )
+{
+  w5100_io_event event;
+
+  /* Replies are bounded by the commands which caused them, so this only
+     happens if the emulation has stopped looking */
+  if( nic_w5100_ring_free( &self->events ) < sizeof( event ) ) {
+    nic_w5100_debug( "w5100: event queue full; dropping event %d for socket %d\n",
+                     type, socket->id );
+    return;
+  }
+
+  event.type = type;
+  event.socket = socket->id;
+  event.generation = socket->io_generation;
+  event.rx_start = socket->rx_ring.head;
+  event.tx_sent = socket->tx_sent;
+
+  nic_w5100_ring_write( &self->events, &event, sizeof( event ) );
+}
+
+/* The poller: epoll where we have it, select() otherwise. Sockets are
+   identified by their index, with 4 being the self-pipe */
+
+#define W5100_POLL_SELFPIPE 4
+
+typedef struct w5100_poll_result {
+  int which;
+  int ready;
+} w5100_poll_result;
+
+#ifdef HAVE_SYS_EPOLL_H
+
+static int
+w5100_poll_events( int interest )
+{
+  return ( interest & W5100_POLL_READ ? EPOLLIN : 0 ) |
+         ( interest & W5100_POLL_WRITE ? EPOLLOUT : 0 );
+}
+
+static void
+w5100_poll_init( nic_w5100_t *self )
+{
+  struct epoll_event event;
+
+  self->epoll_fd = epoll_create( 5 );
+  if( self->epoll_fd == -1 ) {
+    ui_error( UI_ERROR_ERROR, "w5100: error %d creating epoll instance",
+              compat_socket_get_error() );
+    fuse_abort();
+  }
+
+  memset( &event, 0, sizeof( event ) );
+  event.events = EPOLLIN;
+  event.data.u32 = W5100_POLL_SELFPIPE;
+  epoll_ctl( self->epoll_fd, EPOLL_CTL_ADD,
+             compat_socket_selfpipe_get_read_fd( self->selfpipe ), &event );
+}
+
+static void
+w5100_poll_end( nic_w5100_t *self )
+{
+  close( self->epoll_fd );
+}
+
+/* Tell the kernel only about changes in what each socket is waiting for */
+static void
+w5100_poll_update( nic_w5100_t *self, nic_w5100_socket_t *socket,
+                   int interest )
+{
+  struct epoll_event event;
+  int op;
+
+  if( interest == socket->interest ) return;
+
+  if( !socket->interest ) {
+    op = EPOLL_CTL_ADD;
+  } else if( !interest ) {
+    op = EPOLL_CTL_DEL;
+  } else {
+    op = EPOLL_CTL_MOD;
+  }
+
+  memset( &event, 0, sizeof( event ) );
+  event.events = w5100_poll_events( interest );
+  event.data.u32 = socket->id;
+
+  if( epoll_ctl( self->epoll_fd, op, socket->fd, &event ) == -1 )
+    nic_w5100_debug( "w5100: epoll_ctl failed for socket %d; errno %d: %s\n",
+                     socket->id, compat_socket_get_error(),
+                     compat_socket_get_strerror() );
+
+  socket->interest = interest;
+}
+
+static int
+w5100_poll_wait( nic_w5100_t *self, w5100_poll_result *results )
+{
+  struct epoll_event events[ W5100_POLL_SELFPIPE + 1 ];
+  int i, active;
+
+  active = epoll_wait( self->epoll_fd, events, ARRAY_SIZE( events ), -1 );
+
+  for( i = 0; i < active; i++ ) {
+    results[i].which = events[i].data.u32;
+    results[i].ready =
+      ( events[i].events & ( EPOLLIN | EPOLLHUP | EPOLLERR ) ?
+        W5100_POLL_READ : 0 ) |
+      ( events[i].events & ( EPOLLOUT | EPOLLHUP | EPOLLERR ) ?
+        W5100_POLL_WRITE : 0 );
+  }
+
+  return active;
+}
+
+#else                           /* #ifdef HAVE_SYS_EPOLL_H */
+
+static void
+w5100_poll_init( nic_w5100_t *self GCC_UNUSED )
+{
+}
+
+static void
+w5100_poll_end( nic_w5100_t *self GCC_UNUSED )
+{
+}
+
+static void
+w5100_poll_update( nic_w5100_t *self GCC_UNUSED, nic_w5100_socket_t *socket,
+                   int interest )
+{
+  socket->interest = interest;
+}
+
+static int
+w5100_poll_wait( nic_w5100_t *self, w5100_poll_result *results )
+{
+  fd_set readfds, writefds;
+  compat_socket_t selfpipe_socket =
+    compat_socket_selfpipe_get_read_fd( self->selfpipe );
+  int max_fd = selfpipe_socket;
+  int i, n, active;
+
+  FD_ZERO( &readfds );
+  FD_ZERO( &writefds );
+
+  FD_SET( selfpipe_socket, &readfds );
+
+  for( i = 0; i < 4; i++ ) {
+    nic_w5100_socket_t *socket = &self->socket[i];
+    if( socket->interest & W5100_POLL_READ ) FD_SET( socket->fd, &readfds );
+    if( socket->interest & W5100_POLL_WRITE ) FD_SET( socket->fd, &writefds );
+    if( socket->interest && socket->fd > max_fd ) max_fd = socket->fd;
+  }
+
+  active = select( max_fd + 1, &readfds, &writefds, NULL, NULL );
+  if( active == -1 ) return -1;
+
+  n = 0;
+
+  if( FD_ISSET( selfpipe_socket, &readfds ) ) {
+    results[n].which = W5100_POLL_SELFPIPE;
+    results[n++].ready = W5100_POLL_READ;
+  }
+
+  for( i = 0; i < 4; i++ ) {
+    nic_w5100_socket_t *socket = &self->socket[i];
+    int ready = 0;
+
+    if( !socket->interest ) continue;
+    if( FD_ISSET( socket->fd, &readfds ) ) ready |= W5100_POLL_READ;
+    if( FD_ISSET( socket->fd, &writefds ) ) ready |= W5100_POLL_WRITE;
+
+    if( ready ) {
+      results[n].which = i;
+      results[n++].ready = ready;
+    }
+  }
+
+  return n;
+}
+
+#endif                          /* #ifdef HAVE_SYS_EPOLL_H */
+
+static void
+w5100_io_process_commands( nic_w5100_t *self )
+{
+  w5100_io_command command;
+
+  while( nic_w5100_ring_used( &self->commands ) >= sizeof( command ) ) {
+    nic_w5100_ring_peek( &self->commands, 0, &command, sizeof( command ) );
+    nic_w5100_ring_skip( &self->commands, sizeof( command ) );
+    nic_w5100_socket_command( self, &self->socket[ command.socket ],
+                              &command );
+  }
 }
 
 static void*
 w5100_io_thread( void *arg )
 {
   nic_w5100_t *self = arg;
-  int i;
+  w5100_poll_result results[ W5100_POLL_SELFPIPE + 1 ];
+  int i, active;
 
   while( !self->stop_io_thread ) {
-    fd_set readfds, writefds;
-    int active;
-    compat_socket_t selfpipe_socket =
-      compat_socket_selfpipe_get_read_fd( self->selfpipe );
-    int max_fd = selfpipe_socket;
-
-    FD_ZERO( &readfds );
-    FD_ZERO( &writefds );
 
-    FD_SET( selfpipe_socket, &readfds );
+    w5100_io_process_commands( self );
 
     for( i = 0; i < 4; i++ )
-      nic_w5100_socket_add_to_sets( &self->socket[i], &readfds, &writefds,
-        &max_fd );
+      w5100_poll_update( self, &self->socket[i],
+                         nic_w5100_socket_interest( &self->socket[i] ) );
 
-    /* Note that if a socket is closed between when we added it to the sets
-       above and when we call select() below, it will cause the select to fail
-       with EBADF. We catch this and just run around the loop again - the
-       offending socket will not be added to the sets again as it's now been
-       closed */
+    W5100_STORE_RELEASE( self->io_sleeping, 1 );
+    W5100_FENCE();
 
-    nic_w5100_debug( "w5100: io thread select\n" );
+    /* A command which arrived since we last looked wouldn't have woken us */
+    if( nic_w5100_ring_used( &self->commands ) ) {
+      W5100_STORE_RELEASE( self->io_sleeping, 0 );
+      continue;
+    }
+
+    nic_w5100_debug( "w5100: io thread wait\n" );
 
-    active = select( max_fd + 1, &readfds, &writefds, NULL, NULL );
+    active = w5100_poll_wait( self, results );
+
+    W5100_STORE_RELEASE( self->io_sleeping, 0 );
 
     nic_w5100_debug( "w5100: io thread wake; %d active\n", active );
 
-    if( active != -1 ) {
-      if( FD_ISSET( selfpipe_socket, &readfds ) ) {
+    if( active == -1 ) {
+      if( compat_socket_get_error() != EINTR )
+        nic_w5100_debug( "w5100: poll returned unexpected errno %d: %s\n",
+                         compat_socket_get_error(),
+                         compat_socket_get_strerror() );
+      continue;
+    }
+
+    for( i = 0; i < active; i++ ) {
+      if( results[i].which == W5100_POLL_SELFPIPE ) {
         nic_w5100_debug( "w5100: discarding selfpipe data\n" );
         compat_socket_selfpipe_discard_data( self->selfpipe );
+      } else {
+        nic_w5100_socket_process_io( self, &self->socket[ results[i].which ],
+                                     results[i].ready );
       }
-
-      for( i = 0; i < 4; i++ )
-        nic_w5100_socket_process_io( &self->socket[i], readfds, writefds );
-    }
-    else if( compat_socket_get_error() == compat_socket_EBADF ) {
-      /* Do nothing - just loop again */
-    }
-    else {
-      nic_w5100_debug( "w5100: select returned unexpected errno %d: %s\n",
-                       compat_socket_get_error(),
-                       compat_socket_get_strerror() );
     }
   }
 
@@ -155,12 +438,18 @@ nic_w5100_alloc( void )
 
   self->selfpipe = compat_socket_selfpipe_alloc();
 
+  self->commands.head = self->commands.tail = 0;
+  self->events.head = self->events.tail = 0;
+
   for( i = 0; i < 4; i++ )
     nic_w5100_socket_init( &self->socket[i], i );
 
   nic_w5100_reset( self );
 
   self->stop_io_thread = 0;
+  self->io_sleeping = 0;
+
+  w5100_poll_init( self );
 
   error = pthread_create( &self->thread, NULL, w5100_io_thread, self );
   if( error ) {
@@ -185,6 +474,8 @@ nic_w5100_free( nic_w5100_t *self )
     for( i = 0; i < 4; i++ )
       nic_w5100_socket_end( &self->socket[i] );
 
+    w5100_poll_end( self );
+
     compat_socket_selfpipe_free( self->selfpipe );
 
     compat_socket_networking_end();
@@ -240,6 +531,7 @@ nic_w5100_read( nic_w5100_t *self, libspectrum_word reg )
     }
   }
   else if( reg >= 0x400 && reg < 0x800 ) {
+    nic_w5100_process_events( self );
     b = nic_w5100_socket_read( self, reg );
   }
   else if( reg >= 0x6000 && reg < 0x8000 ) {
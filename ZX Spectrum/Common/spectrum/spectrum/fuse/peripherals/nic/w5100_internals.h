@@ -49,6 +49,7 @@ typedef enum w5100_socket_state {
 
   W5100_SOCKET_STATE_INIT = 0x13,
   W5100_SOCKET_STATE_LISTEN,
+  W5100_SOCKET_STATE_SYNSENT,
   W5100_SOCKET_STATE_ESTABLISHED = 0x17,
   W5100_SOCKET_STATE_CLOSE_WAIT = 0x1c,
 
@@ -85,11 +86,92 @@ enum w5100_socket_registers {
   W5100_SOCKET_RX_RD1,
 };
 
+/* The emulation and I/O threads share nothing but single-producer,
+   single-consumer rings. Only the producer moves `head' and only the
+   consumer moves `tail', so no locks are needed; these make sure the data
+   is visible before the index which publishes it */
+#define W5100_LOAD_ACQUIRE( x ) __atomic_load_n( &(x), __ATOMIC_ACQUIRE )
+#define W5100_STORE_RELEASE( x, v ) __atomic_store_n( &(x), (v), __ATOMIC_RELEASE )
+#define W5100_FENCE() __atomic_thread_fence( __ATOMIC_SEQ_CST )
+
+/* Must be a power of two, and comfortably bigger than the W5100's 2K
+   buffers */
+#define W5100_RING_SIZE 0x4000
+
+typedef struct nic_w5100_ring_t {
+  libspectrum_byte data[ W5100_RING_SIZE ];
+  size_t head;
+  size_t tail;
+} nic_w5100_ring_t;
+
+size_t nic_w5100_ring_used( nic_w5100_ring_t *ring );
+size_t nic_w5100_ring_free( nic_w5100_ring_t *ring );
+void nic_w5100_ring_write( nic_w5100_ring_t *ring, const void *data,
+                           size_t length );
+void nic_w5100_ring_peek( nic_w5100_ring_t *ring, size_t offset, void *data,
+                          size_t length );
+void nic_w5100_ring_skip( nic_w5100_ring_t *ring, size_t length );
+
+/* Commands from the emulation thread to the I/O thread */
+typedef enum w5100_io_command_type {
+  W5100_IO_OPEN,
+  W5100_IO_BIND,
+  W5100_IO_LISTEN,
+  W5100_IO_CONNECT,
+  W5100_IO_CLOSE,
+} w5100_io_command_type;
+
+typedef struct w5100_io_command {
+  w5100_io_command_type type;
+  int socket;
+  int generation;
+  w5100_socket_mode mode;
+  libspectrum_byte ip[4];   /* Our IP address and port */
+  libspectrum_byte port[2];
+  libspectrum_byte dip[4];  /* Destination IP address and port */
+  libspectrum_byte dport[2];
+  size_t tx_start;          /* Where the new socket's data starts */
+} w5100_io_command;
+
+/* And the I/O thread's replies */
+typedef enum w5100_io_event_type {
+  W5100_IO_OPENED,
+  W5100_IO_OPEN_FAILED,
+  W5100_IO_BIND_FAILED,
+  W5100_IO_LISTEN_FAILED,
+  W5100_IO_CONNECTED,
+  W5100_IO_CONNECT_FAILED,
+  W5100_IO_ACCEPTED,
+  W5100_IO_EOF,
+} w5100_io_event_type;
+
+typedef struct w5100_io_event {
+  w5100_io_event_type type;
+  int socket;
+  int generation;
+  size_t rx_start;          /* Where the new socket's data starts */
+  size_t tx_sent;           /* nic_w5100_socket_t.tx_sent at the time */
+} w5100_io_event;
+
+typedef enum w5100_io_state {
+  W5100_IO_STATE_CLOSED,
+  W5100_IO_STATE_OPEN,      /* TCP before listen() or connect() */
+  W5100_IO_STATE_UDP,
+  W5100_IO_STATE_LISTEN,
+  W5100_IO_STATE_CONNECTING,
+  W5100_IO_STATE_ESTABLISHED,
+  W5100_IO_STATE_EOF,       /* TCP peer has closed its end */
+} w5100_io_state;
+
+/* What a socket wants to be woken for */
+#define W5100_POLL_READ  ( 1 << 0 )
+#define W5100_POLL_WRITE ( 1 << 1 )
+
 typedef struct nic_w5100_socket_t {
 
   int id; /* For debug use only */
 
-  /* W5100 properties */
+  /* W5100 properties; only used from the emulation thread */
 
   w5100_socket_mode mode;
   libspectrum_byte flags;
@@ -114,23 +196,31 @@ typedef struct nic_w5100_socket_t {
   libspectrum_byte tx_buffer[0x800];  /* Transmit buffer */
   libspectrum_byte rx_buffer[0x800];  /* Received buffer */
 
-  /* Host properties */
-
-  compat_socket_t fd;       /* Socket file descriptor */
   int bind_count;           /* Number of writes to the Sn_PORTx registers we've received */
-  int socket_bound;         /* True once we've bound the socket to a port */
-  int write_pending;        /* True if we're waiting to write data on this socket */
+  int bind_requested;       /* True once we've asked for a UDP socket to be bound */
+
+  /* Bumped whenever the host socket is opened or closed, so replies about
+     an earlier incarnation of the socket can be recognised and ignored */
+  int generation;
+  int synced;               /* True once the I/O thread has opened the
+                               current generation */
+  libspectrum_word tx_queued; /* Sn_TX_WR when the SEND command was last sent */
+  size_t tx_sent_seen;      /* How much of tx_sent we've accounted for */
 
-  int last_send;            /* The value of Sn_TX_WR when the SEND command was last sent */
-  int datagram_lengths[0x20]; /* The lengths of datagrams to be sent */
-  int datagram_count;
+  /* Shared between the threads */
 
-  /* Flag used to indicate that a socket has been closed since we started
-     waiting for it in a select() call and therefore the socket should no
-     longer be used */
-  int ok_for_io;
+  nic_w5100_ring_t rx_ring; /* Received data, with W5100 headers for UDP */
+  nic_w5100_ring_t tx_ring; /* Data to send; UDP datagrams are preceded
+                               by their destination and length */
+  size_t tx_sent;           /* Bytes sent since startup; I/O thread only */
 
-  pthread_mutex_t lock;     /* Mutex for this socket */
+  /* Host properties; only used from the I/O thread */
+
+  compat_socket_t fd;       /* Socket file descriptor */
+  w5100_io_state io_state;
+  int io_generation;
+  int socket_bound;         /* True once we've bound the socket to a port */
+  int interest;             /* W5100_POLL_* the poller is watching for */
 
 } nic_w5100_socket_t;
 
@@ -142,15 +232,23 @@ struct nic_w5100_t {
 
   nic_w5100_socket_t socket[4];
 
+  nic_w5100_ring_t commands; /* w5100_io_commands to the I/O thread */
+  nic_w5100_ring_t events;   /* w5100_io_events from it */
+
   pthread_t thread;         /* Thread for doing I/O */
   sig_atomic_t stop_io_thread; /* Flag to stop I/O thread */
   compat_socket_selfpipe_t *selfpipe; /* Device for waking I/O thread */
+  int io_sleeping;          /* Set while the I/O thread may be in the poller */
+
+#ifdef HAVE_SYS_EPOLL_H
+  int epoll_fd;
+#endif                          /* #ifdef HAVE_SYS_EPOLL_H */
 };
 
 void nic_w5100_socket_init( nic_w5100_socket_t *socket, int which );
 void nic_w5100_socket_end( nic_w5100_socket_t *socket );
 
-void nic_w5100_socket_reset( nic_w5100_socket_t *socket );
+void nic_w5100_socket_reset( nic_w5100_t *self, nic_w5100_socket_t *socket );
 
 libspectrum_byte nic_w5100_socket_read( nic_w5100_t *self, libspectrum_word reg );
 void nic_w5100_socket_write( nic_w5100_t *self, libspectrum_word reg, libspectrum_byte b );
@@ -158,10 +256,22 @@ void nic_w5100_socket_write( nic_w5100_t *self, libspectrum_word reg, libspectru
 libspectrum_byte nic_w5100_socket_read_rx_buffer( nic_w5100_t *self, libspectrum_word reg );
 void nic_w5100_socket_write_tx_buffer( nic_w5100_t *self, libspectrum_word reg, libspectrum_byte b );
 
-void nic_w5100_socket_add_to_sets( nic_w5100_socket_t *socket, fd_set *readfds,
-  fd_set *writefds, int *max_fd );
-void nic_w5100_socket_process_io( nic_w5100_socket_t *socket, fd_set readfds,
-  fd_set writefds );
+/* Emulation thread side of the queues */
+void nic_w5100_send_command( nic_w5100_t *self, w5100_io_command *command );
+void nic_w5100_process_events( nic_w5100_t *self );
+void nic_w5100_socket_event( nic_w5100_t *self, nic_w5100_socket_t *socket,
+                             const w5100_io_event *event );
+void nic_w5100_socket_sync( nic_w5100_t *self, nic_w5100_socket_t *socket );
+
+/* I/O thread side */
+void nic_w5100_post_event( nic_w5100_t *self, nic_w5100_socket_t *socket,
+                           w5100_io_event_type type );
+void nic_w5100_socket_command( nic_w5100_t *self, nic_w5100_socket_t *socket,
+                               const w5100_io_command *command );
+int nic_w5100_socket_interest( nic_w5100_socket_t *socket );
+void nic_w5100_socket_process_io( nic_w5100_t *self,
+                                  nic_w5100_socket_t *socket, int ready );
+void nic_w5100_socket_io_close( nic_w5100_socket_t *socket );
 
 /* Debug routines */
 
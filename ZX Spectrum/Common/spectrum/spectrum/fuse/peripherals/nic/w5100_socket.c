@@ -28,7 +28,6 @@
 
 #include "config.h"
 
-#include <pthread.h>
 #include <string.h>
 #include <sys/types.h>
 #include <unistd.h>
@@ -58,84 +57,91 @@ enum w5100_socket_command {
 };
 
 static void
-w5100_socket_init_common( nic_w5100_socket_t *socket )
+w5100_socket_clean( nic_w5100_socket_t *socket )
 {
-  socket->fd = compat_socket_invalid;
+  socket->ir = 0;
+  memset( socket->port, 0, sizeof( socket->port ) );
+  memset( socket->dip, 0, sizeof( socket->dip ) );
+  memset( socket->dport, 0, sizeof( socket->dport ) );
+  socket->tx_rr = socket->tx_wr = 0;
+  socket->rx_rsr = 0;
+  socket->old_rx_rd = socket->rx_rd = 0;
+
+  socket->tx_queued = 0;
   socket->bind_count = 0;
-  socket->socket_bound = 0;
-  socket->ok_for_io = 0;
-  socket->write_pending = 0;
+  socket->bind_requested = 0;
 }
 
 void
 nic_w5100_socket_init( nic_w5100_socket_t *socket, int which )
 {
   socket->id = which;
-  w5100_socket_init_common( socket );
-  pthread_mutex_init( &socket->lock, NULL );
+
+  socket->generation = socket->io_generation = 0;
+  socket->synced = 0;
+  socket->tx_sent = socket->tx_sent_seen = 0;
+  socket->rx_ring.head = socket->rx_ring.tail = 0;
+  socket->tx_ring.head = socket->tx_ring.tail = 0;
+
+  socket->fd = compat_socket_invalid;
+  socket->io_state = W5100_IO_STATE_CLOSED;
+  socket->socket_bound = 0;
+  socket->interest = 0;
 }
 
+/* Called only once the I/O thread has stopped */
 void
 nic_w5100_socket_end( nic_w5100_socket_t *socket )
 {
-  nic_w5100_socket_reset( socket );
-  pthread_mutex_destroy( &socket->lock );
+  nic_w5100_socket_io_close( socket );
 }
 
 static void
-w5100_socket_acquire_lock( nic_w5100_socket_t *socket )
+w5100_socket_command_fill( nic_w5100_t *self, nic_w5100_socket_t *socket,
+                           w5100_io_command *command,
+                           w5100_io_command_type type )
 {
-  int error = pthread_mutex_lock( &socket->lock );
-  if( error ) {
-    nic_w5100_error( UI_ERROR_ERROR,
-                     "%s:%d: error %d locking mutex for socket %d\n",
-                     __FILE__, __LINE__, error, socket->id );
-    fuse_abort();
-  }
+  command->type = type;
+  command->socket = socket->id;
+  command->generation = socket->generation;
+  command->mode = socket->mode;
+  memcpy( command->ip, self->sip, sizeof( command->ip ) );
+  memcpy( command->port, socket->port, sizeof( command->port ) );
+  memcpy( command->dip, socket->dip, sizeof( command->dip ) );
+  memcpy( command->dport, socket->dport, sizeof( command->dport ) );
+  command->tx_start = socket->tx_ring.head;
 }
 
 static void
-w5100_socket_release_lock( nic_w5100_socket_t *socket )
+w5100_socket_send_command( nic_w5100_t *self, nic_w5100_socket_t *socket,
+                           w5100_io_command_type type )
 {
-  int error = pthread_mutex_unlock( &socket->lock );
-  if( error ) {
-    nic_w5100_debug( "%s:%d: error %d unlocking mutex for socket %d\n", __FILE__, __LINE__, error, socket->id );
-    fuse_abort();
-  }
+  w5100_io_command command;
+
+  w5100_socket_command_fill( self, socket, &command, type );
+  nic_w5100_send_command( self, &command );
 }
 
+/* Forget about the host socket. Anything the I/O thread says about it from
+   now on will be ignored */
 static void
-w5100_socket_clean( nic_w5100_socket_t *socket )
+w5100_socket_close_host( nic_w5100_t *self, nic_w5100_socket_t *socket )
 {
-  socket->ir = 0;
-  memset( socket->port, 0, sizeof( socket->port ) );
-  memset( socket->dip, 0, sizeof( socket->dip ) );
-  memset( socket->dport, 0, sizeof( socket->dport ) );
-  socket->tx_rr = socket->tx_wr = 0;
-  socket->rx_rsr = 0;
-  socket->old_rx_rd = socket->rx_rd = 0;
-
-  socket->last_send = 0;
-  socket->datagram_count = 0;
-
-  if( socket->fd != compat_socket_invalid ) {
-    compat_socket_close( socket->fd );
-    w5100_socket_init_common( socket );
-  }
+  socket->generation++;
+  socket->synced = 0;
+  socket->bind_requested = 0;
+  w5100_socket_send_command( self, socket, W5100_IO_CLOSE );
 }
 
 void
-nic_w5100_socket_reset( nic_w5100_socket_t *socket )
+nic_w5100_socket_reset( nic_w5100_t *self, nic_w5100_socket_t *socket )
 {
-  w5100_socket_acquire_lock( socket );
-
   socket->mode = W5100_SOCKET_MODE_CLOSED;
   socket->flags = 0;
   socket->state = W5100_SOCKET_STATE_CLOSED;
 
   w5100_socket_clean( socket );
-
-  w5100_socket_release_lock( socket );
+  w5100_socket_close_host( self, socket );
 }
 
 static void
@@ -176,131 +182,59 @@ w5100_write_socket_mr( nic_w5100_socket_t *socket, libspectrum_byte b )
   socket->flags = flags;
 }
 
+/* The socket is opened straight away as far as the Spectrum is concerned;
+   the I/O thread will tell us if it couldn't actually do it */
 static void
-w5100_socket_open( nic_w5100_socket_t *socket_obj )
+w5100_socket_open( nic_w5100_t *self, nic_w5100_socket_t *socket )
 {
-  if( ( socket_obj->mode == W5100_SOCKET_MODE_UDP ||
-      socket_obj->mode == W5100_SOCKET_MODE_TCP ) &&
-    socket_obj->state == W5100_SOCKET_STATE_CLOSED ) {
+  if( ( socket->mode == W5100_SOCKET_MODE_UDP ||
+      socket->mode == W5100_SOCKET_MODE_TCP ) &&
+    socket->state == W5100_SOCKET_STATE_CLOSED ) {
 
-    int tcp = socket_obj->mode == W5100_SOCKET_MODE_TCP;
-    int type = tcp ? SOCK_STREAM : SOCK_DGRAM;
-    int protocol = tcp ? IPPROTO_TCP : IPPROTO_UDP;
-    const char *description = tcp ? "TCP" : "UDP";
-    int final_state = tcp ? W5100_SOCKET_STATE_INIT : W5100_SOCKET_STATE_UDP;
-#ifndef WIN32
-    int one = 1;
-#endif
+    int tcp = socket->mode == W5100_SOCKET_MODE_TCP;
 
-    w5100_socket_clean( socket_obj );
+    w5100_socket_clean( socket );
 
-    socket_obj->fd = socket( AF_INET, type, protocol );
-    if( socket_obj->fd == compat_socket_invalid ) {
-      nic_w5100_error( UI_ERROR_ERROR,
-        "w5100: failed to open %s socket for socket %d; errno %d: %s\n",
-        description, socket_obj->id, compat_socket_get_error(),
-        compat_socket_get_strerror() );
-      return;
-    }
+    socket->generation++;
+    socket->synced = 0;
+    w5100_socket_send_command( self, socket, W5100_IO_OPEN );
 
-#ifndef WIN32
-    /* Windows warning: this could forcibly bind sockets already in use */
-    if( setsockopt( socket_obj->fd, SOL_SOCKET, SO_REUSEADDR, &one,
-      sizeof(one) ) == -1 ) {
-      nic_w5100_error( UI_ERROR_ERROR,
-        "w5100: failed to set SO_REUSEADDR on socket %d; errno %d: %s\n",
-        socket_obj->id, compat_socket_get_error(),
-        compat_socket_get_strerror() );
-    }
-#endif
+    socket->state = tcp ? W5100_SOCKET_STATE_INIT : W5100_SOCKET_STATE_UDP;
 
-    socket_obj->state = final_state;
-
-    nic_w5100_debug( "w5100: opened %s fd %d for socket %d\n", description, socket_obj->fd, socket_obj->id );
+    nic_w5100_debug( "w5100: opening %s socket %d\n", tcp ? "TCP" : "UDP",
+                     socket->id );
   }
 }
 
-static int
+static void
 w5100_socket_bind_port( nic_w5100_t *self, nic_w5100_socket_t *socket )
 {
-  struct sockaddr_in sa;
-
-  memset( &sa, 0, sizeof(sa) );
-  sa.sin_family = AF_INET;
-  memcpy( &sa.sin_port, socket->port, 2 );
-  memcpy( &sa.sin_addr.s_addr, self->sip, 4 );
-
-  nic_w5100_debug( "w5100: attempting to bind socket %d to %s:%d\n", socket->id, inet_ntoa(sa.sin_addr), ntohs(sa.sin_port) );
-  if( bind( socket->fd, (struct sockaddr*)&sa, sizeof(sa) ) == -1 ) {
-    nic_w5100_error( UI_ERROR_ERROR,
-                     "w5100: failed to bind socket %d; errno %d: %s\n",
-                     socket->id, compat_socket_get_error(),
-                     compat_socket_get_strerror() );
-
-    socket->ir |= 1 << 3;
-    socket->state = W5100_SOCKET_STATE_CLOSED;
-    return -1;
+  if( !socket->bind_requested ) {
+    w5100_socket_send_command( self, socket, W5100_IO_BIND );
+    socket->bind_requested = 1;
   }
-
-  socket->socket_bound = 1;
-  nic_w5100_debug( "w5100: successfully bound socket %d\n", socket->id );
-
-  return 0;
 }
 
 static void
 w5100_socket_listen( nic_w5100_t *self, nic_w5100_socket_t *socket )
 {
   if( socket->state == W5100_SOCKET_STATE_INIT ) {
-
-    if( !socket->socket_bound )
-      if( w5100_socket_bind_port( self, socket ) )
-        return;
-
-    if( listen( socket->fd, 1 ) == -1 ) {
-      nic_w5100_error( UI_ERROR_ERROR, 
-                       "w5100: failed to listen on socket %d; errno %d: %s\n",
-                       socket->id, compat_socket_get_error(),
-                       compat_socket_get_strerror() );
-      return;
-    }
-
+    w5100_socket_send_command( self, socket, W5100_IO_LISTEN );
     socket->state = W5100_SOCKET_STATE_LISTEN;
-
     nic_w5100_debug( "w5100: listening on socket %d\n", socket->id );
-
-    compat_socket_selfpipe_wake( self->selfpipe );
   }
 }
 
+/* The emulation carries on while the connection is made: the socket sits
+   in SOCK_SYNSENT until the I/O thread reports back, as on the real
+   hardware */
 static void
 w5100_socket_connect( nic_w5100_t *self, nic_w5100_socket_t *socket )
 {
   if( socket->state == W5100_SOCKET_STATE_INIT ) {
-    struct sockaddr_in sa;
-    
-    if( !socket->socket_bound )
-      if( w5100_socket_bind_port( self, socket ) )
-        return;
-
-    memset( &sa, 0, sizeof(sa) );
-    sa.sin_family = AF_INET;
-    memcpy( &sa.sin_port, socket->dport, 2 );
-    memcpy( &sa.sin_addr.s_addr, socket->dip, 4 );
-
-    if( connect( socket->fd, (struct sockaddr*)&sa, sizeof(sa) ) == -1 ) {
-      nic_w5100_error( UI_ERROR_ERROR,
-        "w5100: failed to connect socket %d to 0x%08x:0x%04x; errno %d: %s\n",
-        socket->id, ntohl(sa.sin_addr.s_addr), ntohs(sa.sin_port),
-        compat_socket_get_error(), compat_socket_get_strerror() );
-
-      socket->ir |= 1 << 3;
-      socket->state = W5100_SOCKET_STATE_CLOSED;
-      return;
-    }
-
-    socket->ir |= 1 << 0;
-    socket->state = W5100_SOCKET_STATE_ESTABLISHED;
+    w5100_socket_send_command( self, socket, W5100_IO_CONNECT );
+    socket->state = W5100_SOCKET_STATE_SYNSENT;
+    nic_w5100_debug( "w5100: connecting socket %d\n", socket->id );
   }
 }
 
@@ -311,7 +245,7 @@ w5100_socket_discon( nic_w5100_t *self, nic_w5100_socket_t *socket )
     socket->state == W5100_SOCKET_STATE_CLOSE_WAIT ) {
     socket->ir |= 1 << 1;
     socket->state = W5100_SOCKET_STATE_CLOSED;
-    compat_socket_selfpipe_wake( self->selfpipe );
+    w5100_socket_close_host( self, socket );
 
     nic_w5100_debug( "w5100: disconnected socket %d\n", socket->id );
   }
@@ -320,36 +254,71 @@ w5100_socket_discon( nic_w5100_t *self, nic_w5100_socket_t *socket )
 static void
 w5100_socket_close( nic_w5100_t *self, nic_w5100_socket_t *socket )
 {
-  if( socket->fd != compat_socket_invalid ) {
-    compat_socket_close( socket->fd );
-    socket->fd = compat_socket_invalid;
-    socket->socket_bound = 0;
-    socket->ok_for_io = 0;
-    socket->state = W5100_SOCKET_STATE_CLOSED;
-    compat_socket_selfpipe_wake( self->selfpipe );
-    nic_w5100_debug( "w5100: closed socket %d\n", socket->id );
-  }
+  socket->state = W5100_SOCKET_STATE_CLOSED;
+  w5100_socket_close_host( self, socket );
+  nic_w5100_debug( "w5100: closed socket %d\n", socket->id );
 }
 
+/* Copy from the W5100's transmit buffer to the ring, which must have room */
 static void
-w5100_socket_send( nic_w5100_t *self, nic_w5100_socket_t *socket )
+w5100_socket_queue_tx( nic_w5100_socket_t *socket, libspectrum_word start,
+                       libspectrum_word length )
 {
-  if( socket->state == W5100_SOCKET_STATE_UDP ) {
+  int offset = start & 0x7ff;
+  int first_chunk = 0x800 - offset;
+
+  if( first_chunk > length ) first_chunk = length;
 
-    if( !socket->socket_bound )
-      if( w5100_socket_bind_port( self, socket ) )
-        return;
+  nic_w5100_ring_write( &socket->tx_ring, &socket->tx_buffer[ offset ],
+                        first_chunk );
+  nic_w5100_ring_write( &socket->tx_ring, socket->tx_buffer,
+                        length - first_chunk );
+}
 
-    socket->datagram_lengths[socket->datagram_count++] =
-      socket->tx_wr - socket->last_send;
-    socket->last_send = socket->tx_wr;
-    socket->write_pending = 1;
-    compat_socket_selfpipe_wake( self->selfpipe );
+static void
+w5100_socket_send( nic_w5100_t *self, nic_w5100_socket_t *socket )
+{
+  libspectrum_word length = socket->tx_wr - socket->tx_queued;
+  size_t space = nic_w5100_ring_free( &socket->tx_ring );
+
+  if( socket->state == W5100_SOCKET_STATE_UDP ) {
+    libspectrum_byte header[8];
+
+    w5100_socket_bind_port( self, socket );
+
+    if( space < sizeof( header ) + length ) {
+      nic_w5100_debug( "w5100: no room to queue datagram on UDP socket %d\n",
+                       socket->id );
+      socket->tx_rr += length;
+    } else {
+      /* The destination goes with the datagram as Sn_DIPR and Sn_DPORT can
+         change before it is sent */
+      memcpy( header, socket->dip, 4 );
+      memcpy( header + 4, socket->dport, 2 );
+      header[6] = ( length >> 8 ) & 0xff;
+      header[7] = length & 0xff;
+
+      nic_w5100_ring_write( &socket->tx_ring, header, sizeof( header ) );
+      w5100_socket_queue_tx( socket, socket->tx_queued, length );
+    }
   }
   else if( socket->state == W5100_SOCKET_STATE_ESTABLISHED ) {
-    socket->write_pending = 1;
-    compat_socket_selfpipe_wake( self->selfpipe );
+    if( space < length ) {
+      nic_w5100_debug( "w5100: no room to queue data on TCP socket %d\n",
+                       socket->id );
+      socket->tx_rr += length;
+    } else {
+      w5100_socket_queue_tx( socket, socket->tx_queued, length );
+    }
   }
+  else
+    return;
+
+  socket->tx_queued = socket->tx_wr;
+  if( socket->tx_rr == socket->tx_queued )
+    socket->ir |= 1 << 4;         /* Nothing left to send */
+
+  compat_socket_selfpipe_wake( self->selfpipe );
 }
 
 static void
@@ -359,9 +328,9 @@ w5100_socket_recv( nic_w5100_t *self, nic_w5100_socket_t *socket )
     socket->state == W5100_SOCKET_STATE_ESTABLISHED ) {
     socket->rx_rsr -= socket->rx_rd - socket->old_rx_rd;
     socket->old_rx_rd = socket->rx_rd;
+    nic_w5100_socket_sync( self, socket );
     if( socket->rx_rsr != 0 )
       socket->ir |= 1 << 2;
-    compat_socket_selfpipe_wake( self->selfpipe );
   }
 }
 
@@ -372,7 +341,7 @@ w5100_write_socket_cr( nic_w5100_t *self, nic_w5100_socket_t *socket, libspectru
 
   switch( b ) {
     case W5100_SOCKET_COMMAND_OPEN:
-      w5100_socket_open( socket );
+      w5100_socket_open( self, socket );
       break;
     case W5100_SOCKET_COMMAND_LISTEN:
       w5100_socket_listen( self, socket );
@@ -404,14 +373,118 @@ w5100_write_socket_port( nic_w5100_t *self, nic_w5100_socket_t *socket, int whic
   nic_w5100_debug( "w5100: writing 0x%02x to S%d_PORT%d\n", b, socket->id, which );
   socket->port[which] = b;
   if( ++socket->bind_count == 2 ) {
-    if( socket->state == W5100_SOCKET_STATE_UDP && !socket->socket_bound ) {
-      if( w5100_socket_bind_port( self, socket ) ) {
-        socket->bind_count = 0;
-        return;
+    if( socket->state == W5100_SOCKET_STATE_UDP )
+      w5100_socket_bind_port( self, socket );
+    socket->bind_count = 0;
+  }
+}
+
+void
+nic_w5100_socket_event( nic_w5100_t *self, nic_w5100_socket_t *socket,
+                        const w5100_io_event *event )
+{
+  /* About a host socket we've since closed */
+  if( event->generation != socket->generation ) return;
+
+  nic_w5100_debug( "w5100: event %d on socket %d\n", event->type, socket->id );
+
+  switch( event->type ) {
+    case W5100_IO_OPEN_FAILED:
+      socket->state = W5100_SOCKET_STATE_CLOSED;
+      /* Fall through */
+    case W5100_IO_OPENED:
+      /* Anything left over from the previous connection is dropped; if
+         there was any, the I/O thread may be waiting for the space */
+      if( socket->rx_ring.tail != event->rx_start ) {
+        W5100_STORE_RELEASE( socket->rx_ring.tail, event->rx_start );
+        compat_socket_selfpipe_wake( self->selfpipe );
       }
-      compat_socket_selfpipe_wake( self->selfpipe );
+      socket->tx_sent_seen = event->tx_sent;
+      socket->synced = 1;
+      break;
+    case W5100_IO_BIND_FAILED:
+    case W5100_IO_CONNECT_FAILED:
+      socket->ir |= 1 << 3;
+      socket->state = W5100_SOCKET_STATE_CLOSED;
+      break;
+    case W5100_IO_LISTEN_FAILED:
+      socket->state = W5100_SOCKET_STATE_INIT;
+      break;
+    case W5100_IO_CONNECTED:
+      socket->ir |= 1 << 0;
+      socket->state = W5100_SOCKET_STATE_ESTABLISHED;
+      break;
+    case W5100_IO_ACCEPTED:
+      socket->state = W5100_SOCKET_STATE_ESTABLISHED;
+      break;
+    case W5100_IO_EOF:
+      if( socket->state == W5100_SOCKET_STATE_ESTABLISHED )
+        socket->state = W5100_SOCKET_STATE_CLOSE_WAIT;
+      break;
+  }
+}
+
+/* Move received data from the ring into the W5100's receive buffer, a whole
+   datagram at a time for UDP, and account for anything that has been sent */
+void
+nic_w5100_socket_sync( nic_w5100_t *self, nic_w5100_socket_t *socket )
+{
+  size_t sent, available, space_before;
+  int udp = socket->state == W5100_SOCKET_STATE_UDP;
+  int pulled = 0;
+
+  if( !socket->synced ) return;
+
+  sent = W5100_LOAD_ACQUIRE( socket->tx_sent );
+  if( sent != socket->tx_sent_seen ) {
+    socket->tx_rr += sent - socket->tx_sent_seen;
+    socket->tx_sent_seen = sent;
+    if( socket->tx_rr == socket->tx_queued )
+      socket->ir |= 1 << 4;
+  }
+
+  if( !udp && socket->state != W5100_SOCKET_STATE_ESTABLISHED &&
+      socket->state != W5100_SOCKET_STATE_CLOSE_WAIT )
+    return;
+
+  available = nic_w5100_ring_used( &socket->rx_ring );
+  space_before = W5100_RING_SIZE - available;
+
+  while( available ) {
+    libspectrum_byte header[8];
+    size_t length = available;
+    int offset, first_chunk;
+
+    if( udp ) {
+      if( available < sizeof( header ) ) break;
+      nic_w5100_ring_peek( &socket->rx_ring, 0, header, sizeof( header ) );
+      length = sizeof( header ) + ( ( header[6] << 8 ) | header[7] );
+      if( length > 0x800 - socket->rx_rsr ) break;
+    } else {
+      if( length > 0x800 - socket->rx_rsr ) length = 0x800 - socket->rx_rsr;
+      if( !length ) break;
     }
-    socket->bind_count = 0;
+
+    offset = ( socket->old_rx_rd + socket->rx_rsr ) & 0x7ff;
+    first_chunk = 0x800 - offset;
+    if( first_chunk > length ) first_chunk = length;
+
+    nic_w5100_ring_peek( &socket->rx_ring, 0, &socket->rx_buffer[ offset ],
+                         first_chunk );
+    nic_w5100_ring_peek( &socket->rx_ring, first_chunk, socket->rx_buffer,
+                         length - first_chunk );
+    nic_w5100_ring_skip( &socket->rx_ring, length );
+
+    socket->rx_rsr += length;
+    available -= length;
+    pulled = 1;
+  }
+
+  if( pulled ) {
+    socket->ir |= 1 << 2;
+    /* The I/O thread stops reading when the ring is short of space */
+    if( space_before < 0x800 )
+      compat_socket_selfpipe_wake( self->selfpipe );
   }
 }
 
@@ -424,8 +497,6 @@ nic_w5100_socket_read( nic_w5100_t *self, libspectrum_word reg )
   libspectrum_word fsr;
   libspectrum_byte b;
 
-  w5100_socket_acquire_lock( socket );
-
   switch( socket_reg ) {
     case W5100_SOCKET_MR:
       b = socket->mode;
@@ -475,8 +546,6 @@ nic_w5100_socket_read( nic_w5100_t *self, libspectrum_word reg )
       break;
   }
 
-  w5100_socket_release_lock( socket );
-
   return b;
 }
 
@@ -486,8 +555,6 @@ nic_w5100_socket_write( nic_w5100_t *self, libspectrum_word reg, libspectrum_byt
   nic_w5100_socket_t *socket = &self->socket[(reg >> 8) - 4];
   int socket_reg = reg & 0xff;
 
-  w5100_socket_acquire_lock( socket );
-
   switch( socket_reg ) {
     case W5100_SOCKET_MR:
       w5100_write_socket_mr( socket, b );
@@ -533,8 +600,6 @@ nic_w5100_socket_write( nic_w5100_t *self, libspectrum_word reg, libspectrum_byt
 
   if( socket_reg != W5100_SOCKET_PORT0 && socket_reg != W5100_SOCKET_PORT1 )
     socket->bind_count = 0;
-
-  w5100_socket_release_lock( socket );
 }
 
 libspectrum_byte
@@ -556,47 +621,234 @@ nic_w5100_socket_write_tx_buffer( nic_w5100_t *self, libspectrum_word reg, libsp
   socket->tx_buffer[offset] = b;
 }
 
+/* Everything from here on runs on the I/O thread */
+
 void
-nic_w5100_socket_add_to_sets( nic_w5100_socket_t *socket, fd_set *readfds,
-  fd_set *writefds, int *max_fd )
+nic_w5100_socket_io_close( nic_w5100_socket_t *socket )
 {
-  w5100_socket_acquire_lock( socket );
-
   if( socket->fd != compat_socket_invalid ) {
-    /* We can process a UDP read if we're in a UDP state and there are at least
-       9 bytes free in our buffer (8 byte UDP header and 1 byte of actual
-       data). */
-    int udp_read = socket->state == W5100_SOCKET_STATE_UDP &&
-      0x800 - socket->rx_rsr >= 9;
-    /* We can process a TCP read if we're in the established state and have
-       any room in our buffer (no header necessary for TCP). */
-    int tcp_read = socket->state == W5100_SOCKET_STATE_ESTABLISHED &&
-      0x800 - socket->rx_rsr >= 1;
-
-    int tcp_listen = socket->state == W5100_SOCKET_STATE_LISTEN;
-
-    socket->ok_for_io = 1;
-
-    if( udp_read || tcp_read || tcp_listen ) {
-      FD_SET( socket->fd, readfds );
-      if( socket->fd > *max_fd )
-        *max_fd = socket->fd;
-      nic_w5100_debug( "w5100: checking for read on socket %d with fd %d; max fd %d\n", socket->id, socket->fd, *max_fd );
-    }
+    /* Closing the descriptor also removes it from any epoll set */
+    compat_socket_close( socket->fd );
+    socket->fd = compat_socket_invalid;
+    nic_w5100_debug( "w5100: closed host socket for socket %d\n",
+                     socket->id );
+  }
 
-    if( socket->write_pending ) {
-      FD_SET( socket->fd, writefds );
-      if( socket->fd > *max_fd )
-        *max_fd = socket->fd;
-      nic_w5100_debug( "w5100: write pending on socket %d with fd %d; max fd %d\n", socket->id, socket->fd, *max_fd );
+  socket->io_state = W5100_IO_STATE_CLOSED;
+  socket->socket_bound = 0;
+  socket->interest = 0;
+}
+
+static void
+w5100_socket_io_open( nic_w5100_t *self, nic_w5100_socket_t *socket_obj,
+                      const w5100_io_command *command )
+{
+  int tcp = command->mode == W5100_SOCKET_MODE_TCP;
+  int type = tcp ? SOCK_STREAM : SOCK_DGRAM;
+  int protocol = tcp ? IPPROTO_TCP : IPPROTO_UDP;
+  const char *description = tcp ? "TCP" : "UDP";
+#ifndef WIN32
+  int one = 1;
+#endif
+
+  nic_w5100_socket_io_close( socket_obj );
+
+  /* Anything queued for the old socket is discarded */
+  W5100_STORE_RELEASE( socket_obj->tx_ring.tail, command->tx_start );
+
+  socket_obj->fd = socket( AF_INET, type, protocol );
+  if( socket_obj->fd == compat_socket_invalid ) {
+    nic_w5100_error( UI_ERROR_ERROR,
+      "w5100: failed to open %s socket for socket %d; errno %d: %s\n",
+      description, socket_obj->id, compat_socket_get_error(),
+      compat_socket_get_strerror() );
+    nic_w5100_post_event( self, socket_obj, W5100_IO_OPEN_FAILED );
+    return;
+  }
+
+#ifndef WIN32
+  /* Windows warning: this could forcibly bind sockets already in use */
+  if( setsockopt( socket_obj->fd, SOL_SOCKET, SO_REUSEADDR, &one,
+    sizeof(one) ) == -1 ) {
+    nic_w5100_error( UI_ERROR_ERROR,
+      "w5100: failed to set SO_REUSEADDR on socket %d; errno %d: %s\n",
+      socket_obj->id, compat_socket_get_error(),
+      compat_socket_get_strerror() );
+  }
+#endif
+
+  if( compat_socket_set_nonblocking( socket_obj->fd ) )
+    nic_w5100_error( UI_ERROR_ERROR,
+      "w5100: failed to make socket %d non-blocking; errno %d: %s\n",
+      socket_obj->id, compat_socket_get_error(),
+      compat_socket_get_strerror() );
+
+  socket_obj->io_state = tcp ? W5100_IO_STATE_OPEN : W5100_IO_STATE_UDP;
+  nic_w5100_post_event( self, socket_obj, W5100_IO_OPENED );
+
+  nic_w5100_debug( "w5100: opened %s fd %d for socket %d\n", description, socket_obj->fd, socket_obj->id );
+}
+
+static int
+w5100_socket_io_bind( nic_w5100_t *self, nic_w5100_socket_t *socket,
+                      const w5100_io_command *command )
+{
+  struct sockaddr_in sa;
+
+  if( socket->socket_bound ) return 0;
+
+  memset( &sa, 0, sizeof(sa) );
+  sa.sin_family = AF_INET;
+  memcpy( &sa.sin_port, command->port, 2 );
+  memcpy( &sa.sin_addr.s_addr, command->ip, 4 );
+
+  nic_w5100_debug( "w5100: attempting to bind socket %d to %s:%d\n", socket->id, inet_ntoa(sa.sin_addr), ntohs(sa.sin_port) );
+  if( bind( socket->fd, (struct sockaddr*)&sa, sizeof(sa) ) == -1 ) {
+    nic_w5100_error( UI_ERROR_ERROR,
+                     "w5100: failed to bind socket %d; errno %d: %s\n",
+                     socket->id, compat_socket_get_error(),
+                     compat_socket_get_strerror() );
+
+    nic_w5100_post_event( self, socket, W5100_IO_BIND_FAILED );
+    nic_w5100_socket_io_close( socket );
+    return -1;
+  }
+
+  socket->socket_bound = 1;
+  nic_w5100_debug( "w5100: successfully bound socket %d\n", socket->id );
+
+  return 0;
+}
+
+static void
+w5100_socket_io_listen( nic_w5100_t *self, nic_w5100_socket_t *socket,
+                        const w5100_io_command *command )
+{
+  if( socket->io_state != W5100_IO_STATE_OPEN ) return;
+
+  if( w5100_socket_io_bind( self, socket, command ) ) return;
+
+  if( listen( socket->fd, 1 ) == -1 ) {
+    nic_w5100_error( UI_ERROR_ERROR,
+                     "w5100: failed to listen on socket %d; errno %d: %s\n",
+                     socket->id, compat_socket_get_error(),
+                     compat_socket_get_strerror() );
+    nic_w5100_post_event( self, socket, W5100_IO_LISTEN_FAILED );
+    return;
+  }
+
+  socket->io_state = W5100_IO_STATE_LISTEN;
+}
+
+static void
+w5100_socket_io_connect_failed( nic_w5100_t *self, nic_w5100_socket_t *socket,
+                                int error )
+{
+  nic_w5100_error( UI_ERROR_ERROR,
+                   "w5100: failed to connect socket %d; error %d\n",
+                   socket->id, error );
+
+  nic_w5100_post_event( self, socket, W5100_IO_CONNECT_FAILED );
+  nic_w5100_socket_io_close( socket );
+}
+
+static void
+w5100_socket_io_connect( nic_w5100_t *self, nic_w5100_socket_t *socket,
+                         const w5100_io_command *command )
+{
+  struct sockaddr_in sa;
+
+  if( socket->io_state != W5100_IO_STATE_OPEN ) return;
+
+  if( w5100_socket_io_bind( self, socket, command ) ) return;
+
+  memset( &sa, 0, sizeof(sa) );
+  sa.sin_family = AF_INET;
+  memcpy( &sa.sin_port, command->dport, 2 );
+  memcpy( &sa.sin_addr.s_addr, command->dip, 4 );
+
+  nic_w5100_debug( "w5100: connecting socket %d to 0x%08x:0x%04x\n",
+                   socket->id, ntohl(sa.sin_addr.s_addr), ntohs(sa.sin_port) );
+
+  if( connect( socket->fd, (struct sockaddr*)&sa, sizeof(sa) ) == -1 ) {
+    if( compat_socket_would_block() ) {
+      /* Wait for the socket to become writable */
+      socket->io_state = W5100_IO_STATE_CONNECTING;
+    } else {
+      w5100_socket_io_connect_failed( self, socket,
+                                      compat_socket_get_error() );
     }
+    return;
   }
 
-  w5100_socket_release_lock( socket );
+  socket->io_state = W5100_IO_STATE_ESTABLISHED;
+  nic_w5100_post_event( self, socket, W5100_IO_CONNECTED );
+}
+
+void
+nic_w5100_socket_command( nic_w5100_t *self, nic_w5100_socket_t *socket,
+                          const w5100_io_command *command )
+{
+  socket->io_generation = command->generation;
+
+  switch( command->type ) {
+    case W5100_IO_OPEN:
+      w5100_socket_io_open( self, socket, command );
+      break;
+    case W5100_IO_BIND:
+      if( socket->io_state == W5100_IO_STATE_UDP )
+        w5100_socket_io_bind( self, socket, command );
+      break;
+    case W5100_IO_LISTEN:
+      w5100_socket_io_listen( self, socket, command );
+      break;
+    case W5100_IO_CONNECT:
+      w5100_socket_io_connect( self, socket, command );
+      break;
+    case W5100_IO_CLOSE:
+      nic_w5100_socket_io_close( socket );
+      break;
+  }
+}
+
+int
+nic_w5100_socket_interest( nic_w5100_socket_t *socket )
+{
+  int interest = 0;
+  int tx_pending = nic_w5100_ring_used( &socket->tx_ring ) != 0;
+
+  switch( socket->io_state ) {
+    case W5100_IO_STATE_LISTEN:
+      interest = W5100_POLL_READ;
+      break;
+    case W5100_IO_STATE_CONNECTING:
+      interest = W5100_POLL_WRITE;
+      break;
+    case W5100_IO_STATE_ESTABLISHED:
+      if( nic_w5100_ring_free( &socket->rx_ring ) )
+        interest |= W5100_POLL_READ;
+      if( tx_pending ) interest |= W5100_POLL_WRITE;
+      break;
+    case W5100_IO_STATE_UDP:
+      /* Only read when a maximum size datagram and its header will fit */
+      if( !socket->socket_bound ) break;
+      if( nic_w5100_ring_free( &socket->rx_ring ) >= 0x800 )
+        interest |= W5100_POLL_READ;
+      if( tx_pending ) interest |= W5100_POLL_WRITE;
+      break;
+    case W5100_IO_STATE_EOF:
+      if( tx_pending ) interest = W5100_POLL_WRITE;
+      break;
+    case W5100_IO_STATE_CLOSED:
+    case W5100_IO_STATE_OPEN:
+      break;
+  }
+
+  return interest;
 }
 
 static void
-w5100_socket_process_accept( nic_w5100_socket_t *socket )
+w5100_socket_process_accept( nic_w5100_t *self, nic_w5100_socket_t *socket )
 {
   struct sockaddr_in sa;
   socklen_t sa_length = sizeof(sa);
@@ -617,21 +869,48 @@ w5100_socket_process_accept( nic_w5100_socket_t *socket )
   if( compat_socket_close( socket->fd ) == -1 )
     nic_w5100_debug( "w5100: error attempting to close fd %d for socket %d\n", socket->fd, socket->id );
 
+  compat_socket_set_nonblocking( new_fd );
+
   socket->fd = new_fd;
-  socket->state = W5100_SOCKET_STATE_ESTABLISHED;
+  socket->interest = 0;
+  socket->io_state = W5100_IO_STATE_ESTABLISHED;
+  nic_w5100_post_event( self, socket, W5100_IO_ACCEPTED );
 }
 
 static void
-w5100_socket_process_read( nic_w5100_socket_t *socket )
+w5100_socket_process_connect( nic_w5100_t *self, nic_w5100_socket_t *socket )
+{
+  int error = 0;
+  socklen_t length = sizeof( error );
+
+  if( getsockopt( socket->fd, SOL_SOCKET, SO_ERROR, (char*)&error,
+                  &length ) == -1 )
+    error = compat_socket_get_error();
+
+  if( error ) {
+    w5100_socket_io_connect_failed( self, socket, error );
+    return;
+  }
+
+  nic_w5100_debug( "w5100: connected socket %d\n", socket->id );
+
+  socket->io_state = W5100_IO_STATE_ESTABLISHED;
+  nic_w5100_post_event( self, socket, W5100_IO_CONNECTED );
+}
+
+static void
+w5100_socket_process_read( nic_w5100_t *self, nic_w5100_socket_t *socket )
 {
   libspectrum_byte buffer[0x800];
-  int bytes_free = 0x800 - socket->rx_rsr;
+  size_t bytes_free = nic_w5100_ring_free( &socket->rx_ring );
   ssize_t bytes_read;
   struct sockaddr_in sa;
 
-  int udp = socket->state == W5100_SOCKET_STATE_UDP;
+  int udp = socket->io_state == W5100_IO_STATE_UDP;
   const char *description = udp ? "UDP" : "TCP";
 
+  if( bytes_free > sizeof( buffer ) ) bytes_free = sizeof( buffer );
+
   nic_w5100_debug( "w5100: reading from socket %d\n", socket->id );
 
   if( udp ) {
@@ -645,9 +924,6 @@ w5100_socket_process_read( nic_w5100_socket_t *socket )
   nic_w5100_debug( "w5100: read 0x%03x bytes from %s socket %d\n", (int)bytes_read, description, socket->id );
 
   if( bytes_read > 0 || (udp && bytes_read == 0) ) {
-    int offset = (socket->old_rx_rd + socket->rx_rsr) & 0x7ff;
-    libspectrum_byte *dest = &socket->rx_buffer[offset];
-
     if( udp ) {
       /* Add the W5100's UDP header */
       memcpy( buffer, &sa.sin_addr.s_addr, 4 );
@@ -657,20 +933,15 @@ w5100_socket_process_read( nic_w5100_socket_t *socket )
       bytes_read += 8;
     }
 
-    socket->rx_rsr += bytes_read;
-    socket->ir |= 1 << 2;
-
-    if( offset + bytes_read <= 0x800 ) {
-      memcpy( dest, buffer, bytes_read );
-    }
-    else {
-      int first_chunk = 0x800 - offset;
-      memcpy( dest, buffer, first_chunk );
-      memcpy( socket->rx_buffer, buffer + first_chunk, bytes_read - first_chunk );
-    }
+    nic_w5100_ring_write( &socket->rx_ring, buffer, bytes_read );
+  }
+  else if( bytes_read == -1 && compat_socket_would_block() ) {
+    /* Spurious wakeup */
   }
-  else if( bytes_read == 0 ) {  /* TCP */
-    socket->state = W5100_SOCKET_STATE_CLOSE_WAIT;
+  else if( !udp ) {
+    /* Treat errors as EOF too, or we'd just be woken again and again */
+    socket->io_state = W5100_IO_STATE_EOF;
+    nic_w5100_post_event( self, socket, W5100_IO_EOF );
     nic_w5100_debug( "w5100: EOF on %s socket %d; errno %d: %s\n",
                      description, socket->id, compat_socket_get_error(),
                      compat_socket_get_strerror() );
@@ -682,111 +953,119 @@ w5100_socket_process_read( nic_w5100_socket_t *socket )
   }
 }
 
+static void
+w5100_socket_sent( nic_w5100_socket_t *socket, size_t length )
+{
+  W5100_STORE_RELEASE( socket->tx_sent, socket->tx_sent + length );
+}
+
 static void
 w5100_socket_process_udp_write( nic_w5100_socket_t *socket )
 {
+  libspectrum_byte header[8];
+  libspectrum_byte buffer[0x800];
+  size_t length;
   ssize_t bytes_sent;
-  int offset = socket->tx_rr & 0x7ff;
-  libspectrum_word length = socket->datagram_lengths[0];
-  libspectrum_byte *data = &socket->tx_buffer[ offset ];
   struct sockaddr_in sa;
-  libspectrum_byte buffer[0x800];
 
   nic_w5100_debug( "w5100: writing to UDP socket %d\n", socket->id );
 
-  /* If the data wraps round the write buffer, we need to coalesce it into
-     one chunk for the call to sendto() */
-  if( offset + length > 0x800 ) {
-    int first_chunk = 0x800 - offset;
-    memcpy( buffer, data, first_chunk );
-    memcpy( buffer + first_chunk, socket->tx_buffer, length - first_chunk );
-    data = buffer;
-  }
+  while( nic_w5100_ring_used( &socket->tx_ring ) >= sizeof( header ) ) {
 
-  memset( &sa, 0, sizeof(sa) );
-  sa.sin_family = AF_INET;
-  memcpy( &sa.sin_port, socket->dport, 2 );
-  memcpy( &sa.sin_addr.s_addr, socket->dip, 4 );
+    nic_w5100_ring_peek( &socket->tx_ring, 0, header, sizeof( header ) );
+    length = ( header[6] << 8 ) | header[7];
 
-  bytes_sent = sendto( socket->fd, (const char*)data, length, 0, (struct sockaddr*)&sa, sizeof(sa) );
-  nic_w5100_debug( "w5100: sent 0x%03x bytes of 0x%03x to UDP socket %d\n",
-                   (int)bytes_sent, length, socket->id );
+    /* The emulation thread may not have finished writing the datagram */
+    if( nic_w5100_ring_used( &socket->tx_ring ) < sizeof( header ) + length )
+      break;
 
-  if( bytes_sent == length ) {
-    if( --socket->datagram_count )
-      memmove( socket->datagram_lengths, &socket->datagram_lengths[1],
-        0x1f * sizeof(int) );
+    nic_w5100_ring_peek( &socket->tx_ring, sizeof( header ), buffer, length );
 
-    socket->tx_rr += bytes_sent;
-    if( socket->datagram_count == 0 ) {
-      socket->write_pending = 0;
-      socket->ir |= 1 << 4;
+    memset( &sa, 0, sizeof(sa) );
+    sa.sin_family = AF_INET;
+    memcpy( &sa.sin_addr.s_addr, header, 4 );
+    memcpy( &sa.sin_port, header + 4, 2 );
+
+    bytes_sent = sendto( socket->fd, (const char*)buffer, length, 0,
+                         (struct sockaddr*)&sa, sizeof(sa) );
+    nic_w5100_debug( "w5100: sent 0x%03x bytes of 0x%03x to UDP socket %d\n",
+                     (int)bytes_sent, (int)length, socket->id );
+
+    if( bytes_sent == -1 ) {
+      if( compat_socket_would_block() ) break;
+      /* As far as the Spectrum is concerned, it's gone */
+      nic_w5100_debug( "w5100: error %d writing to UDP socket %d: %s\n",
+                       compat_socket_get_error(), socket->id,
+                       compat_socket_get_strerror() );
     }
+    else if( bytes_sent != length )
+      nic_w5100_debug( "w5100: didn't manage to send full datagram to UDP socket %d?\n", socket->id );
+
+    nic_w5100_ring_skip( &socket->tx_ring, sizeof( header ) + length );
+    w5100_socket_sent( socket, length );
   }
-  else if( bytes_sent != -1 )
-    nic_w5100_debug( "w5100: didn't manage to send full datagram to UDP socket %d?\n", socket->id );
-  else
-    nic_w5100_debug( "w5100: error %d writing to UDP socket %d: %s\n",
-                     compat_socket_get_error(), socket->id,
-                     compat_socket_get_strerror() );
 }
 
 static void
 w5100_socket_process_tcp_write( nic_w5100_socket_t *socket )
 {
+  libspectrum_byte buffer[0x800];
+  size_t length = nic_w5100_ring_used( &socket->tx_ring );
   ssize_t bytes_sent;
-  int offset = socket->tx_rr & 0x7ff;
-  libspectrum_word length = socket->tx_wr - socket->tx_rr;
-  libspectrum_byte *data = &socket->tx_buffer[ offset ];
 
   nic_w5100_debug( "w5100: writing to TCP socket %d\n", socket->id );
 
-  /* If the data wraps round the write buffer, write it in two chunks */
-  if( offset + length > 0x800 )
-    length = 0x800 - offset;
+  if( length > sizeof( buffer ) ) length = sizeof( buffer );
+  nic_w5100_ring_peek( &socket->tx_ring, 0, buffer, length );
 
-  bytes_sent = send( socket->fd, (const char*)data, length, 0 );
+  bytes_sent = send( socket->fd, (const char*)buffer, length, 0 );
   nic_w5100_debug( "w5100: sent 0x%03x bytes of 0x%03x to TCP socket %d\n",
-                   (int)bytes_sent, length, socket->id );
+                   (int)bytes_sent, (int)length, socket->id );
 
-  if( bytes_sent != -1 ) {
-    socket->tx_rr += bytes_sent;
-    if( socket->tx_rr == socket->tx_wr ) {
-      socket->write_pending = 0;
-      socket->ir |= 1 << 4;
-    }
-  }
-  else
+  if( bytes_sent == -1 ) {
+    if( compat_socket_would_block() ) return;
     nic_w5100_debug( "w5100: error %d writing to TCP socket %d: %s\n",
                      compat_socket_get_error(), socket->id,
                      compat_socket_get_strerror() );
+    /* Nothing more will go, so don't leave the Spectrum waiting */
+    bytes_sent = nic_w5100_ring_used( &socket->tx_ring );
+  }
+
+  nic_w5100_ring_skip( &socket->tx_ring, bytes_sent );
+  w5100_socket_sent( socket, bytes_sent );
 }
 
 void
-nic_w5100_socket_process_io( nic_w5100_socket_t *socket, fd_set readfds,
-  fd_set writefds )
-{
-  w5100_socket_acquire_lock( socket );
-
-  /* Process only if we're an open socket, and we haven't been closed and
-     re-opened since the select() started */
-  if( socket->fd != compat_socket_invalid && socket->ok_for_io ) {
-    if( FD_ISSET( socket->fd, &readfds ) ) {
-      if( socket->state == W5100_SOCKET_STATE_LISTEN )
-        w5100_socket_process_accept( socket );
-      else
-        w5100_socket_process_read( socket );
-    }
+nic_w5100_socket_process_io( nic_w5100_t *self, nic_w5100_socket_t *socket,
+                             int ready )
+{
+  /* epoll reports hangups and errors whether we asked for them or not */
+  ready &= socket->interest;
 
-    if( FD_ISSET( socket->fd, &writefds ) ) {
-      if( socket->state == W5100_SOCKET_STATE_UDP ) {
+  switch( socket->io_state ) {
+    case W5100_IO_STATE_LISTEN:
+      if( ready & W5100_POLL_READ )
+        w5100_socket_process_accept( self, socket );
+      break;
+    case W5100_IO_STATE_CONNECTING:
+      if( ready & W5100_POLL_WRITE )
+        w5100_socket_process_connect( self, socket );
+      break;
+    case W5100_IO_STATE_UDP:
+      if( ready & W5100_POLL_READ )
+        w5100_socket_process_read( self, socket );
+      if( ready & W5100_POLL_WRITE )
         w5100_socket_process_udp_write( socket );
-      }
-      else if( socket->state == W5100_SOCKET_STATE_ESTABLISHED ) {
+      break;
+    case W5100_IO_STATE_ESTABLISHED:
+    case W5100_IO_STATE_EOF:
+      if( ready & W5100_POLL_READ )
+        w5100_socket_process_read( self, socket );
+      if( ready & W5100_POLL_WRITE )
         w5100_socket_process_tcp_write( socket );
-      }
-    }
+      break;
+    case W5100_IO_STATE_CLOSED:
+    case W5100_IO_STATE_OPEN:
+      break;
   }
-
-  w5100_socket_release_lock( socket );
 }
@@ -30,6 +30,7 @@
 
 #include "compat.h"
 #include "debugger.h"
+#include "event.h"
 #include "am29f010.h"
 #include "startup_manager.h"
 #include "machine.h"
@@ -41,6 +42,7 @@
 #include "settings.h"
 #include "spectranet.h"
 #include "ui.h"
+#include "z80.h"
 
 #ifdef BUILD_SPECTRANET
 
@@ -92,6 +94,8 @@ static int spectranet_source;
 static const char * const event_type_string = "spectranet";
 static int page_event, unpage_event;
 
+static void spectranet_programmable_trap_changed( void );
+
 void
 spectranet_page( int via_io )
 {
@@ -163,6 +167,7 @@ spectranet_hard_reset( void )
   spectranet_programmable_trap = 0x0000;
   spectranet_programmable_trap_active = 0;
   trap_write_msb = 0;
+  spectranet_programmable_trap_changed();
 
   nmi_flipflop = 0;
 }  
@@ -283,6 +288,7 @@ spectranet_from_snapshot( libspectrum_snap *snap )
       libspectrum_snap_spectranet_programmable_trap_active( snap );
     trap_write_msb =
       libspectrum_snap_spectranet_programmable_trap_msb( snap );
+    spectranet_programmable_trap_changed();
 
     settings_current.spectranet_disable =
       libspectrum_snap_spectranet_all_traps_disabled( snap );
@@ -398,6 +404,8 @@ spectranet_trap( libspectrum_word port, libspectrum_byte data )
       (spectranet_programmable_trap & 0xff00) | data;
 
   trap_write_msb = !trap_write_msb;
+
+  spectranet_programmable_trap_changed();
 }
 
 static libspectrum_byte
@@ -425,6 +433,9 @@ spectranet_control_write( libspectrum_word port, libspectrum_byte data )
     spectranet_unpage();
 
   spectranet_programmable_trap_active = data & 0x08;
+
+  /* This can happen part way through z80_do_opcodes() */
+  periph_update_traps();
 }
 
 static const periph_port_t spectranet_ports[] = {
@@ -442,12 +453,60 @@ static const periph_t spectranet_periph = {
   /* .activate = */ spectranet_activate,
 };
 
+static void
+spectranet_trap_page( libspectrum_word pc GCC_UNUSED )
+{
+  if( !settings_current.spectranet_disable ) spectranet_page( 0 );
+}
+
+static void
+spectranet_trap_unpage( libspectrum_word pc GCC_UNUSED )
+{
+  spectranet_unpage();
+}
+
+static void
+spectranet_trap_nmi( libspectrum_word pc GCC_UNUSED )
+{
+  if( spectranet_available && !settings_current.spectranet_disable )
+    event_add( 0, z80_nmi_event );
+}
+
+static const periph_trap_t spectranet_traps[] = {
+  { PERIPH_TRAP_BEFORE_FETCH, 0x0008, 0x0008, PERIPH_TRAP_ALWAYS,
+    spectranet_trap_page },
+  { PERIPH_TRAP_BEFORE_FETCH, 0x3ff8, 0x3fff, PERIPH_TRAP_ALWAYS,
+    spectranet_trap_page },
+  { PERIPH_TRAP_AFTER_FETCH, 0x007c, 0x007c, PERIPH_TRAP_ALWAYS,
+    spectranet_trap_unpage },
+  { 0, 0, 0, 0, NULL }
+};
+
+/* The programmable trap can be moved by the Spectranet itself, so has a list
+   of its own which is updated by spectranet_programmable_trap_changed() */
+static periph_trap_t spectranet_programmable_traps[] = {
+  { PERIPH_TRAP_BEFORE_FETCH, 0x0000, 0x0000, PERIPH_TRAP_ALWAYS,
+    spectranet_trap_nmi },
+  { 0, 0, 0, 0, NULL }
+};
+
+static void
+spectranet_programmable_trap_changed( void )
+{
+  spectranet_programmable_traps[0].first = spectranet_programmable_trap;
+  spectranet_programmable_traps[0].last = spectranet_programmable_trap;
+  periph_traps_changed();
+}
+
 static int
 spectranet_init( void *context )
 {
   module_register( &spectranet_module_info );
   spectranet_source = memory_source_register( "Spectranet" );
   periph_register( PERIPH_TYPE_SPECTRANET, &spectranet_periph );
+  periph_register_traps( spectranet_traps, &spectranet_available, NULL );
+  periph_register_traps( spectranet_programmable_traps,
+                         &spectranet_programmable_trap_active, NULL );
   periph_register_paging_events( event_type_string, &page_event,
 				 &unpage_event );
 
@@ -27,6 +27,8 @@
 
 #include "config.h"
 
+#include <stdio.h>
+
 #include "libspectrum.h"
 
 #include "compat.h"
@@ -49,6 +51,7 @@ static libspectrum_byte last_byte;
 
 libspectrum_byte ula_contention[ ULA_CONTENTION_SIZE ];
 libspectrum_byte ula_contention_no_mreq[ ULA_CONTENTION_SIZE ];
+libspectrum_dword ula_contention_start, ula_contention_end;
 
 /* What to return if no other input pressed; depends on the last byte
    output to the ULA; see CSS FAQ | Technical Information | Port #FE
@@ -57,6 +60,8 @@ libspectrum_byte ula_default_value;
 
 static void ula_from_snapshot( libspectrum_snap *snap );
 static void ula_to_snapshot( libspectrum_snap *snap );
+static void ula_to_state( module_state *state );
+static void ula_from_state( module_state *state );
 static libspectrum_byte ula_read( libspectrum_word port, libspectrum_byte *attached );
 static void ula_write( libspectrum_word port, libspectrum_byte b );
 
@@ -67,6 +72,8 @@ static module_info_t ula_module_info = {
   /* .snapshot_enabled = */ NULL,
   /* .snapshot_from = */ ula_from_snapshot,
   /* .snapshot_to = */ ula_to_snapshot,
+  /* .state_to = */ ula_to_state,
+  /* .state_from = */ ula_from_state,
 
 };
 
@@ -193,16 +200,10 @@ ula_read( libspectrum_word port, libspectrum_byte *attached )
   return r;
 }
 
-/* What happens when we write to the ULA? */
+/* What to read back from the port after writing b to it */
 static void
-ula_write( libspectrum_word port GCC_UNUSED, libspectrum_byte b )
+set_default_value( libspectrum_byte b )
 {
-  last_byte = b;
-
-  display_set_lores_border( b & 0x07 );
-  sound_beeper( tstates,
-                (!!(b & 0x10) << 1) + ( (!(b & 0x8)) | tape_microphone ) );
-
   /* FIXME: shouldn't really be using the memory capabilities here */
 
   if( machine_current->timex ) {
@@ -224,7 +225,21 @@ ula_write( libspectrum_word port GCC_UNUSED, libspectrum_byte b )
     ula_default_value = b & 0x18 ? 0xff : 0xbf;
 
   }
+}
+
+/* What happens when we write to the ULA? */
+static void
+ula_write( libspectrum_word port GCC_UNUSED, libspectrum_byte b )
+{
+  last_byte = b;
 
+  display_set_lores_border( b & 0x07 );
+  sound_beeper( tstates,
+                (!!(b & 0x10) << 1) + ( (!(b & 0x8)) | tape_microphone ) );
+
+  if( tape_recording ) tape_record_level( ula_tape_level() );
+
+  set_default_value( b );
 }
 
 libspectrum_byte
@@ -255,6 +270,86 @@ ula_to_snapshot( libspectrum_snap *snap )
   libspectrum_snap_set_issue2( snap, settings_current.issue2 );
 }  
 
+static void
+ula_to_state( module_state *state )
+{
+  module_state_write( state, &last_byte, sizeof( last_byte ) );
+  module_state_write( state, &tstates, sizeof( tstates ) );
+}
+
+static void
+ula_from_state( module_state *state )
+{
+  libspectrum_byte b;
+
+  module_state_read( state, &b, sizeof( b ) );
+  module_state_read( state, &tstates, sizeof( tstates ) );
+
+  /* Not a port write: tstates may just have gone backwards, so the beeper
+     and the tape recorder must not see an edge here. The MIC/EAR level is
+     just read back from last_byte */
+  last_byte = b;
+  display_restore_lores_border( b & 0x07 );
+  set_default_value( b );
+}
+
+/* Restoring saved state must put back the port's value, the border and
+   what reads of the port return, without going through a port write */
+int
+ula_unittest( void )
+{
+  module_state state = { NULL, 0, 0, 0 };
+  libspectrum_byte saved_last_byte = last_byte;
+  libspectrum_byte saved_border = display_lores_border;
+  libspectrum_byte saved_default_value = ula_default_value;
+  libspectrum_byte default_value;
+  libspectrum_dword saved_tstates = tstates;
+  int r = 0;
+
+  /* Border 2, MIC and EAR both set */
+  set_default_value( 0x1a );
+  default_value = ula_default_value;
+  last_byte = 0x1a;
+  tstates = 1000;
+  ula_to_state( &state );
+
+  /* Later in the frame and a different value, as after a quick-save */
+  last_byte = 0x05;
+  display_restore_lores_border( 5 );
+  set_default_value( 0x05 );
+  tstates = 50000;
+
+  state.position = 0;
+  ula_from_state( &state );
+
+  if( last_byte != 0x1a || ula_tape_level() != 0x08 ) {
+    printf( "%s: restored last byte 0x%02x\n", __func__, last_byte );
+    r = 1;
+  }
+  if( tstates != 1000 ) {
+    printf( "%s: restored tstates %lu\n", __func__, (unsigned long)tstates );
+    r = 1;
+  }
+  if( display_lores_border != 2 ) {
+    printf( "%s: restored border %d\n", __func__, display_lores_border );
+    r = 1;
+  }
+  if( ula_default_value != default_value ) {
+    printf( "%s: restored default value 0x%02x, expected 0x%02x\n",
+            __func__, ula_default_value, default_value );
+    r = 1;
+  }
+
+  module_state_free( &state );
+
+  tstates = saved_tstates;
+  last_byte = saved_last_byte;
+  display_restore_lores_border( saved_border );
+  ula_default_value = saved_default_value;
+
+  return r;
+}
+
 void
 ula_contend_port_early( libspectrum_word port )
 {
@@ -34,12 +34,18 @@ extern libspectrum_byte ula_contention[ ULA_CONTENTION_SIZE ];
 /* And how much when it is inactive */
 extern libspectrum_byte ula_contention_no_mreq[ ULA_CONTENTION_SIZE ];
 
+/* The first tstate with any contention, and the one after the last; both are
+   zero if the machine has no contention at all */
+extern libspectrum_dword ula_contention_start, ula_contention_end;
+
 void ula_register_startup( void );
 
 libspectrum_byte ula_last_byte( void );
 
 libspectrum_byte ula_tape_level( void );
 
+int ula_unittest( void );
+
 void ula_contend_port_early( libspectrum_word port );
 void ula_contend_port_late( libspectrum_word port );
 
@@ -83,6 +83,18 @@ static const periph_t usource_periph = {
   /* .activate = */ NULL,
 };
 
+static void
+usource_trap_toggle( libspectrum_word pc GCC_UNUSED )
+{
+  usource_toggle();
+}
+
+static const periph_trap_t usource_traps[] = {
+  { PERIPH_TRAP_BEFORE_FETCH, 0x2bae, 0x2bae, PERIPH_TRAP_ALWAYS,
+    usource_trap_toggle },
+  { 0, 0, 0, 0, NULL }
+};
+
 static int
 usource_init( void *context )
 {
@@ -95,6 +107,7 @@ usource_init( void *context )
     usource_memory_map_romcs[i].source = usource_memory_source;
 
   periph_register( PERIPH_TYPE_USOURCE, &usource_periph );
+  periph_register_traps( usource_traps, &usource_available, NULL );
 
   return 0;
 }
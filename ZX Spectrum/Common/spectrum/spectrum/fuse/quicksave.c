@@ -0,0 +1,310 @@
+/* quicksave.c: In-memory quick-save slots
+   Copyright (c) 2026 The Fuse authors
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+   Author contact information:
+
+   E-mail: philip-fuse@shadowmagic.org.uk
+
+*/
+
+#include "config.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif				/* #ifdef HAVE_PTHREAD */
+
+#include "libspectrum.h"
+
+#include "display.h"
+#include "event.h"
+#include "fuse.h"
+#include "machine.h"
+#include "module.h"
+#include "quicksave.h"
+#include "rzx.h"
+#include "settings.h"
+#include "snapshot.h"
+#include "spectrum.h"
+#include "startup_manager.h"
+#include "tape.h"
+#include "timer.h"
+#include "ui.h"
+
+/* Slots hold the raw module state rather than a libspectrum_snap, so saving
+   and loading are little more than a memcpy of the RAM. Modules which don't
+   provide state functions are saved into a snap held alongside */
+typedef struct quicksave_slot {
+
+  int used;
+
+  libspectrum_machine machine;
+  int late_timings;
+
+  module_state state;
+  libspectrum_snap *snap;
+
+#ifdef HAVE_PTHREAD
+  /* Background write of the slot to disk */
+  int persisting;
+  pthread_t thread;
+  libspectrum_snap *persist_snap;
+  char *persist_filename;
+  int persist_flags;
+  int persist_error;
+  ui_error_buffer persist_errors;
+#endif				/* #ifdef HAVE_PTHREAD */
+
+} quicksave_slot;
+
+static quicksave_slot slots[ QUICKSAVE_SLOTS ];
+
+int quicksave_current_slot = 0;
+
+#ifdef HAVE_PTHREAD
+
+static void*
+persist_thread( void *arg )
+{
+  quicksave_slot *slot = arg;
+  libspectrum_byte *buffer = NULL;
+  size_t length = 0;
+  int flags = 0;
+  FILE *f;
+
+  /* Nothing in here may call ui_error(); errors are reported from the main
+     thread when the write is collected */
+  ui_error_buffer_start( &slot->persist_errors );
+
+  slot->persist_error = libspectrum_snap_write(
+    &buffer, &length, &flags, slot->persist_snap, LIBSPECTRUM_ID_SNAPSHOT_SZX,
+    fuse_creator, slot->persist_flags
+  );
+
+  libspectrum_snap_free( slot->persist_snap );
+  slot->persist_snap = NULL;
+
+  if( !slot->persist_error ) {
+    f = fopen( slot->persist_filename, "wb" );
+    if( !f || fwrite( buffer, 1, length, f ) != length )
+      slot->persist_error = 1;
+    if( f && fclose( f ) ) slot->persist_error = 1;
+  }
+
+  libspectrum_free( buffer );
+
+  ui_error_buffer_stop();
+
+  return NULL;
+}
+
+/* Wait for any background write of a slot to finish */
+static void
+persist_collect( quicksave_slot *slot )
+{
+  if( !slot->persisting ) return;
+
+  pthread_join( slot->thread, NULL );
+  slot->persisting = 0;
+
+  if( slot->persist_errors.used )
+    ui_error( UI_ERROR_ERROR, "couldn't write quick-save to '%s': %s",
+              slot->persist_filename, slot->persist_errors.message );
+  else if( slot->persist_error )
+    ui_error( UI_ERROR_ERROR, "couldn't write quick-save to '%s'",
+              slot->persist_filename );
+
+  libspectrum_free( slot->persist_filename );
+  slot->persist_filename = NULL;
+}
+
+static void
+persist_start( quicksave_slot *slot, int n )
+{
+  const char *prefix = settings_current.quicksave_file;
+  size_t length = strlen( prefix ) + 16;
+
+  slot->persist_snap = libspectrum_snap_alloc();
+  snapshot_copy_to( slot->persist_snap );
+
+  slot->persist_filename = libspectrum_new( char, length );
+  snprintf( slot->persist_filename, length, "%s-%d.szx", prefix, n + 1 );
+
+  slot->persist_flags = settings_current.snapshot_compression ?
+                        0 : LIBSPECTRUM_FLAG_SNAPSHOT_NO_COMPRESSION;
+  slot->persist_error = 0;
+  if( pthread_create( &slot->thread, NULL, persist_thread, slot ) ) {
+    ui_error( UI_ERROR_ERROR, "couldn't start quick-save write thread" );
+    libspectrum_snap_free( slot->persist_snap );
+    slot->persist_snap = NULL;
+    libspectrum_free( slot->persist_filename );
+    slot->persist_filename = NULL;
+    return;
+  }
+
+  slot->persisting = 1;
+}
+
+#else				/* #ifdef HAVE_PTHREAD */
+
+static void
+persist_collect( quicksave_slot *slot GCC_UNUSED )
+{
+}
+
+/* Without threads, just write the file synchronously */
+static void
+persist_start( quicksave_slot *slot GCC_UNUSED, int n )
+{
+  const char *prefix = settings_current.quicksave_file;
+  size_t length = strlen( prefix ) + 16;
+  char *filename = libspectrum_new( char, length );
+
+  snprintf( filename, length, "%s-%d.szx", prefix, n + 1 );
+  snapshot_write( filename );
+  libspectrum_free( filename );
+}
+
+#endif				/* #ifdef HAVE_PTHREAD */
+
+static int
+quicksave_init( void *context )
+{
+  memset( slots, 0, sizeof( slots ) );
+  quicksave_current_slot = 0;
+
+  return 0;
+}
+
+static void
+quicksave_end( void )
+{
+  size_t i;
+
+  for( i = 0; i < QUICKSAVE_SLOTS; i++ ) {
+    persist_collect( &slots[i] );
+    module_state_free( &slots[i].state );
+    if( slots[i].snap ) libspectrum_snap_free( slots[i].snap );
+    slots[i].snap = NULL;
+    slots[i].used = 0;
+  }
+}
+
+void
+quicksave_register_startup( void )
+{
+  startup_manager_module dependencies[] = {
+    STARTUP_MANAGER_MODULE_LIBSPECTRUM,
+    STARTUP_MANAGER_MODULE_SETUID,
+  };
+  startup_manager_register( STARTUP_MANAGER_MODULE_QUICKSAVE, dependencies,
+                            ARRAY_SIZE( dependencies ), quicksave_init, NULL,
+                            quicksave_end );
+}
+
+int
+quicksave_save( int n )
+{
+  quicksave_slot *slot;
+
+  if( n < 0 || n >= QUICKSAVE_SLOTS ) return 1;
+  slot = &slots[n];
+
+  persist_collect( slot );
+
+  if( slot->snap ) libspectrum_snap_free( slot->snap );
+  slot->snap = libspectrum_snap_alloc();
+  libspectrum_snap_set_machine( slot->snap, machine_current->machine );
+  libspectrum_snap_set_late_timings( slot->snap,
+                                     settings_current.late_timings );
+
+  module_state_to( &slot->state, slot->snap );
+  event_state_to( &slot->state );
+
+  slot->machine = machine_current->machine;
+  slot->late_timings = settings_current.late_timings;
+  slot->used = 1;
+
+  if( settings_current.quicksave_file ) persist_start( slot, n );
+
+  return 0;
+}
+
+int
+quicksave_load( int n )
+{
+  quicksave_slot *slot;
+  int error;
+
+  if( n < 0 || n >= QUICKSAVE_SLOTS ) return 1;
+  slot = &slots[n];
+
+  if( !slot->used ) {
+    ui_error( UI_ERROR_ERROR, "quick-save slot %d is empty", n + 1 );
+    return 1;
+  }
+
+  if( rzx_playback || rzx_recording ) {
+    ui_error( UI_ERROR_ERROR, "can't quick-load while using an RZX file" );
+    return 1;
+  }
+
+  /* The pulse in progress has to be finished on the timeline it belongs to;
+     time on the restored one may well be earlier */
+  if( tape_recording ) tape_record_stop();
+
+  /* Only pay for a machine change if we really need one */
+  if( slot->machine != machine_current->machine ||
+      slot->late_timings != settings_current.late_timings ) {
+    settings_current.late_timings = slot->late_timings;
+    error = machine_select( slot->machine ); if( error ) return error;
+  }
+
+  module_state_from( &slot->state, slot->snap );
+
+  /* Without a machine reset, the events pending are still those of the
+     timeline being left, so put back the ones which were pending when the
+     slot was saved */
+  event_state_from( &slot->state );
+
+  /* Apart from the host timer, which mustn't try to catch up on the
+     difference */
+  event_remove_type( timer_event );
+  timer_estimate_reset();
+  event_add( tstates, timer_event );
+
+  error = machine_current->memory_map(); if( error ) return error;
+
+  display_refresh_all();
+
+  return 0;
+}
+
+int
+quicksave_slot_used( int n )
+{
+  return n >= 0 && n < QUICKSAVE_SLOTS && slots[n].used;
+}
+
+void
+quicksave_select_slot( int delta )
+{
+  quicksave_current_slot =
+    ( quicksave_current_slot + QUICKSAVE_SLOTS + delta ) % QUICKSAVE_SLOTS;
+}
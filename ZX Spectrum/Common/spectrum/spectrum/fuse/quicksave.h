@@ -0,0 +1,47 @@
+/* quicksave.h: In-memory quick-save slots
+   Copyright (c) 2026 The Fuse authors
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+   Author contact information:
+
+   E-mail: philip-fuse@shadowmagic.org.uk
+
+*/
+
+#ifndef FUSE_QUICKSAVE_H
+#define FUSE_QUICKSAVE_H
+
+#define QUICKSAVE_SLOTS 10
+
+/* The slot used by the menu and keyboard shortcuts */
+extern int quicksave_current_slot;
+
+void quicksave_register_startup( void );
+
+/* Save the machine state into a slot. If the quicksave_file setting is set,
+   the slot is also written in the background to <quicksave_file>-<n>.szx */
+int quicksave_save( int slot );
+
+/* Restore the machine state from a slot */
+int quicksave_load( int slot );
+
+/* Is there anything in a slot? */
+int quicksave_slot_used( int slot );
+
+/* Move the current slot forwards or backwards */
+void quicksave_select_slot( int delta );
+
+#endif			/* #ifndef FUSE_QUICKSAVE_H */
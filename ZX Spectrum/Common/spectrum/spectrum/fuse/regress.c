@@ -0,0 +1,512 @@
+/* regress.c: Play recordings and snapshots against golden results
+   Copyright (c) 2026 The Fuse authors
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+   Author contact information:
+
+   E-mail: philip-fuse@shadowmagic.org.uk
+
+*/
+
+/* The manifest lists one file per line, optionally followed by the number
+   of frames to run it for; blank lines and lines starting with '#' are
+   ignored, and relative paths are taken from the manifest's directory.
+   Recordings run to their end unless given a number of frames, snapshots
+   for DEFAULT_SNAPSHOT_FRAMES.
+
+   Each entry is run in a worker process of its own, forked from the
+   machine as it stands after startup, so nothing one entry does can leak
+   into the next. The worker runs headless and flat out, hashing the
+   emulated screen (border included) at the end of every frame and the
+   registers and RAM at the end of the run, and compares those against the
+   golden results in <file>.golden: one line per frame giving its number
+   and hash, then a "state" line */
+
+#include "config.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef HAVE_FORK
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif				/* #ifdef HAVE_FORK */
+
+#include "libspectrum.h"
+
+#include "compat.h"
+#include "display.h"
+#include "fuse.h"
+#include "machine.h"
+#include "regress.h"
+#include "rzx.h"
+#include "settings.h"
+#include "snapshot.h"
+#include "spectrum.h"
+#include "ui.h"
+#include "utils.h"
+#include "z80.h"
+
+/* How long to run a snapshot for if the manifest doesn't say: ten seconds */
+#define DEFAULT_SNAPSHOT_FRAMES 500
+
+#define STATE_LENGTH 256
+
+/* How a worker finished; also its exit status */
+typedef enum regress_outcome {
+  REGRESS_PASS = 0,
+  REGRESS_DIVERGED = 1,
+  REGRESS_ERROR = 2,
+} regress_outcome;
+
+typedef struct regress_entry {
+  char *filename;
+  long frames;			/* 0 to use the default */
+} regress_entry;
+
+/* What a run produced, or what the golden results say it should */
+typedef struct regress_trace {
+  GArray *hashes;		/* One libspectrum_qword per frame */
+  char state[ STATE_LENGTH ];
+} regress_trace;
+
+static GArray *read_manifest( const char *manifest );
+static void free_manifest( GArray *entries );
+static regress_outcome run_entry( const regress_entry *entry, int update );
+static int play_entry( const regress_entry *entry, regress_trace *trace );
+static int read_golden( const char *filename, regress_trace *golden );
+static int write_golden( const char *filename, const regress_trace *trace );
+static regress_outcome compare( const char *filename,
+                                const regress_trace *trace,
+                                const regress_trace *golden );
+static char* golden_filename( const char *filename );
+
+/* 64-bit FNV-1a, fed a byte at a time so the result doesn't depend on the
+   host's endianness */
+#define FNV_OFFSET 0xcbf29ce484222325ULL
+#define FNV_PRIME 0x100000001b3ULL
+
+static libspectrum_qword
+hash_bytes( libspectrum_qword hash, const libspectrum_byte *data,
+            size_t length )
+{
+  while( length-- ) { hash ^= *data++; hash *= FNV_PRIME; }
+
+  return hash;
+}
+
+static libspectrum_qword
+hash_screen( void )
+{
+  libspectrum_qword hash = FNV_OFFSET;
+  libspectrum_byte bytes[4];
+  size_t i;
+
+  for( i = 0; i < ARRAY_SIZE( display_last_screen ); i++ ) {
+    libspectrum_dword chunk = display_last_screen[i];
+    bytes[0] = chunk; bytes[1] = chunk >> 8;
+    bytes[2] = chunk >> 16; bytes[3] = chunk >> 24;
+    hash = hash_bytes( hash, bytes, 4 );
+  }
+
+  return hash;
+}
+
+static void
+describe_state( char *buffer )
+{
+  libspectrum_qword memory = FNV_OFFSET;
+  int i;
+
+  for( i = 0; i < machine_current->ram.valid_pages; i++ )
+    memory = hash_bytes( memory, RAM[i], 0x4000 );
+
+  snprintf( buffer, STATE_LENGTH,
+            "pc=%04x sp=%04x af=%04x bc=%04x de=%04x hl=%04x af'=%04x "
+            "bc'=%04x de'=%04x hl'=%04x ix=%04x iy=%04x i=%02x r=%02x "
+            "iff=%d%d im=%d tstates=%lu memory=%016llx",
+            z80.pc.w, z80.sp.w, z80.af.w, z80.bc.w, z80.de.w, z80.hl.w,
+            z80.af_.w, z80.bc_.w, z80.de_.w, z80.hl_.w, z80.ix.w, z80.iy.w,
+            z80.i, ( z80.r7 & 0x80 ) | ( z80.r & 0x7f ), z80.iff1, z80.iff2,
+            z80.im, (unsigned long)tstates, (unsigned long long)memory );
+}
+
+int
+regress_run( const char *manifest, int update )
+{
+  GArray *entries;
+  size_t i, passed = 0, diverged = 0, failed = 0;
+
+#ifdef HAVE_FORK
+  regress_outcome outcome;
+  pid_t *workers;
+  size_t next = 0, running = 0;
+  long jobs;
+  int status;
+  pid_t pid;
+#endif				/* #ifdef HAVE_FORK */
+
+  entries = read_manifest( manifest );
+  if( !entries ) return 1;
+
+#ifdef HAVE_FORK
+
+  jobs = sysconf( _SC_NPROCESSORS_ONLN );
+  if( jobs < 1 ) jobs = 1;
+
+  workers = libspectrum_new0( pid_t, entries->len );
+
+  while( next < entries->len || running ) {
+
+    if( next < entries->len && running < (size_t)jobs ) {
+      fflush( stdout ); fflush( stderr );
+
+      pid = fork();
+      if( pid == -1 ) {
+        ui_error( UI_ERROR_ERROR, "couldn't start regression worker: %s",
+                  strerror( errno ) );
+        failed += entries->len - next;
+        next = entries->len;
+        continue;
+      }
+
+      if( !pid ) {
+        outcome = run_entry( &g_array_index( entries, regress_entry, next ),
+                             update );
+        fflush( stdout ); fflush( stderr );
+        _exit( outcome );
+      }
+
+      workers[ next++ ] = pid; running++;
+      continue;
+    }
+
+    pid = waitpid( -1, &status, 0 );
+    if( pid == -1 ) {
+      if( errno == EINTR ) continue;
+      break;
+    }
+
+    for( i = 0; i < next && workers[i] != pid; i++ )
+      ;
+    if( i == next ) continue;
+    running--;
+
+    if( WIFEXITED( status ) ) {
+      outcome = WEXITSTATUS( status );
+    } else {
+      printf( "ERROR %s: worker died with signal %d\n",
+              g_array_index( entries, regress_entry, i ).filename,
+              WIFSIGNALED( status ) ? WTERMSIG( status ) : 0 );
+      outcome = REGRESS_ERROR;
+    }
+
+    switch( outcome ) {
+    case REGRESS_PASS: passed++; break;
+    case REGRESS_DIVERGED: diverged++; break;
+    default: failed++; break;
+    }
+  }
+
+  libspectrum_free( workers );
+
+#else				/* #ifdef HAVE_FORK */
+
+  /* Without workers, just run everything here one after another */
+  for( i = 0; i < entries->len; i++ ) {
+    switch( run_entry( &g_array_index( entries, regress_entry, i ),
+                       update ) ) {
+    case REGRESS_PASS: passed++; break;
+    case REGRESS_DIVERGED: diverged++; break;
+    default: failed++; break;
+    }
+  }
+
+#endif				/* #ifdef HAVE_FORK */
+
+  printf( "%lu passed, %lu diverged, %lu failed\n", (unsigned long)passed,
+          (unsigned long)diverged, (unsigned long)failed );
+
+  free_manifest( entries );
+
+  return diverged || failed;
+}
+
+static GArray*
+read_manifest( const char *manifest )
+{
+  FILE *f;
+  char line[ 1024 ], *start, *end, *directory_end;
+  size_t directory_length;
+  regress_entry entry;
+  GArray *entries;
+
+  f = fopen( manifest, "r" );
+  if( !f ) {
+    ui_error( UI_ERROR_ERROR, "couldn't open regression manifest '%s': %s",
+              manifest, strerror( errno ) );
+    return NULL;
+  }
+
+  directory_end = strrchr( manifest, FUSE_DIR_SEP_CHR );
+  directory_length = directory_end ? directory_end - manifest + 1 : 0;
+
+  entries = g_array_new( FALSE, FALSE, sizeof( regress_entry ) );
+
+  while( fgets( line, sizeof( line ), f ) ) {
+
+    for( start = line; *start == ' ' || *start == '\t'; start++ )
+      ;
+    if( *start == '#' || *start == '\n' || *start == '\r' || !*start )
+      continue;
+
+    for( end = start;
+         *end && *end != ' ' && *end != '\t' && *end != '\n' && *end != '\r';
+         end++ )
+      ;
+
+    entry.frames = strtol( end, NULL, 10 );
+    *end = '\0';
+
+    if( compat_is_absolute_path( start ) || !directory_length ) {
+      entry.filename = utils_safe_strdup( start );
+    } else {
+      entry.filename = libspectrum_new( char,
+                                        directory_length + strlen( start ) + 1 );
+      memcpy( entry.filename, manifest, directory_length );
+      strcpy( entry.filename + directory_length, start );
+    }
+
+    g_array_append_val( entries, entry );
+  }
+
+  fclose( f );
+
+  return entries;
+}
+
+static void
+free_manifest( GArray *entries )
+{
+  size_t i;
+
+  for( i = 0; i < entries->len; i++ )
+    libspectrum_free( g_array_index( entries, regress_entry, i ).filename );
+
+  g_array_free( entries, TRUE );
+}
+
+/* Run one entry and report on it; in a worker of its own if we have them */
+static regress_outcome
+run_entry( const regress_entry *entry, int update )
+{
+  regress_trace trace, golden;
+  regress_outcome outcome;
+  char *golden_file;
+
+  trace.hashes = g_array_new( FALSE, FALSE, sizeof( libspectrum_qword ) );
+  golden.hashes = g_array_new( FALSE, FALSE, sizeof( libspectrum_qword ) );
+  golden_file = golden_filename( entry->filename );
+
+  if( play_entry( entry, &trace ) ) {
+    printf( "ERROR %s: couldn't be played\n", entry->filename );
+    outcome = REGRESS_ERROR;
+  } else if( update ) {
+    if( write_golden( golden_file, &trace ) ) {
+      printf( "ERROR %s: couldn't write golden results\n", entry->filename );
+      outcome = REGRESS_ERROR;
+    } else {
+      printf( "UPDATED %s (%lu frames)\n", entry->filename,
+              (unsigned long)trace.hashes->len );
+      outcome = REGRESS_PASS;
+    }
+  } else if( read_golden( golden_file, &golden ) ) {
+    printf( "ERROR %s: no golden results in %s\n", entry->filename,
+            golden_file );
+    outcome = REGRESS_ERROR;
+  } else {
+    outcome = compare( entry->filename, &trace, &golden );
+  }
+
+  libspectrum_free( golden_file );
+  g_array_free( golden.hashes, TRUE );
+  g_array_free( trace.hashes, TRUE );
+
+  return outcome;
+}
+
+static int
+play_entry( const regress_entry *entry, regress_trace *trace )
+{
+  libspectrum_id_t type;
+  libspectrum_class_t class;
+  libspectrum_qword hash;
+  utils_file file;
+  long frames;
+  int recording, error;
+
+  error = utils_read_file( entry->filename, &file );
+  if( error ) return error;
+
+  error = libspectrum_identify_file_with_class( &type, &class,
+                                                entry->filename, file.buffer,
+                                                file.length );
+  utils_close_file( &file );
+  if( error ) return error;
+
+  /* Never wait for the real time to catch up, and draw every frame */
+  ui_headless = 1;
+  settings_current.fast_forward = 1;
+  settings_current.fast_forward_frameskip = 1;
+
+  /* Leave nothing behind alongside the files being played */
+  settings_current.rzx_index = 0;
+
+  recording = class == LIBSPECTRUM_CLASS_RECORDING;
+  if( recording ) {
+    error = rzx_start_playback( entry->filename, 0 );
+  } else if( class == LIBSPECTRUM_CLASS_SNAPSHOT ) {
+    error = snapshot_read( entry->filename );
+  } else {
+    ui_error( UI_ERROR_ERROR, "'%s' is neither a recording nor a snapshot",
+              entry->filename );
+    error = 1;
+  }
+  if( error ) return error;
+
+  frames = entry->frames;
+  if( !frames && !recording ) frames = DEFAULT_SNAPSHOT_FRAMES;
+
+  while( !frames || (long)trace->hashes->len < frames ) {
+    spectrum_do_frame();
+
+    hash = hash_screen();
+    g_array_append_val( trace->hashes, hash );
+
+    if( recording && !rzx_playback ) break;
+  }
+
+  describe_state( trace->state );
+
+  if( rzx_playback ) rzx_stop_playback( 0 );
+
+  return 0;
+}
+
+static int
+read_golden( const char *filename, regress_trace *golden )
+{
+  FILE *f;
+  char line[ STATE_LENGTH + 16 ];
+  unsigned long frame;
+  unsigned long long hash;
+  libspectrum_qword value;
+  size_t length;
+
+  f = fopen( filename, "r" );
+  if( !f ) return 1;
+
+  golden->state[0] = '\0';
+
+  while( fgets( line, sizeof( line ), f ) ) {
+
+    if( !strncmp( line, "state ", 6 ) ) {
+      length = strcspn( line + 6, "\r\n" );
+      if( length >= STATE_LENGTH ) length = STATE_LENGTH - 1;
+      memcpy( golden->state, line + 6, length );
+      golden->state[ length ] = '\0';
+      continue;
+    }
+
+    if( sscanf( line, "%lu %llx", &frame, &hash ) != 2 ||
+        frame != golden->hashes->len ) {
+      fclose( f );
+      return 1;
+    }
+
+    value = hash;
+    g_array_append_val( golden->hashes, value );
+  }
+
+  fclose( f );
+
+  return 0;
+}
+
+static int
+write_golden( const char *filename, const regress_trace *trace )
+{
+  FILE *f;
+  size_t i;
+
+  f = fopen( filename, "w" );
+  if( !f ) return 1;
+
+  for( i = 0; i < trace->hashes->len; i++ )
+    fprintf( f, "%lu %016llx\n", (unsigned long)i,
+             (unsigned long long)g_array_index( trace->hashes,
+                                                libspectrum_qword, i ) );
+  fprintf( f, "state %s\n", trace->state );
+
+  return fclose( f ) != 0;
+}
+
+static regress_outcome
+compare( const char *filename, const regress_trace *trace,
+         const regress_trace *golden )
+{
+  size_t i, length;
+
+  length = trace->hashes->len < golden->hashes->len ? trace->hashes->len
+                                                    : golden->hashes->len;
+
+  for( i = 0; i < length; i++ )
+    if( g_array_index( trace->hashes, libspectrum_qword, i ) !=
+        g_array_index( golden->hashes, libspectrum_qword, i ) ) break;
+
+  if( i < length || trace->hashes->len != golden->hashes->len ) {
+    printf( "DIVERGED %s: at frame %lu of %lu\n", filename, (unsigned long)i,
+            (unsigned long)golden->hashes->len );
+    return REGRESS_DIVERGED;
+  }
+
+  if( strcmp( trace->state, golden->state ) ) {
+    printf( "DIVERGED %s: final state\n  expected %s\n  got      %s\n",
+            filename, golden->state, trace->state );
+    return REGRESS_DIVERGED;
+  }
+
+  printf( "PASS %s (%lu frames)\n", filename,
+          (unsigned long)trace->hashes->len );
+
+  return REGRESS_PASS;
+}
+
+static char*
+golden_filename( const char *filename )
+{
+  static const char suffix[] = ".golden";
+  char *golden;
+
+  golden = libspectrum_new( char, strlen( filename ) + sizeof( suffix ) );
+  strcpy( golden, filename );
+  strcat( golden, suffix );
+
+  return golden;
+}
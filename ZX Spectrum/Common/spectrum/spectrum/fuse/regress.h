@@ -0,0 +1,34 @@
+/* regress.h: Play recordings and snapshots against golden results
+   Copyright (c) 2026 The Fuse authors
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+   Author contact information:
+
+   E-mail: philip-fuse@shadowmagic.org.uk
+
+*/
+
+#ifndef FUSE_REGRESS_H
+#define FUSE_REGRESS_H
+
+/* Play every file listed in <manifest>, each in a worker process of its
+   own with as many running at once as there are processors, and compare
+   the screen each frame and the machine state at the end with the golden
+   results stored alongside. With <update> set, write the golden results
+   instead. Returns non-zero if anything diverged or couldn't be run */
+int regress_run( const char *manifest, int update );
+
+#endif			/* #ifndef FUSE_REGRESS_H */
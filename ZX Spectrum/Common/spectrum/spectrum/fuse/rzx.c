@@ -43,6 +43,7 @@
 #include "movie.h"
 #include "ula.h"
 #include "rzx.h"
+#include "rzx_index.h"
 #include "settings.h"
 #include "snapshot.h"
 #include "timer.h"
@@ -287,22 +288,25 @@ int rzx_start_playback( const char *filename, int check_snapshot )
     return libspec_error;
   }
 
-  utils_close_file( &file );
-
   snap = rzx_get_initial_snapshot();
   if( !snap && check_snapshot ) {
     /* We need to load an external snapshot. Could be skipped if the snapshot
        is preloaded from command line */
     error = utils_open_snap();
-    if( error ) return error;
+    if( error ) { utils_close_file( &file ); return error; }
   }
 
   error = start_playback( rzx );
   if( error ) {
+    utils_close_file( &file );
     libspectrum_rzx_free( rzx );
     return error;
   }
 
+  rzx_index_start( filename, file.buffer, file.length );
+
+  utils_close_file( &file );
+
   return 0;
 }
 
@@ -334,6 +338,8 @@ rzx_start_playback_from_buffer( const unsigned char *buffer, size_t length )
     return error;
   }
 
+  rzx_index_start( NULL, buffer, length );
+
   return 0;
 }
 
@@ -380,6 +386,8 @@ int rzx_stop_playback( int add_interrupt )
 
   event_remove_type( sentinel_event );
 
+  rzx_index_stop();
+
   /* We've now finished with the RZX file, so add an end of frame
      event if we've been requested to do so; we don't if we just run
      out of frames, as this occurs just before a normal end of frame
@@ -714,6 +722,39 @@ static int playback_frame( void )
   return 0;
 }
 
+int
+rzx_playback_position( int *which, size_t *frame, int *instructions )
+{
+  libspectrum_error error;
+
+  error = libspectrum_rzx_playback_position( rzx, which, frame );
+  if( error ) return error;
+
+  *instructions = R + rzx_instructions_offset;
+
+  return 0;
+}
+
+int
+rzx_playback_resume( int which, size_t frame, int instructions )
+{
+  libspectrum_error error;
+
+  error = libspectrum_rzx_playback_seek( rzx, which, frame );
+  if( error ) return error;
+
+  /* As for start_playback(), having just come from a snapshot */
+  event_remove_type( spectrum_frame_event );
+  event_remove_type( sentinel_event );
+  event_add( RZX_SENTINEL_TIME, sentinel_event );
+
+  rzx_instruction_count = libspectrum_rzx_instructions( rzx );
+  counter_reset();
+  rzx_instructions_offset += instructions;
+
+  return 0;
+}
+
 /* Reset the RZX counter; also, take this opportunity to normalise the
    R register */
 static int counter_reset( void )
@@ -749,6 +790,8 @@ rzx_end( void )
 {
   if( rzx_recording ) rzx_stop_recording();
   if( rzx_playback  ) rzx_stop_playback( 0 );
+
+  rzx_index_end();
 }
 
 void
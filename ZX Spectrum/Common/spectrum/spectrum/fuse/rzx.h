@@ -86,4 +86,12 @@ GSList* rzx_get_rollback_list( libspectrum_rzx *rzx );
 
 libspectrum_snap* rzx_get_initial_snapshot( void );
 
+/* Where playback has got to: the input recording block, the frame within
+   it and the instructions already executed in that frame */
+int rzx_playback_position( int *which, size_t *frame, int *instructions );
+
+/* Carry on playback from a position returned by rzx_playback_position(),
+   with the machine already restored to the state it was in there */
+int rzx_playback_resume( int which, size_t frame, int instructions );
+
 #endif			/* #ifndef FUSE_RZX_H */
@@ -0,0 +1,607 @@
+/* rzx_index.c: Seeking within RZX playback
+   Copyright (c) 2026 The Fuse authors
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+   Author contact information:
+
+   E-mail: philip-fuse@shadowmagic.org.uk
+
+*/
+
+/* Every KEYFRAME_INTERVAL frames, playback takes a snapshot of the machine
+   along with where it has got to in the recording. Seeking restores the
+   last of these keyframes before the frame wanted and plays on from there
+   without sound or drawing.
+
+   Keyframes can only come from playing the recording, as there is only the
+   one machine. Once playback stops, they are converted to SZX and written
+   to an index file alongside the recording on a thread of their own; the
+   next time the recording is played, the index is read back on another
+   thread while playback gets under way */
+
+#include "config.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif				/* #ifdef HAVE_PTHREAD */
+
+#include "libspectrum.h"
+
+#include "display.h"
+#include "fuse.h"
+#include "rzx.h"
+#include "rzx_index.h"
+#include "settings.h"
+#include "snapshot.h"
+#include "spectrum.h"
+#include "ui.h"
+#include "utils.h"
+
+/* Ten seconds at 50 frames per second */
+#define KEYFRAME_INTERVAL ( 10 * 50 )
+
+/* The index file is the signature, then dwords giving the version, the
+   length and checksum of the recording and the number of keyframes. Each
+   keyframe is five dwords (the fields below, and the length of the SZX
+   snapshot) followed by the snapshot itself */
+static const char signature[] = "FuseRZXi";
+static const size_t signature_length = 8;
+static const libspectrum_dword INDEX_VERSION = 1;
+
+typedef struct rzx_keyframe {
+  size_t frame;			/* Frames played before this one */
+  int block;			/* The input recording block... */
+  size_t block_frame;		/* ...and the frame within it */
+  int instructions;		/* Instructions already run in that frame */
+  libspectrum_snap *snap;
+} rzx_keyframe;
+
+/* A read or write of an index file */
+typedef struct index_job {
+
+  char *filename;
+  size_t rzx_length;
+  libspectrum_dword rzx_checksum;
+
+  GArray *keyframes;
+  int error;
+  ui_error_buffer errors;
+
+  int (*fn)( struct index_job *job );
+
+#ifdef HAVE_PTHREAD
+  pthread_t thread;
+  int running;
+#endif				/* #ifdef HAVE_PTHREAD */
+
+} index_job;
+
+static GArray *keyframes;
+static size_t current_frame, total_frames;
+
+/* Have keyframes been taken which aren't in the index file? */
+static int dirty;
+
+static char *index_filename;
+static size_t rzx_length;
+static libspectrum_dword rzx_checksum;
+
+static index_job load_job, save_job;
+static int load_pending, save_pending;
+
+static GArray*
+keyframes_new( void )
+{
+  return g_array_new( FALSE, FALSE, sizeof( rzx_keyframe ) );
+}
+
+static void
+keyframes_free( GArray *array )
+{
+  guint i;
+
+  if( !array ) return;
+
+  for( i = 0; i < array->len; i++ )
+    libspectrum_snap_free( g_array_index( array, rzx_keyframe, i ).snap );
+
+  g_array_free( array, TRUE );
+}
+
+/* FNV-1a, to tell whether an index file belongs to the recording */
+static libspectrum_dword
+checksum( const libspectrum_byte *buffer, size_t length )
+{
+  libspectrum_dword hash = 2166136261U;
+
+  while( length-- ) {
+    hash ^= *buffer++;
+    hash *= 16777619U;
+  }
+
+  return hash;
+}
+
+static int
+write_dword( FILE *f, libspectrum_dword value )
+{
+  libspectrum_byte buffer[4];
+
+  buffer[0] = value & 0xff; buffer[1] = ( value >> 8 ) & 0xff;
+  buffer[2] = ( value >> 16 ) & 0xff; buffer[3] = value >> 24;
+
+  return fwrite( buffer, 1, 4, f ) != 4;
+}
+
+static int
+read_dword( const libspectrum_byte **ptr, const libspectrum_byte *end,
+            libspectrum_dword *value )
+{
+  if( end - *ptr < 4 ) return 1;
+
+  *value = (*ptr)[0] | (*ptr)[1] << 8 | (*ptr)[2] << 16 |
+           (libspectrum_dword)(*ptr)[3] << 24;
+  *ptr += 4;
+
+  return 0;
+}
+
+/* Neither of the jobs may call ui_error(); they may be on another thread,
+   so libspectrum's errors are kept in job->errors */
+
+static int
+index_write( index_job *job )
+{
+  rzx_keyframe *keyframe;
+  libspectrum_byte *buffer;
+  size_t length;
+  int flags, error = 0;
+  guint i;
+  FILE *f;
+
+  f = fopen( job->filename, "wb" );
+  if( !f ) return 1;
+
+  if( fwrite( signature, 1, signature_length, f ) != signature_length ||
+      write_dword( f, INDEX_VERSION ) ||
+      write_dword( f, job->rzx_length ) ||
+      write_dword( f, job->rzx_checksum ) ||
+      write_dword( f, job->keyframes->len ) )
+    error = 1;
+
+  for( i = 0; !error && i < job->keyframes->len; i++ ) {
+
+    keyframe = &g_array_index( job->keyframes, rzx_keyframe, i );
+
+    buffer = NULL; length = 0;
+    error = libspectrum_snap_write( &buffer, &length, &flags, keyframe->snap,
+                                    LIBSPECTRUM_ID_SNAPSHOT_SZX, fuse_creator,
+                                    0 );
+    if( error ) break;
+
+    if( write_dword( f, keyframe->frame ) ||
+        write_dword( f, keyframe->block ) ||
+        write_dword( f, keyframe->block_frame ) ||
+        write_dword( f, keyframe->instructions ) ||
+        write_dword( f, length ) ||
+        fwrite( buffer, 1, length, f ) != length )
+      error = 1;
+
+    libspectrum_free( buffer );
+  }
+
+  if( fclose( f ) ) error = 1;
+
+  /* Don't leave half an index lying around */
+  if( error ) remove( job->filename );
+
+  return error;
+}
+
+static int
+index_save( index_job *job )
+{
+  int error = index_write( job );
+
+  keyframes_free( job->keyframes );
+  job->keyframes = NULL;
+
+  return error;
+}
+
+static int
+index_parse( index_job *job, const libspectrum_byte *ptr,
+             const libspectrum_byte *end )
+{
+  libspectrum_dword version, length, sum, count, i, field[5];
+  rzx_keyframe keyframe;
+  int j;
+
+  if( (size_t)( end - ptr ) < signature_length ||
+      memcmp( ptr, signature, signature_length ) )
+    return 1;
+  ptr += signature_length;
+
+  if( read_dword( &ptr, end, &version ) || version != INDEX_VERSION ||
+      read_dword( &ptr, end, &length ) || length != job->rzx_length ||
+      read_dword( &ptr, end, &sum ) || sum != job->rzx_checksum ||
+      read_dword( &ptr, end, &count ) || !count )
+    return 1;
+
+  keyframe.frame = 0;
+
+  for( i = 0; i < count; i++ ) {
+
+    for( j = 0; j < 5; j++ )
+      if( read_dword( &ptr, end, &field[j] ) ) return 1;
+
+    /* Keyframes must be in order, and the first at the start */
+    if( i ? field[0] <= keyframe.frame : field[0] != 0 ) return 1;
+    if( (size_t)( end - ptr ) < field[4] ) return 1;
+
+    keyframe.frame = field[0];
+    keyframe.block = field[1];
+    keyframe.block_frame = field[2];
+    keyframe.instructions = (libspectrum_signed_dword)field[3];
+
+    keyframe.snap = libspectrum_snap_alloc();
+    if( libspectrum_snap_read( keyframe.snap, ptr, field[4],
+                               LIBSPECTRUM_ID_SNAPSHOT_SZX, NULL ) ) {
+      libspectrum_snap_free( keyframe.snap );
+      return 1;
+    }
+    ptr += field[4];
+
+    g_array_append_val( job->keyframes, keyframe );
+  }
+
+  return 0;
+}
+
+static int
+index_read( index_job *job )
+{
+  libspectrum_byte *buffer;
+  long length;
+  int error;
+  FILE *f;
+
+  f = fopen( job->filename, "rb" );
+  if( !f ) return 1;
+
+  if( fseek( f, 0, SEEK_END ) || ( length = ftell( f ) ) <= 0 ||
+      fseek( f, 0, SEEK_SET ) ) {
+    fclose( f );
+    return 1;
+  }
+
+  buffer = libspectrum_new( libspectrum_byte, length );
+  error = fread( buffer, 1, length, f ) != (size_t)length;
+  fclose( f );
+
+  job->keyframes = keyframes_new();
+  if( !error ) error = index_parse( job, buffer, buffer + length );
+
+  libspectrum_free( buffer );
+
+  if( error ) {
+    keyframes_free( job->keyframes );
+    job->keyframes = NULL;
+  }
+
+  return error;
+}
+
+#ifdef HAVE_PTHREAD
+
+static void*
+job_thread( void *arg )
+{
+  index_job *job = arg;
+
+  ui_error_buffer_start( &job->errors );
+  job->error = job->fn( job );
+  ui_error_buffer_stop();
+
+  return NULL;
+}
+
+#endif				/* #ifdef HAVE_PTHREAD */
+
+/* Run <fn> for <job> in the background if we can; returns non-zero if it
+   is running there */
+static int
+job_start( index_job *job, int (*fn)( index_job *job ) )
+{
+  job->fn = fn;
+  job->error = 0;
+  job->errors.used = 0;
+
+#ifdef HAVE_PTHREAD
+  if( !pthread_create( &job->thread, NULL, job_thread, job ) ) {
+    job->running = 1;
+    return 1;
+  }
+#endif				/* #ifdef HAVE_PTHREAD */
+
+  job->error = fn( job );
+
+  return 0;
+}
+
+static void
+job_wait( index_job *job )
+{
+#ifdef HAVE_PTHREAD
+  if( !job->running ) return;
+
+  pthread_join( job->thread, NULL );
+  job->running = 0;
+#endif				/* #ifdef HAVE_PTHREAD */
+}
+
+/* Swap in the keyframes read from the index file, keeping any taken since
+   which go beyond the end of it */
+static void
+load_collect( void )
+{
+  GArray *loaded;
+  rzx_keyframe *keyframe;
+  size_t last;
+  guint i;
+
+  if( !load_pending ) return;
+
+  job_wait( &load_job );
+  load_pending = 0;
+
+  /* A missing or out of date index is nothing to worry about, but one
+     libspectrum couldn't make sense of is worth a mention */
+  if( load_job.errors.used )
+    ui_error( UI_ERROR_WARNING, "couldn't read RZX index '%s': %s",
+              load_job.filename, load_job.errors.message );
+
+  libspectrum_free( load_job.filename );
+  load_job.filename = NULL;
+
+  loaded = load_job.keyframes;
+  load_job.keyframes = NULL;
+  if( load_job.error || !loaded ) return;
+
+  last = g_array_index( loaded, rzx_keyframe, loaded->len - 1 ).frame;
+
+  dirty = 0;
+
+  for( i = 0; i < keyframes->len; i++ ) {
+    keyframe = &g_array_index( keyframes, rzx_keyframe, i );
+    if( keyframe->frame > last ) {
+      g_array_append_val( loaded, *keyframe );
+      dirty = 1;
+    } else {
+      libspectrum_snap_free( keyframe->snap );
+    }
+  }
+
+  g_array_free( keyframes, TRUE );
+  keyframes = loaded;
+}
+
+static void
+save_collect( void )
+{
+  if( !save_pending ) return;
+
+  job_wait( &save_job );
+  save_pending = 0;
+
+  if( save_job.errors.used )
+    ui_error( UI_ERROR_WARNING, "couldn't write RZX index to '%s': %s",
+              save_job.filename, save_job.errors.message );
+  else if( save_job.error )
+    ui_error( UI_ERROR_WARNING, "couldn't write RZX index to '%s'",
+              save_job.filename );
+
+  libspectrum_free( save_job.filename );
+  save_job.filename = NULL;
+}
+
+static size_t
+count_frames( void )
+{
+  libspectrum_rzx_iterator it;
+  size_t frames = 0;
+
+  for( it = libspectrum_rzx_iterator_begin( rzx );
+       it;
+       it = libspectrum_rzx_iterator_next( it ) ) {
+    if( libspectrum_rzx_iterator_get_type( it ) == LIBSPECTRUM_RZX_INPUT_BLOCK )
+      frames += libspectrum_rzx_iterator_get_frames( it );
+  }
+
+  return frames;
+}
+
+static void
+keyframe_add( void )
+{
+  rzx_keyframe keyframe;
+
+  if( rzx_playback_position( &keyframe.block, &keyframe.block_frame,
+                             &keyframe.instructions ) )
+    return;
+
+  keyframe.frame = current_frame;
+  keyframe.snap = libspectrum_snap_alloc();
+  snapshot_copy_to( keyframe.snap );
+
+  g_array_append_val( keyframes, keyframe );
+  dirty = 1;
+}
+
+static int
+keyframe_restore( const rzx_keyframe *keyframe )
+{
+  int error;
+
+  error = snapshot_copy_from( keyframe->snap );
+  if( error ) return error;
+
+  error = rzx_playback_resume( keyframe->block, keyframe->block_frame,
+                               keyframe->instructions );
+  if( error ) return error;
+
+  current_frame = keyframe->frame;
+
+  return 0;
+}
+
+void
+rzx_index_start( const char *filename, const libspectrum_byte *buffer,
+                 size_t length )
+{
+  size_t filename_length;
+
+  rzx_index_stop();
+
+  keyframes = keyframes_new();
+  current_frame = 0;
+  total_frames = count_frames();
+  dirty = 0;
+
+  rzx_length = length;
+  rzx_checksum = checksum( buffer, length );
+
+  if( filename && settings_current.rzx_index ) {
+
+    filename_length = strlen( filename ) + 5;
+    index_filename = libspectrum_new( char, filename_length );
+    snprintf( index_filename, filename_length, "%s.idx", filename );
+
+    /* This recording's index may still be being written from last time */
+    save_collect();
+
+    load_job.filename = utils_safe_strdup( index_filename );
+    load_job.rzx_length = rzx_length;
+    load_job.rzx_checksum = rzx_checksum;
+    load_job.keyframes = NULL;
+    load_pending = 1;
+    job_start( &load_job, index_read );
+  }
+
+  keyframe_add();
+}
+
+void
+rzx_index_frame( void )
+{
+  if( !keyframes ) return;
+
+  if( ++current_frame % KEYFRAME_INTERVAL ) return;
+
+  /* Only extend the index; after seeking back, these are already there */
+  if( keyframes->len &&
+      g_array_index( keyframes, rzx_keyframe, keyframes->len - 1 ).frame >=
+        current_frame )
+    return;
+
+  keyframe_add();
+}
+
+void
+rzx_index_stop( void )
+{
+  if( !keyframes ) return;
+
+  load_collect();
+
+  /* Not worth an index if there's nothing past the start */
+  if( dirty && index_filename && keyframes->len > 1 ) {
+    save_collect();
+
+    save_job.filename = index_filename;
+    save_job.rzx_length = rzx_length;
+    save_job.rzx_checksum = rzx_checksum;
+    save_job.keyframes = keyframes;
+    save_pending = 1;
+    if( !job_start( &save_job, index_save ) ) save_collect();
+
+    index_filename = NULL;
+    keyframes = NULL;
+    return;
+  }
+
+  keyframes_free( keyframes );
+  keyframes = NULL;
+
+  libspectrum_free( index_filename );
+  index_filename = NULL;
+}
+
+void
+rzx_index_end( void )
+{
+  rzx_index_stop();
+  save_collect();
+}
+
+size_t
+rzx_index_position( void )
+{
+  return current_frame;
+}
+
+size_t
+rzx_index_length( void )
+{
+  return total_frames;
+}
+
+int
+rzx_index_seek( size_t frame )
+{
+  rzx_keyframe *keyframe = NULL;
+  guint i;
+  int error;
+
+  if( !rzx_playback || !keyframes || !total_frames ) return 1;
+
+  load_collect();
+
+  if( frame >= total_frames ) frame = total_frames - 1;
+
+  for( i = 0; i < keyframes->len; i++ ) {
+    if( g_array_index( keyframes, rzx_keyframe, i ).frame > frame ) break;
+    keyframe = &g_array_index( keyframes, rzx_keyframe, i );
+  }
+
+  /* Go back to a keyframe only if carrying on from here won't do */
+  if( frame < current_frame ||
+      ( keyframe && keyframe->frame > current_frame ) ) {
+    if( !keyframe ) return 1;
+    error = keyframe_restore( keyframe );
+    if( error ) return error;
+  }
+
+  /* Any keyframes passed on the way are added to the index */
+  if( frame > current_frame ) spectrum_skip_frames( frame - current_frame );
+
+  display_refresh_all();
+
+  return 0;
+}
@@ -0,0 +1,52 @@
+/* rzx_index.h: Seeking within RZX playback
+   Copyright (c) 2026 The Fuse authors
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+   Author contact information:
+
+   E-mail: philip-fuse@shadowmagic.org.uk
+
+*/
+
+#ifndef FUSE_RZX_INDEX_H
+#define FUSE_RZX_INDEX_H
+
+#include <stddef.h>
+
+#include "libspectrum.h"
+
+/* Start indexing the recording just started from <buffer>. If <filename>
+   is given, the index saved alongside it last time is read back */
+void rzx_index_start( const char *filename, const libspectrum_byte *buffer,
+                      size_t length );
+
+/* Called at the end of every frame played back */
+void rzx_index_frame( void );
+
+/* Playback has stopped: save the index if there's anything new in it */
+void rzx_index_stop( void );
+
+/* Wait for any index still being saved */
+void rzx_index_end( void );
+
+/* The frame about to be played, and how many there are in all */
+size_t rzx_index_position( void );
+size_t rzx_index_length( void );
+
+/* Move playback to <frame>, counting from the start of the recording */
+int rzx_index_seek( size_t frame );
+
+#endif			/* #ifndef FUSE_RZX_INDEX_H */
@@ -98,8 +98,8 @@ screenshot_write( const char *filename, scaler_type scaler )
   if( error ) return error;
 
   /* Actually scale the data here */
-  scaler_get_proc32( scaler )( rgb_data1, rgb_stride, rgb_data2, rgb_stride,
-			       base_width, base_height );
+  scaler_run( scaler, scaler_get_proc32( scaler ), rgb_data1, rgb_stride,
+              rgb_data2, rgb_stride, base_width, base_height );
 
   height = base_height * scaler_get_scaling_factor( scaler );
   width  = base_width  * scaler_get_scaling_factor( scaler );
@@ -76,8 +76,12 @@ typedef struct settings_info {
   char *drive_plusd2_type;
    int embed_snapshot;
    int emulation_speed;
+   int fast_forward;
+   int fast_forward_fps;
+   int fast_forward_frameskip;
    int fastload;
    int fb_mode;
+  char *file_index;
    int frame_rate;
    int full_screen;
    int full_screen_panorama;
@@ -164,9 +168,12 @@ typedef struct settings_info {
    int printer;
   char *printer_graphics_filename;
   char *printer_text_filename;
+  char *quicksave_file;
    int raw_s_net;
   char *record_file;
    int recreated_spectrum;
+  char *regress;
+   int regress_update;
   char *rom_128_0;
   char *rom_128_1;
   char *rom_16_0;
@@ -218,13 +225,17 @@ typedef struct settings_info {
    int rs232_handshake;
   char *rs232_rx;
   char *rs232_tx;
+   int run_ahead;
    int rzx_autosaves;
    int rzx_compression;
+   int rzx_index;
+   int scanline_log;
    int simpleide_active;
   char *simpleide_master_file;
   char *simpleide_slave_file;
    int slt_traps;
   char *snapshot;
+   int snapshot_compression;
   char *snet;
    int sound;
   char *sound_device;
@@ -239,12 +250,15 @@ typedef struct settings_info {
    int spectranet_disable;
   char *start_machine;
   char *start_scaler_mode;
+   int startup_trace;
    int statusbar;
   char *stereo_ay;
    int strict_aspect_hint;
   char *svga_modes;
   char *tape_file;
+  char *tape_record_file;
    int tape_traps;
+   int turbosound;
    int unittests;
    int usource;
    int volume_ay;
@@ -106,8 +106,12 @@ settings_info settings_default = {
   /* drive_plusd2_type */ (char *)"Double-sided 80 track",
   /* embed_snapshot */ 1,
   /* emulation_speed */ 100,
+  /* fast_forward */ 0,
+  /* fast_forward_fps */ 0,
+  /* fast_forward_frameskip */ 10,
   /* fastload */ 1,
   /* fb_mode */ 320,
+  /* file_index */ (char *)NULL,
   /* frame_rate */ 1,
   /* full_screen */ 0,
   /* full_screen_panorama */ 1,
@@ -194,9 +198,12 @@ settings_info settings_default = {
   /* printer */ 0,
   /* printer_graphics_filename */ (char *)"printout.pbm",
   /* printer_text_filename */ (char *)"printout.txt",
+  /* quicksave_file */ (char *)NULL,
   /* raw_s_net */ 0,
   /* record_file */ (char *)NULL,
   /* recreated_spectrum */ 0,
+  /* regress */ (char *)NULL,
+  /* regress_update */ 0,
   /* rom_128_0 */ (char *)"128-0.rom",
   /* rom_128_1 */ (char *)"128-1.rom",
   /* rom_16_0 */ (char *)"48.rom",
@@ -248,13 +255,17 @@ settings_info settings_default = {
   /* rs232_handshake */ 0,
   /* rs232_rx */ (char *)NULL,
   /* rs232_tx */ (char *)NULL,
+  /* run_ahead */ 0,
   /* rzx_autosaves */ 1,
   /* rzx_compression */ 1,
+  /* rzx_index */ 1,
+  /* scanline_log */ 0,
   /* simpleide_active */ 0,
   /* simpleide_master_file */ (char *)NULL,
   /* simpleide_slave_file */ (char *)NULL,
   /* slt_traps */ 1,
   /* snapshot */ (char *)NULL,
+  /* snapshot_compression */ 1,
   /* snet */ (char *)NULL,
   /* sound */ 1,
   /* sound_device */ (char *)NULL,
@@ -269,12 +280,15 @@ settings_info settings_default = {
   /* spectranet_disable */ 0,
   /* start_machine */ (char *)"48",
   /* start_scaler_mode */ (char *)"normal",
+  /* startup_trace */ 0,
   /* statusbar */ 0,
   /* stereo_ay */ (char *)"None",
   /* strict_aspect_hint */ 0,
   /* svga_modes */ (char *)NULL,
   /* tape_file */ (char *)NULL,
+  /* tape_record_file */ (char *)NULL,
   /* tape_traps */ 1,
+  /* turbosound */ 0,
   /* unittests */ 0,
   /* usource */ 0,
   /* volume_ay */ 100,
@@ -452,9 +466,17 @@ void settings_defaults( settings_info *settings )
   value = settings->embed_snapshot ? YES : NO;
   [defaultValues setObject:@(value) forKey:@"embedsnapshot"];
   [defaultValues setObject:@(settings->emulation_speed) forKey:@"speed"];
+  value = settings->fast_forward ? YES : NO;
+  [defaultValues setObject:@(value) forKey:@"fastforward"];
+  [defaultValues setObject:@(settings->fast_forward_fps) forKey:@"fastforwardfps"];
+  [defaultValues setObject:@(settings->fast_forward_frameskip) forKey:@"fastforwardframeskip"];
   value = settings->fastload ? YES : NO;
   [defaultValues setObject:@(value) forKey:@"fastload"];
   [defaultValues setObject:@(settings->fb_mode) forKey:@"fbmode"];
+  if( settings->file_index )
+    [defaultValues setObject:@(settings->file_index) forKey:@"fileindex"];
+  else
+    [defaultValues setObject:@"" forKey:@"fileindex"];
   [defaultValues setObject:@(settings->frame_rate) forKey:@"rate"];
   value = settings->full_screen ? YES : NO;
   [defaultValues setObject:@(value) forKey:@"fullscreen"];
@@ -618,6 +640,10 @@ void settings_defaults( settings_info *settings )
     [defaultValues setObject:@(settings->printer_text_filename) forKey:@"textfile"];
   else
     [defaultValues setObject:@"" forKey:@"textfile"];
+  if( settings->quicksave_file )
+    [defaultValues setObject:@(settings->quicksave_file) forKey:@"quicksavefile"];
+  else
+    [defaultValues setObject:@"" forKey:@"quicksavefile"];
   value = settings->raw_s_net ? YES : NO;
   [defaultValues setObject:@(value) forKey:@"rawsnet"];
 //  if( settings->cocoa && settings->cocoa->recent_snapshots )
@@ -630,6 +656,12 @@ void settings_defaults( settings_info *settings )
     [defaultValues setObject:@"" forKey:@"recordfile"];
   value = settings->recreated_spectrum ? YES : NO;
   [defaultValues setObject:@(value) forKey:@"recreatedspectrum"];
+  if( settings->regress )
+    [defaultValues setObject:@(settings->regress) forKey:@"regress"];
+  else
+    [defaultValues setObject:@"" forKey:@"regress"];
+  value = settings->regress_update ? YES : NO;
+  [defaultValues setObject:@(value) forKey:@"regressupdate"];
   if( settings->rom_128_0 )
     [defaultValues setObject:@(settings->rom_128_0) forKey:@"rom1280"];
   else
@@ -832,10 +864,15 @@ void settings_defaults( settings_info *settings )
     [defaultValues setObject:@(settings->rs232_tx) forKey:@"rs232tx"];
   else
     [defaultValues setObject:@"" forKey:@"rs232tx"];
+  [defaultValues setObject:@(settings->run_ahead) forKey:@"runahead"];
   value = settings->rzx_autosaves ? YES : NO;
   [defaultValues setObject:@(value) forKey:@"rzxautosaves"];
   value = settings->rzx_compression ? YES : NO;
   [defaultValues setObject:@(value) forKey:@"compressrzx"];
+  value = settings->rzx_index ? YES : NO;
+  [defaultValues setObject:@(value) forKey:@"rzxindex"];
+  value = settings->scanline_log ? YES : NO;
+  [defaultValues setObject:@(value) forKey:@"scanlinelog"];
   value = settings->simpleide_active ? YES : NO;
   [defaultValues setObject:@(value) forKey:@"simpleide"];
   if( settings->simpleide_master_file )
@@ -852,6 +889,8 @@ void settings_defaults( settings_info *settings )
     [defaultValues setObject:@(settings->snapshot) forKey:@"snapshot"];
   else
     [defaultValues setObject:@"" forKey:@"snapshot"];
+  value = settings->snapshot_compression ? YES : NO;
+  [defaultValues setObject:@(value) forKey:@"compresssnapshot"];
   if( settings->snet )
     [defaultValues setObject:@(settings->snet) forKey:@"snet"];
   else
@@ -891,6 +930,8 @@ void settings_defaults( settings_info *settings )
     [defaultValues setObject:@(settings->start_scaler_mode) forKey:@"graphicsfilter"];
   else
     [defaultValues setObject:@"" forKey:@"graphicsfilter"];
+  value = settings->startup_trace ? YES : NO;
+  [defaultValues setObject:@(value) forKey:@"startuptrace"];
   value = settings->statusbar ? YES : NO;
   [defaultValues setObject:@(value) forKey:@"statusbar"];
   if( settings->stereo_ay )
@@ -907,8 +948,14 @@ void settings_defaults( settings_info *settings )
     [defaultValues setObject:@(settings->tape_file) forKey:@"tapefile"];
   else
     [defaultValues setObject:@"" forKey:@"tapefile"];
+  if( settings->tape_record_file )
+    [defaultValues setObject:@(settings->tape_record_file) forKey:@"taperecordfile"];
+  else
+    [defaultValues setObject:@"" forKey:@"taperecordfile"];
   value = settings->tape_traps ? YES : NO;
   [defaultValues setObject:@(value) forKey:@"tapetraps"];
+  value = settings->turbosound ? YES : NO;
+  [defaultValues setObject:@(value) forKey:@"turbosound"];
   value = settings->unittests ? YES : NO;
   [defaultValues setObject:@(value) forKey:@"unittests"];
   value = settings->usource ? YES : NO;
@@ -1139,8 +1186,16 @@ read_config_file( settings_info *settings )
   }
   settings->embed_snapshot = [defaults boolForKey:@"embedsnapshot"] ? 1 : 0;
   settings->emulation_speed = [defaults integerForKey:@"speed"];
+  settings->fast_forward = [defaults boolForKey:@"fastforward"] ? 1 : 0;
+  settings->fast_forward_fps = [defaults integerForKey:@"fastforwardfps"];
+  settings->fast_forward_frameskip = [defaults integerForKey:@"fastforwardframeskip"];
   settings->fastload = [defaults boolForKey:@"fastload"] ? 1 : 0;
   settings->fb_mode = [defaults integerForKey:@"fbmode"];
+  if( [[defaults stringForKey:@"fileindex"] isEqualToString:@""] == YES ) {
+    free( settings->file_index );
+    settings->file_index = NULL;
+  } else
+    settings_set_string( &settings->file_index, [[defaults stringForKey:@"fileindex"] UTF8String] );
   settings->frame_rate = [defaults integerForKey:@"rate"];
   settings->full_screen = [defaults boolForKey:@"fullscreen"] ? 1 : 0;
   settings->full_screen_panorama = [defaults boolForKey:@"fullscreenpanorama"] ? 1 : 0;
@@ -1288,6 +1343,11 @@ read_config_file( settings_info *settings )
     settings->printer_text_filename = NULL;
   } else
     settings_set_string( &settings->printer_text_filename, [[defaults stringForKey:@"textfile"] UTF8String] );
+  if( [[defaults stringForKey:@"quicksavefile"] isEqualToString:@""] == YES ) {
+    free( settings->quicksave_file );
+    settings->quicksave_file = NULL;
+  } else
+    settings_set_string( &settings->quicksave_file, [[defaults stringForKey:@"quicksavefile"] UTF8String] );
   settings->raw_s_net = [defaults boolForKey:@"rawsnet"] ? 1 : 0;
   if( [defaults stringArrayForKey:@"recentsnapshots"] != nil ) {
     NSEnumerator *enumerator = [[defaults stringArrayForKey:@"recentsnapshots"] reverseObjectEnumerator];
@@ -1299,6 +1359,12 @@ read_config_file( settings_info *settings )
     }
   }
   settings->recreated_spectrum = [defaults boolForKey:@"recreatedspectrum"] ? 1 : 0;
+  if( [[defaults stringForKey:@"regress"] isEqualToString:@""] == YES ) {
+    free( settings->regress );
+    settings->regress = NULL;
+  } else
+    settings_set_string( &settings->regress, [[defaults stringForKey:@"regress"] UTF8String] );
+  settings->regress_update = [defaults boolForKey:@"regressupdate"] ? 1 : 0;
   if( [[defaults stringForKey:@"rom1280"] isEqualToString:@""] == YES ) {
     free( settings->rom_128_0 );
     settings->rom_128_0 = NULL;
@@ -1550,10 +1616,14 @@ read_config_file( settings_info *settings )
     settings->rs232_tx = NULL;
   } else
     settings_set_string( &settings->rs232_tx, [[defaults stringForKey:@"rs232tx"] UTF8String] );
+  settings->run_ahead = [defaults integerForKey:@"runahead"];
   settings->rzx_autosaves = [defaults boolForKey:@"rzxautosaves"] ? 1 : 0;
   settings->rzx_compression = [defaults boolForKey:@"compressrzx"] ? 1 : 0;
+  settings->rzx_index = [defaults boolForKey:@"rzxindex"] ? 1 : 0;
+  settings->scanline_log = [defaults boolForKey:@"scanlinelog"] ? 1 : 0;
   settings->simpleide_active = [defaults boolForKey:@"simpleide"] ? 1 : 0;
   settings->slt_traps = [defaults boolForKey:@"slttraps"] ? 1 : 0;
+  settings->snapshot_compression = [defaults boolForKey:@"compresssnapshot"] ? 1 : 0;
   if( [[defaults stringForKey:@"snet"] isEqualToString:@""] == YES ) {
     free( settings->snet );
     settings->snet = NULL;
@@ -1596,6 +1666,7 @@ read_config_file( settings_info *settings )
     settings->start_scaler_mode = NULL;
   } else
     settings_set_string( &settings->start_scaler_mode, [[defaults stringForKey:@"graphicsfilter"] UTF8String] );
+  settings->startup_trace = [defaults boolForKey:@"startuptrace"] ? 1 : 0;
   settings->statusbar = [defaults boolForKey:@"statusbar"] ? 1 : 0;
   if( [[defaults stringForKey:@"separation"] isEqualToString:@""] == YES ) {
     free( settings->stereo_ay );
@@ -1612,7 +1683,13 @@ read_config_file( settings_info *settings )
     settings->svga_modes = NULL;
   } else
     settings_set_string( &settings->svga_modes, [[defaults stringForKey:@"svgamodes"] UTF8String] );
+  if( [[defaults stringForKey:@"taperecordfile"] isEqualToString:@""] == YES ) {
+    free( settings->tape_record_file );
+    settings->tape_record_file = NULL;
+  } else
+    settings_set_string( &settings->tape_record_file, [[defaults stringForKey:@"taperecordfile"] UTF8String] );
   settings->tape_traps = [defaults boolForKey:@"tapetraps"] ? 1 : 0;
+  settings->turbosound = [defaults boolForKey:@"turbosound"] ? 1 : 0;
   settings->unittests = [defaults boolForKey:@"unittests"] ? 1 : 0;
   settings->usource = [defaults boolForKey:@"usource"] ? 1 : 0;
   settings->volume_ay = [defaults integerForKey:@"volumeay"];
@@ -1755,9 +1832,17 @@ settings_write_config( settings_info *settings )
   value = settings->embed_snapshot ? YES : NO;
   [currentValues setObject:@(value) forKey:@"embedsnapshot"];
   [currentValues setObject:@(settings->emulation_speed) forKey:@"speed"];
+  value = settings->fast_forward ? YES : NO;
+  [currentValues setObject:@(value) forKey:@"fastforward"];
+  [currentValues setObject:@(settings->fast_forward_fps) forKey:@"fastforwardfps"];
+  [currentValues setObject:@(settings->fast_forward_frameskip) forKey:@"fastforwardframeskip"];
   value = settings->fastload ? YES : NO;
   [currentValues setObject:@(value) forKey:@"fastload"];
   [currentValues setObject:@(settings->fb_mode) forKey:@"fbmode"];
+  if( settings->file_index )
+    [currentValues setObject:@(settings->file_index) forKey:@"fileindex"];
+  else
+    [currentValues setObject:@"" forKey:@"fileindex"];
   [currentValues setObject:@(settings->frame_rate) forKey:@"rate"];
   value = settings->full_screen ? YES : NO;
   [currentValues setObject:@(value) forKey:@"fullscreen"];
@@ -1909,6 +1994,10 @@ settings_write_config( settings_info *settings )
     [currentValues setObject:@(settings->printer_text_filename) forKey:@"textfile"];
   else
     [currentValues setObject:@"" forKey:@"textfile"];
+  if( settings->quicksave_file )
+    [currentValues setObject:@(settings->quicksave_file) forKey:@"quicksavefile"];
+  else
+    [currentValues setObject:@"" forKey:@"quicksavefile"];
   value = settings->raw_s_net ? YES : NO;
   [currentValues setObject:@(value) forKey:@"rawsnet"];
 //  if( settings->cocoa && settings->cocoa->recent_snapshots )
@@ -1917,6 +2006,12 @@ settings_write_config( settings_info *settings )
     [currentValues setObject:[NSMutableArray array] forKey:@"recentsnapshots"];
   value = settings->recreated_spectrum ? YES : NO;
   [currentValues setObject:@(value) forKey:@"recreatedspectrum"];
+  if( settings->regress )
+    [currentValues setObject:@(settings->regress) forKey:@"regress"];
+  else
+    [currentValues setObject:@"" forKey:@"regress"];
+  value = settings->regress_update ? YES : NO;
+  [currentValues setObject:@(value) forKey:@"regressupdate"];
   if( settings->rom_128_0 )
     [currentValues setObject:@(settings->rom_128_0) forKey:@"rom1280"];
   else
@@ -2119,14 +2214,21 @@ settings_write_config( settings_info *settings )
     [currentValues setObject:@(settings->rs232_tx) forKey:@"rs232tx"];
   else
     [currentValues setObject:@"" forKey:@"rs232tx"];
+  [currentValues setObject:@(settings->run_ahead) forKey:@"runahead"];
   value = settings->rzx_autosaves ? YES : NO;
   [currentValues setObject:@(value) forKey:@"rzxautosaves"];
   value = settings->rzx_compression ? YES : NO;
   [currentValues setObject:@(value) forKey:@"compressrzx"];
+  value = settings->rzx_index ? YES : NO;
+  [currentValues setObject:@(value) forKey:@"rzxindex"];
+  value = settings->scanline_log ? YES : NO;
+  [currentValues setObject:@(value) forKey:@"scanlinelog"];
   value = settings->simpleide_active ? YES : NO;
   [currentValues setObject:@(value) forKey:@"simpleide"];
   value = settings->slt_traps ? YES : NO;
   [currentValues setObject:@(value) forKey:@"slttraps"];
+  value = settings->snapshot_compression ? YES : NO;
+  [currentValues setObject:@(value) forKey:@"compresssnapshot"];
   if( settings->snet )
     [currentValues setObject:@(settings->snet) forKey:@"snet"];
   else
@@ -2166,6 +2268,8 @@ settings_write_config( settings_info *settings )
     [currentValues setObject:@(settings->start_scaler_mode) forKey:@"graphicsfilter"];
   else
     [currentValues setObject:@"" forKey:@"graphicsfilter"];
+  value = settings->startup_trace ? YES : NO;
+  [currentValues setObject:@(value) forKey:@"startuptrace"];
   value = settings->statusbar ? YES : NO;
   [currentValues setObject:@(value) forKey:@"statusbar"];
   if( settings->stereo_ay )
@@ -2178,8 +2282,14 @@ settings_write_config( settings_info *settings )
     [currentValues setObject:@(settings->svga_modes) forKey:@"svgamodes"];
   else
     [currentValues setObject:@"" forKey:@"svgamodes"];
+  if( settings->tape_record_file )
+    [currentValues setObject:@(settings->tape_record_file) forKey:@"taperecordfile"];
+  else
+    [currentValues setObject:@"" forKey:@"taperecordfile"];
   value = settings->tape_traps ? YES : NO;
   [currentValues setObject:@(value) forKey:@"tapetraps"];
+  value = settings->turbosound ? YES : NO;
+  [currentValues setObject:@(value) forKey:@"turbosound"];
   value = settings->unittests ? YES : NO;
   [currentValues setObject:@(value) forKey:@"unittests"];
   value = settings->usource ? YES : NO;
@@ -2284,29 +2394,34 @@ settings_command_line( settings_info *settings, int *first_arg,
     {    "embed-snapshot", 0, &(settings->embed_snapshot), 1 },
     { "no-embed-snapshot", 0, &(settings->embed_snapshot), 0 },
     { "speed", 1, NULL, 282 },
+    {    "fast-forward", 0, &(settings->fast_forward), 1 },
+    { "no-fast-forward", 0, &(settings->fast_forward), 0 },
+    { "fast-forward-fps", 1, NULL, 283 },
+    { "fast-forward-frameskip", 1, NULL, 284 },
     {    "fastload", 0, &(settings->fastload), 1 },
     { "no-fastload", 0, &(settings->fastload), 0 },
     { "fbmode", 1, NULL, 'v' },
-    { "rate", 1, NULL, 283 },
+    { "file-index", 1, NULL, 285 },
+    { "rate", 1, NULL, 286 },
     {    "full-screen", 0, &(settings->full_screen), 1 },
     { "no-full-screen", 0, &(settings->full_screen), 0 },
     {    "full-screen-panorama", 0, &(settings->full_screen_panorama), 1 },
     { "no-full-screen-panorama", 0, &(settings->full_screen_panorama), 0 },
     {    "fuller", 0, &(settings->fuller), 1 },
     { "no-fuller", 0, &(settings->fuller), 0 },
-    { "if2cart", 1, NULL, 284 },
+    { "if2cart", 1, NULL, 287 },
     {    "interface1", 0, &(settings->interface1), 1 },
     { "no-interface1", 0, &(settings->interface1), 0 },
     {    "interface2", 0, &(settings->interface2), 1 },
     { "no-interface2", 0, &(settings->interface2), 0 },
     {    "issue2", 0, &(settings->issue2), 1 },
     { "no-issue2", 0, &(settings->issue2), 0 },
-    { "joy1num", 1, NULL, 285 },
-    { "joy1x", 1, NULL, 286 },
-    { "joy1y", 1, NULL, 287 },
-    { "joy2num", 1, NULL, 288 },
-    { "joy2x", 1, NULL, 289 },
-    { "joy2y", 1, NULL, 290 },
+    { "joy1num", 1, NULL, 288 },
+    { "joy1x", 1, NULL, 289 },
+    { "joy1y", 1, NULL, 290 },
+    { "joy2num", 1, NULL, 291 },
+    { "joy2x", 1, NULL, 292 },
+    { "joy2y", 1, NULL, 293 },
     {    "kempston", 0, &(settings->joy_kempston), 1 },
     { "no-kempston", 0, &(settings->joy_kempston), 0 },
     {    "keyboard", 0, &(settings->joy_keyboard), 1 },
@@ -2314,154 +2429,165 @@ settings_command_line( settings_info *settings, int *first_arg,
     {    "joyprompt", 0, &(settings->joy_prompt), 1 },
     { "no-joyprompt", 0, &(settings->joy_prompt), 0 },
     { "joystick-1", 1, NULL, 'j' },
-    { "joystick-1-fire-1", 1, NULL, 291 },
-    { "joystick-1-fire-10", 1, NULL, 292 },
-    { "joystick-1-fire-11", 1, NULL, 293 },
-    { "joystick-1-fire-12", 1, NULL, 294 },
-    { "joystick-1-fire-13", 1, NULL, 295 },
-    { "joystick-1-fire-14", 1, NULL, 296 },
-    { "joystick-1-fire-15", 1, NULL, 297 },
-    { "joystick-1-fire-2", 1, NULL, 298 },
-    { "joystick-1-fire-3", 1, NULL, 299 },
-    { "joystick-1-fire-4", 1, NULL, 300 },
-    { "joystick-1-fire-5", 1, NULL, 301 },
-    { "joystick-1-fire-6", 1, NULL, 302 },
-    { "joystick-1-fire-7", 1, NULL, 303 },
-    { "joystick-1-fire-8", 1, NULL, 304 },
-    { "joystick-1-fire-9", 1, NULL, 305 },
-    { "joystick-1-output", 1, NULL, 306 },
-    { "joystick-2", 1, NULL, 307 },
-    { "joystick-2-fire-1", 1, NULL, 308 },
-    { "joystick-2-fire-10", 1, NULL, 309 },
-    { "joystick-2-fire-11", 1, NULL, 310 },
-    { "joystick-2-fire-12", 1, NULL, 311 },
-    { "joystick-2-fire-13", 1, NULL, 312 },
-    { "joystick-2-fire-14", 1, NULL, 313 },
-    { "joystick-2-fire-15", 1, NULL, 314 },
-    { "joystick-2-fire-2", 1, NULL, 315 },
-    { "joystick-2-fire-3", 1, NULL, 316 },
-    { "joystick-2-fire-4", 1, NULL, 317 },
-    { "joystick-2-fire-5", 1, NULL, 318 },
-    { "joystick-2-fire-6", 1, NULL, 319 },
-    { "joystick-2-fire-7", 1, NULL, 320 },
-    { "joystick-2-fire-8", 1, NULL, 321 },
-    { "joystick-2-fire-9", 1, NULL, 322 },
-    { "joystick-2-output", 1, NULL, 323 },
-    { "joystick-keyboard-down", 1, NULL, 324 },
-    { "joystick-keyboard-fire", 1, NULL, 325 },
-    { "joystick-keyboard-left", 1, NULL, 326 },
-    { "joystick-keyboard-output", 1, NULL, 327 },
-    { "joystick-keyboard-right", 1, NULL, 328 },
-    { "joystick-keyboard-up", 1, NULL, 329 },
+    { "joystick-1-fire-1", 1, NULL, 294 },
+    { "joystick-1-fire-10", 1, NULL, 295 },
+    { "joystick-1-fire-11", 1, NULL, 296 },
+    { "joystick-1-fire-12", 1, NULL, 297 },
+    { "joystick-1-fire-13", 1, NULL, 298 },
+    { "joystick-1-fire-14", 1, NULL, 299 },
+    { "joystick-1-fire-15", 1, NULL, 300 },
+    { "joystick-1-fire-2", 1, NULL, 301 },
+    { "joystick-1-fire-3", 1, NULL, 302 },
+    { "joystick-1-fire-4", 1, NULL, 303 },
+    { "joystick-1-fire-5", 1, NULL, 304 },
+    { "joystick-1-fire-6", 1, NULL, 305 },
+    { "joystick-1-fire-7", 1, NULL, 306 },
+    { "joystick-1-fire-8", 1, NULL, 307 },
+    { "joystick-1-fire-9", 1, NULL, 308 },
+    { "joystick-1-output", 1, NULL, 309 },
+    { "joystick-2", 1, NULL, 310 },
+    { "joystick-2-fire-1", 1, NULL, 311 },
+    { "joystick-2-fire-10", 1, NULL, 312 },
+    { "joystick-2-fire-11", 1, NULL, 313 },
+    { "joystick-2-fire-12", 1, NULL, 314 },
+    { "joystick-2-fire-13", 1, NULL, 315 },
+    { "joystick-2-fire-14", 1, NULL, 316 },
+    { "joystick-2-fire-15", 1, NULL, 317 },
+    { "joystick-2-fire-2", 1, NULL, 318 },
+    { "joystick-2-fire-3", 1, NULL, 319 },
+    { "joystick-2-fire-4", 1, NULL, 320 },
+    { "joystick-2-fire-5", 1, NULL, 321 },
+    { "joystick-2-fire-6", 1, NULL, 322 },
+    { "joystick-2-fire-7", 1, NULL, 323 },
+    { "joystick-2-fire-8", 1, NULL, 324 },
+    { "joystick-2-fire-9", 1, NULL, 325 },
+    { "joystick-2-output", 1, NULL, 326 },
+    { "joystick-keyboard-down", 1, NULL, 327 },
+    { "joystick-keyboard-fire", 1, NULL, 328 },
+    { "joystick-keyboard-left", 1, NULL, 329 },
+    { "joystick-keyboard-output", 1, NULL, 330 },
+    { "joystick-keyboard-right", 1, NULL, 331 },
+    { "joystick-keyboard-up", 1, NULL, 332 },
     {    "kempston-mouse", 0, &(settings->kempston_mouse), 1 },
     { "no-kempston-mouse", 0, &(settings->kempston_mouse), 0 },
     {    "late-timings", 0, &(settings->late_timings), 1 },
     { "no-late-timings", 0, &(settings->late_timings), 0 },
-    { "microdrive-file", 1, NULL, 330 },
-    { "microdrive-2-file", 1, NULL, 331 },
-    { "microdrive-3-file", 1, NULL, 332 },
-    { "microdrive-4-file", 1, NULL, 333 },
-    { "microdrive-5-file", 1, NULL, 334 },
-    { "microdrive-6-file", 1, NULL, 335 },
-    { "microdrive-7-file", 1, NULL, 336 },
-    { "microdrive-8-file", 1, NULL, 337 },
-    { "mdr-len", 1, NULL, 338 },
+    { "microdrive-file", 1, NULL, 333 },
+    { "microdrive-2-file", 1, NULL, 334 },
+    { "microdrive-3-file", 1, NULL, 335 },
+    { "microdrive-4-file", 1, NULL, 336 },
+    { "microdrive-5-file", 1, NULL, 337 },
+    { "microdrive-6-file", 1, NULL, 338 },
+    { "microdrive-7-file", 1, NULL, 339 },
+    { "microdrive-8-file", 1, NULL, 340 },
+    { "mdr-len", 1, NULL, 341 },
     {    "mdr-random-len", 0, &(settings->mdr_random_len), 1 },
     { "no-mdr-random-len", 0, &(settings->mdr_random_len), 0 },
     {    "melodik", 0, &(settings->melodik), 1 },
     { "no-melodik", 0, &(settings->melodik), 0 },
     {    "mouse-swap-buttons", 0, &(settings->mouse_swap_buttons), 1 },
     { "no-mouse-swap-buttons", 0, &(settings->mouse_swap_buttons), 0 },
-    { "movie-compr", 1, NULL, 339 },
-    { "movie-start", 1, NULL, 340 },
+    { "movie-compr", 1, NULL, 342 },
+    { "movie-start", 1, NULL, 343 },
     {    "movie-stop-after-rzx", 0, &(settings->movie_stop_after_rzx), 1 },
     { "no-movie-stop-after-rzx", 0, &(settings->movie_stop_after_rzx), 0 },
     {    "opus", 0, &(settings->opus), 1 },
     { "no-opus", 0, &(settings->opus), 0 },
-    { "opusdisk", 1, NULL, 341 },
+    { "opusdisk", 1, NULL, 344 },
     {    "pal-tv2x", 0, &(settings->pal_tv2x), 1 },
     { "no-pal-tv2x", 0, &(settings->pal_tv2x), 0 },
     { "playback", 1, NULL, 'p' },
     {    "plus3-detect-speedlock", 0, &(settings->plus3_detect_speedlock), 1 },
     { "no-plus3-detect-speedlock", 0, &(settings->plus3_detect_speedlock), 0 },
-    { "plus3disk", 1, NULL, 342 },
+    { "plus3disk", 1, NULL, 345 },
     {    "plusd", 0, &(settings->plusd), 1 },
     { "no-plusd", 0, &(settings->plusd), 0 },
-    { "plusddisk", 1, NULL, 343 },
-    { "preferencestab", 1, NULL, 344 },
+    { "plusddisk", 1, NULL, 346 },
+    { "preferencestab", 1, NULL, 347 },
     {    "printer", 0, &(settings->printer), 1 },
     { "no-printer", 0, &(settings->printer), 0 },
-    { "graphicsfile", 1, NULL, 345 },
-    { "textfile", 1, NULL, 346 },
+    { "graphicsfile", 1, NULL, 348 },
+    { "textfile", 1, NULL, 349 },
+    { "quicksave-file", 1, NULL, 350 },
     {    "raw-s-net", 0, &(settings->raw_s_net), 1 },
     { "no-raw-s-net", 0, &(settings->raw_s_net), 0 },
     { "record", 1, NULL, 'r' },
     {    "recreated-spectrum", 0, &(settings->recreated_spectrum), 1 },
     { "no-recreated-spectrum", 0, &(settings->recreated_spectrum), 0 },
-    { "rom-128-0", 1, NULL, 349 },
-    { "rom-128-1", 1, NULL, 350 },
-    { "rom-16-0", 1, NULL, 351 },
-    { "rom-2048-0", 1, NULL, 352 },
-    { "rom-2068-0", 1, NULL, 353 },
-    { "rom-2068-1", 1, NULL, 354 },
-    { "rom-48-0", 1, NULL, 355 },
-    { "rom-beta128", 1, NULL, 356 },
-    { "rom-didaktik80", 1, NULL, 357 },
-    { "rom-disciple", 1, NULL, 358 },
-    { "rominterfacei", 1, NULL, 359 },
-    { "rom-opus", 1, NULL, 360 },
-    { "rom-pentagon1024-0", 1, NULL, 361 },
-    { "rom-pentagon1024-1", 1, NULL, 362 },
-    { "rom-pentagon1024-2", 1, NULL, 363 },
-    { "rom-pentagon1024-3", 1, NULL, 364 },
-    { "rom-pentagon512-0", 1, NULL, 365 },
-    { "rom-pentagon512-1", 1, NULL, 366 },
-    { "rom-pentagon512-2", 1, NULL, 367 },
-    { "rom-pentagon512-3", 1, NULL, 368 },
-    { "rom-pentagon-0", 1, NULL, 369 },
-    { "rom-pentagon-1", 1, NULL, 370 },
-    { "rom-pentagon-2", 1, NULL, 371 },
-    { "rom-plus2-0", 1, NULL, 372 },
-    { "rom-plus2-1", 1, NULL, 373 },
-    { "rom-plus2a-0", 1, NULL, 374 },
-    { "rom-plus2a-1", 1, NULL, 375 },
-    { "rom-plus2a-2", 1, NULL, 376 },
-    { "rom-plus2a-3", 1, NULL, 377 },
-    { "rom-plus3-0", 1, NULL, 378 },
-    { "rom-plus3-1", 1, NULL, 379 },
-    { "rom-plus3-2", 1, NULL, 380 },
-    { "rom-plus3-3", 1, NULL, 381 },
-    { "rom-plus3e-0", 1, NULL, 382 },
-    { "rom-plus3e-1", 1, NULL, 383 },
-    { "rom-plus3e-2", 1, NULL, 384 },
-    { "rom-plus3e-3", 1, NULL, 385 },
-    { "rom-plusd", 1, NULL, 386 },
-    { "rom-scorpion-0", 1, NULL, 387 },
-    { "rom-scorpion-1", 1, NULL, 388 },
-    { "rom-scorpion-2", 1, NULL, 389 },
-    { "rom-scorpion-3", 1, NULL, 390 },
-    { "rom-se-0", 1, NULL, 391 },
-    { "rom-se-1", 1, NULL, 392 },
-    { "rom-speccyboot", 1, NULL, 393 },
-    { "rom-ts2068-0", 1, NULL, 394 },
-    { "rom-ts2068-1", 1, NULL, 395 },
-    { "rom-usource", 1, NULL, 396 },
+    { "regress", 1, NULL, 353 },
+    {    "regress-update", 0, &(settings->regress_update), 1 },
+    { "no-regress-update", 0, &(settings->regress_update), 0 },
+    { "rom-128-0", 1, NULL, 354 },
+    { "rom-128-1", 1, NULL, 355 },
+    { "rom-16-0", 1, NULL, 356 },
+    { "rom-2048-0", 1, NULL, 357 },
+    { "rom-2068-0", 1, NULL, 358 },
+    { "rom-2068-1", 1, NULL, 359 },
+    { "rom-48-0", 1, NULL, 360 },
+    { "rom-beta128", 1, NULL, 361 },
+    { "rom-didaktik80", 1, NULL, 362 },
+    { "rom-disciple", 1, NULL, 363 },
+    { "rominterfacei", 1, NULL, 364 },
+    { "rom-opus", 1, NULL, 365 },
+    { "rom-pentagon1024-0", 1, NULL, 366 },
+    { "rom-pentagon1024-1", 1, NULL, 367 },
+    { "rom-pentagon1024-2", 1, NULL, 368 },
+    { "rom-pentagon1024-3", 1, NULL, 369 },
+    { "rom-pentagon512-0", 1, NULL, 370 },
+    { "rom-pentagon512-1", 1, NULL, 371 },
+    { "rom-pentagon512-2", 1, NULL, 372 },
+    { "rom-pentagon512-3", 1, NULL, 373 },
+    { "rom-pentagon-0", 1, NULL, 374 },
+    { "rom-pentagon-1", 1, NULL, 375 },
+    { "rom-pentagon-2", 1, NULL, 376 },
+    { "rom-plus2-0", 1, NULL, 377 },
+    { "rom-plus2-1", 1, NULL, 378 },
+    { "rom-plus2a-0", 1, NULL, 379 },
+    { "rom-plus2a-1", 1, NULL, 380 },
+    { "rom-plus2a-2", 1, NULL, 381 },
+    { "rom-plus2a-3", 1, NULL, 382 },
+    { "rom-plus3-0", 1, NULL, 383 },
+    { "rom-plus3-1", 1, NULL, 384 },
+    { "rom-plus3-2", 1, NULL, 385 },
+    { "rom-plus3-3", 1, NULL, 386 },
+    { "rom-plus3e-0", 1, NULL, 387 },
+    { "rom-plus3e-1", 1, NULL, 388 },
+    { "rom-plus3e-2", 1, NULL, 389 },
+    { "rom-plus3e-3", 1, NULL, 390 },
+    { "rom-plusd", 1, NULL, 391 },
+    { "rom-scorpion-0", 1, NULL, 392 },
+    { "rom-scorpion-1", 1, NULL, 393 },
+    { "rom-scorpion-2", 1, NULL, 394 },
+    { "rom-scorpion-3", 1, NULL, 395 },
+    { "rom-se-0", 1, NULL, 396 },
+    { "rom-se-1", 1, NULL, 397 },
+    { "rom-speccyboot", 1, NULL, 398 },
+    { "rom-ts2068-0", 1, NULL, 399 },
+    { "rom-ts2068-1", 1, NULL, 400 },
+    { "rom-usource", 1, NULL, 401 },
     {    "rs232-handshake", 0, &(settings->rs232_handshake), 1 },
     { "no-rs232-handshake", 0, &(settings->rs232_handshake), 0 },
-    { "rs232-rx", 1, NULL, 397 },
-    { "rs232-tx", 1, NULL, 398 },
+    { "rs232-rx", 1, NULL, 402 },
+    { "rs232-tx", 1, NULL, 403 },
+    { "run-ahead", 1, NULL, 404 },
     {    "rzx-autosaves", 0, &(settings->rzx_autosaves), 1 },
     { "no-rzx-autosaves", 0, &(settings->rzx_autosaves), 0 },
     {    "compress-rzx", 0, &(settings->rzx_compression), 1 },
     { "no-compress-rzx", 0, &(settings->rzx_compression), 0 },
+    {    "rzx-index", 0, &(settings->rzx_index), 1 },
+    { "no-rzx-index", 0, &(settings->rzx_index), 0 },
+    {    "scanline-log", 0, &(settings->scanline_log), 1 },
+    { "no-scanline-log", 0, &(settings->scanline_log), 0 },
     {    "simpleide", 0, &(settings->simpleide_active), 1 },
     { "no-simpleide", 0, &(settings->simpleide_active), 0 },
-    { "simpleide-masterfile", 1, NULL, 399 },
-    { "simpleide-slavefile", 1, NULL, 400 },
+    { "simpleide-masterfile", 1, NULL, 405 },
+    { "simpleide-slavefile", 1, NULL, 406 },
     {    "slt", 0, &(settings->slt_traps), 1 },
     { "no-slt", 0, &(settings->slt_traps), 0 },
     { "snapshot", 1, NULL, 's' },
-    { "snet", 1, NULL, 402 },
+    {    "compress-snapshot", 0, &(settings->snapshot_compression), 1 },
+    { "no-compress-snapshot", 0, &(settings->snapshot_compression), 0 },
+    { "snet", 1, NULL, 408 },
     {    "sound", 0, &(settings->sound), 1 },
     { "no-sound", 0, &(settings->sound), 0 },
     { "sound-device", 1, NULL, 'd' },
@@ -2470,10 +2596,10 @@ settings_command_line( settings_info *settings, int *first_arg,
     { "sound-freq", 1, NULL, 'f' },
     {    "sound-load", 0, &(settings->sound_load), 1 },
     { "no-sound-load", 0, &(settings->sound_load), 0 },
-    { "speaker-type", 1, NULL, 403 },
+    { "speaker-type", 1, NULL, 409 },
     {    "speccyboot", 0, &(settings->speccyboot), 1 },
     { "no-speccyboot", 0, &(settings->speccyboot), 0 },
-    { "speccyboot-tap", 1, NULL, 404 },
+    { "speccyboot-tap", 1, NULL, 410 },
     {    "specdrum", 0, &(settings->specdrum), 1 },
     { "no-specdrum", 0, &(settings->specdrum), 0 },
     {    "spectranet", 0, &(settings->spectranet), 1 },
@@ -2482,37 +2608,42 @@ settings_command_line( settings_info *settings, int *first_arg,
     { "no-spectranet-disable", 0, &(settings->spectranet_disable), 0 },
     { "machine", 1, NULL, 'm' },
     { "graphics-filter", 1, NULL, 'g' },
+    {    "startup-trace", 0, &(settings->startup_trace), 1 },
+    { "no-startup-trace", 0, &(settings->startup_trace), 0 },
     {    "statusbar", 0, &(settings->statusbar), 1 },
     { "no-statusbar", 0, &(settings->statusbar), 0 },
-    { "separation", 1, NULL, 405 },
+    { "separation", 1, NULL, 411 },
     {    "strict-aspect-hint", 0, &(settings->strict_aspect_hint), 1 },
     { "no-strict-aspect-hint", 0, &(settings->strict_aspect_hint), 0 },
-    { "svga-modes", 1, NULL, 406 },
+    { "svga-modes", 1, NULL, 412 },
     { "tape", 1, NULL, 't' },
+    { "tape-record-file", 1, NULL, 413 },
     {    "traps", 0, &(settings->tape_traps), 1 },
     { "no-traps", 0, &(settings->tape_traps), 0 },
+    {    "turbosound", 0, &(settings->turbosound), 1 },
+    { "no-turbosound", 0, &(settings->turbosound), 0 },
     {    "unittests", 0, &(settings->unittests), 1 },
     { "no-unittests", 0, &(settings->unittests), 0 },
     {    "usource", 0, &(settings->usource), 1 },
     { "no-usource", 0, &(settings->usource), 0 },
-    { "volume-ay", 1, NULL, 407 },
-    { "volume-beeper", 1, NULL, 408 },
-    { "volume-specdrum", 1, NULL, 409 },
+    { "volume-ay", 1, NULL, 414 },
+    { "volume-beeper", 1, NULL, 415 },
+    { "volume-specdrum", 1, NULL, 416 },
     {    "writable-roms", 0, &(settings->writable_roms), 1 },
     { "no-writable-roms", 0, &(settings->writable_roms), 0 },
     {    "z80-is-cmos", 0, &(settings->z80_is_cmos), 1 },
     { "no-z80-is-cmos", 0, &(settings->z80_is_cmos), 0 },
     {    "zxatasp", 0, &(settings->zxatasp_active), 1 },
     { "no-zxatasp", 0, &(settings->zxatasp_active), 0 },
-    { "zxatasp-masterfile", 1, NULL, 410 },
-    { "zxatasp-slavefile", 1, NULL, 411 },
+    { "zxatasp-masterfile", 1, NULL, 417 },
+    { "zxatasp-slavefile", 1, NULL, 418 },
     {    "zxatasp-upload", 0, &(settings->zxatasp_upload), 1 },
     { "no-zxatasp-upload", 0, &(settings->zxatasp_upload), 0 },
     {    "zxatasp-write-protect", 0, &(settings->zxatasp_wp), 1 },
     { "no-zxatasp-write-protect", 0, &(settings->zxatasp_wp), 0 },
     {    "zxcf", 0, &(settings->zxcf_active), 1 },
     { "no-zxcf", 0, &(settings->zxcf_active), 0 },
-    { "zxcf-cffile", 1, NULL, 412 },
+    { "zxcf-cffile", 1, NULL, 419 },
     {    "zxcf-upload", 0, &(settings->zxcf_upload), 1 },
     { "no-zxcf-upload", 0, &(settings->zxcf_upload), 0 },
     {    "zxprinter", 0, &(settings->zxprinter), 1 },
@@ -2569,143 +2700,150 @@ settings_command_line( settings_info *settings, int *first_arg,
     case 280: settings_set_string( &settings->drive_plusd1_type, optarg ); break;
     case 281: settings_set_string( &settings->drive_plusd2_type, optarg ); break;
     case 282: settings->emulation_speed = atoi( optarg ); break;
+    case 283: settings->fast_forward_fps = atoi( optarg ); break;
+    case 284: settings->fast_forward_frameskip = atoi( optarg ); break;
     case 'v': settings->fb_mode = atoi( optarg ); break;
-    case 283: settings->frame_rate = atoi( optarg ); break;
-    case 284: settings_set_string( &settings->if2_file, optarg ); break;
-    case 285: settings->joy1_number = atoi( optarg ); break;
-    case 286: settings->joy1_xaxis = atoi( optarg ); break;
-    case 287: settings->joy1_yaxis = atoi( optarg ); break;
-    case 288: settings->joy2_number = atoi( optarg ); break;
-    case 289: settings->joy2_xaxis = atoi( optarg ); break;
-    case 290: settings->joy2_yaxis = atoi( optarg ); break;
+    case 285: settings_set_string( &settings->file_index, optarg ); break;
+    case 286: settings->frame_rate = atoi( optarg ); break;
+    case 287: settings_set_string( &settings->if2_file, optarg ); break;
+    case 288: settings->joy1_number = atoi( optarg ); break;
+    case 289: settings->joy1_xaxis = atoi( optarg ); break;
+    case 290: settings->joy1_yaxis = atoi( optarg ); break;
+    case 291: settings->joy2_number = atoi( optarg ); break;
+    case 292: settings->joy2_xaxis = atoi( optarg ); break;
+    case 293: settings->joy2_yaxis = atoi( optarg ); break;
     case 'j': settings_set_string( &settings->joystick_1, optarg ); break;
-    case 291: settings->joystick_1_fire_1 = atoi( optarg ); break;
-    case 292: settings->joystick_1_fire_10 = atoi( optarg ); break;
-    case 293: settings->joystick_1_fire_11 = atoi( optarg ); break;
-    case 294: settings->joystick_1_fire_12 = atoi( optarg ); break;
-    case 295: settings->joystick_1_fire_13 = atoi( optarg ); break;
-    case 296: settings->joystick_1_fire_14 = atoi( optarg ); break;
-    case 297: settings->joystick_1_fire_15 = atoi( optarg ); break;
-    case 298: settings->joystick_1_fire_2 = atoi( optarg ); break;
-    case 299: settings->joystick_1_fire_3 = atoi( optarg ); break;
-    case 300: settings->joystick_1_fire_4 = atoi( optarg ); break;
-    case 301: settings->joystick_1_fire_5 = atoi( optarg ); break;
-    case 302: settings->joystick_1_fire_6 = atoi( optarg ); break;
-    case 303: settings->joystick_1_fire_7 = atoi( optarg ); break;
-    case 304: settings->joystick_1_fire_8 = atoi( optarg ); break;
-    case 305: settings->joystick_1_fire_9 = atoi( optarg ); break;
-    case 306: settings->joystick_1_output = atoi( optarg ); break;
-    case 307: settings_set_string( &settings->joystick_2, optarg ); break;
-    case 308: settings->joystick_2_fire_1 = atoi( optarg ); break;
-    case 309: settings->joystick_2_fire_10 = atoi( optarg ); break;
-    case 310: settings->joystick_2_fire_11 = atoi( optarg ); break;
-    case 311: settings->joystick_2_fire_12 = atoi( optarg ); break;
-    case 312: settings->joystick_2_fire_13 = atoi( optarg ); break;
-    case 313: settings->joystick_2_fire_14 = atoi( optarg ); break;
-    case 314: settings->joystick_2_fire_15 = atoi( optarg ); break;
-    case 315: settings->joystick_2_fire_2 = atoi( optarg ); break;
-    case 316: settings->joystick_2_fire_3 = atoi( optarg ); break;
-    case 317: settings->joystick_2_fire_4 = atoi( optarg ); break;
-    case 318: settings->joystick_2_fire_5 = atoi( optarg ); break;
-    case 319: settings->joystick_2_fire_6 = atoi( optarg ); break;
-    case 320: settings->joystick_2_fire_7 = atoi( optarg ); break;
-    case 321: settings->joystick_2_fire_8 = atoi( optarg ); break;
-    case 322: settings->joystick_2_fire_9 = atoi( optarg ); break;
-    case 323: settings->joystick_2_output = atoi( optarg ); break;
-    case 324: settings->joystick_keyboard_down = atoi( optarg ); break;
-    case 325: settings->joystick_keyboard_fire = atoi( optarg ); break;
-    case 326: settings->joystick_keyboard_left = atoi( optarg ); break;
-    case 327: settings->joystick_keyboard_output = atoi( optarg ); break;
-    case 328: settings->joystick_keyboard_right = atoi( optarg ); break;
-    case 329: settings->joystick_keyboard_up = atoi( optarg ); break;
-    case 330: settings_set_string( &settings->mdr_file, optarg ); break;
-    case 331: settings_set_string( &settings->mdr_file2, optarg ); break;
-    case 332: settings_set_string( &settings->mdr_file3, optarg ); break;
-    case 333: settings_set_string( &settings->mdr_file4, optarg ); break;
-    case 334: settings_set_string( &settings->mdr_file5, optarg ); break;
-    case 335: settings_set_string( &settings->mdr_file6, optarg ); break;
-    case 336: settings_set_string( &settings->mdr_file7, optarg ); break;
-    case 337: settings_set_string( &settings->mdr_file8, optarg ); break;
-    case 338: settings->mdr_len = atoi( optarg ); break;
-    case 339: settings_set_string( &settings->movie_compr, optarg ); break;
-    case 340: settings_set_string( &settings->movie_start, optarg ); break;
-    case 341: settings_set_string( &settings->opusdisk_file, optarg ); break;
+    case 294: settings->joystick_1_fire_1 = atoi( optarg ); break;
+    case 295: settings->joystick_1_fire_10 = atoi( optarg ); break;
+    case 296: settings->joystick_1_fire_11 = atoi( optarg ); break;
+    case 297: settings->joystick_1_fire_12 = atoi( optarg ); break;
+    case 298: settings->joystick_1_fire_13 = atoi( optarg ); break;
+    case 299: settings->joystick_1_fire_14 = atoi( optarg ); break;
+    case 300: settings->joystick_1_fire_15 = atoi( optarg ); break;
+    case 301: settings->joystick_1_fire_2 = atoi( optarg ); break;
+    case 302: settings->joystick_1_fire_3 = atoi( optarg ); break;
+    case 303: settings->joystick_1_fire_4 = atoi( optarg ); break;
+    case 304: settings->joystick_1_fire_5 = atoi( optarg ); break;
+    case 305: settings->joystick_1_fire_6 = atoi( optarg ); break;
+    case 306: settings->joystick_1_fire_7 = atoi( optarg ); break;
+    case 307: settings->joystick_1_fire_8 = atoi( optarg ); break;
+    case 308: settings->joystick_1_fire_9 = atoi( optarg ); break;
+    case 309: settings->joystick_1_output = atoi( optarg ); break;
+    case 310: settings_set_string( &settings->joystick_2, optarg ); break;
+    case 311: settings->joystick_2_fire_1 = atoi( optarg ); break;
+    case 312: settings->joystick_2_fire_10 = atoi( optarg ); break;
+    case 313: settings->joystick_2_fire_11 = atoi( optarg ); break;
+    case 314: settings->joystick_2_fire_12 = atoi( optarg ); break;
+    case 315: settings->joystick_2_fire_13 = atoi( optarg ); break;
+    case 316: settings->joystick_2_fire_14 = atoi( optarg ); break;
+    case 317: settings->joystick_2_fire_15 = atoi( optarg ); break;
+    case 318: settings->joystick_2_fire_2 = atoi( optarg ); break;
+    case 319: settings->joystick_2_fire_3 = atoi( optarg ); break;
+    case 320: settings->joystick_2_fire_4 = atoi( optarg ); break;
+    case 321: settings->joystick_2_fire_5 = atoi( optarg ); break;
+    case 322: settings->joystick_2_fire_6 = atoi( optarg ); break;
+    case 323: settings->joystick_2_fire_7 = atoi( optarg ); break;
+    case 324: settings->joystick_2_fire_8 = atoi( optarg ); break;
+    case 325: settings->joystick_2_fire_9 = atoi( optarg ); break;
+    case 326: settings->joystick_2_output = atoi( optarg ); break;
+    case 327: settings->joystick_keyboard_down = atoi( optarg ); break;
+    case 328: settings->joystick_keyboard_fire = atoi( optarg ); break;
+    case 329: settings->joystick_keyboard_left = atoi( optarg ); break;
+    case 330: settings->joystick_keyboard_output = atoi( optarg ); break;
+    case 331: settings->joystick_keyboard_right = atoi( optarg ); break;
+    case 332: settings->joystick_keyboard_up = atoi( optarg ); break;
+    case 333: settings_set_string( &settings->mdr_file, optarg ); break;
+    case 334: settings_set_string( &settings->mdr_file2, optarg ); break;
+    case 335: settings_set_string( &settings->mdr_file3, optarg ); break;
+    case 336: settings_set_string( &settings->mdr_file4, optarg ); break;
+    case 337: settings_set_string( &settings->mdr_file5, optarg ); break;
+    case 338: settings_set_string( &settings->mdr_file6, optarg ); break;
+    case 339: settings_set_string( &settings->mdr_file7, optarg ); break;
+    case 340: settings_set_string( &settings->mdr_file8, optarg ); break;
+    case 341: settings->mdr_len = atoi( optarg ); break;
+    case 342: settings_set_string( &settings->movie_compr, optarg ); break;
+    case 343: settings_set_string( &settings->movie_start, optarg ); break;
+    case 344: settings_set_string( &settings->opusdisk_file, optarg ); break;
     case 'p': settings_set_string( &settings->playback_file, optarg ); break;
-    case 342: settings_set_string( &settings->plus3disk_file, optarg ); break;
-    case 343: settings_set_string( &settings->plusddisk_file, optarg ); break;
-    case 344: settings->preferences_tab = atoi( optarg ); break;
-    case 345: settings_set_string( &settings->printer_graphics_filename, optarg ); break;
-    case 346: settings_set_string( &settings->printer_text_filename, optarg ); break;
+    case 345: settings_set_string( &settings->plus3disk_file, optarg ); break;
+    case 346: settings_set_string( &settings->plusddisk_file, optarg ); break;
+    case 347: settings->preferences_tab = atoi( optarg ); break;
+    case 348: settings_set_string( &settings->printer_graphics_filename, optarg ); break;
+    case 349: settings_set_string( &settings->printer_text_filename, optarg ); break;
+    case 350: settings_set_string( &settings->quicksave_file, optarg ); break;
     case 'r': settings_set_string( &settings->record_file, optarg ); break;
-    case 349: settings_set_string( &settings->rom_128_0, optarg ); break;
-    case 350: settings_set_string( &settings->rom_128_1, optarg ); break;
-    case 351: settings_set_string( &settings->rom_16_0, optarg ); break;
-    case 352: settings_set_string( &settings->rom_2048_0, optarg ); break;
-    case 353: settings_set_string( &settings->rom_2068_0, optarg ); break;
-    case 354: settings_set_string( &settings->rom_2068_1, optarg ); break;
-    case 355: settings_set_string( &settings->rom_48_0, optarg ); break;
-    case 356: settings_set_string( &settings->rom_beta128, optarg ); break;
-    case 357: settings_set_string( &settings->rom_didaktik80, optarg ); break;
-    case 358: settings_set_string( &settings->rom_disciple, optarg ); break;
-    case 359: settings_set_string( &settings->rom_interface1, optarg ); break;
-    case 360: settings_set_string( &settings->rom_opus, optarg ); break;
-    case 361: settings_set_string( &settings->rom_pentagon1024_0, optarg ); break;
-    case 362: settings_set_string( &settings->rom_pentagon1024_1, optarg ); break;
-    case 363: settings_set_string( &settings->rom_pentagon1024_2, optarg ); break;
-    case 364: settings_set_string( &settings->rom_pentagon1024_3, optarg ); break;
-    case 365: settings_set_string( &settings->rom_pentagon512_0, optarg ); break;
-    case 366: settings_set_string( &settings->rom_pentagon512_1, optarg ); break;
-    case 367: settings_set_string( &settings->rom_pentagon512_2, optarg ); break;
-    case 368: settings_set_string( &settings->rom_pentagon512_3, optarg ); break;
-    case 369: settings_set_string( &settings->rom_pentagon_0, optarg ); break;
-    case 370: settings_set_string( &settings->rom_pentagon_1, optarg ); break;
-    case 371: settings_set_string( &settings->rom_pentagon_2, optarg ); break;
-    case 372: settings_set_string( &settings->rom_plus2_0, optarg ); break;
-    case 373: settings_set_string( &settings->rom_plus2_1, optarg ); break;
-    case 374: settings_set_string( &settings->rom_plus2a_0, optarg ); break;
-    case 375: settings_set_string( &settings->rom_plus2a_1, optarg ); break;
-    case 376: settings_set_string( &settings->rom_plus2a_2, optarg ); break;
-    case 377: settings_set_string( &settings->rom_plus2a_3, optarg ); break;
-    case 378: settings_set_string( &settings->rom_plus3_0, optarg ); break;
-    case 379: settings_set_string( &settings->rom_plus3_1, optarg ); break;
-    case 380: settings_set_string( &settings->rom_plus3_2, optarg ); break;
-    case 381: settings_set_string( &settings->rom_plus3_3, optarg ); break;
-    case 382: settings_set_string( &settings->rom_plus3e_0, optarg ); break;
-    case 383: settings_set_string( &settings->rom_plus3e_1, optarg ); break;
-    case 384: settings_set_string( &settings->rom_plus3e_2, optarg ); break;
-    case 385: settings_set_string( &settings->rom_plus3e_3, optarg ); break;
-    case 386: settings_set_string( &settings->rom_plusd, optarg ); break;
-    case 387: settings_set_string( &settings->rom_scorpion_0, optarg ); break;
-    case 388: settings_set_string( &settings->rom_scorpion_1, optarg ); break;
-    case 389: settings_set_string( &settings->rom_scorpion_2, optarg ); break;
-    case 390: settings_set_string( &settings->rom_scorpion_3, optarg ); break;
-    case 391: settings_set_string( &settings->rom_se_0, optarg ); break;
-    case 392: settings_set_string( &settings->rom_se_1, optarg ); break;
-    case 393: settings_set_string( &settings->rom_speccyboot, optarg ); break;
-    case 394: settings_set_string( &settings->rom_ts2068_0, optarg ); break;
-    case 395: settings_set_string( &settings->rom_ts2068_1, optarg ); break;
-    case 396: settings_set_string( &settings->rom_usource, optarg ); break;
-    case 397: settings_set_string( &settings->rs232_rx, optarg ); break;
-    case 398: settings_set_string( &settings->rs232_tx, optarg ); break;
-    case 399: settings_set_string( &settings->simpleide_master_file, optarg ); break;
-    case 400: settings_set_string( &settings->simpleide_slave_file, optarg ); break;
+    case 353: settings_set_string( &settings->regress, optarg ); break;
+    case 354: settings_set_string( &settings->rom_128_0, optarg ); break;
+    case 355: settings_set_string( &settings->rom_128_1, optarg ); break;
+    case 356: settings_set_string( &settings->rom_16_0, optarg ); break;
+    case 357: settings_set_string( &settings->rom_2048_0, optarg ); break;
+    case 358: settings_set_string( &settings->rom_2068_0, optarg ); break;
+    case 359: settings_set_string( &settings->rom_2068_1, optarg ); break;
+    case 360: settings_set_string( &settings->rom_48_0, optarg ); break;
+    case 361: settings_set_string( &settings->rom_beta128, optarg ); break;
+    case 362: settings_set_string( &settings->rom_didaktik80, optarg ); break;
+    case 363: settings_set_string( &settings->rom_disciple, optarg ); break;
+    case 364: settings_set_string( &settings->rom_interface1, optarg ); break;
+    case 365: settings_set_string( &settings->rom_opus, optarg ); break;
+    case 366: settings_set_string( &settings->rom_pentagon1024_0, optarg ); break;
+    case 367: settings_set_string( &settings->rom_pentagon1024_1, optarg ); break;
+    case 368: settings_set_string( &settings->rom_pentagon1024_2, optarg ); break;
+    case 369: settings_set_string( &settings->rom_pentagon1024_3, optarg ); break;
+    case 370: settings_set_string( &settings->rom_pentagon512_0, optarg ); break;
+    case 371: settings_set_string( &settings->rom_pentagon512_1, optarg ); break;
+    case 372: settings_set_string( &settings->rom_pentagon512_2, optarg ); break;
+    case 373: settings_set_string( &settings->rom_pentagon512_3, optarg ); break;
+    case 374: settings_set_string( &settings->rom_pentagon_0, optarg ); break;
+    case 375: settings_set_string( &settings->rom_pentagon_1, optarg ); break;
+    case 376: settings_set_string( &settings->rom_pentagon_2, optarg ); break;
+    case 377: settings_set_string( &settings->rom_plus2_0, optarg ); break;
+    case 378: settings_set_string( &settings->rom_plus2_1, optarg ); break;
+    case 379: settings_set_string( &settings->rom_plus2a_0, optarg ); break;
+    case 380: settings_set_string( &settings->rom_plus2a_1, optarg ); break;
+    case 381: settings_set_string( &settings->rom_plus2a_2, optarg ); break;
+    case 382: settings_set_string( &settings->rom_plus2a_3, optarg ); break;
+    case 383: settings_set_string( &settings->rom_plus3_0, optarg ); break;
+    case 384: settings_set_string( &settings->rom_plus3_1, optarg ); break;
+    case 385: settings_set_string( &settings->rom_plus3_2, optarg ); break;
+    case 386: settings_set_string( &settings->rom_plus3_3, optarg ); break;
+    case 387: settings_set_string( &settings->rom_plus3e_0, optarg ); break;
+    case 388: settings_set_string( &settings->rom_plus3e_1, optarg ); break;
+    case 389: settings_set_string( &settings->rom_plus3e_2, optarg ); break;
+    case 390: settings_set_string( &settings->rom_plus3e_3, optarg ); break;
+    case 391: settings_set_string( &settings->rom_plusd, optarg ); break;
+    case 392: settings_set_string( &settings->rom_scorpion_0, optarg ); break;
+    case 393: settings_set_string( &settings->rom_scorpion_1, optarg ); break;
+    case 394: settings_set_string( &settings->rom_scorpion_2, optarg ); break;
+    case 395: settings_set_string( &settings->rom_scorpion_3, optarg ); break;
+    case 396: settings_set_string( &settings->rom_se_0, optarg ); break;
+    case 397: settings_set_string( &settings->rom_se_1, optarg ); break;
+    case 398: settings_set_string( &settings->rom_speccyboot, optarg ); break;
+    case 399: settings_set_string( &settings->rom_ts2068_0, optarg ); break;
+    case 400: settings_set_string( &settings->rom_ts2068_1, optarg ); break;
+    case 401: settings_set_string( &settings->rom_usource, optarg ); break;
+    case 402: settings_set_string( &settings->rs232_rx, optarg ); break;
+    case 403: settings_set_string( &settings->rs232_tx, optarg ); break;
+    case 404: settings->run_ahead = atoi( optarg ); break;
+    case 405: settings_set_string( &settings->simpleide_master_file, optarg ); break;
+    case 406: settings_set_string( &settings->simpleide_slave_file, optarg ); break;
     case 's': settings_set_string( &settings->snapshot, optarg ); break;
-    case 402: settings_set_string( &settings->snet, optarg ); break;
+    case 408: settings_set_string( &settings->snet, optarg ); break;
     case 'd': settings_set_string( &settings->sound_device, optarg ); break;
     case 'f': settings->sound_freq = atoi( optarg ); break;
-    case 403: settings_set_string( &settings->speaker_type, optarg ); break;
-    case 404: settings_set_string( &settings->speccyboot_tap, optarg ); break;
+    case 409: settings_set_string( &settings->speaker_type, optarg ); break;
+    case 410: settings_set_string( &settings->speccyboot_tap, optarg ); break;
     case 'm': settings_set_string( &settings->start_machine, optarg ); break;
     case 'g': settings_set_string( &settings->start_scaler_mode, optarg ); break;
-    case 405: settings_set_string( &settings->stereo_ay, optarg ); break;
-    case 406: settings_set_string( &settings->svga_modes, optarg ); break;
+    case 411: settings_set_string( &settings->stereo_ay, optarg ); break;
+    case 412: settings_set_string( &settings->svga_modes, optarg ); break;
     case 't': settings_set_string( &settings->tape_file, optarg ); break;
-    case 407: settings->volume_ay = atoi( optarg ); break;
-    case 408: settings->volume_beeper = atoi( optarg ); break;
-    case 409: settings->volume_specdrum = atoi( optarg ); break;
-    case 410: settings_set_string( &settings->zxatasp_master_file, optarg ); break;
-    case 411: settings_set_string( &settings->zxatasp_slave_file, optarg ); break;
-    case 412: settings_set_string( &settings->zxcf_pri_file, optarg ); break;
+    case 413: settings_set_string( &settings->tape_record_file, optarg ); break;
+    case 414: settings->volume_ay = atoi( optarg ); break;
+    case 415: settings->volume_beeper = atoi( optarg ); break;
+    case 416: settings->volume_specdrum = atoi( optarg ); break;
+    case 417: settings_set_string( &settings->zxatasp_master_file, optarg ); break;
+    case 418: settings_set_string( &settings->zxatasp_slave_file, optarg ); break;
+    case 419: settings_set_string( &settings->zxcf_pri_file, optarg ); break;
 
     case 'h': settings->show_help = 1; break;
     case 'V': settings->show_version = 1; break;
@@ -2846,8 +2984,15 @@ settings_copy_internal( settings_info *dest, settings_info *src )
   }
   dest->embed_snapshot = src->embed_snapshot;
   dest->emulation_speed = src->emulation_speed;
+  dest->fast_forward = src->fast_forward;
+  dest->fast_forward_fps = src->fast_forward_fps;
+  dest->fast_forward_frameskip = src->fast_forward_frameskip;
   dest->fastload = src->fastload;
   dest->fb_mode = src->fb_mode;
+  dest->file_index = NULL;
+  if( src->file_index ) {
+    dest->file_index = utils_safe_strdup( src->file_index );
+  }
   dest->frame_rate = src->frame_rate;
   dest->full_screen = src->full_screen;
   dest->full_screen_panorama = src->full_screen_panorama;
@@ -2991,6 +3136,10 @@ settings_copy_internal( settings_info *dest, settings_info *src )
   if( src->printer_text_filename ) {
     dest->printer_text_filename = utils_safe_strdup( src->printer_text_filename );
   }
+  dest->quicksave_file = NULL;
+  if( src->quicksave_file ) {
+    dest->quicksave_file = utils_safe_strdup( src->quicksave_file );
+  }
   dest->raw_s_net = src->raw_s_net;
 //  if( src->cocoa && src->cocoa->recent_snapshots ) {
 //    dest->cocoa->recent_snapshots = [NSMutableArray arrayWithArray:src->cocoa->recent_snapshots];
@@ -3003,6 +3152,11 @@ settings_copy_internal( settings_info *dest, settings_info *src )
     dest->record_file = utils_safe_strdup( src->record_file );
   }
   dest->recreated_spectrum = src->recreated_spectrum;
+  dest->regress = NULL;
+  if( src->regress ) {
+    dest->regress = utils_safe_strdup( src->regress );
+  }
+  dest->regress_update = src->regress_update;
   dest->rom_128_0 = NULL;
   if( src->rom_128_0 ) {
     dest->rom_128_0 = utils_safe_strdup( src->rom_128_0 );
@@ -3204,8 +3358,11 @@ settings_copy_internal( settings_info *dest, settings_info *src )
   if( src->rs232_tx ) {
     dest->rs232_tx = utils_safe_strdup( src->rs232_tx );
   }
+  dest->run_ahead = src->run_ahead;
   dest->rzx_autosaves = src->rzx_autosaves;
   dest->rzx_compression = src->rzx_compression;
+  dest->rzx_index = src->rzx_index;
+  dest->scanline_log = src->scanline_log;
   dest->simpleide_active = src->simpleide_active;
   dest->simpleide_master_file = NULL;
   if( src->simpleide_master_file ) {
@@ -3220,6 +3377,7 @@ settings_copy_internal( settings_info *dest, settings_info *src )
   if( src->snapshot ) {
     dest->snapshot = utils_safe_strdup( src->snapshot );
   }
+  dest->snapshot_compression = src->snapshot_compression;
   dest->snet = NULL;
   if( src->snet ) {
     dest->snet = utils_safe_strdup( src->snet );
@@ -3252,6 +3410,7 @@ settings_copy_internal( settings_info *dest, settings_info *src )
   if( src->start_scaler_mode ) {
     dest->start_scaler_mode = utils_safe_strdup( src->start_scaler_mode );
   }
+  dest->startup_trace = src->startup_trace;
   dest->statusbar = src->statusbar;
   dest->stereo_ay = NULL;
   if( src->stereo_ay ) {
@@ -3266,7 +3425,12 @@ settings_copy_internal( settings_info *dest, settings_info *src )
   if( src->tape_file ) {
     dest->tape_file = utils_safe_strdup( src->tape_file );
   }
+  dest->tape_record_file = NULL;
+  if( src->tape_record_file ) {
+    dest->tape_record_file = utils_safe_strdup( src->tape_record_file );
+  }
   dest->tape_traps = src->tape_traps;
+  dest->turbosound = src->turbosound;
   dest->unittests = src->unittests;
   dest->usource = src->usource;
   dest->volume_ay = src->volume_ay;
@@ -3385,6 +3549,10 @@ settings_free( settings_info *settings )
     free( settings->drive_plusd2_type );
     settings->drive_plusd2_type = NULL;
   }
+  if( settings->file_index ) {
+    free( settings->file_index );
+    settings->file_index = NULL;
+  }
   if( settings->if2_file ) {
     free( settings->if2_file );
     settings->if2_file = NULL;
@@ -3461,6 +3629,10 @@ settings_free( settings_info *settings )
     free( settings->printer_text_filename );
     settings->printer_text_filename = NULL;
   }
+  if( settings->quicksave_file ) {
+    free( settings->quicksave_file );
+    settings->quicksave_file = NULL;
+  }
 //  if( settings->cocoa && settings->cocoa->recent_snapshots ) {
 //    settings->cocoa->recent_snapshots = nil;
 //  }
@@ -3468,6 +3640,10 @@ settings_free( settings_info *settings )
     free( settings->record_file );
     settings->record_file = NULL;
   }
+  if( settings->regress ) {
+    free( settings->regress );
+    settings->regress = NULL;
+  }
   if( settings->rom_128_0 ) {
     free( settings->rom_128_0 );
     settings->rom_128_0 = NULL;
@@ -3716,6 +3892,10 @@ settings_free( settings_info *settings )
     free( settings->tape_file );
     settings->tape_file = NULL;
   }
+  if( settings->tape_record_file ) {
+    free( settings->tape_record_file );
+    settings->tape_record_file = NULL;
+  }
   if( settings->zxatasp_master_file ) {
     free( settings->zxatasp_master_file );
     settings->zxatasp_master_file = NULL;
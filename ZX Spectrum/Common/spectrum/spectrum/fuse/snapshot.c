@@ -33,51 +33,82 @@
 #include "module.h"
 #include "settings.h"
 #include "snapshot.h"
+#include "spectrum.h"
 #include "ui.h"
 #include "utils.h"
 
-int snapshot_read( const char *filename )
+/* Let a snap being written use our RAM pages directly rather than copies
+   of them, so the .szx writer compresses straight from RAM; only for snaps
+   which are freed as soon as they have been written */
+static void
+snapshot_use_ram( libspectrum_snap *snap )
+{
+  libspectrum_snap_set_page_buffer( snap, RAM[0] );
+  libspectrum_snap_set_page_buffer_pages( snap, SPECTRUM_RAM_PAGES );
+}
+
+/* Give a snap being read one block of scratch pages for the .szx reader to
+   inflate into. Not RAM itself: the running machine must be left alone if
+   the snapshot turns out to be bad */
+static libspectrum_byte*
+snapshot_use_scratch( libspectrum_snap *snap )
+{
+  libspectrum_byte *pages =
+    libspectrum_new( libspectrum_byte, SPECTRUM_RAM_PAGES * 0x4000 );
+
+  libspectrum_snap_set_page_buffer( snap, pages );
+  libspectrum_snap_set_page_buffer_pages( snap, SPECTRUM_RAM_PAGES );
+
+  return pages;
+}
+
+static int
+snapshot_read_buffer_named( const unsigned char *buffer, size_t length,
+                            libspectrum_id_t type, const char *filename )
 {
-  utils_file file;
   libspectrum_snap *snap = libspectrum_snap_alloc();
+  libspectrum_byte *pages = snapshot_use_scratch( snap );
   int error;
 
-  error = utils_read_file( filename, &file );
-  if( error ) { libspectrum_snap_free( snap ); return error; }
-
-  error = libspectrum_snap_read( snap, file.buffer, file.length,
-				 LIBSPECTRUM_ID_UNKNOWN, filename );
+  error = libspectrum_snap_read( snap, buffer, length, type, filename );
   if( error ) {
-    utils_close_file( &file ); libspectrum_snap_free( snap );
+    libspectrum_snap_free( snap ); libspectrum_free( pages );
     return error;
   }
 
-  utils_close_file( &file );
-
   error = snapshot_copy_from( snap );
-  if( error ) { libspectrum_snap_free( snap ); return error; }
+  if( error ) {
+    libspectrum_snap_free( snap ); libspectrum_free( pages );
+    return error;
+  }
 
-  error = libspectrum_snap_free( snap ); if( error ) return error;
+  error = libspectrum_snap_free( snap );
+  libspectrum_free( pages );
 
-  return 0;
+  return error;
 }
 
-int
-snapshot_read_buffer( const unsigned char *buffer, size_t length,
-		      libspectrum_id_t type )
+int snapshot_read( const char *filename )
 {
-  libspectrum_snap *snap = libspectrum_snap_alloc();
+  utils_file file;
   int error;
 
-  error = libspectrum_snap_read( snap, buffer, length, type, NULL );
-  if( error ) { libspectrum_snap_free( snap ); return error; }
-    
-  error = snapshot_copy_from( snap );
-  if( error ) { libspectrum_snap_free( snap ); return error; }
+  error = utils_read_file( filename, &file );
+  if( error ) return error;
 
-  error = libspectrum_snap_free( snap ); if( error ) return error;
+  error = snapshot_read_buffer_named( file.buffer, file.length,
+                                      LIBSPECTRUM_ID_UNKNOWN, filename );
 
-  return 0;
+  utils_close_file( &file );
+
+  return error;
+}
+
+int
+snapshot_read_buffer( const unsigned char *buffer, size_t length,
+		      libspectrum_id_t type )
+{
+  return snapshot_read_buffer_named( buffer, length, type, NULL );
 }
 
 int
@@ -133,14 +164,19 @@ int snapshot_write( const char *filename )
 
   snap = libspectrum_snap_alloc();
 
+  snapshot_use_ram( snap );
+
   error = snapshot_copy_to( snap );
   if( error ) { libspectrum_snap_free( snap ); return error; }
 
   flags = 0;
   length = 0;
   buffer = NULL;
-  error = libspectrum_snap_write( &buffer, &length, &flags, snap, type,
-				  fuse_creator, 0 );
+  error = libspectrum_snap_write(
+    &buffer, &length, &flags, snap, type, fuse_creator,
+    settings_current.snapshot_compression ?
+      0 : LIBSPECTRUM_FLAG_SNAPSHOT_NO_COMPRESSION
+  );
   if( error ) { libspectrum_snap_free( snap ); return error; }
 
   if( flags & LIBSPECTRUM_FLAG_SNAPSHOT_MAJOR_INFO_LOSS ) {
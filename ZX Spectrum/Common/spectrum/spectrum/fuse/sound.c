@@ -30,6 +30,10 @@
 
 #include "config.h"
 
+#include <stdio.h>
+#include <string.h>
+
+#include "ay.h"
 #include "fuse.h"
 #include "startup_manager.h"
 #include "machine.h"
@@ -37,6 +41,7 @@
 #include "options.h"
 #include "settings.h"
 #include "sound.h"
+#include "spectrum.h"
 #include "tape.h"
 #include "ui.h"
 #include "blipbuffer.h"
@@ -58,11 +63,12 @@ int sound_stereo_ay = SOUND_STEREO_AY_NONE; /* local copy of settings_current.st
 #define AMPL_TAPE		( 2 * 256 )
 #define AMPL_AY_TONE		( 24 * 256 )	/* three of these */
 
-/* max. number of sub-frame AY port writes allowed;
- * given the number of port writes theoretically possible in a
- * 50th I think this should be plenty.
+/* Initial size of each chip's log of sub-frame AY port writes. The log
+ * grows as needed and is kept from one frame to the next, so after the
+ * first few frames of even the busiest sample player no more memory is
+ * allocated.
  */
-#define AY_CHANGE_MAX		8000
+#define AY_CHANGE_INITIAL	1024
 
 int sound_framesiz;
 
@@ -70,22 +76,37 @@ static int sound_channels;
 
 static unsigned int ay_tone_levels[16];
 
-static unsigned int ay_tone_tick[3], ay_tone_high[3], ay_noise_tick;
-static unsigned int ay_tone_cycles, ay_env_cycles;
-static unsigned int ay_env_internal_tick, ay_env_tick;
-static unsigned int ay_tone_period[3], ay_noise_period, ay_env_period;
-
-/* Local copy of the AY registers */
-static libspectrum_byte sound_ay_registers[16];
-
 struct ay_change_tag
 {
   libspectrum_dword tstates;
   unsigned char reg, val;
 };
 
-static struct ay_change_tag ay_change[ AY_CHANGE_MAX ];
-static int ay_change_count;
+/* Everything we need to know about one AY chip */
+typedef struct sound_ay_chip {
+
+  unsigned int tone_tick[3], tone_high[3], noise_tick;
+  unsigned int tone_cycles, env_cycles;
+  unsigned int env_internal_tick, env_tick;
+  unsigned int tone_period[3], noise_period, env_period;
+
+  int rng, noise_toggle;
+  int env_first, env_rev, env_counter;
+
+  /* Local copy of the AY registers */
+  libspectrum_byte registers[16];
+
+  /* Writes made during the current frame */
+  struct ay_change_tag *change;
+  size_t change_count, change_size;
+
+  /* Channels A, B and C; the _r versions are only used for the middle
+     channel in stereo */
+  Blip_Synth *synth[3], *synth_r[3];
+
+} sound_ay_chip;
+
+static sound_ay_chip ay_chips[ SOUND_AY_CHIPS ];
 
 Blip_Buffer *left_buf = NULL;
 Blip_Buffer *right_buf = NULL;
@@ -93,9 +114,6 @@ blip_sample_t *samples = NULL;
 
 Blip_Synth *left_beeper_synth = NULL, *right_beeper_synth = NULL;
 
-Blip_Synth *ay_a_synth = NULL, *ay_b_synth = NULL, *ay_c_synth = NULL;
-Blip_Synth *ay_a_synth_r = NULL, *ay_b_synth_r = NULL, *ay_c_synth_r = NULL;
-
 Blip_Synth *left_specdrum_synth = NULL, *right_specdrum_synth = NULL;
 
 struct speaker_type_tag
@@ -163,19 +181,40 @@ sound_ay_init( void )
     0x2B4C, 0x43C1, 0x5A4B, 0x732F,
     0x9204, 0xAFF1, 0xD921, 0xFFFF
   };
-  int f;
+  sound_ay_chip *chip;
+  int f, i;
 
   /* scale the values down to fit */
   for( f = 0; f < 16; f++ )
     ay_tone_levels[f] = ( levels[f] * AMPL_AY_TONE + 0x8000 ) / 0xffff;
 
-  ay_noise_tick = ay_noise_period = 0;
-  ay_env_internal_tick = ay_env_tick = ay_env_period = 0;
-  ay_tone_cycles = ay_env_cycles = 0;
-  for( f = 0; f < 3; f++ )
-    ay_tone_tick[f] = ay_tone_high[f] = 0, ay_tone_period[f] = 1;
+  for( i = 0; i < SOUND_AY_CHIPS; i++ ) {
+    chip = &ay_chips[i];
+
+    chip->noise_tick = chip->noise_period = 0;
+    chip->env_internal_tick = chip->env_tick = chip->env_period = 0;
+    chip->tone_cycles = chip->env_cycles = 0;
+    for( f = 0; f < 3; f++ )
+      chip->tone_tick[f] = chip->tone_high[f] = 0, chip->tone_period[f] = 1;
 
-  ay_change_count = 0;
+    chip->rng = 1;
+    chip->noise_toggle = 0;
+    chip->env_first = 1; chip->env_rev = 0; chip->env_counter = 15;
+
+    chip->change_count = 0;
+  }
+}
+
+static Blip_Synth *
+sound_ay_synth( Blip_Buffer *buf, double treble )
+{
+  Blip_Synth *synth = new_Blip_Synth();
+
+  blip_synth_set_volume( synth, sound_get_volume( settings_current.volume_ay ) );
+  blip_synth_set_output( synth, buf );
+  blip_synth_set_treble_eq( synth, treble );
+
+  return synth;
 }
 
 void
@@ -183,10 +222,9 @@ sound_init( const char *device )
 {
   float hz;
   double treble;
-  Blip_Synth **ay_left_synth;
-  Blip_Synth **ay_mid_synth;
-  Blip_Synth **ay_mid_synth_r;
-  Blip_Synth **ay_right_synth;
+  int ay_mid, ay_right;
+  sound_ay_chip *chip;
+  int i, g;
 
   /* Allow sound as long as emulation speed is greater than 2%
      (less than that and a single Speccy frame generates more
@@ -196,6 +234,9 @@ sound_init( const char *device )
          settings_current.emulation_speed > 1 ) )
     return;
 
+  /* No sound while fast-forwarding */
+  if( spectrum_fast_forward_active() ) return;
+
   /* only try for stereo if we need it */
   sound_stereo_ay = option_enumerate_sound_stereo_ay();
 
@@ -211,18 +252,6 @@ sound_init( const char *device )
 
   treble = speaker_type[ option_enumerate_sound_speaker_type() ].treble;
 
-  ay_a_synth = new_Blip_Synth();
-  blip_synth_set_volume( ay_a_synth, sound_get_volume( settings_current.volume_ay) );
-  blip_synth_set_treble_eq( ay_a_synth, treble );
-
-  ay_b_synth = new_Blip_Synth();
-  blip_synth_set_volume( ay_b_synth, sound_get_volume( settings_current.volume_ay) );
-  blip_synth_set_treble_eq( ay_b_synth, treble );
-
-  ay_c_synth = new_Blip_Synth();
-  blip_synth_set_volume( ay_c_synth, sound_get_volume( settings_current.volume_ay) );
-  blip_synth_set_treble_eq( ay_c_synth, treble );
-
   left_specdrum_synth = new_Blip_Synth();
   blip_synth_set_volume( left_specdrum_synth, sound_get_volume( settings_current.volume_specdrum ) );
   blip_synth_set_output( left_specdrum_synth, left_buf );
@@ -234,46 +263,38 @@ sound_init( const char *device )
    * rather than using the real ones).
    */
 
-  ay_a_synth_r = NULL;
-  ay_b_synth_r = NULL;
-  ay_c_synth_r = NULL;
+  if( sound_stereo_ay == SOUND_STEREO_AY_ACB ) {
+    ay_mid = 2; ay_right = 1;
+  } else if ( sound_stereo_ay == SOUND_STEREO_AY_ABC ) {
+    ay_mid = 1; ay_right = 2;
+  } else if ( sound_stereo_ay == SOUND_STEREO_AY_NONE ) {
+    ay_mid = ay_right = 0;
+  } else {
+    ui_error( UI_ERROR_ERROR, "unknown AY stereo separation type: %d", sound_stereo_ay );
+    fuse_abort();
+  }
 
-  if( sound_stereo_ay != SOUND_STEREO_AY_NONE ) {
-    /* Attach the Blip_Synth's we've already created as appropriate, and
-     * create one more Blip_Synth for the middle channel's right buffer. */
-    if( sound_stereo_ay == SOUND_STEREO_AY_ACB ) {
-      ay_left_synth = &ay_a_synth;
-      ay_mid_synth = &ay_c_synth;
-      ay_mid_synth_r = &ay_c_synth_r;
-      ay_right_synth = &ay_b_synth;
-    } else if ( sound_stereo_ay == SOUND_STEREO_AY_ABC ) {
-      ay_left_synth = &ay_a_synth;
-      ay_mid_synth = &ay_b_synth;
-      ay_mid_synth_r = &ay_b_synth_r;
-      ay_right_synth = &ay_c_synth;
-    } else {
-      ui_error( UI_ERROR_ERROR, "unknown AY stereo separation type: %d", sound_stereo_ay );
-      fuse_abort();
-    }
+  /* Every chip gets the same stereo separation; the middle channel has
+   * one more Blip_Synth for the right buffer. */
+  for( i = 0; i < SOUND_AY_CHIPS; i++ ) {
+    chip = &ay_chips[i];
 
-    blip_synth_set_output( *ay_left_synth, left_buf );
-    blip_synth_set_output( *ay_mid_synth, left_buf );
-    blip_synth_set_output( *ay_right_synth, right_buf );
+    for( g = 0; g < 3; g++ ) {
+      chip->synth[g] = sound_ay_synth( left_buf, treble );
+      chip->synth_r[g] = NULL;
+    }
 
-    *ay_mid_synth_r = new_Blip_Synth();
-    blip_synth_set_volume( *ay_mid_synth_r,
-                           sound_get_volume( settings_current.volume_ay ) );
-    blip_synth_set_output( *ay_mid_synth_r, right_buf );
-    blip_synth_set_treble_eq( *ay_mid_synth_r, treble );
+    if( sound_stereo_ay != SOUND_STEREO_AY_NONE ) {
+      blip_synth_set_output( chip->synth[ ay_right ], right_buf );
+      chip->synth_r[ ay_mid ] = sound_ay_synth( right_buf, treble );
+    }
+  }
 
+  if( sound_stereo_ay != SOUND_STEREO_AY_NONE ) {
     right_specdrum_synth = new_Blip_Synth();
     blip_synth_set_volume( right_specdrum_synth, sound_get_volume( settings_current.volume_specdrum ) );
     blip_synth_set_output( right_specdrum_synth, right_buf );
     blip_synth_set_treble_eq( right_specdrum_synth, treble );
-  } else {
-    blip_synth_set_output( ay_a_synth, left_buf );
-    blip_synth_set_output( ay_b_synth, left_buf );
-    blip_synth_set_output( ay_c_synth, left_buf );
   }
 
   sound_enabled = sound_enabled_ever = 1;
@@ -316,16 +337,21 @@ sound_unpause( void )
 void
 sound_end( void )
 {
+  int i, g;
+
   if( sound_enabled ) {
     delete_Blip_Synth( &left_beeper_synth );
     delete_Blip_Synth( &right_beeper_synth );
 
-    delete_Blip_Synth( &ay_a_synth );
-    delete_Blip_Synth( &ay_b_synth );
-    delete_Blip_Synth( &ay_c_synth );
-    delete_Blip_Synth( &ay_a_synth_r );
-    delete_Blip_Synth( &ay_b_synth_r );
-    delete_Blip_Synth( &ay_c_synth_r );
+    for( i = 0; i < SOUND_AY_CHIPS; i++ ) {
+      for( g = 0; g < 3; g++ ) {
+        delete_Blip_Synth( &ay_chips[i].synth[g] );
+        delete_Blip_Synth( &ay_chips[i].synth_r[g] );
+      }
+      libspectrum_free( ay_chips[i].change );
+      ay_chips[i].change = NULL;
+      ay_chips[i].change_count = ay_chips[i].change_size = 0;
+    }
 
     delete_Blip_Synth( &left_specdrum_synth );
     delete_Blip_Synth( &right_specdrum_synth );
@@ -349,19 +375,20 @@ sound_register_startup( void )
 }
 
 static inline void
-ay_do_tone( int level, unsigned int tone_count, int *var, int chan )
+ay_do_tone( sound_ay_chip *chip, int level, unsigned int tone_count, int *var,
+            int chan )
 {
   *var = 0;
 
-  ay_tone_tick[ chan ] += tone_count;
+  chip->tone_tick[ chan ] += tone_count;
 
-  if( ay_tone_tick[ chan ] >= ay_tone_period[ chan ] ) {
-    ay_tone_tick[ chan ] -= ay_tone_period[ chan ];
-    ay_tone_high[ chan ] = !ay_tone_high[ chan ];
+  if( chip->tone_tick[ chan ] >= chip->tone_period[ chan ] ) {
+    chip->tone_tick[ chan ] -= chip->tone_period[ chan ];
+    chip->tone_high[ chan ] = !chip->tone_high[ chan ];
   }
 
   if( level ) {
-    if( ay_tone_high[ chan ] )
+    if( chip->tone_high[ chan ] )
       *var = level;
     else {
       *var = 0;
@@ -382,130 +409,140 @@ ay_do_tone( int level, unsigned int tone_count, int *var, int chan )
    master clock by 2 to drive the AY */
 #define AY_CLOCK_RATIO 2
 
+/* How many AY chips are making sound at the moment */
+static int
+sound_ay_chips_active( void )
+{
+  /* If no AY chip, don't produce any AY sound (!) */
+  if( !( periph_is_active( PERIPH_TYPE_FULLER) ||
+         periph_is_active( PERIPH_TYPE_MELODIK ) ||
+         machine_current->capabilities & LIBSPECTRUM_MACHINE_CAPABILITY_AY ) )
+    return 0;
+
+  return ay_turbosound_active() ? SOUND_AY_CHIPS : 1;
+}
+
 static void
-sound_ay_overlay( void )
+sound_ay_set_register( sound_ay_chip *chip, int reg, int val )
+{
+  int r;
+
+  chip->registers[ reg ] = val;
+
+  /* fix things as needed for some register changes */
+  switch ( reg ) {
+  case 0: case 1: case 2: case 3: case 4: case 5:
+    r = reg >> 1;
+    /* a zero-len period is the same as 1 */
+    chip->tone_period[r] = ( chip->registers[ reg & ~1 ] |
+                             ( chip->registers[ reg | 1 ] & 15 ) << 8 );
+    if( !chip->tone_period[r] )
+      chip->tone_period[r]++;
+
+    /* important to get this right, otherwise e.g. Ghouls 'n' Ghosts
+     * has really scratchy, horrible-sounding vibrato.
+     */
+    if( chip->tone_tick[r] >= chip->tone_period[r] * 2 )
+      chip->tone_tick[r] %= chip->tone_period[r] * 2;
+    break;
+  case 6:
+    chip->noise_tick = 0;
+    chip->noise_period = ( chip->registers[ reg ] & 31 );
+    break;
+  case 11: case 12:
+    chip->env_period = chip->registers[11] | ( chip->registers[12] << 8 );
+    break;
+  case 13:
+    chip->env_internal_tick = chip->env_tick = chip->env_cycles = 0;
+    chip->env_first = 1;
+    chip->env_rev = 0;
+    chip->env_counter = ( chip->registers[13] & AY_ENV_ATTACK ) ? 0 : 15;
+    break;
+  }
+}
+
+static void
+sound_ay_overlay( sound_ay_chip *chip )
 {
-  static int rng = 1;
-  static int noise_toggle = 0;
-  static int env_first = 1, env_rev = 0, env_counter = 15;
   int tone_level[3];
   int mixer, envshape;
   int g, level;
   libspectrum_dword f;
-  struct ay_change_tag *change_ptr = ay_change;
-  int changes_left = ay_change_count;
-  int reg, r;
+  struct ay_change_tag *change_ptr = chip->change;
+  size_t changes_left = chip->change_count;
   int chan1, chan2, chan3;
   int last_chan1 = 0, last_chan2 = 0, last_chan3 = 0;
   unsigned int tone_count, noise_count;
 
-  /* If no AY chip, don't produce any AY sound (!) */
-  if( !( periph_is_active( PERIPH_TYPE_FULLER) ||
-         periph_is_active( PERIPH_TYPE_MELODIK ) ||
-         machine_current->capabilities & LIBSPECTRUM_MACHINE_CAPABILITY_AY ) )
-    return;
-
   for( f = 0; f < machine_current->timings.tstates_per_frame;
        f+= AY_CLOCK_DIVISOR * AY_CLOCK_RATIO ) {
     /* update ay registers. */
     while( changes_left && f >= change_ptr->tstates ) {
-      sound_ay_registers[ reg = change_ptr->reg ] = change_ptr->val;
+      sound_ay_set_register( chip, change_ptr->reg, change_ptr->val );
       change_ptr++;
       changes_left--;
-
-      /* fix things as needed for some register changes */
-      switch ( reg ) {
-      case 0: case 1: case 2: case 3: case 4: case 5:
-        r = reg >> 1;
-        /* a zero-len period is the same as 1 */
-        ay_tone_period[r] = ( sound_ay_registers[ reg & ~1 ] |
-                              ( sound_ay_registers[ reg | 1 ] & 15 ) << 8 );
-        if( !ay_tone_period[r] )
-          ay_tone_period[r]++;
-
-        /* important to get this right, otherwise e.g. Ghouls 'n' Ghosts
-         * has really scratchy, horrible-sounding vibrato.
-         */
-        if( ay_tone_tick[r] >= ay_tone_period[r] * 2 )
-          ay_tone_tick[r] %= ay_tone_period[r] * 2;
-        break;
-      case 6:
-        ay_noise_tick = 0;
-        ay_noise_period = ( sound_ay_registers[ reg ] & 31 );
-        break;
-      case 11: case 12:
-        ay_env_period =
-          sound_ay_registers[11] | ( sound_ay_registers[12] << 8 );
-        break;
-      case 13:
-        ay_env_internal_tick = ay_env_tick = ay_env_cycles = 0;
-        env_first = 1;
-        env_rev = 0;
-        env_counter = ( sound_ay_registers[13] & AY_ENV_ATTACK ) ? 0 : 15;
-        break;
-      }
     }
 
     /* the tone level if no enveloping is being used */
     for( g = 0; g < 3; g++ )
-      tone_level[g] = ay_tone_levels[ sound_ay_registers[ 8 + g ] & 15 ];
+      tone_level[g] = ay_tone_levels[ chip->registers[ 8 + g ] & 15 ];
 
     /* envelope */
-    envshape = sound_ay_registers[13];
-    level = ay_tone_levels[ env_counter ];
+    envshape = chip->registers[13];
+    level = ay_tone_levels[ chip->env_counter ];
 
     for( g = 0; g < 3; g++ )
-      if( sound_ay_registers[ 8 + g ] & 16 )
+      if( chip->registers[ 8 + g ] & 16 )
         tone_level[g] = level;
 
     /* envelope output counter gets incr'd every 16 AY cycles. */
-    ay_env_cycles += AY_CLOCK_DIVISOR;
+    chip->env_cycles += AY_CLOCK_DIVISOR;
     noise_count = 0;
-    while( ay_env_cycles >= 16 ) {
-      ay_env_cycles -= 16;
+    while( chip->env_cycles >= 16 ) {
+      chip->env_cycles -= 16;
       noise_count++;
-      ay_env_tick++;
-      while( ay_env_tick >= ay_env_period ) {
-        ay_env_tick -= ay_env_period;
+      chip->env_tick++;
+      while( chip->env_tick >= chip->env_period ) {
+        chip->env_tick -= chip->env_period;
 
         /* do a 1/16th-of-period incr/decr if needed */
-        if( env_first ||
+        if( chip->env_first ||
             ( ( envshape & AY_ENV_CONT ) && !( envshape & AY_ENV_HOLD ) ) ) {
-          if( env_rev )
-            env_counter -= ( envshape & AY_ENV_ATTACK ) ? 1 : -1;
+          if( chip->env_rev )
+            chip->env_counter -= ( envshape & AY_ENV_ATTACK ) ? 1 : -1;
           else
-            env_counter += ( envshape & AY_ENV_ATTACK ) ? 1 : -1;
-          if( env_counter < 0 )
-            env_counter = 0;
-          if( env_counter > 15 )
-            env_counter = 15;
+            chip->env_counter += ( envshape & AY_ENV_ATTACK ) ? 1 : -1;
+          if( chip->env_counter < 0 )
+            chip->env_counter = 0;
+          if( chip->env_counter > 15 )
+            chip->env_counter = 15;
         }
 
-        ay_env_internal_tick++;
-        while( ay_env_internal_tick >= 16 ) {
-          ay_env_internal_tick -= 16;
+        chip->env_internal_tick++;
+        while( chip->env_internal_tick >= 16 ) {
+          chip->env_internal_tick -= 16;
 
           /* end of cycle */
           if( !( envshape & AY_ENV_CONT ) )
-            env_counter = 0;
+            chip->env_counter = 0;
           else {
             if( envshape & AY_ENV_HOLD ) {
-              if( env_first && ( envshape & AY_ENV_ALT ) )
-                env_counter = ( env_counter ? 0 : 15 );
+              if( chip->env_first && ( envshape & AY_ENV_ALT ) )
+                chip->env_counter = ( chip->env_counter ? 0 : 15 );
             } else {
               /* non-hold */
               if( envshape & AY_ENV_ALT )
-                env_rev = !env_rev;
+                chip->env_rev = !chip->env_rev;
               else
-                env_counter = ( envshape & AY_ENV_ATTACK ) ? 0 : 15;
+                chip->env_counter = ( envshape & AY_ENV_ATTACK ) ? 0 : 15;
             }
           }
 
-          env_first = 0;
+          chip->env_first = 0;
         }
 
         /* don't keep trying if period is zero */
-        if( !ay_env_period )
+        if( !chip->env_period )
           break;
       }
     }
@@ -518,84 +555,105 @@ sound_ay_overlay( void )
     chan1 = tone_level[0];
     chan2 = tone_level[1];
     chan3 = tone_level[2];
-    mixer = sound_ay_registers[7];
+    mixer = chip->registers[7];
 
-    ay_tone_cycles += AY_CLOCK_DIVISOR;
-    tone_count = ay_tone_cycles >> 3;
-    ay_tone_cycles &= 7;
+    chip->tone_cycles += AY_CLOCK_DIVISOR;
+    tone_count = chip->tone_cycles >> 3;
+    chip->tone_cycles &= 7;
 
     if( ( mixer & 1 ) == 0 ) {
       level = chan1;
-      ay_do_tone( level, tone_count, &chan1, 0 );
+      ay_do_tone( chip, level, tone_count, &chan1, 0 );
     }
-    if( ( mixer & 0x08 ) == 0 && noise_toggle )
+    if( ( mixer & 0x08 ) == 0 && chip->noise_toggle )
       chan1 = 0;
 
     if( ( mixer & 2 ) == 0 ) {
       level = chan2;
-      ay_do_tone( level, tone_count, &chan2, 1 );
+      ay_do_tone( chip, level, tone_count, &chan2, 1 );
     }
-    if( ( mixer & 0x10 ) == 0 && noise_toggle )
+    if( ( mixer & 0x10 ) == 0 && chip->noise_toggle )
       chan2 = 0;
 
     if( ( mixer & 4 ) == 0 ) {
       level = chan3;
-      ay_do_tone( level, tone_count, &chan3, 2 );
+      ay_do_tone( chip, level, tone_count, &chan3, 2 );
     }
-    if( ( mixer & 0x20 ) == 0 && noise_toggle )
+    if( ( mixer & 0x20 ) == 0 && chip->noise_toggle )
       chan3 = 0;
 
     if( last_chan1 != chan1 ) {
-      blip_synth_update( ay_a_synth, f, chan1 );
-      if( ay_a_synth_r ) blip_synth_update( ay_a_synth_r, f, chan1 );
+      blip_synth_update( chip->synth[0], f, chan1 );
+      if( chip->synth_r[0] ) blip_synth_update( chip->synth_r[0], f, chan1 );
       last_chan1 = chan1;
     }
     if( last_chan2 != chan2 ) {
-      blip_synth_update( ay_b_synth, f, chan2 );
-      if( ay_b_synth_r ) blip_synth_update( ay_b_synth_r, f, chan2 );
+      blip_synth_update( chip->synth[1], f, chan2 );
+      if( chip->synth_r[1] ) blip_synth_update( chip->synth_r[1], f, chan2 );
       last_chan2 = chan2;
     }
     if( last_chan3 != chan3 ) {
-      blip_synth_update( ay_c_synth, f, chan3 );
-      if( ay_c_synth_r ) blip_synth_update( ay_c_synth_r, f, chan3 );
+      blip_synth_update( chip->synth[2], f, chan3 );
+      if( chip->synth_r[2] ) blip_synth_update( chip->synth_r[2], f, chan3 );
       last_chan3 = chan3;
     }
 
     /* update noise RNG/filter */
-    ay_noise_tick += noise_count;
-    while( ay_noise_tick >= ay_noise_period ) {
-      ay_noise_tick -= ay_noise_period;
+    chip->noise_tick += noise_count;
+    while( chip->noise_tick >= chip->noise_period ) {
+      chip->noise_tick -= chip->noise_period;
 
-      if( ( rng & 1 ) ^ ( ( rng & 2 ) ? 1 : 0 ) )
-        noise_toggle = !noise_toggle;
+      if( ( chip->rng & 1 ) ^ ( ( chip->rng & 2 ) ? 1 : 0 ) )
+        chip->noise_toggle = !chip->noise_toggle;
 
       /* rng is 17-bit shift reg, bit 0 is output.
        * input is bit 0 xor bit 3.
        */
-      if( rng & 1 ) {
-        rng ^= 0x24000;
+      if( chip->rng & 1 ) {
+        chip->rng ^= 0x24000;
       }
-      rng >>= 1;
+      chip->rng >>= 1;
 
       /* don't keep trying if period is zero */
-      if( !ay_noise_period )
+      if( !chip->noise_period )
         break;
     }
   }
+
+  /* Writes made after the end of the frame still have to take effect */
+  for( ; changes_left; changes_left--, change_ptr++ )
+    sound_ay_set_register( chip, change_ptr->reg, change_ptr->val );
+
+  chip->change_count = 0;
 }
 
 /* don't make the change immediately; record it for later,
  * to be made by sound_frame() (via sound_ay_overlay()).
  */
-void
-sound_ay_write( int reg, int val, libspectrum_dword now )
+static void
+sound_ay_log( sound_ay_chip *chip, int reg, int val, libspectrum_dword now )
 {
-  if( ay_change_count < AY_CHANGE_MAX ) {
-    ay_change[ ay_change_count ].tstates = now;
-    ay_change[ ay_change_count ].reg = ( reg & 15 );
-    ay_change[ ay_change_count ].val = val;
-    ay_change_count++;
+  struct ay_change_tag *change;
+
+  if( chip->change_count == chip->change_size ) {
+    chip->change_size = chip->change_size ? chip->change_size * 2 :
+                                            AY_CHANGE_INITIAL;
+    chip->change = libspectrum_renew( struct ay_change_tag, chip->change,
+                                      chip->change_size );
   }
+
+  change = &chip->change[ chip->change_count++ ];
+  change->tstates = now;
+  change->reg = ( reg & 15 );
+  change->val = val;
+}
+
+void
+sound_ay_write( int chip, int reg, int val, libspectrum_dword now )
+{
+  if( !sound_enabled ) return;
+
+  sound_ay_log( &ay_chips[ chip ], reg, val, now );
 }
 
 /* no need to call this initially, but should be called
@@ -604,17 +662,14 @@ sound_ay_write( int reg, int val, libspectrum_dword now )
 void
 sound_ay_reset( void )
 {
-  int f;
+  int f, i;
 
   /* recalculate timings based on new machines ay clock */
   sound_ay_init();
 
-  ay_change_count = 0;
-  for( f = 0; f < 16; f++ )
-    sound_ay_write( f, 0, 0 );
-  for( f = 0; f < 3; f++ )
-    ay_tone_high[f] = 0;
-  ay_tone_cycles = ay_env_cycles = 0;
+  for( i = 0; i < SOUND_AY_CHIPS; i++ )
+    for( f = 0; f < 16; f++ )
+      sound_ay_write( i, f, 0, 0 );
 }
 
 /*
@@ -625,9 +680,11 @@ void
 sound_specdrum_write( libspectrum_word port GCC_UNUSED, libspectrum_byte val )
 {
   if( periph_is_active( PERIPH_TYPE_SPECDRUM ) ) {
-    blip_synth_update( left_specdrum_synth, tstates, ( val - 128) * 128);
-    if( right_specdrum_synth ) {
-      blip_synth_update( right_specdrum_synth, tstates, ( val - 128) * 128);
+    if( sound_enabled ) {
+      blip_synth_update( left_specdrum_synth, tstates, ( val - 128) * 128);
+      if( right_specdrum_synth ) {
+        blip_synth_update( right_specdrum_synth, tstates, ( val - 128) * 128);
+      }
     }
     machine_current->specdrum.specdrum_dac = val - 128;
   }
@@ -637,12 +694,19 @@ void
 sound_frame( void )
 {
   long count;
+  int i, chips;
 
   if( !sound_enabled )
     return;
 
   /* overlay AY sound */
-  sound_ay_overlay();
+  chips = sound_ay_chips_active();
+  for( i = 0; i < SOUND_AY_CHIPS; i++ ) {
+    if( i < chips )
+      sound_ay_overlay( &ay_chips[i] );
+    else
+      ay_chips[i].change_count = 0;
+  }
 
   blip_buffer_end_frame( left_buf, machine_current->timings.tstates_per_frame );
 
@@ -663,7 +727,6 @@ sound_frame( void )
 
   if( movie_recording )
       movie_add_sound( samples, count );
-  ay_change_count = 0;
 }
 
 void
@@ -690,3 +753,54 @@ sound_beeper( libspectrum_dword at_tstates, int on )
   if( sound_stereo_ay != SOUND_STEREO_AY_NONE )
     blip_synth_update( right_beeper_synth, at_tstates, val );
 }
+
+/* A sample player writing all three volume registers on both chips every
+   16 tstates; nothing may be lost, and the second frame must reuse the
+   memory allocated for the first */
+int
+sound_unittest( void )
+{
+  sound_ay_chip chips[ SOUND_AY_CHIPS ];
+  struct ay_change_tag *change;
+  libspectrum_dword t;
+  size_t size, writes;
+  int frame, i, r = 0;
+
+  memset( chips, 0, sizeof( chips ) );
+
+  for( frame = 0; frame < 2; frame++ ) {
+    for( i = 0; i < SOUND_AY_CHIPS; i++ ) {
+      change = chips[i].change;
+      size = chips[i].change_size;
+      writes = 0;
+
+      for( t = 0; t < 70908; t += 16, writes += 3 ) {
+        sound_ay_log( &chips[i], 8, ( t >> 4 ) & 15, t );
+        sound_ay_log( &chips[i], 9, ( t >> 5 ) & 15, t + 4 );
+        sound_ay_log( &chips[i], 10, ( t >> 6 ) & 15, t + 8 );
+      }
+
+      if( chips[i].change_count != writes ) {
+        printf( "%s: chip %d logged %lu of %lu AY writes\n", __func__, i,
+                (unsigned long)chips[i].change_count, (unsigned long)writes );
+        r = 1;
+      } else if( chips[i].change[ writes - 1 ].reg != 10 ||
+                 chips[i].change[ writes - 1 ].val != ( ( t - 16 ) >> 6 ) % 16 ) {
+        printf( "%s: chip %d logged the wrong final AY write\n", __func__, i );
+        r = 1;
+      }
+
+      if( frame && ( chips[i].change != change ||
+                     chips[i].change_size != size ) ) {
+        printf( "%s: chip %d reallocated its AY log\n", __func__, i );
+        r = 1;
+      }
+
+      chips[i].change_count = 0;
+    }
+  }
+
+  for( i = 0; i < SOUND_AY_CHIPS; i++ ) libspectrum_free( chips[i].change );
+
+  return r;
+}
@@ -29,19 +29,24 @@
 
 #include "libspectrum.h"
 
+/* The most AY chips we ever emulate at once: two for TurboSound */
+#define SOUND_AY_CHIPS 2
+
 void sound_register_startup( void );
 
 void sound_init( const char *device );
 void sound_pause( void );
 void sound_unpause( void );
 void sound_end( void );
-void sound_ay_write( int reg, int val, libspectrum_dword now );
+void sound_ay_write( int chip, int reg, int val, libspectrum_dword now );
 void sound_ay_reset( void );
 void sound_specdrum_write( libspectrum_word port, libspectrum_byte val );
 void sound_frame( void );
 void sound_beeper( libspectrum_dword at_tstates, int on );
 libspectrum_dword sound_get_effective_processor_speed( void );
 
+int sound_unittest( void );
+
 extern int sound_enabled;
 extern int sound_framesiz;
 
@@ -31,15 +31,20 @@
 #include "debugger.h"
 #include "display.h"
 #include "event.h"
+#include "fuse.h"
+#include "heatmap.h"
 #include "keyboard.h"
 #include "startup_manager.h"
 #include "loader.h"
 #include "machine.h"
 #include "memory.h"
+#include "module.h"
+#include "periph.h"
 #include "printer.h"
 #include "psg.h"
 #include "profile.h"
 #include "rzx.h"
+#include "rzx_index.h"
 #include "settings.h"
 #include "sound.h"
 #include "spectrum.h"
@@ -63,6 +68,19 @@ static int contention_pattern_76543210[] = { 5, 4, 3, 2, 1, 0, 7, 6 };
 /* Event */
 int spectrum_frame_event;
 
+/* The most frames we will run ahead of the displayed frame */
+#define SPECTRUM_RUN_AHEAD_MAX 8
+
+/* The core state saved while running ahead */
+static module_state run_ahead_state;
+
+static void spectrum_run_ahead( void );
+
+/* Counts the frames since the last one drawn while fast-forwarding */
+static int fast_forward_frames = 0;
+
+static void spectrum_fast_forward( void );
+
 static void
 spectrum_frame_event_fn( libspectrum_dword last_tstates, int type,
 			 void *user_data )
@@ -78,12 +96,20 @@ spectrum_do_frame_end( void )
   psg_frame();
   spectrum_frame();
   z80_interrupt();
-  ui_joystick_poll();
+  if( !ui_headless ) ui_joystick_poll();
   timer_estimate_speed();
   debugger_add_time_events();
-  ui_event();
+  if( !ui_headless ) ui_event();
   ui_error_frame();
   event_frame_end = 0;
+  if( rzx_playback ) rzx_index_frame();
+
+  if( spectrum_fast_forward_active() ) {
+    spectrum_fast_forward();
+  } else {
+    fast_forward_frames = 0;
+    spectrum_run_ahead();
+  }
 }
 
 static int
@@ -95,6 +121,12 @@ spectrum_init( void *context )
   return 0;
 }
 
+static void
+spectrum_end( void )
+{
+  module_state_free( &run_ahead_state );
+}
+
 void
 spectrum_register_startup( void )
 {
@@ -104,7 +136,7 @@ spectrum_register_startup( void )
   };
   startup_manager_register( STARTUP_MANAGER_MODULE_SPECTRUM, dependencies,
                             ARRAY_SIZE( dependencies ), spectrum_init, NULL, 
-                            NULL );
+                            spectrum_end );
 }
 
 int
@@ -128,6 +160,8 @@ spectrum_frame( void )
 
   if( display_frame() ) return 1;
   if( profile_active ) profile_frame( frame_length );
+  if( heatmap_active ) heatmap_frame();
+  if( tape_recording ) tape_record_frame( frame_length );
   printer_frame();
 
   /* Add an interrupt unless they're being generated by .rzx playback */
@@ -294,3 +328,212 @@ spectrum_do_timer( libspectrum_dword target_tstates )
     }
   }
 }
+
+int
+spectrum_fast_forward_active( void )
+{
+  return settings_current.fast_forward ||
+         ( settings_current.fastload && tape_is_playing() );
+}
+
+int
+spectrum_fast_forward_fps( void )
+{
+  return settings_current.fast_forward && settings_current.fast_forward_fps > 0 ?
+         settings_current.fast_forward_fps : 0;
+}
+
+void
+spectrum_set_fast_forward( int fast_forward )
+{
+  settings_current.fast_forward = fast_forward;
+
+  /* Sound is off while fast-forwarding; if emulation is paused, unpausing
+     will sort it out */
+  if( !fuse_emulation_paused ) {
+    if( fast_forward ) {
+      sound_pause();
+    } else {
+      sound_unpause();
+    }
+  }
+
+  timer_estimate_reset();
+}
+
+/* When fast-forwarding, draw only every settings_current.fast_forward_frameskip
+   frames; the rest just mark what needs drawing next time */
+static void
+spectrum_fast_forward( void )
+{
+  int skip = settings_current.fast_forward_frameskip;
+
+  if( skip < 1 ) skip = 1;
+
+  if( ++fast_forward_frames >= skip ) fast_forward_frames = 0;
+  display_hidden = fast_forward_frames != 0;
+}
+
+static void
+run_ahead_check_event( gpointer data, gpointer user_data )
+{
+  const event_t *event = data;
+  int *core_only = user_data;
+
+  if( event->type != spectrum_frame_event &&
+      event->type != timer_event &&
+      event->type != z80_interrupt_event &&
+      event->type != z80_nmos_iff2_event &&
+      event->type != event_type_null )
+    *core_only = 0;
+}
+
+/* Peripherals with paging or registers of their own which aren't rewound
+   with the core; DivIDE's automapping, for one, changes every frame */
+static const periph_type run_ahead_excluded[] = {
+  PERIPH_TYPE_BETA128,
+  PERIPH_TYPE_BETA128_PENTAGON,
+  PERIPH_TYPE_BETA128_PENTAGON_LATE,
+  PERIPH_TYPE_DIDAKTIK80,
+  PERIPH_TYPE_DISCIPLE,
+  PERIPH_TYPE_DIVIDE,
+  PERIPH_TYPE_INTERFACE1,
+  PERIPH_TYPE_OPUS,
+  PERIPH_TYPE_PLUSD,
+  PERIPH_TYPE_SCLD,
+  PERIPH_TYPE_SIMPLEIDE,
+  PERIPH_TYPE_SPECCYBOOT,
+  PERIPH_TYPE_SPECDRUM,
+  PERIPH_TYPE_SPECTRANET,
+  PERIPH_TYPE_UPD765,
+  PERIPH_TYPE_USOURCE,
+  PERIPH_TYPE_ZXATASP,
+  PERIPH_TYPE_ZXCF,
+};
+
+/* Running ahead rewinds only the core of the machine, so don't do it while
+   anything else is happening which wouldn't be rewound: tape or disk
+   activity (which shows up as pending events), tape recording (whose edges
+   come straight from the ULA without an event), peripherals with state of
+   their own, file output or debugging */
+static int
+run_ahead_possible( void )
+{
+  int core_only = 1;
+  size_t i;
+
+  if( settings_current.run_ahead <= 0 ) return 0;
+
+  if( rzx_playback || rzx_recording || psg_recording || tape_recording ||
+      profile_active || heatmap_active ||
+      debugger_mode != DEBUGGER_MODE_INACTIVE || settings_current.printer )
+    return 0;
+
+  for( i = 0; i < ARRAY_SIZE( run_ahead_excluded ); i++ )
+    if( periph_is_active( run_ahead_excluded[i] ) ) return 0;
+
+  event_foreach( run_ahead_check_event, &core_only );
+
+  return core_only;
+}
+
+/* A frame with none of the per-frame UI work */
+static void
+run_ahead_frame( void )
+{
+  while( !event_frame_end ) {
+    z80_do_opcodes();
+    event_do_events();
+  }
+
+  spectrum_frame();
+  z80_interrupt();
+  event_frame_end = 0;
+}
+
+/* Emulate whole frames as fast as possible, with no sound, nothing drawn
+   and none of the per-frame UI work; used to play an RZX file forward to
+   the frame being sought */
+void
+spectrum_skip_frames( size_t frames )
+{
+  int sound;
+
+  event_remove_type( timer_event );
+
+  sound = sound_enabled;
+  sound_enabled = 0;
+  display_hidden = 1;
+
+  while( frames-- ) {
+    while( !event_frame_end ) {
+      z80_do_opcodes();
+      event_do_events();
+    }
+
+    if( rzx_playback ) event_force_events();
+    rzx_frame();
+    psg_frame();
+    spectrum_frame();
+    z80_interrupt();
+    event_frame_end = 0;
+    if( rzx_playback ) rzx_index_frame();
+  }
+
+  display_hidden = 0;
+  sound_enabled = sound;
+
+  /* Don't try to catch up on the time spent here */
+  timer_estimate_reset();
+  event_add( tstates, timer_event );
+}
+
+/* Cut input latency by showing the frame settings_current.run_ahead frames
+   in the future: save the core state, emulate that many frames with the
+   current input and no sound, drawing only the last, and then restore the
+   state. The real frames produce the sound but are not drawn */
+static void
+spectrum_run_ahead( void )
+{
+  int i, frames, sound;
+
+  if( !run_ahead_possible() ) {
+    display_hidden = 0;
+    return;
+  }
+
+  frames = settings_current.run_ahead > SPECTRUM_RUN_AHEAD_MAX ?
+           SPECTRUM_RUN_AHEAD_MAX : settings_current.run_ahead;
+
+  module_state_to( &run_ahead_state, NULL );
+  event_state_to( &run_ahead_state );
+  display_state_to( &run_ahead_state );
+
+  /* The host timer must not see the frames ahead; the event list is
+     restored afterwards anyway */
+  event_remove_type( timer_event );
+
+  sound = sound_enabled;
+  sound_enabled = 0;
+
+  for( i = 0; i < frames; i++ ) {
+    display_hidden = i < frames - 1;
+    run_ahead_frame();
+  }
+
+  /* The next real frame is hidden; the last frame ahead of it is shown */
+  display_hidden = 1;
+
+  module_state_from( &run_ahead_state, NULL );
+  event_state_from( &run_ahead_state );
+  display_state_from( &run_ahead_state );
+  machine_current->memory_map();
+
+  /* The screen now shows a frame from the timeline just thrown away, and
+     only bytes written again would be redrawn, so check every line of it
+     against the rewound RAM. The border is redrawn in full every frame
+     anyway */
+  display_refresh_main_screen();
+
+  sound_enabled = sound;
+}
@@ -87,7 +87,20 @@ int spectrum_frame( void );
 /* Do a single frame */
 void spectrum_do_frame(void);
 
+/* Do this many frames flat out, without sound or drawing */
+void spectrum_skip_frames( size_t frames );
+
 /* Run until the next timer event */
 void spectrum_do_timer( libspectrum_dword target_tstates );
 
+/* Is fast-forward on, either from the setting or because a tape is being
+   fastloaded? */
+int spectrum_fast_forward_active( void );
+
+/* The emulated frames per second to aim for when fast-forwarding, or 0 to
+   go as fast as possible */
+int spectrum_fast_forward_fps( void );
+
+void spectrum_set_fast_forward( int fast_forward );
+
 #endif			/* #ifndef FUSE_SPECTRUM_H */
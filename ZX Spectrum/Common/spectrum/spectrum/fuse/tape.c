@@ -35,6 +35,7 @@
 #include "libspectrum.h"
 #include "cocoatape.h"
 
+#include "compat.h"
 #include "debugger.h"
 #include "event.h"
 #include "fuse.h"
@@ -48,6 +49,7 @@
 #include "settings.h"
 #include "snapshot.h"
 #include "tape.h"
+#include "tape_recorder.h"
 #include "timer.h"
 #include "ui.h"
 #include "utils.h"
@@ -78,7 +80,6 @@ static int play_event, stop_event = -1;
 
 /* Spectrum events */
 int tape_edge_event;
-static int record_event;
 static int tape_mic_off_event;
 
 static libspectrum_dword next_tape_edge_tstates;
@@ -89,9 +90,6 @@ static int tape_autoload( libspectrum_machine hardware );
 static int trap_load_block( libspectrum_tape_block *block );
 static int tape_play( int autoplay );
 static void make_name( unsigned char *name, const unsigned char *data );
-static void
-tape_event_record_sample( libspectrum_dword last_tstates, int type,
-			  void *user_data );
 static void tape_stop_mic_off( libspectrum_dword last_tstates, int type,
                                void *user_data );
 
@@ -109,8 +107,6 @@ tape_init( void *context )
 
   tape_edge_event = event_register( tape_next_edge, "Tape edge" );
   tape_mic_off_event = event_register( tape_stop_mic_off, "Tape stop MIC off" );
-  record_event = event_register( tape_event_record_sample,
-				 "Tape sample record" );
 
   tape_modified = 0;
 
@@ -685,117 +681,175 @@ tape_present( void )
 
 typedef struct
 {
-  libspectrum_byte *tape_buffer;
-  libspectrum_dword tape_buffer_size;
-  libspectrum_dword tape_buffer_used;
-  int tstates_per_sample;
+  tape_recorder *recorder;
+  compat_fd fd;
+  char *filename;
+  libspectrum_id_t type;
   int last_level;
-  int last_level_count;
+  /* When the last edge happened, relative to the start of the current
+     frame, and how long since then there was in earlier frames. An OUT at
+     the very end of a frame can finish past its end, so the edge can be
+     carried into the next frame */
+  libspectrum_signed_dword last_edge_tstates;
+  libspectrum_dword earlier_frames;
 } tape_rec_state;
 
 int tape_recording = 0;
 
 static tape_rec_state rec_state;
 
-void
-tape_record_start( void )
+static void
+record_file_close( void )
 {
-  /* sample rate will be 44.1KHz */
-  rec_state.tstates_per_sample =
-    machine_current->timings.processor_speed/44100;
+  if( rec_state.fd != COMPAT_FILE_OPEN_FAILED ) {
+    compat_file_close( rec_state.fd );
+    rec_state.fd = COMPAT_FILE_OPEN_FAILED;
+  }
 
-  rec_state.tape_buffer_size = 8192;
-  rec_state.tape_buffer = libspectrum_new(libspectrum_byte,
-					  rec_state.tape_buffer_size);
-  rec_state.tape_buffer_used = 0;
+  libspectrum_free( rec_state.filename );
+  rec_state.filename = NULL;
+}
 
-  /* start scheduling events that record into a buffer that we
-     start allocating here */
-  event_add( tstates + rec_state.tstates_per_sample, record_event );
+/* Stream a block to the recording file as well as adding it to the tape */
+static void
+record_block( libspectrum_tape_block *block, void *user_data )
+{
+  libspectrum_byte *buffer; size_t length = 0;
+  int error;
 
-  rec_state.last_level = ula_tape_level();
-  rec_state.last_level_count = 1;
+  libspectrum_tape_append_block( tape, block );
 
-  tape_recording = 1;
+  tape_modified = 1;
+  ui_tape_browser_update( UI_TAPE_BROWSER_NEW_BLOCK, block );
 
-  /* Also want to disable other tape actions */
-  ui_menu_activate( UI_MENU_ITEM_TAPE_RECORDING, 1 );
+  if( rec_state.fd == COMPAT_FILE_OPEN_FAILED ) return;
+
+  error = libspectrum_tape_block_write( &buffer, &length, block,
+                                        rec_state.type );
+  if( !error ) {
+    error = compat_file_write( rec_state.fd, buffer, length );
+    libspectrum_free( buffer );
+  }
+
+  /* The recording carries on in memory, so it can still be saved */
+  if( error ) {
+    ui_error( UI_ERROR_ERROR,
+              "stopped writing tape recording to `%s'; save the tape to keep it",
+              rec_state.filename );
+    record_file_close();
+  }
 }
 
-static int
-write_rec_buffer( libspectrum_byte *tape_buffer,
-                  libspectrum_dword tape_buffer_used,
-                  int last_level_count )
+static void
+record_file_open( const char *filename )
 {
-  if( last_level_count <= 0xff ) {
-    tape_buffer[ tape_buffer_used++ ] = last_level_count;
+  libspectrum_tape *empty;
+  libspectrum_class_t class;
+  libspectrum_byte *buffer; size_t length = 0;
+
+  rec_state.fd = COMPAT_FILE_OPEN_FAILED;
+
+  if( !filename ) return;
+
+  /* As for tape_write(), write a .tzx unless asked for a .pzx */
+  if( libspectrum_identify_file_with_class( &rec_state.type, &class, filename,
+                                            NULL, 0 ) ||
+      rec_state.type != LIBSPECTRUM_ID_TAPE_PZX )
+    rec_state.type = LIBSPECTRUM_ID_TAPE_TZX;
+
+  empty = libspectrum_tape_alloc();
+  if( libspectrum_tape_write( &buffer, &length, empty, rec_state.type ) ) {
+    libspectrum_tape_free( empty );
+    return;
+  }
+  libspectrum_tape_free( empty );
+
+  rec_state.fd = compat_file_open( filename, 1 );
+  if( rec_state.fd == COMPAT_FILE_OPEN_FAILED ) {
+    ui_error( UI_ERROR_ERROR, "couldn't open `%s' for writing: %s\n",
+              filename, strerror( errno ) );
+  } else if( compat_file_write( rec_state.fd, buffer, length ) ) {
+    compat_file_close( rec_state.fd );
+    rec_state.fd = COMPAT_FILE_OPEN_FAILED;
   } else {
-    tape_buffer[ tape_buffer_used++ ] = 0;
-    tape_buffer[ tape_buffer_used++ ] = ( last_level_count & 0x000000ff )      ;
-    tape_buffer[ tape_buffer_used++ ] = ( last_level_count & 0x0000ff00 ) >>  8;
-    tape_buffer[ tape_buffer_used++ ] = ( last_level_count & 0x00ff0000 ) >> 16;
-    tape_buffer[ tape_buffer_used++ ] = ( last_level_count & 0xff000000 ) >> 24;
+    rec_state.filename = utils_safe_strdup( filename );
   }
 
-  return tape_buffer_used;
+  libspectrum_free( buffer );
+}
+
+/* How long since the last edge */
+static libspectrum_dword
+record_pulse_length( void )
+{
+  libspectrum_dword elapsed = tstates - rec_state.last_edge_tstates;
+
+  return rec_state.earlier_frames > 0xffffffff - elapsed ?
+         0xffffffff : rec_state.earlier_frames + elapsed;
 }
 
 void
-tape_event_record_sample( libspectrum_dword last_tstates, int type,
-			  void *user_data )
+tape_record_start( void )
 {
-  if( rec_state.last_level != (ula_tape_level()) ) {
-    /* put a sample into the recording buffer */
-    rec_state.tape_buffer_used =
-      write_rec_buffer( rec_state.tape_buffer,
-                        rec_state.tape_buffer_used,
-                        rec_state.last_level_count );
-
-    rec_state.last_level_count = 0;
-    rec_state.last_level = ula_tape_level();
-    /* make sure we can still fit a dword and a flag byte in the buffer */
-    if( rec_state.tape_buffer_used+5 >= rec_state.tape_buffer_size ) {
-      rec_state.tape_buffer_size = rec_state.tape_buffer_size*2;
-      rec_state.tape_buffer =
-        libspectrum_renew( libspectrum_byte, rec_state.tape_buffer,
-                           rec_state.tape_buffer_size );
-    }
-  }
+  /* Pulses are turned into blocks as they come in, and those blocks are
+     written out as they're finished if we've been given a file */
+  rec_state.recorder = tape_recorder_alloc( record_block, NULL );
+  record_file_open( settings_current.tape_record_file );
 
-  rec_state.last_level_count++;
+  rec_state.last_level = ula_tape_level();
+  rec_state.last_edge_tstates = tstates;
+  rec_state.earlier_frames = 0;
+
+  tape_recording = 1;
 
-  /* schedule next timer */
-  event_add( last_tstates + rec_state.tstates_per_sample, record_event );
+  /* Also want to disable other tape actions */
+  ui_menu_activate( UI_MENU_ITEM_TAPE_RECORDING, 1 );
 }
 
-int
-tape_record_stop( void )
+/* Called by the ULA on every write to the MIC/EAR port; the length of each
+   pulse is exactly the time between two changes of level */
+void
+tape_record_level( libspectrum_byte level )
 {
-  libspectrum_tape_block* block;
+  if( level == rec_state.last_level ) return;
 
-  /* put last sample into the recording buffer */
-  rec_state.tape_buffer_used = write_rec_buffer( rec_state.tape_buffer,
-                                                 rec_state.tape_buffer_used,
-                                                 rec_state.last_level_count );
+  tape_recorder_pulse( rec_state.recorder, record_pulse_length() );
 
-  /* stop scheduling events and turn buffer into a block and
-     pop into the current tape */
-  event_remove_type( record_event );
+  rec_state.last_level = level;
+  rec_state.last_edge_tstates = tstates;
+  rec_state.earlier_frames = 0;
+}
 
-  block = libspectrum_tape_block_alloc( LIBSPECTRUM_TAPE_BLOCK_RLE_PULSE );
+/* Carry the time since the last edge over into the next frame */
+void
+tape_record_frame( libspectrum_dword frame_length )
+{
+  libspectrum_dword elapsed;
 
-  libspectrum_tape_block_set_scale( block, rec_state.tstates_per_sample );
-  libspectrum_tape_block_set_data_length( block, rec_state.tape_buffer_used );
-  libspectrum_tape_block_set_data( block, rec_state.tape_buffer );
+  rec_state.last_edge_tstates -= frame_length;
 
-  libspectrum_tape_append_block( tape, block );
+  /* An edge past the end of this frame just moves into the next one */
+  if( rec_state.last_edge_tstates >= 0 ) return;
 
-  rec_state.tape_buffer = NULL;
-  rec_state.tape_buffer_size = 0;
-  rec_state.tape_buffer_used = 0;
+  elapsed = -rec_state.last_edge_tstates;
 
-  tape_modified = 1;
-  ui_tape_browser_update( UI_TAPE_BROWSER_NEW_BLOCK, block );
+  /* Nothing useful can be done with a gap of over 20 minutes at 3.5MHz,
+     so just stop counting */
+  rec_state.earlier_frames =
+    rec_state.earlier_frames > 0xffffffff - elapsed ?
+    0xffffffff : rec_state.earlier_frames + elapsed;
+  rec_state.last_edge_tstates = 0;
+}
+
+int
+tape_record_stop( void )
+{
+  /* Finish off the last pulse and whatever block it was part of */
+  tape_recorder_pulse( rec_state.recorder, record_pulse_length() );
+  tape_recorder_free( rec_state.recorder );
+  rec_state.recorder = NULL;
+
+  record_file_close();
 
   tape_recording = 0;
 
@@ -805,6 +859,50 @@ tape_record_stop( void )
   return 0;
 }
 
+/* Check the time between edges is carried across frame ends, including
+   for an edge from an OUT which finished after the end of its frame */
+int
+tape_unittest( void )
+{
+  tape_rec_state saved_state = rec_state;
+  libspectrum_dword saved_tstates = tstates;
+  libspectrum_dword frame_length = 69888, length;
+  int r = 0;
+
+  rec_state.earlier_frames = 0;
+
+  /* An edge 5 tstates past the end of the frame, then one 100 tstates into
+     the next */
+  rec_state.last_edge_tstates = frame_length + 5;
+  tape_record_frame( frame_length );
+  tstates = 100;
+  length = record_pulse_length();
+  if( length != 95 ) {
+    printf( "%s: edge past the end of the frame gave a %lu tstate pulse\n",
+            __func__, (unsigned long)length );
+    r = 1;
+  }
+
+  /* An edge 1000 tstates into a frame, then one 200 tstates into the frame
+     after next */
+  rec_state.last_edge_tstates = 1000;
+  rec_state.earlier_frames = 0;
+  tape_record_frame( frame_length );
+  tape_record_frame( frame_length );
+  tstates = 200;
+  length = record_pulse_length();
+  if( length != 2 * frame_length - 1000 + 200 ) {
+    printf( "%s: edge two frames back gave a %lu tstate pulse\n", __func__,
+            (unsigned long)length );
+    r = 1;
+  }
+
+  rec_state = saved_state;
+  tstates = saved_tstates;
+
+  return r;
+}
+
 void
 tape_next_edge( libspectrum_dword last_tstates, int type, void *user_data )
 {
@@ -62,6 +62,14 @@ int tape_present( void );
 void tape_record_start( void );
 int tape_record_stop( void );
 
+/* Called with the new MIC level on every write to the ULA while recording */
+void tape_record_level( libspectrum_byte level );
+
+/* Called at the end of every frame while recording */
+void tape_record_frame( libspectrum_dword frame_length );
+
+int tape_unittest( void );
+
 /* Call a user-supplied function for every block in the current tape */
 int
 tape_foreach( void (*function)( libspectrum_tape_block *block,
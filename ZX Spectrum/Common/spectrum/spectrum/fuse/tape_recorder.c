@@ -0,0 +1,378 @@
+/* tape_recorder.c: Turn recorded pulses into tape blocks
+   Copyright (c) 2026 The Fuse authors
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+   Author contact information:
+
+   E-mail: philip-fuse@shadowmagic.org.uk
+
+*/
+
+#include "config.h"
+
+#include "libspectrum.h"
+
+#include "tape_recorder.h"
+
+/* The ROM's timings, and how far a recorded pulse can be from them. The
+   ranges have to allow for saving routines which don't hit the ROM's
+   timings exactly */
+#define PILOT_LENGTH 2168
+#define PILOT_MIN 1950
+#define PILOT_MAX 2450
+#define SYNC1_LENGTH 667
+#define SYNC2_LENGTH 735
+#define SYNC_MIN 450
+#define SYNC_MAX 900
+#define BIT0_LENGTH 855
+#define BIT0_MIN 600
+#define BIT0_MAX 1150
+#define BIT1_LENGTH 1710
+#define BIT1_MIN 1300
+#define BIT1_MAX 1950
+
+/* The ROM won't start loading after a shorter pilot tone than this */
+#define PILOT_PULSES_MIN 256
+
+/* A gap of at least a millisecond after some data is the block's pause;
+   TZX pauses are stored in milliseconds and can't be longer than 0xffff */
+#define PAUSE_MS 3500
+#define GAP_MIN PAUSE_MS
+#define GAP_MAX ( 0xffff * PAUSE_MS )
+
+/* Longer pulses than this won't fit in a TZX pulse block and become
+   pauses instead */
+#define PAUSE_MIN 0x10000
+
+/* Outstanding pulses are written out as a block every so often so they're
+   not all held until recording stops; the limit is only hit if a pilot tone
+   goes on for ever */
+#define PENDING_FLUSH 4096
+#define PENDING_LIMIT 65536
+
+typedef enum recorder_state {
+
+  RECORDER_PULSES,		/* Nothing recognised */
+  RECORDER_PILOT,		/* In what looks like a pilot tone */
+  RECORDER_SYNC,		/* Seen the first sync pulse */
+  RECORDER_DATA,		/* In the first byte of data */
+  RECORDER_DATA_BLOCK,		/* Past the first byte; the pulses are no
+				   longer kept */
+
+} recorder_state;
+
+struct tape_recorder {
+
+  tape_recorder_block_fn block_done;
+  void *user_data;
+
+  recorder_state state;
+
+  /* Pulses which aren't in a block yet, with repeats of the same length
+     run together */
+  libspectrum_dword *lengths;
+  size_t *repeats;
+  size_t count, size;
+
+  /* Where the pilot tone starts in the pulses above */
+  size_t pilot_start;
+  size_t pilot_pulses;
+
+  /* The data so far and the first pulse of the bit in progress */
+  libspectrum_byte *data;
+  size_t data_size;
+  size_t bits;
+  libspectrum_dword half_bit;
+
+};
+
+static void recorder_process( tape_recorder *recorder,
+                              libspectrum_dword tstates );
+
+tape_recorder*
+tape_recorder_alloc( tape_recorder_block_fn block_done, void *user_data )
+{
+  tape_recorder *recorder = libspectrum_new0( tape_recorder, 1 );
+
+  recorder->block_done = block_done;
+  recorder->user_data = user_data;
+  recorder->state = RECORDER_PULSES;
+
+  return recorder;
+}
+
+static void
+flush_pulses( tape_recorder *recorder )
+{
+  libspectrum_tape_block *block;
+
+  if( !recorder->count ) return;
+
+  block = libspectrum_tape_block_alloc( LIBSPECTRUM_TAPE_BLOCK_PULSE_SEQUENCE );
+
+  libspectrum_tape_block_set_count( block, recorder->count );
+  libspectrum_tape_block_set_pulse_lengths(
+    block, libspectrum_renew( libspectrum_dword, recorder->lengths,
+                              recorder->count )
+  );
+  libspectrum_tape_block_set_pulse_repeats(
+    block, libspectrum_renew( size_t, recorder->repeats, recorder->count )
+  );
+
+  recorder->lengths = NULL;
+  recorder->repeats = NULL;
+  recorder->count = recorder->size = 0;
+  recorder->pilot_start = 0;
+
+  recorder->block_done( block, recorder->user_data );
+}
+
+static void
+add_pulse( tape_recorder *recorder, libspectrum_dword tstates )
+{
+  /* Don't run the start of a pilot tone into whatever came before it */
+  if( recorder->count && recorder->count != recorder->pilot_start &&
+      recorder->lengths[ recorder->count - 1 ] == tstates ) {
+    recorder->repeats[ recorder->count - 1 ]++;
+    return;
+  }
+
+  if( recorder->count == recorder->size ) {
+    recorder->size = recorder->size ? recorder->size * 2 : 256;
+    recorder->lengths = libspectrum_renew( libspectrum_dword,
+                                           recorder->lengths, recorder->size );
+    recorder->repeats = libspectrum_renew( size_t, recorder->repeats,
+                                           recorder->size );
+  }
+
+  recorder->lengths[ recorder->count ] = tstates;
+  recorder->repeats[ recorder->count ] = 1;
+  recorder->count++;
+
+  if( recorder->count >= PENDING_LIMIT ||
+      ( recorder->count >= PENDING_FLUSH &&
+        recorder->state == RECORDER_PULSES ) )
+    flush_pulses( recorder );
+}
+
+static void
+set_pause( libspectrum_tape_block *block, libspectrum_dword tstates )
+{
+  if( tstates > GAP_MAX ) tstates = GAP_MAX;
+
+  libspectrum_tape_block_set_pause( block, tstates / PAUSE_MS );
+  libspectrum_tape_block_set_pause_tstates( block, tstates );
+}
+
+static void
+add_pause( tape_recorder *recorder, libspectrum_dword tstates )
+{
+  libspectrum_tape_block *block;
+
+  flush_pulses( recorder );
+
+  block = libspectrum_tape_block_alloc( LIBSPECTRUM_TAPE_BLOCK_PAUSE );
+  set_pause( block, tstates );
+  libspectrum_tape_block_set_level( block, -1 );
+
+  recorder->block_done( block, recorder->user_data );
+}
+
+static int
+bit_value( libspectrum_dword tstates )
+{
+  if( tstates >= BIT0_MIN && tstates <= BIT0_MAX ) return 0;
+  if( tstates >= BIT1_MIN && tstates <= BIT1_MAX ) return 1;
+  return -1;
+}
+
+static void
+add_bit( tape_recorder *recorder, int bit )
+{
+  size_t byte = recorder->bits / 8;
+
+  if( byte >= recorder->data_size ) {
+    recorder->data_size = recorder->data_size ? recorder->data_size * 2 : 256;
+    recorder->data = libspectrum_renew( libspectrum_byte, recorder->data,
+                                        recorder->data_size );
+  }
+
+  if( recorder->bits % 8 == 0 ) recorder->data[ byte ] = 0;
+  if( bit ) recorder->data[ byte ] |= 0x80 >> ( recorder->bits % 8 );
+
+  recorder->bits++;
+}
+
+/* Write out the data as a standard speed block if it's whole bytes, or
+   as a turbo block with the ROM's timings if not */
+static void
+finish_data_block( tape_recorder *recorder, libspectrum_dword pause )
+{
+  libspectrum_tape_block *block;
+  size_t length = ( recorder->bits + 7 ) / 8;
+
+  if( recorder->bits % 8 == 0 ) {
+    block = libspectrum_tape_block_alloc( LIBSPECTRUM_TAPE_BLOCK_ROM );
+  } else {
+    block = libspectrum_tape_block_alloc( LIBSPECTRUM_TAPE_BLOCK_TURBO );
+    libspectrum_tape_block_set_pilot_length( block, PILOT_LENGTH );
+    libspectrum_tape_block_set_pilot_pulses( block, recorder->pilot_pulses );
+    libspectrum_tape_block_set_sync1_length( block, SYNC1_LENGTH );
+    libspectrum_tape_block_set_sync2_length( block, SYNC2_LENGTH );
+    libspectrum_tape_block_set_bit0_length( block, BIT0_LENGTH );
+    libspectrum_tape_block_set_bit1_length( block, BIT1_LENGTH );
+    libspectrum_tape_block_set_bits_in_last_byte( block, recorder->bits % 8 );
+  }
+
+  libspectrum_tape_block_set_data_length( block, length );
+  libspectrum_tape_block_set_data(
+    block, libspectrum_renew( libspectrum_byte, recorder->data, length )
+  );
+  set_pause( block, pause );
+
+  recorder->data = NULL;
+  recorder->data_size = recorder->bits = 0;
+  recorder->state = RECORDER_PULSES;
+
+  recorder->block_done( block, recorder->user_data );
+}
+
+/* Something other than a bit turned up in the data */
+static void
+end_data( tape_recorder *recorder, libspectrum_dword tstates, int have_half )
+{
+  if( recorder->state == RECORDER_DATA ) {
+    /* Not enough to be worth a block; the pulses are all still there */
+    recorder->state = RECORDER_PULSES;
+    recorder_process( recorder, tstates );
+    return;
+  }
+
+  /* The gap after the data is the block's pause */
+  if( !have_half && tstates >= GAP_MIN ) {
+    finish_data_block( recorder, tstates );
+    return;
+  }
+
+  finish_data_block( recorder, 0 );
+  if( have_half ) recorder_process( recorder, recorder->half_bit );
+  recorder_process( recorder, tstates );
+}
+
+static void
+recorder_process( tape_recorder *recorder, libspectrum_dword tstates )
+{
+  int bit;
+
+  switch( recorder->state ) {
+
+  case RECORDER_PULSES:
+    if( tstates >= PAUSE_MIN ) {
+      add_pause( recorder, tstates );
+    } else if( tstates >= PILOT_MIN && tstates <= PILOT_MAX ) {
+      recorder->state = RECORDER_PILOT;
+      recorder->pilot_start = recorder->count;
+      recorder->pilot_pulses = 1;
+      add_pulse( recorder, tstates );
+    } else {
+      add_pulse( recorder, tstates );
+    }
+    break;
+
+  case RECORDER_PILOT:
+    if( tstates >= PILOT_MIN && tstates <= PILOT_MAX ) {
+      recorder->pilot_pulses++;
+      add_pulse( recorder, tstates );
+    } else if( tstates >= SYNC_MIN && tstates <= SYNC_MAX &&
+               recorder->pilot_pulses >= PILOT_PULSES_MIN ) {
+      recorder->state = RECORDER_SYNC;
+      add_pulse( recorder, tstates );
+    } else {
+      recorder->state = RECORDER_PULSES;
+      recorder_process( recorder, tstates );
+    }
+    break;
+
+  case RECORDER_SYNC:
+    if( tstates >= SYNC_MIN && tstates <= SYNC_MAX ) {
+      recorder->state = RECORDER_DATA;
+      recorder->bits = 0;
+      recorder->half_bit = 0;
+      add_pulse( recorder, tstates );
+    } else {
+      recorder->state = RECORDER_PULSES;
+      recorder_process( recorder, tstates );
+    }
+    break;
+
+  case RECORDER_DATA:
+  case RECORDER_DATA_BLOCK:
+    bit = bit_value( tstates );
+
+    if( !recorder->half_bit ) {
+
+      if( bit == -1 ) { end_data( recorder, tstates, 0 ); break; }
+      recorder->half_bit = tstates;
+
+    } else {
+
+      if( bit != bit_value( recorder->half_bit ) ) {
+        recorder->half_bit = 0;
+        end_data( recorder, tstates, 1 );
+        break;
+      }
+      recorder->half_bit = 0;
+      add_bit( recorder, bit );
+
+    }
+
+    if( recorder->state == RECORDER_DATA ) {
+      add_pulse( recorder, tstates );
+
+      /* A whole byte is enough to be sure this is data; the pulses from
+         the start of the pilot tone aren't needed any more */
+      if( recorder->bits == 8 ) {
+        recorder->count = recorder->pilot_start;
+        flush_pulses( recorder );
+        recorder->state = RECORDER_DATA_BLOCK;
+      }
+    }
+    break;
+
+  }
+}
+
+void
+tape_recorder_pulse( tape_recorder *recorder, libspectrum_dword tstates )
+{
+  recorder_process( recorder, tstates );
+}
+
+void
+tape_recorder_free( tape_recorder *recorder )
+{
+  if( recorder->state == RECORDER_DATA_BLOCK ) {
+    /* Any half finished bit is lost with the rest of the recording */
+    finish_data_block( recorder, 0 );
+  }
+
+  flush_pulses( recorder );
+
+  libspectrum_free( recorder->lengths );
+  libspectrum_free( recorder->repeats );
+  libspectrum_free( recorder->data );
+  libspectrum_free( recorder );
+}
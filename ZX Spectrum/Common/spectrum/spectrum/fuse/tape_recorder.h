@@ -0,0 +1,48 @@
+/* tape_recorder.h: Turn recorded pulses into tape blocks
+   Copyright (c) 2026 The Fuse authors
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+   Author contact information:
+
+   E-mail: philip-fuse@shadowmagic.org.uk
+
+*/
+
+#ifndef FUSE_TAPE_RECORDER_H
+#define FUSE_TAPE_RECORDER_H
+
+#include "libspectrum.h"
+
+/* Called with each block as it's finished; the block then belongs to the
+   callee */
+typedef void (*tape_recorder_block_fn)( libspectrum_tape_block *block,
+                                        void *user_data );
+
+/* Anything saved with the ROM's timings becomes a standard speed data block
+   (or a turbo block if it doesn't end on a byte boundary), long gaps become
+   pauses and everything else is kept as pulse sequences */
+typedef struct tape_recorder tape_recorder;
+
+tape_recorder* tape_recorder_alloc( tape_recorder_block_fn block_done,
+                                    void *user_data );
+
+/* Add the next pulse, the time in tstates between two changes of level */
+void tape_recorder_pulse( tape_recorder *recorder, libspectrum_dword tstates );
+
+/* Finish off the block in progress and free the recorder */
+void tape_recorder_free( tape_recorder *recorder );
+
+#endif				/* #ifndef FUSE_TAPE_RECORDER_H */
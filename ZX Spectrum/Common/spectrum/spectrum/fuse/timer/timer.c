@@ -30,7 +30,7 @@
 #include "movie.h"
 #include "settings.h"
 #include "sound.h"
-#include "tape.h"
+#include "spectrum.h"
 #include "timer.h"
 #include "ui.h"
 
@@ -188,9 +188,9 @@ timer_frame( libspectrum_dword last_tstates, int event GCC_UNUSED,
     return;
   }
 
-  /* If we're fastloading, just schedule another check in a frame's time
-     and do nothing else */
-  if( settings_current.fastload && tape_is_playing() ) {
+  /* If we're fastloading or fast-forwarding with no target speed, just
+     schedule another check in a frame's time and do nothing else */
+  if( spectrum_fast_forward_active() && !spectrum_fast_forward_fps() ) {
 
     libspectrum_dword next_check_time =
       last_tstates + machine_current->timings.tstates_per_frame;
@@ -203,6 +203,12 @@ timer_frame( libspectrum_dword last_tstates, int event GCC_UNUSED,
                     1.0                                  :
                     settings_current.emulation_speed ) / 100.0;
 
+    /* Fast-forwarding aims for a number of frames per second instead */
+    if( spectrum_fast_forward_active() )
+      speed = (float)spectrum_fast_forward_fps() *
+              machine_current->timings.tstates_per_frame /
+              machine_current->timings.processor_speed;
+
     while( 1 ) {
 
       current_time = timer_get_time(); if( current_time < 0 ) return;
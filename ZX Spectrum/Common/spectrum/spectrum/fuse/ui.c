@@ -31,6 +31,10 @@
 #include <string.h>
 #include <unistd.h>
 
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif				/* #ifdef HAVE_PTHREAD */
+
 #include "libspectrum.h"
 
 #include "fuse.h"
@@ -47,6 +51,8 @@
 /* We don't start in a widget */
 int ui_widget_level = -1;
 
+int ui_headless = 0;
+
 static char last_message[ MESSAGE_MAX_LENGTH ] = "";
 static size_t frames_since_last_message = 0;
 
@@ -90,7 +96,7 @@ ui_verror( ui_error_level severity, const char *format, va_list ap )
 #endif			/* #ifndef UI_WIN32 */
 
   /* Do any UI-specific bits as well */
-  ui_error_specific( severity, message );
+  if( !ui_headless ) ui_error_specific( severity, message );
 
   return 0;
 }
@@ -143,11 +149,71 @@ print_error_to_stderr( ui_error_level severity, const char *message )
   return 0;
 }
 
+#ifdef HAVE_PTHREAD
+
+static pthread_once_t error_buffer_once = PTHREAD_ONCE_INIT;
+static pthread_key_t error_buffer_key;
+
+static void
+error_buffer_key_create( void )
+{
+  pthread_key_create( &error_buffer_key, NULL );
+}
+
+void
+ui_error_buffer_start( ui_error_buffer *buffer )
+{
+  buffer->used = 0;
+  buffer->message[0] = '\0';
+
+  pthread_once( &error_buffer_once, error_buffer_key_create );
+  pthread_setspecific( error_buffer_key, buffer );
+}
+
+void
+ui_error_buffer_stop( void )
+{
+  pthread_once( &error_buffer_once, error_buffer_key_create );
+  pthread_setspecific( error_buffer_key, NULL );
+}
+
+#else				/* #ifdef HAVE_PTHREAD */
+
+void
+ui_error_buffer_start( ui_error_buffer *buffer )
+{
+  buffer->used = 0;
+  buffer->message[0] = '\0';
+}
+
+void
+ui_error_buffer_stop( void )
+{
+}
+
+#endif				/* #ifdef HAVE_PTHREAD */
+
 libspectrum_error
 ui_libspectrum_error( libspectrum_error error GCC_UNUSED, const char *format,
 		      va_list ap )
 {
   char new_format[ 257 ];
+
+#ifdef HAVE_PTHREAD
+  ui_error_buffer *buffer;
+
+  /* Not on the main thread: keep the first error for it to report */
+  pthread_once( &error_buffer_once, error_buffer_key_create );
+  buffer = pthread_getspecific( error_buffer_key );
+  if( buffer ) {
+    if( !buffer->used ) {
+      vsnprintf( buffer->message, sizeof( buffer->message ), format, ap );
+      buffer->used = 1;
+    }
+    return LIBSPECTRUM_ERROR_NONE;
+  }
+#endif				/* #ifdef HAVE_PTHREAD */
+
   snprintf( new_format, 256, "libspectrum: %s", format );
 
   ui_verror( UI_ERROR_ERROR, new_format, ap );
@@ -45,13 +45,9 @@
 #include "screenshot.h"
 #include "ui/ui.h"
 #include "ui/uidisplay.h"
+#include "ui/uiframe.h"
 #include "settings.h"
 
-/* A copy of every pixel on the screen */
-libspectrum_word
-  fbdisplay_image[ 2 * DISPLAY_SCREEN_HEIGHT ][ DISPLAY_SCREEN_WIDTH ];
-ptrdiff_t fbdisplay_pitch = DISPLAY_SCREEN_WIDTH * sizeof( libspectrum_word );
-
 /* The environment variable specifying which device to use */
 static const char * const DEVICE_VARIABLE = "FRAMEBUFFER";
 
@@ -69,6 +65,7 @@ int image_width, image_height;
 static int hires;
 
 static void register_scalers( void );
+static void fb_render( const uiframe *frame, void *user_data );
 
 /* probably 0rrrrrgggggbbbbb */
 static short rgbs[16], greys[16];
@@ -145,6 +142,11 @@ int uidisplay_init( int width, int height )
 
   register_scalers();
 
+  /* Every pixel on the screen, drawn to the framebuffer by the render
+     thread */
+  uiframe_init( DISPLAY_SCREEN_WIDTH, 2 * DISPLAY_SCREEN_HEIGHT, fb_render,
+                NULL );
+
   display_ui_initialised = 1;
 
   display_refresh_all();
@@ -333,11 +335,18 @@ uidisplay_hotswap_gfx_mode( void )
 void
 uidisplay_frame_end( void ) 
 {
-  return;
+  uiframe_publish();
 }
 
 void
 uidisplay_area( int x, int start, int width, int height)
+{
+  uiframe_area( x, start, width, height );
+}
+
+static void
+fb_draw_area( const libspectrum_byte (*image)[ DISPLAY_SCREEN_WIDTH ], int x,
+              int start, int width, int height )
 {
   int y;
   const short *colours = settings_current.bw_tv ? greys : rgbs;
@@ -354,7 +363,7 @@ uidisplay_area( int x, int start, int width, int height)
 	for( i = 0, point = gm + y * display.xres_virtual + x;
 	     i < width;
 	     i++, point++ )
-	  *point = colours[fbdisplay_image[y][x+i]];
+	  *point = colours[image[y][x+i]];
 
       } else {
 
@@ -363,7 +372,7 @@ uidisplay_area( int x, int start, int width, int height)
 	     i++, point += 2 )
 	  *  point       = *( point +     display.xres_virtual ) =
 	  *( point + 1 ) = *( point + 1 + display.xres_virtual ) = 
-	    colours[fbdisplay_image[y][x+i]];
+	    colours[image[y][x+i]];
 
       }
     }
@@ -381,14 +390,14 @@ uidisplay_area( int x, int start, int width, int height)
 	for ( i = 0, point = gm + y * display.xres_virtual + x;
 	      i < width;
 	      i++, point++ )
-	  *point = colours[fbdisplay_image[y*2][x+i]];
+	  *point = colours[image[y*2][x+i]];
 
       } else {
 
 	for( i = 0, point = gm + y * display.xres_virtual + x * 2;
 	     i < width;
 	     i++, point+=2 )
-	  *point = *(point+1) = colours[fbdisplay_image[y][x+i]];
+	  *point = *(point+1) = colours[image[y][x+i]];
 
       }
     }
@@ -407,14 +416,14 @@ uidisplay_area( int x, int start, int width, int height)
 	for ( i = 0, point = gm + y * display.xres_virtual + x;
 	      i < width;
 	      i++, point++ )
-	  *point = colours[fbdisplay_image[y*2][(x+i)*2]];
+	  *point = colours[image[y*2][(x+i)*2]];
 
       } else {
 
 	for( i = 0, point = gm + y * display.xres_virtual + x;
 	     i < width;
 	     i++, point++ )
-	  *point = colours[fbdisplay_image[y][x+i]];
+	  *point = colours[image[y][x+i]];
 
       }
 
@@ -425,9 +434,28 @@ uidisplay_area( int x, int start, int width, int height)
   }
 }
 
+/* Called on the render thread with each finished frame */
+static void
+fb_render( const uiframe *frame, void *user_data GCC_UNUSED )
+{
+  const libspectrum_byte (*image)[ DISPLAY_SCREEN_WIDTH ] =
+    (const libspectrum_byte (*)[ DISPLAY_SCREEN_WIDTH ])frame->pixels;
+  size_t i;
+
+  if( frame->full ) {
+    fb_draw_area( image, 0, 0, image_width, image_height );
+    return;
+  }
+
+  for( i = 0; i < frame->rect_count; i++ )
+    fb_draw_area( image, frame->rects[i].x, frame->rects[i].y,
+                  frame->rects[i].w, frame->rects[i].h );
+}
+
 int
 uidisplay_end( void )
 {
+  uiframe_end();
   return 0;
 }
 
@@ -454,15 +482,7 @@ fbdisplay_end( void )
 void
 uidisplay_putpixel( int x, int y, int colour )
 {
-  if( machine_current->timex ) {
-    x <<= 1; y <<= 1;
-    fbdisplay_image[y  ][x  ] = colour;
-    fbdisplay_image[y  ][x+1] = colour;
-    fbdisplay_image[y+1][x  ] = colour;
-    fbdisplay_image[y+1][x+1] = colour;
-  } else {
-    fbdisplay_image[y][x] = colour;
-  }
+  uiframe_putpixel( x, y, colour );
 }
 
 /* Print the 8 pixels in `data' using ink colour `ink' and paper
@@ -471,40 +491,7 @@ void
 uidisplay_plot8( int x, int y, libspectrum_byte data,
                 libspectrum_byte ink, libspectrum_byte paper )
 {
-  x <<= 3;
-
-  if( machine_current->timex ) {
-    int i;
-
-    x <<= 1; y <<= 1;
-    for( i=0; i<2; i++,y++ ) {
-      fbdisplay_image[y][x+ 0] = ( data & 0x80 ) ? ink : paper;
-      fbdisplay_image[y][x+ 1] = ( data & 0x80 ) ? ink : paper;
-      fbdisplay_image[y][x+ 2] = ( data & 0x40 ) ? ink : paper;
-      fbdisplay_image[y][x+ 3] = ( data & 0x40 ) ? ink : paper;
-      fbdisplay_image[y][x+ 4] = ( data & 0x20 ) ? ink : paper;
-      fbdisplay_image[y][x+ 5] = ( data & 0x20 ) ? ink : paper;
-      fbdisplay_image[y][x+ 6] = ( data & 0x10 ) ? ink : paper;
-      fbdisplay_image[y][x+ 7] = ( data & 0x10 ) ? ink : paper;
-      fbdisplay_image[y][x+ 8] = ( data & 0x08 ) ? ink : paper;
-      fbdisplay_image[y][x+ 9] = ( data & 0x08 ) ? ink : paper;
-      fbdisplay_image[y][x+10] = ( data & 0x04 ) ? ink : paper;
-      fbdisplay_image[y][x+11] = ( data & 0x04 ) ? ink : paper;
-      fbdisplay_image[y][x+12] = ( data & 0x02 ) ? ink : paper;
-      fbdisplay_image[y][x+13] = ( data & 0x02 ) ? ink : paper;
-      fbdisplay_image[y][x+14] = ( data & 0x01 ) ? ink : paper;
-      fbdisplay_image[y][x+15] = ( data & 0x01 ) ? ink : paper;
-    }
-  } else {
-    fbdisplay_image[y][x+ 0] = ( data & 0x80 ) ? ink : paper;
-    fbdisplay_image[y][x+ 1] = ( data & 0x40 ) ? ink : paper;
-    fbdisplay_image[y][x+ 2] = ( data & 0x20 ) ? ink : paper;
-    fbdisplay_image[y][x+ 3] = ( data & 0x10 ) ? ink : paper;
-    fbdisplay_image[y][x+ 4] = ( data & 0x08 ) ? ink : paper;
-    fbdisplay_image[y][x+ 5] = ( data & 0x04 ) ? ink : paper;
-    fbdisplay_image[y][x+ 6] = ( data & 0x02 ) ? ink : paper;
-    fbdisplay_image[y][x+ 7] = ( data & 0x01 ) ? ink : paper;
-  }
+  uiframe_plot8( x, y, data, ink, paper );
 }
 
 /* Print the 16 pixels in `data' using ink colour `ink' and paper
@@ -513,27 +500,7 @@ void
 uidisplay_plot16( int x, int y, libspectrum_word data,
                  libspectrum_byte ink, libspectrum_byte paper )
 {
-  int i;
-  x <<= 4; y <<= 1;
-
-  for( i=0; i<2; i++,y++ ) {
-    fbdisplay_image[y][x+ 0] = ( data & 0x8000 ) ? ink : paper;
-    fbdisplay_image[y][x+ 1] = ( data & 0x4000 ) ? ink : paper;
-    fbdisplay_image[y][x+ 2] = ( data & 0x2000 ) ? ink : paper;
-    fbdisplay_image[y][x+ 3] = ( data & 0x1000 ) ? ink : paper;
-    fbdisplay_image[y][x+ 4] = ( data & 0x0800 ) ? ink : paper;
-    fbdisplay_image[y][x+ 5] = ( data & 0x0400 ) ? ink : paper;
-    fbdisplay_image[y][x+ 6] = ( data & 0x0200 ) ? ink : paper;
-    fbdisplay_image[y][x+ 7] = ( data & 0x0100 ) ? ink : paper;
-    fbdisplay_image[y][x+ 8] = ( data & 0x0080 ) ? ink : paper;
-    fbdisplay_image[y][x+ 9] = ( data & 0x0040 ) ? ink : paper;
-    fbdisplay_image[y][x+10] = ( data & 0x0020 ) ? ink : paper;
-    fbdisplay_image[y][x+11] = ( data & 0x0010 ) ? ink : paper;
-    fbdisplay_image[y][x+12] = ( data & 0x0008 ) ? ink : paper;
-    fbdisplay_image[y][x+13] = ( data & 0x0004 ) ? ink : paper;
-    fbdisplay_image[y][x+14] = ( data & 0x0002 ) ? ink : paper;
-    fbdisplay_image[y][x+15] = ( data & 0x0001 ) ? ink : paper;
-  }
+  uiframe_plot16( x, y, data, ink, paper );
 }
 
 void
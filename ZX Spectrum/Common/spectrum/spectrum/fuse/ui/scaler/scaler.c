@@ -31,12 +31,20 @@
 
 #include <string.h>
 
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif				/* #ifdef HAVE_PTHREAD */
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif				/* #ifdef HAVE_UNISTD_H */
+
 #include "libspectrum.h"
 
 #include "machine.h"
 #include "scaler.h"
 #include "scaler_internals.h"
 #include "settings.h"
+#include "startup_manager.h"
 #include "ui.h"
 #include "uidisplay.h"
 #include "utils.h"
@@ -53,6 +61,7 @@ struct scaler_info {
   scale_factor_t scaling_factor;
   ScalerProc *scaler16, *scaler32;
   scaler_expand_fn *expander;
+  ScalerPrepareProc *prepare16, *prepare32;
 
 };
 
@@ -87,11 +96,14 @@ static struct scaler_info available_scalers[] = {
     scaler_Normal2x_16,   NULL,   NULL                },
   { "Triple size",     "3x",	     SCALER_FLAGS_NONE,	  SCALE_FACTOR_THREE,
     scaler_Normal3x_16,   NULL,   NULL		    },
-  { "2xSaI",	       "2xsai",	     SCALER_FLAGS_EXPAND, SCALE_FACTOR_TWO,
+  { "2xSaI",	       "2xsai",	     SCALER_FLAGS_EXPAND | SCALER_FLAGS_PARALLEL,
+                                                          SCALE_FACTOR_TWO,
     scaler_2xSaI_16,      NULL,      expand_sai          },
-  { "Super 2xSaI",     "super2xsai", SCALER_FLAGS_EXPAND, SCALE_FACTOR_TWO,
+  { "Super 2xSaI",     "super2xsai", SCALER_FLAGS_EXPAND | SCALER_FLAGS_PARALLEL,
+                                                          SCALE_FACTOR_TWO,
     scaler_Super2xSaI_16, NULL, expand_sai          },
-  { "SuperEagle",      "supereagle", SCALER_FLAGS_EXPAND, SCALE_FACTOR_TWO,
+  { "SuperEagle",      "supereagle", SCALER_FLAGS_EXPAND | SCALER_FLAGS_PARALLEL,
+                                                          SCALE_FACTOR_TWO,
     scaler_SuperEagle_16, NULL, expand_sai          },
   { "AdvMAME 2x",      "advmame2x",  SCALER_FLAGS_EXPAND, SCALE_FACTOR_TWO,
     scaler_AdvMame2x_16,  NULL,  expand_1            },
@@ -107,16 +119,23 @@ static struct scaler_info available_scalers[] = {
     scaler_DotMatrix_16,  NULL,  expand_dotmatrix    },
   { "Timex 1.5x",      "timex15x",   SCALER_FLAGS_NONE,   SCALE_FACTOR_ONE_HALF,
     scaler_Timex1_5x_16,  NULL,  NULL                },
-  { "PAL TV",	       "paltv",     SCALER_FLAGS_EXPAND,  SCALE_FACTOR_ONE,
+  { "PAL TV",	       "paltv",     SCALER_FLAGS_EXPAND | SCALER_FLAGS_PARALLEL,
+                                                          SCALE_FACTOR_ONE,
     scaler_PalTV_16,  	  NULL,  expand_pal1        	    },
-  { "PAL TV 2x",       "paltv2x",   SCALER_FLAGS_EXPAND,  SCALE_FACTOR_TWO,
+  { "PAL TV 2x",       "paltv2x",   SCALER_FLAGS_EXPAND | SCALER_FLAGS_PARALLEL,
+                                                          SCALE_FACTOR_TWO,
     scaler_PalTV2x_16,    NULL,  expand_pal            },
-  { "PAL TV 3x",       "paltv3x",   SCALER_FLAGS_EXPAND,  SCALE_FACTOR_THREE,
+  { "PAL TV 3x",       "paltv3x",   SCALER_FLAGS_EXPAND | SCALER_FLAGS_PARALLEL,
+                                                          SCALE_FACTOR_THREE,
     scaler_PalTV3x_16,    NULL,  expand_pal            },
-  { "HQ 2x",           "hq2x",      SCALER_FLAGS_EXPAND,  SCALE_FACTOR_TWO,
-    scaler_HQ2x_16,       NULL,    expand_1            },
-  { "HQ 3x",           "hq3x",      SCALER_FLAGS_EXPAND,  SCALE_FACTOR_THREE,
-    scaler_HQ3x_16,       NULL,    expand_1            },
+  { "HQ 2x",           "hq2x",      SCALER_FLAGS_EXPAND | SCALER_FLAGS_PARALLEL,
+                                                          SCALE_FACTOR_TWO,
+    scaler_HQ2x_16,       NULL,    expand_1,
+    scaler_HQ_prepare_16, NULL                                                },
+  { "HQ 3x",           "hq3x",      SCALER_FLAGS_EXPAND | SCALER_FLAGS_PARALLEL,
+                                                          SCALE_FACTOR_THREE,
+    scaler_HQ3x_16,       NULL,    expand_1,
+    scaler_HQ_prepare_16, NULL                                                },
 };
 
 scaler_type current_scaler = SCALER_NUM;
@@ -258,6 +277,257 @@ scaler_get_expander( scaler_type scaler )
   return available_scalers[scaler].expander;
 }
 
+/* Parallel scaling. Areas are split into horizontal bands, one per thread.
+   Each band reads a line of context either side of itself from the source,
+   so neighbouring bands overlap by one line; as the source is never written
+   to, this needs no synchronisation */
+
+/* The most threads we'll use, including the calling thread */
+#define SCALER_MAX_THREADS 8
+
+/* Don't bother splitting bands shorter than this many source lines */
+#define SCALER_MIN_BAND 16
+
+typedef struct scaler_job {
+
+  ScalerProc *proc;
+  const libspectrum_byte *src;
+  libspectrum_dword src_pitch;
+  libspectrum_byte *dst;
+  libspectrum_dword dst_pitch;
+  int width, height;
+
+  /* Destination lines per source line */
+  int factor;
+
+  int bands;
+
+} scaler_job;
+
+static void
+scaler_run_band( const scaler_job *job, int band )
+{
+  int start = job->height * band / job->bands;
+  int end = job->height * ( band + 1 ) / job->bands;
+
+  if( end == start ) return;
+
+  job->proc( job->src + start * job->src_pitch, job->src_pitch,
+             job->dst + start * job->factor * job->dst_pitch, job->dst_pitch,
+             job->width, end - start );
+}
+
+#ifdef HAVE_PTHREAD
+
+static scaler_job pool_job;
+
+/* -1 until the pool has been started */
+static int pool_threads = -1;
+static pthread_t pool_workers[ SCALER_MAX_THREADS - 1 ];
+
+static pthread_mutex_t pool_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t pool_start = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t pool_done = PTHREAD_COND_INITIALIZER;
+
+/* Bumped each time a job is posted */
+static unsigned pool_generation = 0;
+
+/* The number of bands still being scaled by the workers */
+static int pool_pending = 0;
+
+static int pool_quit = 0;
+
+static void*
+pool_worker( void *arg )
+{
+  /* Worker n scales band n + 1; the calling thread does band 0 */
+  int band = (size_t)arg + 1;
+  unsigned seen = 0;
+
+  pthread_mutex_lock( &pool_lock );
+
+  while( 1 ) {
+
+    while( pool_generation == seen && !pool_quit )
+      pthread_cond_wait( &pool_start, &pool_lock );
+    if( pool_quit ) break;
+
+    seen = pool_generation;
+    if( band >= pool_job.bands ) continue;
+
+    pthread_mutex_unlock( &pool_lock );
+    scaler_run_band( &pool_job, band );
+    pthread_mutex_lock( &pool_lock );
+
+    if( !--pool_pending ) pthread_cond_signal( &pool_done );
+  }
+
+  pthread_mutex_unlock( &pool_lock );
+
+  return NULL;
+}
+
+/* Start the workers the first time they're needed. Returns the number of
+   threads available, including the calling one */
+static int
+pool_init( void )
+{
+  long cpus = 1;
+  size_t i;
+
+  if( pool_threads >= 0 ) return pool_threads + 1;
+
+#ifdef _SC_NPROCESSORS_ONLN
+  cpus = sysconf( _SC_NPROCESSORS_ONLN );
+#endif				/* #ifdef _SC_NPROCESSORS_ONLN */
+  if( cpus < 1 ) cpus = 1;
+  if( cpus > SCALER_MAX_THREADS ) cpus = SCALER_MAX_THREADS;
+
+  /* No job can have been posted yet, so the workers all start with a
+     generation of zero */
+  for( pool_threads = 0; pool_threads < cpus - 1; pool_threads++ ) {
+    i = pool_threads;
+    if( pthread_create( &pool_workers[i], NULL, pool_worker, (void*)i ) )
+      break;
+  }
+
+  return pool_threads + 1;
+}
+
+static void
+pool_end( void )
+{
+  int i;
+
+  if( pool_threads <= 0 ) return;
+
+  pthread_mutex_lock( &pool_lock );
+  pool_quit = 1;
+  pthread_cond_broadcast( &pool_start );
+  pthread_mutex_unlock( &pool_lock );
+
+  for( i = 0; i < pool_threads; i++ )
+    pthread_join( pool_workers[i], NULL );
+
+  pool_threads = -1;
+  pool_quit = 0;
+}
+
+static void
+pool_run( const scaler_job *job )
+{
+  pthread_mutex_lock( &pool_lock );
+  pool_job = *job;
+  pool_pending = job->bands - 1;
+  pool_generation++;
+  pthread_cond_broadcast( &pool_start );
+  pthread_mutex_unlock( &pool_lock );
+
+  scaler_run_band( job, 0 );
+
+  pthread_mutex_lock( &pool_lock );
+  while( pool_pending ) pthread_cond_wait( &pool_done, &pool_lock );
+  pthread_mutex_unlock( &pool_lock );
+}
+
+#else				/* #ifdef HAVE_PTHREAD */
+
+static int
+pool_init( void )
+{
+  return 1;
+}
+
+static void
+pool_end( void )
+{
+}
+
+static void
+pool_run( const scaler_job *job GCC_UNUSED )
+{
+}
+
+#endif				/* #ifdef HAVE_PTHREAD */
+
+void
+scaler_run( scaler_type scaler, ScalerProc *proc,
+            const libspectrum_byte *srcPtr, libspectrum_dword srcPitch,
+            libspectrum_byte *dstPtr, libspectrum_dword dstPitch,
+            int width, int height )
+{
+  const struct scaler_info *info = &available_scalers[ scaler ];
+  ScalerPrepareProc *prepare;
+  scaler_job job;
+  int threads;
+
+  prepare = proc == info->scaler32 ? info->prepare32 : info->prepare16;
+  if( prepare ) prepare( srcPtr, srcPitch, width, height );
+
+  job.proc = proc;
+  job.src = srcPtr; job.src_pitch = srcPitch;
+  job.dst = dstPtr; job.dst_pitch = dstPitch;
+  job.width = width; job.height = height;
+  job.factor = scaler_scale_number( scaler, 1 );
+  job.bands = 1;
+
+  if( info->flags & SCALER_FLAGS_PARALLEL && height >= 2 * SCALER_MIN_BAND ) {
+    threads = pool_init();
+    job.bands = height / SCALER_MIN_BAND;
+    if( job.bands > threads ) job.bands = threads;
+  }
+
+  if( job.bands > 1 ) {
+    pool_run( &job );
+  } else {
+    proc( srcPtr, srcPitch, dstPtr, dstPitch, width, height );
+  }
+}
+
+scaler_simd_type scaler_simd = SCALER_SIMD_NONE;
+
+void
+scaler_simd_select( void )
+{
+  scaler_simd = SCALER_SIMD_NONE;
+
+#ifdef SCALER_HAVE_SSE2
+  scaler_simd = SCALER_SIMD_SSE2;
+#endif				/* #ifdef SCALER_HAVE_SSE2 */
+
+#ifdef SCALER_HAVE_AVX2
+  __builtin_cpu_init();
+  if( __builtin_cpu_supports( "avx2" ) ) scaler_simd = SCALER_SIMD_AVX2;
+#endif				/* #ifdef SCALER_HAVE_AVX2 */
+
+#ifdef SCALER_HAVE_NEON
+  scaler_simd = SCALER_SIMD_NEON;
+#endif				/* #ifdef SCALER_HAVE_NEON */
+}
+
+static int
+scaler_init( void *context )
+{
+  /* Not every UI selects a bitformat, so make sure the vector routines are
+     chosen before anything is scaled */
+  scaler_simd_select();
+
+  return 0;
+}
+
+static void
+scaler_end( void )
+{
+  pool_end();
+}
+
+void
+scaler_register_startup( void )
+{
+  startup_manager_register_no_dependencies( STARTUP_MANAGER_MODULE_SCALER,
+                                            scaler_init, NULL, scaler_end );
+}
+
 /* The expansion functions */
 
 /* Clip after expansion */
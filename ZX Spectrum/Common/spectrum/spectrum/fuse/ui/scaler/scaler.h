@@ -55,6 +55,7 @@ typedef enum scaler_type {
 typedef enum scaler_flags_t {
   SCALER_FLAGS_NONE        = 0,
   SCALER_FLAGS_EXPAND      = 1 << 0,
+  SCALER_FLAGS_PARALLEL    = 1 << 1,
 } scaler_flags_t;
 
 typedef enum scale_factor_t {
@@ -98,4 +99,13 @@ scaler_expand_fn* scaler_get_expander( scaler_type scaler );
 
 int scaler_select_bitformat( libspectrum_dword BitFormat );
 
+void scaler_register_startup( void );
+
+/* Run a scaler over an area. Scalers with SCALER_FLAGS_PARALLEL set have the
+   area split into horizontal bands which are scaled on a pool of threads */
+void scaler_run( scaler_type scaler, ScalerProc *proc,
+                 const libspectrum_byte *srcPtr, libspectrum_dword srcPitch,
+                 libspectrum_byte *dstPtr, libspectrum_dword dstPitch,
+                 int width, int height );
+
 #endif
@@ -181,7 +181,7 @@
       case 50:
 	{
 	  *q = HQ_PIXEL00_22;
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q1 = HQ_PIXEL01_10;
 	  } else {
 	    *q1 = HQ_PIXEL01_20;
@@ -196,7 +196,7 @@
 	  *q = HQ_PIXEL00_20;
 	  *q1 = HQ_PIXEL01_22;
 	  *qN = HQ_PIXEL10_21;
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qN1 = HQ_PIXEL11_10;
 	  } else {
 	    *qN1 = HQ_PIXEL11_20;
@@ -208,7 +208,7 @@
 	{
 	  *q = HQ_PIXEL00_21;
 	  *q1 = HQ_PIXEL01_20;
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qN = HQ_PIXEL10_10;
 	  } else {
 	    *qN = HQ_PIXEL10_20;
@@ -219,7 +219,7 @@
       case 10:
       case 138:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_10;
 	  } else {
 	    *q = HQ_PIXEL00_20;
@@ -289,7 +289,7 @@
       case 54:
 	{
 	  *q = HQ_PIXEL00_22;
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q1 = HQ_PIXEL01_0;
 	  } else {
 	    *q1 = HQ_PIXEL01_20;
@@ -304,7 +304,7 @@
 	  *q = HQ_PIXEL00_20;
 	  *q1 = HQ_PIXEL01_22;
 	  *qN = HQ_PIXEL10_21;
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qN1 = HQ_PIXEL11_0;
 	  } else {
 	    *qN1 = HQ_PIXEL11_20;
@@ -316,7 +316,7 @@
 	{
 	  *q = HQ_PIXEL00_21;
 	  *q1 = HQ_PIXEL01_20;
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qN = HQ_PIXEL10_0;
 	  } else {
 	    *qN = HQ_PIXEL10_20;
@@ -327,7 +327,7 @@
       case 11:
       case 139:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_0;
 	  } else {
 	    *q = HQ_PIXEL00_20;
@@ -340,7 +340,7 @@
       case 19:
       case 51:
 	{
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q = HQ_PIXEL00_11;
 	    *q1 = HQ_PIXEL01_10;
 	  } else {
@@ -355,7 +355,7 @@
       case 178:
 	{
 	  *q = HQ_PIXEL00_22;
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q1 = HQ_PIXEL01_10;
 	    *qN1 = HQ_PIXEL11_12;
 	  } else {
@@ -369,7 +369,7 @@
       case 85:
 	{
 	  *q = HQ_PIXEL00_20;
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *q1 = HQ_PIXEL01_11;
 	    *qN1 = HQ_PIXEL11_10;
 	  } else {
@@ -384,7 +384,7 @@
 	{
 	  *q = HQ_PIXEL00_20;
 	  *q1 = HQ_PIXEL01_22;
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qN = HQ_PIXEL10_12;
 	    *qN1 = HQ_PIXEL11_10;
 	  } else {
@@ -398,7 +398,7 @@
 	{
 	  *q = HQ_PIXEL00_21;
 	  *q1 = HQ_PIXEL01_20;
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qN = HQ_PIXEL10_10;
 	    *qN1 = HQ_PIXEL11_11;
 	  } else {
@@ -410,7 +410,7 @@
       case 73:
       case 77:
 	{
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *q = HQ_PIXEL00_12;
 	    *qN = HQ_PIXEL10_10;
 	  } else {
@@ -424,7 +424,7 @@
       case 42:
       case 170:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_10;
 	    *qN = HQ_PIXEL10_11;
 	  } else {
@@ -438,7 +438,7 @@
       case 14:
       case 142:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_10;
 	    *q1 = HQ_PIXEL01_12;
 	  } else {
@@ -516,12 +516,12 @@
       case 26:
       case 31:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_0;
 	  } else {
 	    *q = HQ_PIXEL00_20;
 	  }
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q1 = HQ_PIXEL01_0;
 	  } else {
 	    *q1 = HQ_PIXEL01_20;
@@ -534,13 +534,13 @@
       case 214:
 	{
 	  *q = HQ_PIXEL00_22;
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q1 = HQ_PIXEL01_0;
 	  } else {
 	    *q1 = HQ_PIXEL01_20;
 	  }
 	  *qN = HQ_PIXEL10_21;
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qN1 = HQ_PIXEL11_0;
 	  } else {
 	    *qN1 = HQ_PIXEL11_20;
@@ -552,12 +552,12 @@
 	{
 	  *q = HQ_PIXEL00_21;
 	  *q1 = HQ_PIXEL01_22;
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qN = HQ_PIXEL10_0;
 	  } else {
 	    *qN = HQ_PIXEL10_20;
 	  }
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qN1 = HQ_PIXEL11_0;
 	  } else {
 	    *qN1 = HQ_PIXEL11_20;
@@ -567,13 +567,13 @@
       case 74:
       case 107:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_0;
 	  } else {
 	    *q = HQ_PIXEL00_20;
 	  }
 	  *q1 = HQ_PIXEL01_21;
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qN = HQ_PIXEL10_0;
 	  } else {
 	    *qN = HQ_PIXEL10_20;
@@ -583,7 +583,7 @@
 	}
       case 27:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_0;
 	  } else {
 	    *q = HQ_PIXEL00_20;
@@ -596,7 +596,7 @@
       case 86:
 	{
 	  *q = HQ_PIXEL00_22;
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q1 = HQ_PIXEL01_0;
 	  } else {
 	    *q1 = HQ_PIXEL01_20;
@@ -610,7 +610,7 @@
 	  *q = HQ_PIXEL00_21;
 	  *q1 = HQ_PIXEL01_22;
 	  *qN = HQ_PIXEL10_10;
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qN1 = HQ_PIXEL11_0;
 	  } else {
 	    *qN1 = HQ_PIXEL11_20;
@@ -621,7 +621,7 @@
 	{
 	  *q = HQ_PIXEL00_10;
 	  *q1 = HQ_PIXEL01_21;
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qN = HQ_PIXEL10_0;
 	  } else {
 	    *qN = HQ_PIXEL10_20;
@@ -632,7 +632,7 @@
       case 30:
 	{
 	  *q = HQ_PIXEL00_10;
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q1 = HQ_PIXEL01_0;
 	  } else {
 	    *q1 = HQ_PIXEL01_20;
@@ -646,7 +646,7 @@
 	  *q = HQ_PIXEL00_22;
 	  *q1 = HQ_PIXEL01_10;
 	  *qN = HQ_PIXEL10_21;
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qN1 = HQ_PIXEL11_0;
 	  } else {
 	    *qN1 = HQ_PIXEL11_20;
@@ -657,7 +657,7 @@
 	{
 	  *q = HQ_PIXEL00_21;
 	  *q1 = HQ_PIXEL01_22;
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qN = HQ_PIXEL10_0;
 	  } else {
 	    *qN = HQ_PIXEL10_20;
@@ -667,7 +667,7 @@
 	}
       case 75:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_0;
 	  } else {
 	    *q = HQ_PIXEL00_20;
@@ -775,12 +775,12 @@
 	}
       case 58:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_10;
 	  } else {
 	    *q = HQ_PIXEL00_70;
 	  }
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q1 = HQ_PIXEL01_10;
 	  } else {
 	    *q1 = HQ_PIXEL01_70;
@@ -792,13 +792,13 @@
       case 83:
 	{
 	  *q = HQ_PIXEL00_11;
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q1 = HQ_PIXEL01_10;
 	  } else {
 	    *q1 = HQ_PIXEL01_70;
 	  }
 	  *qN = HQ_PIXEL10_21;
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qN1 = HQ_PIXEL11_10;
 	  } else {
 	    *qN1 = HQ_PIXEL11_70;
@@ -809,12 +809,12 @@
 	{
 	  *q = HQ_PIXEL00_21;
 	  *q1 = HQ_PIXEL01_11;
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qN = HQ_PIXEL10_10;
 	  } else {
 	    *qN = HQ_PIXEL10_70;
 	  }
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qN1 = HQ_PIXEL11_10;
 	  } else {
 	    *qN1 = HQ_PIXEL11_70;
@@ -823,13 +823,13 @@
 	}
       case 202:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_10;
 	  } else {
 	    *q = HQ_PIXEL00_70;
 	  }
 	  *q1 = HQ_PIXEL01_21;
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qN = HQ_PIXEL10_10;
 	  } else {
 	    *qN = HQ_PIXEL10_70;
@@ -839,13 +839,13 @@
 	}
       case 78:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_10;
 	  } else {
 	    *q = HQ_PIXEL00_70;
 	  }
 	  *q1 = HQ_PIXEL01_12;
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qN = HQ_PIXEL10_10;
 	  } else {
 	    *qN = HQ_PIXEL10_70;
@@ -855,12 +855,12 @@
 	}
       case 154:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_10;
 	  } else {
 	    *q = HQ_PIXEL00_70;
 	  }
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q1 = HQ_PIXEL01_10;
 	  } else {
 	    *q1 = HQ_PIXEL01_70;
@@ -872,13 +872,13 @@
       case 114:
 	{
 	  *q = HQ_PIXEL00_22;
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q1 = HQ_PIXEL01_10;
 	  } else {
 	    *q1 = HQ_PIXEL01_70;
 	  }
 	  *qN = HQ_PIXEL10_12;
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qN1 = HQ_PIXEL11_10;
 	  } else {
 	    *qN1 = HQ_PIXEL11_70;
@@ -889,12 +889,12 @@
 	{
 	  *q = HQ_PIXEL00_12;
 	  *q1 = HQ_PIXEL01_22;
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qN = HQ_PIXEL10_10;
 	  } else {
 	    *qN = HQ_PIXEL10_70;
 	  }
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qN1 = HQ_PIXEL11_10;
 	  } else {
 	    *qN1 = HQ_PIXEL11_70;
@@ -903,22 +903,22 @@
 	}
       case 90:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_10;
 	  } else {
 	    *q = HQ_PIXEL00_70;
 	  }
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q1 = HQ_PIXEL01_10;
 	  } else {
 	    *q1 = HQ_PIXEL01_70;
 	  }
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qN = HQ_PIXEL10_10;
 	  } else {
 	    *qN = HQ_PIXEL10_70;
 	  }
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qN1 = HQ_PIXEL11_10;
 	  } else {
 	    *qN1 = HQ_PIXEL11_70;
@@ -928,7 +928,7 @@
       case 55:
       case 23:
 	{
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q = HQ_PIXEL00_11;
 	    *q1 = HQ_PIXEL01_0;
 	  } else {
@@ -943,7 +943,7 @@
       case 150:
 	{
 	  *q = HQ_PIXEL00_22;
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q1 = HQ_PIXEL01_0;
 	    *qN1 = HQ_PIXEL11_12;
 	  } else {
@@ -957,7 +957,7 @@
       case 212:
 	{
 	  *q = HQ_PIXEL00_20;
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *q1 = HQ_PIXEL01_11;
 	    *qN1 = HQ_PIXEL11_0;
 	  } else {
@@ -972,7 +972,7 @@
 	{
 	  *q = HQ_PIXEL00_20;
 	  *q1 = HQ_PIXEL01_22;
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qN = HQ_PIXEL10_12;
 	    *qN1 = HQ_PIXEL11_0;
 	  } else {
@@ -986,7 +986,7 @@
 	{
 	  *q = HQ_PIXEL00_21;
 	  *q1 = HQ_PIXEL01_20;
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qN = HQ_PIXEL10_0;
 	    *qN1 = HQ_PIXEL11_11;
 	  } else {
@@ -998,7 +998,7 @@
       case 109:
       case 105:
 	{
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *q = HQ_PIXEL00_12;
 	    *qN = HQ_PIXEL10_0;
 	  } else {
@@ -1012,7 +1012,7 @@
       case 171:
       case 43:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_0;
 	    *qN = HQ_PIXEL10_11;
 	  } else {
@@ -1026,7 +1026,7 @@
       case 143:
       case 15:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_0;
 	    *q1 = HQ_PIXEL01_12;
 	  } else {
@@ -1041,7 +1041,7 @@
 	{
 	  *q = HQ_PIXEL00_21;
 	  *q1 = HQ_PIXEL01_11;
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qN = HQ_PIXEL10_0;
 	  } else {
 	    *qN = HQ_PIXEL10_20;
@@ -1051,7 +1051,7 @@
 	}
       case 203:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_0;
 	  } else {
 	    *q = HQ_PIXEL00_20;
@@ -1064,7 +1064,7 @@
       case 62:
 	{
 	  *q = HQ_PIXEL00_10;
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q1 = HQ_PIXEL01_0;
 	  } else {
 	    *q1 = HQ_PIXEL01_20;
@@ -1078,7 +1078,7 @@
 	  *q = HQ_PIXEL00_11;
 	  *q1 = HQ_PIXEL01_10;
 	  *qN = HQ_PIXEL10_21;
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qN1 = HQ_PIXEL11_0;
 	  } else {
 	    *qN1 = HQ_PIXEL11_20;
@@ -1088,7 +1088,7 @@
       case 118:
 	{
 	  *q = HQ_PIXEL00_22;
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q1 = HQ_PIXEL01_0;
 	  } else {
 	    *q1 = HQ_PIXEL01_20;
@@ -1102,7 +1102,7 @@
 	  *q = HQ_PIXEL00_12;
 	  *q1 = HQ_PIXEL01_22;
 	  *qN = HQ_PIXEL10_10;
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qN1 = HQ_PIXEL11_0;
 	  } else {
 	    *qN1 = HQ_PIXEL11_20;
@@ -1113,7 +1113,7 @@
 	{
 	  *q = HQ_PIXEL00_10;
 	  *q1 = HQ_PIXEL01_12;
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qN = HQ_PIXEL10_0;
 	  } else {
 	    *qN = HQ_PIXEL10_20;
@@ -1123,7 +1123,7 @@
 	}
       case 155:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_0;
 	  } else {
 	    *q = HQ_PIXEL00_20;
@@ -1201,12 +1201,12 @@
 	{
 	  *q = HQ_PIXEL00_21;
 	  *q1 = HQ_PIXEL01_11;
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qN = HQ_PIXEL10_10;
 	  } else {
 	    *qN = HQ_PIXEL10_70;
 	  }
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qN1 = HQ_PIXEL11_0;
 	  } else {
 	    *qN1 = HQ_PIXEL11_20;
@@ -1215,12 +1215,12 @@
 	}
       case 158:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_10;
 	  } else {
 	    *q = HQ_PIXEL00_70;
 	  }
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q1 = HQ_PIXEL01_0;
 	  } else {
 	    *q1 = HQ_PIXEL01_20;
@@ -1231,13 +1231,13 @@
 	}
       case 234:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_10;
 	  } else {
 	    *q = HQ_PIXEL00_70;
 	  }
 	  *q1 = HQ_PIXEL01_21;
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qN = HQ_PIXEL10_0;
 	  } else {
 	    *qN = HQ_PIXEL10_20;
@@ -1248,13 +1248,13 @@
       case 242:
 	{
 	  *q = HQ_PIXEL00_22;
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q1 = HQ_PIXEL01_10;
 	  } else {
 	    *q1 = HQ_PIXEL01_70;
 	  }
 	  *qN = HQ_PIXEL10_12;
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qN1 = HQ_PIXEL11_0;
 	  } else {
 	    *qN1 = HQ_PIXEL11_20;
@@ -1263,12 +1263,12 @@
 	}
       case 59:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_0;
 	  } else {
 	    *q = HQ_PIXEL00_20;
 	  }
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q1 = HQ_PIXEL01_10;
 	  } else {
 	    *q1 = HQ_PIXEL01_70;
@@ -1281,12 +1281,12 @@
 	{
 	  *q = HQ_PIXEL00_12;
 	  *q1 = HQ_PIXEL01_22;
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qN = HQ_PIXEL10_0;
 	  } else {
 	    *qN = HQ_PIXEL10_20;
 	  }
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qN1 = HQ_PIXEL11_10;
 	  } else {
 	    *qN1 = HQ_PIXEL11_70;
@@ -1296,13 +1296,13 @@
       case 87:
 	{
 	  *q = HQ_PIXEL00_11;
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q1 = HQ_PIXEL01_0;
 	  } else {
 	    *q1 = HQ_PIXEL01_20;
 	  }
 	  *qN = HQ_PIXEL10_21;
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qN1 = HQ_PIXEL11_10;
 	  } else {
 	    *qN1 = HQ_PIXEL11_70;
@@ -1311,13 +1311,13 @@
 	}
       case 79:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_0;
 	  } else {
 	    *q = HQ_PIXEL00_20;
 	  }
 	  *q1 = HQ_PIXEL01_12;
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qN = HQ_PIXEL10_10;
 	  } else {
 	    *qN = HQ_PIXEL10_70;
@@ -1327,22 +1327,22 @@
 	}
       case 122:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_10;
 	  } else {
 	    *q = HQ_PIXEL00_70;
 	  }
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q1 = HQ_PIXEL01_10;
 	  } else {
 	    *q1 = HQ_PIXEL01_70;
 	  }
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qN = HQ_PIXEL10_0;
 	  } else {
 	    *qN = HQ_PIXEL10_20;
 	  }
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qN1 = HQ_PIXEL11_10;
 	  } else {
 	    *qN1 = HQ_PIXEL11_70;
@@ -1351,22 +1351,22 @@
 	}
       case 94:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_10;
 	  } else {
 	    *q = HQ_PIXEL00_70;
 	  }
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q1 = HQ_PIXEL01_0;
 	  } else {
 	    *q1 = HQ_PIXEL01_20;
 	  }
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qN = HQ_PIXEL10_10;
 	  } else {
 	    *qN = HQ_PIXEL10_70;
 	  }
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qN1 = HQ_PIXEL11_10;
 	  } else {
 	    *qN1 = HQ_PIXEL11_70;
@@ -1375,22 +1375,22 @@
 	}
       case 218:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_10;
 	  } else {
 	    *q = HQ_PIXEL00_70;
 	  }
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q1 = HQ_PIXEL01_10;
 	  } else {
 	    *q1 = HQ_PIXEL01_70;
 	  }
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qN = HQ_PIXEL10_10;
 	  } else {
 	    *qN = HQ_PIXEL10_70;
 	  }
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qN1 = HQ_PIXEL11_0;
 	  } else {
 	    *qN1 = HQ_PIXEL11_20;
@@ -1399,22 +1399,22 @@
 	}
       case 91:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_0;
 	  } else {
 	    *q = HQ_PIXEL00_20;
 	  }
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q1 = HQ_PIXEL01_10;
 	  } else {
 	    *q1 = HQ_PIXEL01_70;
 	  }
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qN = HQ_PIXEL10_10;
 	  } else {
 	    *qN = HQ_PIXEL10_70;
 	  }
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qN1 = HQ_PIXEL11_10;
 	  } else {
 	    *qN1 = HQ_PIXEL11_70;
@@ -1455,12 +1455,12 @@
 	}
       case 186:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_10;
 	  } else {
 	    *q = HQ_PIXEL00_70;
 	  }
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q1 = HQ_PIXEL01_10;
 	  } else {
 	    *q1 = HQ_PIXEL01_70;
@@ -1472,13 +1472,13 @@
       case 115:
 	{
 	  *q = HQ_PIXEL00_11;
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q1 = HQ_PIXEL01_10;
 	  } else {
 	    *q1 = HQ_PIXEL01_70;
 	  }
 	  *qN = HQ_PIXEL10_12;
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qN1 = HQ_PIXEL11_10;
 	  } else {
 	    *qN1 = HQ_PIXEL11_70;
@@ -1489,12 +1489,12 @@
 	{
 	  *q = HQ_PIXEL00_12;
 	  *q1 = HQ_PIXEL01_11;
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qN = HQ_PIXEL10_10;
 	  } else {
 	    *qN = HQ_PIXEL10_70;
 	  }
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qN1 = HQ_PIXEL11_10;
 	  } else {
 	    *qN1 = HQ_PIXEL11_70;
@@ -1503,13 +1503,13 @@
 	}
       case 206:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_10;
 	  } else {
 	    *q = HQ_PIXEL00_70;
 	  }
 	  *q1 = HQ_PIXEL01_12;
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qN = HQ_PIXEL10_10;
 	  } else {
 	    *qN = HQ_PIXEL10_70;
@@ -1522,7 +1522,7 @@
 	{
 	  *q = HQ_PIXEL00_12;
 	  *q1 = HQ_PIXEL01_20;
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qN = HQ_PIXEL10_10;
 	  } else {
 	    *qN = HQ_PIXEL10_70;
@@ -1533,7 +1533,7 @@
       case 174:
       case 46:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_10;
 	  } else {
 	    *q = HQ_PIXEL00_70;
@@ -1547,7 +1547,7 @@
       case 147:
 	{
 	  *q = HQ_PIXEL00_11;
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q1 = HQ_PIXEL01_10;
 	  } else {
 	    *q1 = HQ_PIXEL01_70;
@@ -1562,7 +1562,7 @@
 	  *q = HQ_PIXEL00_20;
 	  *q1 = HQ_PIXEL01_11;
 	  *qN = HQ_PIXEL10_12;
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qN1 = HQ_PIXEL11_10;
 	  } else {
 	    *qN1 = HQ_PIXEL11_70;
@@ -1588,12 +1588,12 @@
       case 126:
 	{
 	  *q = HQ_PIXEL00_10;
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q1 = HQ_PIXEL01_0;
 	  } else {
 	    *q1 = HQ_PIXEL01_20;
 	  }
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qN = HQ_PIXEL10_0;
 	  } else {
 	    *qN = HQ_PIXEL10_20;
@@ -1603,14 +1603,14 @@
 	}
       case 219:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_0;
 	  } else {
 	    *q = HQ_PIXEL00_20;
 	  }
 	  *q1 = HQ_PIXEL01_10;
 	  *qN = HQ_PIXEL10_10;
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qN1 = HQ_PIXEL11_0;
 	  } else {
 	    *qN1 = HQ_PIXEL11_20;
@@ -1619,7 +1619,7 @@
 	}
       case 125:
 	{
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *q = HQ_PIXEL00_12;
 	    *qN = HQ_PIXEL10_0;
 	  } else {
@@ -1633,7 +1633,7 @@
       case 221:
 	{
 	  *q = HQ_PIXEL00_12;
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *q1 = HQ_PIXEL01_11;
 	    *qN1 = HQ_PIXEL11_0;
 	  } else {
@@ -1645,7 +1645,7 @@
 	}
       case 207:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_0;
 	    *q1 = HQ_PIXEL01_12;
 	  } else {
@@ -1660,7 +1660,7 @@
 	{
 	  *q = HQ_PIXEL00_10;
 	  *q1 = HQ_PIXEL01_12;
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qN = HQ_PIXEL10_0;
 	    *qN1 = HQ_PIXEL11_11;
 	  } else {
@@ -1672,7 +1672,7 @@
       case 190:
 	{
 	  *q = HQ_PIXEL00_10;
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q1 = HQ_PIXEL01_0;
 	    *qN1 = HQ_PIXEL11_12;
 	  } else {
@@ -1684,7 +1684,7 @@
 	}
       case 187:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_0;
 	    *qN = HQ_PIXEL10_11;
 	  } else {
@@ -1699,7 +1699,7 @@
 	{
 	  *q = HQ_PIXEL00_11;
 	  *q1 = HQ_PIXEL01_10;
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qN = HQ_PIXEL10_12;
 	    *qN1 = HQ_PIXEL11_0;
 	  } else {
@@ -1710,7 +1710,7 @@
 	}
       case 119:
 	{
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q = HQ_PIXEL00_11;
 	    *q1 = HQ_PIXEL01_0;
 	  } else {
@@ -1726,7 +1726,7 @@
 	{
 	  *q = HQ_PIXEL00_12;
 	  *q1 = HQ_PIXEL01_20;
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qN = HQ_PIXEL10_0;
 	  } else {
 	    *qN = HQ_PIXEL10_100;
@@ -1737,7 +1737,7 @@
       case 175:
       case 47:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_0;
 	  } else {
 	    *q = HQ_PIXEL00_100;
@@ -1751,7 +1751,7 @@
       case 151:
 	{
 	  *q = HQ_PIXEL00_11;
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q1 = HQ_PIXEL01_0;
 	  } else {
 	    *q1 = HQ_PIXEL01_100;
@@ -1766,7 +1766,7 @@
 	  *q = HQ_PIXEL00_20;
 	  *q1 = HQ_PIXEL01_11;
 	  *qN = HQ_PIXEL10_12;
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qN1 = HQ_PIXEL11_0;
 	  } else {
 	    *qN1 = HQ_PIXEL11_100;
@@ -1777,12 +1777,12 @@
 	{
 	  *q = HQ_PIXEL00_10;
 	  *q1 = HQ_PIXEL01_10;
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qN = HQ_PIXEL10_0;
 	  } else {
 	    *qN = HQ_PIXEL10_20;
 	  }
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qN1 = HQ_PIXEL11_0;
 	  } else {
 	    *qN1 = HQ_PIXEL11_20;
@@ -1791,13 +1791,13 @@
 	}
       case 123:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_0;
 	  } else {
 	    *q = HQ_PIXEL00_20;
 	  }
 	  *q1 = HQ_PIXEL01_10;
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qN = HQ_PIXEL10_0;
 	  } else {
 	    *qN = HQ_PIXEL10_20;
@@ -1807,12 +1807,12 @@
 	}
       case 95:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_0;
 	  } else {
 	    *q = HQ_PIXEL00_20;
 	  }
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q1 = HQ_PIXEL01_0;
 	  } else {
 	    *q1 = HQ_PIXEL01_20;
@@ -1824,13 +1824,13 @@
       case 222:
 	{
 	  *q = HQ_PIXEL00_10;
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q1 = HQ_PIXEL01_0;
 	  } else {
 	    *q1 = HQ_PIXEL01_20;
 	  }
 	  *qN = HQ_PIXEL10_10;
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qN1 = HQ_PIXEL11_0;
 	  } else {
 	    *qN1 = HQ_PIXEL11_20;
@@ -1841,12 +1841,12 @@
 	{
 	  *q = HQ_PIXEL00_21;
 	  *q1 = HQ_PIXEL01_11;
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qN = HQ_PIXEL10_0;
 	  } else {
 	    *qN = HQ_PIXEL10_20;
 	  }
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qN1 = HQ_PIXEL11_0;
 	  } else {
 	    *qN1 = HQ_PIXEL11_100;
@@ -1857,12 +1857,12 @@
 	{
 	  *q = HQ_PIXEL00_12;
 	  *q1 = HQ_PIXEL01_22;
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qN = HQ_PIXEL10_0;
 	  } else {
 	    *qN = HQ_PIXEL10_100;
 	  }
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qN1 = HQ_PIXEL11_0;
 	  } else {
 	    *qN1 = HQ_PIXEL11_20;
@@ -1871,13 +1871,13 @@
 	}
       case 235:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_0;
 	  } else {
 	    *q = HQ_PIXEL00_20;
 	  }
 	  *q1 = HQ_PIXEL01_21;
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qN = HQ_PIXEL10_0;
 	  } else {
 	    *qN = HQ_PIXEL10_100;
@@ -1887,13 +1887,13 @@
 	}
       case 111:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_0;
 	  } else {
 	    *q = HQ_PIXEL00_100;
 	  }
 	  *q1 = HQ_PIXEL01_12;
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qN = HQ_PIXEL10_0;
 	  } else {
 	    *qN = HQ_PIXEL10_20;
@@ -1903,12 +1903,12 @@
 	}
       case 63:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_0;
 	  } else {
 	    *q = HQ_PIXEL00_100;
 	  }
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q1 = HQ_PIXEL01_0;
 	  } else {
 	    *q1 = HQ_PIXEL01_20;
@@ -1919,12 +1919,12 @@
 	}
       case 159:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_0;
 	  } else {
 	    *q = HQ_PIXEL00_20;
 	  }
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q1 = HQ_PIXEL01_0;
 	  } else {
 	    *q1 = HQ_PIXEL01_100;
@@ -1936,13 +1936,13 @@
       case 215:
 	{
 	  *q = HQ_PIXEL00_11;
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q1 = HQ_PIXEL01_0;
 	  } else {
 	    *q1 = HQ_PIXEL01_100;
 	  }
 	  *qN = HQ_PIXEL10_21;
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qN1 = HQ_PIXEL11_0;
 	  } else {
 	    *qN1 = HQ_PIXEL11_20;
@@ -1952,13 +1952,13 @@
       case 246:
 	{
 	  *q = HQ_PIXEL00_22;
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q1 = HQ_PIXEL01_0;
 	  } else {
 	    *q1 = HQ_PIXEL01_20;
 	  }
 	  *qN = HQ_PIXEL10_12;
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qN1 = HQ_PIXEL11_0;
 	  } else {
 	    *qN1 = HQ_PIXEL11_100;
@@ -1968,17 +1968,17 @@
       case 254:
 	{
 	  *q = HQ_PIXEL00_10;
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q1 = HQ_PIXEL01_0;
 	  } else {
 	    *q1 = HQ_PIXEL01_20;
 	  }
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qN = HQ_PIXEL10_0;
 	  } else {
 	    *qN = HQ_PIXEL10_20;
 	  }
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qN1 = HQ_PIXEL11_0;
 	  } else {
 	    *qN1 = HQ_PIXEL11_100;
@@ -1989,12 +1989,12 @@
 	{
 	  *q = HQ_PIXEL00_12;
 	  *q1 = HQ_PIXEL01_11;
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qN = HQ_PIXEL10_0;
 	  } else {
 	    *qN = HQ_PIXEL10_100;
 	  }
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qN1 = HQ_PIXEL11_0;
 	  } else {
 	    *qN1 = HQ_PIXEL11_100;
@@ -2003,18 +2003,18 @@
 	}
       case 251:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_0;
 	  } else {
 	    *q = HQ_PIXEL00_20;
 	  }
 	  *q1 = HQ_PIXEL01_10;
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qN = HQ_PIXEL10_0;
 	  } else {
 	    *qN = HQ_PIXEL10_100;
 	  }
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qN1 = HQ_PIXEL11_0;
 	  } else {
 	    *qN1 = HQ_PIXEL11_20;
@@ -2023,13 +2023,13 @@
 	}
       case 239:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_0;
 	  } else {
 	    *q = HQ_PIXEL00_100;
 	  }
 	  *q1 = HQ_PIXEL01_12;
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qN = HQ_PIXEL10_0;
 	  } else {
 	    *qN = HQ_PIXEL10_100;
@@ -2039,17 +2039,17 @@
 	}
       case 127:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_0;
 	  } else {
 	    *q = HQ_PIXEL00_100;
 	  }
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q1 = HQ_PIXEL01_0;
 	  } else {
 	    *q1 = HQ_PIXEL01_20;
 	  }
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qN = HQ_PIXEL10_0;
 	  } else {
 	    *qN = HQ_PIXEL10_20;
@@ -2059,12 +2059,12 @@
 	}
       case 191:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_0;
 	  } else {
 	    *q = HQ_PIXEL00_100;
 	  }
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q1 = HQ_PIXEL01_0;
 	  } else {
 	    *q1 = HQ_PIXEL01_100;
@@ -2075,18 +2075,18 @@
 	}
       case 223:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_0;
 	  } else {
 	    *q = HQ_PIXEL00_20;
 	  }
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q1 = HQ_PIXEL01_0;
 	  } else {
 	    *q1 = HQ_PIXEL01_100;
 	  }
 	  *qN = HQ_PIXEL10_10;
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qN1 = HQ_PIXEL11_0;
 	  } else {
 	    *qN1 = HQ_PIXEL11_20;
@@ -2096,13 +2096,13 @@
       case 247:
 	{
 	  *q = HQ_PIXEL00_11;
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q1 = HQ_PIXEL01_0;
 	  } else {
 	    *q1 = HQ_PIXEL01_100;
 	  }
 	  *qN = HQ_PIXEL10_12;
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qN1 = HQ_PIXEL11_0;
 	  } else {
 	    *qN1 = HQ_PIXEL11_100;
@@ -2111,22 +2111,22 @@
 	}
       case 255:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_0;
 	  } else {
 	    *q = HQ_PIXEL00_100;
 	  }
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q1 = HQ_PIXEL01_0;
 	  } else {
 	    *q1 = HQ_PIXEL01_100;
 	  }
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qN = HQ_PIXEL10_0;
 	  } else {
 	    *qN = HQ_PIXEL10_100;
 	  }
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qN1 = HQ_PIXEL11_0;
 	  } else {
 	    *qN1 = HQ_PIXEL11_100;
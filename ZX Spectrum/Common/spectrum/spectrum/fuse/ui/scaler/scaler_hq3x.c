@@ -246,7 +246,7 @@
       case 50:
 	{
 	  *q = HQ_PIXEL00_1M;
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q1 = HQ_PIXEL01_C;
 	    *q2 = HQ_PIXEL02_1M;
 	    *qN2 = HQ_PIXEL12_C;
@@ -271,7 +271,7 @@
 	  *qN = HQ_PIXEL10_1;
 	  *qN1 = HQ_PIXEL11;
 	  *qNN = HQ_PIXEL20_1M;
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qN2 = HQ_PIXEL12_C;
 	    *qNN1 = HQ_PIXEL21_C;
 	    *qNN2 = HQ_PIXEL22_1M;
@@ -290,7 +290,7 @@
 	  *q2 = HQ_PIXEL02_2;
 	  *qN1 = HQ_PIXEL11;
 	  *qN2 = HQ_PIXEL12_1;
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qN = HQ_PIXEL10_C;
 	    *qNN = HQ_PIXEL20_1M;
 	    *qNN1 = HQ_PIXEL21_C;
@@ -305,7 +305,7 @@
       case 10:
       case 138:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_1M;
 	    *q1 = HQ_PIXEL01_C;
 	    *qN = HQ_PIXEL10_C;
@@ -412,7 +412,7 @@
       case 54:
 	{
 	  *q = HQ_PIXEL00_1M;
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q1 = HQ_PIXEL01_C;
 	    *q2 = HQ_PIXEL02_C;
 	    *qN2 = HQ_PIXEL12_C;
@@ -437,7 +437,7 @@
 	  *qN = HQ_PIXEL10_1;
 	  *qN1 = HQ_PIXEL11;
 	  *qNN = HQ_PIXEL20_1M;
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qN2 = HQ_PIXEL12_C;
 	    *qNN1 = HQ_PIXEL21_C;
 	    *qNN2 = HQ_PIXEL22_C;
@@ -456,7 +456,7 @@
 	  *q2 = HQ_PIXEL02_2;
 	  *qN1 = HQ_PIXEL11;
 	  *qN2 = HQ_PIXEL12_1;
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qN = HQ_PIXEL10_C;
 	    *qNN = HQ_PIXEL20_C;
 	    *qNN1 = HQ_PIXEL21_C;
@@ -471,7 +471,7 @@
       case 11:
       case 139:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_C;
 	    *q1 = HQ_PIXEL01_C;
 	    *qN = HQ_PIXEL10_C;
@@ -491,7 +491,7 @@
       case 19:
       case 51:
 	{
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q = HQ_PIXEL00_1L;
 	    *q1 = HQ_PIXEL01_C;
 	    *q2 = HQ_PIXEL02_1M;
@@ -512,7 +512,7 @@
       case 146:
       case 178:
 	{
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q1 = HQ_PIXEL01_C;
 	    *q2 = HQ_PIXEL02_1M;
 	    *qN2 = HQ_PIXEL12_C;
@@ -533,7 +533,7 @@
       case 84:
       case 85:
 	{
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *q2 = HQ_PIXEL02_1U;
 	    *qN2 = HQ_PIXEL12_C;
 	    *qNN1 = HQ_PIXEL21_C;
@@ -554,7 +554,7 @@
       case 112:
       case 113:
 	{
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qN2 = HQ_PIXEL12_C;
 	    *qNN = HQ_PIXEL20_1L;
 	    *qNN1 = HQ_PIXEL21_C;
@@ -575,7 +575,7 @@
       case 200:
       case 204:
 	{
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qN = HQ_PIXEL10_C;
 	    *qNN = HQ_PIXEL20_1M;
 	    *qNN1 = HQ_PIXEL21_C;
@@ -596,7 +596,7 @@
       case 73:
       case 77:
 	{
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *q = HQ_PIXEL00_1U;
 	    *qN = HQ_PIXEL10_C;
 	    *qNN = HQ_PIXEL20_1M;
@@ -617,7 +617,7 @@
       case 42:
       case 170:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_1M;
 	    *q1 = HQ_PIXEL01_C;
 	    *qN = HQ_PIXEL10_C;
@@ -638,7 +638,7 @@
       case 14:
       case 142:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_1M;
 	    *q1 = HQ_PIXEL01_C;
 	    *q2 = HQ_PIXEL02_1R;
@@ -763,7 +763,7 @@
       case 26:
       case 31:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_C;
 	    *qN = HQ_PIXEL10_C;
 	  } else {
@@ -771,7 +771,7 @@
 	    *qN = HQ_PIXEL10_3;
 	  }
 	  *q1 = HQ_PIXEL01_C;
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q2 = HQ_PIXEL02_C;
 	    *qN2 = HQ_PIXEL12_C;
 	  } else {
@@ -788,7 +788,7 @@
       case 214:
 	{
 	  *q = HQ_PIXEL00_1M;
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q1 = HQ_PIXEL01_C;
 	    *q2 = HQ_PIXEL02_C;
 	  } else {
@@ -799,7 +799,7 @@
 	  *qN1 = HQ_PIXEL11;
 	  *qN2 = HQ_PIXEL12_C;
 	  *qNN = HQ_PIXEL20_1M;
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qNN1 = HQ_PIXEL21_C;
 	    *qNN2 = HQ_PIXEL22_C;
 	  } else {
@@ -815,7 +815,7 @@
 	  *q1 = HQ_PIXEL01_1;
 	  *q2 = HQ_PIXEL02_1M;
 	  *qN1 = HQ_PIXEL11;
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qN = HQ_PIXEL10_C;
 	    *qNN = HQ_PIXEL20_C;
 	  } else {
@@ -823,7 +823,7 @@
 	    *qNN = HQ_PIXEL20_4;
 	  }
 	  *qNN1 = HQ_PIXEL21_C;
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qN2 = HQ_PIXEL12_C;
 	    *qNN2 = HQ_PIXEL22_C;
 	  } else {
@@ -835,7 +835,7 @@
       case 74:
       case 107:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_C;
 	    *q1 = HQ_PIXEL01_C;
 	  } else {
@@ -846,7 +846,7 @@
 	  *qN = HQ_PIXEL10_C;
 	  *qN1 = HQ_PIXEL11;
 	  *qN2 = HQ_PIXEL12_1;
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qNN = HQ_PIXEL20_C;
 	    *qNN1 = HQ_PIXEL21_C;
 	  } else {
@@ -858,7 +858,7 @@
 	}
       case 27:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_C;
 	    *q1 = HQ_PIXEL01_C;
 	    *qN = HQ_PIXEL10_C;
@@ -878,7 +878,7 @@
       case 86:
 	{
 	  *q = HQ_PIXEL00_1M;
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q1 = HQ_PIXEL01_C;
 	    *q2 = HQ_PIXEL02_C;
 	    *qN2 = HQ_PIXEL12_C;
@@ -902,7 +902,7 @@
 	  *qN = HQ_PIXEL10_C;
 	  *qN1 = HQ_PIXEL11;
 	  *qNN = HQ_PIXEL20_1M;
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qN2 = HQ_PIXEL12_C;
 	    *qNN1 = HQ_PIXEL21_C;
 	    *qNN2 = HQ_PIXEL22_C;
@@ -920,7 +920,7 @@
 	  *q2 = HQ_PIXEL02_1M;
 	  *qN1 = HQ_PIXEL11;
 	  *qN2 = HQ_PIXEL12_1;
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qN = HQ_PIXEL10_C;
 	    *qNN = HQ_PIXEL20_C;
 	    *qNN1 = HQ_PIXEL21_C;
@@ -935,7 +935,7 @@
       case 30:
 	{
 	  *q = HQ_PIXEL00_1M;
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q1 = HQ_PIXEL01_C;
 	    *q2 = HQ_PIXEL02_C;
 	    *qN2 = HQ_PIXEL12_C;
@@ -959,7 +959,7 @@
 	  *qN = HQ_PIXEL10_1;
 	  *qN1 = HQ_PIXEL11;
 	  *qNN = HQ_PIXEL20_1M;
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qN2 = HQ_PIXEL12_C;
 	    *qNN1 = HQ_PIXEL21_C;
 	    *qNN2 = HQ_PIXEL22_C;
@@ -977,7 +977,7 @@
 	  *q2 = HQ_PIXEL02_1M;
 	  *qN1 = HQ_PIXEL11;
 	  *qN2 = HQ_PIXEL12_C;
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qN = HQ_PIXEL10_C;
 	    *qNN = HQ_PIXEL20_C;
 	    *qNN1 = HQ_PIXEL21_C;
@@ -991,7 +991,7 @@
 	}
       case 75:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_C;
 	    *q1 = HQ_PIXEL01_C;
 	    *qN = HQ_PIXEL10_C;
@@ -1166,13 +1166,13 @@
 	}
       case 58:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_1M;
 	  } else {
 	    *q = HQ_PIXEL00_2;
 	  }
 	  *q1 = HQ_PIXEL01_C;
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q2 = HQ_PIXEL02_1M;
 	  } else {
 	    *q2 = HQ_PIXEL02_2;
@@ -1189,7 +1189,7 @@
 	{
 	  *q = HQ_PIXEL00_1L;
 	  *q1 = HQ_PIXEL01_C;
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q2 = HQ_PIXEL02_1M;
 	  } else {
 	    *q2 = HQ_PIXEL02_2;
@@ -1199,7 +1199,7 @@
 	  *qN2 = HQ_PIXEL12_C;
 	  *qNN = HQ_PIXEL20_1M;
 	  *qNN1 = HQ_PIXEL21_C;
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qNN2 = HQ_PIXEL22_1M;
 	  } else {
 	    *qNN2 = HQ_PIXEL22_2;
@@ -1214,13 +1214,13 @@
 	  *qN = HQ_PIXEL10_C;
 	  *qN1 = HQ_PIXEL11;
 	  *qN2 = HQ_PIXEL12_C;
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qNN = HQ_PIXEL20_1M;
 	  } else {
 	    *qNN = HQ_PIXEL20_2;
 	  }
 	  *qNN1 = HQ_PIXEL21_C;
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qNN2 = HQ_PIXEL22_1M;
 	  } else {
 	    *qNN2 = HQ_PIXEL22_2;
@@ -1229,7 +1229,7 @@
 	}
       case 202:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_1M;
 	  } else {
 	    *q = HQ_PIXEL00_2;
@@ -1239,7 +1239,7 @@
 	  *qN = HQ_PIXEL10_C;
 	  *qN1 = HQ_PIXEL11;
 	  *qN2 = HQ_PIXEL12_1;
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qNN = HQ_PIXEL20_1M;
 	  } else {
 	    *qNN = HQ_PIXEL20_2;
@@ -1250,7 +1250,7 @@
 	}
       case 78:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_1M;
 	  } else {
 	    *q = HQ_PIXEL00_2;
@@ -1260,7 +1260,7 @@
 	  *qN = HQ_PIXEL10_C;
 	  *qN1 = HQ_PIXEL11;
 	  *qN2 = HQ_PIXEL12_1;
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qNN = HQ_PIXEL20_1M;
 	  } else {
 	    *qNN = HQ_PIXEL20_2;
@@ -1271,13 +1271,13 @@
 	}
       case 154:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_1M;
 	  } else {
 	    *q = HQ_PIXEL00_2;
 	  }
 	  *q1 = HQ_PIXEL01_C;
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q2 = HQ_PIXEL02_1M;
 	  } else {
 	    *q2 = HQ_PIXEL02_2;
@@ -1294,7 +1294,7 @@
 	{
 	  *q = HQ_PIXEL00_1M;
 	  *q1 = HQ_PIXEL01_C;
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q2 = HQ_PIXEL02_1M;
 	  } else {
 	    *q2 = HQ_PIXEL02_2;
@@ -1304,7 +1304,7 @@
 	  *qN2 = HQ_PIXEL12_C;
 	  *qNN = HQ_PIXEL20_1L;
 	  *qNN1 = HQ_PIXEL21_C;
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qNN2 = HQ_PIXEL22_1M;
 	  } else {
 	    *qNN2 = HQ_PIXEL22_2;
@@ -1319,13 +1319,13 @@
 	  *qN = HQ_PIXEL10_C;
 	  *qN1 = HQ_PIXEL11;
 	  *qN2 = HQ_PIXEL12_C;
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qNN = HQ_PIXEL20_1M;
 	  } else {
 	    *qNN = HQ_PIXEL20_2;
 	  }
 	  *qNN1 = HQ_PIXEL21_C;
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qNN2 = HQ_PIXEL22_1M;
 	  } else {
 	    *qNN2 = HQ_PIXEL22_2;
@@ -1334,13 +1334,13 @@
 	}
       case 90:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_1M;
 	  } else {
 	    *q = HQ_PIXEL00_2;
 	  }
 	  *q1 = HQ_PIXEL01_C;
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q2 = HQ_PIXEL02_1M;
 	  } else {
 	    *q2 = HQ_PIXEL02_2;
@@ -1348,13 +1348,13 @@
 	  *qN = HQ_PIXEL10_C;
 	  *qN1 = HQ_PIXEL11;
 	  *qN2 = HQ_PIXEL12_C;
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qNN = HQ_PIXEL20_1M;
 	  } else {
 	    *qNN = HQ_PIXEL20_2;
 	  }
 	  *qNN1 = HQ_PIXEL21_C;
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qNN2 = HQ_PIXEL22_1M;
 	  } else {
 	    *qNN2 = HQ_PIXEL22_2;
@@ -1364,7 +1364,7 @@
       case 55:
       case 23:
 	{
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q = HQ_PIXEL00_1L;
 	    *q1 = HQ_PIXEL01_C;
 	    *q2 = HQ_PIXEL02_C;
@@ -1385,7 +1385,7 @@
       case 182:
       case 150:
 	{
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q1 = HQ_PIXEL01_C;
 	    *q2 = HQ_PIXEL02_C;
 	    *qN2 = HQ_PIXEL12_C;
@@ -1406,7 +1406,7 @@
       case 213:
       case 212:
 	{
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *q2 = HQ_PIXEL02_1U;
 	    *qN2 = HQ_PIXEL12_C;
 	    *qNN1 = HQ_PIXEL21_C;
@@ -1427,7 +1427,7 @@
       case 241:
       case 240:
 	{
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qN2 = HQ_PIXEL12_C;
 	    *qNN = HQ_PIXEL20_1L;
 	    *qNN1 = HQ_PIXEL21_C;
@@ -1448,7 +1448,7 @@
       case 236:
       case 232:
 	{
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qN = HQ_PIXEL10_C;
 	    *qNN = HQ_PIXEL20_C;
 	    *qNN1 = HQ_PIXEL21_C;
@@ -1469,7 +1469,7 @@
       case 109:
       case 105:
 	{
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *q = HQ_PIXEL00_1U;
 	    *qN = HQ_PIXEL10_C;
 	    *qNN = HQ_PIXEL20_C;
@@ -1490,7 +1490,7 @@
       case 171:
       case 43:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_C;
 	    *q1 = HQ_PIXEL01_C;
 	    *qN = HQ_PIXEL10_C;
@@ -1511,7 +1511,7 @@
       case 143:
       case 15:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_C;
 	    *q1 = HQ_PIXEL01_C;
 	    *q2 = HQ_PIXEL02_1R;
@@ -1536,7 +1536,7 @@
 	  *q2 = HQ_PIXEL02_1U;
 	  *qN1 = HQ_PIXEL11;
 	  *qN2 = HQ_PIXEL12_C;
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qN = HQ_PIXEL10_C;
 	    *qNN = HQ_PIXEL20_C;
 	    *qNN1 = HQ_PIXEL21_C;
@@ -1550,7 +1550,7 @@
 	}
       case 203:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_C;
 	    *q1 = HQ_PIXEL01_C;
 	    *qN = HQ_PIXEL10_C;
@@ -1570,7 +1570,7 @@
       case 62:
 	{
 	  *q = HQ_PIXEL00_1M;
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q1 = HQ_PIXEL01_C;
 	    *q2 = HQ_PIXEL02_C;
 	    *qN2 = HQ_PIXEL12_C;
@@ -1594,7 +1594,7 @@
 	  *qN = HQ_PIXEL10_1;
 	  *qN1 = HQ_PIXEL11;
 	  *qNN = HQ_PIXEL20_1M;
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qN2 = HQ_PIXEL12_C;
 	    *qNN1 = HQ_PIXEL21_C;
 	    *qNN2 = HQ_PIXEL22_C;
@@ -1608,7 +1608,7 @@
       case 118:
 	{
 	  *q = HQ_PIXEL00_1M;
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q1 = HQ_PIXEL01_C;
 	    *q2 = HQ_PIXEL02_C;
 	    *qN2 = HQ_PIXEL12_C;
@@ -1632,7 +1632,7 @@
 	  *qN = HQ_PIXEL10_C;
 	  *qN1 = HQ_PIXEL11;
 	  *qNN = HQ_PIXEL20_1M;
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qN2 = HQ_PIXEL12_C;
 	    *qNN1 = HQ_PIXEL21_C;
 	    *qNN2 = HQ_PIXEL22_C;
@@ -1650,7 +1650,7 @@
 	  *q2 = HQ_PIXEL02_1R;
 	  *qN1 = HQ_PIXEL11;
 	  *qN2 = HQ_PIXEL12_1;
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qN = HQ_PIXEL10_C;
 	    *qNN = HQ_PIXEL20_C;
 	    *qNN1 = HQ_PIXEL21_C;
@@ -1664,7 +1664,7 @@
 	}
       case 155:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_C;
 	    *q1 = HQ_PIXEL01_C;
 	    *qN = HQ_PIXEL10_C;
@@ -1792,12 +1792,12 @@
 	  *q2 = HQ_PIXEL02_1U;
 	  *qN = HQ_PIXEL10_C;
 	  *qN1 = HQ_PIXEL11;
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qNN = HQ_PIXEL20_1M;
 	  } else {
 	    *qNN = HQ_PIXEL20_2;
 	  }
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qN2 = HQ_PIXEL12_C;
 	    *qNN1 = HQ_PIXEL21_C;
 	    *qNN2 = HQ_PIXEL22_C;
@@ -1810,12 +1810,12 @@
 	}
       case 158:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_1M;
 	  } else {
 	    *q = HQ_PIXEL00_2;
 	  }
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q1 = HQ_PIXEL01_C;
 	    *q2 = HQ_PIXEL02_C;
 	    *qN2 = HQ_PIXEL12_C;
@@ -1833,7 +1833,7 @@
 	}
       case 234:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_1M;
 	  } else {
 	    *q = HQ_PIXEL00_2;
@@ -1842,7 +1842,7 @@
 	  *q2 = HQ_PIXEL02_1M;
 	  *qN1 = HQ_PIXEL11;
 	  *qN2 = HQ_PIXEL12_1;
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qN = HQ_PIXEL10_C;
 	    *qNN = HQ_PIXEL20_C;
 	    *qNN1 = HQ_PIXEL21_C;
@@ -1858,7 +1858,7 @@
 	{
 	  *q = HQ_PIXEL00_1M;
 	  *q1 = HQ_PIXEL01_C;
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q2 = HQ_PIXEL02_1M;
 	  } else {
 	    *q2 = HQ_PIXEL02_2;
@@ -1866,7 +1866,7 @@
 	  *qN = HQ_PIXEL10_1;
 	  *qN1 = HQ_PIXEL11;
 	  *qNN = HQ_PIXEL20_1L;
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qN2 = HQ_PIXEL12_C;
 	    *qNN1 = HQ_PIXEL21_C;
 	    *qNN2 = HQ_PIXEL22_C;
@@ -1879,7 +1879,7 @@
 	}
       case 59:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_C;
 	    *q1 = HQ_PIXEL01_C;
 	    *qN = HQ_PIXEL10_C;
@@ -1888,7 +1888,7 @@
 	    *q1 = HQ_PIXEL01_3;
 	    *qN = HQ_PIXEL10_3;
 	  }
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q2 = HQ_PIXEL02_1M;
 	  } else {
 	    *q2 = HQ_PIXEL02_2;
@@ -1907,7 +1907,7 @@
 	  *q2 = HQ_PIXEL02_1M;
 	  *qN1 = HQ_PIXEL11;
 	  *qN2 = HQ_PIXEL12_C;
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qN = HQ_PIXEL10_C;
 	    *qNN = HQ_PIXEL20_C;
 	    *qNN1 = HQ_PIXEL21_C;
@@ -1916,7 +1916,7 @@
 	    *qNN = HQ_PIXEL20_4;
 	    *qNN1 = HQ_PIXEL21_3;
 	  }
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qNN2 = HQ_PIXEL22_1M;
 	  } else {
 	    *qNN2 = HQ_PIXEL22_2;
@@ -1926,7 +1926,7 @@
       case 87:
 	{
 	  *q = HQ_PIXEL00_1L;
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q1 = HQ_PIXEL01_C;
 	    *q2 = HQ_PIXEL02_C;
 	    *qN2 = HQ_PIXEL12_C;
@@ -1939,7 +1939,7 @@
 	  *qN1 = HQ_PIXEL11;
 	  *qNN = HQ_PIXEL20_1M;
 	  *qNN1 = HQ_PIXEL21_C;
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qNN2 = HQ_PIXEL22_1M;
 	  } else {
 	    *qNN2 = HQ_PIXEL22_2;
@@ -1948,7 +1948,7 @@
 	}
       case 79:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_C;
 	    *q1 = HQ_PIXEL01_C;
 	    *qN = HQ_PIXEL10_C;
@@ -1960,7 +1960,7 @@
 	  *q2 = HQ_PIXEL02_1R;
 	  *qN1 = HQ_PIXEL11;
 	  *qN2 = HQ_PIXEL12_1;
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qNN = HQ_PIXEL20_1M;
 	  } else {
 	    *qNN = HQ_PIXEL20_2;
@@ -1971,20 +1971,20 @@
 	}
       case 122:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_1M;
 	  } else {
 	    *q = HQ_PIXEL00_2;
 	  }
 	  *q1 = HQ_PIXEL01_C;
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q2 = HQ_PIXEL02_1M;
 	  } else {
 	    *q2 = HQ_PIXEL02_2;
 	  }
 	  *qN1 = HQ_PIXEL11;
 	  *qN2 = HQ_PIXEL12_C;
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qN = HQ_PIXEL10_C;
 	    *qNN = HQ_PIXEL20_C;
 	    *qNN1 = HQ_PIXEL21_C;
@@ -1993,7 +1993,7 @@
 	    *qNN = HQ_PIXEL20_4;
 	    *qNN1 = HQ_PIXEL21_3;
 	  }
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qNN2 = HQ_PIXEL22_1M;
 	  } else {
 	    *qNN2 = HQ_PIXEL22_2;
@@ -2002,12 +2002,12 @@
 	}
       case 94:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_1M;
 	  } else {
 	    *q = HQ_PIXEL00_2;
 	  }
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q1 = HQ_PIXEL01_C;
 	    *q2 = HQ_PIXEL02_C;
 	    *qN2 = HQ_PIXEL12_C;
@@ -2018,13 +2018,13 @@
 	  }
 	  *qN = HQ_PIXEL10_C;
 	  *qN1 = HQ_PIXEL11;
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qNN = HQ_PIXEL20_1M;
 	  } else {
 	    *qNN = HQ_PIXEL20_2;
 	  }
 	  *qNN1 = HQ_PIXEL21_C;
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qNN2 = HQ_PIXEL22_1M;
 	  } else {
 	    *qNN2 = HQ_PIXEL22_2;
@@ -2033,25 +2033,25 @@
 	}
       case 218:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_1M;
 	  } else {
 	    *q = HQ_PIXEL00_2;
 	  }
 	  *q1 = HQ_PIXEL01_C;
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q2 = HQ_PIXEL02_1M;
 	  } else {
 	    *q2 = HQ_PIXEL02_2;
 	  }
 	  *qN = HQ_PIXEL10_C;
 	  *qN1 = HQ_PIXEL11;
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qNN = HQ_PIXEL20_1M;
 	  } else {
 	    *qNN = HQ_PIXEL20_2;
 	  }
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qN2 = HQ_PIXEL12_C;
 	    *qNN1 = HQ_PIXEL21_C;
 	    *qNN2 = HQ_PIXEL22_C;
@@ -2064,7 +2064,7 @@
 	}
       case 91:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_C;
 	    *q1 = HQ_PIXEL01_C;
 	    *qN = HQ_PIXEL10_C;
@@ -2073,20 +2073,20 @@
 	    *q1 = HQ_PIXEL01_3;
 	    *qN = HQ_PIXEL10_3;
 	  }
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q2 = HQ_PIXEL02_1M;
 	  } else {
 	    *q2 = HQ_PIXEL02_2;
 	  }
 	  *qN1 = HQ_PIXEL11;
 	  *qN2 = HQ_PIXEL12_C;
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qNN = HQ_PIXEL20_1M;
 	  } else {
 	    *qNN = HQ_PIXEL20_2;
 	  }
 	  *qNN1 = HQ_PIXEL21_C;
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qNN2 = HQ_PIXEL22_1M;
 	  } else {
 	    *qNN2 = HQ_PIXEL22_2;
@@ -2147,13 +2147,13 @@
 	}
       case 186:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_1M;
 	  } else {
 	    *q = HQ_PIXEL00_2;
 	  }
 	  *q1 = HQ_PIXEL01_C;
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q2 = HQ_PIXEL02_1M;
 	  } else {
 	    *q2 = HQ_PIXEL02_2;
@@ -2170,7 +2170,7 @@
 	{
 	  *q = HQ_PIXEL00_1L;
 	  *q1 = HQ_PIXEL01_C;
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q2 = HQ_PIXEL02_1M;
 	  } else {
 	    *q2 = HQ_PIXEL02_2;
@@ -2180,7 +2180,7 @@
 	  *qN2 = HQ_PIXEL12_C;
 	  *qNN = HQ_PIXEL20_1L;
 	  *qNN1 = HQ_PIXEL21_C;
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qNN2 = HQ_PIXEL22_1M;
 	  } else {
 	    *qNN2 = HQ_PIXEL22_2;
@@ -2195,13 +2195,13 @@
 	  *qN = HQ_PIXEL10_C;
 	  *qN1 = HQ_PIXEL11;
 	  *qN2 = HQ_PIXEL12_C;
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qNN = HQ_PIXEL20_1M;
 	  } else {
 	    *qNN = HQ_PIXEL20_2;
 	  }
 	  *qNN1 = HQ_PIXEL21_C;
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qNN2 = HQ_PIXEL22_1M;
 	  } else {
 	    *qNN2 = HQ_PIXEL22_2;
@@ -2210,7 +2210,7 @@
 	}
       case 206:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_1M;
 	  } else {
 	    *q = HQ_PIXEL00_2;
@@ -2220,7 +2220,7 @@
 	  *qN = HQ_PIXEL10_C;
 	  *qN1 = HQ_PIXEL11;
 	  *qN2 = HQ_PIXEL12_1;
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qNN = HQ_PIXEL20_1M;
 	  } else {
 	    *qNN = HQ_PIXEL20_2;
@@ -2238,7 +2238,7 @@
 	  *qN = HQ_PIXEL10_C;
 	  *qN1 = HQ_PIXEL11;
 	  *qN2 = HQ_PIXEL12_1;
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qNN = HQ_PIXEL20_1M;
 	  } else {
 	    *qNN = HQ_PIXEL20_2;
@@ -2250,7 +2250,7 @@
       case 174:
       case 46:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_1M;
 	  } else {
 	    *q = HQ_PIXEL00_2;
@@ -2270,7 +2270,7 @@
 	{
 	  *q = HQ_PIXEL00_1L;
 	  *q1 = HQ_PIXEL01_C;
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q2 = HQ_PIXEL02_1M;
 	  } else {
 	    *q2 = HQ_PIXEL02_2;
@@ -2294,7 +2294,7 @@
 	  *qN2 = HQ_PIXEL12_C;
 	  *qNN = HQ_PIXEL20_1L;
 	  *qNN1 = HQ_PIXEL21_C;
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qNN2 = HQ_PIXEL22_1M;
 	  } else {
 	    *qNN2 = HQ_PIXEL22_2;
@@ -2330,7 +2330,7 @@
       case 126:
 	{
 	  *q = HQ_PIXEL00_1M;
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q1 = HQ_PIXEL01_C;
 	    *q2 = HQ_PIXEL02_C;
 	    *qN2 = HQ_PIXEL12_C;
@@ -2340,7 +2340,7 @@
 	    *qN2 = HQ_PIXEL12_3;
 	  }
 	  *qN1 = HQ_PIXEL11;
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qN = HQ_PIXEL10_C;
 	    *qNN = HQ_PIXEL20_C;
 	    *qNN1 = HQ_PIXEL21_C;
@@ -2354,7 +2354,7 @@
 	}
       case 219:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_C;
 	    *q1 = HQ_PIXEL01_C;
 	    *qN = HQ_PIXEL10_C;
@@ -2366,7 +2366,7 @@
 	  *q2 = HQ_PIXEL02_1M;
 	  *qN1 = HQ_PIXEL11;
 	  *qNN = HQ_PIXEL20_1M;
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qN2 = HQ_PIXEL12_C;
 	    *qNN1 = HQ_PIXEL21_C;
 	    *qNN2 = HQ_PIXEL22_C;
@@ -2379,7 +2379,7 @@
 	}
       case 125:
 	{
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *q = HQ_PIXEL00_1U;
 	    *qN = HQ_PIXEL10_C;
 	    *qNN = HQ_PIXEL20_C;
@@ -2399,7 +2399,7 @@
 	}
       case 221:
 	{
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *q2 = HQ_PIXEL02_1U;
 	    *qN2 = HQ_PIXEL12_C;
 	    *qNN1 = HQ_PIXEL21_C;
@@ -2419,7 +2419,7 @@
 	}
       case 207:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_C;
 	    *q1 = HQ_PIXEL01_C;
 	    *q2 = HQ_PIXEL02_1R;
@@ -2439,7 +2439,7 @@
 	}
       case 238:
 	{
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qN = HQ_PIXEL10_C;
 	    *qNN = HQ_PIXEL20_C;
 	    *qNN1 = HQ_PIXEL21_C;
@@ -2459,7 +2459,7 @@
 	}
       case 190:
 	{
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q1 = HQ_PIXEL01_C;
 	    *q2 = HQ_PIXEL02_C;
 	    *qN2 = HQ_PIXEL12_C;
@@ -2479,7 +2479,7 @@
 	}
       case 187:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_C;
 	    *q1 = HQ_PIXEL01_C;
 	    *qN = HQ_PIXEL10_C;
@@ -2499,7 +2499,7 @@
 	}
       case 243:
 	{
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qN2 = HQ_PIXEL12_C;
 	    *qNN = HQ_PIXEL20_1L;
 	    *qNN1 = HQ_PIXEL21_C;
@@ -2519,7 +2519,7 @@
 	}
       case 119:
 	{
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q = HQ_PIXEL00_1L;
 	    *q1 = HQ_PIXEL01_C;
 	    *q2 = HQ_PIXEL02_C;
@@ -2546,7 +2546,7 @@
 	  *qN = HQ_PIXEL10_C;
 	  *qN1 = HQ_PIXEL11;
 	  *qN2 = HQ_PIXEL12_1;
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qNN = HQ_PIXEL20_C;
 	  } else {
 	    *qNN = HQ_PIXEL20_2;
@@ -2558,7 +2558,7 @@
       case 175:
       case 47:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_C;
 	  } else {
 	    *q = HQ_PIXEL00_2;
@@ -2578,7 +2578,7 @@
 	{
 	  *q = HQ_PIXEL00_1L;
 	  *q1 = HQ_PIXEL01_C;
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q2 = HQ_PIXEL02_C;
 	  } else {
 	    *q2 = HQ_PIXEL02_2;
@@ -2602,7 +2602,7 @@
 	  *qN2 = HQ_PIXEL12_C;
 	  *qNN = HQ_PIXEL20_1L;
 	  *qNN1 = HQ_PIXEL21_C;
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qNN2 = HQ_PIXEL22_C;
 	  } else {
 	    *qNN2 = HQ_PIXEL22_2;
@@ -2615,7 +2615,7 @@
 	  *q1 = HQ_PIXEL01_C;
 	  *q2 = HQ_PIXEL02_1M;
 	  *qN1 = HQ_PIXEL11;
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qN = HQ_PIXEL10_C;
 	    *qNN = HQ_PIXEL20_C;
 	  } else {
@@ -2623,7 +2623,7 @@
 	    *qNN = HQ_PIXEL20_4;
 	  }
 	  *qNN1 = HQ_PIXEL21_C;
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qN2 = HQ_PIXEL12_C;
 	    *qNN2 = HQ_PIXEL22_C;
 	  } else {
@@ -2634,7 +2634,7 @@
 	}
       case 123:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_C;
 	    *q1 = HQ_PIXEL01_C;
 	  } else {
@@ -2645,7 +2645,7 @@
 	  *qN = HQ_PIXEL10_C;
 	  *qN1 = HQ_PIXEL11;
 	  *qN2 = HQ_PIXEL12_C;
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qNN = HQ_PIXEL20_C;
 	    *qNN1 = HQ_PIXEL21_C;
 	  } else {
@@ -2657,7 +2657,7 @@
 	}
       case 95:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_C;
 	    *qN = HQ_PIXEL10_C;
 	  } else {
@@ -2665,7 +2665,7 @@
 	    *qN = HQ_PIXEL10_3;
 	  }
 	  *q1 = HQ_PIXEL01_C;
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q2 = HQ_PIXEL02_C;
 	    *qN2 = HQ_PIXEL12_C;
 	  } else {
@@ -2681,7 +2681,7 @@
       case 222:
 	{
 	  *q = HQ_PIXEL00_1M;
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q1 = HQ_PIXEL01_C;
 	    *q2 = HQ_PIXEL02_C;
 	  } else {
@@ -2692,7 +2692,7 @@
 	  *qN1 = HQ_PIXEL11;
 	  *qN2 = HQ_PIXEL12_C;
 	  *qNN = HQ_PIXEL20_1M;
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qNN1 = HQ_PIXEL21_C;
 	    *qNN2 = HQ_PIXEL22_C;
 	  } else {
@@ -2708,7 +2708,7 @@
 	  *q2 = HQ_PIXEL02_1U;
 	  *qN1 = HQ_PIXEL11;
 	  *qN2 = HQ_PIXEL12_C;
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qN = HQ_PIXEL10_C;
 	    *qNN = HQ_PIXEL20_C;
 	  } else {
@@ -2716,7 +2716,7 @@
 	    *qNN = HQ_PIXEL20_4;
 	  }
 	  *qNN1 = HQ_PIXEL21_C;
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qNN2 = HQ_PIXEL22_C;
 	  } else {
 	    *qNN2 = HQ_PIXEL22_2;
@@ -2730,13 +2730,13 @@
 	  *q2 = HQ_PIXEL02_1M;
 	  *qN = HQ_PIXEL10_C;
 	  *qN1 = HQ_PIXEL11;
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qNN = HQ_PIXEL20_C;
 	  } else {
 	    *qNN = HQ_PIXEL20_2;
 	  }
 	  *qNN1 = HQ_PIXEL21_C;
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qN2 = HQ_PIXEL12_C;
 	    *qNN2 = HQ_PIXEL22_C;
 	  } else {
@@ -2747,7 +2747,7 @@
 	}
       case 235:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_C;
 	    *q1 = HQ_PIXEL01_C;
 	  } else {
@@ -2758,7 +2758,7 @@
 	  *qN = HQ_PIXEL10_C;
 	  *qN1 = HQ_PIXEL11;
 	  *qN2 = HQ_PIXEL12_1;
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qNN = HQ_PIXEL20_C;
 	  } else {
 	    *qNN = HQ_PIXEL20_2;
@@ -2769,7 +2769,7 @@
 	}
       case 111:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_C;
 	  } else {
 	    *q = HQ_PIXEL00_2;
@@ -2779,7 +2779,7 @@
 	  *qN = HQ_PIXEL10_C;
 	  *qN1 = HQ_PIXEL11;
 	  *qN2 = HQ_PIXEL12_1;
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qNN = HQ_PIXEL20_C;
 	    *qNN1 = HQ_PIXEL21_C;
 	  } else {
@@ -2791,13 +2791,13 @@
 	}
       case 63:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_C;
 	  } else {
 	    *q = HQ_PIXEL00_2;
 	  }
 	  *q1 = HQ_PIXEL01_C;
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q2 = HQ_PIXEL02_C;
 	    *qN2 = HQ_PIXEL12_C;
 	  } else {
@@ -2813,7 +2813,7 @@
 	}
       case 159:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_C;
 	    *qN = HQ_PIXEL10_C;
 	  } else {
@@ -2821,7 +2821,7 @@
 	    *qN = HQ_PIXEL10_3;
 	  }
 	  *q1 = HQ_PIXEL01_C;
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q2 = HQ_PIXEL02_C;
 	  } else {
 	    *q2 = HQ_PIXEL02_2;
@@ -2837,7 +2837,7 @@
 	{
 	  *q = HQ_PIXEL00_1L;
 	  *q1 = HQ_PIXEL01_C;
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q2 = HQ_PIXEL02_C;
 	  } else {
 	    *q2 = HQ_PIXEL02_2;
@@ -2846,7 +2846,7 @@
 	  *qN1 = HQ_PIXEL11;
 	  *qN2 = HQ_PIXEL12_C;
 	  *qNN = HQ_PIXEL20_1M;
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qNN1 = HQ_PIXEL21_C;
 	    *qNN2 = HQ_PIXEL22_C;
 	  } else {
@@ -2858,7 +2858,7 @@
       case 246:
 	{
 	  *q = HQ_PIXEL00_1M;
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q1 = HQ_PIXEL01_C;
 	    *q2 = HQ_PIXEL02_C;
 	  } else {
@@ -2870,7 +2870,7 @@
 	  *qN2 = HQ_PIXEL12_C;
 	  *qNN = HQ_PIXEL20_1L;
 	  *qNN1 = HQ_PIXEL21_C;
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qNN2 = HQ_PIXEL22_C;
 	  } else {
 	    *qNN2 = HQ_PIXEL22_2;
@@ -2880,7 +2880,7 @@
       case 254:
 	{
 	  *q = HQ_PIXEL00_1M;
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q1 = HQ_PIXEL01_C;
 	    *q2 = HQ_PIXEL02_C;
 	  } else {
@@ -2888,14 +2888,14 @@
 	    *q2 = HQ_PIXEL02_4;
 	  }
 	  *qN1 = HQ_PIXEL11;
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qN = HQ_PIXEL10_C;
 	    *qNN = HQ_PIXEL20_C;
 	  } else {
 	    *qN = HQ_PIXEL10_3;
 	    *qNN = HQ_PIXEL20_4;
 	  }
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qN2 = HQ_PIXEL12_C;
 	    *qNN1 = HQ_PIXEL21_C;
 	    *qNN2 = HQ_PIXEL22_C;
@@ -2914,13 +2914,13 @@
 	  *qN = HQ_PIXEL10_C;
 	  *qN1 = HQ_PIXEL11;
 	  *qN2 = HQ_PIXEL12_C;
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qNN = HQ_PIXEL20_C;
 	  } else {
 	    *qNN = HQ_PIXEL20_2;
 	  }
 	  *qNN1 = HQ_PIXEL21_C;
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qNN2 = HQ_PIXEL22_C;
 	  } else {
 	    *qNN2 = HQ_PIXEL22_2;
@@ -2929,7 +2929,7 @@
 	}
       case 251:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_C;
 	    *q1 = HQ_PIXEL01_C;
 	  } else {
@@ -2938,7 +2938,7 @@
 	  }
 	  *q2 = HQ_PIXEL02_1M;
 	  *qN1 = HQ_PIXEL11;
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qN = HQ_PIXEL10_C;
 	    *qNN = HQ_PIXEL20_C;
 	    *qNN1 = HQ_PIXEL21_C;
@@ -2947,7 +2947,7 @@
 	    *qNN = HQ_PIXEL20_2;
 	    *qNN1 = HQ_PIXEL21_3;
 	  }
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qN2 = HQ_PIXEL12_C;
 	    *qNN2 = HQ_PIXEL22_C;
 	  } else {
@@ -2958,7 +2958,7 @@
 	}
       case 239:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_C;
 	  } else {
 	    *q = HQ_PIXEL00_2;
@@ -2968,7 +2968,7 @@
 	  *qN = HQ_PIXEL10_C;
 	  *qN1 = HQ_PIXEL11;
 	  *qN2 = HQ_PIXEL12_1;
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qNN = HQ_PIXEL20_C;
 	  } else {
 	    *qNN = HQ_PIXEL20_2;
@@ -2979,7 +2979,7 @@
 	}
       case 127:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_C;
 	    *q1 = HQ_PIXEL01_C;
 	    *qN = HQ_PIXEL10_C;
@@ -2988,7 +2988,7 @@
 	    *q1 = HQ_PIXEL01_3;
 	    *qN = HQ_PIXEL10_3;
 	  }
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q2 = HQ_PIXEL02_C;
 	    *qN2 = HQ_PIXEL12_C;
 	  } else {
@@ -2996,7 +2996,7 @@
 	    *qN2 = HQ_PIXEL12_3;
 	  }
 	  *qN1 = HQ_PIXEL11;
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qNN = HQ_PIXEL20_C;
 	    *qNN1 = HQ_PIXEL21_C;
 	  } else {
@@ -3008,13 +3008,13 @@
 	}
       case 191:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_C;
 	  } else {
 	    *q = HQ_PIXEL00_2;
 	  }
 	  *q1 = HQ_PIXEL01_C;
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q2 = HQ_PIXEL02_C;
 	  } else {
 	    *q2 = HQ_PIXEL02_2;
@@ -3029,14 +3029,14 @@
 	}
       case 223:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_C;
 	    *qN = HQ_PIXEL10_C;
 	  } else {
 	    *q = HQ_PIXEL00_4;
 	    *qN = HQ_PIXEL10_3;
 	  }
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q1 = HQ_PIXEL01_C;
 	    *q2 = HQ_PIXEL02_C;
 	    *qN2 = HQ_PIXEL12_C;
@@ -3047,7 +3047,7 @@
 	  }
 	  *qN1 = HQ_PIXEL11;
 	  *qNN = HQ_PIXEL20_1M;
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qNN1 = HQ_PIXEL21_C;
 	    *qNN2 = HQ_PIXEL22_C;
 	  } else {
@@ -3060,7 +3060,7 @@
 	{
 	  *q = HQ_PIXEL00_1L;
 	  *q1 = HQ_PIXEL01_C;
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q2 = HQ_PIXEL02_C;
 	  } else {
 	    *q2 = HQ_PIXEL02_2;
@@ -3070,7 +3070,7 @@
 	  *qN2 = HQ_PIXEL12_C;
 	  *qNN = HQ_PIXEL20_1L;
 	  *qNN1 = HQ_PIXEL21_C;
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qNN2 = HQ_PIXEL22_C;
 	  } else {
 	    *qNN2 = HQ_PIXEL22_2;
@@ -3079,13 +3079,13 @@
 	}
       case 255:
 	{
-	  if( HQ_YUVDIFF( y[4], u[4], v[4], y[2], u[2], v[2] ) ) {
+	  if( HQ_DIFF( 4, 2 ) ) {
 	    *q = HQ_PIXEL00_C;
 	  } else {
 	    *q = HQ_PIXEL00_2;
 	  }
 	  *q1 = HQ_PIXEL01_C;
-	  if( HQ_YUVDIFF( y[2], u[2], v[2], y[6], u[6], v[6] ) ) {
+	  if( HQ_DIFF( 2, 6 ) ) {
 	    *q2 = HQ_PIXEL02_C;
 	  } else {
 	    *q2 = HQ_PIXEL02_2;
@@ -3093,13 +3093,13 @@
 	  *qN = HQ_PIXEL10_C;
 	  *qN1 = HQ_PIXEL11;
 	  *qN2 = HQ_PIXEL12_C;
-	  if( HQ_YUVDIFF( y[8], u[8], v[8], y[4], u[4], v[4] ) ) {
+	  if( HQ_DIFF( 8, 4 ) ) {
 	    *qNN = HQ_PIXEL20_C;
 	  } else {
 	    *qNN = HQ_PIXEL20_2;
 	  }
 	  *qNN1 = HQ_PIXEL21_C;
-	  if( HQ_YUVDIFF( y[6], u[6], v[6], y[8], u[8], v[8] ) ) {
+	  if( HQ_DIFF( 6, 8 ) ) {
 	    *qNN2 = HQ_PIXEL22_C;
 	  } else {
 	    *qNN2 = HQ_PIXEL22_2;
@@ -33,6 +33,37 @@
 #ifndef FUSE_SCALER_INTERNALS_H
 #define FUSE_SCALER_INTERNALS_H
 
+/* Vector instructions the scalers can be built with. The colour masks for
+   big endian 32-bit pixels don't leave enough headroom to do the TV
+   scanline multiply in 32 bits, so stick with the scalar code there */
+#ifndef WORDS_BIGENDIAN
+
+#if defined( __SSE2__ ) || defined( _M_X64 )
+#define SCALER_HAVE_SSE2
+#if defined( __GNUC__ ) && ( defined( __x86_64__ ) || defined( __i386__ ) )
+#define SCALER_HAVE_AVX2
+#endif				/* #if defined( __GNUC__ ) && ... */
+#endif				/* #if defined( __SSE2__ ) || ... */
+
+#if defined( __ARM_NEON ) || defined( __ARM_NEON__ )
+#define SCALER_HAVE_NEON
+#endif				/* #if defined( __ARM_NEON ) || ... */
+
+#endif				/* #ifndef WORDS_BIGENDIAN */
+
+typedef enum scaler_simd_type {
+  SCALER_SIMD_NONE = 0,
+  SCALER_SIMD_SSE2,
+  SCALER_SIMD_AVX2,
+  SCALER_SIMD_NEON,
+} scaler_simd_type;
+
+/* The vector instructions in use; chosen at runtime from what the CPU
+   supports */
+extern scaler_simd_type scaler_simd;
+
+void scaler_simd_select( void );
+
 #define DECLARE_SCALER( name ) \
          extern void scaler_##name##_16( const libspectrum_byte *srcPtr, \
 					 libspectrum_dword srcPitch, \
@@ -66,4 +97,11 @@ DECLARE_SCALER(PalTV3x);
 DECLARE_SCALER(HQ2x);
 DECLARE_SCALER(HQ3x);
 
+/* Called on the whole area before it is split into bands */
+typedef void ScalerPrepareProc( const libspectrum_byte *srcPtr,
+                                libspectrum_dword srcPitch,
+                                int width, int height );
+
+extern ScalerPrepareProc scaler_HQ_prepare_16, scaler_HQ_prepare_32;
+
 #endif				/* #ifndef FUSE_SCALER_INTERNALS_H */
@@ -0,0 +1,448 @@
+/* scaler_simd.c: included into scalers.c
+   Copyright (c) 2026 The Fuse authors
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+   Author contact information:
+
+   E-mail: philip-fuse@shadowmagic.org.uk
+
+*/
+
+/* Row operations used by the TV, PAL TV and dot matrix scalers, with SSE2,
+   AVX2 and NEON versions chosen at runtime. Each vector version handles as
+   many whole vectors as fit in the row and returns the number of pixels it
+   did; the scalar code finishes off the rest. All the versions give exactly
+   the same results as the scalar code */
+
+#ifdef SCALER_HAVE_SSE2
+#include <emmintrin.h>
+#endif				/* #ifdef SCALER_HAVE_SSE2 */
+
+#ifdef SCALER_HAVE_AVX2
+#include <immintrin.h>
+#endif				/* #ifdef SCALER_HAVE_AVX2 */
+
+#ifdef SCALER_HAVE_NEON
+#include <arm_neon.h>
+#endif				/* #ifdef SCALER_HAVE_NEON */
+
+/* Darken a pixel to 7/8 brightness for the gap between scanlines. The
+   masks are passed in so the compiler can keep them in registers rather
+   than reloading them after every store */
+static inline scaler_data_type
+simd_shade( scaler_data_type p, libspectrum_dword rb, libspectrum_dword g )
+{
+  return ( ( ( ( p & rb ) * 7 ) >> 3 ) & rb ) |
+         ( ( ( ( p & g  ) * 7 ) >> 3 ) & g  );
+}
+
+/* Type-specific helpers for the x86 versions. In 16 bits, (x * 7) >> 3 is
+   exactly the high half of x * 0xe000; in 32 bits the masks leave enough
+   room to do the multiply directly */
+
+#ifdef SCALER_HAVE_SSE2
+
+#if SCALER_DATA_SIZE == 2
+
+#define SSE2_SET1( x ) _mm_set1_epi16( (short)(x) )
+#define SSE2_UNPACKLO _mm_unpacklo_epi16
+#define SSE2_UNPACKHI _mm_unpackhi_epi16
+#define SSE2_SRLI2( x ) _mm_srli_epi16( x, 2 )
+#define SSE2_SUB _mm_sub_epi16
+
+static inline __m128i
+sse2_times_7_8( __m128i x )
+{
+  return _mm_mulhi_epu16( x, _mm_set1_epi16( (short)0xe000 ) );
+}
+
+#else				/* #if SCALER_DATA_SIZE == 2 */
+
+#define SSE2_SET1( x ) _mm_set1_epi32( (int)(x) )
+#define SSE2_UNPACKLO _mm_unpacklo_epi32
+#define SSE2_UNPACKHI _mm_unpackhi_epi32
+#define SSE2_SRLI2( x ) _mm_srli_epi32( x, 2 )
+#define SSE2_SUB _mm_sub_epi32
+
+static inline __m128i
+sse2_times_7_8( __m128i x )
+{
+  return _mm_srli_epi32( _mm_sub_epi32( _mm_slli_epi32( x, 3 ), x ), 3 );
+}
+
+#endif				/* #if SCALER_DATA_SIZE == 2 */
+
+#define SSE2_PIXELS ( 16 / SCALER_DATA_SIZE )
+
+static inline __m128i
+sse2_shade( __m128i p, __m128i rb, __m128i g )
+{
+  return _mm_or_si128(
+    _mm_and_si128( sse2_times_7_8( _mm_and_si128( p, rb ) ), rb ),
+    _mm_and_si128( sse2_times_7_8( _mm_and_si128( p, g  ) ), g  )
+  );
+}
+
+static int
+shade_row_sse2( const scaler_data_type *src, scaler_data_type *dst, int n )
+{
+  __m128i rb = SSE2_SET1( redblueMask ), g = SSE2_SET1( greenMask );
+  int i;
+
+  for( i = 0; i + SSE2_PIXELS <= n; i += SSE2_PIXELS ) {
+    __m128i p = _mm_loadu_si128( (const __m128i*)( src + i ) );
+    _mm_storeu_si128( (__m128i*)( dst + i ), sse2_shade( p, rb, g ) );
+  }
+
+  return i;
+}
+
+static int
+double_row_sse2( const scaler_data_type *src, scaler_data_type *dst, int n )
+{
+  int i;
+
+  for( i = 0; i + SSE2_PIXELS <= n; i += SSE2_PIXELS ) {
+    __m128i p = _mm_loadu_si128( (const __m128i*)( src + i ) );
+    _mm_storeu_si128( (__m128i*)( dst + 2 * i ), SSE2_UNPACKLO( p, p ) );
+    _mm_storeu_si128( (__m128i*)( dst + 2 * i + SSE2_PIXELS ),
+                      SSE2_UNPACKHI( p, p ) );
+  }
+
+  return i;
+}
+
+static int
+dotmatrix_row_sse2( const scaler_data_type *src, scaler_data_type *dst, int n,
+                    const scaler_data_type *mask )
+{
+  __m128i m, d;
+  int i;
+
+#if SCALER_DATA_SIZE == 2
+  m = _mm_setr_epi16( mask[0], mask[1], mask[2], mask[3],
+                      mask[0], mask[1], mask[2], mask[3] );
+#else
+  m = _mm_setr_epi32( mask[0], mask[1], mask[2], mask[3] );
+#endif
+
+  for( i = 0; i + SSE2_PIXELS <= n; i += SSE2_PIXELS ) {
+    __m128i p = _mm_loadu_si128( (const __m128i*)( src + i ) );
+    d = SSE2_UNPACKLO( p, p );
+    _mm_storeu_si128( (__m128i*)( dst + 2 * i ),
+                      SSE2_SUB( d, _mm_and_si128( SSE2_SRLI2( d ), m ) ) );
+    d = SSE2_UNPACKHI( p, p );
+    _mm_storeu_si128( (__m128i*)( dst + 2 * i + SSE2_PIXELS ),
+                      SSE2_SUB( d, _mm_and_si128( SSE2_SRLI2( d ), m ) ) );
+  }
+
+  return i;
+}
+
+#endif				/* #ifdef SCALER_HAVE_SSE2 */
+
+#ifdef SCALER_HAVE_AVX2
+
+#define AVX2_FN static __attribute__(( target( "avx2" ) )) int
+
+#if SCALER_DATA_SIZE == 2
+#define AVX2_SET1( x ) _mm256_set1_epi16( (short)(x) )
+#define AVX2_UNPACKLO _mm256_unpacklo_epi16
+#define AVX2_UNPACKHI _mm256_unpackhi_epi16
+#define AVX2_SRLI2( x ) _mm256_srli_epi16( x, 2 )
+#define AVX2_SUB _mm256_sub_epi16
+#define AVX2_TIMES_7_8( x ) \
+  _mm256_mulhi_epu16( x, _mm256_set1_epi16( (short)0xe000 ) )
+#else				/* #if SCALER_DATA_SIZE == 2 */
+#define AVX2_SET1( x ) _mm256_set1_epi32( (int)(x) )
+#define AVX2_UNPACKLO _mm256_unpacklo_epi32
+#define AVX2_UNPACKHI _mm256_unpackhi_epi32
+#define AVX2_SRLI2( x ) _mm256_srli_epi32( x, 2 )
+#define AVX2_SUB _mm256_sub_epi32
+#define AVX2_TIMES_7_8( x ) \
+  _mm256_srli_epi32( _mm256_sub_epi32( _mm256_slli_epi32( x, 3 ), x ), 3 )
+#endif				/* #if SCALER_DATA_SIZE == 2 */
+
+#define AVX2_PIXELS ( 32 / SCALER_DATA_SIZE )
+
+AVX2_FN
+shade_row_avx2( const scaler_data_type *src, scaler_data_type *dst, int n )
+{
+  __m256i rb = AVX2_SET1( redblueMask ), g = AVX2_SET1( greenMask );
+  int i;
+
+  for( i = 0; i + AVX2_PIXELS <= n; i += AVX2_PIXELS ) {
+    __m256i p = _mm256_loadu_si256( (const __m256i*)( src + i ) );
+    __m256i a = _mm256_and_si256( p, rb ), b = _mm256_and_si256( p, g );
+    a = _mm256_and_si256( AVX2_TIMES_7_8( a ), rb );
+    b = _mm256_and_si256( AVX2_TIMES_7_8( b ), g );
+    _mm256_storeu_si256( (__m256i*)( dst + i ), _mm256_or_si256( a, b ) );
+  }
+
+  return i;
+}
+
+/* The unpacks work within each 128-bit half, so put the halves back in
+   order afterwards */
+AVX2_FN
+double_row_avx2( const scaler_data_type *src, scaler_data_type *dst, int n )
+{
+  int i;
+
+  for( i = 0; i + AVX2_PIXELS <= n; i += AVX2_PIXELS ) {
+    __m256i p = _mm256_loadu_si256( (const __m256i*)( src + i ) );
+    __m256i lo = AVX2_UNPACKLO( p, p ), hi = AVX2_UNPACKHI( p, p );
+    _mm256_storeu_si256( (__m256i*)( dst + 2 * i ),
+                         _mm256_permute2x128_si256( lo, hi, 0x20 ) );
+    _mm256_storeu_si256( (__m256i*)( dst + 2 * i + AVX2_PIXELS ),
+                         _mm256_permute2x128_si256( lo, hi, 0x31 ) );
+  }
+
+  return i;
+}
+
+AVX2_FN
+dotmatrix_row_avx2( const scaler_data_type *src, scaler_data_type *dst, int n,
+                    const scaler_data_type *mask )
+{
+  __m256i m, lo, hi;
+  int i;
+
+#if SCALER_DATA_SIZE == 2
+  m = _mm256_setr_epi16( mask[0], mask[1], mask[2], mask[3],
+                         mask[0], mask[1], mask[2], mask[3],
+                         mask[0], mask[1], mask[2], mask[3],
+                         mask[0], mask[1], mask[2], mask[3] );
+#else
+  m = _mm256_setr_epi32( mask[0], mask[1], mask[2], mask[3],
+                         mask[0], mask[1], mask[2], mask[3] );
+#endif
+
+  for( i = 0; i + AVX2_PIXELS <= n; i += AVX2_PIXELS ) {
+    __m256i p = _mm256_loadu_si256( (const __m256i*)( src + i ) );
+    lo = AVX2_UNPACKLO( p, p ); hi = AVX2_UNPACKHI( p, p );
+    lo = AVX2_SUB( lo, _mm256_and_si256( AVX2_SRLI2( lo ), m ) );
+    hi = AVX2_SUB( hi, _mm256_and_si256( AVX2_SRLI2( hi ), m ) );
+    _mm256_storeu_si256( (__m256i*)( dst + 2 * i ),
+                         _mm256_permute2x128_si256( lo, hi, 0x20 ) );
+    _mm256_storeu_si256( (__m256i*)( dst + 2 * i + AVX2_PIXELS ),
+                         _mm256_permute2x128_si256( lo, hi, 0x31 ) );
+  }
+
+  return i;
+}
+
+#endif				/* #ifdef SCALER_HAVE_AVX2 */
+
+#ifdef SCALER_HAVE_NEON
+
+#if SCALER_DATA_SIZE == 2
+
+#define NEON_PIXELS 8
+
+static inline uint16x8_t
+neon_times_7_8( uint16x8_t x )
+{
+  uint16x4_t seven = vdup_n_u16( 7 );
+
+  return vcombine_u16( vshrn_n_u32( vmull_u16( vget_low_u16( x ), seven ), 3 ),
+                       vshrn_n_u32( vmull_u16( vget_high_u16( x ), seven ), 3 ) );
+}
+
+static int
+shade_row_neon( const scaler_data_type *src, scaler_data_type *dst, int n )
+{
+  uint16x8_t rb = vdupq_n_u16( redblueMask ), g = vdupq_n_u16( greenMask );
+  int i;
+
+  for( i = 0; i + NEON_PIXELS <= n; i += NEON_PIXELS ) {
+    uint16x8_t p = vld1q_u16( src + i );
+    vst1q_u16( dst + i,
+               vorrq_u16( vandq_u16( neon_times_7_8( vandq_u16( p, rb ) ), rb ),
+                          vandq_u16( neon_times_7_8( vandq_u16( p, g ) ), g ) ) );
+  }
+
+  return i;
+}
+
+static int
+double_row_neon( const scaler_data_type *src, scaler_data_type *dst, int n )
+{
+  int i;
+
+  for( i = 0; i + NEON_PIXELS <= n; i += NEON_PIXELS ) {
+    uint16x8x2_t d;
+    d.val[0] = d.val[1] = vld1q_u16( src + i );
+    vst2q_u16( dst + 2 * i, d );
+  }
+
+  return i;
+}
+
+static int
+dotmatrix_row_neon( const scaler_data_type *src, scaler_data_type *dst, int n,
+                    const scaler_data_type *mask )
+{
+  /* vst2 interleaves, so the even and odd output pixels each see every
+     other mask entry */
+  const scaler_data_type even[4] = { mask[0], mask[2], mask[0], mask[2] };
+  const scaler_data_type odd[4] = { mask[1], mask[3], mask[1], mask[3] };
+  uint16x8_t me = vcombine_u16( vld1_u16( even ), vld1_u16( even ) );
+  uint16x8_t mo = vcombine_u16( vld1_u16( odd ), vld1_u16( odd ) );
+  int i;
+
+  for( i = 0; i + NEON_PIXELS <= n; i += NEON_PIXELS ) {
+    uint16x8_t p = vld1q_u16( src + i );
+    uint16x8x2_t d;
+    d.val[0] = vsubq_u16( p, vandq_u16( vshrq_n_u16( p, 2 ), me ) );
+    d.val[1] = vsubq_u16( p, vandq_u16( vshrq_n_u16( p, 2 ), mo ) );
+    vst2q_u16( dst + 2 * i, d );
+  }
+
+  return i;
+}
+
+#else				/* #if SCALER_DATA_SIZE == 2 */
+
+#define NEON_PIXELS 4
+
+static int
+shade_row_neon( const scaler_data_type *src, scaler_data_type *dst, int n )
+{
+  uint32x4_t rb = vdupq_n_u32( redblueMask ), g = vdupq_n_u32( greenMask );
+  int i;
+
+  for( i = 0; i + NEON_PIXELS <= n; i += NEON_PIXELS ) {
+    uint32x4_t p = vld1q_u32( src + i );
+    uint32x4_t a = vshrq_n_u32( vmulq_n_u32( vandq_u32( p, rb ), 7 ), 3 );
+    uint32x4_t b = vshrq_n_u32( vmulq_n_u32( vandq_u32( p, g ), 7 ), 3 );
+    vst1q_u32( dst + i, vorrq_u32( vandq_u32( a, rb ), vandq_u32( b, g ) ) );
+  }
+
+  return i;
+}
+
+static int
+double_row_neon( const scaler_data_type *src, scaler_data_type *dst, int n )
+{
+  int i;
+
+  for( i = 0; i + NEON_PIXELS <= n; i += NEON_PIXELS ) {
+    uint32x4x2_t d;
+    d.val[0] = d.val[1] = vld1q_u32( src + i );
+    vst2q_u32( dst + 2 * i, d );
+  }
+
+  return i;
+}
+
+static int
+dotmatrix_row_neon( const scaler_data_type *src, scaler_data_type *dst, int n,
+                    const scaler_data_type *mask )
+{
+  const scaler_data_type even[4] = { mask[0], mask[2], mask[0], mask[2] };
+  const scaler_data_type odd[4] = { mask[1], mask[3], mask[1], mask[3] };
+  uint32x4_t me = vld1q_u32( even ), mo = vld1q_u32( odd );
+  int i;
+
+  for( i = 0; i + NEON_PIXELS <= n; i += NEON_PIXELS ) {
+    uint32x4_t p = vld1q_u32( src + i );
+    uint32x4x2_t d;
+    d.val[0] = vsubq_u32( p, vandq_u32( vshrq_n_u32( p, 2 ), me ) );
+    d.val[1] = vsubq_u32( p, vandq_u32( vshrq_n_u32( p, 2 ), mo ) );
+    vst2q_u32( dst + 2 * i, d );
+  }
+
+  return i;
+}
+
+#endif				/* #if SCALER_DATA_SIZE == 2 */
+
+#endif				/* #ifdef SCALER_HAVE_NEON */
+
+/* dst[i] = src[i] darkened for the scanline gap */
+static void
+shade_row( const scaler_data_type *src, scaler_data_type *dst, int n )
+{
+  libspectrum_dword rb = redblueMask, g = greenMask;
+  int i = 0;
+
+  switch( scaler_simd ) {
+#ifdef SCALER_HAVE_AVX2
+  case SCALER_SIMD_AVX2: i = shade_row_avx2( src, dst, n ); break;
+#endif
+#ifdef SCALER_HAVE_SSE2
+  case SCALER_SIMD_SSE2: i = shade_row_sse2( src, dst, n ); break;
+#endif
+#ifdef SCALER_HAVE_NEON
+  case SCALER_SIMD_NEON: i = shade_row_neon( src, dst, n ); break;
+#endif
+  default: break;
+  }
+
+  for( ; i < n; i++ ) dst[i] = simd_shade( src[i], rb, g );
+}
+
+/* dst[2i] = dst[2i+1] = src[i] */
+static void
+double_row( const scaler_data_type *src, scaler_data_type *dst, int n )
+{
+  int i = 0;
+
+  switch( scaler_simd ) {
+#ifdef SCALER_HAVE_AVX2
+  case SCALER_SIMD_AVX2: i = double_row_avx2( src, dst, n ); break;
+#endif
+#ifdef SCALER_HAVE_SSE2
+  case SCALER_SIMD_SSE2: i = double_row_sse2( src, dst, n ); break;
+#endif
+#ifdef SCALER_HAVE_NEON
+  case SCALER_SIMD_NEON: i = double_row_neon( src, dst, n ); break;
+#endif
+  default: break;
+  }
+
+  for( ; i < n; i++ ) dst[ 2 * i ] = dst[ 2 * i + 1 ] = src[i];
+}
+
+/* Double a row, taking away a quarter of each output pixel masked by
+   mask[ output pixel & 3 ] */
+static void
+dotmatrix_row( const scaler_data_type *src, scaler_data_type *dst, int n,
+               const scaler_data_type *mask )
+{
+  scaler_data_type c, m0 = mask[0], m1 = mask[1], m2 = mask[2], m3 = mask[3];
+  int i = 0;
+
+  switch( scaler_simd ) {
+#ifdef SCALER_HAVE_AVX2
+  case SCALER_SIMD_AVX2: i = dotmatrix_row_avx2( src, dst, n, mask ); break;
+#endif
+#ifdef SCALER_HAVE_SSE2
+  case SCALER_SIMD_SSE2: i = dotmatrix_row_sse2( src, dst, n, mask ); break;
+#endif
+#ifdef SCALER_HAVE_NEON
+  case SCALER_SIMD_NEON: i = dotmatrix_row_neon( src, dst, n, mask ); break;
+#endif
+  default: break;
+  }
+
+  for( ; i < n; i++ ) {
+    c = src[i];
+    dst[ 2 * i     ] = c - ( ( c >> 2 ) & ( i & 1 ? m2 : m0 ) );
+    dst[ 2 * i + 1 ] = c - ( ( c >> 2 ) & ( i & 1 ? m3 : m1 ) );
+  }
+}
@@ -46,6 +46,8 @@
 #define ABS(x)     ((x)>=0?(x):-(x))
 #endif
 
+static void hq_colours_reset( void );
+
 /* The actual code for the scalers starts here */
 
 #if SCALER_DATA_SIZE == 2
@@ -136,6 +138,11 @@ scaler_select_bitformat( libspectrum_dword BitFormat )
 
   }
 
+  /* The same pixel value may now be a different colour */
+  hq_colours_reset();
+
+  scaler_simd_select();
+
   return 0;
 }
 
@@ -243,6 +250,8 @@ Q_INTERPOLATE( libspectrum_dword A, libspectrum_dword B, libspectrum_dword C,
   return x + y;
 }
 
+#include "scaler_simd.c"
+
 /* HQ scalers */
 #define HQ_INTERPOLATE_1(A,B) Q_INTERPOLATE(A,A,A,B)
 
@@ -1076,7 +1085,6 @@ FUNCTION( scaler_TV2x )( const libspectrum_byte *srcPtr,
 			 libspectrum_dword dstPitch,
 			 int width, int height )
 {
-  int i, j;
   unsigned int nextlineSrc = srcPitch / sizeof( scaler_data_type );
   const scaler_data_type *p = (const scaler_data_type*)srcPtr;
 
@@ -1084,18 +1092,8 @@ FUNCTION( scaler_TV2x )( const libspectrum_byte *srcPtr,
   scaler_data_type *q = (scaler_data_type*)dstPtr;
 
   while(height--) {
-    for (i = 0, j = 0; i < width; ++i, j += 2) {
-      scaler_data_type p1 = *(p + i);
-      scaler_data_type pi;
-
-      pi  = (((p1 & redblueMask) * 7) >> 3) & redblueMask;
-      pi |= (((p1 & greenMask  ) * 7) >> 3) & greenMask;
-
-      *(q + j) = p1;
-      *(q + j + 1) = p1;
-      *(q + j + nextlineDst) = pi;
-      *(q + j + nextlineDst + 1) = pi;
-    }
+    double_row( p, q, width );
+    shade_row( q, q + nextlineDst, width * 2 );
     p += nextlineSrc;
     q += nextlineDst << 1;
   }
@@ -1117,23 +1115,13 @@ FUNCTION( scaler_TV3x )( const libspectrum_byte *srcPtr,
   while(height--) {
     for (i = 0, j = 0; i < width; ++i, j += 3) {
       scaler_data_type p1 = *(p + i);
-      scaler_data_type pi;
-
-      pi  = (((p1 & redblueMask) * 7) >> 3) & redblueMask;
-      pi |= (((p1 & greenMask  ) * 7) >> 3) & greenMask;
 
       *(q + j) = p1;
       *(q + j + 1) = p1;
       *(q + j + 2) = p1;
-
-      *(q + j + nextlineDst) = p1;
-      *(q + j + nextlineDst + 1) = p1;
-      *(q + j + nextlineDst + 2) = p1;
-
-      *(q + j + (nextlineDst << 1)) = pi;
-      *(q + j + (nextlineDst << 1) + 1) = pi;
-      *(q + j + (nextlineDst << 1) + 2) = pi;
     }
+    memcpy( q + nextlineDst, q, width * 3 * sizeof( scaler_data_type ) );
+    shade_row( q, q + (nextlineDst << 1), width * 3 );
     p += nextlineSrc;
     q += nextlineDst * 3;
   }
@@ -1146,7 +1134,6 @@ FUNCTION( scaler_TimexTV )( const libspectrum_byte *srcPtr,
 			    libspectrum_dword dstPitch,
 			    int width, int height )
 {
-  int i, j;
   unsigned int nextlineSrc = srcPitch / sizeof( scaler_data_type );
   const scaler_data_type *p = (const scaler_data_type *)srcPtr;
 
@@ -1155,26 +1142,14 @@ FUNCTION( scaler_TimexTV )( const libspectrum_byte *srcPtr,
 
   while(height--) {
     if( ( height & 1 ) == 0 ) {
-      for (i = 0, j = 0; i < width; ++i, j++ ) {
-        scaler_data_type p1 = *(p + i);
-        scaler_data_type pi;
-
-	pi  = (((p1 & redblueMask) * 7) >> 3) & redblueMask;
-	pi |= (((p1 & greenMask  ) * 7) >> 3) & greenMask;
-
-        *(q + j) = p1;
-        *(q + j + nextlineDst) = pi;
-      }
+      memcpy( q, p, width * sizeof( scaler_data_type ) );
+      shade_row( p, q + nextlineDst, width );
       q += nextlineDst << 1;
     }
     p += nextlineSrc;
   }
 }
 
-static inline scaler_data_type DOT_16(scaler_data_type c, int j, int i) {
-  return c - ((c >> 2) & *(dotmatrix + ((j & 3) << 2) + (i & 3)));
-}
-
 void
 FUNCTION( scaler_DotMatrix )( const libspectrum_byte *srcPtr,
 			      libspectrum_dword srcPitch,
@@ -1182,7 +1157,7 @@ FUNCTION( scaler_DotMatrix )( const libspectrum_byte *srcPtr,
 			      libspectrum_dword dstPitch,
 			      int width, int height )
 {
-  int i, j, ii, jj;
+  int j, jj;
   unsigned int nextlineSrc = srcPitch / sizeof( scaler_data_type );
   const scaler_data_type *p = (const scaler_data_type *)srcPtr;
 
@@ -1190,13 +1165,9 @@ FUNCTION( scaler_DotMatrix )( const libspectrum_byte *srcPtr,
   scaler_data_type *q = (scaler_data_type *)dstPtr;
 
   for (j = 0, jj = 0; j < height; ++j, jj += 2) {
-    for (i = 0, ii = 0; i < width; ++i, ii += 2) {
-      scaler_data_type c = *(p + i);
-      *(q + ii) = DOT_16(c, jj, ii);
-      *(q + ii + 1) = DOT_16(c, jj, ii + 1);
-      *(q + ii + nextlineDst) = DOT_16(c, jj + 1, ii);
-      *(q + ii + nextlineDst + 1) = DOT_16(c, jj + 1, ii + 1);
-    }
+    dotmatrix_row( p, q, width, dotmatrix + ( ( jj & 3 ) << 2 ) );
+    dotmatrix_row( p, q + nextlineDst, width,
+                   dotmatrix + ( ( ( jj + 1 ) & 3 ) << 2 ) );
     p += nextlineSrc;
     q += nextlineDst << 1;
   }
@@ -1474,13 +1445,6 @@ FUNCTION( scaler_PalTV2x )( const libspectrum_byte *srcPtr,
       *q = rx + ( gx << 8 ) + ( bx << 16 );
 #endif
 
-      if( settings_current.pal_tv2x )
-        *(q + nextlineDst) =
-            ((((*q & redblueMask) * 7) >> 3) & redblueMask) |
-                ((((*q & greenMask  ) * 7) >> 3) & greenMask);
-      else
-        *(q + nextlineDst) = *q;
-
       q++;
 #if SCALER_DATA_SIZE == 2
 /* 3.b. RGB => RGB */
@@ -1492,17 +1456,14 @@ FUNCTION( scaler_PalTV2x )( const libspectrum_byte *srcPtr,
 #else
       *q = r1 + ( g1 << 8 ) + ( b1 << 16 );
 #endif
-      if( settings_current.pal_tv2x )
-        *(q + nextlineDst) =
-            ((((*q & redblueMask) * 7) >> 3) & redblueMask) |
-                ((((*q & greenMask  ) * 7) >> 3) & greenMask);
-      else
-        *(q + nextlineDst) = *q;
-
       q++;
       y1 = y2; u1 = u2; v1 = v2;        /* save for next point */
       r1 = r0; g1 = g0; b1 = b0;
     }
+    if( settings_current.pal_tv2x )
+      shade_row( q0, q0 + nextlineDst, width * 2 );
+    else
+      memcpy( q0 + nextlineDst, q0, width * 2 * sizeof( scaler_data_type ) );
     p0 += nextlineSrc;
     q0 += nextlineDst << 1;
   }
@@ -1615,15 +1576,6 @@ FUNCTION( scaler_PalTV3x )( const libspectrum_byte *srcPtr,
 #else
       *q = rx + ( gx << 8 ) + ( bx << 16 );     /* E, E, e */
 #endif
-      *(q + nextlineDst) = *q;
-
-      if( settings_current.pal_tv2x )
-        *(q + (nextlineDst << 1)) =
-            ((((*q & redblueMask) * 7) >> 3) & redblueMask) |
-                ((((*q & greenMask  ) * 7) >> 3) & greenMask);
-      else
-        *(q + (nextlineDst << 1)) = *q;
-
       q++;
 #if SCALER_DATA_SIZE == 2
 /* 3.b. RGB => RGB */
@@ -1635,15 +1587,6 @@ FUNCTION( scaler_PalTV3x )( const libspectrum_byte *srcPtr,
 #else
       *q = r2 + ( g2 << 8 ) + ( b2 << 16 );     /* F, F, f*/
 #endif
-      *(q + nextlineDst) = *q;
-
-      if( settings_current.pal_tv2x )
-        *(q + (nextlineDst << 1)) =
-            ((((*q & redblueMask) * 7) >> 3) & redblueMask) |
-                ((((*q & greenMask  ) * 7) >> 3) & greenMask);
-      else
-        *(q + (nextlineDst << 1)) = *q;
-
       q++;
 #if SCALER_DATA_SIZE == 2
 /* 3.b. RGB => RGB */
@@ -1655,27 +1598,198 @@ FUNCTION( scaler_PalTV3x )( const libspectrum_byte *srcPtr,
 #else
       *q = r1 + ( g1 << 8 ) + ( b1 << 16 );     /* G, G, g*/
 #endif
-      *(q + nextlineDst) = *q;
-      if( settings_current.pal_tv2x )
-        *(q + (nextlineDst << 1)) =
-            ((((*q & redblueMask) * 7) >> 3) & redblueMask) |
-                ((((*q & greenMask  ) * 7) >> 3) & greenMask);
-      else
-        *(q + (nextlineDst << 1)) = *q;
-
       q++;
       y1 = y2; u1 = u2; v1 = v2;        /* save for next point */
       r1 = r0; g1 = g0; b1 = b0;
     }
+    memcpy( q0 + nextlineDst, q0, width * 3 * sizeof( scaler_data_type ) );
+    if( settings_current.pal_tv2x )
+      shade_row( q0, q0 + (nextlineDst << 1), width * 3 );
+    else
+      memcpy( q0 + (nextlineDst << 1), q0,
+              width * 3 * sizeof( scaler_data_type ) );
     p0 += nextlineSrc;
     q0 += (nextlineDst << 1) + nextlineDst;
   }
 }
 
+/* The HQ scalers only care whether each neighbour is "different" from the
+   centre pixel. Spectrum output only ever uses a handful of colours (16, or
+   64 with ULAplus), so rather than converting all nine neighbours to YUV and
+   comparing them for every pixel, each colour seen is given a small index
+   and we keep a table of which pairs of indices differ. The pattern for a
+   pixel is then eight bit lookups in the centre pixel's row of the table */
+
+#define HQ_COLOURS 64
+#define HQ_HASH_SIZE 256
+
+/* Map from pixel value to index; 'index' is one more than the real index
+   so that a zeroed entry is empty */
+static struct {
+  libspectrum_dword colour;
+  int index;
+} hq_hash[ HQ_HASH_SIZE ];
+
+static libspectrum_signed_dword hq_y[ HQ_COLOURS ], hq_u[ HQ_COLOURS ],
+                                hq_v[ HQ_COLOURS ];
+
+/* Bit j of hq_differ[i] is set if colours i and j differ */
+static libspectrum_qword hq_differ[ HQ_COLOURS ];
+
+static int hq_colours_used;
+
+/* Set if we ran out of indices and should start again the next time an area
+   is prepared */
+static int hq_colours_overflow;
+
+static void
+hq_colours_reset( void )
+{
+  memset( hq_hash, 0, sizeof( hq_hash ) );
+  hq_colours_used = 0;
+  hq_colours_overflow = 0;
+}
+
+static inline void
+hq_rgb_to_yuv( libspectrum_dword colour, libspectrum_signed_dword *y,
+               libspectrum_signed_dword *u, libspectrum_signed_dword *v )
+{
+  libspectrum_byte r, g, b;
+
+#if SCALER_DATA_SIZE == 2
+  r = R_TO_R( colour );
+  g = G_TO_G( colour );
+  b = B_TO_B( colour );
+#else
+  r =  colour & redMask;
+  g = (colour & greenMask) >> 8;
+  b = (colour & blueMask) >> 16;
+#endif
+  *y = RGB_TO_Y( r, g, b );
+  *u = RGB_TO_U( r, g, b );
+  *v = RGB_TO_V( r, g, b );
+}
+
+#define HQ_HASH( colour ) \
+  ( (libspectrum_dword)( (libspectrum_dword)(colour) * 0x9e3779b1U ) >> 24 )
+
+/* Look up a colour which wasn't in its first hash slot, adding it to the
+   table if necessary. Return -1 if the table is full */
+static int
+hq_colour_add( libspectrum_dword colour )
+{
+  size_t slot = HQ_HASH( colour );
+  int i, index;
+
+  while( hq_hash[ slot ].index ) {
+    if( hq_hash[ slot ].colour == colour ) return hq_hash[ slot ].index - 1;
+    slot = ( slot + 1 ) & ( HQ_HASH_SIZE - 1 );
+  }
+
+  if( hq_colours_used == HQ_COLOURS ) {
+    hq_colours_overflow = 1;
+    return -1;
+  }
+
+  index = hq_colours_used++;
+  hq_hash[ slot ].colour = colour;
+  hq_hash[ slot ].index = index + 1;
+
+  hq_rgb_to_yuv( colour, &hq_y[ index ], &hq_u[ index ], &hq_v[ index ] );
+
+  hq_differ[ index ] = 0;
+  for( i = 0; i < index; i++ ) {
+    if( HQ_YUVDIFF( hq_y[ index ], hq_u[ index ], hq_v[ index ],
+                    hq_y[ i ], hq_u[ i ], hq_v[ i ] ) ) {
+      hq_differ[ index ] |= (libspectrum_qword)1 << i;
+      hq_differ[ i ] |= (libspectrum_qword)1 << index;
+    }
+  }
+
+  return index;
+}
+
+static inline int
+hq_colour_index( libspectrum_dword colour )
+{
+  size_t slot = HQ_HASH( colour );
+
+  if( hq_hash[ slot ].colour == colour && hq_hash[ slot ].index )
+    return hq_hash[ slot ].index - 1;
+
+  return hq_colour_add( colour );
+}
+
+/* Do colours w[a] and w[b] differ? Used when the fast path in HQ_DIFF() can't
+   be, as we have seen more colours than we can index */
+static int
+hq_diff_slow( libspectrum_dword a, libspectrum_dword b )
+{
+  libspectrum_signed_dword ya, ua, va, yb, ub, vb;
+
+  hq_rgb_to_yuv( a, &ya, &ua, &va );
+  hq_rgb_to_yuv( b, &yb, &ub, &vb );
+  return HQ_YUVDIFF( ya, ua, va, yb, ub, vb );
+}
+
+#define HQ_DIFF(a,b) \
+  ( ( idx[a] | idx[b] ) >= 0 ? \
+    (int)( ( hq_differ[ idx[a] ] >> idx[b] ) & 1 ) : \
+    hq_diff_slow( w[a], w[b] ) )
+
+
+static int
+hq_pattern_slow( const libspectrum_qword *w )
+{
+  libspectrum_signed_dword y[10], u[10], v[10];
+  int k, pattern = 0;
+
+  for( k = 1; k <= 9; k++ )
+    hq_rgb_to_yuv( w[k], &y[k], &u[k], &v[k] );
+
+  if( HQ_YUVDIFF( y[5], u[5], v[5], y[1], u[1], v[1] ) ) pattern |= 0x01;
+  if( HQ_YUVDIFF( y[5], u[5], v[5], y[2], u[2], v[2] ) ) pattern |= 0x02;
+  if( HQ_YUVDIFF( y[5], u[5], v[5], y[3], u[3], v[3] ) ) pattern |= 0x04;
+  if( HQ_YUVDIFF( y[5], u[5], v[5], y[4], u[4], v[4] ) ) pattern |= 0x08;
+  if( HQ_YUVDIFF( y[5], u[5], v[5], y[6], u[6], v[6] ) ) pattern |= 0x10;
+  if( HQ_YUVDIFF( y[5], u[5], v[5], y[7], u[7], v[7] ) ) pattern |= 0x20;
+  if( HQ_YUVDIFF( y[5], u[5], v[5], y[8], u[8], v[8] ) ) pattern |= 0x40;
+  if( HQ_YUVDIFF( y[5], u[5], v[5], y[9], u[9], v[9] ) ) pattern |= 0x80;
+
+  return pattern;
+}
+
+static inline int
+hq_pattern( const libspectrum_qword *w, const int *idx )
+{
+  libspectrum_qword row;
+
+  /* More colours than we can index? Do it the slow way */
+  if( ( idx[1] | idx[2] | idx[3] | idx[4] | idx[5] | idx[6] | idx[7] |
+        idx[8] | idx[9] ) < 0 )
+    return hq_pattern_slow( w );
+
+  row = hq_differ[ idx[5] ];
+  return   ( ( row >> idx[1] ) & 1 )        |
+         ( ( ( row >> idx[2] ) & 1 ) << 1 ) |
+         ( ( ( row >> idx[3] ) & 1 ) << 2 ) |
+         ( ( ( row >> idx[4] ) & 1 ) << 3 ) |
+         ( ( ( row >> idx[6] ) & 1 ) << 4 ) |
+         ( ( ( row >> idx[7] ) & 1 ) << 5 ) |
+         ( ( ( row >> idx[8] ) & 1 ) << 6 ) |
+         ( ( ( row >> idx[9] ) & 1 ) << 7 );
+}
+
+/* All nine pixels the same colour? Every HQ output pixel is a blend of the
+   neighbours, so a flat block is just copied */
+#define HQ_FLAT( w ) \
+  ( w[1] == w[5] && w[2] == w[5] && w[3] == w[5] && w[4] == w[5] && \
+    w[6] == w[5] && w[7] == w[5] && w[8] == w[5] && w[9] == w[5] )
+
 #define prevline (-nextlineSrc)
 #define nextline nextlineSrc
 #define MOVE_B_TO_A(A,B) \
-		w[A] = w[B]; y[A] = y[B]; u[A] = u[B]; v[A] = v[B];
+		w[A] = w[B]; idx[A] = idx[B];
 #define MOVE_P_RIGHT \
 	MOVE_B_TO_A(1,2) \
 	MOVE_B_TO_A(4,5) \
@@ -1684,6 +1798,29 @@ FUNCTION( scaler_PalTV3x )( const libspectrum_byte *srcPtr,
 	MOVE_B_TO_A(5,6) \
 	MOVE_B_TO_A(8,9)
 
+/* Index every colour the HQ scalers will read for an area. Run before the
+   area is split into bands so the scalers themselves only ever read the
+   tables and can run on several threads at once */
+void
+FUNCTION( scaler_HQ_prepare )( const libspectrum_byte *srcPtr,
+                               libspectrum_dword srcPitch,
+                               int width, int height )
+{
+  int i, j;
+  int nextlineSrc = srcPitch / sizeof( scaler_data_type );
+  const scaler_data_type *p = (const scaler_data_type *)srcPtr;
+
+  if( hq_colours_overflow ) hq_colours_reset();
+
+  /* One line above and below, one pixel to the left and two to the right as
+     the scalers read one pixel ahead at the end of each line */
+  p += prevline;
+  for( j = -1; j <= height; j++ ) {
+    for( i = -1; i <= width + 1; i++ ) hq_colour_index( p[i] );
+    p += nextlineSrc;
+  }
+}
+
 void
 FUNCTION( scaler_HQ2x ) ( const libspectrum_byte *srcPtr,
                           libspectrum_dword srcPitch,
@@ -1697,9 +1834,7 @@ FUNCTION( scaler_HQ2x ) ( const libspectrum_byte *srcPtr,
   int nextlineDst = dstPitch / sizeof( scaler_data_type );
   scaler_data_type *q, *q1, *qN, *qN1, *q0 = (scaler_data_type *)dstPtr;
   libspectrum_qword w[10];
-  
-  libspectrum_byte  r, g, b;
-  libspectrum_signed_dword y[10], u[10], v[10];
+  int idx[10];
 
   /*   +----+----+----+
        |    |    |    |
@@ -1724,33 +1859,16 @@ FUNCTION( scaler_HQ2x ) ( const libspectrum_byte *srcPtr,
     w[3] = *(p + prevline + 1);
     w[6] = *(p + 1);
     w[9] = *(p + nextline + 1);
-    for( k = 1; k <= 9; k++ ) {
-#if SCALER_DATA_SIZE == 2
-      r = R_TO_R( w[k] );
-      g = G_TO_G( w[k] );
-      b = B_TO_B( w[k] );
-#else
-      r =  w[k] & redMask;
-      g = (w[k] & greenMask) >> 8;
-      b = (w[k] & blueMask) >> 16;
-#endif
-      y[k] = RGB_TO_Y( r, g, b );
-      u[k] = RGB_TO_U( r, g, b );
-      v[k] = RGB_TO_V( r, g, b );
-    }
+    for( k = 1; k <= 9; k++ ) idx[k] = hq_colour_index( w[k] );
 
     for( i = 0; i < width; i++ ) {
-      pattern = 0;
-      if( HQ_YUVDIFF( y[5], u[5], v[5], y[1], u[1], v[1] ) ) pattern |= 0x01;
-      if( HQ_YUVDIFF( y[5], u[5], v[5], y[2], u[2], v[2] ) ) pattern |= 0x02;
-      if( HQ_YUVDIFF( y[5], u[5], v[5], y[3], u[3], v[3] ) ) pattern |= 0x04;
-      if( HQ_YUVDIFF( y[5], u[5], v[5], y[4], u[4], v[4] ) ) pattern |= 0x08;
-      if( HQ_YUVDIFF( y[5], u[5], v[5], y[6], u[6], v[6] ) ) pattern |= 0x10;
-      if( HQ_YUVDIFF( y[5], u[5], v[5], y[7], u[7], v[7] ) ) pattern |= 0x20;
-      if( HQ_YUVDIFF( y[5], u[5], v[5], y[8], u[8], v[8] ) ) pattern |= 0x40;
-      if( HQ_YUVDIFF( y[5], u[5], v[5], y[9], u[9], v[9] ) ) pattern |= 0x80;
+      if( HQ_FLAT( w ) ) {
+        *q = *q1 = *qN = *qN1 = w[5];
+      } else {
+        pattern = hq_pattern( w, idx );
 
 #include "scaler_hq2x.c"
+      }
 
       p++;
       q  += 2; q1  += 2;
@@ -1759,20 +1877,9 @@ FUNCTION( scaler_HQ2x ) ( const libspectrum_byte *srcPtr,
       w[3] = *(p + prevline + 1);
       w[6] = *(p + 1);
       w[9] = *(p + nextline + 1);
-      for( k = 3; k <= 9; k += 3 ) {
-#if SCALER_DATA_SIZE == 2
-        r = R_TO_R( w[k] );
-        g = G_TO_G( w[k] );
-        b = B_TO_B( w[k] );
-#else
-        r =   w[k] & redMask;
-        g = ( w[k] & greenMask ) >> 8;
-        b = ( w[k] & blueMask  ) >> 16;
-#endif
-        y[k] = RGB_TO_Y( r, g, b );
-        u[k] = RGB_TO_U( r, g, b );
-        v[k] = RGB_TO_V( r, g, b );
-      }
+      idx[3] = hq_colour_index( w[3] );
+      idx[6] = hq_colour_index( w[6] );
+      idx[9] = hq_colour_index( w[9] );
     }
     p0 += nextlineSrc;
     q0 += nextlineDst << 1;
@@ -1793,9 +1900,7 @@ FUNCTION( scaler_HQ3x ) ( const libspectrum_byte *srcPtr,
   scaler_data_type *q, *qN, *qNN, *q1, *qN1, *qNN1, *q2, *qN2, *qNN2, 
 		   *q0 = (scaler_data_type *)dstPtr;
   libspectrum_qword w[10];
-  
-  libspectrum_byte  r, g, b;
-  libspectrum_signed_dword y[10], u[10], v[10];
+  int idx[10];
 
   /*   +----+----+----+
        |    |    |    |
@@ -1808,8 +1913,6 @@ FUNCTION( scaler_HQ3x ) ( const libspectrum_byte *srcPtr,
        | w7 | w8 | w9 |
        +----+----+----+ */
   for( j = 0; j < height; j++ ) {
-    if( j == height - 1 ) nextline = 0;
-
     p = p0;
     q = q0;
     q1 = q + 1; q2 = q + 2;
@@ -1825,33 +1928,18 @@ FUNCTION( scaler_HQ3x ) ( const libspectrum_byte *srcPtr,
     w[3] = *(p + prevline + 1);
     w[6] = *(p + 1);
     w[9] = *(p + nextline + 1);
-    for( k = 1; k <= 9; k++ ) {
-#if SCALER_DATA_SIZE == 2
-      r = R_TO_R( w[k] );
-      g = G_TO_G( w[k] );
-      b = B_TO_B( w[k] );
-#else
-      r =  w[k] & redMask;
-      g = (w[k] & greenMask) >> 8;
-      b = (w[k] & blueMask) >> 16;
-#endif
-      y[k] = RGB_TO_Y( r, g, b );
-      u[k] = RGB_TO_U( r, g, b );
-      v[k] = RGB_TO_V( r, g, b );
-    }
+    for( k = 1; k <= 9; k++ ) idx[k] = hq_colour_index( w[k] );
 
     for( i = 0; i < width; i++ ) {
-      pattern = 0;
-      if( HQ_YUVDIFF( y[5], u[5], v[5], y[1], u[1], v[1] ) ) pattern |= 0x01;
-      if( HQ_YUVDIFF( y[5], u[5], v[5], y[2], u[2], v[2] ) ) pattern |= 0x02;
-      if( HQ_YUVDIFF( y[5], u[5], v[5], y[3], u[3], v[3] ) ) pattern |= 0x04;
-      if( HQ_YUVDIFF( y[5], u[5], v[5], y[4], u[4], v[4] ) ) pattern |= 0x08;
-      if( HQ_YUVDIFF( y[5], u[5], v[5], y[6], u[6], v[6] ) ) pattern |= 0x10;
-      if( HQ_YUVDIFF( y[5], u[5], v[5], y[7], u[7], v[7] ) ) pattern |= 0x20;
-      if( HQ_YUVDIFF( y[5], u[5], v[5], y[8], u[8], v[8] ) ) pattern |= 0x40;
-      if( HQ_YUVDIFF( y[5], u[5], v[5], y[9], u[9], v[9] ) ) pattern |= 0x80;
+      if( HQ_FLAT( w ) ) {
+        *q   = *q1   = *q2   = w[5];
+        *qN  = *qN1  = *qN2  = w[5];
+        *qNN = *qNN1 = *qNN2 = w[5];
+      } else {
+        pattern = hq_pattern( w, idx );
 
 #include "scaler_hq3x.c"
+      }
 
       p++;
       q   += 3; q1   += 3; q2   += 3;
@@ -1861,20 +1949,9 @@ FUNCTION( scaler_HQ3x ) ( const libspectrum_byte *srcPtr,
       w[3] = *(p + prevline + 1);
       w[6] = *(p + 1);
       w[9] = *(p + nextline + 1);
-      for( k = 3; k <= 9; k += 3 ) {
-#if SCALER_DATA_SIZE == 2
-        r = R_TO_R( w[k] );
-        g = G_TO_G( w[k] );
-        b = B_TO_B( w[k] );
-#else
-        r =   w[k] & redMask;
-        g = ( w[k] & greenMask ) >> 8;
-        b = ( w[k] & blueMask  ) >> 16;
-#endif
-        y[k] = RGB_TO_Y( r, g, b );
-        u[k] = RGB_TO_U( r, g, b );
-        v[k] = RGB_TO_V( r, g, b );
-      }
+      idx[3] = hq_colour_index( w[3] );
+      idx[6] = hq_colour_index( w[6] );
+      idx[9] = hq_colour_index( w[9] );
     }
     p0 += nextlineSrc;
     q0 += ( nextlineDst << 1 ) + nextlineDst;
@@ -469,7 +469,7 @@ sdl_blit_icon( SDL_Surface **icon,
   dst_y = y * sdldisplay_current_size;
   dst_h = h;
 
-  scaler_proc16(
+  scaler_run( current_scaler, scaler_proc16,
 	(libspectrum_byte*)tmp_screen->pixels +
 			(x+1) * tmp_screen->format->BytesPerPixel +
 	                (y+1) * tmp_screen_pitch,
@@ -731,7 +731,7 @@ uidisplay_frame_end( void )
     int dst_y = r->y * sdldisplay_current_size;
     int dst_h = r->h;
 
-    scaler_proc16(
+    scaler_run( current_scaler, scaler_proc16,
       (libspectrum_byte*)tmp_screen->pixels +
                         (r->x+1) * tmp_screen->format->BytesPerPixel +
 	                (r->y+1)*tmp_screen_pitch,
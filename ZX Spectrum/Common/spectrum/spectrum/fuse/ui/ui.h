@@ -70,6 +70,18 @@ int ui_verror( ui_error_level severity, const char *format, va_list ap )
 int ui_error_specific( ui_error_level severity, const char *message );
 void ui_error_frame( void );
 
+/* libspectrum's errors can't go to ui_error() from a thread other than the
+   main one. Such a thread can instead keep the first of them in one of
+   these, for the main thread to report once it's done */
+typedef struct ui_error_buffer {
+  int used;
+  char message[ 256 ];
+} ui_error_buffer;
+
+/* Called on the thread itself */
+void ui_error_buffer_start( ui_error_buffer *buffer );
+void ui_error_buffer_stop( void );
+
 /* Callbacks used by the debugger */
 int ui_debugger_activate( void );
 int ui_debugger_deactivate( int interruptable );
@@ -108,6 +120,10 @@ typedef enum ui_confirm_joystick_t {
 ui_confirm_joystick_t
 ui_confirm_joystick( libspectrum_joystick libspectrum_type, int inputs );
 
+/* Set in the regression runner's workers: the machine runs as normal, but
+   nothing is shown by or read from the UI */
+extern int ui_headless;
+
 /* Mouse handling */
 
 extern int ui_mouse_present, ui_mouse_grabbed;
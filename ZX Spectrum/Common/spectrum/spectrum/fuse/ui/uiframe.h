@@ -0,0 +1,88 @@
+/* uiframe.h: Hand finished frames over to a render thread
+   Copyright (c) 2026 The Fuse authors
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+   Author contact information:
+
+   E-mail: philip-fuse@shadowmagic.org.uk
+
+*/
+
+#ifndef FUSE_UIFRAME_H
+#define FUSE_UIFRAME_H
+
+#include <stddef.h>
+
+#include "libspectrum.h"
+
+/* An area of a frame, in pixels */
+typedef struct uiframe_rect {
+  int x, y, w, h;
+} uiframe_rect;
+
+/* A frame as handed to the render function. Nothing changes it until the
+   render function returns */
+typedef struct uiframe {
+
+  /* One palette index per pixel, <width> pixels to a line */
+  const libspectrum_byte *pixels;
+  int width, height;
+
+  /* The areas changed since the last frame rendered. If <full> is set the
+     whole frame must be drawn and the list is empty */
+  const uiframe_rect *rects;
+  size_t rect_count;
+  int full;
+
+} uiframe;
+
+typedef void (*uiframe_render_fn)( const uiframe *frame, void *user_data );
+
+typedef struct uiframe_stats {
+  unsigned long published;	/* Frames handed over */
+  unsigned long rendered;	/* Frames drawn */
+  unsigned long dropped;	/* Frames replaced by a newer one before they
+				   could be drawn */
+  unsigned long duplicated;	/* Frame periods with nothing new to draw,
+				   leaving the last frame up for another one */
+} uiframe_stats;
+
+/* Start handing frames of <width> x <height> pixels to <render>, which is
+   called on a thread of its own if threads are available and from
+   uiframe_publish() if not */
+int uiframe_init( int width, int height, uiframe_render_fn render,
+                  void *user_data );
+
+/* Wait for the frame being rendered, if any, and stop */
+void uiframe_end( void );
+
+/* Drawing into the next frame, in the same units as uidisplay_putpixel(),
+   uidisplay_plot8() and uidisplay_plot16() */
+void uiframe_putpixel( int x, int y, int colour );
+void uiframe_plot8( int x, int y, libspectrum_byte data, libspectrum_byte ink,
+                    libspectrum_byte paper );
+void uiframe_plot16( int x, int y, libspectrum_word data,
+                     libspectrum_byte ink, libspectrum_byte paper );
+
+/* Mark an area of the next frame, in pixels, as changed */
+void uiframe_area( int x, int y, int w, int h );
+
+/* Hand the frame over for rendering if anything in it has changed */
+void uiframe_publish( void );
+
+void uiframe_get_stats( uiframe_stats *stats );
+
+#endif			/* #ifndef FUSE_UIFRAME_H */
@@ -41,6 +41,7 @@
 #include <ctype.h>
 #endif				/* #ifdef WIN32 */
 
+#include "file_index.h"
 #include "fuse.h"
 #include "ui.h"
 #include "utils.h"
@@ -83,7 +84,8 @@ static int is_drivesel = 0;
 static int is_rootdir;
 #endif				/* #ifdef WIN32 */
 
-#define ENTRIES_PER_SCREEN (is_saving ? 32 : 36)
+/* When loading, the bottom line shows what's known about the current file */
+#define ENTRIES_PER_SCREEN (is_saving ? 32 : 34)
 
 /* The number of the filename in the top-left corner of the current
    display, that of the filename which the `cursor' is on, and that
@@ -108,6 +110,8 @@ static int widget_print_all_filenames( struct widget_dirent **filenames, int n,
 				       const char *dir );
 static int widget_print_filename( struct widget_dirent *filename, int position,
 				  int inverted );
+static void widget_print_file_info( struct widget_dirent *filename,
+				    const char *dir );
 #ifdef WIN32
 static void widget_filesel_chdrv( void );
 static void widget_filesel_drvlist( void );
@@ -398,6 +402,30 @@ static int widget_scandrives( struct widget_dirent ***namelist )
 }
 #endif
 
+/* Make sure the file index knows about everything in the directory */
+static void
+widget_index_files( const char *dir )
+{
+  char **paths;
+  size_t i, count = 0;
+
+  paths = libspectrum_new( char*, widget_numfiles );
+
+  for( i = 0; i < widget_numfiles; i++ ) {
+    if( !S_ISREG( widget_filenames[i]->mode ) ) continue;
+    paths[ count ] = libspectrum_new( char, strlen( dir ) + 1 +
+				      strlen( widget_filenames[i]->name ) + 1 );
+    sprintf( paths[ count ], "%s" FUSE_DIR_SEP_STR "%s", dir,
+	     widget_filenames[i]->name );
+    count++;
+  }
+
+  file_index_scan( (const char * const *)paths, count );
+
+  for( i = 0; i < count; i++ ) libspectrum_free( paths[i] );
+  libspectrum_free( paths );
+}
+
 static void widget_scan( char *dir )
 {
   struct stat file_info;
@@ -429,6 +457,8 @@ static void widget_scan( char *dir )
     widget_filenames[i]->mode = error ? 0 : file_info.st_mode;
   }
 
+  if( !is_saving && dir ) widget_index_files( dir );
+
   qsort( widget_filenames, widget_numfiles, sizeof(struct widget_dirent*),
 	 (int(*)(const void*,const void*))widget_scan_compare );
 
@@ -627,7 +657,10 @@ static int widget_print_all_filenames( struct widget_dirent **filenames, int n,
   }
 
   if( i < n )
-    widget_down_arrow( 1, is_saving ? 20 : 22, WIDGET_COLOUR_FOREGROUND );
+    widget_down_arrow( 1, is_saving ? 20 : 21, WIDGET_COLOUR_FOREGROUND );
+
+  if( !is_saving && current < n )
+    widget_print_file_info( filenames[ current ], dir );
 
   /* Display that lot */
   widget_display_lines( 2, 22 );
@@ -720,6 +753,54 @@ static int widget_print_filename( struct widget_dirent *filename, int position,
 
   return 0;
 }
+
+/* Print the machine, title and publisher of a file from the file index */
+static void
+widget_print_file_info( struct widget_dirent *filename, const char *dir )
+{
+  const file_index_entry *entry = NULL;
+  const char *machine = NULL, *info_title, *publisher;
+  char *path, buffer[128];
+  int prefix;
+
+  widget_rectangle( 12, 22 * 8, 232, 8, WIDGET_COLOUR_BACKGROUND );
+
+  if( S_ISREG( filename->mode ) ) {
+    path = libspectrum_new( char, strlen( dir ) + 1 +
+			    strlen( filename->name ) + 1 );
+    sprintf( path, "%s" FUSE_DIR_SEP_STR "%s", dir, filename->name );
+    entry = file_index_lookup( path );
+    libspectrum_free( path );
+  }
+
+  if( !entry ) return;
+
+  if( entry->machine != LIBSPECTRUM_MACHINE_UNKNOWN )
+    machine = libspectrum_machine_name( entry->machine );
+  info_title = file_index_archive_info( entry, 0x00 );
+  publisher = file_index_archive_info( entry, 0x01 );
+
+  if( info_title && publisher ) {
+    snprintf( buffer, sizeof( buffer ), "%s%s%s (%s)", machine ? machine : "",
+	      machine ? ": " : "", info_title, publisher );
+  } else if( info_title ) {
+    snprintf( buffer, sizeof( buffer ), "%s%s%s", machine ? machine : "",
+	      machine ? ": " : "", info_title );
+  } else if( machine ) {
+    snprintf( buffer, sizeof( buffer ), "%s", machine );
+  } else {
+    return;
+  }
+
+  if( widget_stringwidth( buffer ) > 232 ) {
+    prefix = widget_stringwidth( "..." ) + 1;
+    while( widget_stringwidth( buffer ) > 232 - prefix )
+      buffer[ strlen( buffer ) - 1 ] = '\0';
+    strcat( buffer, "..." );
+  }
+
+  widget_printstring( 12, 22 * 8, WIDGET_COLOUR_FOREGROUND ^ 2, buffer );
+}
 #endif /* ifndef AMIGA */
 
 #ifdef WIN32
@@ -993,8 +1074,14 @@ widget_filesel_keyhandler( input_key key )
 	  
       widget_print_filename( widget_filenames[ new_current_file ],
 			     new_current_file - top_left_file, 1 );
-        
-      widget_display_lines( 2, 21 );
+
+      if( !is_saving ) {
+	widget_print_file_info( widget_filenames[ new_current_file ],
+				dirtitle );
+	widget_display_lines( 2, 22 );
+      } else {
+	widget_display_lines( 2, 21 );
+      }
     }
 
     /* Reset the current file marker */
@@ -0,0 +1,164 @@
+/* heatmap.c: Memory access heatmap widget
+   Copyright (c) 2026 The Fuse authors
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+   Author contact information:
+
+   E-mail: philip-fuse@shadowmagic.org.uk
+
+*/
+
+#include "config.h"
+
+#include <stdio.h>
+
+#include "compat.h"
+#include "heatmap.h"
+#include "memory.h"
+#include "ui.h"
+#include "widget.h"
+#include "widget_internals.h"
+
+/* Where the 128x128 map of the bank is drawn */
+#define MAP_X 16
+#define MAP_Y 32
+#define MAP_WIDTH 128
+
+/* Counters at or above this level are drawn in bright colours */
+#define HOT_LEVEL 0x80
+
+static int show_rom = 0;
+static int bank = 0;
+
+static const char * const title = "Memory heatmap";
+
+/* Black for untouched, magenta for bytes touched earlier in the session but
+   not recently, and blue/red/green for recent reads/writes/execution */
+static int
+byte_colour( const libspectrum_byte *coverage, size_t offset )
+{
+  const libspectrum_byte *read, *write, *execute;
+  libspectrum_byte level;
+  int colour;
+
+  if( !coverage[ offset ] ) return 0;
+
+  read = heatmap_counters( show_rom, bank, HEATMAP_READ );
+  write = heatmap_counters( show_rom, bank, HEATMAP_WRITE );
+  execute = heatmap_counters( show_rom, bank, HEATMAP_EXECUTE );
+
+  if( execute[ offset ] ) {
+    level = execute[ offset ]; colour = 4;
+  } else if( write[ offset ] ) {
+    level = write[ offset ]; colour = 2;
+  } else if( read[ offset ] ) {
+    level = read[ offset ]; colour = 1;
+  } else {
+    return 3;
+  }
+
+  return level >= HOT_LEVEL ? colour + 8 : colour;
+}
+
+static void
+display_map( void )
+{
+  const libspectrum_byte *coverage = heatmap_coverage( show_rom, bank );
+  char buf[ 32 ];
+  size_t i;
+
+  widget_rectangle( MAP_X, 24, 216, 8, WIDGET_COLOUR_BACKGROUND );
+  snprintf( buf, sizeof( buf ), "%s bank %d%s", show_rom ? "ROM" : "RAM",
+            bank, heatmap_active ? "" : " (stopped)" );
+  widget_printstring( MAP_X, 24, WIDGET_COLOUR_FOREGROUND, buf );
+
+  if( !coverage ) {
+    widget_rectangle( MAP_X, MAP_Y, MAP_WIDTH, HEATMAP_BANK_SIZE / MAP_WIDTH,
+                      0 );
+  } else {
+    for( i = 0; i < HEATMAP_BANK_SIZE; i++ )
+      widget_putpixel( MAP_X + i % MAP_WIDTH, MAP_Y + i / MAP_WIDTH,
+                       byte_colour( coverage, i ) );
+  }
+
+  widget_display_lines( 3, 17 );
+}
+
+int
+widget_heatmap_draw( void *data )
+{
+  widget_dialog_with_border( 1, 2, 30, 20 );
+  widget_printstring( 10, 16, WIDGET_COLOUR_TITLE, title );
+
+  widget_printstring( 152, 40, 9, "Read" );
+  widget_printstring( 152, 48, 10, "Write" );
+  widget_printstring( 152, 56, 12, "Execute" );
+  widget_printstring( 152, 64, 3, "Earlier" );
+
+  widget_printstring( 152, 96, WIDGET_COLOUR_FOREGROUND, "\x0A" "Left\x01/\x0ARight" );
+  widget_printstring( 152, 104, WIDGET_COLOUR_FOREGROUND, "\x01" "bank" );
+  widget_printstring( 152, 120, WIDGET_COLOUR_FOREGROUND, "\x0AT\x01oggle ROM" );
+  widget_printstring( 152, 136, WIDGET_COLOUR_FOREGROUND, "\x0AU\x01pdate" );
+  widget_printstring( 152, 144, WIDGET_COLOUR_FOREGROUND, "\x0A" "C\x01lose" );
+
+  display_map();
+
+  widget_display_lines( 2, 20 );
+
+  return 0;
+}
+
+void
+widget_heatmap_keyhandler( input_key key )
+{
+  int banks = show_rom ? SPECTRUM_ROM_PAGES : SPECTRUM_RAM_PAGES;
+
+  switch( key ) {
+
+  case INPUT_KEY_Escape:
+  case INPUT_KEY_c:
+    widget_end_widget( WIDGET_FINISHED_CANCEL );
+    break;
+
+  case INPUT_KEY_Return:
+  case INPUT_KEY_KP_Enter:
+    widget_end_all( WIDGET_FINISHED_OK );
+    break;
+
+  case INPUT_KEY_Left:
+    bank = ( bank + banks - 1 ) % banks;
+    display_map();
+    break;
+
+  case INPUT_KEY_Right:
+    bank = ( bank + 1 ) % banks;
+    display_map();
+    break;
+
+  case INPUT_KEY_t:
+    show_rom = !show_rom;
+    bank = 0;
+    display_map();
+    break;
+
+  case INPUT_KEY_u:
+    display_map();
+    break;
+
+  default:;
+
+  }
+}
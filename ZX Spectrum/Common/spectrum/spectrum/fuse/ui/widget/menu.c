@@ -693,6 +693,12 @@ menu_machine_memorybrowser( int action )
   widget_do_memorybrowser();
 }
 
+void
+menu_machine_memoryheatmap_view( int action )
+{
+  widget_do_heatmap();
+}
+
 void
 menu_media_tape_browse( int action )
 {
@@ -687,6 +687,7 @@ widget_t widget_data[] = {
   { widget_pokefinder_draw, NULL,		 widget_pokefinder_keyhandler },
   { widget_pokemem_draw, widget_pokemem_finish,	widget_pokemem_keyhandler },
   { widget_memory_draw,   NULL,			 widget_memory_keyhandler   },
+  { widget_heatmap_draw,  NULL,			 widget_heatmap_keyhandler  },
   { widget_roms_draw,     widget_roms_finish,	 widget_roms_keyhandler     },
   { widget_peripherals_general_draw, widget_options_finish, widget_peripherals_general_keyhandler },
   { widget_peripherals_disk_draw, widget_options_finish, widget_peripherals_disk_keyhandler },
@@ -829,6 +830,9 @@ ui_popup_menu( int native_key )
     menu_file_exit( 0 );
     fuse_emulation_unpause();
     break;
+  case INPUT_KEY_F12:
+    menu_machine_fastforward( 0 );
+    break;
 
   default: break;		/* Remove gcc warning */
 
@@ -56,6 +56,7 @@ typedef enum widget_type {
   WIDGET_TYPE_POKEFINDER,	/* Poke finder widget */
   WIDGET_TYPE_POKEMEM,  	/* Poke memory widget */
   WIDGET_TYPE_MEMORYBROWSER,	/* Memory browser widget */
+  WIDGET_TYPE_HEATMAP,		/* Memory heatmap widget */
   WIDGET_TYPE_ROM,		/* ROM selector widget */
   WIDGET_TYPE_PERIPHERALS_GENERAL, /* General peripherals options */
   WIDGET_TYPE_PERIPHERALS_DISK, /* Disk peripherals options */
@@ -233,6 +234,12 @@ static inline int widget_do_memorybrowser( void )
   return widget_do( WIDGET_TYPE_MEMORYBROWSER, NULL );
 }
 
+/* Memory heatmap widget */
+static inline int widget_do_heatmap( void )
+{
+  return widget_do( WIDGET_TYPE_HEATMAP, NULL );
+}
+
 /* ROM selector widget */
 static inline int widget_do_rom( widget_roms_info *data )
 {
@@ -233,6 +233,11 @@ void widget_pokefinder_keyhandler( input_key key );
 int widget_memory_draw( void *data );
 void widget_memory_keyhandler( input_key key );
 
+/* The memory heatmap widget */
+
+int widget_heatmap_draw( void *data );
+void widget_heatmap_keyhandler( input_key key );
+
 /* The about fuse widget */
 
 int widget_about_draw( void *data );
@@ -709,7 +709,7 @@ xdisplay_update_rect_scale( int x, int y, int w, int h )
 
   y = y * image_scale >> 2;
   x = x * image_scale >> 2;
-  scaler_proc16(
+  scaler_run( current_scaler, scaler_proc16,
         (libspectrum_byte *)&(rgb_image[yy + 2][xx + 1]),
         rgb_pitch * sizeof(rgb_image[0][0]),
         (libspectrum_byte *)&(scaled_image[y][x]),
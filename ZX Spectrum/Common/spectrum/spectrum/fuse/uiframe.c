@@ -0,0 +1,397 @@
+/* uiframe.c: Hand finished frames over to a render thread
+   Copyright (c) 2026 The Fuse authors
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+   Author contact information:
+
+   E-mail: philip-fuse@shadowmagic.org.uk
+
+*/
+
+/* The emulation thread draws into a work frame of its own. Publishing a
+   frame copies it into whichever of the three slots is spare and swaps
+   that with the ready slot; the render thread swaps the ready slot with
+   the one it draws from. Neither side ever waits for the other to finish
+   with a frame: if the renderer falls behind, the frame it hadn't got to
+   is dropped and its changed areas carried over into the newer one */
+
+#include "config.h"
+
+#include <string.h>
+
+#ifdef HAVE_PTHREAD
+#include <errno.h>
+#include <pthread.h>
+#include <sys/time.h>
+#endif				/* #ifdef HAVE_PTHREAD */
+
+#include "compat.h"
+#include "fuse.h"
+#include "machine.h"
+#include "ui/ui.h"
+#include "ui/uiframe.h"
+#include "utils.h"
+
+/* Beyond this many changed areas, just redraw the whole frame */
+#define MAX_RECTS 300
+
+/* How long the renderer waits for a frame before counting the last one as
+   having been shown again: one frame at 50Hz */
+#define FRAME_PERIOD_US 20000
+
+typedef struct frame_slot {
+  libspectrum_byte *pixels;
+  uiframe_rect rects[ MAX_RECTS ];
+  size_t rect_count;
+  int full;
+} frame_slot;
+
+static int frame_width, frame_height;
+
+static uiframe_render_fn render_fn;
+static void *render_data;
+
+static frame_slot work;
+
+static uiframe_stats stats;
+
+static int initialised = 0;
+
+static void slot_alloc( frame_slot *slot );
+static void slot_free( frame_slot *slot );
+static void slot_add_rect( frame_slot *slot, int x, int y, int w, int h );
+static void slot_render( frame_slot *slot );
+
+#ifdef HAVE_PTHREAD
+
+/* Protects <ready>, <ready_fresh> and <stats>; <spare> belongs to the
+   emulation thread and <front> to the render thread */
+static pthread_mutex_t frame_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t frame_cond = PTHREAD_COND_INITIALIZER;
+static pthread_t render_thread;
+static int render_thread_running = 0;
+static int render_thread_quit;
+
+static frame_slot slots[3];
+static frame_slot *spare, *ready, *front;
+
+/* Has <ready> been published since the renderer last took it? */
+static int ready_fresh;
+
+#define FRAME_LOCK() pthread_mutex_lock( &frame_mutex )
+#define FRAME_UNLOCK() pthread_mutex_unlock( &frame_mutex )
+
+#else				/* #ifdef HAVE_PTHREAD */
+
+#define FRAME_LOCK()
+#define FRAME_UNLOCK()
+
+#endif				/* #ifdef HAVE_PTHREAD */
+
+static void
+slot_alloc( frame_slot *slot )
+{
+  slot->pixels = libspectrum_new0( libspectrum_byte,
+                                   frame_width * frame_height );
+  slot->rect_count = 0;
+  slot->full = 1;
+}
+
+static void
+slot_free( frame_slot *slot )
+{
+  libspectrum_free( slot->pixels );
+  slot->pixels = NULL;
+}
+
+static void
+slot_add_rect( frame_slot *slot, int x, int y, int w, int h )
+{
+  uiframe_rect *rect;
+
+  if( slot->full ) return;
+
+  if( slot->rect_count == MAX_RECTS ) {
+    slot->full = 1;
+    slot->rect_count = 0;
+    return;
+  }
+
+  rect = &slot->rects[ slot->rect_count++ ];
+  rect->x = x; rect->y = y; rect->w = w; rect->h = h;
+}
+
+static void
+slot_render( frame_slot *slot )
+{
+  uiframe frame;
+
+  frame.pixels = slot->pixels;
+  frame.width = frame_width; frame.height = frame_height;
+  frame.rects = slot->rects;
+  frame.rect_count = slot->rect_count;
+  frame.full = slot->full;
+
+  render_fn( &frame, render_data );
+
+  slot->rect_count = 0;
+  slot->full = 0;
+}
+
+#ifdef HAVE_PTHREAD
+
+static void*
+render_thread_fn( void *arg GCC_UNUSED )
+{
+  struct timeval now;
+  struct timespec until;
+  frame_slot *slot;
+
+  FRAME_LOCK();
+
+  while( !render_thread_quit ) {
+
+    if( !ready_fresh ) {
+      gettimeofday( &now, NULL );
+      now.tv_usec += FRAME_PERIOD_US;
+      if( now.tv_usec >= 1000000 ) { now.tv_sec++; now.tv_usec -= 1000000; }
+      until.tv_sec = now.tv_sec; until.tv_nsec = now.tv_usec * 1000;
+
+      if( pthread_cond_timedwait( &frame_cond, &frame_mutex, &until ) ==
+          ETIMEDOUT && !ready_fresh && stats.rendered )
+        stats.duplicated++;
+
+      continue;
+    }
+
+    slot = front; front = ready; ready = slot;
+    ready_fresh = 0;
+    FRAME_UNLOCK();
+
+    slot_render( front );
+
+    FRAME_LOCK();
+    stats.rendered++;
+  }
+
+  FRAME_UNLOCK();
+
+  return NULL;
+}
+
+static void
+render_thread_stop( void )
+{
+  if( !render_thread_running ) return;
+
+  FRAME_LOCK();
+  render_thread_quit = 1;
+  pthread_cond_signal( &frame_cond );
+  FRAME_UNLOCK();
+
+  pthread_join( render_thread, NULL );
+  render_thread_running = 0;
+}
+
+static void
+render_thread_start( void )
+{
+  int i;
+
+  for( i = 0; i < 3; i++ ) slot_alloc( &slots[i] );
+  spare = &slots[0]; ready = &slots[1]; front = &slots[2];
+  ready_fresh = 0;
+
+  render_thread_quit = 0;
+  if( pthread_create( &render_thread, NULL, render_thread_fn, NULL ) ) {
+    ui_error( UI_ERROR_ERROR, "couldn't start display render thread" );
+    return;
+  }
+
+  render_thread_running = 1;
+}
+
+static void
+render_thread_free( void )
+{
+  int i;
+
+  for( i = 0; i < 3; i++ ) slot_free( &slots[i] );
+}
+
+#endif				/* #ifdef HAVE_PTHREAD */
+
+int
+uiframe_init( int width, int height, uiframe_render_fn render,
+              void *user_data )
+{
+  if( initialised ) uiframe_end();
+
+  frame_width = width; frame_height = height;
+  render_fn = render; render_data = user_data;
+
+  memset( &stats, 0, sizeof( stats ) );
+
+  slot_alloc( &work );
+
+#ifdef HAVE_PTHREAD
+  render_thread_start();
+#endif				/* #ifdef HAVE_PTHREAD */
+
+  initialised = 1;
+
+  return 0;
+}
+
+void
+uiframe_end( void )
+{
+  if( !initialised ) return;
+
+#ifdef HAVE_PTHREAD
+  render_thread_stop();
+  render_thread_free();
+#endif				/* #ifdef HAVE_PTHREAD */
+
+  slot_free( &work );
+
+  initialised = 0;
+}
+
+void
+uiframe_putpixel( int x, int y, int colour )
+{
+  libspectrum_byte *pixel;
+
+  if( machine_current->timex ) {
+    x <<= 1; y <<= 1;
+    pixel = &work.pixels[ y * frame_width + x ];
+    pixel[0] = pixel[1] = colour;
+    pixel[ frame_width ] = pixel[ frame_width + 1 ] = colour;
+  } else {
+    work.pixels[ y * frame_width + x ] = colour;
+  }
+}
+
+void
+uiframe_plot8( int x, int y, libspectrum_byte data, libspectrum_byte ink,
+               libspectrum_byte paper )
+{
+  libspectrum_byte *pixel;
+  int i;
+
+  x <<= 3;
+
+  if( machine_current->timex ) {
+    x <<= 1; y <<= 1;
+    pixel = &work.pixels[ y * frame_width + x ];
+    for( i = 0; i < 8; i++, data <<= 1, pixel += 2 )
+      pixel[0] = pixel[1] = pixel[ frame_width ] = pixel[ frame_width + 1 ] =
+        ( data & 0x80 ) ? ink : paper;
+  } else {
+    pixel = &work.pixels[ y * frame_width + x ];
+    for( i = 0; i < 8; i++, data <<= 1 )
+      *pixel++ = ( data & 0x80 ) ? ink : paper;
+  }
+}
+
+void
+uiframe_plot16( int x, int y, libspectrum_word data, libspectrum_byte ink,
+                libspectrum_byte paper )
+{
+  libspectrum_byte *pixel;
+  int i;
+
+  x <<= 4; y <<= 1;
+
+  pixel = &work.pixels[ y * frame_width + x ];
+  for( i = 0; i < 16; i++, data <<= 1, pixel++ )
+    pixel[0] = pixel[ frame_width ] = ( data & 0x8000 ) ? ink : paper;
+}
+
+void
+uiframe_area( int x, int y, int w, int h )
+{
+  slot_add_rect( &work, x, y, w, h );
+}
+
+#ifdef HAVE_PTHREAD
+
+void
+uiframe_publish( void )
+{
+  frame_slot *slot;
+  size_t i;
+
+  if( !initialised || ( !work.full && !work.rect_count ) ) return;
+
+  /* Without a render thread, there's nothing to do but draw it here */
+  if( !render_thread_running ) {
+    slot_render( &work );
+    stats.published++; stats.rendered++;
+    return;
+  }
+
+  memcpy( spare->pixels, work.pixels, frame_width * frame_height );
+  memcpy( spare->rects, work.rects, work.rect_count * sizeof( *work.rects ) );
+  spare->rect_count = work.rect_count;
+  spare->full = work.full;
+
+  work.rect_count = 0;
+  work.full = 0;
+
+  FRAME_LOCK();
+
+  /* The renderer never got to the last frame, so the areas which changed
+     in it have to be drawn with this one */
+  if( ready_fresh ) {
+    for( i = 0; i < ready->rect_count; i++ )
+      slot_add_rect( spare, ready->rects[i].x, ready->rects[i].y,
+                     ready->rects[i].w, ready->rects[i].h );
+    if( ready->full ) { spare->full = 1; spare->rect_count = 0; }
+    stats.dropped++;
+  }
+
+  slot = ready; ready = spare; spare = slot;
+  ready_fresh = 1;
+  stats.published++;
+
+  pthread_cond_signal( &frame_cond );
+
+  FRAME_UNLOCK();
+}
+
+#else				/* #ifdef HAVE_PTHREAD */
+
+/* Without threads, frames are drawn as they're published */
+void
+uiframe_publish( void )
+{
+  if( !initialised || ( !work.full && !work.rect_count ) ) return;
+
+  slot_render( &work );
+  stats.published++; stats.rendered++;
+}
+
+#endif				/* #ifdef HAVE_PTHREAD */
+
+void
+uiframe_get_stats( uiframe_stats *result )
+{
+  FRAME_LOCK();
+  *result = stats;
+  FRAME_UNLOCK();
+}
@@ -26,6 +26,8 @@
 
 #include <config.h>
 
+#include <string.h>
+
 #include <libspectrum.h>
 
 #include "fuse.h"
@@ -46,6 +48,10 @@
 #include "peripherals/ula.h"
 #include "peripherals/usource.h"
 #include "settings.h"
+#include "sound.h"
+#include "tape.h"
+#include "ui/scaler/scaler.h"
+#include "ui/scaler/scaler_internals.h"
 #include "unittests.h"
 
 static int
@@ -246,6 +252,78 @@ floating_bus_merge_test( void )
   return 0;
 }
 
+/* The vectorised scalers must give exactly the same output as the plain C
+   versions */
+#define SCALER_TEST_WIDTH 37
+#define SCALER_TEST_HEIGHT 6
+
+static int
+scaler_simd_compare( ScalerProc *proc, size_t pixel_size )
+{
+  static libspectrum_byte src[ ( SCALER_TEST_WIDTH + 3 ) * ( SCALER_TEST_HEIGHT + 3 ) * 4 ];
+  static libspectrum_byte simd[ SCALER_TEST_WIDTH * SCALER_TEST_HEIGHT * 9 * 4 ];
+  static libspectrum_byte scalar[ SCALER_TEST_WIDTH * SCALER_TEST_HEIGHT * 9 * 4 ];
+  libspectrum_dword src_pitch = ( SCALER_TEST_WIDTH + 3 ) * pixel_size;
+  libspectrum_dword dst_pitch = SCALER_TEST_WIDTH * 3 * pixel_size;
+  scaler_simd_type type = scaler_simd;
+  libspectrum_dword seed = 0x12345678;
+  size_t i;
+
+  for( i = 0; i < sizeof( src ); i++ ) {
+    seed = seed * 1103515245 + 12345;
+    src[i] = seed >> 24;
+  }
+
+  /* Leave a border so scalers which look at neighbouring pixels stay
+     inside the buffer */
+  memset( simd, 0, sizeof( simd ) );
+  proc( src + src_pitch + pixel_size, src_pitch, simd, dst_pitch,
+        SCALER_TEST_WIDTH, SCALER_TEST_HEIGHT );
+
+  scaler_simd = SCALER_SIMD_NONE;
+  memset( scalar, 0, sizeof( scalar ) );
+  proc( src + src_pitch + pixel_size, src_pitch, scalar, dst_pitch,
+        SCALER_TEST_WIDTH, SCALER_TEST_HEIGHT );
+  scaler_simd = type;
+
+  TEST_ASSERT( !memcmp( simd, scalar, sizeof( simd ) ) );
+
+  return 0;
+}
+
+static int
+scaler_simd_test( void )
+{
+  static const scaler_type scalers[] = {
+    SCALER_TV2X, SCALER_TV3X, SCALER_TIMEXTV, SCALER_DOTMATRIX,
+    SCALER_PALTV2X, SCALER_PALTV3X,
+  };
+  static const libspectrum_dword formats[] = { 565, 555 };
+  int pal_tv2x = settings_current.pal_tv2x;
+  size_t i, j;
+  int r = 0, k;
+
+  for( k = 0; k < 2; k++ ) {
+    settings_current.pal_tv2x = k;
+
+    for( i = 0; i < ARRAY_SIZE( formats ); i++ ) {
+      scaler_select_bitformat( formats[i] );
+
+      for( j = 0; j < ARRAY_SIZE( scalers ); j++ ) {
+        if( scaler_get_proc16( scalers[j] ) )
+          r += scaler_simd_compare( scaler_get_proc16( scalers[j] ), 2 );
+        if( i == 0 && scaler_get_proc32( scalers[j] ) )
+          r += scaler_simd_compare( scaler_get_proc32( scalers[j] ), 4 );
+      }
+    }
+  }
+
+  settings_current.pal_tv2x = pal_tv2x;
+  scaler_simd_select();
+
+  return r;
+}
+
 static int
 mempool_test( void )
 {
@@ -782,6 +860,10 @@ unittests_run( void )
   r += floating_bus_merge_test();
   r += mempool_test();
   r += paging_test();
+  r += scaler_simd_test();
+  r += sound_unittest();
+  r += tape_unittest();
+  r += ula_unittest();
 
   return r;
 }
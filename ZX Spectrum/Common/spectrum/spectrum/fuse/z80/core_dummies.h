@@ -0,0 +1,34 @@
+/* core_dummies.h: The rest of Fuse as seen by the core tester and benchmark
+   Copyright (c) 2003-2015 Philip Kendall
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+   Author contact information:
+
+   E-mail: philip-fuse@shadowmagic.org.uk
+
+*/
+
+#ifndef FUSE_Z80_CORE_DUMMIES_H
+#define FUSE_Z80_CORE_DUMMIES_H
+
+#include "libspectrum.h"
+
+/* Set up the stand-ins for a plain machine with nothing attached, with the
+   64Kb at <memory> as the memory map. Each program still provides its own
+   memory and port access and periph_run_traps() */
+int core_dummies_init( libspectrum_byte *memory );
+
+#endif			/* #ifndef FUSE_Z80_CORE_DUMMIES_H */
@@ -76,6 +76,8 @@ int z80_nmos_iff2_event;
 static void z80_init_tables(void);
 static void z80_from_snapshot( libspectrum_snap *snap );
 static void z80_to_snapshot( libspectrum_snap *snap );
+static void z80_to_state( module_state *state );
+static void z80_from_state( module_state *state );
 static void z80_nmi( libspectrum_dword ts, int type, void *user_data );
 
 static module_info_t z80_module_info = {
@@ -85,6 +87,8 @@ static module_info_t z80_module_info = {
   NULL,
   z80_from_snapshot,
   z80_to_snapshot,
+  z80_to_state,
+  z80_from_state,
 
 };
 
@@ -337,3 +341,15 @@ z80_to_snapshot( libspectrum_snap *snap )
     snap, z80.interrupts_enabled_at == tstates
   );
 }
+
+static void
+z80_to_state( module_state *state )
+{
+  module_state_write( state, &z80, sizeof( z80 ) );
+}
+
+static void
+z80_from_state( module_state *state )
+{
+  module_state_read( state, &z80, sizeof( z80 ) );
+}
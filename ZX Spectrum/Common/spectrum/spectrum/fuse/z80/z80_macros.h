@@ -106,18 +106,26 @@
 
 #ifndef CORETEST
 
+/* Redefined to 0 by z80_do_opcodes() around the copy of the opcodes used
+   when no access in the instruction can be contended; the checks below then
+   fold away, leaving a constant number of tstates for each opcode */
+#define Z80_CONTENDED 1
+
 #define contend_read(address,time) \
-  if( memory_map_read[ (address) >> MEMORY_PAGE_SIZE_LOGARITHM ].contended ) \
+  if( Z80_CONTENDED && \
+      memory_map_read[ (address) >> MEMORY_PAGE_SIZE_LOGARITHM ].contended ) \
     tstates += ula_contention[ tstates ]; \
   tstates += (time);
 
 #define contend_read_no_mreq(address,time) \
-  if( memory_map_read[ (address) >> MEMORY_PAGE_SIZE_LOGARITHM ].contended ) \
+  if( Z80_CONTENDED && \
+      memory_map_read[ (address) >> MEMORY_PAGE_SIZE_LOGARITHM ].contended ) \
     tstates += ula_contention_no_mreq[ tstates ]; \
   tstates += (time);
 
 #define contend_write_no_mreq(address,time) \
-  if( memory_map_write[ (address) >> MEMORY_PAGE_SIZE_LOGARITHM ].contended ) \
+  if( Z80_CONTENDED && \
+      memory_map_write[ (address) >> MEMORY_PAGE_SIZE_LOGARITHM ].contended ) \
     tstates += ula_contention_no_mreq[ tstates ]; \
   tstates += (time);
 
@@ -32,23 +32,18 @@
 
 #include "debugger.h"
 #include "event.h"
+#include "heatmap.h"
 #include "machine.h"
 #include "memory.h"
+#include "opus.h"
 #include "periph.h"
-#include "beta.h"
 #include "didaktik.h"
-#include "disciple.h"
-#include "opus.h"
-#include "plusd.h"
-#include "divide.h"
-#include "if1.h"
-#include "spectranet.h"
 #include "ula.h"
-#include "usource.h"
 #include "profile.h"
 #include "rzx.h"
 #include "settings.h"
 #include "slt.h"
+#include "spectranet.h"
 #include "svg.h"
 #include "tape.h"
 #include "z80.h"
@@ -109,6 +104,34 @@ enum {
 static libspectrum_byte opcode = 0x00;
 #endif
 
+#if defined( HAVE_ENOUGH_MEMORY ) && !defined( CORETEST )
+
+/* If the whole opcode is inlined into z80_do_opcodes(), we can keep a second
+   copy of it with the contention checks compiled out, and use that whenever
+   an instruction can't possibly reach the part of the frame where contention
+   occurs. Each memory access still adds its tstates as it happens, so the
+   timing of writes to the screen and of port accesses is unchanged */
+#define Z80_UNCONTENDED_PATH
+
+/* The longest an instruction can take after its opcode fetch */
+#define Z80_MAX_OPCODE_TSTATES 23
+
+/* Operand and data reads for the uncontended copy of the opcodes. The only
+   reads anything else needs to see are those the Opus and the Spectranet
+   take over in the bottom 16K, so everything else can come straight from
+   the page without the call into memory.c */
+static inline libspectrum_byte
+readbyte_uncontended_inline( libspectrum_word address )
+{
+  if( address < 0x4000 && ( opus_active || spectranet_paged ) )
+    return readbyte_uncontended( address );
+
+  tstates += 3;
+  return readbyte_internal( address );
+}
+
+#endif
+
 /* Execute Z80 opcodes until the next event */
 void
 z80_do_opcodes( void )
@@ -120,6 +143,29 @@ z80_do_opcodes( void )
   int even_m1 =
     machine_current->capabilities & LIBSPECTRUM_MACHINE_CAPABILITY_EVEN_M1; 
 
+#ifdef Z80_UNCONTENDED_PATH
+  /* Instructions starting before uncontended_before or at or after
+     uncontended_after can use the uncontended copy of the opcodes. The
+     debugger and the heatmap need to see every access, so force the normal
+     path while either is active */
+  libspectrum_dword uncontended_before, uncontended_after;
+  libspectrum_dword uncontended_fetch_before;
+  int straight_through;
+
+  if( debugger_mode != DEBUGGER_MODE_INACTIVE || heatmap_active ) {
+    uncontended_before = 0; uncontended_after = 0xffffffff;
+  } else {
+    uncontended_before = ula_contention_start > Z80_MAX_OPCODE_TSTATES ?
+                         ula_contention_start - Z80_MAX_OPCODE_TSTATES : 0;
+    uncontended_after = ula_contention_end;
+  }
+#endif				/* #ifdef Z80_UNCONTENDED_PATH */
+
+  /* Peripherals may have been (un)paged or become (un)available since last
+     time, so make sure the traps are up to date before deciding which checks
+     are needed */
+  periph_update_traps();
+
 #ifdef __GNUC__
 
 #undef SETUP_CHECK
@@ -138,8 +184,39 @@ z80_do_opcodes( void )
 
 #endif				/* #ifdef __GNUC__ */
 
+#ifdef Z80_UNCONTENDED_PATH
+
+  /* If none of the checks are needed, an instruction which can't be
+     contended goes straight from its opcode fetch to the uncontended copy
+     of the opcodes. Anything which would need a check turned on part way
+     through adds an event to get us out of here first */
+#undef SETUP_CHECK
+#define SETUP_CHECK( label, condition ) if( condition ) straight_through = 0;
+
+#undef SETUP_NEXT
+#define SETUP_NEXT( label )
+
+  straight_through = 1;
+
+#include "z80_checks.h"
+
+  /* The fetch takes 4 tstates before the instruction proper starts */
+  uncontended_fetch_before = uncontended_before > 4 ? uncontended_before - 4 : 0;
+
+#endif				/* #ifdef Z80_UNCONTENDED_PATH */
+
   while( tstates < event_next_event ) {
 
+#ifdef Z80_UNCONTENDED_PATH
+    if( straight_through && ( tstates < uncontended_fetch_before ||
+                              tstates >= uncontended_after ) ) {
+      tstates += 4;
+      opcode = readbyte_internal( PC );
+      PC++; R++;
+      goto uncontended_opcode;
+    }
+#endif				/* #ifdef Z80_UNCONTENDED_PATH */
+
     /* Profiler */
     CHECK( profile, profile_active )
 
@@ -147,6 +224,13 @@ z80_do_opcodes( void )
 
     END_CHECK
 
+    /* Memory access heatmap */
+    CHECK( heatmap, heatmap_active )
+
+    heatmap_execute( PC );
+
+    END_CHECK
+
     /* If we're due an end of frame from RZX playback, generate one */
     CHECK( rzx, rzx_playback )
 
@@ -166,81 +250,11 @@ z80_do_opcodes( void )
 
     END_CHECK
 
-    CHECK( beta, beta_available )
+    /* Automatic paging of peripherals' memory */
+    CHECK( periph_early, periph_traps_armed )
 
-#define NOT_128_TYPE_OR_IS_48_TYPE ( !( machine_current->capabilities & \
-            LIBSPECTRUM_MACHINE_CAPABILITY_128_MEMORY ) || \
-            machine_current->ram.current_rom )
-
-    if( beta_active ) {
-      if( NOT_128_TYPE_OR_IS_48_TYPE && PC >= 16384 ) {
-	beta_unpage();
-      }
-    } else if( ( PC & beta_pc_mask ) == beta_pc_value &&
-               NOT_128_TYPE_OR_IS_48_TYPE ) {
-      beta_page();
-    }
-
-    END_CHECK
-
-    CHECK( plusd, plusd_available )
-
-    if( PC == 0x0008 || PC == 0x003a || PC == 0x0066 || PC == 0x028e ) {
-      plusd_page();
-    }
-
-    END_CHECK
-
-    CHECK( didaktik80, didaktik80_available )
-
-    if( PC == 0x0000 || PC == 0x0008 ) {
-      didaktik80_page();
-    } else if( PC == 0x1700 ) {
-      didaktik80_unpage();
-    }
-
-    END_CHECK
-
-    CHECK( disciple, disciple_available )
-
-    if( PC == 0x0001 || PC == 0x0008 || PC == 0x0066 || PC == 0x028e ) {
-      disciple_page();
-    }
-
-    END_CHECK
-
-    CHECK( usource, usource_available )
-
-    if( PC == 0x2bae ) {
-      usource_toggle();
-    }
-
-    END_CHECK
-
-    CHECK( if1p, if1_available )
-
-    if( PC == 0x0008 || PC == 0x1708 ) {
-      if1_page();
-    }
-
-    END_CHECK
-
-    CHECK( divide_early, settings_current.divide_enabled )
-    
-    if( ( PC & 0xff00 ) == 0x3d00 ) {
-      divide_set_automap( 1 );
-    }
-    
-    END_CHECK
-
-    CHECK( spectranet_page, spectranet_available && !settings_current.spectranet_disable )
-
-    if( PC == 0x0008 || ((PC & 0xfff8) == 0x3ff8) )
-      spectranet_page( 0 );
-
-    if( PC == spectranet_programmable_trap &&
-      spectranet_programmable_trap_active )
-      event_add( 0, z80_nmi_event );
+    if( periph_trap_hit( PERIPH_TRAP_BEFORE_FETCH, PC ) )
+      periph_run_traps( PERIPH_TRAP_BEFORE_FETCH, PC );
 
     END_CHECK
 
@@ -264,41 +278,10 @@ z80_do_opcodes( void )
        triggering read breakpoints */
     opcode = readbyte_internal( PC );
 
-    CHECK( if1u, if1_available )
-
-    if( PC == 0x0700 ) {
-      if1_unpage();
-    }
-
-    END_CHECK
-
-    CHECK( divide_late, settings_current.divide_enabled )
-
-    if( ( PC & 0xfff8 ) == 0x1ff8 ) {
-      divide_set_automap( 0 );
-    } else if( (PC == 0x0000) || (PC == 0x0008) || (PC == 0x0038)
-      || (PC == 0x0066) || (PC == 0x04c6) || (PC == 0x0562) ) {
-      divide_set_automap( 1 );
-    }
-    
-    END_CHECK
-
-    CHECK( opus, opus_available )
+    CHECK( periph_late, periph_traps_armed )
 
-    if( opus_active ) {
-      if( PC == 0x1748 ) {
-        opus_unpage();
-      }
-    } else if( PC == 0x0008 || PC == 0x0048 || PC == 0x1708 ) {
-      opus_page();
-    }
-
-    END_CHECK
-
-    CHECK( spectranet_unpage, spectranet_available )
-
-    if( PC == 0x007c )
-      spectranet_unpage();
+    if( periph_trap_hit( PERIPH_TRAP_AFTER_FETCH, PC ) )
+      periph_run_traps( PERIPH_TRAP_AFTER_FETCH, PC );
 
     END_CHECK
 
@@ -327,6 +310,29 @@ z80_do_opcodes( void )
 
   end_opcode:
     PC++; R++;
+
+#ifdef Z80_UNCONTENDED_PATH
+    if( tstates < uncontended_before || tstates >= uncontended_after ) {
+
+#undef Z80_CONTENDED
+#define Z80_CONTENDED 0
+#define readbyte( address ) readbyte_uncontended_inline( address )
+#define writebyte( address, b ) writebyte_uncontended( address, b )
+
+    uncontended_opcode:
+      switch(opcode) {
+#include "opcodes_base.c"
+      }
+
+#undef writebyte
+#undef readbyte
+#undef Z80_CONTENDED
+#define Z80_CONTENDED 1
+
+      continue;
+    }
+#endif				/* #ifdef Z80_UNCONTENDED_PATH */
+
     switch(opcode) {
 #include "opcodes_base.c"
     }
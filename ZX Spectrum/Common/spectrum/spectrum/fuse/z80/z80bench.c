@@ -0,0 +1,745 @@
+/* z80bench.c: Benchmark for Fuse's Z80 core
+   Copyright (c) 2026 The Fuse authors
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+   Author contact information:
+
+   E-mail: philip-fuse@shadowmagic.org.uk
+
+*/
+
+/* Unlike the core tester, this is built against the same z80_ops.c as Fuse
+   itself, so the memory and contention macros and the uncontended copy of
+   the opcodes are all exercised. Everything outside the core is a plain 48K
+   machine: 64Kb of flat memory, the 48K contention pattern and a frame
+   interrupt, with no display or sound behind it.
+
+   Each workload is run twice from the same start: once for time, with
+   nothing else going on, and once with a trap on every opcode fetch to
+   count the instructions and how many tstates each took. The runs are
+   identical as far as the emulated machine is concerned, so the count from
+   the second goes with the time from the first */
+
+#include <config.h>
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include "fuse.h"
+#include "machine.h"
+#include "memory.h"
+#include "periph.h"
+#include "peripherals/ula.h"
+#include "z80.h"
+#include "z80_macros.h"
+#include "core_dummies.h"
+
+/* 48K timings */
+#define FRAME_LENGTH 69888
+#define INTERRUPT_LENGTH 32
+#define LINE_LENGTH 224
+#define FIRST_CONTENDED 14335
+#define CONTENDED_LINES 192
+
+/* Instructions taking this many tstates or more share the last bucket */
+#define HISTOGRAM_SIZE 64
+
+/* How many frames to run each workload for by default */
+#define DEFAULT_FRAMES 5000
+
+typedef struct workload {
+
+  const char *name;
+
+  /* Load the program into memory and set up the registers; returns non-zero
+     if the workload can't be run */
+  int (*setup)( void );
+
+  int rom;		/* Is 0x0000 to 0x3fff read only? */
+  int contended;	/* Is 0x4000 to 0x7fff contended? */
+  int interrupts;	/* Is there an interrupt at the start of each frame? */
+  int cpm;		/* Does the program expect CP/M's BDOS? If so, run it
+			   until it returns to CP/M rather than for a set
+			   number of frames */
+
+} workload;
+
+typedef struct workload_result {
+  libspectrum_qword frames;
+  libspectrum_qword tstates;
+  double seconds;
+  libspectrum_qword instructions;
+  libspectrum_qword histogram[ HISTOGRAM_SIZE ];
+} workload_result;
+
+static const char *progname;		/* argv[0] */
+static const char *rom_file;
+static const char *zexall_file;
+
+libspectrum_dword tstates;
+libspectrum_dword event_next_event;
+
+static libspectrum_byte memory[ 0x10000 ];
+
+memory_page memory_map_read[ MEMORY_PAGES_IN_64K ];
+memory_page memory_map_write[ MEMORY_PAGES_IN_64K ];
+
+libspectrum_byte ula_contention[ ULA_CONTENTION_SIZE ];
+libspectrum_byte ula_contention_no_mreq[ ULA_CONTENTION_SIZE ];
+libspectrum_dword ula_contention_start, ula_contention_end;
+
+static const workload *current_workload;
+
+/* The AY's registers, so the player has somewhere to write to */
+static libspectrum_byte ay_register, ay_registers[ 16 ];
+
+/* While counting, the time of the last opcode fetch relative to the start
+   of the current frame */
+static libspectrum_signed_qword last_fetch;
+static workload_result *counting;
+
+static int setup_rom_boot( void );
+static int setup_zexall( void );
+static int setup_ldir( void );
+static int setup_indexed( void );
+static int setup_multicolour( void );
+static int setup_ay_player( void );
+
+static const workload workloads[] = {
+  { "rom-boot",    setup_rom_boot,    1, 1, 1, 0 },
+  { "zexall",      setup_zexall,      0, 0, 0, 1 },
+  { "ldir",        setup_ldir,        0, 0, 0, 0 },
+  { "indexed",     setup_indexed,     0, 0, 0, 0 },
+  { "multicolour", setup_multicolour, 0, 1, 1, 0 },
+  { "ay-player",   setup_ay_player,   0, 0, 1, 0 },
+};
+
+#define WORKLOAD_COUNT ( sizeof( workloads ) / sizeof( workloads[0] ) )
+
+static int parse_args( int argc, char **argv, int *json, long *frames );
+static int load_file( const char *filename, libspectrum_word address );
+static void set_memory_map( const workload *w );
+static void set_contention( int contended );
+static void run_workload( const workload *w, long frames, int count,
+                          workload_result *result );
+static double elapsed( const struct timeval *start );
+static void print_text( const workload_result *results, const int *run );
+static void print_json( const workload_result *results, const int *run );
+
+int
+main( int argc, char **argv )
+{
+  workload_result results[ WORKLOAD_COUNT ];
+  int run[ WORKLOAD_COUNT ];
+  int json;
+  long frames;
+  size_t i;
+
+  progname = argv[0];
+
+  if( parse_args( argc, argv, &json, &frames ) ) {
+    fprintf( stderr,
+             "Usage: %s [--json] [--frames <n>] [--rom <48.rom>] "
+             "[--zexall <zexall.com>]\n", progname );
+    return 1;
+  }
+
+  if( core_dummies_init( memory ) ) return 1;
+  machine_current->timings.interrupt_length = INTERRUPT_LENGTH;
+  machine_current->timings.tstates_per_frame = FRAME_LENGTH;
+
+  /* Initialise the tables used by the Z80 core */
+  z80_init( NULL );
+
+  for( i = 0; i < WORKLOAD_COUNT; i++ ) {
+    const workload *w = &workloads[i];
+
+    memset( &results[i], 0, sizeof( results[i] ) );
+    current_workload = w;
+
+    run[i] = 0;
+    set_memory_map( w );
+    set_contention( w->contended );
+    z80_reset( 1 ); tstates = 0;
+    memset( memory, 0, sizeof( memory ) );
+    if( w->setup() ) continue;
+
+    run_workload( w, frames, 0, &results[i] );
+
+    set_memory_map( w );
+    z80_reset( 1 ); tstates = 0;
+    memset( memory, 0, sizeof( memory ) );
+    w->setup();
+
+    run_workload( w, frames, 1, &results[i] );
+
+    run[i] = 1;
+  }
+
+  if( json ) {
+    print_json( results, run );
+  } else {
+    print_text( results, run );
+  }
+
+  return 0;
+}
+
+static int
+parse_args( int argc, char **argv, int *json, long *frames )
+{
+  int i;
+
+  *json = 0; *frames = DEFAULT_FRAMES;
+
+  for( i = 1; i < argc; i++ ) {
+    if( !strcmp( argv[i], "--json" ) ) {
+      *json = 1;
+    } else if( !strcmp( argv[i], "--frames" ) && i + 1 < argc ) {
+      *frames = strtol( argv[++i], NULL, 10 );
+      if( *frames <= 0 ) return 1;
+    } else if( !strcmp( argv[i], "--rom" ) && i + 1 < argc ) {
+      rom_file = argv[++i];
+    } else if( !strcmp( argv[i], "--zexall" ) && i + 1 < argc ) {
+      zexall_file = argv[++i];
+    } else {
+      return 1;
+    }
+  }
+
+  return 0;
+}
+
+static int
+load_file( const char *filename, libspectrum_word address )
+{
+  FILE *f;
+  size_t length;
+
+  f = fopen( filename, "rb" );
+  if( !f ) {
+    fprintf( stderr, "%s: couldn't open `%s': %s\n", progname, filename,
+             strerror( errno ) );
+    return 1;
+  }
+
+  length = fread( &memory[ address ], 1, 0x10000 - address, f );
+  fclose( f );
+
+  if( !length ) {
+    fprintf( stderr, "%s: `%s' is empty\n", progname, filename );
+    return 1;
+  }
+
+  return 0;
+}
+
+static void
+set_memory_map( const workload *w )
+{
+  size_t i;
+
+  for( i = 0; i < MEMORY_PAGES_IN_64K; i++ ) {
+    libspectrum_word address = i * MEMORY_PAGE_SIZE;
+    memory_page *page = &memory_map_read[i];
+
+    memset( page, 0, sizeof( *page ) );
+    page->page = &memory[ address ];
+    page->offset = address & 0x3fff;
+    page->writable = !( w->rom && address < 0x4000 );
+    page->contended = w->contended && address >= 0x4000 && address < 0x8000;
+
+    memory_map_write[i] = *page;
+  }
+}
+
+/* The same pattern as spectrum_contend_delay_65432100(), for both normal and
+   no-MREQ accesses */
+static void
+set_contention( int contended )
+{
+  static const libspectrum_byte pattern[8] = { 6, 5, 4, 3, 2, 1, 0, 0 };
+  libspectrum_dword line, i;
+
+  memset( ula_contention, 0, sizeof( ula_contention ) );
+  ula_contention_start = ula_contention_end = 0;
+
+  if( contended ) {
+    for( line = 0; line < CONTENDED_LINES; line++ )
+      for( i = 0; i < 128; i++ )
+        ula_contention[ FIRST_CONTENDED + line * LINE_LENGTH + i ] =
+          pattern[ i % 8 ];
+
+    ula_contention_start = FIRST_CONTENDED;
+    ula_contention_end = FIRST_CONTENDED + ( CONTENDED_LINES - 1 ) *
+                         LINE_LENGTH + 128;
+  }
+
+  memcpy( ula_contention_no_mreq, ula_contention,
+          sizeof( ula_contention_no_mreq ) );
+}
+
+static void
+run_workload( const workload *w, long frames, int count,
+              workload_result *result )
+{
+  struct timeval start;
+  libspectrum_qword total = 0;
+  long frame;
+
+  counting = count ? result : NULL;
+  periph_traps_armed = count;
+  memset( periph_trap_map[ PERIPH_TRAP_BEFORE_FETCH ], count ? 0xff : 0,
+          sizeof( periph_trap_map[ PERIPH_TRAP_BEFORE_FETCH ] ) );
+  last_fetch = -1;
+
+  gettimeofday( &start, NULL );
+
+  for( frame = 0; w->cpm || frame < frames; frame++ ) {
+
+    event_next_event = FRAME_LENGTH;
+    z80_do_opcodes();
+
+    tstates -= FRAME_LENGTH; total += FRAME_LENGTH;
+    if( z80.interrupts_enabled_at >= 0 )
+      z80.interrupts_enabled_at -= FRAME_LENGTH;
+    if( last_fetch >= 0 ) last_fetch -= FRAME_LENGTH;
+
+    if( w->interrupts ) z80_interrupt();
+
+    /* Back at CP/M's warm boot */
+    if( w->cpm && z80.halted ) { frame++; break; }
+  }
+
+  if( count ) {
+    result->instructions = 0;
+    for( frame = 0; frame < HISTOGRAM_SIZE; frame++ )
+      result->instructions += result->histogram[ frame ];
+  } else {
+    result->seconds = elapsed( &start );
+    result->frames = frame;
+    result->tstates = total + tstates;
+  }
+
+  periph_traps_armed = 0;
+  counting = NULL;
+}
+
+static double
+elapsed( const struct timeval *start )
+{
+  struct timeval now;
+
+  gettimeofday( &now, NULL );
+
+  return ( now.tv_sec - start->tv_sec ) +
+         ( now.tv_usec - start->tv_usec ) / 1000000.0;
+}
+
+/*
+ * The workloads
+ */
+
+/* The 48K ROM from reset, through clearing and testing memory to the
+   copyright message and the editor waiting for a key */
+static int
+setup_rom_boot( void )
+{
+  if( !rom_file ) return 1;
+
+  return load_file( rom_file, 0x0000 );
+}
+
+/* ZEXALL, or any other CP/M program using only BDOS functions 2 and 9. The
+   BDOS entry point is an OUT to port 0x00, which does the work */
+static int
+setup_zexall( void )
+{
+  static const libspectrum_byte bdos[] = { 0xd3, 0x00, 0xc9 };
+
+  if( !zexall_file ) return 1;
+
+  if( load_file( zexall_file, 0x0100 ) ) return 1;
+
+  memory[ 0x0000 ] = 0x76;	/* HALT: warm boot */
+  memory[ 0x0005 ] = 0xc3;	/* JP 0xfe00: BDOS, also the top of the TPA */
+  memory[ 0x0006 ] = 0x00;
+  memory[ 0x0007 ] = 0xfe;
+  memcpy( &memory[ 0xfe00 ], bdos, sizeof( bdos ) );
+
+  PC = 0x0100; SP = 0xfe00;
+
+  return 0;
+}
+
+/* 4Kb block copies round uncontended memory, back to back */
+static int
+setup_ldir( void )
+{
+  static const libspectrum_byte program[] = {
+    0xf3,			/* DI */
+    0x21, 0x00, 0xa0,		/* loop: LD HL,0xa000 */
+    0x11, 0x00, 0xc0,		/* LD DE,0xc000 */
+    0x01, 0x00, 0x10,		/* LD BC,0x1000 */
+    0xed, 0xb0,			/* LDIR */
+    0x18, 0xf3,			/* JR loop */
+  };
+
+  memcpy( &memory[ 0x8000 ], program, sizeof( program ) );
+  PC = 0x8000;
+
+  return 0;
+}
+
+/* Table work through IX and IY, so most instructions carry a prefix and a
+   displacement */
+static int
+setup_indexed( void )
+{
+  static const libspectrum_byte program[] = {
+    0xf3,			/* DI */
+    0xdd, 0x21, 0x00, 0xa0,	/* loop: LD IX,0xa000 */
+    0xfd, 0x21, 0x00, 0xc0,	/* LD IY,0xc000 */
+    0x06, 0x00,			/* LD B,0 */
+    0xdd, 0x7e, 0x00,		/* next: LD A,(IX+0) */
+    0xdd, 0x86, 0x01,		/* ADD A,(IX+1) */
+    0xfd, 0x77, 0x00,		/* LD (IY+0),A */
+    0xfd, 0xae, 0x01,		/* XOR (IY+1) */
+    0xfd, 0x77, 0x01,		/* LD (IY+1),A */
+    0xdd, 0x23,			/* INC IX */
+    0xfd, 0x23,			/* INC IY */
+    0x10, 0xeb,			/* DJNZ next */
+    0x18, 0xdf,			/* JR loop */
+  };
+
+  memcpy( &memory[ 0x8000 ], program, sizeof( program ) );
+  PC = 0x8000;
+
+  return 0;
+}
+
+/* Running from contended memory and rewriting the attributes after each
+   interrupt, as a multicolour effect would */
+static int
+setup_multicolour( void )
+{
+  static const libspectrum_byte program[] = {
+    0xf3,			/* DI */
+    0x31, 0x00, 0x7f,		/* LD SP,0x7f00 */
+    0xed, 0x56,			/* IM 1 */
+    0xfb,			/* EI */
+    0x76,			/* frame: HALT */
+    0x21, 0x00, 0x58,		/* LD HL,0x5800 */
+    0x01, 0x00, 0x03,		/* LD BC,0x0300 */
+    0x7d,			/* next: LD A,L */
+    0xac,			/* XOR H */
+    0x77,			/* LD (HL),A */
+    0x23,			/* INC HL */
+    0x0b,			/* DEC BC */
+    0x78,			/* LD A,B */
+    0xb1,			/* OR C */
+    0x20, 0xf7,			/* JR NZ,next */
+    0x18, 0xee,			/* JR frame */
+  };
+
+  memory[ 0x0038 ] = 0xfb;	/* EI */
+  memory[ 0x0039 ] = 0xc9;	/* RET */
+
+  memcpy( &memory[ 0x6000 ], program, sizeof( program ) );
+  PC = 0x6000;
+
+  return 0;
+}
+
+/* An interrupt routine writing a new set of values to all the AY's tone,
+   noise, mixer and volume registers each frame, as a music player does */
+static int
+setup_ay_player( void )
+{
+  static const libspectrum_byte interrupt[] = {
+    0xf5, 0xe5, 0xc5, 0xd5,	/* PUSH AF, HL, BC, DE */
+    0x2a, 0x00, 0x90,		/* LD HL,(0x9000) */
+    0x1e, 0x00,			/* LD E,0 */
+    0x01, 0xfd, 0xff,		/* reg: LD BC,0xfffd */
+    0xed, 0x59,			/* OUT (C),E */
+    0x06, 0xbf,			/* LD B,0xbf */
+    0x7e,			/* LD A,(HL) */
+    0xed, 0x79,			/* OUT (C),A */
+    0x23,			/* INC HL */
+    0x1c,			/* INC E */
+    0x7b,			/* LD A,E */
+    0xfe, 0x0e,			/* CP 0x0e */
+    0x20, 0xef,			/* JR NZ,reg */
+    0x7c,			/* LD A,H */
+    0xe6, 0x0f,			/* AND 0x0f */
+    0xf6, 0xa0,			/* OR 0xa0 */
+    0x67,			/* LD H,A */
+    0x22, 0x00, 0x90,		/* LD (0x9000),HL */
+    0xd1, 0xc1, 0xe1, 0xf1,	/* POP DE, BC, HL, AF */
+    0xfb,			/* EI */
+    0xc9,			/* RET */
+  };
+  static const libspectrum_byte program[] = {
+    0xf3,			/* DI */
+    0x31, 0x00, 0xff,		/* LD SP,0xff00 */
+    0x21, 0x00, 0xa0,		/* LD HL,0xa000 */
+    0x22, 0x00, 0x90,		/* LD (0x9000),HL */
+    0xed, 0x56,			/* IM 1 */
+    0xfb,			/* EI */
+    0x76,			/* loop: HALT */
+    0x18, 0xfd,			/* JR loop */
+  };
+  libspectrum_dword seed = 1;
+  size_t i;
+
+  memcpy( &memory[ 0x0038 ], interrupt, sizeof( interrupt ) );
+  memcpy( &memory[ 0x8000 ], program, sizeof( program ) );
+
+  /* The "song" */
+  for( i = 0xa000; i < 0xb000; i++ ) {
+    seed = seed * 1103515245 + 12345;
+    memory[i] = seed >> 16;
+  }
+
+  memset( ay_registers, 0, sizeof( ay_registers ) );
+  PC = 0x8000;
+
+  return 0;
+}
+
+/*
+ * Memory and port access, as in memory.c and periph.c
+ */
+
+libspectrum_byte
+readbyte( libspectrum_word address )
+{
+  memory_page *mapping = &memory_map_read[ address >> MEMORY_PAGE_SIZE_LOGARITHM ];
+
+  if( mapping->contended ) tstates += ula_contention[ tstates ];
+  tstates += 3;
+
+  return mapping->page[ address & MEMORY_PAGE_SIZE_MASK ];
+}
+
+libspectrum_byte
+readbyte_uncontended( libspectrum_word address )
+{
+  tstates += 3;
+
+  return readbyte_internal( address );
+}
+
+void
+writebyte_internal( libspectrum_word address, libspectrum_byte b )
+{
+  memory_page *mapping = &memory_map_write[ address >> MEMORY_PAGE_SIZE_LOGARITHM ];
+
+  if( mapping->writable ) mapping->page[ address & MEMORY_PAGE_SIZE_MASK ] = b;
+}
+
+void
+writebyte( libspectrum_word address, libspectrum_byte b )
+{
+  if( memory_map_write[ address >> MEMORY_PAGE_SIZE_LOGARITHM ].contended )
+    tstates += ula_contention[ tstates ];
+  tstates += 3;
+
+  writebyte_internal( address, b );
+}
+
+void
+writebyte_uncontended( libspectrum_word address, libspectrum_byte b )
+{
+  tstates += 3;
+
+  writebyte_internal( address, b );
+}
+
+static void
+contend_port_early( libspectrum_word port )
+{
+  if( memory_map_read[ port >> MEMORY_PAGE_SIZE_LOGARITHM ].contended )
+    tstates += ula_contention_no_mreq[ tstates ];
+
+  tstates++;
+}
+
+static void
+contend_port_late( libspectrum_word port )
+{
+  if( !( port & 0x0001 ) ) {
+
+    tstates += ula_contention_no_mreq[ tstates ]; tstates += 2;
+
+  } else if( memory_map_read[ port >> MEMORY_PAGE_SIZE_LOGARITHM ].contended ) {
+
+    tstates += ula_contention_no_mreq[ tstates ]; tstates++;
+    tstates += ula_contention_no_mreq[ tstates ]; tstates++;
+    tstates += ula_contention_no_mreq[ tstates ];
+
+  } else {
+
+    tstates += 2;
+
+  }
+}
+
+libspectrum_byte
+readport( libspectrum_word port )
+{
+  libspectrum_byte value = 0xff;
+
+  contend_port_early( port );
+  contend_port_late( port );
+
+  if( port == 0xfffd ) value = ay_registers[ ay_register ];
+
+  tstates++;
+
+  return value;
+}
+
+static void
+bdos_call( void )
+{
+  libspectrum_word address;
+
+  switch( C ) {
+
+  case 2:
+    putc( E, stderr );
+    break;
+
+  case 9:
+    for( address = DE; memory[ address ] != '$'; address++ )
+      putc( memory[ address ], stderr );
+    break;
+
+  }
+}
+
+void
+writeport( libspectrum_word port, libspectrum_byte b )
+{
+  contend_port_early( port );
+
+  if( current_workload->cpm && ( port & 0xff ) == 0x00 ) {
+    bdos_call();
+  } else if( ( port & 0xc002 ) == 0xc000 ) {
+    ay_register = b & 0x0f;
+  } else if( ( port & 0xc002 ) == 0x8000 ) {
+    ay_registers[ ay_register ] = b;
+  }
+
+  contend_port_late( port );
+  tstates++;
+}
+
+/* Called before every opcode fetch while counting */
+void
+periph_run_traps( periph_trap_stage stage GCC_UNUSED,
+                  libspectrum_word pc GCC_UNUSED )
+{
+  libspectrum_signed_qword cycles;
+
+  if( last_fetch >= 0 ) {
+    cycles = (libspectrum_signed_qword)tstates - last_fetch;
+    if( cycles >= HISTOGRAM_SIZE ) cycles = HISTOGRAM_SIZE - 1;
+    counting->histogram[ cycles ]++;
+  }
+
+  last_fetch = tstates;
+}
+
+/*
+ * Output
+ */
+
+static void
+print_text( const workload_result *results, const int *run )
+{
+  size_t i, j;
+
+  printf( "%-12s %8s %12s %8s %10s %12s\n", "workload", "frames", "tstates",
+          "seconds", "MHz", "instrs/sec" );
+
+  for( i = 0; i < WORKLOAD_COUNT; i++ ) {
+    const workload_result *r = &results[i];
+
+    if( !run[i] ) {
+      printf( "%-12s (skipped)\n", workloads[i].name );
+      continue;
+    }
+
+    printf( "%-12s %8lu %12lu %8.3f %10.2f %12.0f\n", workloads[i].name,
+            (unsigned long)r->frames, (unsigned long)r->tstates, r->seconds,
+            r->tstates / r->seconds / 1e6, r->instructions / r->seconds );
+
+    printf( "  tstates per instruction:" );
+    for( j = 0; j < HISTOGRAM_SIZE; j++ )
+      if( r->histogram[j] )
+        printf( " %lu%s:%lu", (unsigned long)j,
+                j == HISTOGRAM_SIZE - 1 ? "+" : "",
+                (unsigned long)r->histogram[j] );
+    printf( "\n" );
+  }
+}
+
+static void
+print_json( const workload_result *results, const int *run )
+{
+  size_t i, j;
+  const char *separator = "";
+
+  printf( "{\n  \"frame_length\": %d,\n  \"workloads\": [", FRAME_LENGTH );
+
+  for( i = 0; i < WORKLOAD_COUNT; i++ ) {
+    const workload_result *r = &results[i];
+    const char *bucket_separator = "";
+
+    if( !run[i] ) continue;
+
+    printf( "%s\n    {\n", separator );
+    printf( "      \"name\": \"%s\",\n", workloads[i].name );
+    printf( "      \"frames\": %lu,\n", (unsigned long)r->frames );
+    printf( "      \"tstates\": %lu,\n", (unsigned long)r->tstates );
+    printf( "      \"instructions\": %lu,\n",
+            (unsigned long)r->instructions );
+    printf( "      \"seconds\": %.6f,\n", r->seconds );
+    printf( "      \"emulated_mhz\": %.3f,\n",
+            r->tstates / r->seconds / 1e6 );
+    printf( "      \"instructions_per_second\": %.0f,\n",
+            r->instructions / r->seconds );
+
+    printf( "      \"tstates_per_instruction\": {" );
+    for( j = 0; j < HISTOGRAM_SIZE; j++ ) {
+      if( !r->histogram[j] ) continue;
+      printf( "%s \"%lu%s\": %lu", bucket_separator, (unsigned long)j,
+              j == HISTOGRAM_SIZE - 1 ? "+" : "",
+              (unsigned long)r->histogram[j] );
+      bucket_separator = ",";
+    }
+    printf( " }\n    }" );
+
+    separator = ",";
+  }
+
+  printf( "\n  ]\n}\n" );
+}
@@ -83,6 +83,10 @@ struct libspectrum_snap {
 
   libspectrum_byte *pages[ SNAPSHOT_RAM_PAGES ];
 
+  /* Memory owned by the caller for the RAM pages to live in */
+  libspectrum_byte *page_buffer;
+  size_t page_buffer_pages;
+
   /* Data from .slt files */
 
   libspectrum_byte *slt[ SNAPSHOT_SLT_PAGES ];	/* Level data */
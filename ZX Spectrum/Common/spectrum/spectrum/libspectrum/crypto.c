@@ -62,6 +62,9 @@ libspectrum_sign_data( libspectrum_byte **signature, size_t *signature_length,
   int error;
   gcry_mpi_t r, s;
 
+  error = libspectrum_gcrypt_init();
+  if( error ) return error;
+
   error = get_signature( &r, &s, data, data_length, key );
   if( error ) return error;
 
@@ -302,6 +305,9 @@ libspectrum_verify_signature( libspectrum_signature *signature,
   gcry_error_t gcrypt_error;
   gcry_sexp_t hash, key_sexp, signature_sexp;
 
+  error = libspectrum_gcrypt_init();
+  if( error ) return error;
+
   error = get_hash( &hash, signature->start, signature->length );
   if( error ) return error;
 
@@ -31,6 +31,36 @@
 /* The .csw file signature (first 23 bytes) */
 static const char * const csw_signature = "Compressed Square Wave\x1a";
 
+#ifdef HAVE_ZLIB_H
+
+/* Find the inflated length of a Z-RLE block, and its length in tstates
+   counted in the same way as for uncompressed blocks, in one pass over a
+   window's worth of data at a time */
+static libspectrum_error
+csw_measure_stream( libspectrum_tape_rle_pulse_block *csw_block )
+{
+  const libspectrum_byte *data;
+  size_t offset = 0, available, i;
+  libspectrum_dword tstates = 0;
+  libspectrum_error error;
+
+  do {
+    error = libspectrum_zlib_stream_window( csw_block->stream, offset, &data,
+                                            &available );
+    if( error != LIBSPECTRUM_ERROR_NONE ) return error;
+
+    for( i = 0; i < available; i++ ) tstates += data[i] * csw_block->scale;
+    offset += available;
+  } while( available );
+
+  csw_block->length = offset;
+  csw_block->tstates = tstates;
+
+  return LIBSPECTRUM_ERROR_NONE;
+}
+
+#endif			/* #ifdef HAVE_ZLIB_H */
+
 libspectrum_error
 libspectrum_csw_read( libspectrum_tape *tape,
 		      const libspectrum_byte *buffer, size_t length )
@@ -51,10 +81,7 @@ libspectrum_csw_read( libspectrum_tape *tape,
   }
 
   /* Claim memory for the block */
-  block = libspectrum_new( libspectrum_tape_block, 1 );
-
-  /* Set the block type */
-  block->type = LIBSPECTRUM_TAPE_BLOCK_RLE_PULSE;
+  block = libspectrum_tape_block_alloc( LIBSPECTRUM_TAPE_BLOCK_RLE_PULSE );
   csw_block = &block->types.rle_pulse;
 
   buffer += signature_length;
@@ -111,11 +138,29 @@ libspectrum_csw_read( libspectrum_tape *tape,
 #ifdef HAVE_ZLIB_H
     libspectrum_error error;
 
-    csw_block->data = NULL;
-    csw_block->length = 0;
-    error = libspectrum_zlib_inflate( buffer, length, &csw_block->data,
-                                      &csw_block->length );
-    if( error != LIBSPECTRUM_ERROR_NONE ) return error;
+    /* Keep the data compressed and inflate it as the tape is played; a long
+       recording can be hundreds of megabytes once inflated */
+    csw_block->compressed_length = length;
+    csw_block->compressed = libspectrum_new( libspectrum_byte, length );
+    memcpy( csw_block->compressed, buffer, length );
+
+    csw_block->stream =
+      libspectrum_zlib_stream_alloc( csw_block->compressed, length );
+    if( !csw_block->stream ) {
+      libspectrum_tape_block_free( block );
+      return LIBSPECTRUM_ERROR_MEMORY;
+    }
+
+    error = csw_measure_stream( csw_block );
+    if( error != LIBSPECTRUM_ERROR_NONE ) {
+      libspectrum_tape_block_free( block );
+      return error;
+    }
+
+    if( !csw_block->length ) {
+      libspectrum_tape_block_free( block );
+      return LIBSPECTRUM_ERROR_NONE;
+    }
 #else
     libspectrum_print_error( LIBSPECTRUM_ERROR_UNKNOWN,
                              "zlib not available to decompress gzipped file" );
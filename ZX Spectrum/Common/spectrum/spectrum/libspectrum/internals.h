@@ -144,6 +144,59 @@ libspectrum_error
 libspectrum_zip_blind_read( const libspectrum_byte *zipptr, size_t ziplength,
                             libspectrum_byte **outptr, size_t *outlength );
 
+#ifdef HAVE_ZLIB_H
+
+libspectrum_error
+libspectrum_zlib_inflate_to_buffer( const libspectrum_byte *gzptr,
+				    size_t gzlength, libspectrum_byte *outptr,
+				    size_t outlength );
+
+/* One page for libspectrum_zlib_compress_pages() or
+   libspectrum_zlib_inflate_pages(), which work through a set of pages on
+   several threads where possible */
+typedef struct libspectrum_zlib_page {
+
+  const libspectrum_byte *data;	/* The input */
+  size_t length;
+
+  libspectrum_byte *output;	/* The output */
+  size_t output_length;
+
+  libspectrum_error error;
+  const char *message;		/* What went wrong, if error is set */
+
+} libspectrum_zlib_page;
+
+libspectrum_error
+libspectrum_zlib_compress_pages( libspectrum_zlib_page *pages, size_t count );
+
+libspectrum_error
+libspectrum_zlib_inflate_pages( libspectrum_zlib_page *pages, size_t count );
+
+/* Stop the threads used by the two functions above */
+void libspectrum_zlib_end( void );
+
+/* Inflates zlib data a window at a time as it's read, for data which may
+   be much bigger once inflated */
+typedef struct libspectrum_zlib_stream libspectrum_zlib_stream;
+
+libspectrum_zlib_stream*
+libspectrum_zlib_stream_alloc( const libspectrum_byte *data, size_t length );
+
+void
+libspectrum_zlib_stream_free( libspectrum_zlib_stream *stream );
+
+libspectrum_error
+libspectrum_zlib_stream_window( libspectrum_zlib_stream *stream, size_t offset,
+				const libspectrum_byte **data,
+				size_t *available );
+
+libspectrum_error
+libspectrum_zlib_stream_byte( libspectrum_zlib_stream *stream, size_t offset,
+			      libspectrum_byte *byte );
+
+#endif				/* #ifdef HAVE_ZLIB_H */
+
 /* The TZX file signature */
 
 extern const char * const libspectrum_tzx_signature;
@@ -187,6 +240,11 @@ libspectrum_error
 libspectrum_szx_read( libspectrum_snap *snap,
 		      const libspectrum_byte *buffer, size_t buffer_length );
 libspectrum_error
+internal_szx_read_metadata( libspectrum_snap *snap,
+			    const libspectrum_byte *buffer,
+			    size_t buffer_length, libspectrum_byte *screen,
+			    int *have_screen );
+libspectrum_error
 libspectrum_szx_write( libspectrum_byte **buffer, size_t *length,
 		       int *out_flags, libspectrum_snap *snap,
 		       libspectrum_creator *creator, int in_flags );
@@ -194,6 +252,11 @@ libspectrum_error
 internal_z80_read( libspectrum_snap *snap,
 		   const libspectrum_byte *buffer, size_t buffer_length );
 libspectrum_error
+internal_z80_read_metadata( libspectrum_snap *snap,
+			    const libspectrum_byte *buffer,
+			    size_t buffer_length, libspectrum_byte *screen,
+			    int *have_screen );
+libspectrum_error
 libspectrum_z80_write2( libspectrum_byte **buffer, size_t *length,
 			int *out_flags, libspectrum_snap *snap, int in_flags );
 libspectrum_error
@@ -210,6 +273,10 @@ extern const libspectrum_dword LIBSPECTRUM_TAPE_TIMING_DATA0;
 extern const libspectrum_dword LIBSPECTRUM_TAPE_TIMING_DATA1;
 extern const libspectrum_dword LIBSPECTRUM_TAPE_TIMING_TAIL;
 
+/* The number of pilot pulses before headers and data blocks */
+extern const size_t LIBSPECTRUM_TAPE_PILOTS_HEADER;
+extern const size_t LIBSPECTRUM_TAPE_PILOTS_DATA;
+
 /* Tape routines */
 
 void libspectrum_tape_block_zero( libspectrum_tape_block *block );
@@ -224,6 +291,9 @@ libspectrum_tape_block_read_symbol_table(
 
 void libspectrum_init_bits_set( void );
 
+/* Initialise libgcrypt if it hasn't been already */
+libspectrum_error libspectrum_gcrypt_init( void );
+
 /* Format specific tape routines */
   
 libspectrum_error
@@ -265,6 +335,15 @@ libspectrum_error
 internal_pzx_read( libspectrum_tape *tape, const libspectrum_byte *buffer,
                    const size_t length );
 
+libspectrum_error
+internal_pzx_write( libspectrum_byte **buffer, size_t *length,
+                    libspectrum_tape *tape );
+
+/* Work out from a tape's hardware info blocks which machine it wants */
+libspectrum_error
+libspectrum_tape_guess_hardware( libspectrum_machine *machine,
+				 const libspectrum_tape *tape );
+
 libspectrum_tape_block*
 libspectrum_tape_block_internal_init(
                                 libspectrum_tape_block_state *iterator,
@@ -39,6 +39,7 @@ static const char * const MIN_GCRYPT_VERSION = "1.1.42";
 #endif				/* #ifdef HAVE_GCRYPT_H */
 
 static const char *gcrypt_version;
+static int gcrypt_initialised;
 
 #include "internals.h"
 
@@ -79,15 +80,36 @@ gcrypt_log_handler( void *opaque, int level, const char *format, va_list ap );
 libspectrum_error
 libspectrum_init( void )
 {
+  /* libgcrypt is needed only for signed RZX files, so it is left until
+     libspectrum_gcrypt_init() is called */
+  libspectrum_init_bits_set();
+
+  return LIBSPECTRUM_ERROR_NONE;
+}
+
+/* Initialise libgcrypt the first time it's needed, rather than at start-up */
+libspectrum_error
+libspectrum_gcrypt_init( void )
+{
+  if( gcrypt_initialised )
+    return gcrypt_version ? LIBSPECTRUM_ERROR_NONE : LIBSPECTRUM_ERROR_LOGIC;
+
+  gcrypt_initialised = 1;
+
 #ifdef HAVE_GCRYPT_H
 
-  if( !gcry_control( GCRYCTL_ANY_INITIALIZATION_P ) ) {
+  if( gcry_control( GCRYCTL_ANY_INITIALIZATION_P ) ) {
+
+    /* Someone else has already done it */
+    gcrypt_version = gcry_check_version( NULL );
+
+  } else {
 
     gcrypt_version = gcry_check_version( MIN_GCRYPT_VERSION );
     if( !gcrypt_version ) {
       libspectrum_print_error(
         LIBSPECTRUM_ERROR_LOGIC,
-	"libspectrum_init: found libgcrypt %s, but need %s",
+	"libspectrum_gcrypt_init: found libgcrypt %s, but need %s",
 	gcry_check_version( NULL ), MIN_GCRYPT_VERSION
       );
       return LIBSPECTRUM_ERROR_LOGIC;	/* FIXME: better error code */
@@ -108,20 +130,22 @@ libspectrum_init( void )
     gcry_control( GCRYCTL_INITIALIZATION_FINISHED );
   }
 
+  return LIBSPECTRUM_ERROR_NONE;
+
 #else				/* #ifdef HAVE_GCRYPT_H */
 
-  gcrypt_version = NULL;
+  return LIBSPECTRUM_ERROR_LOGIC;
 
 #endif				/* #ifdef HAVE_GCRYPT_H */
-
-  libspectrum_init_bits_set();
-
-  return LIBSPECTRUM_ERROR_NONE;
 }
 
 void
 libspectrum_end( void )
 {
+#ifdef HAVE_ZLIB_H
+  libspectrum_zlib_end();
+#endif				/* #ifdef HAVE_ZLIB_H */
+
 #ifndef HAVE_LIB_GLIB
   libspectrum_slist_cleanup();
   libspectrum_hashtable_cleanup();
@@ -171,6 +195,8 @@ libspectrum_version( void )
 const char *
 libspectrum_gcrypt_version( void )
 {
+  libspectrum_gcrypt_init();
+
   return gcrypt_version;
 }
 
@@ -611,6 +611,50 @@ libspectrum_timings_lines_per_frame( libspectrum_machine machine );
 WIN32_DLL libspectrum_dword
 libspectrum_timings_tstates_per_frame( libspectrum_machine machine );
 
+/* Quick identification of a file's contents, for file selectors and
+   indexes. Only the headers and the first few blocks are examined */
+
+typedef struct libspectrum_metadata libspectrum_metadata;
+
+/* The length of the loading screen returned */
+#define LIBSPECTRUM_METADATA_SCREEN_LENGTH 6912
+
+/* How much of a tape file is worth reading; anything which isn't a tape
+   must be given in full */
+#define LIBSPECTRUM_METADATA_PROBE_LENGTH 0x10000
+
+WIN32_DLL libspectrum_metadata*
+libspectrum_metadata_alloc( void );
+WIN32_DLL libspectrum_error
+libspectrum_metadata_free( libspectrum_metadata *metadata );
+
+WIN32_DLL libspectrum_error
+libspectrum_metadata_read( libspectrum_metadata *metadata,
+			   const libspectrum_byte *buffer, size_t length,
+			   const char *filename );
+
+WIN32_DLL libspectrum_id_t
+libspectrum_metadata_type( libspectrum_metadata *metadata );
+WIN32_DLL libspectrum_class_t
+libspectrum_metadata_class( libspectrum_metadata *metadata );
+WIN32_DLL libspectrum_machine
+libspectrum_metadata_machine( libspectrum_metadata *metadata );
+
+/* The contents of the tape's first archive info block, if any */
+WIN32_DLL size_t
+libspectrum_metadata_archive_info_count( libspectrum_metadata *metadata );
+WIN32_DLL int
+libspectrum_metadata_archive_info_id( libspectrum_metadata *metadata,
+				      size_t idx );
+WIN32_DLL const char*
+libspectrum_metadata_archive_info_string( libspectrum_metadata *metadata,
+					  size_t idx );
+
+/* The snapshot's screen or the tape's loading screen in the Spectrum's
+   normal layout, or NULL if there isn't one */
+WIN32_DLL const libspectrum_byte*
+libspectrum_metadata_screen( libspectrum_metadata *metadata );
+
 /* Creator information */
 
 typedef struct libspectrum_creator libspectrum_creator;
@@ -663,6 +707,13 @@ typedef struct libspectrum_snap libspectrum_snap;
 WIN32_DLL libspectrum_snap* libspectrum_snap_alloc( void );
 WIN32_DLL libspectrum_error libspectrum_snap_free( libspectrum_snap *snap );
 
+/* A snap may be given a page buffer of page_buffer_pages 16K pages, with
+   page n at page_buffer + n * 0x4000. RAM pages which point into the buffer
+   belong to the caller and are not freed with the snap, and the .szx reader
+   places the RAM pages it reads directly into the buffer */
+WIN32_DLL libspectrum_byte*
+libspectrum_snap_page_buffer_page( libspectrum_snap *snap, int page );
+
 /* Read in a snapshot, optionally guessing what type it is */
 WIN32_DLL libspectrum_error
 libspectrum_snap_read( libspectrum_snap *snap, const libspectrum_byte *buffer,
@@ -875,6 +926,10 @@ WIN32_DLL size_t libspectrum_snap_rom_length( libspectrum_snap *snap, int idx );
 WIN32_DLL void libspectrum_snap_set_rom_length( libspectrum_snap *snap, int idx, size_t rom_length );
 WIN32_DLL libspectrum_byte * libspectrum_snap_pages( libspectrum_snap *snap, int idx );
 WIN32_DLL void libspectrum_snap_set_pages( libspectrum_snap *snap, int idx, libspectrum_byte* pages );
+WIN32_DLL libspectrum_byte * libspectrum_snap_page_buffer( libspectrum_snap *snap );
+WIN32_DLL void libspectrum_snap_set_page_buffer( libspectrum_snap *snap, libspectrum_byte* page_buffer );
+WIN32_DLL size_t libspectrum_snap_page_buffer_pages( libspectrum_snap *snap );
+WIN32_DLL void libspectrum_snap_set_page_buffer_pages( libspectrum_snap *snap, size_t page_buffer_pages );
 WIN32_DLL libspectrum_byte * libspectrum_snap_slt( libspectrum_snap *snap, int idx );
 WIN32_DLL void libspectrum_snap_set_slt( libspectrum_snap *snap, int idx, libspectrum_byte* slt );
 WIN32_DLL size_t libspectrum_snap_slt_length( libspectrum_snap *snap, int idx );
@@ -1259,6 +1314,14 @@ WIN32_DLL libspectrum_error
 libspectrum_tape_write( libspectrum_byte **buffer, size_t *length,
 			libspectrum_tape *tape, libspectrum_id_t type );
 
+/* Write one block as it would appear in a .tzx, .pzx or .tap file, without
+   the file's header, so a file can be written a block at a time. The header
+   is what libspectrum_tape_write() gives for an empty tape */
+WIN32_DLL libspectrum_error
+libspectrum_tape_block_write( libspectrum_byte **buffer, size_t *length,
+			      libspectrum_tape_block *block,
+			      libspectrum_id_t type );
+
 /* Does this tape structure actually contain a tape? */
 WIN32_DLL int libspectrum_tape_present( const libspectrum_tape *tape );
 
@@ -1386,6 +1449,15 @@ libspectrum_rzx_playback_frame( libspectrum_rzx *rzx, int *finished, libspectrum
 WIN32_DLL libspectrum_error
 libspectrum_rzx_playback( libspectrum_rzx *rzx, libspectrum_byte *byte );
 
+/* Where playback has got to, and moving it to anywhere in the file. Seeking
+   leaves the machine state alone: restoring that is up to the caller */
+WIN32_DLL libspectrum_error
+libspectrum_rzx_playback_position( libspectrum_rzx *rzx, int *which,
+				   size_t *frame );
+WIN32_DLL libspectrum_error
+libspectrum_rzx_playback_seek( libspectrum_rzx *rzx, int which,
+			       size_t frame );
+
 /* Get and set the tstate counter */
 WIN32_DLL size_t libspectrum_rzx_tstates( libspectrum_rzx *rzx );
 
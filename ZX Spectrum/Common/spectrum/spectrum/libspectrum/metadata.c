@@ -0,0 +1,435 @@
+/* metadata.c: Quick identification of a file's contents
+   Copyright (c) 2026 The Fuse authors
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+   Author contact information:
+
+   E-mail: philip-fuse@shadowmagic.org.uk
+
+*/
+
+#include "config.h"
+
+#include <string.h>
+
+#include "internals.h"
+
+struct libspectrum_metadata {
+
+  libspectrum_id_t type;
+  libspectrum_class_t class;
+  libspectrum_machine machine;
+
+  /* Copied from the first archive info block of a tape */
+  size_t archive_info_count;
+  int *archive_info_ids;
+  char **archive_info_strings;
+
+  int have_screen;
+  libspectrum_byte screen[ LIBSPECTRUM_METADATA_SCREEN_LENGTH ];
+
+};
+
+static void
+metadata_clear( libspectrum_metadata *metadata )
+{
+  size_t i;
+
+  for( i = 0; i < metadata->archive_info_count; i++ )
+    libspectrum_free( metadata->archive_info_strings[i] );
+  libspectrum_free( metadata->archive_info_strings );
+  libspectrum_free( metadata->archive_info_ids );
+
+  metadata->type = LIBSPECTRUM_ID_UNKNOWN;
+  metadata->class = LIBSPECTRUM_CLASS_UNKNOWN;
+  metadata->machine = LIBSPECTRUM_MACHINE_UNKNOWN;
+  metadata->archive_info_count = 0;
+  metadata->archive_info_ids = NULL;
+  metadata->archive_info_strings = NULL;
+  metadata->have_screen = 0;
+}
+
+libspectrum_metadata*
+libspectrum_metadata_alloc( void )
+{
+  libspectrum_metadata *metadata = libspectrum_new0( libspectrum_metadata, 1 );
+  metadata_clear( metadata );
+  return metadata;
+}
+
+libspectrum_error
+libspectrum_metadata_free( libspectrum_metadata *metadata )
+{
+  metadata_clear( metadata );
+  libspectrum_free( metadata );
+
+  return LIBSPECTRUM_ERROR_NONE;
+}
+
+/* The length of the TZX block starting at `block' (including its ID), or
+   0 if not enough of the block is present to tell */
+static size_t
+tzx_block_length( const libspectrum_byte *block, const libspectrum_byte *end )
+{
+  const libspectrum_byte *data = block + 1;
+  size_t available, header, length, i;
+
+  if( end - block < 1 ) return 0;
+  available = end - data;
+
+  /* Enough of every block type to find its length */
+
+  switch( *block ) {
+
+  case 0x10: header = 0x04; break;
+  case 0x11: header = 0x12; break;
+  case 0x12: header = 0x04; break;
+  case 0x13: header = 0x01; break;
+  case 0x14: header = 0x0a; break;
+  case 0x15: header = 0x08; break;
+  case 0x20: case 0x23: case 0x24: header = 0x02; break;
+  case 0x21: case 0x30: case 0x33: header = 0x01; break;
+  case 0x22: case 0x25: case 0x27: header = 0x00; break;
+  case 0x26: case 0x28: case 0x31: case 0x32: header = 0x02; break;
+  case 0x34: header = 0x08; break;
+  case 0x35: header = 0x14; break;
+  case 0x5a: header = 0x09; break;
+  default: header = 0x04; break;	/* All newer blocks start with a dword
+					   length */
+  }
+
+  if( available < header ) return 0;
+
+  switch( *block ) {
+
+  case 0x10: length = 0x04 + data[2] + data[3] * 0x100; break;
+  case 0x11:
+    length = 0x12 + data[0x0f] + data[0x10] * 0x100 + data[0x11] * 0x10000;
+    break;
+  case 0x12: length = 0x04; break;
+  case 0x13: length = 0x01 + 2 * data[0]; break;
+  case 0x14: length = 0x0a + data[7] + data[8] * 0x100 + data[9] * 0x10000;
+    break;
+  case 0x15: length = 0x08 + data[5] + data[6] * 0x100 + data[7] * 0x10000;
+    break;
+  case 0x20: case 0x23: case 0x24: length = 0x02; break;
+  case 0x21: case 0x30: length = 0x01 + data[0]; break;
+  case 0x22: case 0x25: case 0x27: length = 0x00; break;
+  case 0x26: length = 0x02 + 2 * ( data[0] + data[1] * 0x100 ); break;
+  case 0x28: length = 0x02 + data[0] + data[1] * 0x100; break;
+  case 0x32:
+    /* As tzx_read.c, ignore the block length and walk the strings */
+    if( available < 0x03 ) return 0;
+    for( i = 0, length = 0x03; i < data[2]; i++ ) {
+      if( available < length + 2 ) return 0;
+      length += 2 + data[ length + 1 ];
+    }
+    break;
+  case 0x31: length = 0x02 + data[1]; break;
+  case 0x33: length = 0x01 + 3 * data[0]; break;
+  case 0x34: length = 0x08; break;
+  case 0x35:
+    length = 0x14 + data[0x10] + data[0x11] * 0x100 +
+             data[0x12] * 0x10000 + data[0x13] * 0x1000000;
+    break;
+  case 0x40:
+    length = 0x04 + data[1] + data[2] * 0x100 + data[3] * 0x10000;
+    break;
+  case 0x5a: length = 0x09; break;
+  default:
+    length = 0x04 + data[0] + data[1] * 0x100 + data[2] * 0x10000 +
+             data[3] * 0x1000000;
+    break;
+  }
+
+  return 1 + length;
+}
+
+/* How much of the start of `buffer' is made up of complete blocks, so it can
+   be given to the normal tape reader even if the file has been cut short */
+static size_t
+complete_tape_length( const libspectrum_byte *buffer, size_t length,
+                      libspectrum_id_t type )
+{
+  const libspectrum_byte *ptr = buffer, *end = buffer + length;
+  size_t block_length;
+
+  switch( type ) {
+
+  case LIBSPECTRUM_ID_TAPE_TZX:
+    if( length < 10 ) return 0;
+    ptr += 10;
+    while( ( block_length = tzx_block_length( ptr, end ) ) != 0 &&
+           block_length <= (size_t)( end - ptr ) )
+      ptr += block_length;
+    break;
+
+  case LIBSPECTRUM_ID_TAPE_TAP:
+    while( end - ptr >= 2 &&
+           (size_t)( end - ptr ) >= 2 + ptr[0] + ptr[1] * 0x100 )
+      ptr += 2 + ptr[0] + ptr[1] * 0x100;
+    break;
+
+  case LIBSPECTRUM_ID_TAPE_PZX:
+    while( end - ptr >= 8 ) {
+      block_length = 8 + ptr[4] + ptr[5] * 0x100 + ptr[6] * 0x10000 +
+                     ptr[7] * 0x1000000;
+      if( block_length > (size_t)( end - ptr ) ) break;
+      ptr += block_length;
+    }
+    break;
+
+  default:
+    break;
+
+  }
+
+  return ptr - buffer;
+}
+
+/* Is this the standard header for a 6912 byte block of code at 16384? */
+static int
+is_screen_header( libspectrum_tape_block *block )
+{
+  libspectrum_byte *data;
+
+  if( libspectrum_tape_block_type( block ) != LIBSPECTRUM_TAPE_BLOCK_ROM ||
+      libspectrum_tape_block_data_length( block ) != 19 )
+    return 0;
+
+  data = libspectrum_tape_block_data( block );
+
+  return data[0] == 0x00 && data[1] == 0x03 &&
+         data[12] + data[13] * 0x100 == LIBSPECTRUM_METADATA_SCREEN_LENGTH &&
+         data[14] + data[15] * 0x100 == 0x4000;
+}
+
+static void
+read_tape_metadata( libspectrum_metadata *metadata, libspectrum_tape *tape )
+{
+  libspectrum_tape_iterator iterator;
+  libspectrum_tape_block *block;
+  int after_screen_header = 0;
+  size_t i, count;
+
+  libspectrum_tape_guess_hardware( &metadata->machine, tape );
+
+  for( block = libspectrum_tape_iterator_init( &iterator, tape );
+       block;
+       block = libspectrum_tape_iterator_next( &iterator ) ) {
+
+    switch( libspectrum_tape_block_type( block ) ) {
+
+    case LIBSPECTRUM_TAPE_BLOCK_ARCHIVE_INFO:
+      if( metadata->archive_info_count ) break;
+
+      count = libspectrum_tape_block_count( block );
+      metadata->archive_info_ids = libspectrum_new( int, count );
+      metadata->archive_info_strings = libspectrum_new( char*, count );
+      for( i = 0; i < count; i++ ) {
+        metadata->archive_info_ids[i] = libspectrum_tape_block_ids( block, i );
+        metadata->archive_info_strings[i] =
+          strdup( libspectrum_tape_block_texts( block, i ) );
+      }
+      metadata->archive_info_count = count;
+      break;
+
+    case LIBSPECTRUM_TAPE_BLOCK_ROM:
+    case LIBSPECTRUM_TAPE_BLOCK_TURBO:
+      if( after_screen_header && !metadata->have_screen &&
+          libspectrum_tape_block_data_length( block ) >=
+            LIBSPECTRUM_METADATA_SCREEN_LENGTH + 2 ) {
+        memcpy( metadata->screen, libspectrum_tape_block_data( block ) + 1,
+                LIBSPECTRUM_METADATA_SCREEN_LENGTH );
+        metadata->have_screen = 1;
+      }
+      after_screen_header = is_screen_header( block );
+      break;
+
+    default:
+      break;
+
+    }
+  }
+}
+
+static libspectrum_error
+read_tape( libspectrum_metadata *metadata, const libspectrum_byte *buffer,
+           size_t length )
+{
+  libspectrum_tape *tape;
+  libspectrum_error error;
+
+  /* Only formats which can be cut at a block boundary are read; the rest
+     don't carry anything more than their type anyway */
+  length = complete_tape_length( buffer, length, metadata->type );
+  if( !length ) return LIBSPECTRUM_ERROR_NONE;
+
+  tape = libspectrum_tape_alloc();
+
+  error = libspectrum_tape_read( tape, buffer, length, metadata->type, NULL );
+  if( !error ) read_tape_metadata( metadata, tape );
+
+  libspectrum_tape_free( tape );
+
+  return error;
+}
+
+static libspectrum_error
+read_snapshot( libspectrum_metadata *metadata, const libspectrum_byte *buffer,
+               size_t length, const char *filename )
+{
+  libspectrum_snap *snap;
+  libspectrum_byte *page;
+  libspectrum_error error;
+
+  snap = libspectrum_snap_alloc();
+
+  switch( metadata->type ) {
+
+  case LIBSPECTRUM_ID_SNAPSHOT_Z80:
+    error = internal_z80_read_metadata( snap, buffer, length,
+                                        metadata->screen,
+                                        &metadata->have_screen );
+    break;
+
+  case LIBSPECTRUM_ID_SNAPSHOT_SZX:
+    error = internal_szx_read_metadata( snap, buffer, length,
+                                        metadata->screen,
+                                        &metadata->have_screen );
+    break;
+
+  default:
+    error = libspectrum_snap_read( snap, buffer, length, metadata->type,
+                                   filename );
+    if( error ) break;
+
+    page = libspectrum_snap_pages( snap, 5 );
+    if( page ) {
+      memcpy( metadata->screen, page, LIBSPECTRUM_METADATA_SCREEN_LENGTH );
+      metadata->have_screen = 1;
+    }
+    break;
+
+  }
+
+  if( !error ) metadata->machine = libspectrum_snap_machine( snap );
+
+  libspectrum_snap_free( snap );
+
+  return error;
+}
+
+libspectrum_error
+libspectrum_metadata_read( libspectrum_metadata *metadata,
+                           const libspectrum_byte *buffer, size_t length,
+                           const char *filename )
+{
+  libspectrum_id_t type;
+  libspectrum_class_t class;
+  libspectrum_byte *new_buffer;
+  size_t new_length;
+  char *new_filename = NULL;
+  libspectrum_error error;
+
+  metadata_clear( metadata );
+
+  error = libspectrum_identify_file_raw( &type, filename, buffer, length );
+  if( error ) return error;
+
+  error = libspectrum_identify_class( &class, type );
+  if( error ) return error;
+
+  if( class == LIBSPECTRUM_CLASS_COMPRESSED ) {
+
+    error = libspectrum_uncompress_file( &new_buffer, &new_length,
+                                         filename ? &new_filename : NULL,
+                                         type, buffer, length, filename );
+    if( error ) return error;
+
+    error = libspectrum_metadata_read( metadata, new_buffer, new_length,
+                                       new_filename );
+
+    libspectrum_free( new_filename );
+    libspectrum_free( new_buffer );
+
+    return error;
+  }
+
+  metadata->type = type;
+  metadata->class = class;
+
+  switch( class ) {
+
+  case LIBSPECTRUM_CLASS_TAPE:
+    return read_tape( metadata, buffer, length );
+
+  case LIBSPECTRUM_CLASS_SNAPSHOT:
+    return read_snapshot( metadata, buffer, length, filename );
+
+  case LIBSPECTRUM_CLASS_DISK_PLUS3:
+    metadata->machine = LIBSPECTRUM_MACHINE_PLUS3;
+    return LIBSPECTRUM_ERROR_NONE;
+
+  default:
+    return LIBSPECTRUM_ERROR_NONE;
+
+  }
+}
+
+libspectrum_id_t
+libspectrum_metadata_type( libspectrum_metadata *metadata )
+{
+  return metadata->type;
+}
+
+libspectrum_class_t
+libspectrum_metadata_class( libspectrum_metadata *metadata )
+{
+  return metadata->class;
+}
+
+libspectrum_machine
+libspectrum_metadata_machine( libspectrum_metadata *metadata )
+{
+  return metadata->machine;
+}
+
+size_t
+libspectrum_metadata_archive_info_count( libspectrum_metadata *metadata )
+{
+  return metadata->archive_info_count;
+}
+
+int
+libspectrum_metadata_archive_info_id( libspectrum_metadata *metadata,
+                                      size_t idx )
+{
+  return metadata->archive_info_ids[ idx ];
+}
+
+const char*
+libspectrum_metadata_archive_info_string( libspectrum_metadata *metadata,
+                                          size_t idx )
+{
+  return metadata->archive_info_strings[ idx ];
+}
+
+const libspectrum_byte*
+libspectrum_metadata_screen( libspectrum_metadata *metadata )
+{
+  return metadata->have_screen ? metadata->screen : NULL;
+}
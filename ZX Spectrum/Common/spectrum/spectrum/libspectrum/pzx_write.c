@@ -0,0 +1,614 @@
+/* pzx_write.c: Routines for writing .pzx files
+   Copyright (c) 2026 The Fuse authors
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+   Author contact information:
+
+   E-mail: philip-fuse@shadowmagic.org.uk
+
+*/
+
+#include "config.h"
+
+#include <string.h>
+
+#include "internals.h"
+#include "tape_block.h"
+
+/* Archive info IDs and the tags used for them in the PZXT block */
+static const struct {
+
+  int archive_info_id;
+  const char *tag;
+
+} info_tags[] = {
+
+  { 0x01, "Publisher"  },
+  { 0x02, "Author"     },
+  { 0x03, "Year"       },
+  { 0x04, "Language"   },
+  { 0x05, "Type"       },
+  { 0x06, "Price"      },
+  { 0x07, "Protection" },
+  { 0x08, "Origin"     },
+  { 0xff, "Comment"    },
+
+};
+
+/* PULS blocks hold at most this many repeats of one pulse */
+#define PZX_MAX_REPEATS 0x7fff
+
+/*** Local function prototypes ***/
+
+static size_t
+pzx_block_start( const char *id, libspectrum_byte **buffer,
+                 libspectrum_byte **ptr, size_t *length );
+static void
+pzx_block_end( size_t start, libspectrum_byte **buffer,
+               libspectrum_byte **ptr );
+
+static void
+pzx_write_header( libspectrum_tape *tape, libspectrum_byte **buffer,
+                  libspectrum_byte **ptr, size_t *length );
+static void
+pzx_write_pulse( libspectrum_dword duration, size_t count,
+                 libspectrum_byte **buffer, libspectrum_byte **ptr,
+                 size_t *length );
+static void
+pzx_write_data( const libspectrum_byte *data, libspectrum_dword bits,
+                int level, libspectrum_dword tail,
+                libspectrum_dword bit0_length, libspectrum_dword bit1_length,
+                libspectrum_byte **buffer, libspectrum_byte **ptr,
+                size_t *length );
+static void
+pzx_write_pause( libspectrum_dword tstates, int level,
+                 libspectrum_byte **buffer, libspectrum_byte **ptr,
+                 size_t *length );
+static void
+pzx_write_stop( libspectrum_word flags, libspectrum_byte **buffer,
+                libspectrum_byte **ptr, size_t *length );
+static void
+pzx_write_browse( const char *text, libspectrum_byte **buffer,
+                  libspectrum_byte **ptr, size_t *length );
+
+static void
+pzx_write_rom( libspectrum_tape_block *block, libspectrum_byte **buffer,
+               libspectrum_byte **ptr, size_t *length );
+static void
+pzx_write_turbo( libspectrum_tape_block *block, libspectrum_byte **buffer,
+                 libspectrum_byte **ptr, size_t *length );
+static void
+pzx_write_pure_data( libspectrum_tape_block *block, libspectrum_byte **buffer,
+                     libspectrum_byte **ptr, size_t *length );
+static void
+pzx_write_pulses( libspectrum_tape_block *block, libspectrum_byte **buffer,
+                  libspectrum_byte **ptr, size_t *length );
+static void
+pzx_write_pulse_sequence( libspectrum_tape_block *block,
+                          libspectrum_byte **buffer, libspectrum_byte **ptr,
+                          size_t *length );
+static void
+pzx_write_data_block( libspectrum_tape_block *block,
+                      libspectrum_byte **buffer, libspectrum_byte **ptr,
+                      size_t *length );
+static libspectrum_error
+pzx_write_edges( libspectrum_tape *tape, libspectrum_tape_iterator iterator,
+                 libspectrum_byte **buffer, libspectrum_byte **ptr,
+                 size_t *length );
+
+/*** Function definitions ***/
+
+/* The main write function */
+
+libspectrum_error
+internal_pzx_write( libspectrum_byte **buffer, size_t *length,
+                    libspectrum_tape *tape )
+{
+  libspectrum_error error;
+  libspectrum_tape_iterator iterator;
+  libspectrum_tape_block *block;
+  libspectrum_byte *ptr = *buffer;
+  int skipped = 0;
+
+  pzx_write_header( tape, buffer, &ptr, length );
+
+  for( block = libspectrum_tape_iterator_init( &iterator, tape );
+       block;
+       block = libspectrum_tape_iterator_next( &iterator )       )
+  {
+    switch( libspectrum_tape_block_type( block ) ) {
+
+    case LIBSPECTRUM_TAPE_BLOCK_ROM:
+      pzx_write_rom( block, buffer, &ptr, length );
+      break;
+
+    case LIBSPECTRUM_TAPE_BLOCK_TURBO:
+      pzx_write_turbo( block, buffer, &ptr, length );
+      break;
+
+    case LIBSPECTRUM_TAPE_BLOCK_PURE_TONE:
+      pzx_write_pulse( libspectrum_tape_block_pulse_length( block ),
+                       libspectrum_tape_block_count( block ),
+                       buffer, &ptr, length );
+      break;
+
+    case LIBSPECTRUM_TAPE_BLOCK_PULSES:
+      pzx_write_pulses( block, buffer, &ptr, length );
+      break;
+
+    case LIBSPECTRUM_TAPE_BLOCK_PURE_DATA:
+      pzx_write_pure_data( block, buffer, &ptr, length );
+      break;
+
+    case LIBSPECTRUM_TAPE_BLOCK_PULSE_SEQUENCE:
+      pzx_write_pulse_sequence( block, buffer, &ptr, length );
+      break;
+
+    case LIBSPECTRUM_TAPE_BLOCK_DATA_BLOCK:
+      pzx_write_data_block( block, buffer, &ptr, length );
+      break;
+
+    case LIBSPECTRUM_TAPE_BLOCK_PAUSE:
+      /* A zero length pause stops the tape */
+      if( libspectrum_tape_block_pause_tstates( block ) )
+        pzx_write_pause( libspectrum_tape_block_pause_tstates( block ),
+                         libspectrum_tape_block_level( block ) == 1,
+                         buffer, &ptr, length );
+      else
+        pzx_write_stop( 0, buffer, &ptr, length );
+      break;
+
+    case LIBSPECTRUM_TAPE_BLOCK_STOP48:
+      pzx_write_stop( 1, buffer, &ptr, length );
+      break;
+
+    case LIBSPECTRUM_TAPE_BLOCK_GROUP_START:
+    case LIBSPECTRUM_TAPE_BLOCK_COMMENT:
+      pzx_write_browse( libspectrum_tape_block_text( block ), buffer, &ptr,
+                        length );
+      break;
+
+    /* Anything else which makes a sound goes in as its edges */
+    case LIBSPECTRUM_TAPE_BLOCK_RAW_DATA:
+    case LIBSPECTRUM_TAPE_BLOCK_GENERALISED_DATA:
+    case LIBSPECTRUM_TAPE_BLOCK_RLE_PULSE:
+      error = pzx_write_edges( tape, iterator, buffer, &ptr, length );
+      if( error ) { libspectrum_free( *buffer ); return error; }
+      break;
+
+    /* The archive info went into the header, and PZX has nowhere to keep
+       the rest */
+    case LIBSPECTRUM_TAPE_BLOCK_GROUP_END:
+    case LIBSPECTRUM_TAPE_BLOCK_MESSAGE:
+    case LIBSPECTRUM_TAPE_BLOCK_ARCHIVE_INFO:
+    case LIBSPECTRUM_TAPE_BLOCK_HARDWARE:
+    case LIBSPECTRUM_TAPE_BLOCK_CUSTOM:
+    case LIBSPECTRUM_TAPE_BLOCK_CONCAT:
+    case LIBSPECTRUM_TAPE_BLOCK_SET_SIGNAL_LEVEL:
+      break;
+
+    /* PZX files are played straight through */
+    case LIBSPECTRUM_TAPE_BLOCK_JUMP:
+    case LIBSPECTRUM_TAPE_BLOCK_LOOP_START:
+    case LIBSPECTRUM_TAPE_BLOCK_LOOP_END:
+    case LIBSPECTRUM_TAPE_BLOCK_SELECT:
+      skipped = 1;
+      break;
+
+    default:
+      libspectrum_free( *buffer );
+      libspectrum_print_error(
+        LIBSPECTRUM_ERROR_LOGIC,
+	"internal_pzx_write: unknown block type 0x%02x",
+	libspectrum_tape_block_type( block )
+      );
+      return LIBSPECTRUM_ERROR_LOGIC;
+    }
+  }
+
+  if( skipped )
+    libspectrum_print_error(
+      LIBSPECTRUM_ERROR_WARNING,
+      "internal_pzx_write: PZX files can't jump, loop or select; the tape will be played straight through"
+    );
+
+  (*length) = ptr - *buffer;
+
+  return LIBSPECTRUM_ERROR_NONE;
+}
+
+/* Write a block's tag and leave room for its length; returns where the
+   block starts, as the buffer may move while it's being written */
+static size_t
+pzx_block_start( const char *id, libspectrum_byte **buffer,
+                 libspectrum_byte **ptr, size_t *length )
+{
+  size_t start;
+
+  libspectrum_make_room( buffer, 8, ptr, length );
+
+  start = *ptr - *buffer;
+  memcpy( *ptr, id, 4 ); *ptr += 8;
+
+  return start;
+}
+
+static void
+pzx_block_end( size_t start, libspectrum_byte **buffer,
+               libspectrum_byte **ptr )
+{
+  libspectrum_byte *length_ptr = *buffer + start + 4;
+
+  libspectrum_write_dword( &length_ptr, *ptr - *buffer - start - 8 );
+}
+
+static void
+pzx_write_string( const char *string, libspectrum_byte **buffer,
+                  libspectrum_byte **ptr, size_t *length )
+{
+  size_t string_length = string ? strlen( string ) + 1 : 1;
+
+  libspectrum_make_room( buffer, string_length, ptr, length );
+  if( string ) memcpy( *ptr, string, string_length ); else **ptr = '\0';
+  *ptr += string_length;
+}
+
+/* The PZXT block, with the tape's first archive info block if it has one */
+static void
+pzx_write_header( libspectrum_tape *tape, libspectrum_byte **buffer,
+                  libspectrum_byte **ptr, size_t *length )
+{
+  libspectrum_tape_iterator iterator;
+  libspectrum_tape_block *block;
+  size_t start, i, j, count;
+
+  start = pzx_block_start( "PZXT", buffer, ptr, length );
+
+  libspectrum_make_room( buffer, 2, ptr, length );
+  *(*ptr)++ = 1;		/* Major version number */
+  *(*ptr)++ = 0;		/* Minor version number */
+
+  for( block = libspectrum_tape_iterator_init( &iterator, tape );
+       block;
+       block = libspectrum_tape_iterator_next( &iterator )       )
+    if( libspectrum_tape_block_type( block ) ==
+        LIBSPECTRUM_TAPE_BLOCK_ARCHIVE_INFO ) break;
+
+  if( block ) {
+
+    count = libspectrum_tape_block_count( block );
+
+    /* The title always comes first */
+    for( i = 0; i < count; i++ )
+      if( libspectrum_tape_block_ids( block, i ) == 0x00 ) break;
+    pzx_write_string( i < count ? libspectrum_tape_block_texts( block, i ) :
+                                  NULL,
+                      buffer, ptr, length );
+
+    for( i = 0; i < count; i++ ) {
+      for( j = 0; j < ARRAY_SIZE( info_tags ); j++ ) {
+        if( libspectrum_tape_block_ids( block, i ) ==
+            info_tags[j].archive_info_id ) {
+          pzx_write_string( info_tags[j].tag, buffer, ptr, length );
+          pzx_write_string( libspectrum_tape_block_texts( block, i ), buffer,
+                            ptr, length );
+          break;
+        }
+      }
+    }
+
+  }
+
+  pzx_block_end( start, buffer, ptr );
+}
+
+/* Add one pulse, repeated `count' times, to the current PULS block */
+static void
+pzx_add_pulse( libspectrum_dword duration, size_t count,
+               libspectrum_byte **buffer, libspectrum_byte **ptr,
+               size_t *length )
+{
+  while( count ) {
+
+    size_t repeats = count > PZX_MAX_REPEATS ? PZX_MAX_REPEATS : count;
+
+    libspectrum_make_room( buffer, 8, ptr, length );
+
+    /* Long pulses always have a count so their first word isn't taken for
+       one */
+    if( repeats > 1 || duration > 0x7fff )
+      libspectrum_write_word( ptr, 0x8000 | repeats );
+
+    if( duration > 0x7fff ) {
+      libspectrum_write_word( ptr, 0x8000 | ( duration >> 16 ) );
+      libspectrum_write_word( ptr, duration & 0xffff );
+    } else {
+      libspectrum_write_word( ptr, duration );
+    }
+
+    count -= repeats;
+  }
+}
+
+static void
+pzx_write_pulse( libspectrum_dword duration, size_t count,
+                 libspectrum_byte **buffer, libspectrum_byte **ptr,
+                 size_t *length )
+{
+  size_t start;
+
+  if( !count ) return;
+
+  start = pzx_block_start( "PULS", buffer, ptr, length );
+  pzx_add_pulse( duration, count, buffer, ptr, length );
+  pzx_block_end( start, buffer, ptr );
+}
+
+static void
+pzx_write_data( const libspectrum_byte *data, libspectrum_dword bits,
+                int level, libspectrum_dword tail,
+                libspectrum_dword bit0_length, libspectrum_dword bit1_length,
+                libspectrum_byte **buffer, libspectrum_byte **ptr,
+                size_t *length )
+{
+  size_t start, bytes = libspectrum_bits_to_bytes( bits );
+
+  if( !bits ) return;
+
+  start = pzx_block_start( "DATA", buffer, ptr, length );
+
+  libspectrum_make_room( buffer, 16 + bytes, ptr, length );
+
+  libspectrum_write_dword( ptr, bits | ( level ? 0x80000000 : 0 ) );
+  libspectrum_write_word( ptr, tail );
+  *(*ptr)++ = 2;
+  *(*ptr)++ = 2;
+  libspectrum_write_word( ptr, bit0_length );
+  libspectrum_write_word( ptr, bit0_length );
+  libspectrum_write_word( ptr, bit1_length );
+  libspectrum_write_word( ptr, bit1_length );
+  memcpy( *ptr, data, bytes ); *ptr += bytes;
+
+  pzx_block_end( start, buffer, ptr );
+}
+
+static void
+pzx_write_pause( libspectrum_dword tstates, int level,
+                 libspectrum_byte **buffer, libspectrum_byte **ptr,
+                 size_t *length )
+{
+  size_t start;
+
+  if( !tstates ) return;
+
+  start = pzx_block_start( "PAUS", buffer, ptr, length );
+  libspectrum_make_room( buffer, 4, ptr, length );
+  libspectrum_write_dword( ptr, ( tstates & 0x7fffffff ) |
+                                ( level ? 0x80000000 : 0 ) );
+  pzx_block_end( start, buffer, ptr );
+}
+
+static void
+pzx_write_stop( libspectrum_word flags, libspectrum_byte **buffer,
+                libspectrum_byte **ptr, size_t *length )
+{
+  size_t start;
+
+  start = pzx_block_start( "STOP", buffer, ptr, length );
+  libspectrum_make_room( buffer, 2, ptr, length );
+  libspectrum_write_word( ptr, flags );
+  pzx_block_end( start, buffer, ptr );
+}
+
+static void
+pzx_write_browse( const char *text, libspectrum_byte **buffer,
+                  libspectrum_byte **ptr, size_t *length )
+{
+  size_t start;
+
+  start = pzx_block_start( "BRWS", buffer, ptr, length );
+  pzx_write_string( text, buffer, ptr, length );
+  pzx_block_end( start, buffer, ptr );
+}
+
+/* The pilot tone and sync pulses before a block of data */
+static void
+pzx_write_leader( libspectrum_dword pilot_length, size_t pilot_pulses,
+                  libspectrum_dword sync1_length,
+                  libspectrum_dword sync2_length,
+                  libspectrum_byte **buffer, libspectrum_byte **ptr,
+                  size_t *length )
+{
+  size_t start;
+
+  start = pzx_block_start( "PULS", buffer, ptr, length );
+  pzx_add_pulse( pilot_length, pilot_pulses, buffer, ptr, length );
+  pzx_add_pulse( sync1_length, 1, buffer, ptr, length );
+  pzx_add_pulse( sync2_length, 1, buffer, ptr, length );
+  pzx_block_end( start, buffer, ptr );
+}
+
+static libspectrum_dword
+pzx_data_bits( libspectrum_tape_block *block )
+{
+  size_t data_length = libspectrum_tape_block_data_length( block );
+
+  if( !data_length ) return 0;
+
+  return ( data_length - 1 ) * LIBSPECTRUM_BITS_IN_BYTE +
+         libspectrum_tape_block_bits_in_last_byte( block );
+}
+
+static void
+pzx_write_rom( libspectrum_tape_block *block, libspectrum_byte **buffer,
+               libspectrum_byte **ptr, size_t *length )
+{
+  libspectrum_byte *data = libspectrum_tape_block_data( block );
+  size_t data_length = libspectrum_tape_block_data_length( block );
+
+  /* Headers have a longer pilot tone than data blocks */
+  pzx_write_leader( LIBSPECTRUM_TAPE_TIMING_PILOT,
+                    data_length && data[0] & 0x80 ?
+                      LIBSPECTRUM_TAPE_PILOTS_DATA :
+                      LIBSPECTRUM_TAPE_PILOTS_HEADER,
+                    LIBSPECTRUM_TAPE_TIMING_SYNC1,
+                    LIBSPECTRUM_TAPE_TIMING_SYNC2, buffer, ptr, length );
+
+  pzx_write_data( data, data_length * LIBSPECTRUM_BITS_IN_BYTE, 0, 0,
+                  LIBSPECTRUM_TAPE_TIMING_DATA0, LIBSPECTRUM_TAPE_TIMING_DATA1,
+                  buffer, ptr, length );
+
+  pzx_write_pause( libspectrum_tape_block_pause_tstates( block ), 0, buffer,
+                   ptr, length );
+}
+
+static void
+pzx_write_turbo( libspectrum_tape_block *block, libspectrum_byte **buffer,
+                 libspectrum_byte **ptr, size_t *length )
+{
+  pzx_write_leader( libspectrum_tape_block_pilot_length( block ),
+                    libspectrum_tape_block_pilot_pulses( block ),
+                    libspectrum_tape_block_sync1_length( block ),
+                    libspectrum_tape_block_sync2_length( block ),
+                    buffer, ptr, length );
+
+  pzx_write_pure_data( block, buffer, ptr, length );
+}
+
+static void
+pzx_write_pure_data( libspectrum_tape_block *block, libspectrum_byte **buffer,
+                     libspectrum_byte **ptr, size_t *length )
+{
+  pzx_write_data( libspectrum_tape_block_data( block ),
+                  pzx_data_bits( block ), 0, 0,
+                  libspectrum_tape_block_bit0_length( block ),
+                  libspectrum_tape_block_bit1_length( block ),
+                  buffer, ptr, length );
+
+  pzx_write_pause( libspectrum_tape_block_pause_tstates( block ), 0, buffer,
+                   ptr, length );
+}
+
+static void
+pzx_write_pulses( libspectrum_tape_block *block, libspectrum_byte **buffer,
+                  libspectrum_byte **ptr, size_t *length )
+{
+  size_t start, i, count = libspectrum_tape_block_count( block );
+
+  if( !count ) return;
+
+  start = pzx_block_start( "PULS", buffer, ptr, length );
+  for( i = 0; i < count; i++ )
+    pzx_add_pulse( libspectrum_tape_block_pulse_lengths( block, i ), 1,
+                   buffer, ptr, length );
+  pzx_block_end( start, buffer, ptr );
+}
+
+static void
+pzx_write_pulse_sequence( libspectrum_tape_block *block,
+                          libspectrum_byte **buffer, libspectrum_byte **ptr,
+                          size_t *length )
+{
+  size_t start, i, count = libspectrum_tape_block_count( block );
+
+  if( !count ) return;
+
+  start = pzx_block_start( "PULS", buffer, ptr, length );
+  for( i = 0; i < count; i++ )
+    pzx_add_pulse( libspectrum_tape_block_pulse_lengths( block, i ),
+                   libspectrum_tape_block_pulse_repeats( block, i ),
+                   buffer, ptr, length );
+  pzx_block_end( start, buffer, ptr );
+}
+
+static void
+pzx_write_data_block( libspectrum_tape_block *block,
+                      libspectrum_byte **buffer, libspectrum_byte **ptr,
+                      size_t *length )
+{
+  size_t start, i;
+  size_t bit0_count = libspectrum_tape_block_bit0_pulse_count( block );
+  size_t bit1_count = libspectrum_tape_block_bit1_pulse_count( block );
+  size_t bytes = libspectrum_tape_block_data_length( block );
+
+  start = pzx_block_start( "DATA", buffer, ptr, length );
+
+  libspectrum_make_room( buffer, 8 + 2 * ( bit0_count + bit1_count ) + bytes,
+                         ptr, length );
+
+  libspectrum_write_dword( ptr, libspectrum_tape_block_count( block ) |
+                           ( libspectrum_tape_block_level( block ) == 1 ?
+                             0x80000000 : 0 ) );
+  libspectrum_write_word( ptr, libspectrum_tape_block_tail_length( block ) );
+  *(*ptr)++ = bit0_count;
+  *(*ptr)++ = bit1_count;
+  for( i = 0; i < bit0_count; i++ )
+    libspectrum_write_word( ptr, libspectrum_tape_block_bit0_pulses( block,
+                                                                     i ) );
+  for( i = 0; i < bit1_count; i++ )
+    libspectrum_write_word( ptr, libspectrum_tape_block_bit1_pulses( block,
+                                                                     i ) );
+  memcpy( *ptr, libspectrum_tape_block_data( block ), bytes ); *ptr += bytes;
+
+  pzx_block_end( start, buffer, ptr );
+}
+
+/* Play through a block which has no PZX equivalent and write out the
+   pulses it makes */
+static libspectrum_error
+pzx_write_edges( libspectrum_tape *tape, libspectrum_tape_iterator iterator,
+                 libspectrum_byte **buffer, libspectrum_byte **ptr,
+                 size_t *length )
+{
+  libspectrum_error error;
+  libspectrum_tape_block_state it;
+  libspectrum_dword pulse_tstates, pulse = 0, last_pulse = 0;
+  size_t start, repeats = 0;
+  int flags = 0;
+
+  it.current_block = iterator;
+  error = libspectrum_tape_block_init( iterator->data, &it );
+  if( error ) return error;
+
+  start = pzx_block_start( "PULS", buffer, ptr, length );
+
+  while( !( flags & LIBSPECTRUM_TAPE_FLAGS_BLOCK ) ) {
+
+    /* Use the internal version so the tape's own position isn't moved */
+    error = libspectrum_tape_get_next_edge_internal( &pulse_tstates, &flags,
+                                                     tape, &it );
+    if( error ) return error;
+
+    pulse += pulse_tstates;
+    if( flags & LIBSPECTRUM_TAPE_FLAGS_NO_EDGE ) continue;
+
+    if( repeats && pulse == last_pulse ) {
+      repeats++;
+    } else {
+      pzx_add_pulse( last_pulse, repeats, buffer, ptr, length );
+      last_pulse = pulse; repeats = 1;
+    }
+    pulse = 0;
+  }
+
+  pzx_add_pulse( last_pulse, repeats, buffer, ptr, length );
+
+  /* Nothing was written if the block made no edges */
+  if( *ptr - *buffer == start + 8 ) *ptr -= 8;
+  else pzx_block_end( start, buffer, ptr );
+
+  return LIBSPECTRUM_ERROR_NONE;
+}
@@ -613,6 +613,63 @@ libspectrum_rzx_playback( libspectrum_rzx *rzx, libspectrum_byte *byte )
   return LIBSPECTRUM_ERROR_NONE;
 }
 
+libspectrum_error
+libspectrum_rzx_playback_position( libspectrum_rzx *rzx, int *which,
+				   size_t *frame )
+{
+  GSList *list;
+  rzx_block_t *block;
+  int i;
+
+  if( !rzx->current_block ) {
+    libspectrum_print_error(
+      LIBSPECTRUM_ERROR_INVALID,
+      "libspectrum_rzx_playback_position: playback not in progress"
+    );
+    return LIBSPECTRUM_ERROR_INVALID;
+  }
+
+  for( i = 0, list = rzx->blocks; list != rzx->current_block;
+       list = list->next ) {
+    block = list->data;
+    if( block->type == LIBSPECTRUM_RZX_INPUT_BLOCK ) i++;
+  }
+
+  *which = i;
+  *frame = rzx->current_frame;
+
+  return LIBSPECTRUM_ERROR_NONE;
+}
+
+libspectrum_error
+libspectrum_rzx_playback_seek( libspectrum_rzx *rzx, int which, size_t frame )
+{
+  libspectrum_snap *snap;
+  libspectrum_error error;
+  size_t i;
+
+  error = libspectrum_rzx_start_playback( rzx, which, &snap );
+  if( error ) return error;
+
+  if( frame >= rzx->current_input->count ) {
+    libspectrum_print_error(
+      LIBSPECTRUM_ERROR_INVALID,
+      "libspectrum_rzx_playback_seek: input recording block %d has only %lu frames",
+      which, (unsigned long)rzx->current_input->count
+    );
+    return LIBSPECTRUM_ERROR_INVALID;
+  }
+
+  rzx->current_frame = frame;
+
+  /* A repeated frame takes its data from the last one which wasn't */
+  for( i = frame; i && rzx->current_input->frames[ i ].repeat_last; i-- )
+    ;
+  rzx->data_frame = &rzx->current_input->frames[ i ];
+
+  return LIBSPECTRUM_ERROR_NONE;
+}
+
 libspectrum_error
 libspectrum_rzx_free( libspectrum_rzx *rzx )
 {
@@ -1215,6 +1272,11 @@ rzx_read_sign_end( libspectrum_rzx *rzx, const libspectrum_byte **ptr,
   { 
     gcry_error_t error; size_t mpi_length;
 
+    if( libspectrum_gcrypt_init() ) {
+      libspectrum_free( block );
+      return LIBSPECTRUM_ERROR_LOGIC;
+    }
+
     error = gcry_mpi_scan( &signature->r, GCRYMPI_FMT_PGP, *ptr, length,
 			   &mpi_length );
     if( error ) {
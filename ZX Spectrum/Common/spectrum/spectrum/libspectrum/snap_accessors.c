@@ -57,6 +57,10 @@ struct libspectrum_snap {
 
   libspectrum_byte *pages[ SNAPSHOT_RAM_PAGES ];
 
+  /* Memory owned by the caller for the RAM pages to live in */
+  libspectrum_byte *page_buffer;
+  size_t page_buffer_pages;
+
   /* Data from .slt files */
 
   libspectrum_byte *slt[ SNAPSHOT_SLT_PAGES ];	/* Level data */
@@ -1267,6 +1271,30 @@ libspectrum_snap_set_pages( libspectrum_snap *snap, int idx, libspectrum_byte* p
   snap->pages[idx] = pages;
 }
 
+libspectrum_byte*
+libspectrum_snap_page_buffer( libspectrum_snap *snap )
+{
+  return snap->page_buffer;
+}
+
+void
+libspectrum_snap_set_page_buffer( libspectrum_snap *snap, libspectrum_byte* page_buffer )
+{
+  snap->page_buffer = page_buffer;
+}
+
+size_t
+libspectrum_snap_page_buffer_pages( libspectrum_snap *snap )
+{
+  return snap->page_buffer_pages;
+}
+
+void
+libspectrum_snap_set_page_buffer_pages( libspectrum_snap *snap, size_t page_buffer_pages )
+{
+  snap->page_buffer_pages = page_buffer_pages;
+}
+
 libspectrum_byte*
 libspectrum_snap_slt( libspectrum_snap *snap, int idx )
 {
@@ -81,6 +81,8 @@ libspectrum_snap_alloc( void )
 
   for( i = 0; i < SNAPSHOT_RAM_PAGES; i++ )
     libspectrum_snap_set_pages( snap, i, NULL );
+  libspectrum_snap_set_page_buffer( snap, NULL );
+  libspectrum_snap_set_page_buffer_pages( snap, 0 );
   for( i = 0; i < SNAPSHOT_SLT_PAGES; i++ ) {
     libspectrum_snap_set_slt( snap, i, NULL );
     libspectrum_snap_set_slt_length( snap, i, 0 );
@@ -259,6 +261,19 @@ libspectrum_snap_alloc( void )
   return snap;
 }
 
+/* The caller-owned buffer for a RAM page, or NULL if there isn't one */
+libspectrum_byte*
+libspectrum_snap_page_buffer_page( libspectrum_snap *snap, int page )
+{
+  libspectrum_byte *buffer = libspectrum_snap_page_buffer( snap );
+
+  if( !buffer || page < 0 ||
+      (size_t)page >= libspectrum_snap_page_buffer_pages( snap ) )
+    return NULL;
+
+  return buffer + page * 0x4000;
+}
+
 /* Free all memory used by a libspectrum_snap structure (destructor...) */
 libspectrum_error
 libspectrum_snap_free( libspectrum_snap *snap )
@@ -269,7 +284,9 @@ libspectrum_snap_free( libspectrum_snap *snap )
     libspectrum_free( libspectrum_snap_roms( snap, i ) );
 
   for( i = 0; i < SNAPSHOT_RAM_PAGES; i++ )
-    libspectrum_free( libspectrum_snap_pages( snap, i ) );
+    if( libspectrum_snap_pages( snap, i ) !=
+        libspectrum_snap_page_buffer_page( snap, i ) )
+      libspectrum_free( libspectrum_snap_pages( snap, i ) );
 
   for( i = 0; i < SNAPSHOT_SLT_PAGES; i++ )
     libspectrum_free( libspectrum_snap_slt( snap, i ) );
@@ -29,10 +29,22 @@
 
 /* Used for passing internal data around */
 
+/* A RAMP chunk seen while reading; the pages are only decompressed once the
+   whole file has been read, so they can be done in parallel */
+typedef struct szx_ram_page {
+
+  const libspectrum_byte *data;
+  size_t length;
+  libspectrum_word flags;
+
+} szx_ram_page;
+
 typedef struct szx_context {
 
   int swap_af;
 
+  szx_ram_page ram_pages[ 64 ];
+
 } szx_context;
 
 /* The machine numbers used in the .szx format */
@@ -254,13 +266,20 @@ static libspectrum_error
 write_ram_pages( libspectrum_byte **buffer, libspectrum_byte **ptr,
 		 size_t *length, libspectrum_snap *snap, int compress );
 static libspectrum_error
-write_ramp_chunk( libspectrum_byte **buffer, libspectrum_byte **ptr,
-		  size_t *length, libspectrum_snap *snap, int page,
-		  int compress );
+write_ramp_chunks( libspectrum_byte **buffer, libspectrum_byte **ptr,
+		   size_t *length, libspectrum_snap *snap, const int *pages,
+		   size_t count, int compress );
 static libspectrum_error
 write_ram_page( libspectrum_byte **buffer, libspectrum_byte **ptr,
 		size_t *length, const char *id, const libspectrum_byte *data,
 		size_t data_length, int page, int compress, int extra_flags );
+static void
+write_compressed_ram_page( libspectrum_byte **buffer, libspectrum_byte **ptr,
+			   size_t *length, const char *id,
+			   const libspectrum_byte *data, size_t data_length,
+			   const libspectrum_byte *compressed_data,
+			   size_t compressed_length, int page, int compress,
+			   int extra_flags );
 static libspectrum_error
 write_rom_chunk( libspectrum_byte **buffer, libspectrum_byte **ptr,
 		 size_t *length, int *out_flags, libspectrum_snap *snap,
@@ -1252,33 +1271,114 @@ read_amxm_chunk( libspectrum_snap *snap, libspectrum_word version,
 }
 
 static libspectrum_error
-read_ramp_chunk( libspectrum_snap *snap, libspectrum_word version GCC_UNUSED,
+read_ramp_chunk( libspectrum_snap *snap GCC_UNUSED,
+		 libspectrum_word version GCC_UNUSED,
 		 const libspectrum_byte **buffer,
 		 const libspectrum_byte *end GCC_UNUSED, size_t data_length,
-                 szx_context *ctx GCC_UNUSED )
+                 szx_context *ctx )
 {
-  libspectrum_byte *data;
   size_t page;
-  libspectrum_error error;
   libspectrum_word flags;
 
+  if( data_length < 3 ) {
+    libspectrum_print_error( LIBSPECTRUM_ERROR_UNKNOWN,
+			     "%s:read_ramp_chunk: length %lu too short",
+			     __FILE__, (unsigned long)data_length );
+    return LIBSPECTRUM_ERROR_UNKNOWN;
+  }
 
-  error = read_ram_page( &data, &page, buffer, data_length, 0x4000, &flags );
-  if( error ) return error;
+  flags = libspectrum_read_word( buffer );
+
+  page = **buffer; (*buffer)++;
 
   if( page > 63 ) {
     libspectrum_print_error( LIBSPECTRUM_ERROR_CORRUPT,
 			     "%s:read_ramp_chunk: unknown page number %lu",
 			     __FILE__, (unsigned long)page );
-    libspectrum_free( data );
     return LIBSPECTRUM_ERROR_CORRUPT;
   }
 
-  libspectrum_snap_set_pages( snap, page, data );
+  if( flags & ZXSTRF_COMPRESSED ) {
+
+#ifndef HAVE_ZLIB_H
+
+    libspectrum_print_error(
+      LIBSPECTRUM_ERROR_UNKNOWN,
+      "%s:read_ramp_chunk: zlib needed for decompression\n",
+      __FILE__
+    );
+    return LIBSPECTRUM_ERROR_UNKNOWN;
+
+#endif			/* #ifndef HAVE_ZLIB_H */
+
+    ctx->ram_pages[ page ].length = data_length - 3;
+
+  } else {
+
+    if( data_length < 3 + 0x4000 ) {
+      libspectrum_print_error( LIBSPECTRUM_ERROR_UNKNOWN,
+			       "%s:read_ramp_chunk: length %lu too short",
+			       __FILE__, (unsigned long)data_length );
+      return LIBSPECTRUM_ERROR_UNKNOWN;
+    }
+
+    ctx->ram_pages[ page ].length = 0x4000;
+
+  }
+
+  ctx->ram_pages[ page ].data = *buffer;
+  ctx->ram_pages[ page ].flags = flags;
+
+  *buffer += ctx->ram_pages[ page ].length;
 
   return LIBSPECTRUM_ERROR_NONE;
 }
 
+/* Put the RAM pages from the RAMP chunks into the snap, straight into the
+   snap's page buffer if it has one */
+static libspectrum_error
+read_ram_pages( libspectrum_snap *snap, szx_context *ctx )
+{
+  libspectrum_byte *data;
+  size_t i;
+
+#ifdef HAVE_ZLIB_H
+  libspectrum_zlib_page zpages[ 64 ];
+  size_t count = 0;
+#endif			/* #ifdef HAVE_ZLIB_H */
+
+  for( i = 0; i < 64; i++ ) {
+
+    szx_ram_page *page = &ctx->ram_pages[i];
+
+    if( !page->data ) continue;
+
+    data = libspectrum_snap_page_buffer_page( snap, i );
+    if( !data ) data = libspectrum_new( libspectrum_byte, 0x4000 );
+
+    libspectrum_snap_set_pages( snap, i, data );
+
+#ifdef HAVE_ZLIB_H
+    if( page->flags & ZXSTRF_COMPRESSED ) {
+      zpages[ count ].data = page->data;
+      zpages[ count ].length = page->length;
+      zpages[ count ].output = data;
+      zpages[ count ].output_length = 0x4000;
+      count++;
+      continue;
+    }
+#endif			/* #ifdef HAVE_ZLIB_H */
+
+    memcpy( data, page->data, 0x4000 );
+  }
+
+#ifdef HAVE_ZLIB_H
+  return libspectrum_zlib_inflate_pages( zpages, count );
+#else			/* #ifdef HAVE_ZLIB_H */
+  return LIBSPECTRUM_ERROR_NONE;
+#endif			/* #ifdef HAVE_ZLIB_H */
+}
+
 static libspectrum_error
 read_scld_chunk( libspectrum_snap *snap, libspectrum_word version GCC_UNUSED,
 		 const libspectrum_byte **buffer,
@@ -2277,9 +2377,11 @@ read_chunk( libspectrum_snap *snap, libspectrum_word version,
   return LIBSPECTRUM_ERROR_NONE;
 }
 
-libspectrum_error
-libspectrum_szx_read( libspectrum_snap *snap, const libspectrum_byte *buffer,
-		      size_t length )
+/* Read the header and every chunk, leaving the RAM pages in `ctx' */
+static libspectrum_error
+read_header_and_chunks( libspectrum_snap *snap,
+			const libspectrum_byte *buffer, size_t length,
+			szx_context *ctx )
 {
   libspectrum_word version;
   libspectrum_byte machine;
@@ -2287,7 +2389,6 @@ libspectrum_szx_read( libspectrum_snap *snap, const libspectrum_byte *buffer,
 
   libspectrum_error error;
   const libspectrum_byte *end = buffer + length;
-  szx_context *ctx;
 
   if( end - buffer < 8 ) {
     libspectrum_print_error(
@@ -2403,19 +2504,81 @@ libspectrum_szx_read( libspectrum_snap *snap, const libspectrum_byte *buffer,
     break;
   }
 
-  ctx = libspectrum_new( szx_context, 1 );
-  ctx->swap_af = 0;
-
   while( buffer < end ) {
     error = read_chunk( snap, version, &buffer, end, ctx );
-    if( error ) {
-      libspectrum_free( ctx );
-      return error;
+    if( error ) return error;
+  }
+
+  return LIBSPECTRUM_ERROR_NONE;
+}
+
+libspectrum_error
+libspectrum_szx_read( libspectrum_snap *snap, const libspectrum_byte *buffer,
+		      size_t length )
+{
+  libspectrum_error error;
+  szx_context *ctx;
+
+  ctx = libspectrum_new0( szx_context, 1 );
+  ctx->swap_af = 0;
+
+  error = read_header_and_chunks( snap, buffer, length, ctx );
+  if( !error ) error = read_ram_pages( snap, ctx );
+
+  libspectrum_free( ctx );
+  return error;
+}
+
+/* As libspectrum_szx_read(), but only RAM page 5 is decompressed, and then
+   just into `screen' rather than the snap */
+libspectrum_error
+internal_szx_read_metadata( libspectrum_snap *snap,
+			    const libspectrum_byte *buffer, size_t length,
+			    libspectrum_byte *screen, int *have_screen )
+{
+  libspectrum_error error;
+  szx_context *ctx;
+  szx_ram_page *page;
+
+  *have_screen = 0;
+
+  ctx = libspectrum_new0( szx_context, 1 );
+  ctx->swap_af = 0;
+
+  error = read_header_and_chunks( snap, buffer, length, ctx );
+  if( error ) {
+    libspectrum_free( ctx );
+    return error;
+  }
+
+  page = &ctx->ram_pages[5];
+
+  if( page->data && !( page->flags & ZXSTRF_COMPRESSED ) ) {
+    memcpy( screen, page->data, LIBSPECTRUM_METADATA_SCREEN_LENGTH );
+    *have_screen = 1;
+  }
+
+#ifdef HAVE_ZLIB_H
+  if( page->data && ( page->flags & ZXSTRF_COMPRESSED ) ) {
+    libspectrum_zlib_page zpage;
+
+    zpage.data = page->data;
+    zpage.length = page->length;
+    zpage.output = libspectrum_new( libspectrum_byte, 0x4000 );
+    zpage.output_length = 0x4000;
+
+    error = libspectrum_zlib_inflate_pages( &zpage, 1 );
+    if( !error ) {
+      memcpy( screen, zpage.output, LIBSPECTRUM_METADATA_SCREEN_LENGTH );
+      *have_screen = 1;
     }
+
+    libspectrum_free( zpage.output );
   }
+#endif			/* #ifdef HAVE_ZLIB_H */
 
   libspectrum_free( ctx );
-  return LIBSPECTRUM_ERROR_NONE;
+  return error;
 }
 
 libspectrum_error
@@ -3028,75 +3191,110 @@ write_ram_pages( libspectrum_byte **buffer, libspectrum_byte **ptr,
 {
   libspectrum_machine machine;
   int i, capabilities; 
-  libspectrum_error error;
+  int pages[ 64 ];
+  size_t count = 0;
 
   machine = libspectrum_snap_machine( snap );
   capabilities = libspectrum_machine_capabilities( machine );
 
-  error = write_ramp_chunk( buffer, ptr, length, snap, 5, compress );
-  if( error ) return error;
+  pages[ count++ ] = 5;
 
   if( machine != LIBSPECTRUM_MACHINE_16 ) {
-    error = write_ramp_chunk( buffer, ptr, length, snap, 2, compress );
-    if( error ) return error;
-    error = write_ramp_chunk( buffer, ptr, length, snap, 0, compress );
-    if( error ) return error;
+    pages[ count++ ] = 2;
+    pages[ count++ ] = 0;
   }
 
   if( capabilities & LIBSPECTRUM_MACHINE_CAPABILITY_128_MEMORY ) {
-    error = write_ramp_chunk( buffer, ptr, length, snap, 1, compress );
-    if( error ) return error;
-    error = write_ramp_chunk( buffer, ptr, length, snap, 3, compress );
-    if( error ) return error;
-    error = write_ramp_chunk( buffer, ptr, length, snap, 4, compress );
-    if( error ) return error;
-    error = write_ramp_chunk( buffer, ptr, length, snap, 6, compress );
-    if( error ) return error;
-    error = write_ramp_chunk( buffer, ptr, length, snap, 7, compress );
-    if( error ) return error;
+    pages[ count++ ] = 1;
+    pages[ count++ ] = 3;
+    pages[ count++ ] = 4;
+    pages[ count++ ] = 6;
+    pages[ count++ ] = 7;
 
     if( capabilities & LIBSPECTRUM_MACHINE_CAPABILITY_SCORP_MEMORY ) {
-      for( i = 8; i < 16; i++ ) {
-        error = write_ramp_chunk( buffer, ptr, length, snap, i, compress );
-        if( error ) return error;
-      }
+      for( i = 8; i < 16; i++ ) pages[ count++ ] = i;
     } else if( capabilities & LIBSPECTRUM_MACHINE_CAPABILITY_PENT512_MEMORY ) {
-      for( i = 8; i < 32; i++ ) {
-        error = write_ramp_chunk( buffer, ptr, length, snap, i, compress );
-        if( error ) return error;
-      }
+      for( i = 8; i < 32; i++ ) pages[ count++ ] = i;
 
       if( capabilities & LIBSPECTRUM_MACHINE_CAPABILITY_PENT1024_MEMORY ) {
-	for( i = 32; i < 64; i++ ) {
-	  error = write_ramp_chunk( buffer, ptr, length, snap, i, compress );
-	  if( error ) return error;
-	}
+	for( i = 32; i < 64; i++ ) pages[ count++ ] = i;
       }
     }
 
   }
 
-  if( capabilities & LIBSPECTRUM_MACHINE_CAPABILITY_SE_MEMORY ) {
-    error = write_ramp_chunk( buffer, ptr, length, snap, 8, compress );
-    if( error ) return error;
-  }
+  if( capabilities & LIBSPECTRUM_MACHINE_CAPABILITY_SE_MEMORY )
+    pages[ count++ ] = 8;
 
-  return LIBSPECTRUM_ERROR_NONE;
+  return write_ramp_chunks( buffer, ptr, length, snap, pages, count,
+			    compress );
 }
 
+/* Write all the RAMP chunks at once so the pages can be compressed in
+   parallel and the buffer grown just once */
 static libspectrum_error
-write_ramp_chunk( libspectrum_byte **buffer, libspectrum_byte **ptr,
-		  size_t *length, libspectrum_snap *snap, int page,
-		  int compress )
+write_ramp_chunks( libspectrum_byte **buffer, libspectrum_byte **ptr,
+		   size_t *length, libspectrum_snap *snap, const int *pages,
+		   size_t count, int compress )
 {
+  const libspectrum_byte *data[ 64 ];
+  libspectrum_byte *compressed_data[ 64 ];
+  size_t compressed_length[ 64 ];
+  size_t i, room;
+
+#ifdef HAVE_ZLIB_H
+  libspectrum_zlib_page zpages[ 64 ];
+  size_t zcount = 0;
   libspectrum_error error;
-  const libspectrum_byte *data;
+#endif				/* #ifdef HAVE_ZLIB_H */
 
-  data = libspectrum_snap_pages( snap, page );
+  for( i = 0; i < count; i++ ) {
+    data[i] = libspectrum_snap_pages( snap, pages[i] );
+    compressed_data[i] = NULL; compressed_length[i] = 0;
+  }
 
-  error = write_ram_page( buffer, ptr, length, ZXSTBID_RAMPAGE, data, 0x4000,
-			  page, compress, 0x00 );
-  if( error ) return error;
+#ifdef HAVE_ZLIB_H
+
+  if( compress ) {
+
+    for( i = 0; i < count; i++ ) {
+      if( !data[i] ) continue;
+      zpages[ zcount ].data = data[i];
+      zpages[ zcount ].length = 0x4000;
+      zpages[ zcount ].output = NULL;
+      zcount++;
+    }
+
+    error = libspectrum_zlib_compress_pages( zpages, zcount );
+    if( error ) {
+      for( i = 0; i < zcount; i++ ) libspectrum_free( zpages[i].output );
+      return error;
+    }
+
+    for( i = 0, zcount = 0; i < count; i++ ) {
+      if( !data[i] ) continue;
+      compressed_data[i] = zpages[ zcount ].output;
+      compressed_length[i] = zpages[ zcount ].output_length;
+      zcount++;
+    }
+  }
+
+#endif				/* #ifdef HAVE_ZLIB_H */
+
+  /* 8 for each chunk header, 3 for the flags and the page number; this is
+     slightly more than we need if any page was compressed */
+  for( i = 0, room = 0; i < count; i++ )
+    if( data[i] ) room += 8 + 3 + 0x4000;
+  libspectrum_make_room( buffer, room, ptr, length );
+
+  for( i = 0; i < count; i++ ) {
+    if( !data[i] ) continue;
+    write_compressed_ram_page( buffer, ptr, length, ZXSTBID_RAMPAGE, data[i],
+			       0x4000, compressed_data[i],
+			       compressed_length[i], pages[i], compress,
+			       0x00 );
+    libspectrum_free( compressed_data[i] );
+  }
 
   return LIBSPECTRUM_ERROR_NONE;
 }
@@ -3109,11 +3307,45 @@ write_ram_page( libspectrum_byte **buffer, libspectrum_byte **ptr,
 #ifdef HAVE_ZLIB_H
   libspectrum_error error;
 #endif
-  libspectrum_byte *block_length, *flags, *compressed_data;
-  int use_compression;
+  libspectrum_byte *compressed_data;
+  size_t compressed_length;
 
   if( !data ) return LIBSPECTRUM_ERROR_NONE;
 
+  compressed_data = NULL;
+  compressed_length = 0;
+
+#ifdef HAVE_ZLIB_H
+
+  if( compress ) {
+    error = libspectrum_zlib_compress( data, data_length,
+				       &compressed_data, &compressed_length );
+    if( error ) return error;
+  }
+
+#endif				/* #ifdef HAVE_ZLIB_H */
+
+  write_compressed_ram_page( buffer, ptr, length, id, data, data_length,
+			     compressed_data, compressed_length, page,
+			     compress, extra_flags );
+
+  if( compressed_data ) libspectrum_free( compressed_data );
+
+  return LIBSPECTRUM_ERROR_NONE;
+}
+
+/* Write a page given its raw data and, if we have it, its compressed form,
+   using whichever is appropriate */
+static void
+write_compressed_ram_page( libspectrum_byte **buffer, libspectrum_byte **ptr,
+			   size_t *length, const char *id,
+			   const libspectrum_byte *data, size_t data_length,
+			   const libspectrum_byte *compressed_data,
+			   size_t compressed_length, int page, int compress,
+			   int extra_flags )
+{
+  libspectrum_byte *block_length, *flags;
+
   /* 8 for the chunk header, 3 for the flags and the page number */
   libspectrum_make_room( buffer, 8 + 3, ptr, length );
 
@@ -3127,41 +3359,20 @@ write_ram_page( libspectrum_byte **buffer, libspectrum_byte **ptr,
 
   *(*ptr)++ = (libspectrum_byte)page;
 
-  use_compression = 0;
-  compressed_data = NULL;
-
-#ifdef HAVE_ZLIB_H
-
-  if( compress ) {
-
-    size_t compressed_length;
-
-    error = libspectrum_zlib_compress( data, data_length,
-				       &compressed_data, &compressed_length );
-    if( error ) return error;
-
-    if( compress & LIBSPECTRUM_FLAG_SNAPSHOT_ALWAYS_COMPRESS ||
-        compressed_length < data_length ) {
-      use_compression = 1;
-      data = compressed_data;
-      data_length = compressed_length;
-    }
+  if( compressed_data &&
+      ( compress & LIBSPECTRUM_FLAG_SNAPSHOT_ALWAYS_COMPRESS ||
+        compressed_length < data_length ) ) {
+    extra_flags |= ZXSTRF_COMPRESSED;
+    data = compressed_data;
+    data_length = compressed_length;
   }
 
-#endif				/* #ifdef HAVE_ZLIB_H */
-
-  if( use_compression ) extra_flags |= ZXSTRF_COMPRESSED;
-
   libspectrum_write_dword( &block_length, 3 + data_length );
   libspectrum_write_word( &flags, extra_flags );
 
   libspectrum_make_room( buffer, data_length, ptr, length );
 
   memcpy( *ptr, data, data_length ); *ptr += data_length;
-
-  if( compressed_data ) libspectrum_free( compressed_data );
-
-  return LIBSPECTRUM_ERROR_NONE;
 }
 
 static libspectrum_error
@@ -291,6 +291,9 @@ libspectrum_tape_write( libspectrum_byte **buffer, size_t *length,
   case LIBSPECTRUM_ID_TAPE_TZX:
     return internal_tzx_write( buffer, length, tape );
 
+  case LIBSPECTRUM_ID_TAPE_PZX:
+    return internal_pzx_write( buffer, length, tape );
+
   case LIBSPECTRUM_ID_TAPE_CSW:
     return libspectrum_csw_write( buffer, length, tape );
 
@@ -302,6 +305,56 @@ libspectrum_tape_write( libspectrum_byte **buffer, size_t *length,
   }
 }
 
+libspectrum_error
+libspectrum_tape_block_write( libspectrum_byte **buffer, size_t *length,
+			      libspectrum_tape_block *block,
+			      libspectrum_id_t type )
+{
+  libspectrum_tape *tape;
+  libspectrum_byte *header = NULL; size_t header_length = 0;
+  libspectrum_error error;
+
+  switch( type ) {
+
+  case LIBSPECTRUM_ID_TAPE_TAP:
+  case LIBSPECTRUM_ID_TAPE_SPC:
+  case LIBSPECTRUM_ID_TAPE_STA:
+  case LIBSPECTRUM_ID_TAPE_LTP:
+  case LIBSPECTRUM_ID_TAPE_TZX:
+  case LIBSPECTRUM_ID_TAPE_PZX:
+    break;
+
+  default:
+    libspectrum_print_error(
+      LIBSPECTRUM_ERROR_UNKNOWN,
+      "libspectrum_tape_block_write: format can't be written a block at a time"
+    );
+    return LIBSPECTRUM_ERROR_UNKNOWN;
+
+  }
+
+  tape = libspectrum_tape_alloc();
+
+  error = libspectrum_tape_write( &header, &header_length, tape, type );
+  if( error ) { libspectrum_tape_free( tape ); return error; }
+  libspectrum_free( header );
+
+  libspectrum_tape_append_block( tape, block );
+
+  error = libspectrum_tape_write( buffer, length, tape, type );
+
+  /* The block still belongs to the caller */
+  g_slist_free( tape->blocks ); tape->blocks = NULL;
+  libspectrum_tape_free( tape );
+
+  if( error ) return error;
+
+  *length -= header_length;
+  memmove( *buffer, *buffer + header_length, *length );
+
+  return LIBSPECTRUM_ERROR_NONE;
+}
+
 /* Does this tape structure actually contain a tape? */
 int
 libspectrum_tape_present( const libspectrum_tape *tape )
@@ -1062,14 +1115,42 @@ jump_blocks( libspectrum_tape *tape, int offset )
 
 /* Extra, non-TZX, blocks which can be handled as if TZX */
 
+/* Get one byte of an RLE pulse block, inflating it if need be */
+libspectrum_error
+libspectrum_tape_rle_pulse_byte( libspectrum_tape_rle_pulse_block *block,
+                                 size_t offset, libspectrum_byte *byte )
+{
+  if( block->data ) {
+    *byte = block->data[ offset ];
+    return LIBSPECTRUM_ERROR_NONE;
+  }
+
+#ifdef HAVE_ZLIB_H
+  if( block->stream )
+    return libspectrum_zlib_stream_byte( block->stream, offset, byte );
+#endif
+
+  libspectrum_print_error( LIBSPECTRUM_ERROR_LOGIC,
+                           "libspectrum_tape_rle_pulse_byte: block has no data" );
+  return LIBSPECTRUM_ERROR_LOGIC;
+}
+
 static libspectrum_error
 rle_pulse_edge( libspectrum_tape_rle_pulse_block *block,
                 libspectrum_tape_rle_pulse_block_state *state,
 		libspectrum_dword *tstates, int *end_of_block )
 {
-  if( block->data[state->index] ) {
+  libspectrum_byte bytes[5];
+  libspectrum_error error;
+  int i;
 
-    *tstates = block->scale * block->data[ state->index++ ];
+  error = libspectrum_tape_rle_pulse_byte( block, state->index, &bytes[0] );
+  if( error ) return error;
+
+  if( bytes[0] ) {
+
+    *tstates = block->scale * bytes[0];
+    state->index++;
 
   } else {
 
@@ -1079,10 +1160,16 @@ rle_pulse_edge( libspectrum_tape_rle_pulse_block *block,
       return LIBSPECTRUM_ERROR_LOGIC;
     }
 
-    *tstates = block->scale * ( block->data[ state->index + 1 ]       |
-			        block->data[ state->index + 2 ] << 8  |
-			        block->data[ state->index + 3 ] << 16 |
-			        block->data[ state->index + 4 ] << 24   );
+    for( i = 1; i < 5; i++ ) {
+      error = libspectrum_tape_rle_pulse_byte( block, state->index + i,
+                                               &bytes[i] );
+      if( error ) return error;
+    }
+
+    *tstates = block->scale * ( bytes[1]       |
+			        bytes[2] << 8  |
+			        bytes[3] << 16 |
+			        bytes[4] << 24   );
     state->index += 5;
 
   }
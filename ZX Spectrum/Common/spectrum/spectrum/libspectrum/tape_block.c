@@ -34,8 +34,8 @@
    pilot pulse, which gives a difference of one in both cases. The
    further difference of 4 in the header count is just a screw-up in
    the .tzx specification AFAICT */
-static const size_t LIBSPECTRUM_TAPE_PILOTS_HEADER = 0x1f7f;
-static const size_t LIBSPECTRUM_TAPE_PILOTS_DATA   = 0x0c97;
+const size_t LIBSPECTRUM_TAPE_PILOTS_HEADER = 0x1f7f;
+const size_t LIBSPECTRUM_TAPE_PILOTS_DATA   = 0x0c97;
 
 /* Functions to initialise block types */
 
@@ -61,7 +61,7 @@ data_block_init( libspectrum_tape_data_block *block,
 libspectrum_tape_block*
 libspectrum_tape_block_alloc( libspectrum_tape_type type )
 {
-  libspectrum_tape_block *block = libspectrum_new( libspectrum_tape_block, 1 );
+  libspectrum_tape_block *block = libspectrum_new0( libspectrum_tape_block, 1 );
   libspectrum_tape_block_set_type( block, type );
   return block;
 }
@@ -168,6 +168,10 @@ libspectrum_tape_block_free( libspectrum_tape_block *block )
 
   case LIBSPECTRUM_TAPE_BLOCK_RLE_PULSE:
     libspectrum_free( block->types.rle_pulse.data );
+#ifdef HAVE_ZLIB_H
+    libspectrum_zlib_stream_free( block->types.rle_pulse.stream );
+#endif
+    libspectrum_free( block->types.rle_pulse.compressed );
     break;
 
   case LIBSPECTRUM_TAPE_BLOCK_PULSE_SEQUENCE:
@@ -679,6 +683,9 @@ rle_pulse_block_length( libspectrum_tape_rle_pulse_block *rle_pulse )
   libspectrum_dword length = 0;
   size_t i;
 
+  /* Worked out as the block was read */
+  if( !rle_pulse->data ) return rle_pulse->tstates;
+
   for( i = 0; i < rle_pulse->length; i++ ) {
     length += rle_pulse->data[ i ] * rle_pulse->scale;
   }
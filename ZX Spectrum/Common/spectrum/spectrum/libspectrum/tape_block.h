@@ -352,6 +352,13 @@ typedef struct libspectrum_tape_rle_pulse_block {
   libspectrum_byte *data;
   long scale;
 
+  /* Z-RLE .csw data is kept compressed and inflated as it's played, in
+     which case `data' is NULL and `length' is the inflated length */
+  libspectrum_byte *compressed;
+  size_t compressed_length;
+  struct libspectrum_zlib_stream *stream;
+  libspectrum_dword tstates;	/* Cached result of the block length */
+
 } libspectrum_tape_rle_pulse_block;
 
 typedef struct libspectrum_tape_rle_pulse_block_state {
@@ -501,6 +508,9 @@ libspectrum_tape_pure_data_next_bit( libspectrum_tape_pure_data_block *block,
 void
 libspectrum_tape_raw_data_next_bit( libspectrum_tape_raw_data_block *block,
                              libspectrum_tape_raw_data_block_state *state );
+libspectrum_error
+libspectrum_tape_rle_pulse_byte( libspectrum_tape_rle_pulse_block *block,
+                                 size_t offset, libspectrum_byte *byte );
 libspectrum_byte
 get_generalised_data_symbol( libspectrum_tape_generalised_data_block *block,
                         libspectrum_tape_generalised_data_block_state *state );
@@ -1,28 +1,12 @@
 #include "test.h"
 
 test_return_t
-check_edges( const char *filename, test_edge_sequence_t *edges,
-	     int flags_mask )
+check_tape_edges( libspectrum_tape *tape, test_edge_sequence_t *edges,
+		  int flags_mask )
 {
-  libspectrum_byte *buffer = NULL;
-  size_t filesize = 0;
-  libspectrum_tape *tape;
   test_return_t r = TEST_FAIL;
   test_edge_sequence_t *ptr = edges;
 
-  if( read_file( &buffer, &filesize, filename ) ) return TEST_INCOMPLETE;
-
-  tape = libspectrum_tape_alloc();
-
-  if( libspectrum_tape_read( tape, buffer, filesize, LIBSPECTRUM_ID_UNKNOWN,
-			     filename ) != LIBSPECTRUM_ERROR_NONE ) {
-    libspectrum_tape_free( tape );
-    libspectrum_free( buffer );
-    return TEST_INCOMPLETE;
-  }
-
-  libspectrum_free( buffer );
-
   while( 1 ) {
 
     libspectrum_dword tstates;
@@ -30,10 +14,7 @@ check_edges( const char *filename, test_edge_sequence_t *edges,
     libspectrum_error e;
 
     e = libspectrum_tape_get_next_edge( &tstates, &flags, tape );
-    if( e ) {
-      libspectrum_tape_free( tape );
-      return TEST_INCOMPLETE;
-    }
+    if( e ) return TEST_INCOMPLETE;
 
     flags &= flags_mask;
 
@@ -58,9 +39,34 @@ check_edges( const char *filename, test_edge_sequence_t *edges,
     }
   }
 
+  return r;
+}
+
+test_return_t
+check_edges( const char *filename, test_edge_sequence_t *edges,
+	     int flags_mask )
+{
+  libspectrum_byte *buffer = NULL;
+  size_t filesize = 0;
+  libspectrum_tape *tape;
+  test_return_t r;
+
+  if( read_file( &buffer, &filesize, filename ) ) return TEST_INCOMPLETE;
+
+  tape = libspectrum_tape_alloc();
+
+  if( libspectrum_tape_read( tape, buffer, filesize, LIBSPECTRUM_ID_UNKNOWN,
+			     filename ) != LIBSPECTRUM_ERROR_NONE ) {
+    libspectrum_tape_free( tape );
+    libspectrum_free( buffer );
+    return TEST_INCOMPLETE;
+  }
+
+  libspectrum_free( buffer );
+
+  r = check_tape_edges( tape, edges, flags_mask );
+
   if( libspectrum_tape_free( tape ) ) return TEST_INCOMPLETE;
 
   return r;
 }
-
-  
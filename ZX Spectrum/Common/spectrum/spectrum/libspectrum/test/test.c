@@ -733,6 +733,136 @@ test_27( void )
   return r;
 }
 
+/* The metadata reader should agree with the full snapshot reader */
+static test_return_t
+metadata_matches_snap( const char *filename )
+{
+  libspectrum_byte *buffer = NULL;
+  size_t filesize = 0;
+  libspectrum_snap *snap;
+  libspectrum_metadata *metadata;
+  const libspectrum_byte *screen;
+  test_return_t r = TEST_INCOMPLETE;
+
+  if( read_file( &buffer, &filesize, filename ) ) return TEST_INCOMPLETE;
+
+  snap = libspectrum_snap_alloc();
+  metadata = libspectrum_metadata_alloc();
+
+  if( libspectrum_snap_read( snap, buffer, filesize, LIBSPECTRUM_ID_UNKNOWN,
+			     filename ) != LIBSPECTRUM_ERROR_NONE ||
+      libspectrum_metadata_read( metadata, buffer, filesize,
+				 filename ) != LIBSPECTRUM_ERROR_NONE ) {
+    fprintf( stderr, "%s: reading `%s' failed\n", progname, filename );
+  } else if( libspectrum_metadata_class( metadata ) !=
+	     LIBSPECTRUM_CLASS_SNAPSHOT ) {
+    fprintf( stderr, "%s: `%s' not identified as a snapshot\n", progname,
+	     filename );
+    r = TEST_FAIL;
+  } else if( libspectrum_metadata_machine( metadata ) !=
+	     libspectrum_snap_machine( snap ) ) {
+    fprintf( stderr, "%s: machine for `%s' is %d, not the expected %d\n",
+	     progname, filename, libspectrum_metadata_machine( metadata ),
+	     libspectrum_snap_machine( snap ) );
+    r = TEST_FAIL;
+  } else if( !( screen = libspectrum_metadata_screen( metadata ) ) ||
+	     memcmp( screen, libspectrum_snap_pages( snap, 5 ),
+		     LIBSPECTRUM_METADATA_SCREEN_LENGTH ) ) {
+    fprintf( stderr, "%s: screen for `%s' doesn't match RAM page 5\n",
+	     progname, filename );
+    r = TEST_FAIL;
+  } else {
+    r = TEST_PASS;
+  }
+
+  libspectrum_metadata_free( metadata );
+  libspectrum_snap_free( snap );
+  libspectrum_free( buffer );
+
+  return r;
+}
+
+static test_return_t
+test_30( void )
+{
+  test_return_t r;
+
+  r = metadata_matches_snap( STATIC_TEST_PATH( "plus3.z80" ) );
+  if( r != TEST_PASS ) return r;
+
+  r = metadata_matches_snap( STATIC_TEST_PATH( "empty.z80" ) );
+  if( r != TEST_PASS ) return r;
+
+  return metadata_matches_snap( STATIC_TEST_PATH( "empty.szx" ) );
+}
+
+/* Compare the next edge from two tapes; sets `stop' when both have reached
+   the end of the tape */
+static test_return_t
+compare_next_edge( libspectrum_tape *tape, libspectrum_tape *expected,
+		   int *stop )
+{
+  libspectrum_dword tstates, expected_tstates;
+  int flags, expected_flags;
+
+  if( libspectrum_tape_get_next_edge( &tstates, &flags, tape ) ||
+      libspectrum_tape_get_next_edge( &expected_tstates, &expected_flags,
+				      expected ) )
+    return TEST_INCOMPLETE;
+
+  if( tstates != expected_tstates || flags != expected_flags ) {
+    fprintf( stderr,
+	     "%s: expected %d tstates and flags %d, got %d tstates and flags %d\n",
+	     progname, expected_tstates, expected_flags, tstates, flags );
+    return TEST_FAIL;
+  }
+
+  *stop = flags & LIBSPECTRUM_TAPE_FLAGS_STOP;
+
+  return TEST_PASS;
+}
+
+/* Z-RLE CSW files are inflated a window at a time as they are played; check
+   they give the same edges as the uncompressed file, including a long pulse
+   split across two windows and going back to the start of the block */
+static test_return_t
+test_31( void )
+{
+  libspectrum_tape *tape, *expected;
+  test_return_t r;
+  int stop = 0, edges = 0;
+
+  r = load_tape( &tape, STATIC_TEST_PATH( "zrle.csw" ),
+		 LIBSPECTRUM_ERROR_NONE );
+  if( r ) return r;
+
+  r = load_tape( &expected, STATIC_TEST_PATH( "rle.csw" ),
+		 LIBSPECTRUM_ERROR_NONE );
+  if( r ) {
+    libspectrum_tape_free( tape );
+    return r;
+  }
+
+  /* Play past the long pulse at the window boundary, then rewind */
+  while( r == TEST_PASS && edges++ < 17000 )
+    r = compare_next_edge( tape, expected, &stop );
+
+  if( r == TEST_PASS &&
+      ( libspectrum_tape_nth_block( tape, 0 ) ||
+	libspectrum_tape_nth_block( expected, 0 ) ) )
+    r = TEST_INCOMPLETE;
+
+  /* And play the whole block from its start */
+  stop = 0;
+  while( r == TEST_PASS && !stop )
+    r = compare_next_edge( tape, expected, &stop );
+
+  if( libspectrum_tape_free( tape ) || libspectrum_tape_free( expected ) )
+    return TEST_INCOMPLETE;
+
+  return r;
+}
+
 struct test_description {
 
   test_fn test;
@@ -771,6 +901,9 @@ static struct test_description tests[] = {
   { test_27, "Reading old SZX file", 0 },
   { test_28, "Zero tail length PZX file", 0 },
   { test_29, "No pilot pulse GDB TZX file", 0 },
+  { test_30, "Snapshot metadata", 0 },
+  { test_31, "CSW Z-RLE file", 0 },
+  { test_32, "Writing PZX file", 0 },
 };
 
 static size_t test_count = ARRAY_SIZE( tests );
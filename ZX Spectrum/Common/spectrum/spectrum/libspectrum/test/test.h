@@ -27,9 +27,12 @@ int read_file( libspectrum_byte **buffer, size_t *length,
 
 test_return_t check_edges( const char *filename, test_edge_sequence_t *edges,
 			   int flags_mask );
+test_return_t check_tape_edges( libspectrum_tape *tape,
+				test_edge_sequence_t *edges, int flags_mask );
 
 test_return_t test_15( void );
 test_return_t test_28( void );
 test_return_t test_29( void );
+test_return_t test_32( void );
 
 #endif
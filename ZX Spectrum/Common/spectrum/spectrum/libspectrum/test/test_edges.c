@@ -195,3 +195,146 @@ test_29( void )
   return check_edges( DYNAMIC_TEST_PATH( "no-pilot-gdb.tzx" ),
                       no_pilot_gdb_list, 0x1ff );
 }
+
+static test_edge_sequence_t
+pzx_write_edges_list[] = 
+{
+  /* ROM block */
+  { 2168, 3223, 0 },	/* Pilot */
+  {  667,    1, 0 },	/* Sync 1 */
+  {  735,    1, 1 },	/* Sync 2, end of PULS block */
+  { 1710,   16, 0 },	/* Byte 1 */
+  {  855,    8, 0 },	/* Byte 2, bits 1-4 */
+  { 1710,    8, 0 },	/* Byte 2, bits 5-8 */
+  {    0,    1, 1 },	/* No tail, end of DATA block */
+  { 3500,    1, 1 },	/* Pause */
+
+  /* Turbo speed data block */
+  { 1000,    5, 0 },	/* Pilot */
+  {  123,    1, 0 },	/* Sync 1 */
+  {  456,    1, 1 },	/* Sync 2, end of PULS block */
+  {  789,   16, 0 },	/* Byte 1 */
+  {  400,    8, 0 },	/* Byte 2, bits 1-4 */
+  {    0,    1, 1 },	/* No tail, end of DATA block */
+  { 7000,    1, 1 },	/* Pause */
+
+  /* Pure tone block, split over two PULS entries */
+  {  535, 33023, 0 },
+  {  535,    1, 1 },
+
+  /* List of pulses */
+  { 74565,   1, 0 },
+  {  700,    1, 1 },
+
+  /* Pause block */
+  { 350000,  1, 1 },
+
+  /* Stop block */
+  {    0,    1, 3 },
+
+  { -1, 0, 0 }		/* End marker */
+};
+
+static libspectrum_tape_block*
+pzx_write_block( libspectrum_tape *tape, libspectrum_tape_type type )
+{
+  libspectrum_tape_block *block = libspectrum_tape_block_alloc( type );
+
+  libspectrum_tape_append_block( tape, block );
+
+  return block;
+}
+
+static void
+pzx_write_block_data( libspectrum_tape_block *block,
+		      libspectrum_byte first, libspectrum_byte second )
+{
+  libspectrum_byte *data = libspectrum_new( libspectrum_byte, 2 );
+
+  data[0] = first; data[1] = second;
+  libspectrum_tape_block_set_data( block, data );
+  libspectrum_tape_block_set_data_length( block, 2 );
+}
+
+static void
+pzx_write_block_pause( libspectrum_tape_block *block, libspectrum_dword ms )
+{
+  libspectrum_tape_block_set_pause( block, ms );
+  libspectrum_tape_block_set_pause_tstates( block, ms * 3500 );
+}
+
+/* Write a tape with a block of each type PZX has its own block for, read
+   it back and check the edges */
+test_return_t
+test_32( void )
+{
+  libspectrum_tape *tape;
+  libspectrum_tape_block *block;
+  libspectrum_dword *lengths;
+  libspectrum_byte *buffer = NULL;
+  size_t length = 0;
+  test_return_t r;
+
+  tape = libspectrum_tape_alloc();
+
+  block = pzx_write_block( tape, LIBSPECTRUM_TAPE_BLOCK_ROM );
+  pzx_write_block_data( block, 0xff, 0x0f );
+  pzx_write_block_pause( block, 1 );
+
+  block = pzx_write_block( tape, LIBSPECTRUM_TAPE_BLOCK_TURBO );
+  libspectrum_tape_block_set_pilot_length( block, 1000 );
+  libspectrum_tape_block_set_pilot_pulses( block, 5 );
+  libspectrum_tape_block_set_sync1_length( block, 123 );
+  libspectrum_tape_block_set_sync2_length( block, 456 );
+  libspectrum_tape_block_set_bit0_length( block, 789 );
+  libspectrum_tape_block_set_bit1_length( block, 400 );
+  libspectrum_tape_block_set_bits_in_last_byte( block, 4 );
+  pzx_write_block_data( block, 0x00, 0xf0 );
+  pzx_write_block_pause( block, 2 );
+
+  /* More repeats than fit in one PULS entry */
+  block = pzx_write_block( tape, LIBSPECTRUM_TAPE_BLOCK_PURE_TONE );
+  libspectrum_tape_block_set_pulse_length( block, 535 );
+  libspectrum_tape_block_set_count( block, 0x8100 );
+
+  /* And a pulse too long for one word */
+  block = pzx_write_block( tape, LIBSPECTRUM_TAPE_BLOCK_PULSES );
+  lengths = libspectrum_new( libspectrum_dword, 2 );
+  lengths[0] = 0x12345; lengths[1] = 700;
+  libspectrum_tape_block_set_count( block, 2 );
+  libspectrum_tape_block_set_pulse_lengths( block, lengths );
+
+  block = pzx_write_block( tape, LIBSPECTRUM_TAPE_BLOCK_PAUSE );
+  pzx_write_block_pause( block, 100 );
+
+  /* A zero length pause stops the tape */
+  block = pzx_write_block( tape, LIBSPECTRUM_TAPE_BLOCK_PAUSE );
+  pzx_write_block_pause( block, 0 );
+
+  if( libspectrum_tape_write( &buffer, &length, tape,
+			      LIBSPECTRUM_ID_TAPE_PZX ) ) {
+    libspectrum_tape_free( tape );
+    return TEST_INCOMPLETE;
+  }
+
+  libspectrum_tape_free( tape );
+  tape = libspectrum_tape_alloc();
+
+  if( libspectrum_tape_read( tape, buffer, length, LIBSPECTRUM_ID_TAPE_PZX,
+			     NULL ) ) {
+    fprintf( stderr, "%s: reading back written PZX file failed\n",
+	     progname );
+    libspectrum_tape_free( tape );
+    libspectrum_free( buffer );
+    return TEST_INCOMPLETE;
+  }
+
+  libspectrum_free( buffer );
+
+  r = check_tape_edges( tape, pzx_write_edges_list,
+		        LIBSPECTRUM_TAPE_FLAGS_BLOCK | LIBSPECTRUM_TAPE_FLAGS_STOP );
+
+  if( libspectrum_tape_free( tape ) ) return TEST_INCOMPLETE;
+
+  return r;
+}
@@ -31,14 +31,17 @@
 #include "internals.h"
 #include "tape_block.h"
 
+/* How many samples to read from the file at once */
+#define WAV_READ_WINDOW 65536
+
 libspectrum_error
 libspectrum_wav_read( libspectrum_tape *tape, const char *filename )
 {
   libspectrum_byte *buffer; size_t length;
   libspectrum_byte *tape_buffer; size_t tape_length;
-  size_t data_length;
+  size_t data_length, frames_read;
   libspectrum_tape_block *block = NULL;
-  int frames;
+  int frames = 0;
 
   /* Our filehandle from libaudiofile */
   AFfilehandle handle;
@@ -83,25 +86,7 @@ libspectrum_wav_read( libspectrum_tape *tape, const char *filename )
 
   length = afGetFrameCount( handle, track );
 
-  tape_length = length;
-  if( tape_length%8 ) tape_length += 8 - (tape_length%8);
-
-  buffer = libspectrum_new0( libspectrum_byte,
-			     tape_length * afGetChannels(handle, track) );
-
-  frames = afReadFrames( handle, track, buffer, length );
-  if( frames == -1 ) {
-    libspectrum_free( buffer );
-    afCloseFile( handle );
-    libspectrum_print_error(
-      LIBSPECTRUM_ERROR_CORRUPT,
-      "libspectrum_wav_read: can't calculate number of frames in audio file"
-    );
-    return LIBSPECTRUM_ERROR_CORRUPT;
-  }
-
   if( !length ) {
-    libspectrum_free( buffer );
     afCloseFile( handle );
     libspectrum_print_error(
       LIBSPECTRUM_ERROR_CORRUPT,
@@ -110,13 +95,52 @@ libspectrum_wav_read( libspectrum_tape *tape, const char *filename )
     return LIBSPECTRUM_ERROR_CORRUPT;
   }
 
-  if( frames != length ) {
-    libspectrum_free( buffer );
+  tape_length = length;
+  if( tape_length%8 ) tape_length += 8 - (tape_length%8);
+
+  data_length = tape_length / LIBSPECTRUM_BITS_IN_BYTE;
+  tape_buffer = libspectrum_new0( libspectrum_byte, data_length );
+
+  /* Read the samples a window at a time, packing each one down to a single
+     bit as we go, rather than holding every sample in memory at once */
+  buffer = libspectrum_new( libspectrum_byte, WAV_READ_WINDOW );
+
+  for( frames_read = 0; frames_read < length; frames_read += frames ) {
+
+    size_t i, wanted = length - frames_read;
+    if( wanted > WAV_READ_WINDOW ) wanted = WAV_READ_WINDOW;
+
+    frames = afReadFrames( handle, track, buffer, wanted );
+    if( frames == -1 ) {
+      libspectrum_free( tape_buffer );
+      libspectrum_free( buffer );
+      afCloseFile( handle );
+      libspectrum_print_error(
+        LIBSPECTRUM_ERROR_CORRUPT,
+        "libspectrum_wav_read: can't calculate number of frames in audio file"
+      );
+      return LIBSPECTRUM_ERROR_CORRUPT;
+    }
+
+    if( !frames ) break;
+
+    for( i = 0; i < (size_t)frames; i++ ) {
+      if( buffer[i] > 127 )
+        tape_buffer[ ( frames_read + i ) / 8 ] |=
+          1 << ( 7 - ( frames_read + i ) % 8 );
+    }
+
+  }
+
+  libspectrum_free( buffer );
+
+  if( frames_read != length ) {
+    libspectrum_free( tape_buffer );
     afCloseFile( handle );
     libspectrum_print_error(
       LIBSPECTRUM_ERROR_CORRUPT,
-      "libspectrum_wav_read: read %d frames, but expected %lu\n", frames,
-      (unsigned long)length
+      "libspectrum_wav_read: read %lu frames, but expected %lu\n",
+      (unsigned long)frames_read, (unsigned long)length
     );
     return LIBSPECTRUM_ERROR_CORRUPT;
   }
@@ -130,29 +154,12 @@ libspectrum_wav_read( libspectrum_tape *tape, const char *filename )
   libspectrum_tape_block_set_bits_in_last_byte( block,
               length % LIBSPECTRUM_BITS_IN_BYTE ?
                 length % LIBSPECTRUM_BITS_IN_BYTE : LIBSPECTRUM_BITS_IN_BYTE );
-  data_length = tape_length / LIBSPECTRUM_BITS_IN_BYTE;
   libspectrum_tape_block_set_data_length( block, data_length );
-
-  tape_buffer = libspectrum_new0( libspectrum_byte, data_length );
-
-  libspectrum_byte *from = buffer;
-  libspectrum_byte *to = tape_buffer;
-  length = tape_length;
-  do {
-    libspectrum_byte val = 0;
-    int i;
-    for( i = 7; i >= 0; i-- ) {
-      if( *from++ > 127 ) val |= 1 << i;
-    }
-    *to++ = val;
-  } while ((length -= 8) > 0);
-
   libspectrum_tape_block_set_data( block, tape_buffer );
 
   libspectrum_tape_append_block( tape, block );
 
   if( afCloseFile( handle ) ) {
-    libspectrum_free( buffer );
     libspectrum_print_error(
       LIBSPECTRUM_ERROR_UNKNOWN,
       "libspectrum_wav_read: failed to close audio file"
@@ -160,8 +167,6 @@ libspectrum_wav_read( libspectrum_tape *tape, const char *filename )
     return LIBSPECTRUM_ERROR_UNKNOWN;
   }
 
-  libspectrum_free( buffer );
-
   /* Successful completion */
   return LIBSPECTRUM_ERROR_NONE;
 }
@@ -223,6 +223,78 @@ internal_z80_read( libspectrum_snap *snap,
   return LIBSPECTRUM_ERROR_NONE;
 }
 
+/* Read the header and just the page holding the screen from a .z80 file;
+   the other pages are skipped without being decompressed. `screen' must
+   be at least 6912 bytes long, and `*have_screen' is set if it was filled */
+libspectrum_error
+internal_z80_read_metadata( libspectrum_snap *snap,
+                            const libspectrum_byte *buffer,
+                            size_t buffer_length, libspectrum_byte *screen,
+                            int *have_screen )
+{
+  libspectrum_error error;
+  const libspectrum_byte *data, *next_block, *end = buffer + buffer_length;
+  libspectrum_byte *uncompressed;
+  int version, compressed = 1;
+
+  *have_screen = 0;
+
+  /* read_header() trusts the extended header's length, so check it here */
+  if( buffer_length < LIBSPECTRUM_Z80_HEADER_LENGTH + 2 ||
+      ( buffer[6] == 0 && buffer[7] == 0 &&
+        buffer_length < LIBSPECTRUM_Z80_HEADER_LENGTH + 2 +
+                        buffer[ LIBSPECTRUM_Z80_HEADER_LENGTH     ] +
+                        buffer[ LIBSPECTRUM_Z80_HEADER_LENGTH + 1 ] * 0x100 ) ) {
+    libspectrum_print_error( LIBSPECTRUM_ERROR_CORRUPT,
+                             "internal_z80_read_metadata: not enough data" );
+    return LIBSPECTRUM_ERROR_CORRUPT;
+  }
+
+  error = read_header( buffer, snap, &data, &version, &compressed );
+  if( error != LIBSPECTRUM_ERROR_NONE ) return error;
+
+  if( version == 1 ) {
+
+    error = read_v1_block( data, compressed, &uncompressed, &next_block,
+                           end );
+    if( error != LIBSPECTRUM_ERROR_NONE ) return error;
+
+    memcpy( screen, uncompressed, LIBSPECTRUM_METADATA_SCREEN_LENGTH );
+    libspectrum_free( uncompressed );
+    *have_screen = 1;
+
+    return LIBSPECTRUM_ERROR_NONE;
+  }
+
+  /* Page 8 is 0x4000 on the 48K machines and RAM bank 5 on everything
+     else, so it always holds the normal screen */
+  while( end - data >= 3 ) {
+
+    size_t length = data[0] + data[1] * 0x100;
+    int page = data[2];
+
+    /* Stop at .slt data or anything which isn't a page */
+    if( length == 0 && page == 0 ) break;
+
+    if( page == 8 ) {
+      error = read_v2_block( data, &uncompressed, &length, &page, &next_block,
+                             end );
+      if( error != LIBSPECTRUM_ERROR_NONE ) return error;
+
+      if( length >= LIBSPECTRUM_METADATA_SCREEN_LENGTH ) {
+        memcpy( screen, uncompressed, LIBSPECTRUM_METADATA_SCREEN_LENGTH );
+        *have_screen = 1;
+      }
+      libspectrum_free( uncompressed );
+      break;
+    }
+
+    data += 3 + ( length == 0xffff ? 0x4000 : length );
+  }
+
+  return LIBSPECTRUM_ERROR_NONE;
+}
+
 static libspectrum_error
 read_header( const libspectrum_byte *buffer, libspectrum_snap *snap,
 	     const libspectrum_byte **data, int *version, int *compressed )
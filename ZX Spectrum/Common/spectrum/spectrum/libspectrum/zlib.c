@@ -35,6 +35,10 @@
 #include <unistd.h>
 #endif			/* #ifdef HAVE_UNISTD_H */
 
+#ifdef HAVE_PTHREAD_H
+#include <pthread.h>
+#endif			/* #ifdef HAVE_PTHREAD_H */
+
 #define ZLIB_CONST
 #include <zlib.h>
 
@@ -308,16 +312,12 @@ skip_null_terminated_string( const libspectrum_byte **ptr, size_t *length,
   return LIBSPECTRUM_ERROR_NONE;
 }
 
-libspectrum_error
-libspectrum_zlib_compress( const libspectrum_byte *data, size_t length,
-			   libspectrum_byte **gzptr, size_t *gzlength )
-/* Deflates a block of data.
- * Input:	data		-> source data
- *		length		== source data length
- * Output:	*gzptr		-> deflated data (malloced in this fn),
- *		*gzlength	== length of the deflated data
- * Returns:	error flag (libspectrum_error)
- */
+/* Deflate a block of data without reporting any error, so this can be used
+   from worker threads; on error, *message describes what went wrong */
+static libspectrum_error
+zlib_compress( const libspectrum_byte *data, size_t length,
+	       libspectrum_byte **gzptr, size_t *gzlength,
+	       const char **message )
 {
   uLongf gzl = (uLongf)( length * 1.001 ) + 12;
   int gzret;
@@ -333,27 +333,502 @@ libspectrum_zlib_compress( const libspectrum_byte *data, size_t length,
 
   case Z_MEM_ERROR:		/* out of memory */
     libspectrum_free( *gzptr ); *gzptr = 0;
-    libspectrum_print_error( LIBSPECTRUM_ERROR_MEMORY,
-			     "libspectrum_zlib_compress: out of memory" );
+    *message = "out of memory";
     return LIBSPECTRUM_ERROR_MEMORY;
 
   case Z_VERSION_ERROR:		/* unrecognised version */
     libspectrum_free( *gzptr ); *gzptr = 0;
-    libspectrum_print_error( LIBSPECTRUM_ERROR_UNKNOWN,
-			     "libspectrum_zlib_compress: unknown version" );
+    *message = "unknown version";
     return LIBSPECTRUM_ERROR_UNKNOWN;
 
   case Z_BUF_ERROR:		/* Not enough space in output buffer.
 				   Shouldn't happen */
     libspectrum_free( *gzptr ); *gzptr = 0;
-    libspectrum_print_error( LIBSPECTRUM_ERROR_LOGIC,
-			     "libspectrum_zlib_compress: out of space?" ); 
+    *message = "out of space?";
     return LIBSPECTRUM_ERROR_LOGIC;
 
   default:			/* some other error */
     libspectrum_free( *gzptr ); *gzptr = 0;
-    libspectrum_print_error( LIBSPECTRUM_ERROR_LOGIC,
-			     "libspectrum_zlib_compress: unexpected error?" ); 
+    *message = "unexpected error?";
     return LIBSPECTRUM_ERROR_LOGIC;
   }
 }
+
+libspectrum_error
+libspectrum_zlib_compress( const libspectrum_byte *data, size_t length,
+			   libspectrum_byte **gzptr, size_t *gzlength )
+/* Deflates a block of data.
+ * Input:	data		-> source data
+ *		length		== source data length
+ * Output:	*gzptr		-> deflated data (malloced in this fn),
+ *		*gzlength	== length of the deflated data
+ * Returns:	error flag (libspectrum_error)
+ */
+{
+  const char *message;
+  libspectrum_error error;
+
+  error = zlib_compress( data, length, gzptr, gzlength, &message );
+  if( error )
+    libspectrum_print_error( error, "libspectrum_zlib_compress: %s",
+			     message );
+
+  return error;
+}
+
+/* As libspectrum_zlib_inflate_to_buffer(), but without reporting any
+   error */
+static libspectrum_error
+zlib_inflate_to_buffer( const libspectrum_byte *gzptr, size_t gzlength,
+			libspectrum_byte *outptr, size_t outlength,
+			const char **message )
+{
+  uLongf length = outlength;
+  int error;
+
+  error = uncompress( outptr, &length, gzptr, gzlength );
+
+  switch( error ) {
+
+  case Z_OK:
+    if( length == outlength ) return LIBSPECTRUM_ERROR_NONE;
+    *message = "inflated to the wrong length";
+    return LIBSPECTRUM_ERROR_CORRUPT;
+
+  case Z_MEM_ERROR:
+    *message = "out of memory";
+    return LIBSPECTRUM_ERROR_MEMORY;
+
+  case Z_BUF_ERROR:
+    *message = "not enough space in zlib output buffer";
+    return LIBSPECTRUM_ERROR_CORRUPT;
+
+  default:
+    *message = "corrupt zlib data";
+    return LIBSPECTRUM_ERROR_CORRUPT;
+
+  }
+}
+
+/* Inflates a block of data whose length is known in advance straight into
+   a buffer supplied by the caller */
+libspectrum_error
+libspectrum_zlib_inflate_to_buffer( const libspectrum_byte *gzptr,
+				    size_t gzlength, libspectrum_byte *outptr,
+				    size_t outlength )
+{
+  const char *message;
+  libspectrum_error error;
+
+  error = zlib_inflate_to_buffer( gzptr, gzlength, outptr, outlength,
+				  &message );
+  if( error )
+    libspectrum_print_error( error, "libspectrum_zlib_inflate_to_buffer: %s",
+			     message );
+
+  return error;
+}
+
+/* Run a compression or inflation over a set of pages, spreading the work
+   over a pool of threads if we can. The pool is started the first time it's
+   needed and kept until libspectrum_end(). Nothing is reported from the
+   workers: each page just records its error, and the first is reported
+   once all the pages are done */
+
+typedef void (*zlib_page_fn)( libspectrum_zlib_page *page );
+
+typedef struct zlib_page_work {
+
+  libspectrum_zlib_page *pages;
+  size_t count;
+  zlib_page_fn fn;
+
+  size_t next;
+
+} zlib_page_work;
+
+/* The most threads we'll use; a snapshot has at most 64 pages, and there's
+   little to gain from more threads than that on any likely machine */
+#define ZLIB_MAX_THREADS 8
+
+#ifdef HAVE_PTHREAD_H
+
+static zlib_page_work pool_work;
+
+/* -1 until the pool has been started */
+static int pool_threads = -1;
+static pthread_t pool_workers[ ZLIB_MAX_THREADS - 1 ];
+
+/* Held for the whole of a run, as snapshots may be read or written on more
+   than one thread at once */
+static pthread_mutex_t pool_run_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static pthread_mutex_t pool_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t pool_start = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t pool_done = PTHREAD_COND_INITIALIZER;
+
+/* Bumped each time a run is posted */
+static unsigned pool_generation = 0;
+
+/* The number of workers still busy with this run */
+static int pool_pending = 0;
+
+static int pool_quit = 0;
+
+/* Take pages from the current run until there are none left; called with
+   pool_lock held */
+static void
+zlib_page_work_run( zlib_page_work *work )
+{
+  size_t i;
+
+  while( work->next < work->count ) {
+    i = work->next++;
+
+    pthread_mutex_unlock( &pool_lock );
+    work->fn( &work->pages[i] );
+    pthread_mutex_lock( &pool_lock );
+  }
+}
+
+static void*
+zlib_pool_worker( void *arg )
+{
+  unsigned seen = 0;
+
+  pthread_mutex_lock( &pool_lock );
+
+  while( 1 ) {
+    while( pool_generation == seen && !pool_quit )
+      pthread_cond_wait( &pool_start, &pool_lock );
+    if( pool_quit ) break;
+
+    seen = pool_generation;
+
+    zlib_page_work_run( &pool_work );
+
+    if( !--pool_pending ) pthread_cond_signal( &pool_done );
+  }
+
+  pthread_mutex_unlock( &pool_lock );
+
+  return NULL;
+}
+
+/* Start the workers the first time they're needed; called with
+   pool_run_lock held */
+static void
+zlib_pool_init( void )
+{
+  long cpus = 1;
+
+  if( pool_threads >= 0 ) return;
+
+#if defined( HAVE_UNISTD_H ) && defined( _SC_NPROCESSORS_ONLN )
+  cpus = sysconf( _SC_NPROCESSORS_ONLN );
+#endif
+  if( cpus < 1 ) cpus = 1;
+  if( cpus > ZLIB_MAX_THREADS ) cpus = ZLIB_MAX_THREADS;
+
+  /* No run can have been posted yet, so the workers all start with a
+     generation of zero */
+  for( pool_threads = 0; pool_threads < cpus - 1; pool_threads++ )
+    if( pthread_create( &pool_workers[ pool_threads ], NULL,
+			zlib_pool_worker, NULL ) )
+      break;
+}
+
+static void
+zlib_pool_run( libspectrum_zlib_page *pages, size_t count, zlib_page_fn fn )
+{
+  pthread_mutex_lock( &pool_run_lock );
+
+  zlib_pool_init();
+
+  pthread_mutex_lock( &pool_lock );
+
+  pool_work.pages = pages; pool_work.count = count; pool_work.fn = fn;
+  pool_work.next = 0;
+
+  /* The calling thread does its share of the work too; a worker which
+     wakes up to find nothing left just goes back to sleep */
+  pool_pending = pool_threads;
+  pool_generation++;
+  pthread_cond_broadcast( &pool_start );
+
+  zlib_page_work_run( &pool_work );
+
+  while( pool_pending ) pthread_cond_wait( &pool_done, &pool_lock );
+
+  pthread_mutex_unlock( &pool_lock );
+
+  pthread_mutex_unlock( &pool_run_lock );
+}
+
+void
+libspectrum_zlib_end( void )
+{
+  int i;
+
+  pthread_mutex_lock( &pool_run_lock );
+
+  if( pool_threads > 0 ) {
+    pthread_mutex_lock( &pool_lock );
+    pool_quit = 1;
+    pthread_cond_broadcast( &pool_start );
+    pthread_mutex_unlock( &pool_lock );
+
+    for( i = 0; i < pool_threads; i++ )
+      pthread_join( pool_workers[i], NULL );
+
+    pool_quit = 0;
+  }
+
+  pool_threads = -1;
+
+  pthread_mutex_unlock( &pool_run_lock );
+}
+
+#else			/* #ifdef HAVE_PTHREAD_H */
+
+static void
+zlib_pool_run( libspectrum_zlib_page *pages, size_t count, zlib_page_fn fn )
+{
+  size_t i;
+
+  for( i = 0; i < count; i++ ) fn( &pages[i] );
+}
+
+void
+libspectrum_zlib_end( void )
+{
+}
+
+#endif			/* #ifdef HAVE_PTHREAD_H */
+
+static libspectrum_error
+zlib_run_pages( libspectrum_zlib_page *pages, size_t count, zlib_page_fn fn,
+		const char *what )
+{
+  size_t i;
+
+  zlib_pool_run( pages, count, fn );
+
+  for( i = 0; i < count; i++ )
+    if( pages[i].error ) {
+      libspectrum_print_error( pages[i].error, "%s: page %lu: %s", what,
+			       (unsigned long)i, pages[i].message );
+      return pages[i].error;
+    }
+
+  return LIBSPECTRUM_ERROR_NONE;
+}
+
+static void
+zlib_compress_page( libspectrum_zlib_page *page )
+{
+  page->error = zlib_compress( page->data, page->length, &page->output,
+			       &page->output_length, &page->message );
+  if( page->error ) page->output = NULL;
+}
+
+static void
+zlib_inflate_page( libspectrum_zlib_page *page )
+{
+  page->error = zlib_inflate_to_buffer( page->data, page->length,
+					page->output, page->output_length,
+					&page->message );
+}
+
+/* Compress each page into a newly allocated buffer in page->output */
+libspectrum_error
+libspectrum_zlib_compress_pages( libspectrum_zlib_page *pages, size_t count )
+{
+  return zlib_run_pages( pages, count, zlib_compress_page,
+			 "libspectrum_zlib_compress_pages" );
+}
+
+/* Inflate each page into the page->output_length bytes at page->output */
+libspectrum_error
+libspectrum_zlib_inflate_pages( libspectrum_zlib_page *pages, size_t count )
+{
+  return zlib_run_pages( pages, count, zlib_inflate_page,
+			 "libspectrum_zlib_inflate_pages" );
+}
+
+/* An inflate stream which keeps only a small window of its output */
+
+#define ZLIB_STREAM_WINDOW 16384
+
+struct libspectrum_zlib_stream {
+
+  const libspectrum_byte *data;	/* The input */
+  size_t length;
+
+  z_stream stream;
+  int finished;
+
+  /* The window covers the output from window_start onwards */
+  libspectrum_byte window[ ZLIB_STREAM_WINDOW ];
+  size_t window_start;
+  size_t window_length;
+
+};
+
+static libspectrum_error
+zlib_stream_rewind( libspectrum_zlib_stream *stream )
+{
+  int error;
+
+  inflateEnd( &stream->stream );
+
+  stream->stream.zalloc = Z_NULL; stream->stream.zfree = Z_NULL;
+  stream->stream.opaque = Z_NULL;
+  stream->stream.next_in = stream->data;
+  stream->stream.avail_in = stream->length;
+
+  stream->finished = 0;
+  stream->window_start = stream->window_length = 0;
+
+  error = inflateInit( &stream->stream );
+  if( error == Z_OK ) return LIBSPECTRUM_ERROR_NONE;
+
+  libspectrum_print_error( LIBSPECTRUM_ERROR_MEMORY,
+			   "error from inflateInit: %s",
+			   stream->stream.msg ? stream->stream.msg : "unknown" );
+  return LIBSPECTRUM_ERROR_MEMORY;
+}
+
+/* Move the window on to the next part of the output */
+static libspectrum_error
+zlib_stream_advance( libspectrum_zlib_stream *stream )
+{
+  int error;
+
+  stream->window_start += stream->window_length;
+  stream->window_length = 0;
+
+  if( stream->finished ) return LIBSPECTRUM_ERROR_NONE;
+
+  stream->stream.next_out = stream->window;
+  stream->stream.avail_out = ZLIB_STREAM_WINDOW;
+
+  error = inflate( &stream->stream, Z_SYNC_FLUSH );
+  stream->window_length = ZLIB_STREAM_WINDOW - stream->stream.avail_out;
+
+  switch( error ) {
+
+  case Z_STREAM_END:
+    stream->finished = 1;
+    return LIBSPECTRUM_ERROR_NONE;
+
+  case Z_OK:
+    return LIBSPECTRUM_ERROR_NONE;
+
+  case Z_BUF_ERROR:
+    /* Out of input before the end of the stream */
+    stream->finished = 1;
+    libspectrum_print_error( LIBSPECTRUM_ERROR_CORRUPT,
+			     "zlib stream is truncated" );
+    return LIBSPECTRUM_ERROR_CORRUPT;
+
+  case Z_MEM_ERROR:
+    libspectrum_print_error( LIBSPECTRUM_ERROR_MEMORY,
+			     "out of memory at %s:%d", __FILE__, __LINE__ );
+    return LIBSPECTRUM_ERROR_MEMORY;
+
+  default:
+    stream->finished = 1;
+    libspectrum_print_error( LIBSPECTRUM_ERROR_CORRUPT, "corrupt zlib data" );
+    return LIBSPECTRUM_ERROR_CORRUPT;
+
+  }
+}
+
+/* Open a stream over `length' bytes of zlib data at `data', which must stay
+   around until the stream is freed */
+libspectrum_zlib_stream*
+libspectrum_zlib_stream_alloc( const libspectrum_byte *data, size_t length )
+{
+  libspectrum_zlib_stream *stream = libspectrum_new0( libspectrum_zlib_stream,
+						      1 );
+
+  stream->data = data;
+  stream->length = length;
+
+  /* Give inflateEnd() something harmless to look at on the first rewind */
+  stream->stream.state = Z_NULL;
+
+  if( zlib_stream_rewind( stream ) ) {
+    libspectrum_free( stream );
+    return NULL;
+  }
+
+  return stream;
+}
+
+void
+libspectrum_zlib_stream_free( libspectrum_zlib_stream *stream )
+{
+  if( !stream ) return;
+
+  inflateEnd( &stream->stream );
+  libspectrum_free( stream );
+}
+
+/* Point `data' at the output from `offset' onwards, with `available' set
+   to how much of it is in the window; `available' is 0 once `offset' is past
+   the end of the output. Reading forwards just moves the window along;
+   reading backwards inflates again from the start */
+libspectrum_error
+libspectrum_zlib_stream_window( libspectrum_zlib_stream *stream, size_t offset,
+				const libspectrum_byte **data,
+				size_t *available )
+{
+  libspectrum_error error;
+
+  if( offset < stream->window_start ) {
+    error = zlib_stream_rewind( stream );
+    if( error ) return error;
+  }
+
+  while( offset >= stream->window_start + stream->window_length ) {
+
+    if( stream->finished ) {
+      *data = NULL;
+      *available = 0;
+      return LIBSPECTRUM_ERROR_NONE;
+    }
+
+    error = zlib_stream_advance( stream );
+    if( error ) return error;
+  }
+
+  *data = stream->window + ( offset - stream->window_start );
+  *available = stream->window_start + stream->window_length - offset;
+
+  return LIBSPECTRUM_ERROR_NONE;
+}
+
+/* Get the byte at `offset' in the output */
+libspectrum_error
+libspectrum_zlib_stream_byte( libspectrum_zlib_stream *stream, size_t offset,
+			      libspectrum_byte *byte )
+{
+  const libspectrum_byte *data;
+  size_t available;
+  libspectrum_error error;
+
+  error = libspectrum_zlib_stream_window( stream, offset, &data, &available );
+  if( error ) return error;
+
+  if( !available ) {
+    libspectrum_print_error( LIBSPECTRUM_ERROR_CORRUPT,
+			     "libspectrum_zlib_stream_byte: read past end of stream" );
+    return LIBSPECTRUM_ERROR_CORRUPT;
+  }
+
+  *byte = *data;
+
+  return LIBSPECTRUM_ERROR_NONE;
+}
@@ -7,6 +7,8 @@
 #import "ZX_Spectrum-Swift.h"
 #import "SpectrumDisplayController.h"
 
+#include "uiframe.h"
+
 int controller_display_init_function(int width, int height, void *context);
 int controller_display_hotswap_gfx_mode_function(void *context);
 void controller_display_putpixel_function(int x, int y, int colour, void *context);
@@ -68,11 +70,15 @@ static uint32_t imageWidth;
 static uint32_t imageHeight;
 static uint8_t *imageData;
 
-static BOOL displayUpdated;
-
 static CGColorSpaceRef colorSpace;
 
+static void controller_display_render(const uiframe *frame, void *context);
+
 int controller_display_init_function(int width, int height, void *context) {
+	// Make sure render thread isn't using image data before replacing it.
+	uiframe_end();
+	free(imageData);
+
 	SpectrumPalette *pal = SpectrumPalette.colored;
 	for (int i=0; i<16; i++) {
 		palette[i] = [pal rawColorAtIndex:i];
@@ -84,11 +90,12 @@ int controller_display_init_function(int width, int height, void *context) {
 	imageData = malloc(width * height * BYTES_PER_COLOR);
 	memset(imageData, 0, imageWidth * imageHeight * BYTES_PER_COLOR);
 	
-	displayUpdated = NO;
-	
-	colorSpace = CGColorSpaceCreateDeviceRGB();
+	if (!colorSpace) {
+		colorSpace = CGColorSpaceCreateDeviceRGB();
+	}
 	
-	return 0;
+	// Emulation only draws palette indices; converting to colors and creating the image happens on render thread.
+	return uiframe_init(width, height, controller_display_render, context);
 }
 
 int controller_display_hotswap_gfx_mode_function(void *context) {
@@ -96,107 +103,52 @@ int controller_display_hotswap_gfx_mode_function(void *context) {
 }
 
 void controller_display_putpixel_function(int x, int y, int colour, void *context) {
-	uint32_t raw = palette[colour];
-	uint32_t *base = (uint32_t *)imageData;
-
-	if (machine_current->timex) {
-		x <<= 1;
-		y <<= 1;
-		
-		uint32_t *buffer = &base[y * imageWidth + x];
-		
-		*(buffer++) = raw;
-		*(buffer++) = raw;
-		
-	} else {
-		uint32_t *buffer = &base[y * imageWidth + x];
-		
-		*(buffer++) = raw;
-	}
+	uiframe_putpixel(x, y, colour);
 }
 
 void controller_display_plot8_function(int x, int y, libspectrum_byte data, libspectrum_byte ink, libspectrum_byte paper, void *context) {
-	uint32_t inkRaw = palette[ink];
-	uint32_t paperRaw = palette[paper];
-
-	uint32_t *base = (uint32_t *)imageData;
-
-	if (machine_current->timex) {
-		x <<= 4;
-		y <<= 1;
-		
-		uint32_t *buffer = &base[y * imageWidth + x];
-
-		*(buffer++) = (data & 0x80) > 0 ? inkRaw : paperRaw;
-		*(buffer++) = (data & 0x80) > 0 ? inkRaw : paperRaw;
-		*(buffer++) = (data & 0x40) > 0 ? inkRaw : paperRaw;
-		*(buffer++) = (data & 0x40) > 0 ? inkRaw : paperRaw;
-		*(buffer++) = (data & 0x20) > 0 ? inkRaw : paperRaw;
-		*(buffer++) = (data & 0x20) > 0 ? inkRaw : paperRaw;
-		*(buffer++) = (data & 0x10) > 0 ? inkRaw : paperRaw;
-		*(buffer++) = (data & 0x10) > 0 ? inkRaw : paperRaw;
-		*(buffer++) = (data & 0x08) > 0 ? inkRaw : paperRaw;
-		*(buffer++) = (data & 0x08) > 0 ? inkRaw : paperRaw;
-		*(buffer++) = (data & 0x04) > 0 ? inkRaw : paperRaw;
-		*(buffer++) = (data & 0x04) > 0 ? inkRaw : paperRaw;
-		*(buffer++) = (data & 0x02) > 0 ? inkRaw : paperRaw;
-		*(buffer++) = (data & 0x02) > 0 ? inkRaw : paperRaw;
-		*(buffer++) = (data & 0x01) > 0 ? inkRaw : paperRaw;
-		*(buffer++) = (data & 0x01) > 0 ? inkRaw : paperRaw;
-	} else {
-		x <<= 3;
-		
-		uint32_t *buffer = &base[y * imageWidth + x];
-
-		*(buffer++) = (data & 0x80) > 0 ? inkRaw : paperRaw;
-		*(buffer++) = (data & 0x40) > 0 ? inkRaw : paperRaw;
-		*(buffer++) = (data & 0x20) > 0 ? inkRaw : paperRaw;
-		*(buffer++) = (data & 0x10) > 0 ? inkRaw : paperRaw;
-		*(buffer++) = (data & 0x08) > 0 ? inkRaw : paperRaw;
-		*(buffer++) = (data & 0x04) > 0 ? inkRaw : paperRaw;
-		*(buffer++) = (data & 0x02) > 0 ? inkRaw : paperRaw;
-		*(buffer++) = (data & 0x01) > 0 ? inkRaw : paperRaw;
-	}
+	uiframe_plot8(x, y, data, ink, paper);
 }
 
 void controller_display_plot16_function(int x, int y, libspectrum_word data, libspectrum_byte ink, libspectrum_byte paper, void *context) {
-	if (machine_current->timex) {
-		x <<= 4;
-		y <<= 1;
-	}
-	
-	uint32_t inkRaw = palette[ink];
-	uint32_t paperRaw = palette[paper];
-	
-	uint32_t *base = (uint32_t *)imageData;
-	uint32_t *buffer = &base[y * imageWidth + x];
-	
-	for (int i=0; i<2; i++) {
-		*(buffer++) = (data & 0x8000) > 0 ? inkRaw : paperRaw;
-		*(buffer++) = (data & 0x4000) > 0 ? inkRaw : paperRaw;
-		*(buffer++) = (data & 0x2000) > 0 ? inkRaw : paperRaw;
-		*(buffer++) = (data & 0x1000) > 0 ? inkRaw : paperRaw;
-		*(buffer++) = (data & 0x0800) > 0 ? inkRaw : paperRaw;
-		*(buffer++) = (data & 0x0400) > 0 ? inkRaw : paperRaw;
-		*(buffer++) = (data & 0x0200) > 0 ? inkRaw : paperRaw;
-		*(buffer++) = (data & 0x0100) > 0 ? inkRaw : paperRaw;
-		*(buffer++) = (data & 0x0080) > 0 ? inkRaw : paperRaw;
-		*(buffer++) = (data & 0x0040) > 0 ? inkRaw : paperRaw;
-		*(buffer++) = (data & 0x0020) > 0 ? inkRaw : paperRaw;
-		*(buffer++) = (data & 0x0010) > 0 ? inkRaw : paperRaw;
-		*(buffer++) = (data & 0x0008) > 0 ? inkRaw : paperRaw;
-		*(buffer++) = (data & 0x0004) > 0 ? inkRaw : paperRaw;
-		*(buffer++) = (data & 0x0002) > 0 ? inkRaw : paperRaw;
-		*(buffer++) = (data & 0x0001) > 0 ? inkRaw : paperRaw;
-	}
+	uiframe_plot16(x, y, data, ink, paper);
 }
 
 void controller_display_area_function(int x, int y, int width, int height, void *context) {
-	displayUpdated = YES;
+	uiframe_area(x, y, width, height);
 }
 
 void controller_display_frame_end_function(void *context) {
-	if (displayUpdated) {
+	uiframe_publish();
+}
+
+void controller_display_end_function(void *context) {
+	uiframe_end();
+}
+
+#pragma mark - Rendering
+
+static void controller_display_render(const uiframe *frame, void *context) {
+	uint32_t *base = (uint32_t *)imageData;
+
+	if (frame->full) {
+		for (int i=0; i<frame->width * frame->height; i++) {
+			base[i] = palette[frame->pixels[i]];
+		}
+	} else {
+		for (size_t r=0; r<frame->rect_count; r++) {
+			const uiframe_rect *rect = &frame->rects[r];
+			for (int y=rect->y; y<rect->y + rect->h; y++) {
+				const libspectrum_byte *source = &frame->pixels[y * frame->width + rect->x];
+				uint32_t *buffer = &base[y * imageWidth + rect->x];
+				for (int x=0; x<rect->w; x++) {
+					*(buffer++) = palette[*(source++)];
+				}
+			}
+		}
+	}
+
+	@autoreleasepool {
 		CGContextRef bitmapContext = CGBitmapContextCreate(
 			imageData,
 			imageWidth,
@@ -218,14 +170,8 @@ void controller_display_frame_end_function(void *context) {
 				SpectrumDisplayController *controller = CONTROLLER;
 				[controller.handler spectrumDisplayController:controller renderImage:image];
 			}
-			
-			CGContextRelease(bitmapContext);
 		}
 
-		displayUpdated = NO;
+		CGContextRelease(bitmapContext);
 	}
 }
-
-void controller_display_end_function(void *context) {
-	// Nothing to do here...
-}
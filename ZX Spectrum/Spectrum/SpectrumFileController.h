@@ -6,6 +6,7 @@
 #import <Foundation/Foundation.h>
 
 #include "libspectrum.h"
+#include "file_index.h"
 #include "tape_block.h"
 #include "tape.h"
 #include "utils.h"
@@ -24,6 +25,16 @@
  */
 - (SpectrumFileInfo * _Nullable)informationForFileAtPath:(NSString * _Nonnull)path error:(NSError * _Nullable * _Nullable)error;
 
+/**
+ Reads the type, machine and archive info of the given files in parallel, without reading whole tapes, and remembers them in the file index (kept in the caches directory unless set otherwise). Only has effect once the emulator is running.
+ */
++ (void)indexFilesAtPaths:(NSArray<NSString *> * _Nonnull)paths;
+
+/**
+ Returns summary information about the given file from the file index, without reading the file itself; use `informationForFileAtPath:error:` for blocks. Fails if the file wasn't indexed or has changed since.
+ */
+- (SpectrumFileInfo * _Nullable)summaryForFileAtPath:(NSString * _Nonnull)path error:(NSError * _Nullable * _Nullable)error;
+
 @end
 
 #pragma mark - 
@@ -42,6 +53,9 @@
 /// Size of the file in bytes.
 @property (assign, nonatomic) NSInteger size;
 
+/// File title.
+@property (copy, nonatomic, nullable) NSString *title;
+
 /// File author(s).
 @property (strong, nonatomic, nullable) NSArray <NSString *> *authors;
 
@@ -4,6 +4,7 @@
 //
 
 #import "SpectrumFileController.h"
+#include "settings.h"
 
 @interface SpectrumFileInfo (PrivateAPI)
 - (void)addBlock:(libspectrum_tape_block)block;
@@ -141,6 +142,56 @@
 	return result;
 }
 
++ (void)indexFilesAtPaths:(NSArray<NSString *> *)paths {
+	// Keep the index between launches if nobody asked for it elsewhere.
+	if (!settings_current.file_index) {
+		NSString *caches = NSSearchPathForDirectoriesInDomains(NSCachesDirectory, NSUserDomainMask, YES).firstObject;
+		NSString *filename = [caches stringByAppendingPathComponent:@"fuse-file-index"];
+		settings_set_string(&settings_current.file_index, filename.UTF8String);
+		file_index_load(settings_current.file_index);
+	}
+	
+	const char **filenames = malloc(paths.count * sizeof(const char *));
+	for (NSUInteger i=0; i<paths.count; i++) {
+		filenames[i] = paths[i].fileSystemRepresentation;
+	}
+	
+	file_index_scan(filenames, paths.count);
+	free(filenames);
+}
+
+- (SpectrumFileInfo *)summaryForFileAtPath:(NSString *)path error:(NSError **)error {
+	const file_index_entry *entry = file_index_lookup(path.fileSystemRepresentation);
+	if (!entry) {
+		if (error) *error = [self errorWithCode:-9020 description:NSLocalizedString(@"File is not indexed.", nil)];
+		return nil;
+	}
+	
+	SpectrumFileInfo *result = [SpectrumFileInfo new];
+	result.size = (NSInteger)entry->size;
+	result.hardwareInfo = [SpectrumHardwareInfo defaultInfos];
+	
+	for (size_t i=0; i<entry->archive_info_count; i++) {
+		char *text = entry->archive_info_strings[i];
+		
+		switch (entry->archive_info_ids[i]) {
+			case 0x00: result.title = [self stringFromCString:text]; break;
+			case 0x01: result.publisher = [self stringFromCString:text]; break;
+			case 0x02: result.authors = [self componentsFromCString:text]; break;
+			case 0x03: result.year = [self stringFromCString:text]; break;
+			case 0x04: result.language = [self stringFromCString:text]; break;
+			case 0x05: result.type = [self stringFromCString:text]; break;
+			case 0x06: result.price = [self stringFromCString:text]; break;
+			case 0x07: result.loader = [self stringFromCString:text]; break;
+			case 0x08: result.origin = [self stringFromCString:text]; break;
+			case 0xff: result.comment = [self stringFromCString:text]; break;
+			default: break;
+		}
+	}
+	
+	return result;
+}
+
 - (void)consolidateHardwareInfosInArray:(NSMutableArray<SpectrumHardwareInfo *> *)array
 								   with:(NSArray<SpectrumHardwareInfo *> *)infos
 							replacement:(SpectrumHardwareInfo *(^)(void))replacement {